@@ -0,0 +1,49 @@
+/**
+ * @file bsdiff.h
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef BSDIFF_INCLUDE_GUARD
+#define BSDIFF_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function builds the suffix array of an original image. The suffix array only depends on the
+ * original image: it may be shared by several calls to bsDiff(), including concurrent ones.
+ *
+ * @return
+ *      - The suffix array, to be released with free(3)
+ *      - NULL if there is not enough memory
+ */
+//--------------------------------------------------------------------------------------------------
+off_t* bsDiffSuffixArray
+(
+    const uint8_t *oldPtr,  ///< [IN] Original image
+    off_t oldSize           ///< [IN] Size of the original image
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function builds the delta patch between an original image and a new image, in memory. The
+ * patch is the same as the one written by the bsdiff tool. This function is thread safe.
+ *
+ * @return
+ *      - LE_OK         Patch is successfully built
+ *      - LE_NO_MEMORY  There is not enough memory
+ *      - LE_FAULT      The compression fails
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t bsDiff
+(
+    const uint8_t *oldPtr,  ///< [IN] Original image
+    off_t oldSize,          ///< [IN] Size of the original image
+    const off_t *suffixPtr, ///< [IN] Suffix array of the original image from bsDiffSuffixArray()
+    const uint8_t *newPtr,  ///< [IN] New image
+    off_t newSize,          ///< [IN] Size of the new image
+    uint8_t **patchPtr,     ///< [OUT] Patch, to be released with free(3)
+    size_t *patchSizePtr    ///< [OUT] Size of the patch
+);
+
+#endif // BSDIFF_INCLUDE_GUARD
@@ -0,0 +1,759 @@
+/**
+ * This module implements a benchmark of the AT commands client.
+ *
+ * A pseudo-terminal is opened and its slave side is given to the AT client.  A modem simulator
+ * thread answers the command lines received on the master side, after a fixed delay per line
+ * standing for the round trip with a real modem.  The benchmark logs:
+ *  - the rate and latency of commands sent one at a time with le_atClient_Send(),
+ *  - the latency of a few urgent commands sent with le_atClient_SendAsync() behind a backlog of
+ *    background commands, first with the same priority, then with a higher priority,
+ *  - the rate of a backlog of commands sent one per line, then concatenated on lines,
+ *  - the latency of commands dropped because their deadline was reached behind a backlog.
+ *
+ * Issue the following commands:
+ * @verbatim
+  $ app start atClientBenchmark
+  $ app runProc atClientBenchmark --exe=atClientBenchmark -- [<number of background commands>]
+  @endverbatim
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include <termios.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default number of background commands.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_BACKLOG_COUNT       200
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of background commands.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_BACKLOG_COUNT           2000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of urgent commands sent behind the background commands.
+ */
+//--------------------------------------------------------------------------------------------------
+#define URGENT_CMD_COUNT            5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time taken by the modem simulator to answer a command line, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MODEM_LINE_DELAY_US         1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deadline of the urgent commands in the deadline phase, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define URGENT_DEADLINE_MS          20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timeout of the commands, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CMD_TIMEOUT_MS              10000
+
+#define FINAL_RSP           "OK"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commands sent in turn, and the intermediate responses they expect.  No intermediate response
+ * starts with another one, so consecutive commands can share a line.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* CmdNames[] = { "+CSQ", "+CREG?", "+CGREG?", "+COPS?" };
+static const char* CmdResponses[] = { "+CSQ:", "+CREG:", "+CGREG:", "+COPS:" };
+
+#define CMD_NAME_COUNT      NUM_ARRAY_MEMBERS(CmdNames)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Latency statistics of a set of commands.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int         count;          ///< Number of commands ended
+    int         timeoutCount;   ///< Number of commands ended by a timeout
+    uint64_t    sumUsec;        ///< Sum of the latencies
+    uint64_t    maxUsec;        ///< Maximum latency
+}
+Stats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Command sent asynchronously.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_atClient_CmdRef_t    cmdRef;     ///< AT command
+    int                     nameIdx;    ///< Index in CmdNames
+    le_clk_Time_t           start;      ///< When the command was sent
+    Stats_t*                statsPtr;   ///< Statistics updated when the command ends
+}
+Command_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Master side of the pseudo-terminal, used by the modem simulator.
+ */
+//--------------------------------------------------------------------------------------------------
+static int MasterFd = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of command lines answered by the modem simulator, and its mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ModemLineCount;
+static le_mutex_Ref_t ModemMutex;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AT client device opened on the slave side of the pseudo-terminal.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_atClient_DeviceRef_t DevRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of background commands.
+ */
+//--------------------------------------------------------------------------------------------------
+static int BacklogCount = DEFAULT_BACKLOG_COUNT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commands of the current phase, and the number of them not ended yet.
+ */
+//--------------------------------------------------------------------------------------------------
+static Command_t Commands[MAX_BACKLOG_COUNT + URGENT_CMD_COUNT];
+static int CommandCount;
+static int PendingCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the current phase, and its start time.
+ */
+//--------------------------------------------------------------------------------------------------
+static Stats_t BacklogStats;
+static Stats_t UrgentStats;
+static le_clk_Time_t PhaseStart;
+static int PhaseLineCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of command lines answered by the modem simulator.
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetModemLineCount
+(
+    void
+)
+{
+    int count;
+
+    le_mutex_Lock(ModemMutex);
+    count = ModemLineCount;
+    le_mutex_Unlock(ModemMutex);
+
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole buffer on the master side of the pseudo-terminal.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteAll
+(
+    const char* bufPtr,     ///< [IN] Data to write
+    size_t len              ///< [IN] Data length
+)
+{
+    while (len > 0)
+    {
+        ssize_t size = write(MasterFd, bufPtr, len);
+        if (size < 0)
+        {
+            LE_FATAL_IF(errno != EINTR, "write failed: %m");
+            continue;
+        }
+        bufPtr += size;
+        len -= size;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Answer a command line: one intermediate response per command of the line, then OK.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AnswerLine
+(
+    char* linePtr           ///< [IN] Command line, without the final '\r'
+)
+{
+    char rsp[LE_ATDEFS_COMMAND_MAX_BYTES * 2];
+    size_t len = 0;
+    char* savePtr;
+    char* cmdPtr;
+
+    usleep(MODEM_LINE_DELAY_US);
+
+    if (strncasecmp(linePtr, "AT", 2) == 0)
+    {
+        linePtr += 2;
+    }
+
+    // The intermediate response of "+CMD?" or "+CMD=..." is "+CMD: <value>"
+    for (cmdPtr = strtok_r(linePtr, ";", &savePtr);
+         cmdPtr != NULL;
+         cmdPtr = strtok_r(NULL, ";", &savePtr))
+    {
+        len += snprintf(rsp + len, sizeof(rsp) - len, "\r\n%.*s: 1\r\n",
+                        (int) strcspn(cmdPtr, "?="), cmdPtr);
+    }
+    len += snprintf(rsp + len, sizeof(rsp) - len, "\r\n" FINAL_RSP "\r\n");
+
+    le_mutex_Lock(ModemMutex);
+    ModemLineCount++;
+    le_mutex_Unlock(ModemMutex);
+
+    WriteAll(rsp, len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Modem simulator thread: answers the command lines received on the master side.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ModemThread
+(
+    void* contextPtr
+)
+{
+    char line[LE_ATDEFS_COMMAND_MAX_BYTES];
+    size_t lineLen = 0;
+    char buf[256];
+
+    for (;;)
+    {
+        ssize_t size = read(MasterFd, buf, sizeof(buf));
+        if (size < 0)
+        {
+            LE_FATAL_IF(errno != EINTR, "read failed: %m");
+            continue;
+        }
+
+        ssize_t i;
+        for (i = 0; i < size; i++)
+        {
+            if (buf[i] == '\r')
+            {
+                line[lineLen] = '\0';
+                AnswerLine(line);
+                lineLen = 0;
+            }
+            else if ((buf[i] != '\n') && (lineLen < sizeof(line) - 1))
+            {
+                line[lineLen++] = buf[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ElapsedUsec
+(
+    le_clk_Time_t start     ///< [IN] Start time
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return (uint64_t) elapsed.sec * 1000000 + elapsed.usec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the latency of a command to statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddLatency
+(
+    Stats_t* statsPtr,      ///< [IN] Statistics
+    uint64_t usec           ///< [IN] Latency
+)
+{
+    statsPtr->count++;
+    statsPtr->sumUsec += usec;
+    if (usec > statsPtr->maxUsec)
+    {
+        statsPtr->maxUsec = usec;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log latency statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogStats
+(
+    const char* namePtr,    ///< [IN] Name of the set of commands
+    Stats_t* statsPtr       ///< [IN] Statistics
+)
+{
+    LE_INFO("  %-24s %5d commands, latency avg %6" PRIu64 " us, max %6" PRIu64 " us,"
+            " %d timeouts", namePtr, statsPtr->count,
+            (statsPtr->count == 0) ? 0 : statsPtr->sumUsec / statsPtr->count,
+            statsPtr->maxUsec, statsPtr->timeoutCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an AT command sending one of the benchmark commands.
+ *
+ * @return Command reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_atClient_CmdRef_t CreateCommand
+(
+    int nameIdx                         ///< [IN] Index in CmdNames
+)
+{
+    char cmd[LE_ATDEFS_COMMAND_MAX_BYTES];
+    le_atClient_CmdRef_t cmdRef = le_atClient_Create();
+
+    LE_ASSERT(cmdRef != NULL);
+
+    snprintf(cmd, sizeof(cmd), "AT%s", CmdNames[nameIdx]);
+    LE_ASSERT_OK(le_atClient_SetCommand(cmdRef, cmd));
+    LE_ASSERT_OK(le_atClient_SetDevice(cmdRef, DevRef));
+    LE_ASSERT_OK(le_atClient_SetIntermediateResponse(cmdRef, CmdResponses[nameIdx]));
+    LE_ASSERT_OK(le_atClient_SetFinalResponse(cmdRef, "OK|ERROR|+CME ERROR:"));
+    LE_ASSERT_OK(le_atClient_SetTimeout(cmdRef, CMD_TIMEOUT_MS));
+
+    return cmdRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the responses of a command ended with LE_OK.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckResponses
+(
+    le_atClient_CmdRef_t cmdRef,    ///< [IN] AT command
+    int nameIdx                     ///< [IN] Index in CmdNames
+)
+{
+    char rsp[LE_ATDEFS_RESPONSE_MAX_BYTES];
+
+    LE_ASSERT_OK(le_atClient_GetFirstIntermediateResponse(cmdRef, rsp, sizeof(rsp)));
+    LE_ASSERT(strncmp(rsp, CmdResponses[nameIdx], strlen(CmdResponses[nameIdx])) == 0);
+    LE_ASSERT(le_atClient_GetNextIntermediateResponse(cmdRef, rsp, sizeof(rsp)) == LE_NOT_FOUND);
+    LE_ASSERT_OK(le_atClient_GetFinalResponse(cmdRef, rsp, sizeof(rsp)));
+    LE_ASSERT(strcmp(rsp, FINAL_RSP) == 0);
+}
+
+static void NextPhase(void* param1Ptr, void* param2Ptr);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called at the end of a command sent asynchronously.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CommandHandler
+(
+    le_atClient_CmdRef_t cmdRef,
+    le_result_t result,
+    void* contextPtr
+)
+{
+    Command_t* commandPtr = contextPtr;
+
+    LE_ASSERT(commandPtr->cmdRef == cmdRef);
+    AddLatency(commandPtr->statsPtr, ElapsedUsec(commandPtr->start));
+
+    if (result == LE_TIMEOUT)
+    {
+        commandPtr->statsPtr->timeoutCount++;
+    }
+    else
+    {
+        LE_ASSERT_OK(result);
+        CheckResponses(cmdRef, commandPtr->nameIdx);
+    }
+
+    PendingCount--;
+    if (PendingCount == 0)
+    {
+        le_event_QueueFunction(NextPhase, NULL, NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new phase of asynchronous commands.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartPhase
+(
+    void
+)
+{
+    memset(&BacklogStats, 0, sizeof(BacklogStats));
+    memset(&UrgentStats, 0, sizeof(UrgentStats));
+    CommandCount = 0;
+    PendingCount = 0;
+    PhaseLineCount = GetModemLineCount();
+    PhaseStart = le_clk_GetRelativeTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a command asynchronously in the current phase.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendAsync
+(
+    int nameIdx,                        ///< [IN] Index in CmdNames
+    le_atClient_Priority_t priority,    ///< [IN] Priority
+    uint32_t deadline,                  ///< [IN] Deadline in ms, 0 for none
+    bool batchable,                     ///< [IN] Whether the command can share a line
+    Stats_t* statsPtr                   ///< [IN] Statistics to update when the command ends
+)
+{
+    LE_ASSERT(CommandCount < NUM_ARRAY_MEMBERS(Commands));
+
+    Command_t* commandPtr = &Commands[CommandCount++];
+
+    commandPtr->cmdRef = CreateCommand(nameIdx);
+    commandPtr->nameIdx = nameIdx;
+    commandPtr->statsPtr = statsPtr;
+    LE_ASSERT_OK(le_atClient_SetPriority(commandPtr->cmdRef, priority));
+    LE_ASSERT_OK(le_atClient_SetDeadline(commandPtr->cmdRef, deadline));
+    LE_ASSERT_OK(le_atClient_SetBatchable(commandPtr->cmdRef, batchable));
+
+    PendingCount++;
+    commandPtr->start = le_clk_GetRelativeTime();
+    le_atClient_SendAsync(commandPtr->cmdRef, CommandHandler, commandPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the commands of the current phase and log how long it took.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndPhase
+(
+    void
+)
+{
+    uint64_t usec = ElapsedUsec(PhaseStart);
+    int i;
+
+    LE_INFO("  %d commands in %" PRIu64 " ms on %d lines, %" PRIu64 " commands/s",
+            CommandCount, usec / 1000, GetModemLineCount() - PhaseLineCount,
+            (usec == 0) ? 0 : (uint64_t) CommandCount * 1000000 / usec);
+
+    for (i = 0; i < CommandCount; i++)
+    {
+        LE_ASSERT_OK(le_atClient_Delete(Commands[i].cmdRef));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the background commands one at a time with le_atClient_Send().
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunSyncPhase
+(
+    void
+)
+{
+    int i;
+
+    LE_INFO("Synchronous send, one command at a time:");
+    StartPhase();
+
+    for (i = 0; i < BacklogCount; i++)
+    {
+        int nameIdx = i % CMD_NAME_COUNT;
+        le_atClient_CmdRef_t cmdRef = CreateCommand(nameIdx);
+        le_clk_Time_t start = le_clk_GetRelativeTime();
+
+        LE_ASSERT_OK(le_atClient_Send(cmdRef));
+        AddLatency(&BacklogStats, ElapsedUsec(start));
+        CheckResponses(cmdRef, nameIdx);
+        LE_ASSERT_OK(le_atClient_Delete(cmdRef));
+    }
+
+    LogStats("Send", &BacklogStats);
+    le_event_QueueFunction(NextPhase, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the background commands, then the urgent commands.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueContention
+(
+    le_atClient_Priority_t backlogPriority,     ///< [IN] Priority of the background commands
+    le_atClient_Priority_t urgentPriority       ///< [IN] Priority of the urgent commands
+)
+{
+    int i;
+
+    StartPhase();
+
+    for (i = 0; i < BacklogCount; i++)
+    {
+        SendAsync(i % CMD_NAME_COUNT, backlogPriority, 0, false, &BacklogStats);
+    }
+    for (i = 0; i < URGENT_CMD_COUNT; i++)
+    {
+        SendAsync(i % CMD_NAME_COUNT, urgentPriority, 0, false, &UrgentStats);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the urgent commands behind the background ones, with the same priority.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunFifoPhase
+(
+    void
+)
+{
+    LE_INFO("Asynchronous send, urgent commands with the same priority:");
+    QueueContention(LE_ATCLIENT_PRIORITY_NORMAL, LE_ATCLIENT_PRIORITY_NORMAL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the urgent commands behind the background ones, with a higher priority.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunPriorityPhase
+(
+    void
+)
+{
+    LE_INFO("Asynchronous send, urgent commands with a higher priority:");
+    QueueContention(LE_ATCLIENT_PRIORITY_LOW, LE_ATCLIENT_PRIORITY_HIGH);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the background commands, one per line.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunUnbatchedPhase
+(
+    void
+)
+{
+    int i;
+
+    LE_INFO("Asynchronous send, one command per line:");
+    StartPhase();
+
+    for (i = 0; i < BacklogCount; i++)
+    {
+        SendAsync(i % CMD_NAME_COUNT, LE_ATCLIENT_PRIORITY_NORMAL, 0, false, &BacklogStats);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the background commands, allowing them to share lines.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunBatchedPhase
+(
+    void
+)
+{
+    int i;
+
+    LE_INFO("Asynchronous send, batchable commands:");
+    StartPhase();
+
+    for (i = 0; i < BacklogCount; i++)
+    {
+        SendAsync(i % CMD_NAME_COUNT, LE_ATCLIENT_PRIORITY_NORMAL, 0, true, &BacklogStats);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the urgent commands with a short deadline behind the background ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunDeadlinePhase
+(
+    void
+)
+{
+    int i;
+
+    LE_INFO("Asynchronous send, urgent commands with a %d ms deadline:", URGENT_DEADLINE_MS);
+    StartPhase();
+
+    for (i = 0; i < BacklogCount; i++)
+    {
+        SendAsync(i % CMD_NAME_COUNT, LE_ATCLIENT_PRIORITY_NORMAL, 0, false, &BacklogStats);
+    }
+    for (i = 0; i < URGENT_CMD_COUNT; i++)
+    {
+        SendAsync(i % CMD_NAME_COUNT, LE_ATCLIENT_PRIORITY_NORMAL, URGENT_DEADLINE_MS, false,
+                  &UrgentStats);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Phases of the benchmark, in order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void (*const Phases[])(void) =
+{
+    RunSyncPhase,
+    RunFifoPhase,
+    RunPriorityPhase,
+    RunUnbatchedPhase,
+    RunBatchedPhase,
+    RunDeadlinePhase,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the results of the phase just ended and start the next one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void NextPhase
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    static size_t phaseIdx = 0;
+    static int unbatchedLineCount;
+
+    if (phaseIdx > 0)
+    {
+        void (*phase)(void) = Phases[phaseIdx - 1];
+
+        if (phase != RunSyncPhase)
+        {
+            LogStats("Background commands", &BacklogStats);
+            if (UrgentStats.count > 0)
+            {
+                LogStats("Urgent commands", &UrgentStats);
+            }
+            EndPhase();
+        }
+
+        if (phase == RunUnbatchedPhase)
+        {
+            unbatchedLineCount = GetModemLineCount() - PhaseLineCount;
+        }
+        else if (phase == RunBatchedPhase)
+        {
+            // Commands queued together share lines
+            LE_ASSERT(GetModemLineCount() - PhaseLineCount < unbatchedLineCount);
+        }
+        else if (phase == RunDeadlinePhase)
+        {
+            LE_ASSERT(UrgentStats.timeoutCount == URGENT_CMD_COUNT);
+            LE_ASSERT(BacklogStats.timeoutCount == 0);
+        }
+    }
+
+    if (phaseIdx == NUM_ARRAY_MEMBERS(Phases))
+    {
+        LE_INFO("======== ATClient benchmark done ========");
+        exit(EXIT_SUCCESS);
+    }
+
+    Phases[phaseIdx++]();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a pseudo-terminal in raw mode.
+ *
+ * @return File descriptor of the slave side.
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenPty
+(
+    void
+)
+{
+    struct termios tios;
+
+    MasterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    LE_FATAL_IF(MasterFd < 0, "posix_openpt failed: %m");
+    LE_FATAL_IF((grantpt(MasterFd) != 0) || (unlockpt(MasterFd) != 0),
+                "Cannot unlock pseudo-terminal: %m");
+
+    const char* slaveNamePtr = ptsname(MasterFd);
+    LE_FATAL_IF(slaveNamePtr == NULL, "ptsname failed: %m");
+
+    int slaveFd = open(slaveNamePtr, O_RDWR | O_NOCTTY);
+    LE_FATAL_IF(slaveFd < 0, "Cannot open %s: %m", slaveNamePtr);
+
+    LE_FATAL_IF(tcgetattr(slaveFd, &tios) != 0, "tcgetattr failed: %m");
+    cfmakeraw(&tios);
+    LE_FATAL_IF(tcsetattr(slaveFd, TCSANOW, &tios) != 0, "tcsetattr failed: %m");
+
+    LE_INFO("AT client benchmark on %s", slaveNamePtr);
+
+    return slaveFd;
+}
+
+COMPONENT_INIT
+{
+    if (le_arg_NumArgs() >= 1)
+    {
+        BacklogCount = atoi(le_arg_GetArg(0));
+        LE_FATAL_IF((BacklogCount <= 0) || (BacklogCount > MAX_BACKLOG_COUNT),
+                    "Invalid number of background commands '%s'", le_arg_GetArg(0));
+    }
+
+    ModemMutex = le_mutex_CreateNonRecursive("ModemMutex");
+
+    int slaveFd = OpenPty();
+    DevRef = le_atClient_Start(slaveFd);
+    LE_FATAL_IF(DevRef == NULL, "Cannot start the AT client device");
+
+    le_thread_Start(le_thread_Create("AtBenchModem", ModemThread, NULL));
+
+    le_event_QueueFunction(NextPhase, NULL, NULL);
+}
@@ -109,3 +109,142 @@ void le_wdogChain_Stop
 {
     // do nothing
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response of the last server function which responds immediately
+ */
+//--------------------------------------------------------------------------------------------------
+Response_t Response;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response of the last le_atClient_Send() or le_atClient_SetCommandAndSend()
+ */
+//--------------------------------------------------------------------------------------------------
+static Response_t SendResponse;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Semaphore posted when SendResponse is set
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sem_Ref_t SendResponseSem;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a response
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetResponse
+(
+    Response_t* responsePtr,
+    le_result_t result,
+    void*       ref,
+    const char* rspPtr
+)
+{
+    responsePtr->result = result;
+    responsePtr->ref = ref;
+    LE_ASSERT(le_utf8_Copy(responsePtr->rsp, rspPtr, sizeof(responsePtr->rsp), NULL) == LE_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the respond stubs
+ */
+//--------------------------------------------------------------------------------------------------
+void InitResponses
+(
+    void
+)
+{
+    SendResponseSem = le_sem_Create("SendResponseSem", 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the response of le_atClient_Send() or le_atClient_SetCommandAndSend()
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t WaitSendResponse
+(
+    le_clk_Time_t timeout,
+    Response_t*   responsePtr
+)
+{
+    le_result_t result = le_sem_WaitWithTimeOut(SendResponseSem, timeout);
+
+    if (result == LE_OK)
+    {
+        *responsePtr = SendResponse;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Respond stubs of the functions which respond immediately
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_StartRespond(le_atClient_ServerCmdRef_t serverCmdRef, le_atClient_DeviceRef_t ref)
+{
+    SetResponse(&Response, LE_OK, ref, "");
+}
+
+void le_atClient_CreateRespond(le_atClient_ServerCmdRef_t serverCmdRef, le_atClient_CmdRef_t ref)
+{
+    SetResponse(&Response, LE_OK, ref, "");
+}
+
+#define RESULT_RESPOND_STUB(func)                                                   \
+    void le_atClient_##func##Respond(le_atClient_ServerCmdRef_t serverCmdRef,       \
+                                     le_result_t result)                            \
+    {                                                                               \
+        SetResponse(&Response, result, NULL, "");                                   \
+    }
+
+RESULT_RESPOND_STUB(Stop)
+RESULT_RESPOND_STUB(Delete)
+RESULT_RESPOND_STUB(SetCommand)
+RESULT_RESPOND_STUB(SetIntermediateResponse)
+RESULT_RESPOND_STUB(SetFinalResponse)
+RESULT_RESPOND_STUB(SetText)
+RESULT_RESPOND_STUB(SetTimeout)
+RESULT_RESPOND_STUB(SetPriority)
+RESULT_RESPOND_STUB(SetDeadline)
+RESULT_RESPOND_STUB(SetBatchable)
+RESULT_RESPOND_STUB(SetDevice)
+
+#define STRING_RESPOND_STUB(func)                                                   \
+    void le_atClient_##func##Respond(le_atClient_ServerCmdRef_t serverCmdRef,       \
+                                     le_result_t result, const char* rspPtr)        \
+    {                                                                               \
+        SetResponse(&Response, result, NULL, rspPtr);                               \
+    }
+
+STRING_RESPOND_STUB(GetFirstIntermediateResponse)
+STRING_RESPOND_STUB(GetNextIntermediateResponse)
+STRING_RESPOND_STUB(GetFinalResponse)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Respond stubs of the functions which respond when the command ends
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SendRespond(le_atClient_ServerCmdRef_t serverCmdRef, le_result_t result)
+{
+    SetResponse(&SendResponse, result, NULL, "");
+    le_sem_Post(SendResponseSem);
+}
+
+void le_atClient_SetCommandAndSendRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result,
+    le_atClient_CmdRef_t ref
+)
+{
+    SetResponse(&SendResponse, result, ref, "");
+    le_sem_Post(SendResponseSem);
+}
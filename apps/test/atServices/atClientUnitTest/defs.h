@@ -8,7 +8,7 @@
 #define _DEFS_H
 
 #include "legato.h"
-#include "le_atClient_interface.h"
+#include "le_atClient_common.h"
 
 #define DSIZE                      1024               // default buffer size
 
@@ -27,6 +27,55 @@ typedef struct
 }
 SharedData_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response_t definition: response of a server function, filled by the respond stubs
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_result_t                    result;                             //< result
+    void*                          ref;                                //< returned reference
+    char                           rsp[LE_ATDEFS_RESPONSE_MAX_BYTES];  //< returned response
+}
+Response_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response of the last server function which responds immediately
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+extern Response_t Response;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the respond stubs
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void InitResponses
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the response of le_atClient_Send() or le_atClient_SetCommandAndSend(), which is sent
+ * when the command ends
+ *
+ * @return
+ *      - LE_OK when the response is received
+ *      - LE_TIMEOUT when the response is not received in time
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t WaitSendResponse
+(
+    le_clk_Time_t timeout,       ///< [IN] Time to wait
+    Response_t*   responsePtr    ///< [OUT] Response
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * AtClientServer function to receive the response from the server
@@ -5,7 +5,277 @@
  *
  */
 
-#include "le_atClient_interface.h"
+#include "le_atClient_common.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Command reference of the asynchronous server functions
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_atClient_ServerCmd* le_atClient_ServerCmdRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous server API of le_atClient, as provided by the atClient component. The respond
+ * functions are implemented by the stub.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_StartRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_DeviceRef_t result
+);
+
+void le_atClient_Start
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    int fd
+);
+
+void le_atClient_StopRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_Stop
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_DeviceRef_t device
+);
+
+void le_atClient_CreateRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t result
+);
+
+void le_atClient_Create
+(
+    le_atClient_ServerCmdRef_t serverCmdRef
+);
+
+void le_atClient_DeleteRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_Delete
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef
+);
+
+void le_atClient_SetCommandRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetCommand
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    const char* command
+);
+
+void le_atClient_SetIntermediateResponseRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetIntermediateResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    const char* intermediate
+);
+
+void le_atClient_SetFinalResponseRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetFinalResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    const char* response
+);
+
+void le_atClient_SetTextRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetText
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    const char* text
+);
+
+void le_atClient_SetTimeoutRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetTimeout
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    uint32_t timer
+);
+
+void le_atClient_SetPriorityRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetPriority
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    le_atClient_Priority_t priority
+);
+
+void le_atClient_SetDeadlineRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetDeadline
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    uint32_t deadline
+);
+
+void le_atClient_SetBatchableRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetBatchable
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    bool batchable
+);
+
+void le_atClient_SetDeviceRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_SetDevice
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    le_atClient_DeviceRef_t devRef
+);
+
+void le_atClient_SendRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t result
+);
+
+void le_atClient_Send
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef
+);
+
+void le_atClient_SendAsync
+(
+    le_atClient_CmdRef_t cmdRef,
+    le_atClient_CommandHandlerFunc_t handlerPtr,
+    void* contextPtr
+);
+
+void le_atClient_GetFirstIntermediateResponseRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t _result,
+    const char* intermediateRsp
+);
+
+void le_atClient_GetFirstIntermediateResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    size_t intermediateRspSize
+);
+
+void le_atClient_GetNextIntermediateResponseRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t _result,
+    const char* intermediateRsp
+);
+
+void le_atClient_GetNextIntermediateResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    size_t intermediateRspSize
+);
+
+void le_atClient_GetFinalResponseRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t _result,
+    const char* finalRsp
+);
+
+void le_atClient_GetFinalResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_CmdRef_t cmdRef,
+    size_t finalRspSize
+);
+
+void le_atClient_SetCommandAndSendRespond
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_result_t _result,
+    le_atClient_CmdRef_t cmdRef
+);
+
+void le_atClient_SetCommandAndSend
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+    le_atClient_DeviceRef_t devRef,
+    const char* command,
+    const char* interResp,
+    const char* finalResp,
+    uint32_t timeout
+);
+
+le_atClient_UnsolicitedResponseHandlerRef_t le_atClient_AddUnsolicitedResponseHandler
+(
+    const char* unsolRsp,
+    le_atClient_DeviceRef_t devRef,
+    le_atClient_UnsolicitedResponseHandlerFunc_t handlerPtr,
+    void* contextPtr,
+    uint32_t lineCount
+);
+
+void le_atClient_RemoveUnsolicitedResponseHandler
+(
+    le_atClient_UnsolicitedResponseHandlerRef_t handlerRef
+);
+
 
 #undef LE_KILL_CLIENT
 #define LE_KILL_CLIENT LE_WARN
@@ -23,6 +23,112 @@
 //--------------------------------------------------------------------------------------------------
 static SharedData_t SharedData;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server command reference given to the server functions, ignored by the respond stubs
+ */
+//--------------------------------------------------------------------------------------------------
+#define SERVER_CMD_REF  ((le_atClient_ServerCmdRef_t)&Response)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a server function which responds immediately, and get its result
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESULT(call)    ((call), Response.result)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an AT command
+ */
+//--------------------------------------------------------------------------------------------------
+static le_atClient_CmdRef_t Create
+(
+    void
+)
+{
+    le_atClient_Create(SERVER_CMD_REF);
+    return Response.ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a device
+ */
+//--------------------------------------------------------------------------------------------------
+static le_atClient_DeviceRef_t Start
+(
+    int fd
+)
+{
+    le_atClient_Start(SERVER_CMD_REF, fd);
+    return Response.ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a response of an AT command, for a GetXxx server function
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetResponse
+(
+    void (*getFunc)(le_atClient_ServerCmdRef_t, le_atClient_CmdRef_t, size_t),
+    le_atClient_CmdRef_t cmdRef,
+    char* bufferPtr,
+    size_t bufferSize
+)
+{
+    getFunc(SERVER_CMD_REF, cmdRef, bufferSize);
+    if (Response.result == LE_OK)
+    {
+        LE_ASSERT_OK(le_utf8_Copy(bufferPtr, Response.rsp, bufferSize, NULL));
+    }
+    return Response.result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send an AT command and wait for the response. The server function must not wait for the end of
+ * the command.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Send
+(
+    le_atClient_CmdRef_t cmdRef
+)
+{
+    le_clk_Time_t timeToWait = {CLIENT_TIMEOUT, 0};
+    Response_t response;
+
+    le_atClient_Send(SERVER_CMD_REF, cmdRef);
+    LE_ASSERT_OK(WaitSendResponse(timeToWait, &response));
+    return response.result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set and send an AT command and wait for the response.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetCommandAndSend
+(
+    le_atClient_CmdRef_t* cmdRefPtr,
+    le_atClient_DeviceRef_t devRef,
+    const char* commandPtr,
+    const char* interRespPtr,
+    const char* finalRespPtr,
+    uint32_t timeout
+)
+{
+    le_clk_Time_t timeToWait = {CLIENT_TIMEOUT, 0};
+    Response_t response;
+
+    le_atClient_SetCommandAndSend(SERVER_CMD_REF, devRef, commandPtr, interRespPtr, finalRespPtr, timeout);
+    LE_ASSERT_OK(WaitSendResponse(timeToWait, &response));
+    *cmdRefPtr = response.ref;
+    return response.result;
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -37,10 +143,10 @@ void Testle_atClientSetTextFalseTest
     le_atClient_CmdRef_t cmdRef;
     const char* textPtr = "run";
 
-    cmdRef = le_atClient_Create();
+    cmdRef = Create();
 
     // Set text test
-    LE_ASSERT(LE_BAD_PARAMETER == le_atClient_SetText(NULL, textPtr));
+    LE_ASSERT(LE_BAD_PARAMETER == RESULT(le_atClient_SetText(SERVER_CMD_REF, NULL, textPtr)));
     textPtr = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\
                aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\
                aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\
@@ -85,8 +191,28 @@ void Testle_atClientSetTextFalseTest
                aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\
                aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa";
 
-    LE_ASSERT(LE_FAULT == le_atClient_SetText(cmdRef, textPtr));
-    LE_ASSERT_OK(le_atClient_Delete(cmdRef));
+    LE_ASSERT(LE_FAULT == RESULT(le_atClient_SetText(SERVER_CMD_REF, cmdRef, textPtr)));
+    LE_ASSERT_OK(RESULT(le_atClient_Delete(SERVER_CMD_REF, cmdRef)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the atClient set priority false cases.
+ */
+//--------------------------------------------------------------------------------------------------
+void Testle_atClientSetPriorityFalseTest
+(
+    void
+)
+{
+    le_atClient_CmdRef_t cmdRef = Create();
+
+    LE_ASSERT(LE_BAD_PARAMETER == RESULT(le_atClient_SetPriority(SERVER_CMD_REF, cmdRef,
+                                                                 LE_ATCLIENT_PRIORITY_HIGH + 1)));
+    LE_ASSERT(LE_BAD_PARAMETER == RESULT(le_atClient_SetPriority(SERVER_CMD_REF, cmdRef,
+                                                                 (le_atClient_Priority_t)-1)));
+    LE_ASSERT_OK(RESULT(le_atClient_SetPriority(SERVER_CMD_REF, cmdRef, LE_ATCLIENT_PRIORITY_HIGH)));
+    LE_ASSERT_OK(RESULT(le_atClient_Delete(SERVER_CMD_REF, cmdRef)));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -103,21 +229,35 @@ void Testle_atClientSendFalseTest
     le_atClient_CmdRef_t cmdRef = NULL;
     le_atClient_DeviceRef_t devRef = NULL;
 
-    cmdRef = le_atClient_Create();
-    LE_ASSERT(LE_BAD_PARAMETER == le_atClient_Send(NULL));
-    LE_ASSERT(LE_FAULT == le_atClient_Send(cmdRef));
-
-    LE_ASSERT(NULL == le_atClient_Start(-1));
-
-    devRef = le_atClient_Start(fd);
-    LE_ASSERT_OK(le_atClient_SetDevice(cmdRef, devRef));
-    LE_ASSERT_OK(le_atClient_SetFinalResponse(cmdRef, "OK|ERROR|+CME ERROR"));
-    LE_ASSERT_OK(le_atClient_SetTimeout(cmdRef, 1));
-    LE_ASSERT(LE_TIMEOUT == le_atClient_Send(cmdRef));
-
-    LE_ASSERT(LE_TIMEOUT == le_atClient_SetCommandAndSend(&cmdRef, devRef, "AT",
-                                                          "OK|ERROR|+CME ERROR",
-                                                          "OK|ERROR|+CME ERROR", 1));
+    le_clk_Time_t timeToWait = {CLIENT_TIMEOUT, 0};
+    Response_t response;
+
+    cmdRef = Create();
+    LE_ASSERT(LE_BAD_PARAMETER == Send(NULL));
+    LE_ASSERT(LE_FAULT == Send(cmdRef));
+
+    LE_ASSERT(NULL == Start(-1));
+
+    devRef = Start(fd);
+    LE_ASSERT_OK(RESULT(le_atClient_SetDevice(SERVER_CMD_REF, cmdRef, devRef)));
+    LE_ASSERT_OK(RESULT(le_atClient_SetFinalResponse(SERVER_CMD_REF, cmdRef, "OK|ERROR|+CME ERROR")));
+    LE_ASSERT_OK(RESULT(le_atClient_SetTimeout(SERVER_CMD_REF, cmdRef, 1)));
+    LE_ASSERT(LE_TIMEOUT == Send(cmdRef));
+
+    // The server function doesn't wait for the end of the command: other requests are handled
+    // meanwhile
+    LE_ASSERT_OK(RESULT(le_atClient_SetTimeout(SERVER_CMD_REF, cmdRef, 1000)));
+    le_atClient_Send(SERVER_CMD_REF, cmdRef);
+    LE_ASSERT(LE_TIMEOUT == WaitSendResponse((le_clk_Time_t){0, 0}, &response));
+    LE_ASSERT(LE_BUSY == RESULT(le_atClient_Delete(SERVER_CMD_REF, cmdRef)));
+    Testle_atClientSetPriorityFalseTest();
+    LE_ASSERT_OK(WaitSendResponse(timeToWait, &response));
+    LE_ASSERT(LE_TIMEOUT == response.result);
+    LE_ASSERT_OK(RESULT(le_atClient_Delete(SERVER_CMD_REF, cmdRef)));
+
+    LE_ASSERT(LE_TIMEOUT == SetCommandAndSend(&cmdRef, devRef, "AT",
+                                              "OK|ERROR|+CME ERROR",
+                                              "OK|ERROR|+CME ERROR", 1));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -154,48 +294,50 @@ static void* AtClient
     LE_ASSERT_OK(le_sem_WaitWithTimeOut(sharedDataPtr->semRef, timeToWait));
 
     // Pass the socket fd to start the client
-    devRef = le_atClient_Start(socketFd);
+    devRef = Start(socketFd);
     LE_ASSERT(devRef != NULL);
 
-    cmdRef = le_atClient_Create();
-    LE_ASSERT_OK(le_atClient_SetDevice(cmdRef, devRef));
-    LE_ASSERT_OK(le_atClient_SetCommand(cmdRef, "AT+CREG?"));
-    LE_ASSERT_OK(le_atClient_SetFinalResponse(cmdRef, "OK|ERROR|+CME ERROR"));
-    LE_ASSERT_OK(le_atClient_SetIntermediateResponse(cmdRef, "+CREG:"));
-    LE_ASSERT_OK(le_atClient_Send(cmdRef));
+    cmdRef = Create();
+    LE_ASSERT_OK(RESULT(le_atClient_SetDevice(SERVER_CMD_REF, cmdRef, devRef)));
+    LE_ASSERT_OK(RESULT(le_atClient_SetCommand(SERVER_CMD_REF, cmdRef, "AT+CREG?")));
+    LE_ASSERT_OK(RESULT(le_atClient_SetFinalResponse(SERVER_CMD_REF, cmdRef, "OK|ERROR|+CME ERROR")));
+    LE_ASSERT_OK(RESULT(le_atClient_SetIntermediateResponse(SERVER_CMD_REF, cmdRef, "+CREG:")));
+    LE_ASSERT_OK(Send(cmdRef));
 
-    LE_ASSERT_OK(le_atClient_GetFinalResponse(cmdRef, buffer, LE_ATDEFS_RESPONSE_MAX_BYTES));
+    LE_ASSERT_OK(GetResponse(le_atClient_GetFinalResponse, cmdRef, buffer,
+                             LE_ATDEFS_RESPONSE_MAX_BYTES));
     LE_INFO("final rsp: %s", buffer);
     LE_ASSERT(strcmp(buffer, "OK") == 0);
 
     memset(buffer, 0, LE_ATDEFS_RESPONSE_MAX_BYTES);
-    LE_ASSERT_OK(le_atClient_GetFirstIntermediateResponse(cmdRef, buffer,
-                                                          LE_ATDEFS_RESPONSE_MAX_BYTES));
+    LE_ASSERT_OK(GetResponse(le_atClient_GetFirstIntermediateResponse, cmdRef, buffer,
+                             LE_ATDEFS_RESPONSE_MAX_BYTES));
     LE_INFO("inter rsp: %s", buffer);
     LE_ASSERT(strcmp(buffer, "+CREG: 0,1") == 0);
-    LE_ASSERT(le_atClient_GetNextIntermediateResponse(cmdRef, buffer, LE_ATDEFS_RESPONSE_MAX_BYTES)
-              == LE_NOT_FOUND);
-    LE_ASSERT_OK(le_atClient_Delete(cmdRef));
-
-    LE_ASSERT(le_atClient_SetCommandAndSend(&cmdRef, devRef, "AT+CGSN", "", "OK|ERROR|+CME ERROR",
-                                            LE_ATDEFS_COMMAND_DEFAULT_TIMEOUT) == LE_OK);
-    LE_ASSERT(le_atClient_GetFinalResponse(cmdRef, buffer, LE_ATDEFS_RESPONSE_MAX_BYTES) == LE_OK);
+    LE_ASSERT(GetResponse(le_atClient_GetNextIntermediateResponse, cmdRef, buffer,
+                          LE_ATDEFS_RESPONSE_MAX_BYTES) == LE_NOT_FOUND);
+    LE_ASSERT_OK(RESULT(le_atClient_Delete(SERVER_CMD_REF, cmdRef)));
+
+    LE_ASSERT(SetCommandAndSend(&cmdRef, devRef, "AT+CGSN", "", "OK|ERROR|+CME ERROR",
+                                LE_ATDEFS_COMMAND_DEFAULT_TIMEOUT) == LE_OK);
+    LE_ASSERT(GetResponse(le_atClient_GetFinalResponse, cmdRef, buffer,
+                          LE_ATDEFS_RESPONSE_MAX_BYTES) == LE_OK);
     LE_INFO("final rsp: %s", buffer);
     LE_ASSERT(strcmp(buffer, "OK") == 0);
 
     memset(buffer, 0, LE_ATDEFS_RESPONSE_MAX_BYTES);
-    LE_ASSERT_OK(le_atClient_GetFirstIntermediateResponse(cmdRef, buffer,
-                                                          LE_ATDEFS_RESPONSE_MAX_BYTES));
+    LE_ASSERT_OK(GetResponse(le_atClient_GetFirstIntermediateResponse, cmdRef, buffer,
+                             LE_ATDEFS_RESPONSE_MAX_BYTES));
     LE_INFO("inter rsp: %s", buffer);
     LE_ASSERT(strcmp(buffer, "359377060033064") == 0);
 
-    LE_ASSERT(le_atClient_GetNextIntermediateResponse(cmdRef, buffer, LE_ATDEFS_RESPONSE_MAX_BYTES)
-              == LE_NOT_FOUND);
-    LE_ASSERT(le_atClient_Delete(cmdRef) == LE_OK);
+    LE_ASSERT(GetResponse(le_atClient_GetNextIntermediateResponse, cmdRef, buffer,
+                          LE_ATDEFS_RESPONSE_MAX_BYTES) == LE_NOT_FOUND);
+    LE_ASSERT(RESULT(le_atClient_Delete(SERVER_CMD_REF, cmdRef)) == LE_OK);
 
     // Try to stop the device
-    LE_ASSERT_OK(le_atClient_Stop(devRef));
-    LE_ASSERT(le_atClient_Stop(devRef) == LE_FAULT);
+    LE_ASSERT_OK(RESULT(le_atClient_Stop(SERVER_CMD_REF, devRef)));
+    LE_ASSERT(RESULT(le_atClient_Stop(SERVER_CMD_REF, devRef)) == LE_FAULT);
 
     Testle_atClientSetTextFalseTest();
     Testle_atClientSendFalseTest();
@@ -221,6 +363,7 @@ COMPONENT_INIT
     SharedData.devPathPtr = "\0at-dev";
     SharedData.semRef = le_sem_Create("AtUnitTestSem", 0);
     SharedData.atClientThread = le_thread_GetCurrent();
+    InitResponses();
 
     atClientThread = le_thread_Create("atClientThread", AtClient, (void *)&SharedData);
     le_thread_Start(atClientThread);
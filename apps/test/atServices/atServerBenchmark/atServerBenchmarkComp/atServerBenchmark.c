@@ -0,0 +1,353 @@
+/**
+ * This module implements a benchmark of the AT commands server.
+ *
+ * A pseudo-terminal is opened and its slave side is given to the AT server.  A host thread plays
+ * scripted AT traffic on the master side, waits for the responses and logs how many commands per
+ * second and how many unsolicited responses per second went through the AT server:
+ *  - one command per line,
+ *  - several concatenated commands per line,
+ *  - a burst of unsolicited responses.
+ *
+ * Issue the following commands:
+ * @verbatim
+  $ app start atServerBenchmark
+  $ app runProc atServerBenchmark --exe=atServerBenchmark -- [<number of command lines>]
+  @endverbatim
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include <poll.h>
+#include <termios.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default number of command lines sent in each phase.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_LINE_COUNT          1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of intermediate responses sent by the benchmark command.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INTERMEDIATE_RSP_COUNT      3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of commands concatenated in one line.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CONCAT_CMD_COUNT            4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to wait for a response before giving up, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RSP_TIMEOUT_MS              5000
+
+#define SINGLE_CMD_LINE     "AT+BENCH\r"
+#define CONCAT_CMD_LINE     "AT+BENCH;+BENCH;+BENCH;+BENCH\r"
+#define FINAL_RSP           "OK\r\n"
+#define UNSOL_RSP_PREFIX    "+BURC"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Master side of the pseudo-terminal, used by the host thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static int MasterFd = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AT server device opened on the slave side of the pseudo-terminal.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_atServer_DeviceRef_t DevRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of command lines sent in each phase.
+ */
+//--------------------------------------------------------------------------------------------------
+static int LineCount = DEFAULT_LINE_COUNT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main thread, where the AT server API is used.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t MainThreadRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read from the master side of the pseudo-terminal until a pattern has been received a given
+ * number of times.
+ *
+ * @note The first character of the pattern must not appear anywhere else in it.
+ *
+ * @return
+ *      - LE_OK         The pattern was received.
+ *      - LE_TIMEOUT    Nothing was received for RSP_TIMEOUT_MS.
+ *      - LE_FAULT      The read failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitFor
+(
+    const char* patternPtr,     ///< [IN] Pattern to look for
+    int count                   ///< [IN] Number of times it has to be received
+)
+{
+    size_t patternLen = strlen(patternPtr);
+    size_t matched = 0;
+    char buf[1024];
+
+    while (count > 0)
+    {
+        struct pollfd pfd = { .fd = MasterFd, .events = POLLIN };
+        int ret = poll(&pfd, 1, RSP_TIMEOUT_MS);
+
+        if (ret == 0)
+        {
+            LE_ERROR("Timeout, %d '%s' still expected", count, patternPtr);
+            return LE_TIMEOUT;
+        }
+        if ((ret < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+
+        ssize_t size = (ret < 0) ? -1 : read(MasterFd, buf, sizeof(buf));
+        if (size < 0)
+        {
+            if ((errno == EINTR) || (errno == EAGAIN))
+            {
+                continue;
+            }
+            LE_ERROR("read failed: %m");
+            return LE_FAULT;
+        }
+
+        ssize_t i;
+        for (i = 0; (i < size) && (count > 0); i++)
+        {
+            if (buf[i] == patternPtr[matched])
+            {
+                matched++;
+                if (matched == patternLen)
+                {
+                    matched = 0;
+                    count--;
+                }
+            }
+            else
+            {
+                matched = (buf[i] == patternPtr[0]) ? 1 : 0;
+            }
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole command line on the master side of the pseudo-terminal.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteLine
+(
+    const char* linePtr     ///< [IN] Command line
+)
+{
+    size_t len = strlen(linePtr);
+
+    while (len > 0)
+    {
+        ssize_t size = write(MasterFd, linePtr, len);
+        if (size < 0)
+        {
+            LE_FATAL_IF(errno != EINTR, "write failed: %m");
+            continue;
+        }
+        linePtr += size;
+        len -= size;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute a rate per second.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t Rate
+(
+    int count,              ///< [IN] Number of things done
+    le_clk_Time_t start     ///< [IN] When they started
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    uint64_t usec = (uint64_t) elapsed.sec * 1000000 + elapsed.usec;
+
+    return (usec == 0) ? 0 : ((uint64_t) count * 1000000 / usec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the command lines one at a time, waiting for the final response of each, and log the rate.
+ *
+ * @return Number of commands per second.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t RunCommandPhase
+(
+    const char* linePtr,    ///< [IN] Command line
+    int cmdPerLine          ///< [IN] Number of commands in the line
+)
+{
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    int i;
+
+    for (i = 0; i < LineCount; i++)
+    {
+        WriteLine(linePtr);
+        LE_ASSERT_OK(WaitFor(FINAL_RSP, 1));
+    }
+
+    return Rate(LineCount * cmdPerLine, start);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a burst of unsolicited responses.  Runs in the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendUnsolicitedBurst
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    char rsp[LE_ATDEFS_RESPONSE_MAX_BYTES];
+    int i;
+
+    for (i = 0; i < LineCount; i++)
+    {
+        snprintf(rsp, sizeof(rsp), UNSOL_RSP_PREFIX ": %d", i);
+        LE_ASSERT_OK(le_atServer_SendUnsolicitedResponse(rsp, LE_ATSERVER_SPECIFIC_DEVICE,
+                                                         DevRef));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Host thread: plays the AT traffic and logs the results.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* HostThread
+(
+    void* contextPtr
+)
+{
+    uint64_t singleRate = RunCommandPhase(SINGLE_CMD_LINE, 1);
+    LE_INFO("One command per line: %d commands, %" PRIu64 " commands/s",
+            LineCount, singleRate);
+
+    uint64_t concatRate = RunCommandPhase(CONCAT_CMD_LINE, CONCAT_CMD_COUNT);
+    LE_INFO("%d commands per line: %d commands, %" PRIu64 " commands/s",
+            CONCAT_CMD_COUNT, LineCount * CONCAT_CMD_COUNT, concatRate);
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    le_event_QueueFunctionToThread(MainThreadRef, SendUnsolicitedBurst, NULL, NULL);
+    LE_ASSERT_OK(WaitFor(UNSOL_RSP_PREFIX, LineCount));
+    LE_INFO("Unsolicited responses: %d responses, %" PRIu64 " responses/s",
+            LineCount, Rate(LineCount, start));
+
+    LE_INFO("======== ATServer benchmark done ========");
+    exit(EXIT_SUCCESS);
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark command handler: sends a few intermediate responses and OK.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchCmdHandler
+(
+    le_atServer_CmdRef_t commandRef,
+    le_atServer_Type_t type,
+    uint32_t parametersNumber,
+    void* contextPtr
+)
+{
+    int i;
+
+    for (i = 0; i < INTERMEDIATE_RSP_COUNT; i++)
+    {
+        LE_ASSERT_OK(le_atServer_SendIntermediateResponse(commandRef, "+BENCH: 0123456789"));
+    }
+
+    LE_ASSERT_OK(le_atServer_SendFinalResultCode(commandRef, LE_ATSERVER_OK, "", 0));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a pseudo-terminal in raw mode.
+ *
+ * @return File descriptor of the slave side.
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenPty
+(
+    void
+)
+{
+    struct termios tios;
+
+    MasterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    LE_FATAL_IF(MasterFd < 0, "posix_openpt failed: %m");
+    LE_FATAL_IF((grantpt(MasterFd) != 0) || (unlockpt(MasterFd) != 0),
+                "Cannot unlock pseudo-terminal: %m");
+
+    const char* slaveNamePtr = ptsname(MasterFd);
+    LE_FATAL_IF(slaveNamePtr == NULL, "ptsname failed: %m");
+
+    int slaveFd = open(slaveNamePtr, O_RDWR | O_NOCTTY);
+    LE_FATAL_IF(slaveFd < 0, "Cannot open %s: %m", slaveNamePtr);
+
+    LE_FATAL_IF(tcgetattr(slaveFd, &tios) != 0, "tcgetattr failed: %m");
+    cfmakeraw(&tios);
+    LE_FATAL_IF(tcsetattr(slaveFd, TCSANOW, &tios) != 0, "tcsetattr failed: %m");
+
+    LE_INFO("AT server benchmark on %s", slaveNamePtr);
+
+    return slaveFd;
+}
+
+COMPONENT_INIT
+{
+    if (le_arg_NumArgs() >= 1)
+    {
+        LineCount = atoi(le_arg_GetArg(0));
+        LE_FATAL_IF(LineCount <= 0, "Invalid number of command lines '%s'", le_arg_GetArg(0));
+    }
+
+    MainThreadRef = le_thread_GetCurrent();
+
+    int slaveFd = OpenPty();
+    DevRef = le_atServer_Open(slaveFd);
+    LE_FATAL_IF(DevRef == NULL, "Cannot open the AT server device");
+
+    le_atServer_CmdRef_t cmdRef = le_atServer_Create("AT+BENCH");
+    LE_FATAL_IF(cmdRef == NULL, "Cannot create AT+BENCH");
+    le_atServer_AddCommandHandler(cmdRef, BenchCmdHandler, NULL);
+
+    le_thread_Start(le_thread_Create("AtBenchHost", HostThread, NULL));
+}
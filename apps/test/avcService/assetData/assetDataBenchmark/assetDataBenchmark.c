@@ -0,0 +1,391 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drives UPDATES_PER_SEC updates of observed asset data fields through assetData_client_SetInt()
+ * for RUN_SECS seconds, and logs the cpu time used and the notifications sent.  Also times
+ * updates as fast as possible, and reads of an object whose fields did or did not change.
+ *
+ * The platform adaptor is replaced by the stubs below, which count the notifications.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+#include "assetData.h"
+#include "pa_avc.h"
+
+#include <time.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asset used by the benchmark, from asset_v2.cfg, and its observed integer fields.
+ */
+//--------------------------------------------------------------------------------------------------
+#define APP_NAME        "testOne"
+#define ASSET_ID        1000
+static const int FieldIds[] = { 0, 4, 8 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of instances of the asset updated in turn.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_INSTANCES   10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rate and duration of the paced updates.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UPDATES_PER_SEC 10000
+#define TICK_MS         10
+#define RUN_SECS        5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of updates and reads of the unpaced measurements.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_UPDATES     10000
+#define NUM_READS       10000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Instances of the asset.
+ */
+//--------------------------------------------------------------------------------------------------
+static assetData_InstanceDataRef_t InstanceRefs[NUM_INSTANCES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of updates done so far; also gives the next value written.
+ */
+//--------------------------------------------------------------------------------------------------
+static int NumUpdates;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of updates which failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static int NumErrors;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notifications sent through the platform adaptor stub.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t NumNotifications;
+static size_t NumNotifyBytes;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the paced updates.
+ */
+//--------------------------------------------------------------------------------------------------
+static int NumTicks;
+static struct timespec CpuStart;
+static le_clk_Time_t StartTime;
+static size_t NumNotificationsStart;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Platform adaptor stubs.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_avc_LWM2MOperationDataRef_t pa_avc_CreateOpData
+(
+    char* prefixPtr,
+    int objId,
+    int objInstId,
+    int resourceId,
+    pa_avc_OpType_t opType,
+    uint16_t contentType,
+    uint8_t* tokenPtr,
+    uint8_t tokenLength
+)
+{
+    static int opData;
+
+    return (pa_avc_LWM2MOperationDataRef_t)&opData;
+}
+
+void pa_avc_NotifyChange
+(
+    pa_avc_LWM2MOperationDataRef_t notifyOpRef,
+    uint8_t* respPayloadPtr,
+    size_t respPayloadNumBytes
+)
+{
+    NumNotifications++;
+    NumNotifyBytes += respPayloadNumBytes;
+}
+
+void pa_avc_ReadCallBackReport
+(
+    pa_avc_LWM2MOperationDataRef_t opRef,
+    uint8_t* respPayloadPtr,
+    size_t respPayloadNumBytes
+)
+{
+}
+
+le_result_t pa_avc_RegistrationUpdate
+(
+    const char* updatePtr,
+    size_t updateNumBytes,
+    size_t updateCount
+)
+{
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the cpu time used by the process, in microseconds, since the given time.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetCpuUs
+(
+    const struct timespec* startPtr     ///< [IN] Start time.
+)
+{
+    struct timespec now;
+
+    LE_ASSERT(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) == 0);
+
+    return (uint64_t)(now.tv_sec - startPtr->tv_sec) * 1000000 +
+           (now.tv_nsec - startPtr->tv_nsec) / 1000;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since the given time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedUs
+(
+    le_clk_Time_t start     ///< [IN] Start time.
+)
+{
+    le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return (uint64_t)duration.sec * 1000000 + duration.usec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the next numUpdates fields, going through the fields of all the instances in turn.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Update
+(
+    int numUpdates      ///< [IN] Number of updates.
+)
+{
+    int i;
+
+    for (i = 0; i < numUpdates; i++)
+    {
+        int field = NumUpdates % NUM_ARRAY_MEMBERS(FieldIds);
+        int instance = (NumUpdates / NUM_ARRAY_MEMBERS(FieldIds)) % NUM_INSTANCES;
+
+        if (assetData_client_SetInt(InstanceRefs[instance], FieldIds[field], NumUpdates) != LE_OK)
+        {
+            NumErrors++;
+        }
+        NumUpdates++;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time NUM_READS reads of the object, with or without a field change before each read.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TimeReads
+(
+    assetData_AssetDataRef_t assetRef,      ///< [IN] Asset to read.
+    bool isChanged                          ///< [IN] Change a field before each read?
+)
+{
+    uint8_t buf[NUM_INSTANCES * 256];
+    size_t numBytes;
+    int errors = 0;
+    int i;
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    uint64_t us;
+
+    for (i = 0; i < NUM_READS; i++)
+    {
+        if (isChanged)
+        {
+            Update(1);
+        }
+        if (assetData_WriteObjectToTLV(assetRef, -1, buf, sizeof(buf), &numBytes) != LE_OK)
+        {
+            errors++;
+        }
+    }
+
+    us = GetElapsedUs(start);
+    LE_TEST_OK(errors == 0, "Read the object %s a change", isChanged ? "after" : "without");
+    LE_TEST_INFO("%d reads %s a change: %" PRIu64 " ms, %" PRIu64 " reads/s", NUM_READS,
+                 isChanged ? "after" : "without", us / 1000,
+                 (us > 0) ? NUM_READS * (uint64_t)1000000 / us : 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a read of the object gives the new value of a changed field, then the same TLV as
+ * long as nothing changes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckReads
+(
+    assetData_AssetDataRef_t assetRef       ///< [IN] Asset to read.
+)
+{
+    uint8_t before[NUM_INSTANCES * 256];
+    uint8_t after[NUM_INSTANCES * 256];
+    uint8_t again[NUM_INSTANCES * 256];
+    size_t beforeNumBytes;
+    size_t afterNumBytes;
+    size_t againNumBytes;
+    int value;
+
+    LE_TEST_OK(assetData_WriteObjectToTLV(assetRef, -1, before, sizeof(before),
+                                          &beforeNumBytes) == LE_OK, "Read the object");
+    LE_TEST_OK(assetData_client_GetInt(InstanceRefs[0], FieldIds[0], &value) == LE_OK,
+               "Get a field");
+    LE_TEST_OK(assetData_client_SetInt(InstanceRefs[0], FieldIds[0], value + 1) == LE_OK,
+               "Change the field");
+    LE_TEST_OK(assetData_WriteObjectToTLV(assetRef, -1, after, sizeof(after),
+                                          &afterNumBytes) == LE_OK, "Read the object again");
+    LE_TEST_OK(assetData_WriteObjectToTLV(assetRef, -1, again, sizeof(again),
+                                          &againNumBytes) == LE_OK, "Read the object once more");
+
+    LE_TEST_OK((afterNumBytes == beforeNumBytes) && (memcmp(after, before, afterNumBytes) != 0),
+               "The change is read");
+    LE_TEST_OK((againNumBytes == afterNumBytes) && (memcmp(again, after, againNumBytes) == 0),
+               "An unchanged object is read the same");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that all the changes were notified, and end the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DrainTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    LE_TEST_INFO("%zu notifications, %zu bytes in total", NumNotifications, NumNotifyBytes);
+    LE_TEST_OK(NumNotifications > 0, "Changes notified");
+
+    LE_TEST_EXIT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Do the updates of a tick, and log the results after RUN_SECS.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TickHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    int numUpdates;
+    uint64_t cpuUs;
+    uint64_t us;
+    le_timer_Ref_t drainTimer;
+
+    Update(UPDATES_PER_SEC * TICK_MS / 1000);
+
+    if (++NumTicks < RUN_SECS * 1000 / TICK_MS)
+    {
+        return;
+    }
+
+    le_timer_Stop(timerRef);
+
+    cpuUs = GetCpuUs(&CpuStart);
+    us = GetElapsedUs(StartTime);
+    numUpdates = NumTicks * UPDATES_PER_SEC * TICK_MS / 1000;
+    LE_TEST_OK(NumErrors == 0, "Paced updates");
+    LE_TEST_INFO("%d paced updates in %" PRIu64 " ms: %" PRIu64 " ms cpu (%" PRIu64 "%%),"
+                 " %" PRIu64 " ns cpu per update, %zu notifications", numUpdates, us / 1000,
+                 cpuUs / 1000, (us > 0) ? cpuUs * 100 / us : 0, cpuUs * 1000 / numUpdates,
+                 NumNotifications - NumNotificationsStart);
+
+    // Leave time for the last changes to be notified.
+    drainTimer = le_timer_Create("Drain");
+    LE_ASSERT(le_timer_SetMsInterval(drainTimer, LE_CONFIG_AVC_NOTIFY_COALESCE_MS + 100) == LE_OK);
+    le_timer_SetHandler(drainTimer, DrainTimerHandler);
+    LE_ASSERT(le_timer_Start(drainTimer) == LE_OK);
+}
+
+
+COMPONENT_INIT
+{
+    static uint8_t token[] = { 0xbe, 0x1c, 0x4a, 0x11 };
+    assetData_AssetDataRef_t assetRef;
+    le_timer_Ref_t tickTimer;
+    le_clk_Time_t start;
+    uint64_t us;
+    int i;
+
+    LE_TEST_PLAN(LE_TEST_NO_PLAN);
+
+    assetData_Init();
+
+    for (i = 0; i < NUM_INSTANCES; i++)
+    {
+        LE_TEST_ASSERT(assetData_CreateInstanceById(APP_NAME, ASSET_ID, -1,
+                                                    &InstanceRefs[i]) == LE_OK,
+                       "Create instance %d", i);
+        LE_TEST_ASSERT(assetData_SetObserve(InstanceRefs[i], true, token, sizeof(token)) == LE_OK,
+                       "Observe instance %d", i);
+    }
+    LE_TEST_ASSERT(assetData_GetAssetRefById(APP_NAME, ASSET_ID, &assetRef) == LE_OK,
+                   "Get asset");
+
+    LE_TEST_INFO("=== %d instances, coalescing over %d ms ===", NUM_INSTANCES,
+                 LE_CONFIG_AVC_NOTIFY_COALESCE_MS);
+
+    CheckReads(assetRef);
+    TimeReads(assetRef, false);
+    TimeReads(assetRef, true);
+
+    start = le_clk_GetRelativeTime();
+    Update(NUM_UPDATES);
+    us = GetElapsedUs(start);
+    LE_TEST_OK(NumErrors == 0, "Unpaced updates");
+    LE_TEST_INFO("%d unpaced updates: %" PRIu64 " ms, %" PRIu64 " updates/s", NUM_UPDATES,
+                 us / 1000, (us > 0) ? NUM_UPDATES * (uint64_t)1000000 / us : 0);
+
+    // Count the notifications sent from now on.
+    NumNotificationsStart = NumNotifications;
+
+    // Updates at UPDATES_PER_SEC, in batches every TICK_MS.
+    LE_ASSERT(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &CpuStart) == 0);
+    StartTime = le_clk_GetRelativeTime();
+    tickTimer = le_timer_Create("Tick");
+    LE_ASSERT(le_timer_SetMsInterval(tickTimer, TICK_MS) == LE_OK);
+    LE_ASSERT(le_timer_SetRepeat(tickTimer, 0) == LE_OK);
+    le_timer_SetHandler(tickTimer, TickHandler);
+    LE_ASSERT(le_timer_Start(tickTimer) == LE_OK);
+}
@@ -326,6 +326,47 @@ void RunTest(void)
     LE_TEST(LE_FAULT == assetData_client_GetString(testOneRefZero, 4, strBuf, sizeof(strBuf)));
 
 
+    banner("Write field lists");
+    assetData_FieldValue_t valueList[3];
+    assetData_FieldDataRef_t fieldRef;
+
+    LE_TEST(LE_OK == assetData_GetFieldRefFromName(testOneRefZero, "Bedroom/temp",
+                                                   &valueList[0].fieldRef));
+    valueList[0].type = ASSET_DATA_TYPE_INT;
+    valueList[0].intValue = 25;
+    valueList[0].timeStamp = 0;
+    LE_TEST(LE_OK == assetData_GetFieldRefFromName(testOneRefZero, "Livingroom/temp",
+                                                   &valueList[1].fieldRef));
+    valueList[1].type = ASSET_DATA_TYPE_INT;
+    valueList[1].intValue = 22;
+    valueList[1].timeStamp = 0;
+    LE_TEST(LE_OK == assetData_GetFieldRefFromName(testOneRefZero, "Bathroom/humidity",
+                                                   &valueList[2].fieldRef));
+    valueList[2].type = ASSET_DATA_TYPE_FLOAT;
+    valueList[2].floatValue = 55.5;
+    valueList[2].timeStamp = 0;
+    LE_TEST(LE_FAULT == assetData_GetFieldRefFromName(testOneRefZero, "Attic/temp", &fieldRef));
+
+    LE_TEST(LE_OK == assetData_client_SetFieldList(testOneRefZero, valueList, 3));
+    LE_TEST(LE_OK == assetData_client_GetInt(testOneRefZero, 4, &value));
+    LE_TEST(25 == value);
+    LE_TEST(LE_OK == assetData_client_GetInt(testOneRefZero, 0, &value));
+    LE_TEST(22 == value);
+    LE_TEST(LE_OK == assetData_client_GetFloat(testOneRefZero, 14, &float_value));
+    LE_TEST(55.5 == float_value);
+
+    // The values after one of the wrong type are not set
+    valueList[0].intValue = 26;
+    valueList[1].type = ASSET_DATA_TYPE_STRING;
+    valueList[1].strValuePtr = "new value";
+    valueList[2].floatValue = 66.6;
+    LE_TEST(LE_FAULT == assetData_client_SetFieldList(testOneRefZero, valueList, 3));
+    LE_TEST(LE_OK == assetData_client_GetInt(testOneRefZero, 4, &value));
+    LE_TEST(26 == value);
+    LE_TEST(LE_OK == assetData_client_GetFloat(testOneRefZero, 14, &float_value));
+    LE_TEST(55.5 == float_value);
+
+
     banner("Field write int handlers");
 
     LE_TEST(NULL != assetData_server_AddFieldActionHandler(testOneAssetRef, 4,
@@ -0,0 +1,292 @@
+/**
+ * This program tests the time series store of the avcDaemon.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "timeSeriesStore.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of the ring used by the tests, small enough for the samples to wrap around.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_NUMBYTES   4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time stamp of the first sample.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FIRST_TIME_STAMP    1500000000000ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the store files.
+ */
+//--------------------------------------------------------------------------------------------------
+static char TestDir[] = "/tmp/timeSeriesStoreTestXXXXXX";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the integer sample i.
+ */
+//--------------------------------------------------------------------------------------------------
+static int64_t IntValue
+(
+    int i
+)
+{
+    return 1000 + i + (i % 7) - 3;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a store holds the last samples added by TestInt().
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckIntSamples
+(
+    timeSeriesStore_Ref_t storeRef,
+    int lastIndex
+)
+{
+    timeSeriesStore_Cursor_t cursor;
+    timeSeriesStore_Sample_t sample;
+    uint32_t count = timeSeriesStore_GetCount(storeRef);
+    int i = lastIndex - count + 1;
+
+    timeSeriesStore_StartRead(storeRef, &cursor);
+    while (timeSeriesStore_ReadNext(storeRef, &cursor, &sample) == LE_OK)
+    {
+        if ((sample.timeStamp != FIRST_TIME_STAMP + i * 100) || (sample.intValue != IntValue(i)))
+        {
+            LE_TEST_INFO("Sample %d: %" PRIu64 " %" PRId64, i, sample.timeStamp, sample.intValue);
+            return false;
+        }
+        i++;
+    }
+
+    return (i == lastIndex + 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Integer samples: wrap around, persistence and consumption.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestInt
+(
+    void
+)
+{
+    char path[PATH_MAX];
+    timeSeriesStore_Cursor_t cursor;
+    timeSeriesStore_Sample_t sample;
+    uint32_t count;
+    int i;
+
+    snprintf(path, sizeof(path), "%s/int", TestDir);
+
+    timeSeriesStore_Ref_t storeRef = timeSeriesStore_Open(path, TIME_SERIES_STORE_TYPE_INT,
+                                                          RING_NUMBYTES, 0);
+    LE_TEST_ASSERT(storeRef != NULL, "Open integer store");
+
+    for (i = 0; i < 10000; i++)
+    {
+        LE_ASSERT_OK(timeSeriesStore_AddInt(storeRef, FIRST_TIME_STAMP + i * 100, IntValue(i)));
+    }
+    count = timeSeriesStore_GetCount(storeRef);
+    LE_TEST_INFO("%" PRIu32 " integer samples in %d bytes", count, RING_NUMBYTES);
+    LE_TEST_OK((count > RING_NUMBYTES / 4) && (count < 10000), "Oldest samples dropped");
+    LE_TEST_OK(CheckIntSamples(storeRef, 9999), "Newest samples kept");
+    LE_TEST_OK(timeSeriesStore_AddFloat(storeRef, FIRST_TIME_STAMP, 1.0) == LE_BAD_PARAMETER,
+               "Wrong type rejected");
+
+    timeSeriesStore_Close(storeRef, false);
+
+    storeRef = timeSeriesStore_Open(path, TIME_SERIES_STORE_TYPE_INT, RING_NUMBYTES, 0);
+    LE_TEST_ASSERT(storeRef != NULL, "Reopen integer store");
+    LE_TEST_OK(timeSeriesStore_GetCount(storeRef) == count, "Samples kept after reopening");
+    LE_TEST_OK(CheckIntSamples(storeRef, 9999), "Samples read after reopening");
+
+    timeSeriesStore_StartRead(storeRef, &cursor);
+    for (i = 0; i < 10; i++)
+    {
+        LE_ASSERT_OK(timeSeriesStore_ReadNext(storeRef, &cursor, &sample));
+    }
+    timeSeriesStore_Consume(storeRef, &cursor);
+    LE_TEST_OK(timeSeriesStore_GetCount(storeRef) == count - 10, "Samples read consumed");
+    LE_TEST_OK(CheckIntSamples(storeRef, 9999), "Other samples kept");
+
+    for (i = 10000; i < 10010; i++)
+    {
+        LE_ASSERT_OK(timeSeriesStore_AddInt(storeRef, FIRST_TIME_STAMP + i * 100, IntValue(i)));
+    }
+    LE_TEST_OK(CheckIntSamples(storeRef, 10009), "Samples added after consumption");
+
+    timeSeriesStore_StartRead(storeRef, &cursor);
+    while (timeSeriesStore_ReadNext(storeRef, &cursor, &sample) == LE_OK)
+    {
+    }
+    timeSeriesStore_Consume(storeRef, &cursor);
+    LE_TEST_OK(timeSeriesStore_GetCount(storeRef) == 0, "All samples consumed");
+
+    LE_ASSERT_OK(timeSeriesStore_AddInt(storeRef, FIRST_TIME_STAMP + 10010 * 100,
+                                        IntValue(10010)));
+    LE_TEST_OK(CheckIntSamples(storeRef, 10010), "Sample added to empty store");
+
+    timeSeriesStore_Close(storeRef, true);
+    LE_TEST_OK(access(path, F_OK) != 0, "Store file removed");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Floating point samples, and a store reopened with another type.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestFloat
+(
+    void
+)
+{
+    char path[PATH_MAX];
+    timeSeriesStore_Cursor_t cursor;
+    timeSeriesStore_Sample_t sample;
+    bool isOk = true;
+    int i;
+
+    snprintf(path, sizeof(path), "%s/float", TestDir);
+
+    timeSeriesStore_Ref_t storeRef = timeSeriesStore_Open(path, TIME_SERIES_STORE_TYPE_INT,
+                                                          RING_NUMBYTES, 0);
+    LE_ASSERT(storeRef != NULL);
+    LE_ASSERT_OK(timeSeriesStore_AddInt(storeRef, FIRST_TIME_STAMP, 1));
+    timeSeriesStore_Close(storeRef, false);
+
+    storeRef = timeSeriesStore_Open(path, TIME_SERIES_STORE_TYPE_FLOAT, RING_NUMBYTES, 0);
+    LE_TEST_ASSERT(storeRef != NULL, "Open floating point store");
+    LE_TEST_OK(timeSeriesStore_GetCount(storeRef) == 0, "Samples of another type dropped");
+
+    for (i = 0; i < 1000; i++)
+    {
+        LE_ASSERT_OK(timeSeriesStore_AddFloat(storeRef, FIRST_TIME_STAMP + i * 1000,
+                                              20.0 + (i / 10) * 0.5));
+    }
+
+    timeSeriesStore_StartRead(storeRef, &cursor);
+    for (i = 1000 - timeSeriesStore_GetCount(storeRef);
+         timeSeriesStore_ReadNext(storeRef, &cursor, &sample) == LE_OK;
+         i++)
+    {
+        isOk = isOk && (sample.timeStamp == FIRST_TIME_STAMP + i * 1000) &&
+                       (sample.floatValue == 20.0 + (i / 10) * 0.5);
+    }
+    LE_TEST_OK(isOk && (i == 1000), "Floating point samples read back");
+
+    timeSeriesStore_Close(storeRef, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retention period, with boolean samples.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestMaxAge
+(
+    void
+)
+{
+    char path[PATH_MAX];
+    timeSeriesStore_Cursor_t cursor;
+    timeSeriesStore_Sample_t sample;
+    int i;
+
+    snprintf(path, sizeof(path), "%s/bool", TestDir);
+
+    timeSeriesStore_Ref_t storeRef = timeSeriesStore_Open(path, TIME_SERIES_STORE_TYPE_BOOL,
+                                                          RING_NUMBYTES, 60);
+    LE_TEST_ASSERT(storeRef != NULL, "Open boolean store");
+
+    // One sample per second, the last minute is kept.
+    for (i = 0; i < 1000; i++)
+    {
+        LE_ASSERT_OK(timeSeriesStore_AddBool(storeRef, FIRST_TIME_STAMP + i * 1000, i & 1));
+    }
+    LE_TEST_OK(timeSeriesStore_GetCount(storeRef) == 61, "Samples older than a minute dropped");
+
+    timeSeriesStore_StartRead(storeRef, &cursor);
+    LE_ASSERT_OK(timeSeriesStore_ReadNext(storeRef, &cursor, &sample));
+    LE_TEST_OK((sample.timeStamp == FIRST_TIME_STAMP + 939 * 1000) && sample.boolValue,
+               "Oldest sample kept");
+
+    timeSeriesStore_Close(storeRef, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * String samples.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestString
+(
+    void
+)
+{
+    char path[PATH_MAX];
+    char value[TIME_SERIES_STORE_STRING_BYTES];
+    char longValue[TIME_SERIES_STORE_STRING_BYTES + 1];
+    timeSeriesStore_Cursor_t cursor;
+    timeSeriesStore_Sample_t sample;
+    bool isOk = true;
+    int i;
+
+    snprintf(path, sizeof(path), "%s/string", TestDir);
+
+    timeSeriesStore_Ref_t storeRef = timeSeriesStore_Open(path, TIME_SERIES_STORE_TYPE_STRING,
+                                                          RING_NUMBYTES, 0);
+    LE_TEST_ASSERT(storeRef != NULL, "Open string store");
+
+    for (i = 0; i < 100; i++)
+    {
+        snprintf(value, sizeof(value), "value %d %*s", i, i, "");
+        LE_ASSERT_OK(timeSeriesStore_AddString(storeRef, FIRST_TIME_STAMP + i, value));
+    }
+
+    timeSeriesStore_StartRead(storeRef, &cursor);
+    for (i = 100 - timeSeriesStore_GetCount(storeRef);
+         timeSeriesStore_ReadNext(storeRef, &cursor, &sample) == LE_OK;
+         i++)
+    {
+        snprintf(value, sizeof(value), "value %d %*s", i, i, "");
+        isOk = isOk && (sample.timeStamp == FIRST_TIME_STAMP + i) &&
+                       (strcmp(sample.strValue, value) == 0);
+    }
+    LE_TEST_OK(isOk && (i == 100), "String samples read back");
+
+    memset(longValue, 'x', sizeof(longValue) - 1);
+    longValue[sizeof(longValue) - 1] = '\0';
+    LE_TEST_OK(timeSeriesStore_AddString(storeRef, FIRST_TIME_STAMP + i, longValue) ==
+               LE_OVERFLOW, "Long string rejected");
+
+    timeSeriesStore_Close(storeRef, true);
+}
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(LE_TEST_NO_PLAN);
+
+    LE_TEST_ASSERT(mkdtemp(TestDir) != NULL, "Create test directory");
+
+    timeSeriesStore_Init();
+
+    TestInt();
+    TestFloat();
+    TestMaxAge();
+    TestString();
+
+    le_dir_RemoveRecursive(TestDir);
+
+    LE_TEST_EXIT;
+}
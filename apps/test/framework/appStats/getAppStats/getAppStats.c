@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test of appStats API.  Opens some files and sockets, waits for the Supervisor to sample this app
+ * a few times, then checks its own history.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include <sys/socket.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples to wait for.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_SAMPLES     3
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of socket pairs opened by the test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_SOCKET_PAIRS    4
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the samples taken while the sockets were open.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckHistory
+(
+    le_timer_Ref_t timerRef     ///< [IN] Timer that expired.
+)
+{
+    le_appStats_Sample_t samples[LE_APPSTATS_MAX_SAMPLES];
+    size_t numSamples = NUM_ARRAY_MEMBERS(samples);
+    le_appStats_Sample_t latest;
+
+    LE_TEST_OK(le_appStats_GetHistory("testAppStats", samples, &numSamples) == LE_OK,
+               "Get history of testAppStats");
+    LE_TEST_OK(numSamples >= NUM_SAMPLES - 1, "%" PRIuS " samples kept", numSamples);
+    LE_TEST_ASSERT(numSamples > 0, "At least one sample");
+
+    LE_TEST_OK(le_appStats_GetLatest("testAppStats", &latest) == LE_OK,
+               "Get latest sample of testAppStats");
+    LE_TEST_OK(memcmp(&latest, &samples[numSamples - 1], sizeof(latest)) == 0,
+               "Latest sample is the last of the history");
+    LE_TEST_OK((numSamples < 2) || (samples[0].timestamp < samples[numSamples - 1].timestamp),
+               "Samples are oldest first");
+
+    LE_TEST_OK(latest.numProcs >= 1, "%" PRIu32 " processes", latest.numProcs);
+    LE_TEST_OK(latest.numThreads >= latest.numProcs, "%" PRIu32 " threads", latest.numThreads);
+    LE_TEST_OK(latest.numSockets >= 2 * NUM_SOCKET_PAIRS, "%" PRIu32 " sockets",
+               latest.numSockets);
+    LE_TEST_OK(latest.numFds >= latest.numSockets, "%" PRIu32 " file descriptors",
+               latest.numFds);
+
+    LE_TEST_OK(le_appStats_GetLatest("bogusNonExistantAppName", &latest) == LE_NOT_FOUND,
+               "Non-existant app has no sample");
+
+    LE_TEST_EXIT;
+}
+
+
+COMPONENT_INIT
+{
+    int sockets[2];
+    int i;
+
+    LE_TEST_PLAN(LE_TEST_NO_PLAN);
+
+    uint32_t interval = le_appStats_GetInterval();
+
+    if (interval == 0)
+    {
+        LE_TEST_INFO("Sampling is disabled.");
+        LE_TEST_EXIT;
+    }
+
+    for (i = 0; i < NUM_SOCKET_PAIRS; i++)
+    {
+        LE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+    }
+
+    le_timer_Ref_t timerRef = le_timer_Create("CheckHistory");
+    LE_ASSERT(le_timer_SetMsInterval(timerRef, interval * NUM_SAMPLES) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(timerRef, CheckHistory) == LE_OK);
+    LE_ASSERT(le_timer_Start(timerRef) == LE_OK);
+}
@@ -0,0 +1,460 @@
+/**
+ * This program tests the write-back cache of the Secure Storage Daemon: replay of the journal of a
+ * commit interrupted at every step, recovery from a torn journal, and permanent write errors.
+ *
+ * The platform adaptor is replaced by one storing each item in a file, which can kill the process
+ * before a given write or delete.  Each interrupted commit runs in a child process, and the replay
+ * in another one, since the cache only recovers once per process.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "pa_secStore.h"
+#include "secStoreCache.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Items written in one batch by the tests.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* ItemPaths[] = { "/app/test/a", "/app/test/b", "/app/test/c" };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of platform adaptor operations of a commit of the batch: the journal, the items, and the
+ * deletion of the journal.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMMIT_OPS          (NUM_ARRAY_MEMBERS(ItemPaths) + 2)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the journal item, as known to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_PATH        "/.journal"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the item files.
+ */
+//--------------------------------------------------------------------------------------------------
+static char TestDir[] = "/tmp/secStoreCacheTestXXXXXX";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of the platform adaptor write or delete before which the process is killed, 0 for none.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CrashAtOp = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of platform adaptor writes and deletes done by the process.
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the item the platform adaptor fails to write, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* FailPathPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the file of an item.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetFile
+(
+    const char* pathPtr,
+    char* filePtr,
+    size_t fileSize
+)
+{
+    char* charPtr;
+    int len = snprintf(filePtr, fileSize, "%s/", TestDir);
+
+    LE_ASSERT(le_utf8_Copy(filePtr + len, pathPtr, fileSize - len, NULL) == LE_OK);
+    for (charPtr = filePtr + len; *charPtr != '\0'; charPtr++)
+    {
+        if (*charPtr == '/')
+        {
+            *charPtr = '_';
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count a platform adaptor operation, and kill the process if it is the one to crash at.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountOp
+(
+    void
+)
+{
+    OpCount++;
+    if (OpCount == CrashAtOp)
+    {
+        _exit(EXIT_SUCCESS);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write an item file, atomically.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteFile
+(
+    const char* pathPtr,
+    const void* bufPtr,
+    size_t bufSize
+)
+{
+    char file[PATH_MAX];
+    char tmpFile[PATH_MAX];
+    int fd;
+
+    GetFile(pathPtr, file, sizeof(file));
+    LE_ASSERT(snprintf(tmpFile, sizeof(tmpFile), "%s.tmp", file) < (int)sizeof(tmpFile));
+    fd = open(tmpFile, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(write(fd, bufPtr, bufSize) == (ssize_t)bufSize);
+    close(fd);
+    LE_ASSERT(rename(tmpFile, file) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an item file.
+ *
+ * @return LE_OK, LE_NOT_FOUND or LE_OVERFLOW.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadFile
+(
+    const char* pathPtr,
+    void* bufPtr,
+    size_t* bufSizePtr
+)
+{
+    char file[PATH_MAX];
+    struct stat st;
+    int fd;
+
+    GetFile(pathPtr, file, sizeof(file));
+    fd = open(file, O_RDONLY);
+    if (fd < 0)
+    {
+        return LE_NOT_FOUND;
+    }
+    LE_ASSERT(fstat(fd, &st) == 0);
+    if ((size_t)st.st_size > *bufSizePtr)
+    {
+        close(fd);
+        return LE_OVERFLOW;
+    }
+    LE_ASSERT(read(fd, bufPtr, st.st_size) == st.st_size);
+    close(fd);
+    *bufSizePtr = st.st_size;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Platform adaptor: write an item.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_secStore_Write
+(
+    const char* pathPtr,
+    const uint8_t* bufPtr,
+    size_t bufSize
+)
+{
+    CountOp();
+    if ((FailPathPtr != NULL) && (strcmp(pathPtr, FailPathPtr) == 0))
+    {
+        return LE_FAULT;
+    }
+    WriteFile(pathPtr, bufPtr, bufSize);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Platform adaptor: read an item.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_secStore_Read
+(
+    const char* pathPtr,
+    uint8_t* bufPtr,
+    size_t* bufSizePtr
+)
+{
+    return ReadFile(pathPtr, bufPtr, bufSizePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Platform adaptor: delete an item.  Only items are supported, not directories.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_secStore_Delete
+(
+    const char* pathPtr
+)
+{
+    char file[PATH_MAX];
+
+    CountOp();
+    GetFile(pathPtr, file, sizeof(file));
+
+    return (unlink(file) == 0) ? LE_OK : LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Platform adaptor: get the size of an item.  Only items are supported, not directories.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_secStore_GetSize
+(
+    const char* pathPtr,
+    size_t* sizePtr
+)
+{
+    char file[PATH_MAX];
+    struct stat st;
+
+    GetFile(pathPtr, file, sizeof(file));
+    if (stat(file, &st) != 0)
+    {
+        return LE_NOT_FOUND;
+    }
+    *sizePtr = st.st_size;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that all the items of the batch hold a value.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckItems
+(
+    const char* valuePtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ItemPaths); i++)
+    {
+        char buf[64];
+        size_t size = sizeof(buf) - 1;
+
+        if (ReadFile(ItemPaths[i], buf, &size) != LE_OK)
+        {
+            LE_TEST_INFO("%s: not found", ItemPaths[i]);
+            return false;
+        }
+        buf[size] = '\0';
+        if (strcmp(buf, valuePtr) != 0)
+        {
+            LE_TEST_INFO("%s: '%s' instead of '%s'", ItemPaths[i], buf, valuePtr);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the journal is in secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsJournalThere
+(
+    void
+)
+{
+    size_t size;
+
+    return (pa_secStore_GetSize(JOURNAL_PATH, &size) == LE_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the old values of the batch, then commit the new ones in a child process killed before a
+ * platform adaptor operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CrashCommit
+(
+    int crashAtOp
+)
+{
+    size_t i;
+    pid_t pid;
+    int status;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ItemPaths); i++)
+    {
+        WriteFile(ItemPaths[i], "old", 3);
+    }
+
+    pid = fork();
+    LE_ASSERT(pid >= 0);
+    if (pid == 0)
+    {
+        le_msg_SessionRef_t sessionRef = (le_msg_SessionRef_t)1;
+
+        CrashAtOp = crashAtOp;
+        secStoreCache_Init();
+        secStoreCache_StartBatch(sessionRef);
+        for (i = 0; i < NUM_ARRAY_MEMBERS(ItemPaths); i++)
+        {
+            LE_ASSERT(secStoreCache_Write(ItemPaths[i], (const uint8_t*)"new", 3) == LE_OK);
+        }
+        secStoreCache_EndBatch(sessionRef);
+        _exit(EXIT_FAILURE);
+    }
+
+    LE_ASSERT(waitpid(pid, &status, 0) == pid);
+    LE_TEST_OK(WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS),
+               "Commit killed before operation %d", crashAtOp);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the cache in a child process, which replays the journal if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Restart
+(
+    void
+)
+{
+    pid_t pid = fork();
+    int status;
+
+    LE_ASSERT(pid >= 0);
+    if (pid == 0)
+    {
+        secStoreCache_Init();
+        _exit(EXIT_SUCCESS);
+    }
+
+    LE_ASSERT(waitpid(pid, &status, 0) == pid);
+    LE_TEST_OK(WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS), "Restarted");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A commit killed at any step leaves either all the old values or, after the replay, all the new
+ * ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestReplay
+(
+    void
+)
+{
+    int op;
+
+    for (op = 1; op <= (int)COMMIT_OPS; op++)
+    {
+        CrashCommit(op);
+        LE_TEST_OK(IsJournalThere() == (op > 1), "Journal left by operation %d", op);
+        Restart();
+        LE_TEST_OK(CheckItems((op > 1) ? "new" : "old"), "Batch consistent after operation %d",
+                   op);
+        LE_TEST_OK(!IsJournalThere(), "Journal removed");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A torn journal is discarded without writing anything.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestTornJournal
+(
+    void
+)
+{
+    uint8_t buf[LE_SECSTORE_MAX_ITEM_SIZE];
+    size_t size = sizeof(buf);
+
+    // Killed once the journal is written, before any item.
+    CrashCommit(2);
+    LE_TEST_ASSERT(ReadFile(JOURNAL_PATH, buf, &size) == LE_OK, "Journal written");
+    WriteFile(JOURNAL_PATH, buf, size - 2);
+
+    Restart();
+    LE_TEST_OK(CheckItems("old"), "Items untouched by the torn journal");
+    LE_TEST_OK(!IsJournalThere(), "Torn journal removed");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An item that cannot be written is not served from the cache, and does not prevent the others
+ * from being committed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestWriteError
+(
+    void
+)
+{
+    le_msg_SessionRef_t sessionRef = (le_msg_SessionRef_t)1;
+    uint8_t buf[64];
+    size_t size = sizeof(buf);
+    size_t i;
+
+    secStoreCache_Init();
+
+    FailPathPtr = ItemPaths[1];
+    secStoreCache_StartBatch(sessionRef);
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ItemPaths); i++)
+    {
+        LE_ASSERT(secStoreCache_Write(ItemPaths[i], (const uint8_t*)"err", 3) == LE_OK);
+    }
+    LE_TEST_OK(secStoreCache_EndBatch(sessionRef) == LE_OK, "Batch with a write error ended");
+    FailPathPtr = NULL;
+
+    LE_TEST_OK(secStoreCache_Read(ItemPaths[1], buf, &size) == LE_OK, "Failed item read");
+    LE_TEST_OK((size == 3) && (memcmp(buf, "old", 3) == 0), "Failed item has its stored value");
+
+    size = sizeof(buf);
+    LE_TEST_OK((secStoreCache_Read(ItemPaths[2], buf, &size) == LE_OK) && (size == 3) &&
+               (memcmp(buf, "err", 3) == 0), "Other items committed");
+    LE_TEST_OK(!IsJournalThere(), "Journal removed");
+}
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(LE_TEST_NO_PLAN);
+
+    LE_TEST_ASSERT(mkdtemp(TestDir) != NULL, "Create test directory");
+
+    TestReplay();
+    TestTornJournal();
+    TestWriteError();
+
+    LE_ASSERT(le_dir_RemoveRecursive(TestDir) == LE_OK);
+
+    LE_TEST_EXIT;
+}
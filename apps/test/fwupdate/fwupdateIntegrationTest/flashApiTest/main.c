@@ -10,11 +10,23 @@
   * $ app runProc flashApiTest --exe=flashApiTest -- help
   * @endverbatim
   *
+  * The actions that write a partition can run without touching the device partitions, on a RAM
+  * backed MTD device created by the mtdram or the nandsim kernel module:
+  * @verbatim
+  * $ modprobe mtdram total_size=4096 erase_size=128
+  * $ app runProc flashApiTest --exe=flashApiTest -- stream-short "mtdram test device"
+  * $ app runProc flashApiTest --exe=flashApiTest -- bench "mtdram test device" 1024
+  *
+  * $ modprobe nandsim first_id_byte=0x20 second_id_byte=0xaa third_id_byte=0x00 fourth_id_byte=0x15
+  * $ app runProc flashApiTest --exe=flashApiTest -- stream-short "NAND simulator partition 0"
+  * @endverbatim
+  *
   * Copyright (C) Sierra Wireless Inc.
   *
   */
 
 #include "interfaces.h"
+#include <pthread.h>
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -58,6 +70,11 @@ static le_result_t FlashApiTest_CreateUbi(char **args);
 static le_result_t FlashApiTest_CreateUbiVol(char **args);
 static le_result_t FlashApiTest_DeleteUbiVol(char **args);
 static le_result_t FlashApiTest_CopyUbi(char **args);
+static le_result_t FlashApiTest_StreamFlash(char **args);
+static le_result_t FlashApiTest_StreamDump(char **args);
+static le_result_t FlashApiTest_StreamFlashUbi(char **args);
+static le_result_t FlashApiTest_Bench(char **args);
+static le_result_t FlashApiTest_StreamShort(char **args);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -101,6 +118,23 @@ static FlashApiTest_t FlashApiTest[] =
     { "ubi-copy",       3, FlashApiTest_CopyUbi,
       "ubi-copy sourceName volumeName destinationName: copy the UBI volume from"
            " source to the destination",                                        },
+    { "stream-flash",   2, FlashApiTest_StreamFlash,
+      "stream-flash paritionName fileName: flash the file into the given"
+           " partition through a file descriptor",                              },
+    { "stream-dump",    2, FlashApiTest_StreamDump,
+      "stream-dump paritionName fileName: dump a whole partition into the given"
+           " file through a file descriptor",                                   },
+    { "ubi-stream-flash", 3, FlashApiTest_StreamFlashUbi,
+      "ubi-stream-flash paritionName volumeName fileName: flash the file into"
+           " the given UBI volume through a file descriptor",                   },
+    { "bench",          2, FlashApiTest_Bench,
+      "bench paritionName sizeInKBytes: measure the write and read throughput"
+           " of the block and the file descriptor APIs on the given partition"
+           " (its content is lost)",                                            },
+    { "stream-short",   1, FlashApiTest_StreamShort,
+      "stream-short paritionName: stream one block and a half slowly and check"
+           " that the blocks after them are not erased (the content of the"
+           " first 4 blocks is lost)",                                          },
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -1377,6 +1411,552 @@ static le_result_t FlashApiTest_CopyUbi
 }
 //! [UbiCopy]
 
+//! [StreamFlash]
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flash a file into a MTD partition through a file descriptor
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlashApiTest_StreamFlash
+(
+    char **args
+)
+{
+    const char *partNameStr = args[0];
+    const char *fromFile = args[1];
+    le_flash_PartitionRef_t partRef = NULL;
+    le_result_t res;
+    uint32_t dataSize;
+    int fromFd;
+
+    fromFd = open(fromFile, O_RDONLY);
+    if (-1 == fromFd)
+    {
+        LE_ERROR("Failed to open '%s': %m", fromFile);
+        return LE_FAULT;
+    }
+
+    // Open the given MTD partition in W/O
+    res = le_flash_OpenMtd(partNameStr, LE_FLASH_WRITE_ONLY, &partRef);
+    LE_INFO("partition \"%s\" open ref %p, res %d", partNameStr, partRef, res);
+    if (LE_OK != res)
+    {
+        close(fromFd);
+        return res;
+    }
+
+    // The whole file is written from the block 0. The blocks are erased ahead and the bad blocks
+    // are skipped by the Flash layer. The file descriptor is closed by the service.
+    res = le_flash_WriteFromFd(partRef, 0, fromFd, &dataSize);
+    LE_INFO("Written %u bytes to partition \"%s\", res %d", dataSize, partNameStr, res);
+    if (LE_OK != res)
+    {
+        le_flash_Close(partRef);
+        return res;
+    }
+
+    // Close the MTD
+    res = le_flash_Close(partRef);
+    LE_INFO("partition \"%s\" close ref %p, res %d", partNameStr, partRef, res);
+    return res;
+}
+//! [StreamFlash]
+
+//! [StreamDump]
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dump all blocks from a MTD partition into a file through a file descriptor
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlashApiTest_StreamDump
+(
+    char **args
+)
+{
+    const char *partNameStr = args[0];
+    const char *toFile = args[1];
+    le_flash_PartitionRef_t partRef = NULL;
+    le_result_t res;
+    uint32_t dataSize;
+    int toFd;
+
+    toFd = open(toFile, O_WRONLY | O_TRUNC | O_CREAT, 0644);
+    if (-1 == toFd)
+    {
+        LE_ERROR("Failed to open '%s': %m", toFile);
+        return LE_FAULT;
+    }
+
+    // Open the given MTD partition in R/O
+    res = le_flash_OpenMtd(partNameStr, LE_FLASH_READ_ONLY, &partRef);
+    LE_INFO("partition \"%s\" open ref %p, res %d", partNameStr, partRef, res);
+    if (LE_OK != res)
+    {
+        close(toFd);
+        return res;
+    }
+
+    // Read all the blocks of the partition. The file descriptor is closed by the service.
+    res = le_flash_ReadToFd(partRef, 0, 0, toFd, &dataSize);
+    LE_INFO("Read %u bytes from partition \"%s\", res %d", dataSize, partNameStr, res);
+    if (LE_OK != res)
+    {
+        le_flash_Close(partRef);
+        return res;
+    }
+
+    // Close the MTD
+    res = le_flash_Close(partRef);
+    LE_INFO("partition \"%s\" close ref %p, res %d", partNameStr, partRef, res);
+    return res;
+}
+//! [StreamDump]
+
+//! [UbiStreamFlash]
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flash a whole UBI volume from a file into an UBI partition through a file descriptor
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlashApiTest_StreamFlashUbi
+(
+    char **args
+)
+{
+    const char *partNameStr = args[0];
+    const char *ubiVolStr = args[1];
+    const char *fromFile = args[2];
+    le_flash_PartitionRef_t partRef = NULL;
+    le_result_t res;
+    uint32_t dataSize;
+    int fromFd;
+    struct stat st;
+
+    fromFd = open(fromFile, O_RDONLY);
+    if ((-1 == fromFd) || (-1 == fstat(fromFd, &st)))
+    {
+        LE_ERROR("Failed to open '%s': %m", fromFile);
+        if (-1 != fromFd)
+        {
+            close(fromFd);
+        }
+        return LE_FAULT;
+    }
+
+    // Open the given UBI partition in W/O
+    res = le_flash_OpenUbi(partNameStr, LE_FLASH_WRITE_ONLY, &partRef);
+    LE_INFO("partition \"%s\" open ref %p, res %d", partNameStr, partRef, res);
+    if (LE_OK != res)
+    {
+        close(fromFd);
+        return res;
+    }
+
+    // Open the UBI volume with the size of the file, so that it is adjusted when closed.
+    res = le_flash_OpenUbiVolume(partRef, ubiVolStr, st.st_size);
+    LE_INFO("UBI volume \"%s\" open ref %p, res %d", ubiVolStr, partRef, res);
+    if (LE_OK != res)
+    {
+        close(fromFd);
+        le_flash_Close(partRef);
+        return res;
+    }
+
+    // The whole file is written from the block 0. New blocks are added to the volume if needed.
+    // The file descriptor is closed by the service.
+    res = le_flash_WriteFromFd(partRef, 0, fromFd, &dataSize);
+    LE_INFO("Volume size written %u, expected volume size %u, res %d",
+            dataSize, (uint32_t)st.st_size, res);
+    if (LE_OK != res)
+    {
+        le_flash_CloseUbiVolume(partRef);
+        le_flash_Close(partRef);
+        return res;
+    }
+
+    // Close the UBI volume
+    res = le_flash_CloseUbiVolume(partRef);
+    LE_INFO("UBI volume \"%s\" close ref %p, res %d", ubiVolStr, partRef, res);
+    if (LE_OK != res)
+    {
+        le_flash_Close(partRef);
+        return res;
+    }
+
+    // Close the UBI partition
+    res = le_flash_Close(partRef);
+    LE_INFO("partition \"%s\" close ref %p, res %d", partNameStr, partRef, res);
+    return res;
+}
+//! [UbiStreamFlash]
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data moved through a pipe by a helper thread of the benchmark.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int      fd;        ///< Pipe end used by the thread
+    uint8_t* dataPtr;   ///< Data to write to the pipe, or buffer for the data read from it
+    size_t   size;      ///< Size of the data, or of the buffer
+    size_t   count;     ///< Number of bytes moved
+}
+BenchPipe_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark thread writing the data to the pipe, as a downloader would.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* BenchPipeWriter
+(
+    void* contextPtr
+)
+{
+    BenchPipe_t* pipePtr = contextPtr;
+    ssize_t size;
+
+    while (pipePtr->count < pipePtr->size)
+    {
+        size = write(pipePtr->fd, pipePtr->dataPtr + pipePtr->count,
+                     pipePtr->size - pipePtr->count);
+        if ((-1 == size) && (EINTR != errno))
+        {
+            break;
+        }
+        pipePtr->count += (size > 0 ? size : 0);
+    }
+    close(pipePtr->fd);
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark thread reading the data from the pipe.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* BenchPipeReader
+(
+    void* contextPtr
+)
+{
+    BenchPipe_t* pipePtr = contextPtr;
+    ssize_t size;
+
+    do
+    {
+        size = read(pipePtr->fd, pipePtr->dataPtr + pipePtr->count,
+                    pipePtr->size - pipePtr->count);
+        pipePtr->count += (size > 0 ? size : 0);
+    }
+    while (((size > 0) || ((-1 == size) && (EINTR == errno))) && (pipePtr->count < pipePtr->size));
+    close(pipePtr->fd);
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the throughput in KBytes/s since a start time.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t BenchRate
+(
+    size_t        size,     ///< Number of bytes moved
+    le_clk_Time_t start     ///< Start time
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    uint64_t usec = (uint64_t)elapsed.sec * 1000000 + elapsed.usec;
+
+    return (0 == usec ? 0 : (uint32_t)((uint64_t)size * 1000000 / 1024 / usec));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the write and read throughput of the block API (le_flash_Write() and le_flash_Read())
+ * and of the file descriptor API (le_flash_WriteFromFd() and le_flash_ReadToFd()) on a MTD
+ * partition. The file descriptor API is fed through pipes, as by a downloader. The data read back
+ * are checked.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlashApiTest_Bench
+(
+    char **args
+)
+{
+    const char *partNameStr = args[0];
+    size_t size = strtoul(args[1], NULL, 0) * 1024;
+    le_flash_PartitionRef_t partRef = NULL;
+    le_result_t res;
+    uint32_t badBlock, numBlock, eraseBlockSize, pageSize, blockIdx, chunk, dataSize;
+    uint32_t writeBlockRate, readBlockRate, writeFdRate, readFdRate;
+    uint8_t *srcPtr, *dstPtr;
+    size_t offset, i;
+    le_clk_Time_t start;
+    BenchPipe_t benchPipe;
+    pthread_t thread;
+    int pipeFd[2];
+
+    res = le_flash_OpenMtd(partNameStr, LE_FLASH_READ_WRITE, &partRef);
+    LE_INFO("partition \"%s\" open ref %p, res %d", partNameStr, partRef, res);
+    if (LE_OK != res)
+    {
+        return res;
+    }
+
+    res = le_flash_GetBlockInformation(partRef, &badBlock, &numBlock, &eraseBlockSize, &pageSize);
+    if (LE_OK != res)
+    {
+        le_flash_Close(partRef);
+        return res;
+    }
+    if ((0 == size) || (size > (size_t)(numBlock - badBlock) * eraseBlockSize) ||
+        (eraseBlockSize > LE_FLASH_MAX_WRITE_SIZE))
+    {
+        LE_ERROR("Size %zu does not fit in partition \"%s\"", size, partNameStr);
+        le_flash_Close(partRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    srcPtr = malloc(size);
+    dstPtr = malloc(size);
+    LE_ASSERT((NULL != srcPtr) && (NULL != dstPtr));
+    for (i = 0; i < size; i++)
+    {
+        srcPtr[i] = (uint8_t)(i * 7 + i / eraseBlockSize);
+    }
+
+    // Block API: one IPC message per erase block.
+    start = le_clk_GetRelativeTime();
+    for (offset = 0, blockIdx = 0; (LE_OK == res) && (offset < size); blockIdx++)
+    {
+        chunk = (size - offset < eraseBlockSize ? size - offset : eraseBlockSize);
+        res = le_flash_Write(partRef, blockIdx, srcPtr + offset, chunk);
+        offset += chunk;
+    }
+    writeBlockRate = BenchRate(size, start);
+
+    start = le_clk_GetRelativeTime();
+    for (offset = 0, blockIdx = 0; (LE_OK == res) && (offset < size); blockIdx++)
+    {
+        size_t readSize = (size - offset < eraseBlockSize ? size - offset : eraseBlockSize);
+        res = le_flash_Read(partRef, blockIdx, dstPtr + offset, &readSize);
+        offset += readSize;
+    }
+    readBlockRate = BenchRate(size, start);
+
+    if ((LE_OK != res) || (0 != memcmp(srcPtr, dstPtr, size)))
+    {
+        LE_ERROR("Block API: data read back differ, res %d", res);
+        res = LE_FAULT;
+        goto out;
+    }
+
+    // File descriptor API: the data go through pipes filled and drained by helper threads.
+    memset(dstPtr, 0, size);
+    LE_ASSERT(0 == pipe(pipeFd));
+    benchPipe = (BenchPipe_t){ .fd = pipeFd[1], .dataPtr = srcPtr, .size = size };
+    LE_ASSERT(0 == pthread_create(&thread, NULL, BenchPipeWriter, &benchPipe));
+    start = le_clk_GetRelativeTime();
+    res = le_flash_WriteFromFd(partRef, 0, pipeFd[0], &dataSize);
+    writeFdRate = BenchRate(dataSize, start);
+    pthread_join(thread, NULL);
+    if ((LE_OK != res) || (dataSize != size))
+    {
+        LE_ERROR("le_flash_WriteFromFd failed: %d, %u bytes written", res, dataSize);
+        res = LE_FAULT;
+        goto out;
+    }
+
+    LE_ASSERT(0 == pipe(pipeFd));
+    benchPipe = (BenchPipe_t){ .fd = pipeFd[0], .dataPtr = dstPtr, .size = size };
+    LE_ASSERT(0 == pthread_create(&thread, NULL, BenchPipeReader, &benchPipe));
+    start = le_clk_GetRelativeTime();
+    res = le_flash_ReadToFd(partRef, 0, (size + eraseBlockSize - 1) / eraseBlockSize,
+                            pipeFd[1], &dataSize);
+    readFdRate = BenchRate(dataSize, start);
+    pthread_join(thread, NULL);
+    if ((LE_OK != res) || (benchPipe.count != size) || (0 != memcmp(srcPtr, dstPtr, size)))
+    {
+        LE_ERROR("File descriptor API: data read back differ, res %d", res);
+        res = LE_FAULT;
+        goto out;
+    }
+
+    LE_INFO("Partition \"%s\", %zu KBytes, erase block %u bytes:", partNameStr, size / 1024,
+            eraseBlockSize);
+    LE_INFO("  le_flash_Write:        %u KBytes/s", writeBlockRate);
+    LE_INFO("  le_flash_WriteFromFd:  %u KBytes/s", writeFdRate);
+    LE_INFO("  le_flash_Read:         %u KBytes/s", readBlockRate);
+    LE_INFO("  le_flash_ReadToFd:     %u KBytes/s", readFdRate);
+
+out:
+    free(srcPtr);
+    free(dstPtr);
+    le_flash_Close(partRef);
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test thread writing the data to the pipe one page at a time with pauses, as a slow downloader
+ * would, so that the service erases the blocks while it waits for their data.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SlowPipeWriter
+(
+    void* contextPtr
+)
+{
+    BenchPipe_t* pipePtr = contextPtr;
+    ssize_t size;
+    size_t chunk;
+
+    while (pipePtr->count < pipePtr->size)
+    {
+        chunk = pipePtr->size - pipePtr->count;
+        chunk = (chunk > 512 ? 512 : chunk);
+        size = write(pipePtr->fd, pipePtr->dataPtr + pipePtr->count, chunk);
+        if ((-1 == size) && (EINTR != errno))
+        {
+            break;
+        }
+        pipePtr->count += (size > 0 ? size : 0);
+        usleep(5000);
+    }
+    close(pipePtr->fd);
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream one block and a half slowly to an MTD partition, then check that the data were written
+ * and that the blocks after the end of the stream still hold what was there before.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlashApiTest_StreamShort
+(
+    char **args
+)
+{
+    const char *partNameStr = args[0];
+    le_flash_PartitionRef_t partRef = NULL;
+    le_result_t res;
+    uint32_t badBlock, numBlock, eraseBlockSize, pageSize, blockIdx, dataSize;
+    uint8_t *srcPtr, *blockPtr;
+    size_t size, readSize, i;
+    BenchPipe_t benchPipe;
+    pthread_t thread;
+    int pipeFd[2];
+
+    res = le_flash_OpenMtd(partNameStr, LE_FLASH_READ_WRITE, &partRef);
+    LE_INFO("partition \"%s\" open ref %p, res %d", partNameStr, partRef, res);
+    if (LE_OK != res)
+    {
+        return res;
+    }
+
+    res = le_flash_GetBlockInformation(partRef, &badBlock, &numBlock, &eraseBlockSize, &pageSize);
+    if (LE_OK != res)
+    {
+        le_flash_Close(partRef);
+        return res;
+    }
+    if ((numBlock - badBlock < 4) || (eraseBlockSize > LE_FLASH_MAX_WRITE_SIZE))
+    {
+        LE_ERROR("Partition \"%s\" is too small or has too large blocks", partNameStr);
+        le_flash_Close(partRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    size = eraseBlockSize + eraseBlockSize / 2;
+    srcPtr = malloc(size);
+    blockPtr = malloc(eraseBlockSize);
+    LE_ASSERT((NULL != srcPtr) && (NULL != blockPtr));
+
+    // Fill the first 4 blocks with a known pattern.
+    memset(blockPtr, 0x5A, eraseBlockSize);
+    for (blockIdx = 0; (LE_OK == res) && (blockIdx < 4); blockIdx++)
+    {
+        res = le_flash_Write(partRef, blockIdx, blockPtr, eraseBlockSize);
+    }
+    if (LE_OK != res)
+    {
+        LE_ERROR("le_flash_Write failed: %d", res);
+        goto out;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        srcPtr[i] = (uint8_t)(i * 13 + 1);
+    }
+    LE_ASSERT(0 == pipe(pipeFd));
+    benchPipe = (BenchPipe_t){ .fd = pipeFd[1], .dataPtr = srcPtr, .size = size };
+    LE_ASSERT(0 == pthread_create(&thread, NULL, SlowPipeWriter, &benchPipe));
+    res = le_flash_WriteFromFd(partRef, 0, pipeFd[0], &dataSize);
+    pthread_join(thread, NULL);
+    if ((LE_OK != res) || (dataSize != size))
+    {
+        LE_ERROR("le_flash_WriteFromFd failed: %d, %u bytes written", res, dataSize);
+        res = LE_FAULT;
+        goto out;
+    }
+
+    // The streamed data are in the first two blocks.
+    for (blockIdx = 0; blockIdx < 2; blockIdx++)
+    {
+        readSize = eraseBlockSize;
+        res = le_flash_Read(partRef, blockIdx, blockPtr, &readSize);
+        if ((LE_OK != res) ||
+            (0 != memcmp(blockPtr, srcPtr + blockIdx * eraseBlockSize,
+                         (0 == blockIdx ? eraseBlockSize : size - eraseBlockSize))))
+        {
+            LE_ERROR("Block %u: streamed data read back differ, res %d", blockIdx, res);
+            res = LE_FAULT;
+            goto out;
+        }
+    }
+
+    // The blocks after the end of the stream were not erased.
+    for (blockIdx = 2; blockIdx < 4; blockIdx++)
+    {
+        readSize = eraseBlockSize;
+        res = le_flash_Read(partRef, blockIdx, blockPtr, &readSize);
+        for (i = 0; (LE_OK == res) && (i < readSize); i++)
+        {
+            if (0x5A != blockPtr[i])
+            {
+                LE_ERROR("Block %u was modified by the stream at offset %zu", blockIdx, i);
+                res = LE_FAULT;
+            }
+        }
+        if (LE_OK != res)
+        {
+            goto out;
+        }
+    }
+
+    LE_INFO("Partition \"%s\": stream of %zu bytes left the next blocks untouched",
+            partNameStr, size);
+
+out:
+    free(srcPtr);
+    free(blockPtr);
+    le_flash_Close(partRef);
+    return res;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Main thread.
@@ -0,0 +1,505 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Throughput of the IoT KeyStore streaming routines, which hand file descriptors to the service,
+ * against the chunk by chunk routines, which send every LE_IKS_MAX_PACKET_SIZE bytes through an
+ * IPC message.  The outputs of both are checked against each other.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the data processed by each measurement.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DATA_SIZE   (8 * 1024 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the chunks sent by the chunk by chunk routines.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHUNK_SIZE  LE_IKS_MAX_PACKET_SIZE
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unlinked temporary files holding the plaintext, and the outputs of both kinds of routines.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PlaintextFd;
+static int ChunkedFd;
+static int StreamFd;
+static int CheckFd;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Contents of the files, to compare them.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* PlaintextPtr;
+static uint8_t* OutputPtr;
+static uint8_t* CheckPtr;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double Now
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the throughput of a measurement.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogRate
+(
+    const char* namePtr,    ///< [IN] Measurement.
+    double start            ///< [IN] Start time.
+)
+{
+    double duration = Now() - start;
+
+    LE_TEST_INFO("%-28s %6.1f MB/s (%d KiB in %.3f s)", namePtr,
+                 DATA_SIZE / 1e6 / duration, DATA_SIZE / 1024, duration);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an unlinked temporary file.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CreateFile
+(
+    void
+)
+{
+    char path[] = "/tmp/iksBenchmarkXXXXXX";
+    int fd = mkstemp(path);
+
+    LE_TEST_ASSERT(fd >= 0, "Create temporary file");
+    unlink(path);
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empty a file, to write an output to it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Truncate
+(
+    int fd      ///< [IN] File.
+)
+{
+    LE_ASSERT(ftruncate(fd, 0) == 0);
+    LE_ASSERT(lseek(fd, 0, SEEK_SET) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a file descriptor to hand a file to the service, which closes it.  The file offset is
+ * shared with the original file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static int HandOver
+(
+    int fd      ///< [IN] File, rewound.
+)
+{
+    LE_ASSERT(lseek(fd, 0, SEEK_SET) == 0);
+    return dup(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a whole file in a buffer of DATA_SIZE bytes.
+ *
+ * @return Number of bytes read.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t Load
+(
+    int fd,             ///< [IN] File.
+    uint8_t* bufPtr     ///< [OUT] Buffer.
+)
+{
+    ssize_t count = pread(fd, bufPtr, DATA_SIZE, 0);
+
+    LE_ASSERT(count >= 0);
+    return count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that two files hold the same data.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSameFile
+(
+    int fd1,    ///< [IN] First file.
+    int fd2     ///< [IN] Second file.
+)
+{
+    size_t size1 = Load(fd1, OutputPtr);
+    size_t size2 = Load(fd2, CheckPtr);
+
+    return (size1 == size2) && (memcmp(OutputPtr, CheckPtr, size1) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a file holds the plaintext.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPlaintext
+(
+    int fd      ///< [IN] File.
+)
+{
+    return (Load(fd, CheckPtr) == DATA_SIZE) && (memcmp(PlaintextPtr, CheckPtr, DATA_SIZE) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encrypt or decrypt the plaintext file chunk by chunk, as a client without the streaming routines
+ * does.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t TransformChunked
+(
+    uint64_t session,       ///< [IN] Session reference.
+    le_result_t (*transformFunc)(uint64_t, const uint8_t*, size_t, uint8_t*, size_t*),
+                            ///< [IN] Chunk by chunk routine.
+    int inFd,               ///< [IN] Input file.
+    int outFd               ///< [IN] Output file.
+)
+{
+    uint8_t in[CHUNK_SIZE];
+    uint8_t out[CHUNK_SIZE];
+    ssize_t inSize;
+    off_t offset = 0;
+
+    Truncate(outFd);
+
+    while ((inSize = pread(inFd, in, sizeof(in), offset)) > 0)
+    {
+        size_t outSize = sizeof(out);
+        le_result_t result = transformFunc(session, in, inSize, out, &outSize);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+        LE_ASSERT(write(outFd, out, outSize) == (ssize_t)outSize);
+        offset += inSize;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process the plaintext file chunk by chunk with a MAC routine.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DigestChunked
+(
+    uint64_t session,       ///< [IN] Session reference.
+    le_result_t (*digestFunc)(uint64_t, const uint8_t*, size_t)
+                            ///< [IN] Chunk by chunk routine.
+)
+{
+    uint8_t msg[CHUNK_SIZE];
+    ssize_t msgSize;
+    off_t offset = 0;
+
+    while ((msgSize = pread(PlaintextFd, msg, sizeof(msg), offset)) > 0)
+    {
+        le_result_t result = digestFunc(session, msg, msgSize);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+        offset += msgSize;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a key with a random value and a session using it.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t CreateSession
+(
+    const char* keyIdPtr,       ///< [IN] Key identifier.
+    le_iks_KeyType_t keyType,   ///< [IN] Key type.
+    uint32_t keySize,           ///< [IN] Key size.
+    uint64_t* keyRefPtr         ///< [OUT] Key reference.
+)
+{
+    uint64_t sessionRef;
+
+    if (le_iks_GetKey(keyIdPtr, keyRefPtr) == LE_OK)
+    {
+        LE_ASSERT_OK(le_iks_DeleteKey(*keyRefPtr, NULL, 0));
+    }
+
+    LE_TEST_ASSERT(le_iks_CreateKeyByType(keyIdPtr, keyType, keySize, keyRefPtr) == LE_OK,
+                   "Create key %s", keyIdPtr);
+    LE_ASSERT_OK(le_iks_GenKeyValue(*keyRefPtr, NULL, 0));
+    LE_ASSERT_OK(le_iks_CreateSession(*keyRefPtr, &sessionRef));
+
+    return sessionRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a session and its key.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteSession
+(
+    uint64_t sessionRef,    ///< [IN] Session reference.
+    uint64_t keyRef         ///< [IN] Key reference.
+)
+{
+    LE_ASSERT_OK(le_iks_DeleteSession(sessionRef));
+    LE_ASSERT_OK(le_iks_DeleteKey(keyRef, NULL, 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AES GCM.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AesGcmBenchmark
+(
+    void
+)
+{
+    uint8_t nonce[LE_IKS_AESGCM_NONCE_SIZE];
+    uint8_t streamNonce[LE_IKS_AESGCM_NONCE_SIZE];
+    uint8_t tag[LE_IKS_AESGCM_TAG_SIZE];
+    uint8_t streamTag[LE_IKS_AESGCM_TAG_SIZE];
+    size_t nonceSize = sizeof(nonce);
+    size_t tagSize = sizeof(tag);
+    uint64_t keyRef;
+    uint64_t session = CreateSession("iksBenchmarkGcm", LE_IKS_KEY_TYPE_AES_GCM, 32, &keyRef);
+    double start;
+
+    LE_TEST_INFO("=== AES GCM ===");
+
+    start = Now();
+    LE_ASSERT_OK(le_iks_aesGcm_StartEncrypt(session, nonce, &nonceSize));
+    LE_ASSERT_OK(TransformChunked(session, le_iks_aesGcm_Encrypt, PlaintextFd, ChunkedFd));
+    LE_ASSERT_OK(le_iks_aesGcm_DoneEncrypt(session, tag, &tagSize));
+    LogRate("Encrypt, chunk by chunk", start);
+
+    start = Now();
+    nonceSize = sizeof(streamNonce);
+    tagSize = sizeof(streamTag);
+    Truncate(StreamFd);
+    LE_ASSERT_OK(le_iks_aesGcm_StartEncrypt(session, streamNonce, &nonceSize));
+    LE_TEST_OK(le_iks_aesGcm_EncryptStream(session, HandOver(PlaintextFd), HandOver(StreamFd),
+                                           streamTag, &tagSize) == LE_OK, "EncryptStream");
+    LogRate("Encrypt, stream", start);
+
+    start = Now();
+    Truncate(CheckFd);
+    LE_ASSERT_OK(le_iks_aesGcm_StartDecrypt(session, streamNonce, sizeof(streamNonce)));
+    LE_TEST_OK(le_iks_aesGcm_DecryptStream(session, HandOver(StreamFd), HandOver(CheckFd),
+                                           streamTag, sizeof(streamTag)) == LE_OK,
+               "DecryptStream");
+    LogRate("Decrypt, stream", start);
+    LE_TEST_OK(IsPlaintext(CheckFd), "Stream round trip");
+
+    // The chunk by chunk ciphertext must decrypt with the streaming routine, and the other way.
+    Truncate(CheckFd);
+    LE_ASSERT_OK(le_iks_aesGcm_StartDecrypt(session, nonce, sizeof(nonce)));
+    LE_TEST_OK(le_iks_aesGcm_DecryptStream(session, HandOver(ChunkedFd), HandOver(CheckFd),
+                                           tag, sizeof(tag)) == LE_OK,
+               "DecryptStream of chunk by chunk ciphertext");
+    LE_TEST_OK(IsPlaintext(CheckFd), "Chunk by chunk ciphertext decrypted");
+
+    start = Now();
+    LE_ASSERT_OK(le_iks_aesGcm_StartDecrypt(session, streamNonce, sizeof(streamNonce)));
+    LE_ASSERT_OK(TransformChunked(session, le_iks_aesGcm_Decrypt, StreamFd, CheckFd));
+    LE_TEST_OK(le_iks_aesGcm_DoneDecrypt(session, streamTag, sizeof(streamTag)) == LE_OK,
+               "Decrypt stream ciphertext chunk by chunk");
+    LogRate("Decrypt, chunk by chunk", start);
+    LE_TEST_OK(IsPlaintext(CheckFd), "Stream ciphertext decrypted");
+
+    streamTag[0] ^= 1;
+    LE_ASSERT_OK(le_iks_aesGcm_StartDecrypt(session, streamNonce, sizeof(streamNonce)));
+    LE_TEST_OK(le_iks_aesGcm_DecryptStream(session, HandOver(StreamFd), HandOver(CheckFd),
+                                           streamTag, sizeof(streamTag)) == LE_FAULT,
+               "Wrong tag rejected");
+
+    DeleteSession(session, keyRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AES CBC.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AesCbcBenchmark
+(
+    void
+)
+{
+    uint8_t iv[LE_IKS_AESCBC_IV_SIZE] = { 0x10, 0x32, 0x54, 0x76 };
+    uint64_t keyRef;
+    uint64_t session = CreateSession("iksBenchmarkCbc", LE_IKS_KEY_TYPE_AES_CBC, 32, &keyRef);
+    double start;
+
+    LE_TEST_INFO("=== AES CBC ===");
+
+    start = Now();
+    LE_ASSERT_OK(le_iks_aesCbc_StartEncrypt(session, iv, sizeof(iv)));
+    LE_ASSERT_OK(TransformChunked(session, le_iks_aesCbc_Encrypt, PlaintextFd, ChunkedFd));
+    LogRate("Encrypt, chunk by chunk", start);
+
+    start = Now();
+    Truncate(StreamFd);
+    LE_ASSERT_OK(le_iks_aesCbc_StartEncrypt(session, iv, sizeof(iv)));
+    LE_TEST_OK(le_iks_aesCbc_EncryptStream(session, HandOver(PlaintextFd),
+                                           HandOver(StreamFd)) == LE_OK, "EncryptStream");
+    LogRate("Encrypt, stream", start);
+    LE_TEST_OK(IsSameFile(ChunkedFd, StreamFd), "Same ciphertext");
+
+    start = Now();
+    Truncate(CheckFd);
+    LE_ASSERT_OK(le_iks_aesCbc_StartDecrypt(session, iv, sizeof(iv)));
+    LE_TEST_OK(le_iks_aesCbc_DecryptStream(session, HandOver(StreamFd),
+                                           HandOver(CheckFd)) == LE_OK, "DecryptStream");
+    LogRate("Decrypt, stream", start);
+    LE_TEST_OK(IsPlaintext(CheckFd), "Stream round trip");
+
+    // Data that is not a multiple of the block size.
+    Truncate(CheckFd);
+    LE_ASSERT(write(CheckFd, iv, sizeof(iv) - 1) == sizeof(iv) - 1);
+    Truncate(StreamFd);
+    LE_ASSERT_OK(le_iks_aesCbc_StartEncrypt(session, iv, sizeof(iv)));
+    LE_TEST_OK(le_iks_aesCbc_EncryptStream(session, HandOver(CheckFd),
+                                           HandOver(StreamFd)) == LE_OUT_OF_RANGE,
+               "Partial block rejected");
+
+    DeleteSession(session, keyRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AES CMAC and HMAC.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MacBenchmark
+(
+    const char* namePtr,        ///< [IN] Algorithm.
+    le_iks_KeyType_t keyType,   ///< [IN] Key type.
+    uint32_t keySize,           ///< [IN] Key size.
+    le_result_t (*processChunkFunc)(uint64_t, const uint8_t*, size_t),
+                                ///< [IN] Chunk by chunk routine.
+    le_result_t (*processStreamFunc)(uint64_t, int),
+                                ///< [IN] Streaming routine.
+    le_result_t (*doneFunc)(uint64_t, uint8_t*, size_t*),
+                                ///< [IN] Routine getting the tag.
+    le_result_t (*verifyFunc)(uint64_t, const uint8_t*, size_t)
+                                ///< [IN] Routine checking the tag.
+)
+{
+    uint8_t tag[LE_IKS_HMAC_MAX_TAG_SIZE];
+    size_t tagSize = sizeof(tag);
+    uint64_t keyRef;
+    uint64_t session = CreateSession("iksBenchmarkMac", keyType, keySize, &keyRef);
+    double start;
+
+    LE_TEST_INFO("=== %s ===", namePtr);
+
+    start = Now();
+    LE_ASSERT_OK(DigestChunked(session, processChunkFunc));
+    LE_ASSERT_OK(doneFunc(session, tag, &tagSize));
+    LogRate("MAC, chunk by chunk", start);
+
+    // A MAC session cannot be restarted.
+    LE_ASSERT_OK(le_iks_DeleteSession(session));
+    LE_ASSERT_OK(le_iks_CreateSession(keyRef, &session));
+
+    start = Now();
+    LE_TEST_OK(processStreamFunc(session, HandOver(PlaintextFd)) == LE_OK, "ProcessStream");
+    LE_TEST_OK(verifyFunc(session, tag, tagSize) == LE_OK, "Same tag");
+    LogRate("MAC, stream", start);
+
+    DeleteSession(session, keyRef);
+}
+
+
+COMPONENT_INIT
+{
+    int i;
+
+    LE_TEST_PLAN(LE_TEST_NO_PLAN);
+
+    PlaintextPtr = malloc(DATA_SIZE);
+    OutputPtr = malloc(DATA_SIZE);
+    CheckPtr = malloc(DATA_SIZE);
+    LE_ASSERT((PlaintextPtr != NULL) && (OutputPtr != NULL) && (CheckPtr != NULL));
+
+    srand(1);
+    for (i = 0; i < DATA_SIZE; i++)
+    {
+        PlaintextPtr[i] = rand();
+    }
+
+    PlaintextFd = CreateFile();
+    ChunkedFd = CreateFile();
+    StreamFd = CreateFile();
+    CheckFd = CreateFile();
+    LE_ASSERT(write(PlaintextFd, PlaintextPtr, DATA_SIZE) == DATA_SIZE);
+
+    AesGcmBenchmark();
+    AesCbcBenchmark();
+    MacBenchmark("HMAC SHA256", LE_IKS_KEY_TYPE_HMAC_SHA256, 32,
+                 le_iks_hmac_ProcessChunk, le_iks_hmac_ProcessStream,
+                 le_iks_hmac_Done, le_iks_hmac_Verify);
+    MacBenchmark("AES CMAC", LE_IKS_KEY_TYPE_AES_CMAC, 32,
+                 le_iks_aesCmac_ProcessChunk, le_iks_aesCmac_ProcessStream,
+                 le_iks_aesCmac_Done, le_iks_aesCmac_Verify);
+
+    LE_TEST_EXIT;
+}
@@ -7,6 +7,8 @@
 
 #include "legato.h"
 #include "interfaces.h"
+#include "le_pos_local.h"
+#include "nmeaTrace.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1028,6 +1030,481 @@ static void Testle_pos_RemoveMovementHandler
     le_thread_Cancel(NavigationThreadRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Geofence test parameters.
+ *
+ * The circular fence is centered on the 21st fix of the trace (fixes 18 to 22 are inside), the
+ * polygonal fence covers fixes 30 to 35. Random fences are spread over a 50 km square around
+ * the trace to load the spatial index.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FENCE_CIRCLE_LATITUDE       48850000
+#define FENCE_CIRCLE_LONGITUDE      2277334
+#define FENCE_CIRCLE_RADIUS         250
+#define FENCE_POLYGON_MIN_LAT       48849000
+#define FENCE_POLYGON_MAX_LAT       48851000
+#define FENCE_POLYGON_MIN_LON       2290300
+#define FENCE_POLYGON_MAX_LON       2298500
+#define FENCE_RANDOM_COUNT          2000
+#define FENCE_RANDOM_AREA           450000      // 1e-6 degrees, about 50 km in latitude
+#define FENCE_REPLAY_LOOPS          200
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Geofence test state.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t              FenceThreadRef;
+static le_pos_FenceHandlerRef_t     FenceHandlerRef;
+static le_pos_FenceRef_t            CircleFenceRef;
+static le_pos_FenceRef_t            PolygonFenceRef;
+static le_pos_FenceRef_t            RandomFenceRef[FENCE_RANDOM_COUNT];
+static uint32_t                     CircleEvents[LE_POS_FENCE_DWELL + 1];
+static uint32_t                     PolygonEvents[LE_POS_FENCE_DWELL + 1];
+static size_t                       ReplayIndex;
+static uint64_t                     ReplayStartMs;
+static uint64_t                     ReplayEndMs;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the relative time in milliseconds.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetRelativeTimeMs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    return ((uint64_t)now.sec * 1000) + (now.usec / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function for geofence notifications.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FenceHandler
+(
+    le_pos_FenceRef_t fenceRef,
+    le_pos_FenceEvent_t event,
+    int32_t latitude,
+    int32_t longitude,
+    void* contextPtr
+)
+{
+    LE_ASSERT(event <= LE_POS_FENCE_DWELL);
+
+    if (fenceRef == CircleFenceRef)
+    {
+        CircleEvents[event]++;
+    }
+    else if (fenceRef == PolygonFenceRef)
+    {
+        PolygonEvents[event]++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay the next fix of the NMEA trace. The function queues itself after the position event so
+ * each fix is processed before the simulated location is updated again.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplayNextFix
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    if (ReplayIndex < (NUM_ARRAY_MEMBERS(NmeaTrace) * FENCE_REPLAY_LOOPS))
+    {
+        LE_ASSERT_OK(le_gnssSimu_ReplayNmea(NmeaTrace[ReplayIndex % NUM_ARRAY_MEMBERS(NmeaTrace)]));
+        ReplayIndex++;
+        le_gnssSimu_ReportEvent();
+        le_event_QueueFunction(ReplayNextFix, NULL, NULL);
+    }
+    else
+    {
+        ReplayEndMs = GetRelativeTimeMs();
+        le_sem_Post(ThreadSemaphore);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: create the fences and the fence handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* FenceThread
+(
+    void* context
+)
+{
+    int32_t latitudes[] = { FENCE_POLYGON_MIN_LAT, FENCE_POLYGON_MIN_LAT,
+                            FENCE_POLYGON_MAX_LAT, FENCE_POLYGON_MAX_LAT };
+    int32_t longitudes[] = { FENCE_POLYGON_MIN_LON, FENCE_POLYGON_MAX_LON,
+                             FENCE_POLYGON_MAX_LON, FENCE_POLYGON_MIN_LON };
+    uint32_t seed = 1;
+    int i;
+
+    // test for invalid parameters
+    LE_ASSERT(NULL == le_pos_AddFenceHandler(NULL, NULL));
+    LE_ASSERT(NULL == le_pos_CreateCircularFence(91000000, 0, 100, 0));
+    LE_ASSERT(NULL == le_pos_CreateCircularFence(0, 0, 0, 0));
+    LE_ASSERT(NULL == le_pos_CreatePolygonFence(latitudes, 2, longitudes, 2, 0));
+    LE_ASSERT(NULL == le_pos_CreatePolygonFence(latitudes, 4, longitudes, 3, 0));
+
+    // test for Normal Behaviour
+    FenceHandlerRef = le_pos_AddFenceHandler(FenceHandler, NULL);
+    LE_ASSERT(NULL != FenceHandlerRef);
+
+    CircleFenceRef = le_pos_CreateCircularFence(FENCE_CIRCLE_LATITUDE, FENCE_CIRCLE_LONGITUDE,
+                                                FENCE_CIRCLE_RADIUS, 0);
+    LE_ASSERT(NULL != CircleFenceRef);
+
+    PolygonFenceRef = le_pos_CreatePolygonFence(latitudes, NUM_ARRAY_MEMBERS(latitudes),
+                                                longitudes, NUM_ARRAY_MEMBERS(longitudes), 0);
+    LE_ASSERT(NULL != PolygonFenceRef);
+
+    for (i = 0; i < FENCE_RANDOM_COUNT; i++)
+    {
+        // Deterministic linear congruential generator.
+        seed = seed * 1103515245 + 12345;
+        int32_t latitude = FENCE_CIRCLE_LATITUDE - FENCE_RANDOM_AREA / 2 +
+                           (int32_t)((seed >> 8) % FENCE_RANDOM_AREA);
+        seed = seed * 1103515245 + 12345;
+        int32_t longitude = FENCE_CIRCLE_LONGITUDE - FENCE_RANDOM_AREA / 2 +
+                            (int32_t)((seed >> 8) % FENCE_RANDOM_AREA);
+        seed = seed * 1103515245 + 12345;
+        uint32_t radius = 50 + (seed >> 8) % 450;
+
+        RandomFenceRef[i] = le_pos_CreateCircularFence(latitude, longitude, radius, 0);
+        LE_ASSERT(NULL != RandomFenceRef[i]);
+    }
+
+    le_sem_Post(ThreadSemaphore);
+    le_event_RunLoop();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: delete the fences and the fence handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteFences
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    int i;
+
+    LE_ASSERT_OK(le_pos_DeleteFence(CircleFenceRef));
+    LE_ASSERT(LE_BAD_PARAMETER == le_pos_DeleteFence(CircleFenceRef));
+    LE_ASSERT_OK(le_pos_DeleteFence(PolygonFenceRef));
+    for (i = 0; i < FENCE_RANDOM_COUNT; i++)
+    {
+        LE_ASSERT_OK(le_pos_DeleteFence(RandomFenceRef[i]));
+    }
+    le_pos_RemoveFenceHandler(FenceHandlerRef);
+
+    le_sem_Post(ThreadSemaphore);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tested API: le_pos_CreateCircularFence(), le_pos_CreatePolygonFence(), le_pos_DeleteFence(),
+ * le_pos_GetFenceState(), le_pos_AddFenceHandler(), le_pos_RemoveFenceHandler()
+ *
+ * Replay the NMEA trace through the fences and verify the enter and exit notifications. The
+ * replay time gives the geofence engine throughput.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_pos_Geofence
+(
+    void
+)
+{
+    uint64_t fixCount, candidateCount, exactTestCount;
+    bool isInside;
+
+    FenceThreadRef = le_thread_Create("FenceThread", FenceThread, NULL);
+    le_thread_Start(FenceThreadRef);
+    SynchTest();
+
+    ReplayIndex = 0;
+    ReplayStartMs = GetRelativeTimeMs();
+    le_event_QueueFunctionToThread(FenceThreadRef, ReplayNextFix, NULL, NULL);
+    LE_ASSERT_OK(le_sem_WaitWithTimeOut(ThreadSemaphore, (le_clk_Time_t){ 60, 0 }));
+
+    geofence_GetStats(&fixCount, &candidateCount, &exactTestCount);
+    LE_INFO("+++ %"PRIu64" fixes replayed through %d fences in %"PRIu64" ms",
+            fixCount, FENCE_RANDOM_COUNT + 2, ReplayEndMs - ReplayStartMs);
+    LE_INFO("+++ %"PRIu64" candidate fences, %"PRIu64" exact tests",
+            candidateCount, exactTestCount);
+
+    LE_ASSERT(fixCount == NUM_ARRAY_MEMBERS(NmeaTrace) * FENCE_REPLAY_LOOPS);
+    // The spatial index must keep the number of evaluated fences far below the fence count.
+    LE_ASSERT(candidateCount < fixCount * (FENCE_RANDOM_COUNT / 100));
+
+    LE_ASSERT(FENCE_REPLAY_LOOPS == CircleEvents[LE_POS_FENCE_ENTER]);
+    LE_ASSERT(FENCE_REPLAY_LOOPS == CircleEvents[LE_POS_FENCE_EXIT]);
+    LE_ASSERT(0 == CircleEvents[LE_POS_FENCE_DWELL]);
+    LE_ASSERT(FENCE_REPLAY_LOOPS == PolygonEvents[LE_POS_FENCE_ENTER]);
+    LE_ASSERT(FENCE_REPLAY_LOOPS == PolygonEvents[LE_POS_FENCE_EXIT]);
+    LE_ASSERT(0 == PolygonEvents[LE_POS_FENCE_DWELL]);
+
+    // The last fix of the trace is outside of both fences.
+    LE_ASSERT_OK(le_pos_GetFenceState(CircleFenceRef, &isInside));
+    LE_ASSERT(!isInside);
+    LE_ASSERT_OK(le_pos_GetFenceState(PolygonFenceRef, &isInside));
+    LE_ASSERT(!isInside);
+
+    le_event_QueueFunctionToThread(FenceThreadRef, DeleteFences, NULL, NULL);
+    SynchTest();
+    LE_ASSERT(LE_BAD_PARAMETER == le_pos_GetFenceState(CircleFenceRef, &isInside));
+
+    le_thread_Cancel(FenceThreadRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dwell test parameters: fixes of the trace inside and outside of the circular fence, and dwell
+ * time in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FENCE_INSIDE_FIX            20
+#define FENCE_OUTSIDE_FIX           0
+#define FENCE_DWELL_TIME            2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dwell test state.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t              DwellThreadRef;
+static le_pos_FenceRef_t            DwellFenceRef;
+static le_pos_FenceHandlerRef_t     DwellHandlerRef;
+static le_pos_FenceHandlerRef_t     RemovingHandlerRef;
+static le_pos_FenceHandlerRef_t     RemovedHandlerRef;
+static uint32_t                     DwellEvents[LE_POS_FENCE_DWELL + 1];
+static uint32_t                     RemovedHandlerEvents;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function counting the notifications of the dwell fence.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DwellFenceHandler
+(
+    le_pos_FenceRef_t fenceRef,
+    le_pos_FenceEvent_t event,
+    int32_t latitude,
+    int32_t longitude,
+    void* contextPtr
+)
+{
+    LE_ASSERT(event <= LE_POS_FENCE_DWELL);
+    LE_ASSERT(fenceRef == DwellFenceRef);
+    DwellEvents[event]++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function removing itself and the next registered handler on its first notification.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemovingFenceHandler
+(
+    le_pos_FenceRef_t fenceRef,
+    le_pos_FenceEvent_t event,
+    int32_t latitude,
+    int32_t longitude,
+    void* contextPtr
+)
+{
+    le_pos_RemoveFenceHandler(RemovedHandlerRef);
+    le_pos_RemoveFenceHandler(RemovingHandlerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function removed by RemovingFenceHandler() before being called.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemovedFenceHandler
+(
+    le_pos_FenceRef_t fenceRef,
+    le_pos_FenceEvent_t event,
+    int32_t latitude,
+    int32_t longitude,
+    void* contextPtr
+)
+{
+    RemovedHandlerEvents++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: create the dwell fence and its handlers
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* DwellThread
+(
+    void* context
+)
+{
+    DwellHandlerRef = le_pos_AddFenceHandler(DwellFenceHandler, NULL);
+    LE_ASSERT(NULL != DwellHandlerRef);
+    RemovingHandlerRef = le_pos_AddFenceHandler(RemovingFenceHandler, NULL);
+    LE_ASSERT(NULL != RemovingHandlerRef);
+    RemovedHandlerRef = le_pos_AddFenceHandler(RemovedFenceHandler, NULL);
+    LE_ASSERT(NULL != RemovedHandlerRef);
+
+    DwellFenceRef = le_pos_CreateCircularFence(FENCE_CIRCLE_LATITUDE, FENCE_CIRCLE_LONGITUDE,
+                                               FENCE_CIRCLE_RADIUS, FENCE_DWELL_TIME);
+    LE_ASSERT(NULL != DwellFenceRef);
+
+    le_sem_Post(ThreadSemaphore);
+    le_event_RunLoop();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Post the thread semaphore.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void PostThreadSemaphore
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_sem_Post(ThreadSemaphore);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay one fix of the NMEA trace. The semaphore is posted once the position event is processed.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplayFix
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    LE_ASSERT_OK(le_gnssSimu_ReplayNmea(NmeaTrace[(size_t)param1Ptr]));
+    le_gnssSimu_ReportEvent();
+    le_event_QueueFunction(PostThreadSemaphore, NULL, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process one fix of the NMEA trace in the dwell thread.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessDwellFix
+(
+    size_t fixIndex
+)
+{
+    le_event_QueueFunctionToThread(DwellThreadRef, ReplayFix, (void*)fixIndex, NULL);
+    SynchTest();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test: delete the dwell fence and its handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteDwellFence
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    LE_ASSERT_OK(le_pos_DeleteFence(DwellFenceRef));
+    le_pos_RemoveFenceHandler(DwellHandlerRef);
+
+    le_sem_Post(ThreadSemaphore);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tested API: le_pos_CreateCircularFence() with a dwell time, le_pos_RemoveFenceHandler() called
+ * from a fence handler, le_pos_GetFenceState() and le_pos_DeleteFence() by another client
+ *
+ * A single dwell notification must be reported once the device has stayed inside the fence for
+ * the dwell time, and the dwell time restarts on the next entry.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Testle_pos_GeofenceDwell
+(
+    void
+)
+{
+    bool isInside;
+
+    DwellThreadRef = le_thread_Create("DwellThread", DwellThread, NULL);
+    le_thread_Start(DwellThreadRef);
+    SynchTest();
+
+    // Entry: no dwell yet. The handler removed by another handler is never called.
+    ProcessDwellFix(FENCE_INSIDE_FIX);
+    LE_ASSERT(1 == DwellEvents[LE_POS_FENCE_ENTER]);
+    LE_ASSERT(0 == DwellEvents[LE_POS_FENCE_DWELL]);
+    LE_ASSERT(0 == RemovedHandlerEvents);
+    ProcessDwellFix(FENCE_INSIDE_FIX);
+    LE_ASSERT(0 == DwellEvents[LE_POS_FENCE_DWELL]);
+
+    // A single dwell notification after the dwell time.
+    le_thread_Sleep(FENCE_DWELL_TIME + 1);
+    ProcessDwellFix(FENCE_INSIDE_FIX);
+    LE_ASSERT(1 == DwellEvents[LE_POS_FENCE_DWELL]);
+    ProcessDwellFix(FENCE_INSIDE_FIX);
+    LE_ASSERT(1 == DwellEvents[LE_POS_FENCE_DWELL]);
+    LE_ASSERT(1 == DwellEvents[LE_POS_FENCE_ENTER]);
+
+    // Exit, then entry again: the dwell time restarts.
+    ProcessDwellFix(FENCE_OUTSIDE_FIX);
+    LE_ASSERT(1 == DwellEvents[LE_POS_FENCE_EXIT]);
+    ProcessDwellFix(FENCE_INSIDE_FIX);
+    LE_ASSERT(2 == DwellEvents[LE_POS_FENCE_ENTER]);
+    LE_ASSERT(1 == DwellEvents[LE_POS_FENCE_DWELL]);
+    LE_ASSERT(0 == RemovedHandlerEvents);
+
+    // The fence can't be read or deleted by another client.
+    _ClientSessionRef = (le_msg_SessionRef_t)&DwellFenceRef;
+    LE_ASSERT(LE_BAD_PARAMETER == le_pos_GetFenceState(DwellFenceRef, &isInside));
+    LE_ASSERT(LE_BAD_PARAMETER == le_pos_DeleteFence(DwellFenceRef));
+    _ClientSessionRef = NULL;
+    LE_ASSERT_OK(le_pos_GetFenceState(DwellFenceRef, &isInside));
+    LE_ASSERT(isInside);
+
+    le_event_QueueFunctionToThread(DwellThreadRef, DeleteDwellFence, NULL, NULL);
+    SynchTest();
+
+    le_thread_Cancel(DwellThreadRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * UnitTestInit thread: this function initializes the test and runs an eventLoop
@@ -1041,6 +1518,8 @@ static void* UnitTestInit
 {
     Testle_pos_AddMovementHandler();
     Testle_pos_RemoveMovementHandler();
+    Testle_pos_Geofence();
+    Testle_pos_GeofenceDwell();
     le_sem_Post(InitSemaphore);
     le_event_RunLoop();
 }
@@ -0,0 +1,69 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file nmeaTrace.h
+ *
+ * Recorded GGA sentences used to replay a drive through the GNSS simulation: 50 fixes, one every
+ * 7 seconds, heading east along latitude 48.85 N from longitude 2.25 E, about 100 meters apart.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef _NMEA_TRACE_H
+#define _NMEA_TRACE_H
+
+static const char* const NmeaTrace[] =
+{
+    "$GPGGA,123000.00,4851.0012,N,00215.0000,E,1,09,0.9,35.0,M,47.0,M,,*54",
+    "$GPGGA,123007.00,4850.9991,N,00215.0820,E,1,09,0.9,35.0,M,47.0,M,,*53",
+    "$GPGGA,123014.00,4851.0000,N,00215.1640,E,1,09,0.9,35.0,M,47.0,M,,*51",
+    "$GPGGA,123021.00,4851.0012,N,00215.2460,E,1,09,0.9,35.0,M,47.0,M,,*57",
+    "$GPGGA,123028.00,4850.9991,N,00215.3280,E,1,09,0.9,35.0,M,47.0,M,,*5D",
+    "$GPGGA,123035.00,4851.0000,N,00215.4100,E,1,09,0.9,35.0,M,47.0,M,,*54",
+    "$GPGGA,123042.00,4851.0012,N,00215.4920,E,1,09,0.9,35.0,M,47.0,M,,*5D",
+    "$GPGGA,123049.00,4850.9991,N,00215.5740,E,1,09,0.9,35.0,M,47.0,M,,*55",
+    "$GPGGA,123056.00,4851.0000,N,00215.6560,E,1,09,0.9,35.0,M,47.0,M,,*51",
+    "$GPGGA,123103.00,4851.0012,N,00215.7380,E,1,09,0.9,35.0,M,47.0,M,,*5A",
+    "$GPGGA,123110.00,4850.9991,N,00215.8200,E,1,09,0.9,35.0,M,47.0,M,,*54",
+    "$GPGGA,123117.00,4851.0000,N,00215.9020,E,1,09,0.9,35.0,M,47.0,M,,*5B",
+    "$GPGGA,123124.00,4851.0012,N,00215.9840,E,1,09,0.9,35.0,M,47.0,M,,*56",
+    "$GPGGA,123131.00,4850.9991,N,00216.0660,E,1,09,0.9,35.0,M,47.0,M,,*5E",
+    "$GPGGA,123138.00,4851.0000,N,00216.1480,E,1,09,0.9,35.0,M,47.0,M,,*53",
+    "$GPGGA,123145.00,4851.0012,N,00216.2300,E,1,09,0.9,35.0,M,47.0,M,,*56",
+    "$GPGGA,123152.00,4850.9991,N,00216.3120,E,1,09,0.9,35.0,M,47.0,M,,*5B",
+    "$GPGGA,123159.00,4851.0000,N,00216.3940,E,1,09,0.9,35.0,M,47.0,M,,*57",
+    "$GPGGA,123206.00,4851.0012,N,00216.4760,E,1,09,0.9,35.0,M,47.0,M,,*56",
+    "$GPGGA,123213.00,4850.9991,N,00216.5580,E,1,09,0.9,35.0,M,47.0,M,,*55",
+    "$GPGGA,123220.00,4851.0000,N,00216.6400,E,1,09,0.9,35.0,M,47.0,M,,*56",
+    "$GPGGA,123227.00,4851.0012,N,00216.7220,E,1,09,0.9,35.0,M,47.0,M,,*57",
+    "$GPGGA,123234.00,4850.9991,N,00216.8040,E,1,09,0.9,35.0,M,47.0,M,,*54",
+    "$GPGGA,123241.00,4851.0000,N,00216.8860,E,1,09,0.9,35.0,M,47.0,M,,*55",
+    "$GPGGA,123248.00,4851.0012,N,00216.9680,E,1,09,0.9,35.0,M,47.0,M,,*5E",
+    "$GPGGA,123255.00,4850.9991,N,00217.0500,E,1,09,0.9,35.0,M,47.0,M,,*5B",
+    "$GPGGA,123302.00,4851.0000,N,00217.1320,E,1,09,0.9,35.0,M,47.0,M,,*54",
+    "$GPGGA,123309.00,4851.0012,N,00217.2140,E,1,09,0.9,35.0,M,47.0,M,,*5B",
+    "$GPGGA,123316.00,4850.9991,N,00217.2960,E,1,09,0.9,35.0,M,47.0,M,,*55",
+    "$GPGGA,123323.00,4851.0000,N,00217.3780,E,1,09,0.9,35.0,M,47.0,M,,*5B",
+    "$GPGGA,123330.00,4851.0012,N,00217.4600,E,1,09,0.9,35.0,M,47.0,M,,*54",
+    "$GPGGA,123337.00,4850.9991,N,00217.5420,E,1,09,0.9,35.0,M,47.0,M,,*58",
+    "$GPGGA,123344.00,4851.0000,N,00217.6240,E,1,09,0.9,35.0,M,47.0,M,,*56",
+    "$GPGGA,123351.00,4851.0012,N,00217.7060,E,1,09,0.9,35.0,M,47.0,M,,*50",
+    "$GPGGA,123358.00,4850.9991,N,00217.7880,E,1,09,0.9,35.0,M,47.0,M,,*55",
+    "$GPGGA,123405.00,4851.0000,N,00217.8700,E,1,09,0.9,35.0,M,47.0,M,,*5B",
+    "$GPGGA,123412.00,4851.0012,N,00217.9520,E,1,09,0.9,35.0,M,47.0,M,,*5F",
+    "$GPGGA,123419.00,4850.9991,N,00218.0340,E,1,09,0.9,35.0,M,47.0,M,,*58",
+    "$GPGGA,123426.00,4851.0000,N,00218.1160,E,1,09,0.9,35.0,M,47.0,M,,*5C",
+    "$GPGGA,123433.00,4851.0012,N,00218.1980,E,1,09,0.9,35.0,M,47.0,M,,*5D",
+    "$GPGGA,123440.00,4850.9991,N,00218.2800,E,1,09,0.9,35.0,M,47.0,M,,*59",
+    "$GPGGA,123447.00,4851.0000,N,00218.3620,E,1,09,0.9,35.0,M,47.0,M,,*5A",
+    "$GPGGA,123454.00,4851.0012,N,00218.4440,E,1,09,0.9,35.0,M,47.0,M,,*58",
+    "$GPGGA,123501.00,4850.9991,N,00218.5260,E,1,09,0.9,35.0,M,47.0,M,,*56",
+    "$GPGGA,123508.00,4851.0000,N,00218.6080,E,1,09,0.9,35.0,M,47.0,M,,*59",
+    "$GPGGA,123515.00,4851.0012,N,00218.6900,E,1,09,0.9,35.0,M,47.0,M,,*57",
+    "$GPGGA,123522.00,4850.9991,N,00218.7720,E,1,09,0.9,35.0,M,47.0,M,,*54",
+    "$GPGGA,123529.00,4851.0000,N,00218.8540,E,1,09,0.9,35.0,M,47.0,M,,*5D",
+    "$GPGGA,123536.00,4851.0012,N,00218.9360,E,1,09,0.9,35.0,M,47.0,M,,*55",
+    "$GPGGA,123543.00,4850.9991,N,00219.0180,E,1,09,0.9,35.0,M,47.0,M,,*59",
+};
+
+#endif /* nmeaTrace.h */
@@ -304,6 +304,106 @@ void le_gnssSimu_SetLocation
     GnssLocation = gnssLocation;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a NMEA sentence (82 characters as per NMEA 0183), with some margin.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_SENTENCE_MAX_BYTES  128
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a NMEA "ddmm.mmmm" or "dddmm.mmmm" coordinate into 1e-6 degrees.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t NmeaToMicroDegrees
+(
+    const char* valuePtr,
+    const char* hemispherePtr
+)
+{
+    double value = strtod(valuePtr, NULL);
+    double degrees = floor(value / 100);
+    double microDegrees = (degrees + (value - degrees * 100) / 60) * 1000000.0;
+
+    if ((0 == strcmp(hemispherePtr, "S")) || (0 == strcmp(hemispherePtr, "W")))
+    {
+        microDegrees = -microDegrees;
+    }
+
+    return (int32_t)lround(microDegrees);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_gnssSimu_ReplayNmea: update simulated location data from a recorded GGA sentence
+ *
+ * @return
+ *  - LE_OK            The location was updated.
+ *  - LE_BAD_PARAMETER The sentence is not a valid GGA sentence.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnssSimu_ReplayNmea
+(
+    const char* sentencePtr
+)
+{
+    char buffer[NMEA_SENTENCE_MAX_BYTES];
+    const char* fieldPtr[9];
+    char* tokenPtr;
+    size_t count = 0;
+    const char* cursorPtr;
+    uint8_t checksum = 0;
+
+    if ((NULL == sentencePtr) || ('$' != sentencePtr[0]) ||
+        (LE_OK != le_utf8_Copy(buffer, sentencePtr, sizeof(buffer), NULL)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    // Verify the checksum of the characters between '$' and '*'.
+    for (cursorPtr = sentencePtr + 1; ('\0' != *cursorPtr) && ('*' != *cursorPtr); cursorPtr++)
+    {
+        checksum ^= (uint8_t)*cursorPtr;
+    }
+    if (('*' != *cursorPtr) || (checksum != (uint8_t)strtoul(cursorPtr + 1, NULL, 16)))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    // Split the fields, keeping the empty ones.
+    tokenPtr = buffer;
+    while ((count < NUM_ARRAY_MEMBERS(fieldPtr)) && (NULL != tokenPtr))
+    {
+        fieldPtr[count++] = strsep(&tokenPtr, ",*");
+    }
+
+    if ((count < NUM_ARRAY_MEMBERS(fieldPtr)) || (strlen(fieldPtr[0]) != 6) ||
+        (0 != strcmp(fieldPtr[0] + 3, "GGA")))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    // Fix quality 0 means no fix.
+    if (('\0' == fieldPtr[2][0]) || ('\0' == fieldPtr[4][0]) || ('0' == fieldPtr[6][0]))
+    {
+        GnssLocation.latitude = INT32_MAX;
+        GnssLocation.longitude = INT32_MAX;
+        GnssLocation.accuracy = INT32_MAX;
+        GnssLocation.result = LE_OUT_OF_RANGE;
+        return LE_OK;
+    }
+
+    GnssLocation.latitude = NmeaToMicroDegrees(fieldPtr[2], fieldPtr[3]);
+    GnssLocation.longitude = NmeaToMicroDegrees(fieldPtr[4], fieldPtr[5]);
+    // Horizontal accuracy estimated from the HDOP, in centimeters (UERE of 7 meters).
+    GnssLocation.accuracy = (int32_t)(strtod(fieldPtr[8], NULL) * 700);
+    GnssLocation.result = LE_OK;
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * le_gnssSimu_SetAltitude: update simulated altitude data
@@ -717,6 +817,10 @@ void le_gnss_RemovePositionHandler
     le_gnss_PositionHandlerRef_t    handlerRef ///< [IN] The handler reference.
 )
 {
+    if (NULL != handlerRef)
+    {
+        le_event_RemoveHandler((le_event_HandlerRef_t)handlerRef);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
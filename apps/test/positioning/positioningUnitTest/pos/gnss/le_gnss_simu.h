@@ -143,6 +143,7 @@ void le_gnssSimu_SetDop(gnssSimuDop_t dop);
 void le_gnssSimu_SetSampleRef(le_gnss_SampleRef_t sample);
 void le_gnssSimu_SetPositionState(gnssSimuPositionState_t state);
 void le_gnssSimu_ReportEvent(void);         ///to report the event for handler
+le_result_t le_gnssSimu_ReplayNmea(const char* sentencePtr); ///to replay a recorded GGA sentence
 
 //--------------------------------------------------------------------------------------------------
 /**
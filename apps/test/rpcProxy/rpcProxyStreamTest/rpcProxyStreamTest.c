@@ -0,0 +1,507 @@
+/**
+ * @file rpcProxyStreamTest.c
+ *
+ * RPC Proxy stream receive benchmark.
+ *
+ * Replays RPC Proxy client-request traffic through rpcProxy_RecvStream(), the way it arrives from
+ * the remote RPC Proxy, and checks that:
+ *  - every message is repacked into an IPC message identical to the one the remote client sent,
+ *  - the bytes read past the end of the message being received are kept for the next message,
+ *  - the messages of a message ID whose layout has been learnt are received in bulk, following
+ *    their repack plan.
+ *
+ * The traffic is replayed twice: once as a single network segment, and once cut into small
+ * segments so that most messages arrive in several pieces.  For each run, the number of messages
+ * repacked per second, the number of le_comm_Receive() calls per message and the number of
+ * messages received following a repack plan are reported.
+ *
+ * By default the replayed traffic is a mix of typical API calls packed by the test itself.  A
+ * capture of real traffic can be replayed instead by passing its path with -f.  A capture file
+ * holds a sequence of message bodies as sent by the remote RPC Proxy (big-endian IPC message ID
+ * followed by the CBOR encoded parameters), each one preceded by its size as a big-endian 32-bit
+ * integer.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "le_rpcProxy.h"
+#include "le_rpcProxyNetwork.h"
+#include "le_rpcProxyEventHandler.h"
+
+/// Largest IPC message.
+#define MAX_MSG_SIZE            1024
+
+/// Number of messages in the built-in traffic.
+#ifdef LE_CONFIG_REDUCE_FOOTPRINT
+#   define MSG_COUNT            1000
+#else
+#   define MSG_COUNT            20000
+#endif
+
+/// Largest replayed traffic, in bytes.
+#define MAX_TRAFFIC_SIZE        (MSG_COUNT * 512)
+
+/// Size of the network segments in the fragmented run.  Deliberately not a power of two so that
+/// segment boundaries fall at every position inside the CBOR items.
+#define SMALL_SEGMENT_SIZE      61
+
+/// Service ID used for all the replayed messages.
+#define SERVICE_ID              7
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replayed message.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t offset;              ///< Offset of the message body in the traffic.
+    size_t size;                ///< Size of the message body (IPC message ID included).
+}
+Message_t;
+
+/// Replayed traffic.
+static uint8_t Traffic[MAX_TRAFFIC_SIZE];
+static size_t TrafficSize;
+static Message_t Messages[MSG_COUNT];
+static size_t MessageCount;
+
+/// Replay state: the stream may read up to SegmentEnd, and has read up to ReadOffset.
+static size_t ReadOffset;
+static size_t SegmentEnd;
+static uint64_t ReceiveCallCount;
+static bool ChannelDeleted;
+
+/// Session the repacked messages are created on.
+static le_msg_SessionRef_t SessionRef;
+
+/// Network message receive state, as used by the RPC Proxy.
+static NetworkMessageState_t NetworkMessageState;
+
+/// Path of the capture to replay (NULL to use the built-in traffic).
+static const char* CaptureFilePath;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_comm_Receive() replacement: reads the replayed traffic, up to the end of the current segment.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_comm_Receive
+(
+    void* handle,
+    void* buf,
+    size_t* len
+)
+{
+    LE_UNUSED(handle);
+
+    size_t available = SegmentEnd - ReadOffset;
+    if (*len > available)
+    {
+        *len = available;
+    }
+    memcpy(buf, &Traffic[ReadOffset], *len);
+    ReadOffset += *len;
+    ReceiveCallCount++;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_comm_Send() replacement: nothing is sent by this test.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_comm_Send
+(
+    void* handle,
+    const void* buf,
+    size_t len
+)
+{
+    LE_UNUSED(handle);
+    LE_UNUSED(buf);
+    LE_UNUSED(len);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * RPC Proxy functions used by the stream module.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_SessionRef_t rpcProxy_GetSessionRefById
+(
+    uint32_t serviceId
+)
+{
+    LE_UNUSED(serviceId);
+
+    return SessionRef;
+}
+
+le_msg_ServiceRef_t rpcProxy_GetServiceRefById
+(
+    uint32_t serviceId
+)
+{
+    LE_UNUSED(serviceId);
+
+    return NULL;
+}
+
+le_msg_MessageRef_t rpcProxy_GetMsgRefById
+(
+    uint32_t proxyId
+)
+{
+    LE_UNUSED(proxyId);
+
+    return NULL;
+}
+
+le_result_t rpcEventHandler_RepackOutgoingContext
+(
+    le_pack_SemanticTag_t tagId,
+    void* contextPtr,
+    void** contextPtrPtr,
+    rpcProxy_Message_t* proxyMessagePtr
+)
+{
+    LE_UNUSED(tagId);
+    LE_UNUSED(proxyMessagePtr);
+
+    *contextPtrPtr = contextPtr;
+    return LE_OK;
+}
+
+le_result_t rpcEventHandler_RepackIncomingContext
+(
+    le_pack_SemanticTag_t tagId,
+    void* contextPtr,
+    void** contextPtrPtr,
+    rpcProxy_Message_t* proxyMessagePtr
+)
+{
+    LE_UNUSED(tagId);
+    LE_UNUSED(proxyMessagePtr);
+
+    *contextPtrPtr = contextPtr;
+    return LE_OK;
+}
+
+void rpcProxyNetwork_DeleteNetworkCommunicationChannelByHandle
+(
+    void* handle
+)
+{
+    LE_UNUSED(handle);
+
+    ChannelDeleted = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack one of the typical API calls making up the built-in traffic.
+ *
+ * @return Pointer past the packed parameters.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* PackParameters
+(
+    uint8_t* bufferPtr,     ///< [IN] Where to pack the parameters.
+    uint32_t callIndex      ///< [IN] Index of the call in the traffic.
+)
+{
+    static const char* const Names[] =
+    {
+        "eth0", "rmnet_data0", "/legato/systems/current/apps/modemService/config", ""
+    };
+    uint8_t blob[200];
+    int i;
+
+    LE_ASSERT(le_pack_PackIndefArrayHeader(&bufferPtr));
+
+    switch (callIndex % 5)
+    {
+        case 0:
+            // Scalars: reference, integers of all sizes, boolean.
+            LE_ASSERT(le_pack_PackTaggedReference(&bufferPtr,
+                                                  (void*)(uintptr_t)(2 * callIndex + 1),
+                                                  LE_PACK_REFERENCE));
+            LE_ASSERT(le_pack_PackInt32(&bufferPtr, -(int32_t)callIndex));
+            LE_ASSERT(le_pack_PackUint8(&bufferPtr, callIndex & 0x0F));
+            LE_ASSERT(le_pack_PackUint64(&bufferPtr, (uint64_t)callIndex << 33));
+            LE_ASSERT(le_pack_PackBool(&bufferPtr, callIndex & 1));
+            break;
+
+        case 1:
+            // String and integer.
+            LE_ASSERT(le_pack_PackString(&bufferPtr, Names[callIndex % NUM_ARRAY_MEMBERS(Names)],
+                                         LE_PACK_CBOR_BUFFER_LENGTH));
+            LE_ASSERT(le_pack_PackUint32(&bufferPtr, callIndex));
+            break;
+
+        case 2:
+            // Sizes of output buffers.
+            LE_ASSERT(le_pack_PackSemanticTag(&bufferPtr, LE_PACK_OUT_STRING_SIZE));
+            LE_ASSERT(le_pack_PackUint32(&bufferPtr, 256));
+            LE_ASSERT(le_pack_PackSemanticTag(&bufferPtr, LE_PACK_OUT_BYTE_STR_SIZE));
+            LE_ASSERT(le_pack_PackUint32(&bufferPtr, 100));
+            break;
+
+        case 3:
+            // Byte string and double.
+            for (i = 0; i < (int)sizeof(blob); i++)
+            {
+                blob[i] = (uint8_t)(callIndex + i);
+            }
+            LE_ASSERT(le_pack_PackByteString(&bufferPtr, blob, 20 + callIndex % 180));
+            LE_ASSERT(le_pack_PackDouble(&bufferPtr, callIndex / 3.0));
+            break;
+
+        default:
+            // Array of integers.
+            LE_ASSERT(le_pack_PackArrayHeader(&bufferPtr, NULL, sizeof(uint16_t), 8, 8));
+            for (i = 0; i < 8; i++)
+            {
+                LE_ASSERT(le_pack_PackUint16(&bufferPtr, (uint16_t)(callIndex * i)));
+            }
+            break;
+    }
+
+    LE_ASSERT(le_pack_PackEndOfIndefArray(&bufferPtr));
+
+    return bufferPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the built-in traffic.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildTraffic
+(
+    void
+)
+{
+    uint32_t i;
+
+    TrafficSize = 0;
+    for (i = 0; i < MSG_COUNT; i++)
+    {
+        uint8_t* bodyPtr = &Traffic[TrafficSize];
+        uint32_t msgId = htobe32(i % 5);
+
+        memcpy(bodyPtr, &msgId, sizeof(msgId));
+        uint8_t* endPtr = PackParameters(bodyPtr + sizeof(msgId), i);
+
+        Messages[i].offset = TrafficSize;
+        Messages[i].size = endPtr - bodyPtr;
+        TrafficSize += Messages[i].size;
+        LE_ASSERT(TrafficSize + 512 <= sizeof(Traffic));
+    }
+    MessageCount = MSG_COUNT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the traffic from a capture file.
+ *
+ * @return LE_OK on success, LE_FAULT if the file cannot be read or is malformed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadTraffic
+(
+    const char* pathPtr     ///< [IN] Path of the capture file.
+)
+{
+    FILE* filePtr = fopen(pathPtr, "rb");
+    if (filePtr == NULL)
+    {
+        LE_ERROR("Cannot open '%s' (%m)", pathPtr);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+    uint32_t size;
+
+    TrafficSize = 0;
+    MessageCount = 0;
+    while (fread(&size, sizeof(size), 1, filePtr) == 1)
+    {
+        size = be32toh(size);
+        if ((MessageCount == MSG_COUNT) ||
+            (size > MAX_MSG_SIZE) ||
+            (TrafficSize + size > sizeof(Traffic)) ||
+            (fread(&Traffic[TrafficSize], 1, size, filePtr) != size))
+        {
+            LE_ERROR("Malformed or too large capture file '%s'", pathPtr);
+            result = LE_FAULT;
+            break;
+        }
+        Messages[MessageCount].offset = TrafficSize;
+        Messages[MessageCount].size = size;
+        TrafficSize += size;
+        MessageCount++;
+    }
+
+    fclose(filePtr);
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a repacked IPC message matches the message body it was received from.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckMessage
+(
+    le_msg_MessageRef_t msgRef,
+    const Message_t* messagePtr
+)
+{
+    const uint8_t* payloadPtr = le_msg_GetPayloadPtr(msgRef);
+    const uint8_t* bodyPtr = &Traffic[messagePtr->offset];
+    uint32_t msgId;
+
+    // The IPC message ID is in host byte order in the IPC message, and the parameters are
+    // identical.
+    memcpy(&msgId, bodyPtr, sizeof(msgId));
+    msgId = be32toh(msgId);
+
+    return ((memcmp(payloadPtr, &msgId, sizeof(msgId)) == 0) &&
+            (memcmp(payloadPtr + sizeof(msgId),
+                    bodyPtr + sizeof(msgId),
+                    messagePtr->size - sizeof(msgId)) == 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay the traffic, delivered in segments of the given size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Replay
+(
+    size_t segmentSize      ///< [IN] Size of the network segments.
+)
+{
+    StreamState_t* streamStatePtr = &NetworkMessageState.streamState;
+    rpcProxy_Message_t* proxyMessagePtr = (rpcProxy_Message_t*)NetworkMessageState.buffer;
+    size_t errorCount = 0;
+    size_t plannedCount = 0;
+    size_t i;
+
+    ReadOffset = 0;
+    NetworkMessageState.pendingSize = 0;
+    NetworkMessageState.pendingOffset = 0;
+    SegmentEnd = 0;
+    ReceiveCallCount = 0;
+    ChannelDeleted = false;
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < MessageCount; i++)
+    {
+        const Message_t* messagePtr = &Messages[i];
+        le_result_t result;
+
+        memset(proxyMessagePtr, 0, sizeof(*proxyMessagePtr));
+        proxyMessagePtr->commonHeader.id = i;
+        proxyMessagePtr->commonHeader.serviceId = SERVICE_ID;
+        proxyMessagePtr->commonHeader.type = RPC_PROXY_CLIENT_REQUEST;
+        LE_ASSERT(rpcProxy_InitializeStreamState(streamStatePtr, proxyMessagePtr) == LE_OK);
+
+        // Deliver segments until the message is complete, as the fd monitor would.
+        while ((result = rpcProxy_RecvStream(NULL, streamStatePtr, proxyMessagePtr)) ==
+               LE_IN_PROGRESS)
+        {
+            LE_ASSERT(SegmentEnd < TrafficSize);
+            SegmentEnd += segmentSize;
+            if (SegmentEnd > TrafficSize)
+            {
+                SegmentEnd = TrafficSize;
+            }
+        }
+
+        // Bytes read past the end of the message are pending, to be received with the next one.
+        size_t consumedOffset = ReadOffset - NetworkMessageState.pendingSize;
+        if ((result != LE_OK) ||
+            ChannelDeleted ||
+            (consumedOffset != messagePtr->offset + messagePtr->size) ||
+            !CheckMessage(proxyMessagePtr->msgRef, messagePtr))
+        {
+            LE_ERROR("Message %" PRIuS " not repacked correctly (result %s, consumed up to %" PRIuS
+                     " instead of %" PRIuS ")", i, LE_RESULT_TXT(result), consumedOffset,
+                     messagePtr->offset + messagePtr->size);
+            errorCount++;
+        }
+        if (streamStatePtr->planPtr != NULL)
+        {
+            plannedCount++;
+        }
+
+        le_msg_ReleaseMsg(proxyMessagePtr->msgRef);
+
+        if (consumedOffset != messagePtr->offset + messagePtr->size)
+        {
+            // Stream is out of sync, the following messages cannot be received.
+            break;
+        }
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    uint64_t elapsedUs = ((uint64_t)elapsed.sec * 1000000) + elapsed.usec;
+
+    LE_TEST_OK(errorCount == 0 && i == MessageCount,
+               "%" PRIuS "-byte segments: %" PRIuS " messages repacked", segmentSize, i);
+    LE_TEST_INFO("%" PRIuS "-byte segments: %" PRIuS " messages received following a repack plan",
+                 segmentSize, plannedCount);
+    LE_TEST_INFO("%" PRIuS "-byte segments: %" PRIuS " messages (%" PRIuS " bytes) in %" PRIu64
+                 " us, %" PRIu64 " messages/s, %" PRIu64 ".%02" PRIu64 " receive calls/message",
+                 segmentSize, i, TrafficSize, elapsedUs,
+                 (elapsedUs > 0) ? ((uint64_t)i * 1000000 / elapsedUs) : 0,
+                 (i > 0) ? ReceiveCallCount / i : 0,
+                 (i > 0) ? (ReceiveCallCount * 100 / i) % 100 : 0);
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetStringVar(&CaptureFilePath, "f", "capture");
+    le_arg_Scan();
+
+    LE_TEST_PLAN(2);
+
+    LE_TEST_INFO("======== BEGIN RPC PROXY STREAM BENCHMARK ========");
+
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef("rpcProxyStreamTest", MAX_MSG_SIZE);
+    SessionRef = le_msg_CreateSession(protocolRef, "rpcProxyStreamTest");
+
+    rpcProxy_InitializeOnceStreamingMemPools();
+
+    if (CaptureFilePath != NULL)
+    {
+        LE_ASSERT(LoadTraffic(CaptureFilePath) == LE_OK);
+        LE_TEST_INFO("Replaying %" PRIuS " messages from '%s'", MessageCount, CaptureFilePath);
+    }
+    else
+    {
+        BuildTraffic();
+    }
+
+    Replay(TrafficSize);
+    Replay(SMALL_SEGMENT_SIZE);
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,205 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Times NUM_UPDATES updates of NUM_ITEMS small secure storage items, one by one and in a batch
+ * write, then as many reads, and checks the items hold the last values written.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of updates of each measurement.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_UPDATES     1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of items updated in turn.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_ITEMS       50
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the items.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ITEM_SIZE       32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the name of an item.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetName
+(
+    int item,           ///< [IN] Item index.
+    char* namePtr,      ///< [OUT] Name.
+    size_t nameSize     ///< [IN] Size of the name buffer.
+)
+{
+    snprintf(namePtr, nameSize, "bench/item%d", item);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the value of an item for an update.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetValue
+(
+    int update,         ///< [IN] Update index.
+    uint8_t* valuePtr   ///< [OUT] Value, ITEM_SIZE bytes.
+)
+{
+    int i;
+
+    for (i = 0; i < ITEM_SIZE; i++)
+    {
+        valuePtr[i] = update + i;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the rate of a measurement.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogRate
+(
+    const char* namePtr,        ///< [IN] Measurement.
+    le_clk_Time_t start         ///< [IN] Start time.
+)
+{
+    le_clk_Time_t duration = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    uint64_t us = (uint64_t)duration.sec * 1000000 + duration.usec;
+
+    LE_TEST_INFO("%-24s %6" PRIu64 " ms, %8" PRIu64 " updates/s", namePtr, us / 1000,
+                 (us > 0) ? NUM_UPDATES * (uint64_t)1000000 / us : 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the items NUM_UPDATES times in turn.
+ *
+ * @return
+ *      Number of writes that failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static int Update
+(
+    int firstUpdate     ///< [IN] Index of the first update, to get different values.
+)
+{
+    char name[LE_SECSTORE_MAX_NAME_BYTES];
+    uint8_t value[ITEM_SIZE];
+    int errors = 0;
+    int i;
+
+    for (i = 0; i < NUM_UPDATES; i++)
+    {
+        GetName(i % NUM_ITEMS, name, sizeof(name));
+        GetValue(firstUpdate + i, value);
+        if (le_secStore_Write(name, value, sizeof(value)) != LE_OK)
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the items NUM_UPDATES times in turn, checking they hold the values of the last update.
+ *
+ * @return
+ *      Number of reads that failed or returned a wrong value.
+ */
+//--------------------------------------------------------------------------------------------------
+static int Check
+(
+    int lastUpdate      ///< [IN] Index after the last update.
+)
+{
+    char name[LE_SECSTORE_MAX_NAME_BYTES];
+    uint8_t value[ITEM_SIZE];
+    uint8_t expected[ITEM_SIZE];
+    int errors = 0;
+    int i;
+
+    for (i = 0; i < NUM_UPDATES; i++)
+    {
+        int item = i % NUM_ITEMS;
+        size_t size = sizeof(value);
+
+        GetName(item, name, sizeof(name));
+        GetValue(lastUpdate - NUM_ITEMS + item, expected);
+        if ((le_secStore_Read(name, value, &size) != LE_OK) || (size != sizeof(value)) ||
+            (memcmp(value, expected, sizeof(value)) != 0))
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+
+COMPONENT_INIT
+{
+    char name[LE_SECSTORE_MAX_NAME_BYTES];
+    uint8_t value[ITEM_SIZE];
+    size_t size = sizeof(value);
+    le_clk_Time_t start;
+    int errors = 0;
+    int i;
+
+    LE_TEST_PLAN(LE_TEST_NO_PLAN);
+
+    LE_TEST_INFO("=== %d updates of %d items of %d bytes ===", NUM_UPDATES, NUM_ITEMS, ITEM_SIZE);
+
+    start = le_clk_GetRelativeTime();
+    LE_TEST_OK(Update(0) == 0, "Update one by one");
+    LogRate("Update one by one", start);
+
+    start = le_clk_GetRelativeTime();
+    LE_TEST_OK(le_secStore_StartBatchWrite() == LE_OK, "StartBatchWrite");
+    LE_TEST_OK(Update(NUM_UPDATES) == 0, "Update in a batch write");
+    LE_TEST_OK(le_secStore_EndBatchWrite() == LE_OK, "EndBatchWrite");
+    LogRate("Update in a batch write", start);
+
+    start = le_clk_GetRelativeTime();
+    LE_TEST_OK(Check(2 * NUM_UPDATES) == 0, "Read last values");
+    LogRate("Read", start);
+
+    // An item deleted before being committed must not come back.
+    GetValue(0, value);
+    LE_TEST_OK(le_secStore_Write("bench/tmp", value, sizeof(value)) == LE_OK, "Write bench/tmp");
+    LE_TEST_OK(le_secStore_Delete("bench/tmp") == LE_OK, "Delete bench/tmp");
+    LE_TEST_OK(le_secStore_Read("bench/tmp", value, &size) == LE_NOT_FOUND,
+               "bench/tmp not found");
+
+    for (i = 0; i < NUM_ITEMS; i++)
+    {
+        GetName(i, name, sizeof(name));
+        if (le_secStore_Delete(name) != LE_OK)
+        {
+            errors++;
+        }
+    }
+    LE_TEST_OK(errors == 0, "Delete items");
+
+    LE_TEST_EXIT;
+}
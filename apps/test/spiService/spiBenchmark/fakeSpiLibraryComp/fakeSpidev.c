@@ -0,0 +1,215 @@
+/**
+ * This module is a stand-in for the spidev kernel driver, so that the SPI service can be exercised
+ * without hardware. The ioctl() calls of the SPI library are redirected here at build time.
+ *
+ * The fake slave device has 128 one-byte registers. After the chip select, the first byte clocked
+ * out is a command: bit 7 set to read, clear to write, and the address of the first register in
+ * bits 0 to 6. The following bytes are read from or written to the next registers, the address
+ * wrapping around. Like the real driver, a SPI message is limited to FAKE_SPIDEV_BUFSIZ bytes.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include <stdarg.h>
+#include <sys/ioctl.h>
+#include <linux/types.h>
+#include <linux/spi/spidev.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Max number of bytes in a SPI message, as the default bufsiz parameter of spidev.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FAKE_SPIDEV_BUFSIZ      4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of registers of the fake slave device.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FAKE_SPIDEV_NUM_REGS    128
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read bit of the command byte.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FAKE_SPIDEV_CMD_READ    0x80
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the fake device. One device is emulated, whatever the file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct
+{
+    uint8_t  mode;                          ///< SPI mode
+    uint8_t  bits;                          ///< Bits per word
+    uint32_t speed;                         ///< Max speed (Hz)
+    uint8_t  lsb;                           ///< LSB first
+    uint8_t  regs[FAKE_SPIDEV_NUM_REGS];    ///< Registers of the slave
+    bool     isCmdReceived;                 ///< A command was received since the chip select
+    bool     isRead;                        ///< The command is a read
+    uint8_t  address;                       ///< Next register accessed
+    uint64_t messageCount;                  ///< Number of SPI messages
+    uint64_t transferCount;                 ///< Number of transfers
+    uint64_t byteCount;                     ///< Number of bytes clocked
+}
+Device = { .bits = 8, .speed = 1000000 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clock one byte in and out of the fake slave.
+ *
+ * @return Byte clocked in by the master
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ClockByte
+(
+    uint8_t txByte      ///< [IN] Byte clocked out by the master
+)
+{
+    uint8_t rxByte = 0;
+
+    if (!Device.isCmdReceived)
+    {
+        Device.isCmdReceived = true;
+        Device.isRead = ((txByte & FAKE_SPIDEV_CMD_READ) != 0);
+        Device.address = txByte & (FAKE_SPIDEV_NUM_REGS - 1);
+    }
+    else if (Device.isRead)
+    {
+        rxByte = Device.regs[Device.address];
+        Device.address = (Device.address + 1) % FAKE_SPIDEV_NUM_REGS;
+    }
+    else
+    {
+        Device.regs[Device.address] = txByte;
+        Device.address = (Device.address + 1) % FAKE_SPIDEV_NUM_REGS;
+    }
+
+    return rxByte;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform a SPI message.
+ *
+ * @return Number of bytes transferred, or -1 with errno set.
+ */
+//--------------------------------------------------------------------------------------------------
+static int Message
+(
+    const struct spi_ioc_transfer* trPtr,   ///< [IN] Transfers
+    size_t count                            ///< [IN] Number of transfers
+)
+{
+    size_t total = 0;
+    size_t i, j;
+
+    for (i = 0; i < count; i++)
+    {
+        total += trPtr[i].len;
+    }
+    if (total > FAKE_SPIDEV_BUFSIZ)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        const uint8_t* txPtr = (const uint8_t*)(uintptr_t)trPtr[i].tx_buf;
+        uint8_t* rxPtr = (uint8_t*)(uintptr_t)trPtr[i].rx_buf;
+
+        for (j = 0; j < trPtr[i].len; j++)
+        {
+            uint8_t rxByte = ClockByte(txPtr ? txPtr[j] : 0);
+            if (rxPtr)
+            {
+                rxPtr[j] = rxByte;
+            }
+        }
+
+        // The chip select is released after a transfer flagged with cs_change, but the last one.
+        if (trPtr[i].cs_change && (i < count - 1))
+        {
+            Device.isCmdReceived = false;
+        }
+    }
+    Device.isCmdReceived = false;
+
+    Device.messageCount++;
+    Device.transferCount += count;
+    Device.byteCount += total;
+    LE_DEBUG("Message %"PRIu64": %"PRIuS" transfers, %"PRIuS" bytes",
+             Device.messageCount, count, total);
+
+    return total;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stand-in for ioctl(2) on a spidev device.
+ */
+//--------------------------------------------------------------------------------------------------
+int fakeSpidev_Ioctl
+(
+    int fd,
+    unsigned long request,
+    ...
+)
+{
+    va_list args;
+    void* argPtr;
+
+    va_start(args, request);
+    argPtr = va_arg(args, void*);
+    va_end(args);
+
+    if ((_IOC_TYPE(request) == SPI_IOC_MAGIC) && (_IOC_NR(request) == 0) &&
+        (_IOC_DIR(request) == _IOC_WRITE))
+    {
+        size_t size = _IOC_SIZE(request);
+
+        if ((size == 0) || (size % sizeof(struct spi_ioc_transfer)))
+        {
+            errno = EINVAL;
+            return -1;
+        }
+        return Message(argPtr, size / sizeof(struct spi_ioc_transfer));
+    }
+
+    switch (request)
+    {
+        case SPI_IOC_WR_MODE:
+            Device.mode = *(uint8_t*)argPtr;
+            return 0;
+        case SPI_IOC_RD_MODE:
+            *(uint8_t*)argPtr = Device.mode;
+            return 0;
+        case SPI_IOC_WR_BITS_PER_WORD:
+            Device.bits = *(uint8_t*)argPtr;
+            return 0;
+        case SPI_IOC_RD_BITS_PER_WORD:
+            *(uint8_t*)argPtr = Device.bits;
+            return 0;
+        case SPI_IOC_WR_MAX_SPEED_HZ:
+            Device.speed = *(uint32_t*)argPtr;
+            return 0;
+        case SPI_IOC_RD_MAX_SPEED_HZ:
+            *(uint32_t*)argPtr = Device.speed;
+            return 0;
+        case SPI_IOC_WR_LSB_FIRST:
+            Device.lsb = *(uint8_t*)argPtr;
+            return 0;
+        case SPI_IOC_RD_LSB_FIRST:
+            *(uint8_t*)argPtr = Device.lsb;
+            return 0;
+        default:
+            errno = ENOTTY;
+            return -1;
+    }
+}
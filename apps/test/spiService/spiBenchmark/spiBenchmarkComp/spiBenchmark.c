@@ -0,0 +1,365 @@
+/**
+ * This module implements a benchmark of the SPI service, run on the fake spidev driver of the
+ * fakeSpiService executable so that no hardware is needed.
+ *
+ * The fake slave device has 128 registers (see fakeSpidev.c). The benchmark logs how many register
+ * reads per second and how many bytes per second go through the SPI service:
+ *  - register reads with one le_spi_WriteReadHD() per register,
+ *  - register reads batched in le_spi_Transaction(),
+ *  - bulk reads with le_spi_WriteReadHD(), le_spi_Transaction() and le_spi_SharedTransaction().
+ *
+ * Issue the following commands:
+ * @verbatim
+  $ app start spiBenchmark
+  $ app runProc spiBenchmark --exe=spiBenchmark -- [<number of register reads>]
+  @endverbatim
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// Define the memfd declarations missing from older C libraries.
+#ifndef MFD_ALLOW_SEALING
+# define MFD_ALLOW_SEALING  0x0002U
+#endif
+#ifndef F_ADD_SEALS
+# define F_ADD_SEALS    (1024 + 9)
+# define F_SEAL_SHRINK  0x0002
+# define F_SEAL_GROW    0x0004
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default number of register reads in each phase.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_READ_COUNT      10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of registers of the fake slave device, and read bit of the command byte.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_REGS                128
+#define CMD_READ                0x80
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a register, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REG_SIZE                2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of register reads batched in one transaction: a write transfer and a read transfer each.
+ */
+//--------------------------------------------------------------------------------------------------
+#define READS_PER_TRANSACTION   (LE_SPI_MAX_TRANSFERS / 2)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a SPI message for the bulk reads, as limited by spidev.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BULK_MESSAGE_SIZE       4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes read in each bulk phase.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BULK_SIZE               (4 * 1024 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Device of the fake spidev driver. Any device file can be used, the ioctls are faked.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEVICE_NAME             "null"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle of the SPI device.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_spi_DeviceHandleRef_t SpiHandle;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of register reads in each phase.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ReadCount = DEFAULT_READ_COUNT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value written in a register of the fake slave device.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t RegValue
+(
+    int address
+)
+{
+    return (uint8_t)(address * 3 + 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute a rate per second.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t Rate
+(
+    uint64_t count,         ///< [IN] Number of things done
+    le_clk_Time_t start     ///< [IN] When they started
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    uint64_t usec = (uint64_t) elapsed.sec * 1000000 + elapsed.usec;
+
+    return (usec == 0) ? 0 : (count * 1000000 / usec);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the bytes read from consecutive registers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRegisters
+(
+    int address,            ///< [IN] First register
+    const uint8_t* dataPtr, ///< [IN] Bytes read
+    size_t size             ///< [IN] Number of bytes read
+)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        LE_FATAL_IF(dataPtr[i] != RegValue((address + i) % NUM_REGS),
+                    "Register 0x%02zx: read 0x%02x, 0x%02x expected",
+                    (address + i) % NUM_REGS, dataPtr[i], RegValue((address + i) % NUM_REGS));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read registers one at a time with le_spi_WriteReadHD().
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadRegisters
+(
+    void
+)
+{
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    uint8_t rx[REG_SIZE];
+    int i;
+
+    for (i = 0; i < ReadCount; i++)
+    {
+        int address = (i * REG_SIZE) % NUM_REGS;
+        uint8_t cmd = CMD_READ | address;
+        size_t rxSize = sizeof(rx);
+
+        LE_ASSERT_OK(le_spi_WriteReadHD(SpiHandle, &cmd, 1, rx, &rxSize));
+        CheckRegisters(address, rx, REG_SIZE);
+    }
+
+    LE_INFO("le_spi_WriteReadHD: %d register reads, %"PRIu64" reads/s",
+            ReadCount, Rate(ReadCount, start));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read registers READS_PER_TRANSACTION at a time with le_spi_Transaction().
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadRegistersBatched
+(
+    void
+)
+{
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    le_spi_Transfer_t transfers[2 * READS_PER_TRANSACTION];
+    uint8_t cmds[READS_PER_TRANSACTION];
+    uint8_t rx[READS_PER_TRANSACTION * REG_SIZE];
+    int i, j;
+
+    for (j = 0; j < READS_PER_TRANSACTION; j++)
+    {
+        transfers[2 * j] = (le_spi_Transfer_t){ .length = 1, .flags = LE_SPI_TRANSFER_WRITE };
+        transfers[2 * j + 1] = (le_spi_Transfer_t){
+            .length = REG_SIZE,
+            .flags = LE_SPI_TRANSFER_READ | LE_SPI_TRANSFER_CS_CHANGE };
+    }
+
+    for (i = 0; i < ReadCount; i += READS_PER_TRANSACTION)
+    {
+        int count = (ReadCount - i < READS_PER_TRANSACTION) ? (ReadCount - i) :
+                                                              READS_PER_TRANSACTION;
+        size_t rxSize = sizeof(rx);
+
+        for (j = 0; j < count; j++)
+        {
+            cmds[j] = CMD_READ | (((i + j) * REG_SIZE) % NUM_REGS);
+        }
+        LE_ASSERT_OK(le_spi_Transaction(SpiHandle, transfers, 2 * count, cmds, count,
+                                        rx, &rxSize));
+        LE_ASSERT(rxSize == (size_t)count * REG_SIZE);
+        for (j = 0; j < count; j++)
+        {
+            CheckRegisters(((i + j) * REG_SIZE) % NUM_REGS, rx + j * REG_SIZE, REG_SIZE);
+        }
+    }
+
+    LE_INFO("le_spi_Transaction: %d register reads, %d per transaction, %"PRIu64" reads/s",
+            ReadCount, READS_PER_TRANSACTION, Rate(ReadCount, start));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bulk read with le_spi_WriteReadHD(), limited to LE_SPI_MAX_READ_SIZE bytes per call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BulkRead
+(
+    void
+)
+{
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    uint8_t cmd = CMD_READ;
+    uint8_t rx[LE_SPI_MAX_READ_SIZE];
+    size_t done;
+
+    for (done = 0; done < BULK_SIZE; done += sizeof(rx))
+    {
+        size_t rxSize = sizeof(rx);
+
+        LE_ASSERT_OK(le_spi_WriteReadHD(SpiHandle, &cmd, 1, rx, &rxSize));
+        CheckRegisters(0, rx, sizeof(rx));
+    }
+
+    LE_INFO("le_spi_WriteReadHD: %d KiB read, %d bytes per call, %"PRIu64" KiB/s",
+            BULK_SIZE / 1024, LE_SPI_MAX_READ_SIZE, Rate(BULK_SIZE / 1024, start));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bulk read with le_spi_Transaction(), one SPI message of BULK_MESSAGE_SIZE bytes per call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BulkReadTransaction
+(
+    void
+)
+{
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    le_spi_Transfer_t transfers[] =
+    {
+        { .length = 1, .flags = LE_SPI_TRANSFER_WRITE },
+        { .length = BULK_MESSAGE_SIZE - 1, .flags = LE_SPI_TRANSFER_READ },
+    };
+    uint8_t cmd = CMD_READ;
+    uint8_t rx[BULK_MESSAGE_SIZE - 1];
+    size_t done;
+
+    for (done = 0; done < BULK_SIZE; done += sizeof(rx))
+    {
+        size_t rxSize = sizeof(rx);
+
+        LE_ASSERT_OK(le_spi_Transaction(SpiHandle, transfers, NUM_ARRAY_MEMBERS(transfers),
+                                        &cmd, 1, rx, &rxSize));
+        CheckRegisters(0, rx, sizeof(rx));
+    }
+
+    LE_INFO("le_spi_Transaction: %d KiB read, %d bytes per call, %"PRIu64" KiB/s",
+            BULK_SIZE / 1024, BULK_MESSAGE_SIZE, Rate(BULK_SIZE / 1024, start));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bulk read with le_spi_SharedTransaction(), one SPI message of BULK_MESSAGE_SIZE bytes per call,
+ * the data being in a shared buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BulkReadShared
+(
+    void
+)
+{
+    le_spi_Transfer_t transfers[] =
+    {
+        { .length = 1, .flags = LE_SPI_TRANSFER_WRITE },
+        { .length = BULK_MESSAGE_SIZE - 1, .flags = LE_SPI_TRANSFER_READ },
+    };
+    uint8_t* bufferPtr;
+    size_t done;
+    int fd;
+
+    // The buffer is a memfd, sealed so that the SPI service can map it safely.
+    fd = syscall(SYS_memfd_create, "spiBenchmark", MFD_ALLOW_SEALING);
+    LE_FATAL_IF(fd < 0, "Cannot create the buffer: %m");
+    LE_FATAL_IF(ftruncate(fd, BULK_MESSAGE_SIZE) != 0, "ftruncate failed: %m");
+    LE_FATAL_IF(fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0,
+                "Cannot seal the buffer: %m");
+    bufferPtr = mmap(NULL, BULK_MESSAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    LE_FATAL_IF(bufferPtr == MAP_FAILED, "mmap failed: %m");
+    bufferPtr[0] = CMD_READ;
+
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    for (done = 0; done < BULK_SIZE; done += BULK_MESSAGE_SIZE - 1)
+    {
+        // The file descriptor sent to the service is closed, so a duplicate is sent.
+        LE_ASSERT_OK(le_spi_SharedTransaction(SpiHandle, transfers, NUM_ARRAY_MEMBERS(transfers),
+                                              dup(fd)));
+        CheckRegisters(0, bufferPtr + 1, BULK_MESSAGE_SIZE - 1);
+    }
+
+    LE_INFO("le_spi_SharedTransaction: %d KiB read, %d bytes per call, %"PRIu64" KiB/s",
+            BULK_SIZE / 1024, BULK_MESSAGE_SIZE, Rate(BULK_SIZE / 1024, start));
+
+    munmap(bufferPtr, BULK_MESSAGE_SIZE);
+    close(fd);
+}
+
+COMPONENT_INIT
+{
+    uint8_t regs[1 + NUM_REGS];
+    int i;
+
+    if (le_arg_NumArgs() >= 1)
+    {
+        ReadCount = atoi(le_arg_GetArg(0));
+        LE_FATAL_IF(ReadCount <= 0, "Invalid number of register reads '%s'", le_arg_GetArg(0));
+    }
+
+    LE_ASSERT_OK(le_spi_Open(DEVICE_NAME, &SpiHandle));
+    le_spi_Configure(SpiHandle, 0, 8, 960000, 0);
+
+    // Write all the registers, from address 0
+    regs[0] = 0;
+    for (i = 0; i < NUM_REGS; i++)
+    {
+        regs[1 + i] = RegValue(i);
+    }
+    LE_ASSERT_OK(le_spi_WriteHD(SpiHandle, regs, sizeof(regs)));
+
+    ReadRegisters();
+    ReadRegistersBatched();
+    BulkRead();
+    BulkReadTransaction();
+    BulkReadShared();
+
+    le_spi_Close(SpiHandle);
+
+    LE_INFO("======== SPI benchmark done ========");
+    exit(EXIT_SUCCESS);
+}
@@ -25,6 +25,8 @@
 // For htonl
 #include <arpa/inet.h>
 
+#include "timeSeriesStore.h"
+
 #if FEATURE_TIMESERIES
 #   error "This time series implementation is obsolete"
 #endif
@@ -64,12 +66,60 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of bytes for CBOR encoded time series data
+ * Maximum number of bytes for CBOR encoded time series data, i.e. for one time series
+ * notification.
  */
 //--------------------------------------------------------------------------------------------------
 #define MAX_CBOR_BUFFER_NUMBYTES 1024
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for the TLV of one observe notification.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_NOTIFY_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of changed fields of an instance written in one notification.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NOTIFY_FIELD_LIST_NUM 32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay, in ms, over which the changes of observed fields are coalesced before being notified.
+ * If 0, the changes are notified right away.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NOTIFY_COALESCE_MS LE_CONFIG_AVC_NOTIFY_COALESCE_MS
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes for the cached TLV of the readable fields of an instance.  It is the
+ * largest field list that fits in an instance TLV of 256 bytes, header included.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TLV_CACHE_NUMBYTES (256-6)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configuration of the time series stores:
+ *  - storeDir: directory of the store files,
+ *  - storeSize: number of bytes of samples kept per field,
+ *  - maxAge: samples older than this many seconds are dropped (0: no limit).
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_CFG "/apps/avcService/timeSeries"
+#define DEFAULT_TIME_SERIES_DIR "/data/le_fs/avc/timeSeries"
+#define DEFAULT_TIME_SERIES_STORE_NUMBYTES (64 * 1024)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks the return value from the tinyCBOR encoder and returns from function if an error is found.
@@ -153,6 +203,11 @@ typedef struct le_avdata_AssetInstance
     AssetData_t* assetDataPtr;   ///< Back reference to asset data containing this instance
     le_dls_List_t fieldList;     ///< List of fields for this instance
     le_dls_Link_t link;          ///< For adding to the asset instance list
+    uint8_t* tlvCachePtr;        ///< TLV of the readable fields, or NULL if not read yet
+    size_t tlvCacheNumBytes;     ///< # bytes in the cached TLV
+    bool isTlvCacheValid;        ///< Does the cached TLV hold the current field values?
+    le_dls_List_t notifyList;    ///< Changed fields waiting to be notified
+    le_dls_Link_t notifyLink;    ///< For adding to NotifyInstanceList, if notifyList is not empty
 }
 InstanceData_t;
 
@@ -164,26 +219,9 @@ InstanceData_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    uint8_t* bufferPtr;             ///< Buffer for accumulating history data.
-    size_t bufferSize;              ///< Buffer size of history data.
-
-#if FEATURE_TIMESERIES
+    timeSeriesStore_Ref_t storeRef; ///< Samples accumulated so far.
     double timeStampFactor;         ///< Factor of time stamp.
-    uint64_t prevTimeStamp;         ///< Time stamp of last data capture, used for delta encoding.
-
     double factor;                  ///< Factor of data.
-    union
-    {
-        int prevIntValue;           ///< Value of of last data capture - used for delta encoding.
-        double prevFloatValue;      ///< Value of last data capture - used for delta encoding.
-    };
-
-    uint32_t numElements;           ///< Number of elements in cbor encoded stream.
-
-    CborEncoder streamRef;          ///< CBOR encoded stream reference.
-    CborEncoder mapRef;             ///< CBOR encoded map reference.
-    CborEncoder sampleRef;          ///< CBOR encoded sample data reference.
-#endif
 }
 TimeSeriesData_t;
 
@@ -194,7 +232,7 @@ TimeSeriesData_t;
  * Data contained in a single field of an asset instance
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct assetData_FieldData
 {
     int fieldId;
     char name[100];
@@ -214,6 +252,9 @@ typedef struct
 
     TimeSeriesData_t* timeSeriesPtr;
 
+    bool isNotifyPending;        ///< Is the field in the notify list of its instance?
+    le_dls_Link_t notifyLink;    ///< For adding to the notify list of the instance
+
     le_dls_Link_t link;          ///< For adding to the field list
 }
 FieldData_t;
@@ -335,6 +376,31 @@ static le_hashmap_Ref_t AssetMapByName = NULL;
 static le_timer_Ref_t RegUpdateTimerRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Used to coalesce the changes of observed fields over NOTIFY_COALESCE_MS, so that they are
+ * notified together.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t NotifyTimerRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Instances which have changed fields waiting to be notified, in the order of their first change.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t NotifyInstanceList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Instance TLV cache memory pool.  Initialized in assetData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t TlvCachePoolRef = NULL;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Time series data memory pool.  Initialized in assetData_Init().
@@ -396,9 +462,10 @@ static bool IsRegUpdatePending = false;
 //--------------------------------------------------------------------------------------------------
 static le_result_t WriteNotifyObjectToTLV
 (
-    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
-    int instanceId,                             ///< [IN] Instance that has a changed resource
-    int fieldId,                                ///< [IN] The resource which changed
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Instance that has changed resources
+    FieldData_t** fieldListPtr,                 ///< [IN] The resources which changed
+    size_t* numFieldsPtr,                       ///< [IN/OUT] # resources in the list; # resources
+                                                ///<          written to buffer.
     uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
     size_t bufNumBytes,                         ///< [IN] Size of buffer
     size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
@@ -563,6 +630,8 @@ static void InitDefaultFieldData
 {
     fieldDataPtr->isObserve = false;
     fieldDataPtr->readCallBackOpRef = NULL;
+    fieldDataPtr->isNotifyPending = false;
+    fieldDataPtr->notifyLink = LE_DLS_LINK_INIT;
 
     fieldDataPtr->timeSeriesPtr = NULL;
 
@@ -1292,10 +1361,54 @@ static le_result_t GetField
 
 
 
+#if FEATURE_TIMESERIES
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the type of time series store for a field.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if time series can't be recorded for this type of field
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetTimeSeriesStoreType
+(
+    FieldData_t* fieldDataPtr,                  ///< [IN] Field
+    timeSeriesStore_Type_t* typePtr             ///< [OUT] Type of store
+)
+{
+    switch ( fieldDataPtr->type )
+    {
+        case DATA_TYPE_INT:
+            *typePtr = TIME_SERIES_STORE_TYPE_INT;
+            return LE_OK;
+
+        case DATA_TYPE_FLOAT:
+            *typePtr = TIME_SERIES_STORE_TYPE_FLOAT;
+            return LE_OK;
+
+        case DATA_TYPE_BOOL:
+            *typePtr = TIME_SERIES_STORE_TYPE_BOOL;
+            return LE_OK;
+
+        case DATA_TYPE_STRING:
+            *typePtr = TIME_SERIES_STORE_TYPE_STRING;
+            return LE_OK;
+
+        default:
+            return LE_FAULT;
+    }
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Allocate resources and start accumulating time series data on the specified field.
  *
+ * The samples are kept in a store file named after the field, so samples recorded before the
+ * daemon restarted are kept, as long as the store configuration didn't change.
+ *
  * @return:
  *      - LE_OK on success
  *      - LE_NOT_FOUND if field not found
@@ -1315,11 +1428,12 @@ static le_result_t StartTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t* timeSeriesBufferPtr;
-    char headerId[64];
-    CborError err;
-    CborEncoder headerArray;
-    CborEncoder factorArray;
+    timeSeriesStore_Type_t storeType;
+    timeSeriesStore_Ref_t storeRef;
+    char storeDir[LIMIT_MAX_PATH_BYTES];
+    char storePath[LIMIT_MAX_PATH_BYTES];
+    uint32_t storeSize;
+    uint32_t maxAge;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -1335,86 +1449,50 @@ static le_result_t StartTimeSeries
         return LE_BUSY;
     }
 
-    FormatString(headerId,
-                 sizeof(headerId),
-                 "/%i/%i",
-                 instanceRef->instanceId,
-                 fieldId);
-
-    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
-
-    memset(fieldDataPtr->timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
-
-    timeSeriesBufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
-    fieldDataPtr->timeSeriesPtr->bufferPtr = timeSeriesBufferPtr;
-
-    fieldDataPtr->timeSeriesPtr->bufferSize = MAX_CBOR_BUFFER_NUMBYTES;
-
-    // Initialize CBOR stream.
-    cbor_encoder_init(&fieldDataPtr->timeSeriesPtr->streamRef,
-                      timeSeriesBufferPtr,
-                      MAX_CBOR_BUFFER_NUMBYTES,
-                      0);
-
-    err = cbor_encoder_create_map(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                  &fieldDataPtr->timeSeriesPtr->mapRef,
-                                  NUM_TIME_SERIES_MAPS);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create a map and add the header in to the map.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "h");
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create an array for the header.
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &headerArray,
-                                    1);
-    RETURN_IF_CBOR_ERROR(err);
-
-    err = cbor_encode_text_string(&headerArray, headerId, strlen(headerId));
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the heade map i.e done with entering in to header array.
-    // e.g. "h" : [/1000/0]  --> map for header.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &headerArray);
-
-    // Create a map for factor.
-    // e.g. "f" : [1]  --> map for factor.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "f");
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create an array of factors (time stamp factor, data factor)
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &factorArray,
-                                    2);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Add factor for time stamp.
-    err = cbor_encode_double(&factorArray, timeStampFactor);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Add factor for sample.
-    err = cbor_encode_double(&factorArray, factor);
-    RETURN_IF_CBOR_ERROR(err);
+    if (GetTimeSeriesStoreType(fieldDataPtr, &storeType) != LE_OK)
+    {
+        LE_ERROR("Time series not supported on field %d.", fieldId);
+        return LE_FAULT;
+    }
 
-    // Close the map i.e done with entering in to factor array.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &factorArray);
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(TIME_SERIES_CFG);
+    le_cfg_GetString(iterRef, "storeDir", storeDir, sizeof(storeDir), DEFAULT_TIME_SERIES_DIR);
+    storeSize = le_cfg_GetInt(iterRef, "storeSize", DEFAULT_TIME_SERIES_STORE_NUMBYTES);
+    maxAge = le_cfg_GetInt(iterRef, "maxAge", 0);
+    if ((int32_t)storeSize <= 0)
+    {
+        storeSize = DEFAULT_TIME_SERIES_STORE_NUMBYTES;
+    }
+    if ((int32_t)maxAge < 0)
+    {
+        maxAge = 0;
+    }
+    le_cfg_CancelTxn(iterRef);
 
-    // Create an array for samples. The sample array will have time stamp and data pair.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "s");
-    RETURN_IF_CBOR_ERROR(err);
+    if (FormatString(storePath,
+                     sizeof(storePath),
+                     "%s/%s.%i.%i.%i",
+                     storeDir,
+                     instanceRef->assetDataPtr->appName,
+                     instanceRef->assetDataPtr->assetId,
+                     instanceRef->instanceId,
+                     fieldId) != LE_OK)
+    {
+        return LE_FAULT;
+    }
 
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &fieldDataPtr->timeSeriesPtr->sampleRef,
-                                    CborIndefiniteLength);
-    RETURN_IF_CBOR_ERROR(err);
+    storeRef = timeSeriesStore_Open(storePath, storeType, storeSize, maxAge);
+    if (storeRef == NULL)
+    {
+        return LE_FAULT;
+    }
 
+    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
+    fieldDataPtr->timeSeriesPtr->storeRef = storeRef;
     fieldDataPtr->timeSeriesPtr->factor = factor;
     fieldDataPtr->timeSeriesPtr->timeStampFactor = timeStampFactor;
 
-    return result;
+    return LE_OK;
 
 #else
     LE_ERROR("Time series not supported.");
@@ -1423,6 +1501,24 @@ static le_result_t StartTimeSeries
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the time series resources of a field.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseTimeSeries
+(
+    FieldData_t* fieldDataPtr,                  ///< [IN] Field
+    bool isRemove                               ///< [IN] Delete the samples not pushed yet?
+)
+{
+    timeSeriesStore_Close(fieldDataPtr->timeSeriesPtr->storeRef, isRemove);
+    le_mem_Release(fieldDataPtr->timeSeriesPtr);
+
+    fieldDataPtr->timeSeriesPtr = NULL;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stop time series on this field and free resources.
@@ -1456,10 +1552,7 @@ static le_result_t StopTimeSeries
         return LE_CLOSED;
     }
 
-    le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-    le_mem_Release(fieldDataPtr->timeSeriesPtr);
-
-    fieldDataPtr->timeSeriesPtr = NULL;
+    ReleaseTimeSeries(fieldDataPtr, true);
 
     return LE_OK;
 
@@ -1470,146 +1563,321 @@ static le_result_t StopTimeSeries
 }
 
 
+#if FEATURE_TIMESERIES
 //--------------------------------------------------------------------------------------------------
 /**
- * Compress the accumulated CBOR encoded time series data and send it to server.
+ * CBOR encode the samples of a field, from a cursor in its time series store, until the buffer is
+ * full or all the samples are encoded.  The first sample is encoded as an absolute value, so every
+ * buffer can be decoded on its own.
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
- *      - LE_CLOSED if time series not enabled on this field
- *      - LE_UNAVAILABLE if observe is not enabled on this field
- *      - LE_FAULT if any other error
+ *      - LE_FAULT on any error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t PushTimeSeries
+static le_result_t EncodeTimeSeriesChunk
 (
-    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to be time series'd
-    bool isRestartTimeSeries                    ///< [IN] Restart time series after push?
+    FieldData_t* fieldDataPtr,                  ///< [IN] Field
+    const char* headerIdPtr,                    ///< [IN] Path of the field
+    timeSeriesStore_Cursor_t* cursorPtr,        ///< [IN/OUT] Next sample to encode
+    uint8_t* bufferPtr,                         ///< [OUT] Buffer of MAX_CBOR_BUFFER_NUMBYTES
+    size_t* sizePtr                             ///< [OUT] Number of bytes encoded
 )
 {
+    TimeSeriesData_t* timeSeriesPtr = fieldDataPtr->timeSeriesPtr;
+    timeSeriesStore_Cursor_t nextCursor;
+    timeSeriesStore_Sample_t sample;
+    CborError err;
+    CborEncoder streamRef;
+    CborEncoder mapRef;
+    CborEncoder headerArray;
+    CborEncoder factorArray;
+    CborEncoder sampleRef;
+    size_t sampleMaxBytes;
+    uint64_t prevTimeStamp = 0;
+    int64_t prevIntValue = 0;
+    double prevFloatValue = 0;
+    bool isFirst = true;
 
-#if FEATURE_TIMESERIES
+    // Largest CBOR encoding of a time stamp and a value.
+    sampleMaxBytes = (fieldDataPtr->type == DATA_TYPE_STRING) ?
+                     (9 + 3 + TIME_SERIES_STORE_STRING_BYTES) : (9 + 9);
 
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
-    uint32_t cborStreamSize;
-    unsigned char compressedBuf[MAX_CBOR_BUFFER_NUMBYTES];
-    unsigned long int compressBufLength;
-    z_stream defstream;
-    pa_avc_LWM2MOperationDataRef_t opRef;
-    CborError err;
+    // Initialize CBOR stream.
+    cbor_encoder_init(&streamRef, bufferPtr, MAX_CBOR_BUFFER_NUMBYTES, 0);
 
-    double dataFactor;
-    double timeStampFactor;
+    err = cbor_encoder_create_map(&streamRef, &mapRef, NUM_TIME_SERIES_MAPS);
+    RETURN_IF_CBOR_ERROR(err);
 
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
-    {
-        return result;
-    }
+    // Create a map and add the header in to the map.
+    // e.g. "h" : [/1000/0]  --> map for header.
+    err = cbor_encode_text_stringz(&mapRef, "h");
+    RETURN_IF_CBOR_ERROR(err);
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
-    {
-        // Time series not enabled on this field.
-        LE_ERROR("Time series not enabled on this field.");
-        return LE_CLOSED;
-    }
+    err = cbor_encoder_create_array(&mapRef, &headerArray, 1);
+    RETURN_IF_CBOR_ERROR(err);
 
-    // Check if observe is enabled on this field.
-    if (!fieldDataPtr->isObserve)
-    {
-        LE_ERROR("Observe not enabled on this field.");
-        return LE_UNAVAILABLE;
-    }
+    err = cbor_encode_text_string(&headerArray, headerIdPtr, strlen(headerIdPtr));
+    RETURN_IF_CBOR_ERROR(err);
 
-    // Remember the factors used.
-    dataFactor = fieldDataPtr->timeSeriesPtr->factor;
-    timeStampFactor = fieldDataPtr->timeSeriesPtr->timeStampFactor;
+    cbor_encoder_close_container(&mapRef, &headerArray);
+
+    // Create a map for factor: time stamp factor, data factor.
+    // e.g. "f" : [1]  --> map for factor.
+    err = cbor_encode_text_stringz(&mapRef, "f");
+    RETURN_IF_CBOR_ERROR(err);
 
-    // Close the map i.e done with entering in to sample array.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                               &fieldDataPtr->timeSeriesPtr->sampleRef);
+    err = cbor_encoder_create_array(&mapRef, &factorArray, 2);
+    RETURN_IF_CBOR_ERROR(err);
 
+    err = cbor_encode_double(&factorArray, timeSeriesPtr->timeStampFactor);
     RETURN_IF_CBOR_ERROR(err);
 
-    // Close the stream.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                               &fieldDataPtr->timeSeriesPtr->mapRef);
+    err = cbor_encode_double(&factorArray, timeSeriesPtr->factor);
     RETURN_IF_CBOR_ERROR(err);
 
-    // Dump CBOR encoded data.
-    cborStreamSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                                  fieldDataPtr->timeSeriesPtr->bufferPtr);
+    cbor_encoder_close_container(&mapRef, &factorArray);
+
+    // Create an array for samples. The sample array will have time stamp and data pair.
+    err = cbor_encode_text_stringz(&mapRef, "s");
+    RETURN_IF_CBOR_ERROR(err);
 
-    //LE_DEBUG("cborStreamSize = %d", cborStreamSize);
-    //LE_DUMP(fieldDataPtr->timeSeriesPtr->bufferPtr, cborStreamSize);
+    err = cbor_encoder_create_array(&mapRef, &sampleRef, CborIndefiniteLength);
+    RETURN_IF_CBOR_ERROR(err);
 
-    // Compress the cbor encoded data
-    // ToDo: In place compression
-    defstream.zalloc = Z_NULL;
-    defstream.zfree = Z_NULL;
-    defstream.opaque = Z_NULL;
+    // Reserve CBOR_RESERVED_BYTES bytes for closing the containers.
+    while (cbor_encoder_get_buffer_size(&sampleRef, bufferPtr) + sampleMaxBytes <=
+           MAX_CBOR_BUFFER_NUMBYTES - CBOR_RESERVED_BYTES)
+    {
+        nextCursor = *cursorPtr;
+        if (timeSeriesStore_ReadNext(timeSeriesPtr->storeRef, &nextCursor, &sample) != LE_OK)
+        {
+            // No more samples (the cursor is at the end, even if the store was corrupted).
+            *cursorPtr = nextCursor;
+            break;
+        }
 
-    defstream.avail_in = cborStreamSize;
-    defstream.next_in = (Bytef *)fieldDataPtr->timeSeriesPtr->bufferPtr;
-    defstream.avail_out = (uInt)sizeof(compressedBuf);
-    defstream.next_out = (Bytef *)compressedBuf;
+        // For the first entry write the absolute value, for all other entries the delta.
+        err = cbor_encode_int(&sampleRef,
+                              (uint64_t)((sample.timeStamp - (isFirst ? 0 : prevTimeStamp)) *
+                                         timeSeriesPtr->timeStampFactor));
+        RETURN_IF_CBOR_ERROR(err);
 
-    deflateInit(&defstream, Z_BEST_COMPRESSION);
-    deflate(&defstream, Z_FINISH);
-    deflateEnd(&defstream);
+        prevTimeStamp = sample.timeStamp;
 
-    compressBufLength = defstream.total_out;
+        switch ( fieldDataPtr->type )
+        {
+            case DATA_TYPE_INT:
+                err = cbor_encode_int(&sampleRef,
+                                      (int)((sample.intValue - (isFirst ? 0 : prevIntValue)) *
+                                            timeSeriesPtr->factor));
+                prevIntValue = sample.intValue;
+                break;
 
-    //LE_DEBUG("Compressed size is: %lu\n", compressBufLength);
-    //LE_DUMP(compressedBuf, compressBufLength);
+            case DATA_TYPE_BOOL:
+                err = cbor_encode_boolean(&sampleRef, sample.boolValue);
+                break;
 
-    // Send the delta encoded + CBOR encoded + Zipped data to the server.
-    opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                instanceRef->assetDataPtr->assetId,
-                                -1,
-                                -1,
-                                PA_AVC_OPTYPE_NOTIFY,
-                                SIERRA_CBOR_ENCODING,
-                                fieldDataPtr->token,
-                                fieldDataPtr->tokenLength);
+            case DATA_TYPE_STRING:
+                err = cbor_encode_text_string(&sampleRef, sample.strValue, strlen(sample.strValue));
+                break;
 
-    pa_avc_NotifyChange(opRef, compressedBuf, compressBufLength);
+            case DATA_TYPE_FLOAT:
+            {
+                // ToDO: float doesn't benefit from use of factor - investigate.
+                double floatDelta = (sample.floatValue - (isFirst ? 0 : prevFloatValue)) *
+                                    timeSeriesPtr->factor;
+
+                if ((uint64_t)timeSeriesPtr->factor == 1)
+                {
+                    err = cbor_encode_double(&sampleRef, floatDelta);
+                }
+                else
+                {
+                    err = cbor_encode_int(&sampleRef, (int64_t)floatDelta);
+                }
+                prevFloatValue = sample.floatValue;
+                break;
+            }
 
-    // Stop time series.
-    result = StopTimeSeries(instanceRef, fieldId);
+            default:
+                LE_ERROR("Failed to add an entry in CBOR stream.");
+                return LE_FAULT;
+        }
+        RETURN_IF_CBOR_ERROR(err);
 
-    // Restart time series if asked.
-    if (result == LE_OK && isRestartTimeSeries)
-    {
-        result = StartTimeSeries(instanceRef, fieldId, dataFactor, timeStampFactor);
+        *cursorPtr = nextCursor;
+        isFirst = false;
     }
 
-    return result;
+    // Close the sample array and the stream.
+    err = cbor_encoder_close_container_checked(&mapRef, &sampleRef);
+    RETURN_IF_CBOR_ERROR(err);
 
-#else
-    LE_ERROR("Time series not supported.");
-    return LE_FAULT;
-#endif
-}
+    err = cbor_encoder_close_container_checked(&streamRef, &mapRef);
+    RETURN_IF_CBOR_ERROR(err);
 
+    *sizePtr = cbor_encoder_get_buffer_size(&streamRef, bufferPtr);
+
+    return LE_OK;
+}
+#endif
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Is time series enabled on this resource, if yes how many data points are recorded so far?
+ * Send the accumulated time series data to server.
  *
- * @return
+ * The samples are read from the store, CBOR encoded and compressed one buffer at a time, and each
+ * buffer is sent in its own notification.  The samples of a buffer are dropped from the store once
+ * it is sent, so a push interrupted by an error only sends again what wasn't sent.
+ *
+ * @return:
  *      - LE_OK on success
  *      - LE_NOT_FOUND if field not found
+ *      - LE_CLOSED if time series not enabled on this field
+ *      - LE_UNAVAILABLE if observe is not enabled on this field
+ *      - LE_FAULT if any other error
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t GetTimeSeriesStatus
+static le_result_t PushTimeSeries
 (
     assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field id
+    int fieldId,                                ///< [IN] Field to be time series'd
+    bool isRestartTimeSeries                    ///< [IN] Restart time series after push?
+)
+{
+
+#if FEATURE_TIMESERIES
+
+    le_result_t result;
+    FieldData_t* fieldDataPtr;
+    timeSeriesStore_Cursor_t cursor;
+    char headerId[64];
+    uint8_t* cborBufferPtr;
+    size_t cborStreamSize;
+    // deflate() adds at most a few bytes per 16 KB block, plus a header and a trailer.
+    unsigned char compressedBuf[MAX_CBOR_BUFFER_NUMBYTES + 64];
+    z_stream defstream;
+    pa_avc_LWM2MOperationDataRef_t opRef;
+    int chunkCount = 0;
+
+    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    if (fieldDataPtr->timeSeriesPtr == NULL)
+    {
+        // Time series not enabled on this field.
+        LE_ERROR("Time series not enabled on this field.");
+        return LE_CLOSED;
+    }
+
+    // Check if observe is enabled on this field.
+    if (!fieldDataPtr->isObserve)
+    {
+        LE_ERROR("Observe not enabled on this field.");
+        return LE_UNAVAILABLE;
+    }
+
+    FormatString(headerId,
+                 sizeof(headerId),
+                 "/%i/%i",
+                 instanceRef->instanceId,
+                 fieldId);
+
+    cborBufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
+
+    timeSeriesStore_StartRead(fieldDataPtr->timeSeriesPtr->storeRef, &cursor);
+
+    do
+    {
+        result = EncodeTimeSeriesChunk(fieldDataPtr, headerId, &cursor, cborBufferPtr,
+                                       &cborStreamSize);
+        if (result != LE_OK)
+        {
+            break;
+        }
+
+        // Compress the cbor encoded data
+        memset(&defstream, 0, sizeof(defstream));
+        defstream.zalloc = Z_NULL;
+        defstream.zfree = Z_NULL;
+        defstream.opaque = Z_NULL;
+
+        defstream.avail_in = cborStreamSize;
+        defstream.next_in = (Bytef *)cborBufferPtr;
+        defstream.avail_out = (uInt)sizeof(compressedBuf);
+        defstream.next_out = (Bytef *)compressedBuf;
+
+        if (deflateInit(&defstream, Z_BEST_COMPRESSION) != Z_OK)
+        {
+            LE_ERROR("Failed to initialize compression.");
+            result = LE_FAULT;
+            break;
+        }
+        if (deflate(&defstream, Z_FINISH) != Z_STREAM_END)
+        {
+            LE_ERROR("Failed to compress time series data.");
+            deflateEnd(&defstream);
+            result = LE_FAULT;
+            break;
+        }
+        deflateEnd(&defstream);
+
+        // Send the delta encoded + CBOR encoded + Zipped data to the server.
+        opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
+                                    instanceRef->assetDataPtr->assetId,
+                                    -1,
+                                    -1,
+                                    PA_AVC_OPTYPE_NOTIFY,
+                                    SIERRA_CBOR_ENCODING,
+                                    fieldDataPtr->token,
+                                    fieldDataPtr->tokenLength);
+
+        pa_avc_NotifyChange(opRef, compressedBuf, defstream.total_out);
+
+        // What was sent doesn't have to be kept any more.
+        timeSeriesStore_Consume(fieldDataPtr->timeSeriesPtr->storeRef, &cursor);
+        chunkCount++;
+    }
+    while (cursor.remaining > 0);
+
+    le_mem_Release(cborBufferPtr);
+
+    LE_DEBUG("Time series of field %d pushed in %d notifications.", fieldId, chunkCount);
+
+    // Stop time series, unless asked to restart it: the store is empty, keep the same factors.
+    if (result == LE_OK && !isRestartTimeSeries)
+    {
+        result = StopTimeSeries(instanceRef, fieldId);
+    }
+
+    return result;
+
+#else
+    LE_ERROR("Time series not supported.");
+    return LE_FAULT;
+#endif
+}
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Is time series enabled on this resource, if yes how many data points are recorded so far?
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t GetTimeSeriesStatus
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field id
     bool* isTimeSeriesPtr,                      ///< [OUT] Is time series enabled on this field
     int* numDataPointsPtr                       ///< [OUT] Number of data points recorded so far
 )
@@ -1636,7 +1904,7 @@ le_result_t GetTimeSeriesStatus
     else
     {
         *isTimeSeriesPtr = true;
-        *numDataPointsPtr = fieldDataPtr->timeSeriesPtr->numElements;
+        *numDataPointsPtr = timeSeriesStore_GetCount(fieldDataPtr->timeSeriesPtr->storeRef);
     }
 
     return LE_OK;
@@ -1650,13 +1918,12 @@ le_result_t GetTimeSeriesStatus
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the sampled data in to the CBOR sample array.
+ * Add the sampled data in to the time series store.  When the store is full, the oldest samples
+ * are dropped.
  *
  * @return:
  *      - LE_OK on success
  *      - LE_FAULT on any other error
- *      - LE_OVERFLOW if the current entry was not added as the time series buffer is full.
- *      - LE_NO_MEMORY if the current entry was added but there is no space for next one.
  */
 //--------------------------------------------------------------------------------------------------
 static le_result_t TimeSeriesAddEntry
@@ -1668,27 +1935,9 @@ static le_result_t TimeSeriesAddEntry
 
 #if FEATURE_TIMESERIES
 
-    CborError err;
-    uint64_t timeStamp;
-    int intDelta;
-    double floatDelta;
-    size_t currentSize;
+    timeSeriesStore_Ref_t storeRef = fieldDataPtr->timeSeriesPtr->storeRef;
     struct timeval tv;
 
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
-    {
-        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %"PRIdS".", currentSize);
-
-        return LE_OVERFLOW;
-    }
-
     // Get current system time if utc milli seconds is not provided.
     // The time stamp is expected in UTC milli seconds by the server.
     if (utcMilliSec == 0)
@@ -1697,105 +1946,31 @@ static le_result_t TimeSeriesAddEntry
         utcMilliSec = (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
     }
 
-    // For the first entry write the absolute value, for all other entries calculate delta.
-    if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-    {
-        timeStamp = utcMilliSec * fieldDataPtr->timeSeriesPtr->timeStampFactor;
-    }
-    else
-    {
-        timeStamp = (utcMilliSec - fieldDataPtr->timeSeriesPtr->prevTimeStamp) *
-                    fieldDataPtr->timeSeriesPtr->timeStampFactor;
-    }
-
-    // Add time stamp to sample array.
-    err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, timeStamp);
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->prevTimeStamp = utcMilliSec;
-
-    // Add the data to sample array.
     switch ( fieldDataPtr->type )
     {
         case DATA_TYPE_INT:
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-            {
-                intDelta = fieldDataPtr->intValue * fieldDataPtr->timeSeriesPtr->factor;
-            }
-            else
-            {
-                intDelta = (fieldDataPtr->intValue - fieldDataPtr->timeSeriesPtr->prevIntValue) *
-                            fieldDataPtr->timeSeriesPtr->factor;
-            }
-
-            //LE_DEBUG("intDelta = %d", intDelta);
-
-            err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, intDelta);
-
-            fieldDataPtr->timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
-            break;
+            return timeSeriesStore_AddInt(storeRef, utcMilliSec, fieldDataPtr->intValue);
 
         case DATA_TYPE_BOOL:
-            err = cbor_encode_boolean(&fieldDataPtr->timeSeriesPtr->sampleRef, fieldDataPtr->boolValue);
-            break;
+            return timeSeriesStore_AddBool(storeRef, utcMilliSec, fieldDataPtr->boolValue);
 
         case DATA_TYPE_STRING:
-            err = cbor_encode_text_string(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                          fieldDataPtr->strValuePtr,
-                                          strlen(fieldDataPtr->strValuePtr));
-            break;
-
-        case DATA_TYPE_FLOAT:
-            // ToDO: float doesn't benefit from use of factor - investigate.
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-            {
-                floatDelta = fieldDataPtr->floatValue * fieldDataPtr->timeSeriesPtr->factor;
-            }
-            else
+            if (timeSeriesStore_AddString(storeRef, utcMilliSec, fieldDataPtr->strValuePtr) != LE_OK)
             {
-                floatDelta = (fieldDataPtr->floatValue - fieldDataPtr->timeSeriesPtr->prevFloatValue);
-                floatDelta = floatDelta * fieldDataPtr->timeSeriesPtr->factor;
-            }
-
-            if ((uint64_t)fieldDataPtr->timeSeriesPtr->factor == 1)
-            {
-                err = cbor_encode_double(&fieldDataPtr->timeSeriesPtr->sampleRef, floatDelta);
-            }
-            else
-            {
-                LE_DEBUG("Float data encoded as integer.");
-                err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, (int64_t)floatDelta);
+                LE_ERROR("Failed to add an entry in time series of field %d.",
+                         fieldDataPtr->fieldId);
+                return LE_FAULT;
             }
+            return LE_OK;
 
-            fieldDataPtr->timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
-            break;
-
-        case DATA_TYPE_NONE:
-            LE_ERROR("Failed to add an entry in CBOR stream.");
-            break;
-    }
-
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->numElements++;
-
-
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
-    {
-        LE_WARN("Time series buffer full; flush and restart time series on field %d.",
-                 fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %"PRIdS".", currentSize);
+        case DATA_TYPE_FLOAT:
+            return timeSeriesStore_AddFloat(storeRef, utcMilliSec, fieldDataPtr->floatValue);
 
-        return LE_NO_MEMORY;
+        default:
+            LE_ERROR("Failed to add an entry in time series of field %d.", fieldDataPtr->fieldId);
+            return LE_FAULT;
     }
 
-    return LE_OK;
-
 #else
     LE_ERROR("Time series not supported.");
     return LE_FAULT;
@@ -2137,252 +2312,427 @@ static le_result_t GetFloat
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the integer value for the specified field
+ * Write the value of a field, given as a string, for a read call back operation.
  *
  * @return:
  *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
- *      - LE_OVERFLOW if the current entry was NOT added as the time series buffer is full.
- *                    (This error is applicable only if time series is enabled on this field)
- *      - LE_NO_MEMORY if the current entry was added but there is no space for next one.
- *                    (This error is applicable only if time series is enabled on this field)
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t SetInt
+static le_result_t SendReadCallBackResponse
 (
-    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to write
-    int value,                                  ///< [IN] The value to write
-    bool isClient,                              ///< [IN] Is it client or server access
-    uint64_t utcMilliSec                        ///< [IN] Timestamp in utc milli seconds
+    FieldData_t* fieldDataPtr                   ///< [IN] Field which was written
 )
 {
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
-    size_t bytesWritten;
-    int prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
+    char valueStr[STRING_VALUE_NUMBYTES];
+    le_result_t result = LE_FAULT;
 
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    // Format the response string.
+    switch ( fieldDataPtr->type )
+    {
+        case DATA_TYPE_INT:
+            result = FormatString(valueStr, sizeof(valueStr), "%i", fieldDataPtr->intValue);
+            break;
+
+        case DATA_TYPE_BOOL:
+            result = FormatString(valueStr, sizeof(valueStr), "%i", fieldDataPtr->boolValue);
+            break;
+
+        case DATA_TYPE_STRING:
+            result = le_utf8_Copy(valueStr, fieldDataPtr->strValuePtr, sizeof(valueStr), NULL);
+            break;
+
+        case DATA_TYPE_FLOAT:
+            result = FormatString(valueStr, sizeof(valueStr), "%lf", fieldDataPtr->floatValue);
+            break;
+
+        case DATA_TYPE_NONE:
+            break;
+    }
 
     if ( result != LE_OK )
     {
-        return result;
+        LE_ERROR("Failed to send read response.");
+        return LE_FAULT;
     }
 
-    if ( fieldDataPtr->type != DATA_TYPE_INT )
+    pa_avc_ReadCallBackReport(fieldDataPtr->readCallBackOpRef,
+                              (uint8_t*)valueStr,
+                              strlen(valueStr));
+    fieldDataPtr->readCallBackOpRef = NULL;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the value of a field, without notifying the server of the change.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the stored string was truncated
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetFieldValue
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    FieldData_t* fieldDataPtr,                  ///< [IN] Field to write
+    const assetData_FieldValue_t* valuePtr,     ///< [IN] The value to write
+    bool isClient,                              ///< [IN] Is it client or server access
+    bool* isNotifyPtr                           ///< [OUT] Must the server be notified of the change?
+)
+{
+    static const DataTypes_t dataTypes[] =
     {
-        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
+        [ASSET_DATA_TYPE_INT] = DATA_TYPE_INT,
+        [ASSET_DATA_TYPE_BOOL] = DATA_TYPE_BOOL,
+        [ASSET_DATA_TYPE_STRING] = DATA_TYPE_STRING,
+        [ASSET_DATA_TYPE_FLOAT] = DATA_TYPE_FLOAT
+    };
+    le_result_t result = LE_OK;
+    bool isChanged = false;
+
+    *isNotifyPtr = false;
+
+    if ( fieldDataPtr->type != dataTypes[valuePtr->type] )
+    {
+        LE_ERROR("Field type mismatch: expected '%s', got '%s'",
+                 GetDataTypeStr(dataTypes[valuePtr->type]), GetDataTypeStr(fieldDataPtr->type));
         return LE_FAULT;
     }
 
-    // Remember current value and set new value.
-    prevValue = fieldDataPtr->intValue;
-    fieldDataPtr->intValue = value;
+    // Set the new value, and remember whether it changed.
+    switch ( fieldDataPtr->type )
+    {
+        case DATA_TYPE_INT:
+            isChanged = ( fieldDataPtr->intValue != valuePtr->intValue );
+            fieldDataPtr->intValue = valuePtr->intValue;
+            break;
+
+        case DATA_TYPE_BOOL:
+            isChanged = ( fieldDataPtr->boolValue != valuePtr->boolValue );
+            fieldDataPtr->boolValue = valuePtr->boolValue;
+            break;
+
+        case DATA_TYPE_STRING:
+            isChanged = ( strcmp(fieldDataPtr->strValuePtr, valuePtr->strValuePtr) != 0 );
+            result = le_utf8_Copy(fieldDataPtr->strValuePtr,
+                                  valuePtr->strValuePtr,
+                                  STRING_VALUE_NUMBYTES,
+                                  NULL);
+            break;
+
+        case DATA_TYPE_FLOAT:
+            isChanged = ( fieldDataPtr->floatValue != valuePtr->floatValue );
+            fieldDataPtr->floatValue = valuePtr->floatValue;
+            break;
+
+        case DATA_TYPE_NONE:
+            return LE_FAULT;
+    }
+
+    if ( isChanged )
+    {
+        instanceRef->isTlvCacheValid = false;
+    }
 
     // Call any registered handlers to be notified of write.
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
+    CallFieldActionHandlers( instanceRef, fieldDataPtr->fieldId, ASSET_DATA_ACTION_WRITE, isClient );
 
     // Send a read response for read call back operation.
     if (fieldDataPtr->readCallBackOpRef != NULL && isClient == true)
     {
-        // Format the response string.
-        result = FormatString((char*)valueData, sizeof(valueData), "%i", fieldDataPtr->intValue);
-        bytesWritten = strlen((char*)valueData);
-
-        if ( result != LE_OK )
+        if ( SendReadCallBackResponse(fieldDataPtr) != LE_OK )
         {
-            LE_ERROR("Failed to send read response.");
             return LE_FAULT;
         }
-
-        pa_avc_ReadCallBackReport(fieldDataPtr->readCallBackOpRef, valueData, bytesWritten);
-        fieldDataPtr->readCallBackOpRef = NULL;
     }
 
     // If time series is enabled add the data to time series history and get out. If time series is
-    // not enabled send the observe notification right away.
+    // not enabled the observe notification has to be sent.
     if (fieldDataPtr->timeSeriesPtr != NULL)
     {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
+        le_result_t addResult = TimeSeriesAddEntry(fieldDataPtr, valuePtr->timeStamp);
+
+        return (addResult == LE_OK) ? result : addResult;
     }
 
     // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
-    if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
-    {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
+    *isNotifyPtr = ( fieldDataPtr->isObserve && isChanged && isClient == true );
 
-        if ( result == LE_OK)
-        {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
-            {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
-            }
+    return result;
+}
 
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
 
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
-        }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the change of an observed field, to be notified by FlushNotifications().  A field changed
+ * several times before the notification is notified once, with its last value.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueFieldChange
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr                   ///< [IN] Field which changed
+)
+{
+    if ( fieldDataPtr->isNotifyPending )
+    {
+        return;
     }
 
-    return LE_OK;
+    if ( le_dls_IsEmpty(&instanceRef->notifyList) )
+    {
+        le_dls_Queue(&NotifyInstanceList, &instanceRef->notifyLink);
+    }
+
+    le_dls_Queue(&instanceRef->notifyList, &fieldDataPtr->notifyLink);
+    fieldDataPtr->isNotifyPending = true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the float value for the specified field
+ * Remove a field from the changes waiting to be notified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DequeueFieldChange
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance containing the field
+    FieldData_t* fieldDataPtr                   ///< [IN] Field to remove
+)
+{
+    le_dls_Remove(&instanceRef->notifyList, &fieldDataPtr->notifyLink);
+    fieldDataPtr->isNotifyPending = false;
+
+    if ( le_dls_IsEmpty(&instanceRef->notifyList) )
+    {
+        le_dls_Remove(&NotifyInstanceList, &instanceRef->notifyLink);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the changed fields of an instance which are observed with the given token.
  *
  * @return:
- *      - LE_OK on success
- *      - LE_NOT_FOUND if field not found
- *      - LE_OVERFLOW if the current entry was NOT added as the time series buffer is full.
- *                    (This error is applicable only if time series is enabled on this field)
- *      - LE_NO_MEMORY if the current entry was added but there is no space for next one.
- *                    (This error is applicable only if time series is enabled on this field)
- *      - LE_FAULT on any other error
+ *      - Number of fields written to the list, at most NOTIFY_FIELD_LIST_NUM.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t SetFloat
+static size_t GetNotifyFields
 (
     assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to write
-    double value,                               ///< [IN] The value to write
-    bool isClient,                              ///< [IN] Is it client or server access
-    uint64_t utcMilliSec                        ///< [IN] Timestamp in utc milli seconds
+    const uint8_t* tokenPtr,                    ///< [IN] Token of the observe request
+    uint8_t tokenLength,                        ///< [IN] Token length
+    FieldData_t** fieldListPtr                  ///< [OUT] Fields, NOTIFY_FIELD_LIST_NUM entries
 )
 {
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
-    size_t bytesWritten;
-    float prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
+    le_dls_Link_t* linkPtr = le_dls_Peek(&instanceRef->notifyList);
+    size_t numFields = 0;
 
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
+    while ( ( linkPtr != NULL ) && ( numFields < NOTIFY_FIELD_LIST_NUM ) )
     {
-        return result;
-    }
+        FieldData_t* fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, notifyLink);
 
-    if ( fieldDataPtr->type != DATA_TYPE_FLOAT )
-    {
-        LE_ERROR("Field type mismatch: expected 'float', got '%s'", GetDataTypeStr(fieldDataPtr->type));
-        return LE_FAULT;
+        if ( fieldDataPtr->isObserve &&
+             ( fieldDataPtr->tokenLength == tokenLength ) &&
+             ( memcmp(fieldDataPtr->token, tokenPtr, tokenLength) == 0 ) )
+        {
+            fieldListPtr[numFields++] = fieldDataPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->notifyList, linkPtr);
     }
 
-    // Remember current value and set new value.
-    prevValue = fieldDataPtr->floatValue;
-    fieldDataPtr->floatValue = value;
+    return numFields;
+}
 
-    // Call any registered handlers to be notified of write.
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
 
-    // Send a read response for read call back operation.
-    if (fieldDataPtr->readCallBackOpRef !=NULL && isClient == true)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the server of the queued field changes.
+ *
+ * The server sends notify on entire object, so we need to send the TLV of entire object but
+ * include only the resources that changed.  The changed fields of all the instances of an asset
+ * which are observed with the same token are sent in a single notification, as long as it is not
+ * too large.  Changes of fields which are no longer observed are dropped.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if a change could not be notified
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushNotifications
+(
+    void
+)
+{
+    uint8_t valueData[MAX_NOTIFY_NUMBYTES];
+    FieldData_t* fieldList[NOTIFY_FIELD_LIST_NUM];
+    le_result_t result = LE_OK;
+    le_dls_Link_t* linkPtr;
+
+    while ( ( linkPtr = le_dls_Peek(&NotifyInstanceList) ) != NULL )
     {
-        // Format the response string.
-        result = FormatString((char*)valueData, sizeof(valueData), "%lf", fieldDataPtr->floatValue);
-        bytesWritten = strlen((char*)valueData);
+        InstanceData_t* firstInstPtr = CONTAINER_OF(linkPtr, InstanceData_t, notifyLink);
+        AssetData_t* assetDataPtr = firstInstPtr->assetDataPtr;
+        FieldData_t* firstFieldPtr = CONTAINER_OF(le_dls_Peek(&firstInstPtr->notifyList),
+                                                  FieldData_t,
+                                                  notifyLink);
+        uint8_t token[sizeof(firstFieldPtr->token)];
+        uint8_t tokenLength;
+        size_t bytesWritten = 0;
+        pa_avc_LWM2MOperationDataRef_t opRef;
 
-        if ( result != LE_OK )
+        if ( !firstFieldPtr->isObserve )
         {
-            LE_ERROR("Failed to send read response.");
-            return LE_FAULT;
+            DequeueFieldChange(firstInstPtr, firstFieldPtr);
+            continue;
         }
 
-        pa_avc_ReadCallBackReport(fieldDataPtr->readCallBackOpRef, valueData, bytesWritten);
-        fieldDataPtr->readCallBackOpRef = NULL;
-    }
+        // The first change queued decides the token of this notification.
+        tokenLength = firstFieldPtr->tokenLength;
+        memcpy(token, firstFieldPtr->token, tokenLength);
 
-    // If time series is enabled add the data to time series history and get out. If time series is
-    // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
-    {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
-    }
+        // Write one instance TLV per instance of the asset which has changes observed with this
+        // token, until the notification is full.
+        while ( linkPtr != NULL )
+        {
+            InstanceData_t* instPtr = CONTAINER_OF(linkPtr, InstanceData_t, notifyLink);
+            size_t numFields;
+            size_t numFieldsWritten;
+            size_t numBytesWritten;
+            size_t i;
+            le_result_t writeResult;
+
+            // Get the next instance first, since this one leaves the list once all its changes
+            // are written.
+            linkPtr = le_dls_PeekNext(&NotifyInstanceList, linkPtr);
+
+            if ( instPtr->assetDataPtr != assetDataPtr )
+            {
+                continue;
+            }
 
-    // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
-    if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
-    {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
+            numFields = GetNotifyFields(instPtr, token, tokenLength, fieldList);
+            if ( numFields == 0 )
+            {
+                continue;
+            }
 
-        if ( result == LE_OK)
-        {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
+            numFieldsWritten = numFields;
+            writeResult = WriteNotifyObjectToTLV(instPtr,
+                                                 fieldList,
+                                                 &numFieldsWritten,
+                                                 valueData + bytesWritten,
+                                                 sizeof(valueData) - bytesWritten,
+                                                 &numBytesWritten);
+
+            if ( ( writeResult == LE_OVERFLOW ) && ( bytesWritten > 0 ) )
             {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
+                // The remaining changes are sent in the next notification.
+                break;
+            }
+
+            if ( writeResult != LE_OK )
+            {
+                // Drop the field, so that the other changes can still be notified.
+                LE_ERROR("Failed to notify the change of %s/%i/%i/%i.",
+                         assetDataPtr->appName,
+                         assetDataPtr->assetId,
+                         instPtr->instanceId,
+                         fieldList[0]->fieldId);
+                DequeueFieldChange(instPtr, fieldList[0]);
+                result = LE_FAULT;
+                break;
+            }
+
+            for ( i = 0; i < numFieldsWritten; i++ )
+            {
+                DequeueFieldChange(instPtr, fieldList[i]);
+            }
+            bytesWritten += numBytesWritten;
+
+            if ( numFieldsWritten < numFields )
+            {
+                break;
             }
+        }
 
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
+        if ( bytesWritten > 0 )
+        {
+            opRef = pa_avc_CreateOpData(assetDataPtr->appName,
+                                        assetDataPtr->assetId,
                                         -1,
                                         -1,
                                         PA_AVC_OPTYPE_NOTIFY,
                                         TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
+                                        token,
+                                        tokenLength);
 
             pa_avc_NotifyChange(opRef, valueData, bytesWritten);
         }
     }
 
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the queued field changes right away if NOTIFY_COALESCE_MS is 0, otherwise make sure they
+ * are notified in at most NOTIFY_COALESCE_MS.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if a change could not be notified
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ScheduleNotifications
+(
+    void
+)
+{
+    if ( NOTIFY_COALESCE_MS == 0 )
+    {
+        return FlushNotifications();
+    }
+
+    // Do not restart a running timer, so that frequent changes do not delay the notification.
+    if ( !le_timer_IsRunning(NotifyTimerRef) )
+    {
+        LE_ASSERT(le_timer_Start(NotifyTimerRef) == LE_OK);
+    }
+
     return LE_OK;
 }
 
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the bool value for the specified field
+ * Set the value of the specified field, and notify the server of the change if observe is enabled.
  *
  * @return:
  *      - LE_OK on success
  *      - LE_NOT_FOUND if field not found
+ *      - LE_OVERFLOW if the stored string was truncated
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetBool
+static le_result_t SetField
 (
     assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
-    int fieldId,                                ///< [IN] Field to read
-    bool* valuePtr,                             ///< [OUT] The value read
+    int fieldId,                                ///< [IN] Field to write
+    const assetData_FieldValue_t* valuePtr,     ///< [IN] The value to write
     bool isClient                               ///< [IN] Is it client or server access
 )
 {
     le_result_t result;
     FieldData_t* fieldDataPtr;
+    bool isNotify;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -2390,24 +2740,25 @@ static le_result_t GetBool
         return result;
     }
 
-    if ( fieldDataPtr->type != DATA_TYPE_BOOL )
+    result = SetFieldValue(instanceRef, fieldDataPtr, valuePtr, isClient, &isNotify);
+
+    if ( isNotify )
     {
-        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
-        return LE_FAULT;
-    }
+        QueueFieldChange(instanceRef, fieldDataPtr);
 
-    // Call any registered handlers to be notified of read
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
+        if ( ScheduleNotifications() != LE_OK )
+        {
+            return LE_FAULT;
+        }
+    }
 
-    // Get the value and return it
-    *valuePtr = fieldDataPtr->boolValue;
-    return LE_OK;
+    return result;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the bool value for the specified field
+ * Set the integer value for the specified field
  *
  * @return:
  *      - LE_OK on success
@@ -2419,106 +2770,135 @@ static le_result_t GetBool
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t SetBool
+static le_result_t SetInt
 (
     assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
     int fieldId,                                ///< [IN] Field to write
-    bool value,                                 ///< [IN] The value to write
+    int value,                                  ///< [IN] The value to write
     bool isClient,                              ///< [IN] Is it client or server access
     uint64_t utcMilliSec                        ///< [IN] Timestamp in utc milli seconds
 )
 {
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
-    size_t bytesWritten;
-    bool prevValue;
-    pa_avc_LWM2MOperationDataRef_t opRef;
-
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
+    assetData_FieldValue_t fieldValue =
     {
-        return result;
-    }
-
-    if ( fieldDataPtr->type != DATA_TYPE_BOOL )
-    {
-        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
-        return LE_FAULT;
-    }
+        .type = ASSET_DATA_TYPE_INT,
+        .intValue = value,
+        .timeStamp = utcMilliSec
+    };
 
-    // Remember current value and set new value.
-    prevValue = fieldDataPtr->boolValue;
-    fieldDataPtr->boolValue = value;
+    return SetField(instanceRef, fieldId, &fieldValue, isClient);
+}
 
-    // Call any registered handlers to be notified of write.
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
 
-    // Send a read response for read call back operation.
-    if (fieldDataPtr->readCallBackOpRef != NULL && isClient == true)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the float value for the specified field
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ *      - LE_OVERFLOW if the current entry was NOT added as the time series buffer is full.
+ *                    (This error is applicable only if time series is enabled on this field)
+ *      - LE_NO_MEMORY if the current entry was added but there is no space for next one.
+ *                    (This error is applicable only if time series is enabled on this field)
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetFloat
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to write
+    double value,                               ///< [IN] The value to write
+    bool isClient,                              ///< [IN] Is it client or server access
+    uint64_t utcMilliSec                        ///< [IN] Timestamp in utc milli seconds
+)
+{
+    assetData_FieldValue_t fieldValue =
     {
-        // Format the response string.
-        result = FormatString((char*)valueData, sizeof(valueData), "%i", fieldDataPtr->boolValue);
-        bytesWritten = strlen((char*)valueData);
+        .type = ASSET_DATA_TYPE_FLOAT,
+        .floatValue = value,
+        .timeStamp = utcMilliSec
+    };
 
-        if ( result != LE_OK )
-        {
-            LE_ERROR("Failed to send read response.");
-            return LE_FAULT;
-        }
+    return SetField(instanceRef, fieldId, &fieldValue, isClient);
+}
 
-        pa_avc_ReadCallBackReport(fieldDataPtr->readCallBackOpRef, valueData, bytesWritten);
-        fieldDataPtr->readCallBackOpRef = NULL;
-    }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bool value for the specified field
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetBool
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to read
+    bool* valuePtr,                             ///< [OUT] The value read
+    bool isClient                               ///< [IN] Is it client or server access
+)
+{
+    le_result_t result;
+    FieldData_t* fieldDataPtr;
 
-    // If time series is enabled add the data to time series history and get out. If time series is
-    // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
+    if ( result != LE_OK )
     {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
+        return result;
     }
 
-    // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
-    if (fieldDataPtr->isObserve && prevValue != value && isClient == true)
-    {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
-
-        if ( result == LE_OK)
-        {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
-            {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
-            }
-
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
-        }
+    if ( fieldDataPtr->type != DATA_TYPE_BOOL )
+    {
+        LE_ERROR("Field type mismatch: expected 'int', got '%s'", GetDataTypeStr(fieldDataPtr->type));
+        return LE_FAULT;
     }
 
+    // Call any registered handlers to be notified of read
+    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_READ, isClient );
+
+    // Get the value and return it
+    *valuePtr = fieldDataPtr->boolValue;
     return LE_OK;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bool value for the specified field
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if field not found
+ *      - LE_OVERFLOW if the current entry was NOT added as the time series buffer is full.
+ *                    (This error is applicable only if time series is enabled on this field)
+ *      - LE_NO_MEMORY if the current entry was added but there is no space for next one.
+ *                    (This error is applicable only if time series is enabled on this field)
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetBool
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to write
+    bool value,                                 ///< [IN] The value to write
+    bool isClient,                              ///< [IN] Is it client or server access
+    uint64_t utcMilliSec                        ///< [IN] Timestamp in utc milli seconds
+)
+{
+    assetData_FieldValue_t fieldValue =
+    {
+        .type = ASSET_DATA_TYPE_BOOL,
+        .boolValue = value,
+        .timeStamp = utcMilliSec
+    };
+
+    return SetField(instanceRef, fieldId, &fieldValue, isClient);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the string value for the specified field
@@ -2586,94 +2966,14 @@ static le_result_t SetString
     uint64_t utcMilliSec                        ///< [IN] Timestamp in utc milli seconds
 )
 {
-    le_result_t result;
-    FieldData_t* fieldDataPtr;
-    uint8_t valueData[256+1];  // +1 for null byte, if storing a string
-    size_t bytesWritten;
-    char prevStr[STRING_VALUE_NUMBYTES];
-    pa_avc_LWM2MOperationDataRef_t opRef;
-
-    result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-    if ( result != LE_OK )
-    {
-        return result;
-    }
-
-    if ( fieldDataPtr->type != DATA_TYPE_STRING )
-    {
-        LE_ERROR("Field type mismatch: expected 'string', got '%s'", GetDataTypeStr(fieldDataPtr->type));
-        return LE_FAULT;
-    }
-
-    // Remember current value and set new value.
-    result = le_utf8_Copy(prevStr, fieldDataPtr->strValuePtr, STRING_VALUE_NUMBYTES, NULL);
-    result = le_utf8_Copy(fieldDataPtr->strValuePtr, strPtr, STRING_VALUE_NUMBYTES, NULL);
-
-    // Call any registered handlers to be notified of write.
-    CallFieldActionHandlers( instanceRef, fieldId, ASSET_DATA_ACTION_WRITE, isClient );
-
-    // Send a read response for read call back operation.
-    if (fieldDataPtr->readCallBackOpRef != NULL && isClient == true)
-    {
-        // Format the response string.
-        le_utf8_Copy((char*)valueData, fieldDataPtr->strValuePtr, sizeof(valueData), NULL);
-        bytesWritten = strlen((char*)valueData);
-
-        if ( result != LE_OK )
-        {
-            LE_ERROR("Failed to send read response.");
-            return LE_FAULT;
-        }
-
-        pa_avc_ReadCallBackReport(fieldDataPtr->readCallBackOpRef, valueData, bytesWritten);
-        fieldDataPtr->readCallBackOpRef = NULL;
-    }
-
-    // If time series is enabled add the data to time series history and get out. If time series is
-    // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
-    {
-        return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
-    }
-
-    // Notify the server if observe is enabled and the value is changed.
-    // The server sends notify on entire object, so we need to send the TLV of entire
-    // object but include only the resource that changed.
-    if (fieldDataPtr->isObserve && strcmp(prevStr, strPtr) != 0 && isClient == true)
+    assetData_FieldValue_t fieldValue =
     {
-        assetData_AssetDataRef_t assetRef;
-        result = assetData_GetAssetRefById(instanceRef->assetDataPtr->appName,
-                                           instanceRef->assetDataPtr->assetId,
-                                           &assetRef);
-
-        if ( result == LE_OK)
-        {
-            result = WriteNotifyObjectToTLV(assetRef,
-                                            instanceRef->instanceId,
-                                            fieldId,
-                                            valueData,
-                                            sizeof(valueData),
-                                            &bytesWritten);
-            if ( result != LE_OK )
-            {
-                LE_ERROR("Failed to send lwm2m notification.");
-                return LE_FAULT;
-            }
-
-            opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                        instanceRef->assetDataPtr->assetId,
-                                        -1,
-                                        -1,
-                                        PA_AVC_OPTYPE_NOTIFY,
-                                        TLV_ENCODING,
-                                        fieldDataPtr->token,
-                                        fieldDataPtr->tokenLength);
-
-            pa_avc_NotifyChange(opRef, valueData, bytesWritten);
-        }
-    }
+        .type = ASSET_DATA_TYPE_STRING,
+        .strValuePtr = strPtr,
+        .timeStamp = utcMilliSec
+    };
 
-    return result;
+    return SetField(instanceRef, fieldId, &fieldValue, isClient);
 }
 
 
@@ -3071,6 +3371,12 @@ le_result_t assetData_CreateInstanceById
     // Add back reference from instance data to the asset containing the instance
     assetInstPtr->assetDataPtr = assetDataPtr;
 
+    // The TLV cache is only allocated when the instance is first read.
+    assetInstPtr->tlvCachePtr = NULL;
+    assetInstPtr->tlvCacheNumBytes = 0;
+    assetInstPtr->isTlvCacheValid = false;
+    assetInstPtr->notifyList = LE_DLS_LIST_INIT;
+    assetInstPtr->notifyLink = LE_DLS_LINK_INIT;
 
     le_dls_Queue(&assetDataPtr->instanceList, &assetInstPtr->link);
 
@@ -3175,6 +3481,17 @@ void assetData_DeleteInstance
     FieldData_t* fieldDataPtr;
     le_dls_Link_t* linkPtr;
 
+    // Drop the changes not notified yet; the fields are released below.
+    if ( !le_dls_IsEmpty(&instanceRef->notifyList) )
+    {
+        le_dls_Remove(&NotifyInstanceList, &instanceRef->notifyLink);
+    }
+
+    if ( instanceRef->tlvCachePtr != NULL )
+    {
+        le_mem_Release(instanceRef->tlvCachePtr);
+    }
+
     // Pop the first field from field list
     linkPtr = le_dls_Pop(&instanceRef->fieldList);
 
@@ -3198,9 +3515,10 @@ void assetData_DeleteInstance
         // Release Time Series resources.
         if (fieldDataPtr->timeSeriesPtr != NULL)
         {
+            // Delete the store file too, so that an instance created again with the same id
+            // doesn't inherit the samples of this one.
             LE_DEBUG("Releasing time series resources of %s", fieldDataPtr->name);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr);
+            ReleaseTimeSeries(fieldDataPtr, true);
         }
 
         // Release the field.
@@ -3598,6 +3916,46 @@ le_result_t assetData_GetFieldIdFromName
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the field reference for the given field name
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_GetFieldRefFromName
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    const char* fieldNamePtr,                   ///< [IN] The field name
+    assetData_FieldDataRef_t* fieldRefPtr       ///< [OUT] The field reference
+)
+{
+    FieldData_t* fieldDataPtr;
+    le_dls_Link_t* fieldLinkPtr;
+
+    // Get the start of the field list
+    fieldLinkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    // Loop through the fields
+    while ( fieldLinkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
+
+        if ( strcmp(fieldDataPtr->name, fieldNamePtr) == 0 )
+        {
+            *fieldRefPtr = fieldDataPtr;
+            return LE_OK;
+        }
+
+        fieldLinkPtr = le_dls_PeekNext(&instanceRef->fieldList, fieldLinkPtr);
+    }
+
+    return LE_FAULT;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the integer value for the specified field
@@ -3862,6 +4220,65 @@ le_result_t assetData_client_SetString
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the values of a list of fields of an instance.  The fields which are recording time series
+ * record their value; if observe is enabled on the others, the changes are notified together,
+ * along with the other changes of the asset queued in the meantime.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if a stored string was truncated
+ *      - LE_FAULT if the type of a value does not match its field, or on any other error.  The
+ *        values after the one which failed are not set.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_client_SetFieldList
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    const assetData_FieldValue_t* valueListPtr, ///< [IN] The values to write
+    size_t numValues                            ///< [IN] Number of values in the list
+)
+{
+    bool isAnyNotify = false;
+    le_result_t result = LE_OK;
+    size_t i;
+
+    for ( i = 0; i < numValues; i++ )
+    {
+        FieldData_t* fieldDataPtr = valueListPtr[i].fieldRef;
+        bool isNotify;
+        le_result_t setResult;
+
+        setResult = SetFieldValue(instanceRef, fieldDataPtr, &valueListPtr[i], true, &isNotify);
+
+        if ( setResult == LE_OVERFLOW )
+        {
+            result = LE_OVERFLOW;
+        }
+        else if ( setResult != LE_OK )
+        {
+            result = setResult;
+            break;
+        }
+
+        if ( isNotify )
+        {
+            QueueFieldChange(instanceRef, fieldDataPtr);
+            isAnyNotify = true;
+        }
+    }
+
+    // Notify the fields which changed before any error, too.
+    if ( isAnyNotify && ( ScheduleNotifications() != LE_OK ) )
+    {
+        return LE_FAULT;
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Record the value of a string variable field in time series
@@ -4321,6 +4738,8 @@ le_result_t assetData_server_SetValue
         return result;
     }
 
+    instanceRef->isTlvCacheValid = false;
+
     result = LE_OK;   // result could be changed in the switch statement
     switch ( fieldDataPtr->type )
     {
@@ -4519,6 +4938,21 @@ static void RegUpdateTimerHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function for NotifyTimerRef expiry
+ */
+//--------------------------------------------------------------------------------------------------
+static void NotifyTimerHandler
+(
+    le_timer_Ref_t timerRef    ///< This timer has expired
+)
+{
+    // Errors are logged; the changes which could not be notified are dropped.
+    FlushNotifications();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Init this sub-component
@@ -4539,8 +4973,10 @@ le_result_t assetData_Init
     // Memory pool for time series data.
     TimeSeriesDataPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(TimeSeriesData_t));
     CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", MAX_CBOR_BUFFER_NUMBYTES);
+    timeSeriesStore_Init();
 
     StringValuePoolRef = le_mem_CreatePool("String value pool", STRING_VALUE_NUMBYTES);
+    TlvCachePoolRef = le_mem_CreatePool("Instance TLV cache pool", TLV_CACHE_NUMBYTES);
     AddressStringPoolRef = le_mem_CreatePool("Address pool", 100);
 
     // Create AssetMap that maps (appName, assetId) to an AssetData block.
@@ -4563,6 +4999,14 @@ le_result_t assetData_Init
     le_timer_SetInterval(RegUpdateTimerRef, timerInterval);
     le_timer_SetHandler(RegUpdateTimerRef, RegUpdateTimerHandler);
 
+    // Use a one-shot timer to coalesce the changes of observed fields before notifying them.
+    NotifyTimerRef = le_timer_Create("Notify timer");
+    if ( NOTIFY_COALESCE_MS > 0 )
+    {
+        LE_ASSERT(le_timer_SetMsInterval(NotifyTimerRef, NOTIFY_COALESCE_MS) == LE_OK);
+    }
+    le_timer_SetHandler(NotifyTimerRef, NotifyTimerHandler);
+
     // Pre-load the /lwm2m/9 object into the AssetMap; don't actually need to use the assetRef here.
     assetData_AssetDataRef_t lwm2mAssetRef;
 
@@ -4875,7 +5319,7 @@ static le_result_t WriteFieldTLV
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write a list of readable LWM2M Resource TLVs to the given buffer.
+ * Encode the list of readable LWM2M Resource TLVs of an instance to the given buffer.
  *
  * @return:
  *      - LE_OK on success
@@ -4883,7 +5327,7 @@ static le_result_t WriteFieldTLV
  *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t assetData_WriteFieldListToTLV
+static le_result_t EncodeFieldListToTLV
 (
     assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
     uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
@@ -4934,6 +5378,61 @@ le_result_t assetData_WriteFieldListToTLV
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a list of readable LWM2M Resource TLVs to the given buffer.
+ *
+ * The list is encoded once into the TLV cache of the instance, if it fits, and then copied from
+ * the cache until a field of the instance changes.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the TLV data could not fit in the buffer
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_WriteFieldListToTLV
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
+    size_t bufNumBytes,                         ///< [IN] Size of buffer
+    size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
+)
+{
+    le_result_t result;
+
+    if ( instanceRef->isTlvCacheValid )
+    {
+        if ( instanceRef->tlvCacheNumBytes > bufNumBytes )
+        {
+            LE_WARN("Overflow: oiid=%i", instanceRef->instanceId);
+            return LE_OVERFLOW;
+        }
+
+        memcpy(bufPtr, instanceRef->tlvCachePtr, instanceRef->tlvCacheNumBytes);
+        *numBytesWrittenPtr = instanceRef->tlvCacheNumBytes;
+        return LE_OK;
+    }
+
+    result = EncodeFieldListToTLV(instanceRef, bufPtr, bufNumBytes, numBytesWrittenPtr);
+
+    // Larger lists are encoded on each read.
+    if ( ( result == LE_OK ) && ( *numBytesWrittenPtr <= TLV_CACHE_NUMBYTES ) )
+    {
+        if ( instanceRef->tlvCachePtr == NULL )
+        {
+            instanceRef->tlvCachePtr = le_mem_ForceAlloc(TlvCachePoolRef);
+        }
+
+        memcpy(instanceRef->tlvCachePtr, bufPtr, *numBytesWrittenPtr);
+        instanceRef->tlvCacheNumBytes = *numBytesWrittenPtr;
+        instanceRef->isTlvCacheValid = true;
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write a LWM2M Object Instance TLV to the given buffer.
@@ -4957,11 +5456,18 @@ static le_result_t WriteInstanceToTLV
     FieldData_t* fieldDataPtr;
     size_t totalNumBytesWritten;
     size_t numBytesWritten;
-    uint8_t tmpBuffer[256-6];  // leave enough space for maximum header size of 6 bytes
+    uint8_t tmpBuffer[TLV_CACHE_NUMBYTES];  // leave enough space for maximum header size of 6 bytes
+    const uint8_t* fieldsPtr = tmpBuffer;
 
     // Need to write the field TLVs first, to know how many bytes will be in the instance TLV.
     // Either read all the allowable TLVs, or just the one specified.
-    if ( fieldId == -1 )
+    if ( ( fieldId == -1 ) && instanceRef->isTlvCacheValid )
+    {
+        // No field changed since the last read, so use the cached TLVs as they are.
+        fieldsPtr = instanceRef->tlvCachePtr;
+        totalNumBytesWritten = instanceRef->tlvCacheNumBytes;
+    }
+    else if ( fieldId == -1 )
     {
         // Read all fields that are allowed and write to the TLV.
         result = assetData_WriteFieldListToTLV(instanceRef,
@@ -5000,7 +5506,7 @@ static le_result_t WriteInstanceToTLV
         bufPtr += numBytesWritten;
         bufNumBytes -= numBytesWritten;
 
-        memcpy(bufPtr, tmpBuffer, totalNumBytesWritten);
+        memcpy(bufPtr, fieldsPtr, totalNumBytesWritten);
         *numBytesWrittenPtr = numBytesWritten+totalNumBytesWritten;
 
         result = LE_OK;
@@ -5074,50 +5580,84 @@ le_result_t assetData_WriteObjectToTLV
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Write TLV for an object but include only the instance/resource which changed. This type of
+ *  Write TLV for an object but include only the instance/resources which changed. This type of
  *  response is needed as the server sends notify on entire object, but we need to notify changes
- *  at resource level.
+ *  at resource level.  If all the resources do not fit in the buffer, only the first ones are
+ *  written.
  *
  *  @return:
  *      - LE_OK on success
- *      - LE_FAULT on error
+ *      - LE_OVERFLOW if not even the first resource fits in the buffer
+ *      - LE_FAULT on any other error
  */
 //--------------------------------------------------------------------------------------------------
 static le_result_t WriteNotifyObjectToTLV
 (
-    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
-    int instanceId,                             ///< [IN] Instance that has a changed resource
-    int fieldId,                                ///< [IN] The resource which changed
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Instance that has changed resources
+    FieldData_t** fieldListPtr,                 ///< [IN] The resources which changed
+    size_t* numFieldsPtr,                       ///< [IN/OUT] # resources in the list; # resources
+                                                ///<          written to buffer.
     uint8_t* bufPtr,                            ///< [OUT] Buffer for writing the TLV list
     size_t bufNumBytes,                         ///< [IN] Size of buffer
     size_t* numBytesWrittenPtr                  ///< [OUT] # bytes written to buffer.
 )
 {
-    le_result_t result = LE_OK;
-    InstanceData_t* instancePtr;
-
-    LE_DEBUG("instanceId = %d", instanceId);
-    LE_DEBUG("fieldId = %d", fieldId);
+    le_result_t result;
+    size_t numFields;
+    size_t fieldsNumBytes = 0;
+    size_t numBytesWritten;
 
-    result = GetInstanceFromAssetData(assetRef, instanceId, &instancePtr);
+    // Need to write the resource TLVs first, to know how many bytes will be in the instance TLV.
+    // They are written after room for the largest header (6 bytes), then moved right after the
+    // header once it is written.
+    uint8_t* fieldsBufPtr = bufPtr + 6;
 
-    if (result != LE_OK)
+    if ( bufNumBytes <= 6 )
     {
-        LE_ERROR("Error reading instance reference result = %d.", result);
-        return LE_FAULT;
+        return LE_OVERFLOW;
     }
 
-    result = WriteInstanceToTLV(instancePtr,
-                                fieldId,
-                                bufPtr,
-                                bufNumBytes,
-                                numBytesWrittenPtr);
-    if (result != LE_OK)
+    // Write as many resources as fit in the buffer.
+    for ( numFields = 0; numFields < *numFieldsPtr; numFields++ )
     {
-        LE_ERROR("Error while setting asset instance result = %d.", result);
-        return LE_FAULT;
+        LE_DEBUG("instanceId = %d, fieldId = %d",
+                 instanceRef->instanceId, fieldListPtr[numFields]->fieldId);
+
+        result = WriteFieldTLV(instanceRef,
+                               fieldListPtr[numFields],
+                               fieldsBufPtr + fieldsNumBytes,
+                               bufNumBytes - 6 - fieldsNumBytes,
+                               &numBytesWritten);
+
+        if ( result == LE_OVERFLOW )
+        {
+            if ( numFields == 0 )
+            {
+                return LE_OVERFLOW;
+            }
+            break;
+        }
+        if ( result != LE_OK )
+        {
+            LE_ERROR("Error while setting asset instance result = %d.", result);
+            return LE_FAULT;
+        }
+
+        fieldsNumBytes += numBytesWritten;
     }
 
+    WriteTLVHeader(TLV_TYPE_OBJ_INST,
+                   instanceRef->instanceId,
+                   fieldsNumBytes,
+                   bufPtr,
+                   bufNumBytes,
+                   &numBytesWritten);
+
+    memmove(bufPtr + numBytesWritten, fieldsBufPtr, fieldsNumBytes);
+
+    *numFieldsPtr = numFields;
+    *numBytesWrittenPtr = numBytesWritten + fieldsNumBytes;
+
     return LE_OK;
 }
 
@@ -5226,6 +5766,8 @@ static le_result_t ReadFieldValueFromTLV
     if ( result != LE_OK )
         return result;
 
+    instanceRef->isTlvCacheValid = false;
+
     // Update the field value from the TLV; note that result must be LE_OK here.
     switch ( fieldDataPtr->type )
     {
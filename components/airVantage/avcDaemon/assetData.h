@@ -99,6 +99,51 @@ typedef struct assetData_AssetData* assetData_AssetDataRef_t;
 typedef struct le_avdata_AssetInstance* assetData_InstanceDataRef_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a field of an asset data instance.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct assetData_FieldData* assetData_FieldDataRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Types of the values given to assetData_client_SetFieldList()
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ASSET_DATA_TYPE_INT,
+    ASSET_DATA_TYPE_BOOL,
+    ASSET_DATA_TYPE_STRING,
+    ASSET_DATA_TYPE_FLOAT
+}
+assetData_DataTypes_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of a field, given to assetData_client_SetFieldList()
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    assetData_FieldDataRef_t fieldRef;  ///< Field to write
+    assetData_DataTypes_t type;         ///< Type of the value; must be the type of the field
+    union
+    {
+        int intValue;
+        double floatValue;
+        bool boolValue;
+        const char* strValuePtr;
+    };
+    uint64_t timeStamp;                 ///< Timestamp in utc milli seconds, if the field records
+                                        ///< time series; 0 for the current time
+}
+assetData_FieldValue_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reference used by the AddFieldActionHandler/RemoveFieldActionHandler functions.
@@ -423,6 +468,23 @@ le_result_t assetData_GetFieldIdFromName
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the field reference for the given field name
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_GetFieldRefFromName
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    const char* fieldNamePtr,                   ///< [IN] The field name
+    assetData_FieldDataRef_t* fieldRefPtr       ///< [OUT] The field reference
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the integer value for the specified field
@@ -570,6 +632,27 @@ LE_SHARED le_result_t assetData_client_SetString
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the values of a list of fields of an instance.  The fields which are recording time series
+ * record their value; if observe is enabled on the others, the changes are notified together,
+ * along with the other changes of the asset queued in the meantime.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if a stored string was truncated
+ *      - LE_FAULT if the type of a value does not match its field, or on any other error.  The
+ *        values after the one which failed are not set.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t assetData_client_SetFieldList
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    const assetData_FieldValue_t* valueListPtr, ///< [IN] The values to write
+    size_t numValues                            ///< [IN] Number of values in the list
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a handler to be notified on field actions, such as write or execute
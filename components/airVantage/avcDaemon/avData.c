@@ -56,10 +56,27 @@ typedef struct
 {
     le_avdata_AssetInstanceRef_t instRef;       ///< Instance ref
     le_msg_SessionRef_t clientSessionRef;       ///< Client using this instance ref
+    le_dls_List_t fieldCacheList;               ///< Fields of this instance in FieldCache
 }
 InstanceRefData_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Field resolved from its name by le_avdata_SetFieldList(), kept in FieldCache.  The entry is its
+ * own key.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    InstanceRefData_t* instRefDataPtr;          ///< Instance ref data of the client session
+    char fieldName[LE_AVDATA_FIELD_NAME_LEN+1]; ///< Field name
+    assetData_FieldDataRef_t fieldRef;          ///< Field
+    le_dls_Link_t link;                         ///< For adding to the instance field cache list
+}
+FieldCacheEntry_t;
+
+
 //--------------------------------------------------------------------------------------------------
 // Local Data
 //--------------------------------------------------------------------------------------------------
@@ -106,6 +123,24 @@ static le_timer_Ref_t SessionReleaseTimerRef;
 static le_ref_MapRef_t InstanceRefMap;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Field cache entry memory pool.  Initialized in avData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FieldCacheEntryPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fields of the client instances, by instance and field name, so that le_avdata_SetFieldList()
+ * does not have to look up the field list of the instance for each value.  The entries of an
+ * instance ref are removed when the client session owning it closes.  Initialized in avData_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t FieldCache;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event for sending session state to registered applications.
@@ -168,6 +203,110 @@ static void SessionReleaseTimerHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash function for the FieldCache keys
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashFieldCacheKey
+(
+    const void* keyPtr
+)
+{
+    const FieldCacheEntry_t* entryPtr = keyPtr;
+
+    return le_hashmap_HashString(entryPtr->fieldName) ^
+           le_hashmap_HashVoidPointer(entryPtr->instRefDataPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Equality function for the FieldCache keys
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsFieldCacheKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const FieldCacheEntry_t* firstEntryPtr = firstKeyPtr;
+    const FieldCacheEntry_t* secondEntryPtr = secondKeyPtr;
+
+    return ( firstEntryPtr->instRefDataPtr == secondEntryPtr->instRefDataPtr ) &&
+           ( strcmp(firstEntryPtr->fieldName, secondEntryPtr->fieldName) == 0 );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a field of an instance from its name, using the FieldCache
+ *
+ * @note The client will be terminated if the field doesn't exist
+ *
+ * @return The field, or NULL if the client was terminated
+ */
+//--------------------------------------------------------------------------------------------------
+static assetData_FieldDataRef_t GetCachedFieldRef
+(
+    InstanceRefData_t* instRefDataPtr,
+    const char* fieldName
+)
+{
+    FieldCacheEntry_t key = { .instRefDataPtr = instRefDataPtr };
+    FieldCacheEntry_t* entryPtr;
+
+    if ( le_utf8_Copy(key.fieldName, fieldName, sizeof(key.fieldName), NULL) == LE_OK )
+    {
+        entryPtr = le_hashmap_Get(FieldCache, &key);
+        if ( entryPtr != NULL )
+        {
+            return entryPtr->fieldRef;
+        }
+    }
+
+    if ( assetData_GetFieldRefFromName(instRefDataPtr->instRef,
+                                       fieldName,
+                                       &key.fieldRef) != LE_OK )
+    {
+        LE_KILL_CLIENT("Invalid instance '%p' or unknown field name '%s'",
+                       instRefDataPtr->instRef, fieldName);
+        return NULL;
+    }
+
+    entryPtr = le_mem_ForceAlloc(FieldCacheEntryPoolRef);
+    *entryPtr = key;
+    entryPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&instRefDataPtr->fieldCacheList, &entryPtr->link);
+    le_hashmap_Put(FieldCache, entryPtr, entryPtr);
+
+    return entryPtr->fieldRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the fields of an instance ref from the FieldCache
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushFieldCache
+(
+    InstanceRefData_t* instRefDataPtr
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ( ( linkPtr = le_dls_Pop(&instRefDataPtr->fieldCacheList) ) != NULL )
+    {
+        FieldCacheEntry_t* entryPtr = CONTAINER_OF(linkPtr, FieldCacheEntry_t, link);
+
+        le_hashmap_Remove(FieldCache, entryPtr);
+        le_mem_Release(entryPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler for client session closes
@@ -197,6 +336,9 @@ static void ClientCloseSessionHandler
 
         if ( instRefDataPtr->clientSessionRef == sessionRef )
         {
+            // Forget the cached fields of the instance
+            FlushFieldCache((InstanceRefData_t*)instRefDataPtr);
+
             // Delete instance data, and also delete asset data, if last instance is deleted
             assetData_DeleteInstanceAndAsset(instRefDataPtr->instRef);
 
@@ -393,6 +535,7 @@ le_avdata_AssetInstanceRef_t le_avdata_Create
 
     instRefDataPtr->clientSessionRef = le_avdata_GetClientSessionRef();
     instRefDataPtr->instRef = instRef;
+    instRefDataPtr->fieldCacheList = LE_DLS_LIST_INIT;
 
     instRef = le_ref_CreateRef(InstanceRefMap, instRefDataPtr);
 
@@ -1402,6 +1545,104 @@ le_result_t le_avdata_RecordString
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set, or record in time series, the values of several variable fields of an instance.
+ *
+ * @note The client will be terminated if the instRef is not valid, or one of the fields doesn't
+ *       exist
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if a string was truncated
+ *      - LE_FAULT if the type of a value does not match the type of its field, or on any other
+ *        error.  The values after the one which failed are not set.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_avdata_SetFieldList
+(
+    le_avdata_AssetInstanceRef_t instRef,
+        ///< [IN]
+
+    const le_avdata_FieldValue_t* fieldListPtr,
+        ///< [IN]
+
+    size_t fieldListSize
+        ///< [IN]
+)
+{
+    assetData_FieldValue_t valueList[LE_AVDATA_FIELD_LIST_MAX_NUM];
+    le_result_t result;
+    size_t i;
+
+    // Map safeRef to desired data
+    InstanceRefData_t* instRefDataPtr = le_ref_Lookup(InstanceRefMap, instRef);
+
+    if ( instRefDataPtr == NULL )
+    {
+        LE_KILL_CLIENT("Invalid reference %p from %s", instRef, __func__);
+        return LE_FAULT;
+    }
+
+    if ( fieldListSize > LE_AVDATA_FIELD_LIST_MAX_NUM )
+    {
+        LE_KILL_CLIENT("Too many fields (%zu)", fieldListSize);
+        return LE_FAULT;
+    }
+
+    for ( i = 0; i < fieldListSize; i++ )
+    {
+        const le_avdata_FieldValue_t* fieldValuePtr = &fieldListPtr[i];
+        assetData_FieldValue_t* valuePtr = &valueList[i];
+
+        valuePtr->fieldRef = GetCachedFieldRef(instRefDataPtr, fieldValuePtr->fieldName);
+        if ( valuePtr->fieldRef == NULL )
+        {
+            return LE_FAULT;
+        }
+
+        switch ( fieldValuePtr->type )
+        {
+            case LE_AVDATA_FIELD_TYPE_INT:
+                valuePtr->type = ASSET_DATA_TYPE_INT;
+                valuePtr->intValue = fieldValuePtr->intValue;
+                break;
+
+            case LE_AVDATA_FIELD_TYPE_FLOAT:
+                valuePtr->type = ASSET_DATA_TYPE_FLOAT;
+                valuePtr->floatValue = fieldValuePtr->floatValue;
+                break;
+
+            case LE_AVDATA_FIELD_TYPE_BOOL:
+                valuePtr->type = ASSET_DATA_TYPE_BOOL;
+                valuePtr->boolValue = fieldValuePtr->boolValue;
+                break;
+
+            case LE_AVDATA_FIELD_TYPE_STRING:
+                valuePtr->type = ASSET_DATA_TYPE_STRING;
+                valuePtr->strValuePtr = fieldValuePtr->strValue;
+                break;
+
+            default:
+                LE_KILL_CLIENT("Invalid type %d for field '%s'",
+                               fieldValuePtr->type, fieldValuePtr->fieldName);
+                return LE_FAULT;
+        }
+
+        valuePtr->timeStamp = fieldValuePtr->timeStamp;
+    }
+
+    result = assetData_client_SetFieldList(instRefDataPtr->instRef, valueList, fieldListSize);
+
+    if ( ( result != LE_OK ) && ( result != LE_OVERFLOW ) )
+    {
+        LE_ERROR("Error setting field list");
+    }
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Is time series enabled on this resource, if yes how many data points are recorded so far?
@@ -1471,6 +1712,10 @@ void avData_Init
     // and 10 instances per app.  This can always be increased/decreased later, if needed.
     InstanceRefMap = le_ref_CreateMap("InstRefMap", 300);
 
+    // The field cache is sized like the instance ref map, and grows if needed.
+    FieldCacheEntryPoolRef = le_mem_CreatePool("Field cache pool", sizeof(FieldCacheEntry_t));
+    FieldCache = le_hashmap_Create("FieldCache", 300, HashFieldCacheKey, EqualsFieldCacheKey);
+
     // Add a handler for client session closes
     le_msg_AddServiceCloseHandler(le_avdata_GetServiceRef(), ClientCloseSessionHandler, NULL);
 
@@ -0,0 +1,951 @@
+/**
+ * @file timeSeriesStore.c
+ *
+ * Implementation of the time series store.
+ *
+ * The store file holds a header followed by a ring of samples.  Each sample is:
+ *  - the difference between its time stamp and the previous one, zigzag and varint encoded,
+ *  - then, depending on the type of the store:
+ *      - integer: the difference with the previous value, zigzag and varint encoded,
+ *      - floating point: the XOR with the previous value, byte-reversed and varint encoded, so
+ *        values sharing their sign, exponent and high mantissa bits take few bytes,
+ *      - boolean: one byte,
+ *      - string: the length, varint encoded, then the characters.
+ *
+ * As every sample depends on the one before it, the header keeps the time stamp and value before
+ * the oldest sample (to read the ring) and of the newest sample (to add to it).
+ *
+ * The file is only synced to flash when samples are pushed and when the store is closed; in
+ * between, the kernel writes the mapped pages back in any order.  So a crash can lose the samples
+ * added since the last sync, and can leave a header that doesn't match the ring.  The header is
+ * checked when the file is opened, and a sample that cannot be decoded resets the store.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "timeSeriesStore.h"
+
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+// Definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identifies a time series store file ("AVTS").
+ */
+//--------------------------------------------------------------------------------------------------
+#define STORE_MAGIC 0x53545641
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Version of the store file format.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STORE_VERSION 1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a varint encoded 64-bit value.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_VARINT_BYTES 10
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a sample in the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SAMPLE_BYTES (MAX_VARINT_BYTES + MAX_VARINT_BYTES + TIME_SERIES_STORE_STRING_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimum size of the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_RING_BYTES (4 * MAX_SAMPLE_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a store file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                 ///< STORE_MAGIC.
+    uint32_t version;               ///< STORE_VERSION.
+    uint32_t type;                  ///< Type of the samples (timeSeriesStore_Type_t).
+    uint32_t ringSize;              ///< Number of bytes of the ring.
+    uint32_t head;                  ///< Offset where the next sample is written.
+    uint32_t tail;                  ///< Offset of the oldest sample.
+    uint32_t usedBytes;             ///< Number of bytes from the tail to the head.
+    uint32_t count;                 ///< Number of samples.
+    uint64_t tailPrevTimeStamp;     ///< Time stamp before the oldest sample.
+    uint64_t tailPrevValue;         ///< Value before the oldest sample.
+    uint64_t headPrevTimeStamp;     ///< Time stamp of the newest sample.
+    uint64_t headPrevValue;         ///< Value of the newest sample.
+}
+Header_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An open store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct timeSeriesStore_Store
+{
+    Header_t* headerPtr;            ///< Header, at the beginning of the mapped file.
+    uint8_t* ringPtr;               ///< Ring, right after the header.
+    size_t mapSize;                 ///< Number of bytes mapped.
+    uint64_t maxAgeMs;              ///< Retention period, 0 if none.
+    char path[LIMIT_MAX_PATH_BYTES];///< Path of the file.
+}
+Store_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store memory pool.  Initialized in timeSeriesStore_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t StorePoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+// Local functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a signed value to an unsigned one, small negative values giving small unsigned values.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t ZigZagEncode
+(
+    int64_t value
+)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reverse ZigZagEncode().
+ */
+//--------------------------------------------------------------------------------------------------
+static inline int64_t ZigZagDecode
+(
+    uint64_t value
+)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode a varint: 7 bits per byte, least significant first, the top bit set on all bytes but the
+ * last one.
+ *
+ * @return Number of bytes written.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PutVarint
+(
+    uint8_t* bufPtr,
+    uint64_t value
+)
+{
+    size_t len = 0;
+
+    while (value >= 0x80)
+    {
+        bufPtr[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bufPtr[len++] = (uint8_t)value;
+
+    return len;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a byte of the ring at a cursor and move the cursor.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint8_t GetByte
+(
+    Store_t* storePtr,
+    uint32_t* offsetPtr
+)
+{
+    uint8_t byte = storePtr->ringPtr[*offsetPtr];
+
+    if (++(*offsetPtr) == storePtr->headerPtr->ringSize)
+    {
+        *offsetPtr = 0;
+    }
+
+    return byte;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a varint from the ring at a cursor and move the cursor.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the varint is too long
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetVarint
+(
+    Store_t* storePtr,
+    uint32_t* offsetPtr,
+    uint64_t* valuePtr
+)
+{
+    uint64_t value = 0;
+    int shift;
+
+    for (shift = 0; shift < 7 * MAX_VARINT_BYTES; shift += 7)
+    {
+        uint8_t byte = GetByte(storePtr, offsetPtr);
+
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            *valuePtr = value;
+            return LE_OK;
+        }
+    }
+
+    return LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bits of a floating point value.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t FloatToBits
+(
+    double value
+)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Floating point value from its bits.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline double BitsToFloat
+(
+    uint64_t bits
+)
+{
+    double value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empty the ring, e.g. because it is corrupted.  The newest sample stays the reference for the
+ * next one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Reset
+(
+    Store_t* storePtr
+)
+{
+    Header_t* headerPtr = storePtr->headerPtr;
+
+    headerPtr->head = 0;
+    headerPtr->tail = 0;
+    headerPtr->usedBytes = 0;
+    headerPtr->count = 0;
+    headerPtr->tailPrevTimeStamp = headerPtr->headPrevTimeStamp;
+    headerPtr->tailPrevValue = headerPtr->headPrevValue;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the header of a store file.
+ *
+ * @return true if the samples in the file can be used.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHeaderValid
+(
+    const Header_t* headerPtr,
+    timeSeriesStore_Type_t type,
+    uint32_t ringSize
+)
+{
+    return (headerPtr->magic == STORE_MAGIC) &&
+           (headerPtr->version == STORE_VERSION) &&
+           (headerPtr->type == type) &&
+           (headerPtr->ringSize == ringSize) &&
+           (headerPtr->head < ringSize) &&
+           (headerPtr->tail < ringSize) &&
+           (headerPtr->usedBytes <= ringSize) &&
+           (headerPtr->usedBytes == (headerPtr->head + ringSize - headerPtr->tail) % ringSize ||
+            ((headerPtr->usedBytes == ringSize) && (headerPtr->head == headerPtr->tail))) &&
+           ((headerPtr->count == 0) == (headerPtr->usedBytes == 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the sample at a cursor and move the cursor to the next one.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the sample is corrupted
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Decode
+(
+    Store_t* storePtr,
+    timeSeriesStore_Cursor_t* cursorPtr,
+    timeSeriesStore_Sample_t* samplePtr
+)
+{
+    uint64_t delta;
+    uint64_t len;
+    uint64_t i;
+
+    if (GetVarint(storePtr, &cursorPtr->offset, &delta) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+    samplePtr->timeStamp = cursorPtr->prevTimeStamp + (uint64_t)ZigZagDecode(delta);
+
+    switch (storePtr->headerPtr->type)
+    {
+        case TIME_SERIES_STORE_TYPE_INT:
+            if (GetVarint(storePtr, &cursorPtr->offset, &delta) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+            cursorPtr->prevValue += (uint64_t)ZigZagDecode(delta);
+            samplePtr->intValue = (int64_t)cursorPtr->prevValue;
+            break;
+
+        case TIME_SERIES_STORE_TYPE_FLOAT:
+            if (GetVarint(storePtr, &cursorPtr->offset, &delta) != LE_OK)
+            {
+                return LE_FAULT;
+            }
+            cursorPtr->prevValue ^= __builtin_bswap64(delta);
+            samplePtr->floatValue = BitsToFloat(cursorPtr->prevValue);
+            break;
+
+        case TIME_SERIES_STORE_TYPE_BOOL:
+            cursorPtr->prevValue = GetByte(storePtr, &cursorPtr->offset);
+            samplePtr->boolValue = (cursorPtr->prevValue != 0);
+            break;
+
+        case TIME_SERIES_STORE_TYPE_STRING:
+            if ((GetVarint(storePtr, &cursorPtr->offset, &len) != LE_OK) ||
+                (len >= TIME_SERIES_STORE_STRING_BYTES))
+            {
+                return LE_FAULT;
+            }
+            for (i = 0; i < len; i++)
+            {
+                samplePtr->strValue[i] = (char)GetByte(storePtr, &cursorPtr->offset);
+            }
+            samplePtr->strValue[len] = '\0';
+            break;
+
+        default:
+            return LE_FAULT;
+    }
+
+    cursorPtr->prevTimeStamp = samplePtr->timeStamp;
+    cursorPtr->remaining--;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the samples before a cursor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetTail
+(
+    Store_t* storePtr,
+    const timeSeriesStore_Cursor_t* cursorPtr
+)
+{
+    Header_t* headerPtr = storePtr->headerPtr;
+    uint32_t droppedBytes;
+
+    if (cursorPtr->remaining == headerPtr->count)
+    {
+        return;
+    }
+
+    if (cursorPtr->remaining == 0)
+    {
+        Reset(storePtr);
+        return;
+    }
+
+    droppedBytes = (cursorPtr->offset + headerPtr->ringSize - headerPtr->tail) % headerPtr->ringSize;
+    if (droppedBytes >= headerPtr->usedBytes)
+    {
+        LE_ERROR("Time series store %s is corrupted.", storePtr->path);
+        Reset(storePtr);
+        return;
+    }
+
+    headerPtr->usedBytes -= droppedBytes;
+    headerPtr->tail = cursorPtr->offset;
+    headerPtr->tailPrevTimeStamp = cursorPtr->prevTimeStamp;
+    headerPtr->tailPrevValue = cursorPtr->prevValue;
+    headerPtr->count = cursorPtr->remaining;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the samples that are older than the retention period, relative to a new sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropExpired
+(
+    Store_t* storePtr,
+    uint64_t timeStamp              ///< [IN] Time stamp of the new sample.
+)
+{
+    timeSeriesStore_Cursor_t cursor;
+    timeSeriesStore_Cursor_t next;
+    timeSeriesStore_Sample_t sample;
+
+    if ((storePtr->maxAgeMs == 0) || (timeStamp < storePtr->maxAgeMs))
+    {
+        return;
+    }
+
+    timeSeriesStore_StartRead(storePtr, &cursor);
+
+    while (cursor.remaining > 0)
+    {
+        next = cursor;
+        if (Decode(storePtr, &next, &sample) != LE_OK)
+        {
+            LE_ERROR("Time series store %s is corrupted.", storePtr->path);
+            Reset(storePtr);
+            return;
+        }
+        if (sample.timeStamp >= timeStamp - storePtr->maxAgeMs)
+        {
+            break;
+        }
+        cursor = next;
+    }
+
+    SetTail(storePtr, &cursor);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the oldest sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropOldest
+(
+    Store_t* storePtr
+)
+{
+    timeSeriesStore_Cursor_t cursor;
+    timeSeriesStore_Sample_t sample;
+
+    timeSeriesStore_StartRead(storePtr, &cursor);
+
+    if (Decode(storePtr, &cursor, &sample) != LE_OK)
+    {
+        LE_ERROR("Time series store %s is corrupted.", storePtr->path);
+        Reset(storePtr);
+        return;
+    }
+
+    SetTail(storePtr, &cursor);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an encoded sample to the ring, dropping old samples as needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Append
+(
+    Store_t* storePtr,
+    const uint8_t* bufPtr,          ///< [IN] Encoded sample.
+    size_t len,                     ///< [IN] Number of bytes of the encoded sample.
+    uint64_t timeStamp,             ///< [IN] Time stamp of the sample.
+    uint64_t value                  ///< [IN] Value of the sample.
+)
+{
+    Header_t* headerPtr = storePtr->headerPtr;
+    size_t firstLen;
+
+    DropExpired(storePtr, timeStamp);
+
+    while ((headerPtr->ringSize - headerPtr->usedBytes < len) && (headerPtr->count > 0))
+    {
+        LE_DEBUG("Time series store %s full, dropping oldest sample.", storePtr->path);
+        DropOldest(storePtr);
+    }
+
+    // Write the sample, wrapping around the end of the ring, before updating the header.
+    firstLen = headerPtr->ringSize - headerPtr->head;
+    if (firstLen >= len)
+    {
+        memcpy(storePtr->ringPtr + headerPtr->head, bufPtr, len);
+    }
+    else
+    {
+        memcpy(storePtr->ringPtr + headerPtr->head, bufPtr, firstLen);
+        memcpy(storePtr->ringPtr, bufPtr + firstLen, len - firstLen);
+    }
+
+    headerPtr->head = (headerPtr->head + len) % headerPtr->ringSize;
+    headerPtr->usedBytes += len;
+    headerPtr->count++;
+    headerPtr->headPrevTimeStamp = timeStamp;
+    headerPtr->headPrevValue = value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode the time stamp of a new sample.
+ *
+ * @return Number of bytes written.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t EncodeTimeStamp
+(
+    Store_t* storePtr,
+    uint8_t* bufPtr,
+    uint64_t timeStamp
+)
+{
+    return PutVarint(bufPtr,
+                     ZigZagEncode((int64_t)(timeStamp - storePtr->headerPtr->headPrevTimeStamp)));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a store, creating its file if needed.  The samples already in the file are kept if it was
+ * created for the same type and size of ring.
+ *
+ * @return Reference to the store, or NULL on error.
+ */
+//--------------------------------------------------------------------------------------------------
+timeSeriesStore_Ref_t timeSeriesStore_Open
+(
+    const char* pathPtr,            ///< [IN] Path of the file.
+    timeSeriesStore_Type_t type,    ///< [IN] Type of the samples.
+    uint32_t ringSize,              ///< [IN] Number of bytes available for the samples.
+    uint32_t maxAgeSec              ///< [IN] Samples older than this (relative to the newest one)
+                                    ///<      are dropped.  0 to keep them until there is no room.
+)
+{
+    char dirPath[LIMIT_MAX_PATH_BYTES];
+    struct stat fileStat;
+    char* slashPtr;
+    void* mapPtr;
+    int fd;
+    int err;
+
+    if (ringSize < MIN_RING_BYTES)
+    {
+        ringSize = MIN_RING_BYTES;
+    }
+
+    if (le_utf8_Copy(dirPath, pathPtr, sizeof(dirPath), NULL) != LE_OK)
+    {
+        LE_ERROR("Time series store path '%s' is too long.", pathPtr);
+        return NULL;
+    }
+
+    slashPtr = strrchr(dirPath, '/');
+    if ((slashPtr != NULL) && (slashPtr != dirPath))
+    {
+        *slashPtr = '\0';
+        if (le_dir_MakePath(dirPath, S_IRWXU) != LE_OK)
+        {
+            LE_ERROR("Cannot create directory '%s'.", dirPath);
+            return NULL;
+        }
+    }
+
+    fd = open(pathPtr, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        LE_ERROR("Cannot open '%s' (%m).", pathPtr);
+        return NULL;
+    }
+
+    size_t mapSize = sizeof(Header_t) + ringSize;
+
+    if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size != (off_t)mapSize))
+    {
+        // Allocate the blocks now, so writing to the mapping can't fail when the file system is
+        // full.
+        if ((ftruncate(fd, 0) != 0) || ((err = posix_fallocate(fd, 0, mapSize)) != 0))
+        {
+            LE_ERROR("Cannot allocate %" PRIuS " bytes for '%s'.", mapSize, pathPtr);
+            close(fd);
+            unlink(pathPtr);
+            return NULL;
+        }
+    }
+
+    mapPtr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Cannot map '%s' (%m).", pathPtr);
+        return NULL;
+    }
+
+    Store_t* storePtr = le_mem_ForceAlloc(StorePoolRef);
+
+    storePtr->headerPtr = mapPtr;
+    storePtr->ringPtr = (uint8_t*)mapPtr + sizeof(Header_t);
+    storePtr->mapSize = mapSize;
+    storePtr->maxAgeMs = (uint64_t)maxAgeSec * 1000;
+    le_utf8_Copy(storePtr->path, pathPtr, sizeof(storePtr->path), NULL);
+
+    if (!IsHeaderValid(storePtr->headerPtr, type, ringSize))
+    {
+        memset(storePtr->headerPtr, 0, sizeof(Header_t));
+        storePtr->headerPtr->magic = STORE_MAGIC;
+        storePtr->headerPtr->version = STORE_VERSION;
+        storePtr->headerPtr->type = type;
+        storePtr->headerPtr->ringSize = ringSize;
+    }
+    else
+    {
+        LE_INFO("Time series store %s has %" PRIu32 " samples.",
+                pathPtr, storePtr->headerPtr->count);
+    }
+
+    return storePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a store.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_Close
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    bool isRemove                   ///< [IN] true to delete the samples and the file.
+)
+{
+    if (!isRemove)
+    {
+        msync(storeRef->headerPtr, storeRef->mapSize, MS_SYNC);
+    }
+
+    munmap(storeRef->headerPtr, storeRef->mapSize);
+
+    if (isRemove && (unlink(storeRef->path) != 0) && (errno != ENOENT))
+    {
+        LE_WARN("Cannot remove '%s' (%m).", storeRef->path);
+    }
+
+    le_mem_Release(storeRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an integer sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not an integer store
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddInt
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    int64_t value                   ///< [IN] Value.
+)
+{
+    uint8_t buf[MAX_SAMPLE_BYTES];
+    size_t len;
+
+    if (storeRef->headerPtr->type != TIME_SERIES_STORE_TYPE_INT)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    len = EncodeTimeStamp(storeRef, buf, timeStamp);
+    len += PutVarint(buf + len,
+                     ZigZagEncode((int64_t)((uint64_t)value - storeRef->headerPtr->headPrevValue)));
+
+    Append(storeRef, buf, len, timeStamp, (uint64_t)value);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a floating point sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not a floating point store
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddFloat
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    double value                    ///< [IN] Value.
+)
+{
+    uint8_t buf[MAX_SAMPLE_BYTES];
+    uint64_t bits = FloatToBits(value);
+    size_t len;
+
+    if (storeRef->headerPtr->type != TIME_SERIES_STORE_TYPE_FLOAT)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    len = EncodeTimeStamp(storeRef, buf, timeStamp);
+    len += PutVarint(buf + len, __builtin_bswap64(bits ^ storeRef->headerPtr->headPrevValue));
+
+    Append(storeRef, buf, len, timeStamp, bits);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a boolean sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not a boolean store
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddBool
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    bool value                      ///< [IN] Value.
+)
+{
+    uint8_t buf[MAX_SAMPLE_BYTES];
+    size_t len;
+
+    if (storeRef->headerPtr->type != TIME_SERIES_STORE_TYPE_BOOL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    len = EncodeTimeStamp(storeRef, buf, timeStamp);
+    buf[len++] = value ? 1 : 0;
+
+    Append(storeRef, buf, len, timeStamp, value ? 1 : 0);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not a string store
+ *      - LE_OVERFLOW if the string is too long
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddString
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    const char* valuePtr            ///< [IN] Value.
+)
+{
+    uint8_t buf[MAX_SAMPLE_BYTES];
+    size_t strLen = strlen(valuePtr);
+    size_t len;
+
+    if (storeRef->headerPtr->type != TIME_SERIES_STORE_TYPE_STRING)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (strLen >= TIME_SERIES_STORE_STRING_BYTES)
+    {
+        return LE_OVERFLOW;
+    }
+
+    len = EncodeTimeStamp(storeRef, buf, timeStamp);
+    len += PutVarint(buf + len, strLen);
+    memcpy(buf + len, valuePtr, strLen);
+    len += strLen;
+
+    Append(storeRef, buf, len, timeStamp, storeRef->headerPtr->headPrevValue);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of samples in a store.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t timeSeriesStore_GetCount
+(
+    timeSeriesStore_Ref_t storeRef  ///< [IN] Store.
+)
+{
+    return storeRef->headerPtr->count;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set a cursor on the oldest sample of a store.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_StartRead
+(
+    timeSeriesStore_Ref_t storeRef,         ///< [IN] Store.
+    timeSeriesStore_Cursor_t* cursorPtr     ///< [OUT] Cursor.
+)
+{
+    cursorPtr->offset = storeRef->headerPtr->tail;
+    cursorPtr->remaining = storeRef->headerPtr->count;
+    cursorPtr->prevTimeStamp = storeRef->headerPtr->tailPrevTimeStamp;
+    cursorPtr->prevValue = storeRef->headerPtr->tailPrevValue;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the sample at a cursor and move the cursor to the next one.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if all the samples have been read
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_ReadNext
+(
+    timeSeriesStore_Ref_t storeRef,         ///< [IN] Store.
+    timeSeriesStore_Cursor_t* cursorPtr,    ///< [IN/OUT] Cursor.
+    timeSeriesStore_Sample_t* samplePtr     ///< [OUT] Sample.
+)
+{
+    if (cursorPtr->remaining == 0)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (Decode(storeRef, cursorPtr, samplePtr) != LE_OK)
+    {
+        // Nothing after a corrupted sample can be decoded.
+        LE_ERROR("Time series store %s is corrupted.", storeRef->path);
+        cursorPtr->remaining = 0;
+        Reset(storeRef);
+        return LE_NOT_FOUND;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the samples before a cursor (i.e. the samples read with it) from a store, and write the
+ * store to flash.
+ *
+ * @note No sample must be added to the store between timeSeriesStore_StartRead() and this.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_Consume
+(
+    timeSeriesStore_Ref_t storeRef,             ///< [IN] Store.
+    const timeSeriesStore_Cursor_t* cursorPtr   ///< [IN] Cursor.
+)
+{
+    SetTail(storeRef, cursorPtr);
+
+    if (msync(storeRef->headerPtr, storeRef->mapSize, MS_SYNC) != 0)
+    {
+        LE_WARN("Cannot write time series store %s (%m).", storeRef->path);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_Init
+(
+    void
+)
+{
+    StorePoolRef = le_mem_CreatePool("TimeSeries store pool", sizeof(Store_t));
+}
@@ -0,0 +1,262 @@
+/**
+ * @file timeSeriesStore.h
+ *
+ * Interface for the time series store.
+ *
+ * A time series store keeps the samples recorded on one asset data field in a ring buffer, in a
+ * file mapped in memory.  Samples survive a restart of the daemon and are kept until they are
+ * pushed to the server, or until they are dropped to make room for newer samples or because they
+ * are older than the retention period.
+ *
+ * Time stamps and values are stored as variable-length deltas from the previous sample, so slowly
+ * changing values at a steady rate take a few bytes per sample.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_TIME_SERIES_STORE_INCLUDE_GUARD
+#define LEGATO_TIME_SERIES_STORE_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+// Definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a string sample, including the terminating null character.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_STORE_STRING_BYTES 256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of the samples in a store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    TIME_SERIES_STORE_TYPE_INT = 1,
+    TIME_SERIES_STORE_TYPE_FLOAT,
+    TIME_SERIES_STORE_TYPE_BOOL,
+    TIME_SERIES_STORE_TYPE_STRING
+}
+timeSeriesStore_Type_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A sample read from a store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t timeStamp;             ///< UTC time stamp, in milliseconds.
+    union
+    {
+        int64_t intValue;
+        double floatValue;
+        bool boolValue;
+    };
+    char strValue[TIME_SERIES_STORE_STRING_BYTES];  ///< Value of a string sample.
+}
+timeSeriesStore_Sample_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position in a store, used to read the samples from the oldest to the newest.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t offset;                ///< Offset of the next sample in the ring.
+    uint32_t remaining;             ///< Number of samples not read yet.
+    uint64_t prevTimeStamp;         ///< Time stamp of the previous sample.
+    uint64_t prevValue;             ///< Value of the previous sample.
+}
+timeSeriesStore_Cursor_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct timeSeriesStore_Store* timeSeriesStore_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a store, creating its file if needed.  The samples already in the file are kept if it was
+ * created for the same type and size of ring.
+ *
+ * @return Reference to the store, or NULL on error.
+ */
+//--------------------------------------------------------------------------------------------------
+timeSeriesStore_Ref_t timeSeriesStore_Open
+(
+    const char* pathPtr,            ///< [IN] Path of the file.
+    timeSeriesStore_Type_t type,    ///< [IN] Type of the samples.
+    uint32_t ringSize,              ///< [IN] Number of bytes available for the samples.
+    uint32_t maxAgeSec              ///< [IN] Samples older than this (relative to the newest one)
+                                    ///<      are dropped.  0 to keep them until there is no room.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close a store.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_Close
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    bool isRemove                   ///< [IN] true to delete the samples and the file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an integer sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not an integer store
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddInt
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    int64_t value                   ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a floating point sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not a floating point store
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddFloat
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    double value                    ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a boolean sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not a boolean store
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddBool
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    bool value                      ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string sample to a store.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the store is not a string store
+ *      - LE_OVERFLOW if the string is too long
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_AddString
+(
+    timeSeriesStore_Ref_t storeRef, ///< [IN] Store.
+    uint64_t timeStamp,             ///< [IN] UTC time stamp, in milliseconds.
+    const char* valuePtr            ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of samples in a store.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t timeSeriesStore_GetCount
+(
+    timeSeriesStore_Ref_t storeRef  ///< [IN] Store.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set a cursor on the oldest sample of a store.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_StartRead
+(
+    timeSeriesStore_Ref_t storeRef,         ///< [IN] Store.
+    timeSeriesStore_Cursor_t* cursorPtr     ///< [OUT] Cursor.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the sample at a cursor and move the cursor to the next one.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if all the samples have been read
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeriesStore_ReadNext
+(
+    timeSeriesStore_Ref_t storeRef,         ///< [IN] Store.
+    timeSeriesStore_Cursor_t* cursorPtr,    ///< [IN/OUT] Cursor.
+    timeSeriesStore_Sample_t* samplePtr     ///< [OUT] Sample.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the samples before a cursor (i.e. the samples read with it) from a store, and write the
+ * store to flash.
+ *
+ * @note No sample must be added to the store between timeSeriesStore_StartRead() and this.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeriesStore_Consume
+(
+    timeSeriesStore_Ref_t storeRef,             ///< [IN] Store.
+    const timeSeriesStore_Cursor_t* cursorPtr   ///< [IN] Cursor.
+);
+
+#endif // LEGATO_TIME_SERIES_STORE_INCLUDE_GUARD
@@ -29,6 +29,13 @@
 //--------------------------------------------------------------------------------------------------
 #define DSIZE_INFO_STR   1600
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of buffers written at once by le_dev_WriteV()
+ */
+//--------------------------------------------------------------------------------------------------
+#define WRITEV_MAX_BUFFERS   8
+
 #if LE_DEBUG_ENABLED
 //--------------------------------------------------------------------------------------------------
 /**
@@ -334,6 +341,78 @@ int32_t le_dev_Write
     return currentSize;
 }
 
+#if LE_CONFIG_LINUX
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to write several buffers on device (or port) at once
+ *
+ * @return written byte number
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_dev_WriteV
+(
+    Device_t*           devicePtr,  ///< device pointer
+    const struct iovec* iovPtr,     ///< Buffers to write
+    int                 iovCount    ///< number of buffers
+)
+{
+    struct iovec iov[WRITEV_MAX_BUFFERS];
+    int first = 0;
+    int i;
+    size_t currentSize = 0;
+    ssize_t sizeWritten;
+
+    LE_FATAL_IF(devicePtr->fd==-1,"Write Handle error\n");
+    LE_ASSERT((iovCount >= 0) && (iovCount <= WRITEV_MAX_BUFFERS));
+
+    memcpy(iov, iovPtr, iovCount * sizeof(struct iovec));
+
+    while (first < iovCount)
+    {
+        // Skip the buffers that are already written.
+        if (0 == iov[first].iov_len)
+        {
+            first++;
+            continue;
+        }
+
+        sizeWritten = writev(devicePtr->fd, &iov[first], iovCount - first);
+
+        if (sizeWritten < 0)
+        {
+            if ((errno != EINTR) && (errno != EAGAIN))
+            {
+                LE_ERROR("Cannot write on fd: %s", LE_ERRNO_TXT(errno));
+                break;
+            }
+            continue;
+        }
+
+        currentSize += sizeWritten;
+
+        // Move past what has been written.
+        while ((first < iovCount) && (sizeWritten >= (ssize_t)iov[first].iov_len))
+        {
+            sizeWritten -= iov[first].iov_len;
+            first++;
+        }
+        if (first < iovCount)
+        {
+            iov[first].iov_base = (uint8_t*)iov[first].iov_base + sizeWritten;
+            iov[first].iov_len -= sizeWritten;
+        }
+    }
+
+    for (i = 0; i < iovCount; i++)
+    {
+        PrintBuffer(devicePtr->fd, iovPtr[i].iov_base, iovPtr[i].iov_len);
+    }
+
+    return currentSize;
+}
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to monitor the specified file descriptor
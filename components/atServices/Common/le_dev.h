@@ -8,6 +8,10 @@
 #ifndef LEGATO_LE_DEV_INCLUDE_GUARD
 #define LEGATO_LE_DEV_INCLUDE_GUARD
 
+#if LE_CONFIG_LINUX
+#   include <sys/uio.h>
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * device structure
@@ -49,6 +53,22 @@ int32_t le_dev_Write
     uint32_t    size          ///< size of buffer
 );
 
+#if LE_CONFIG_LINUX
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to write several buffers on device (or port) at once
+ *
+ * @return written byte number
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t le_dev_WriteV
+(
+    Device_t*           devicePtr,  ///< device pointer
+    const struct iovec* iovPtr,     ///< Buffers to write
+    int                 iovCount    ///< number of buffers
+);
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to monitor the specified file descriptor in the calling thread event
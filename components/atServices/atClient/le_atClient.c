@@ -28,6 +28,11 @@
  *
  * @endverbatim
  *
+ * The commands waiting for a device are kept in its atCommandList, sorted by priority. When the
+ * device is waiting, the head of the list is sent, along with the following commands that can be
+ * concatenated on the same line. These commands stay at the head of the list, as in flight, until
+ * the final response of the line or the timeout.
+ *
  *
  *
  *
@@ -281,7 +286,9 @@ typedef struct DeviceContext
     Device_t        device;             ///< data of the connected device
     RxParser_t      rxParser;           ///< Rx buffer parser context
     le_timer_Ref_t  timerRef;           ///< command timer
+    le_timer_Ref_t  deadlineTimerRef;   ///< timer of the next deadline of the waiting commands
     le_dls_List_t   atCommandList;      ///< List of command waiting for execution
+    uint32_t        inFlightCount;      ///< Number of commands of atCommandList being executed
     le_dls_List_t   unsolicitedList;    ///< unsolicited command list
     le_sem_Ref_t    waitingSemaphore;   ///< semaphore used for synchronization
     le_atClient_DeviceRef_t ref;        ///< reference of the device context
@@ -311,8 +318,20 @@ typedef struct AtCmd
     uint32_t               intermediateIndex;                   ///< current index for intermediate
                                                                 ///< reponses reading
     uint32_t               responsesCount;                      ///< responses count in responseList
-    le_sem_Ref_t           endSem;                              ///< end treatment semaphore
     le_result_t            result;                              ///< result operation
+    le_atClient_Priority_t priority;                            ///< priority in the device queue
+    uint32_t               deadline;                            ///< max time in the device queue
+                                                                ///< (in ms), 0 for none
+    le_clk_Time_t          expiryTime;                          ///< time the deadline is reached
+    bool                   isBatchable;                         ///< can share a line with others
+    bool                   isSending;                           ///< send in progress
+    bool                   isSetAndSend;                        ///< sent by
+                                                                ///< le_atClient_SetCommandAndSend()
+    bool                   isSessionClosed;                     ///< client session closed
+    le_atClient_ServerCmdRef_t serverCmdRef;                    ///< pending le_atClient_Send() or
+                                                                ///< le_atClient_SetCommandAndSend()
+    le_atClient_CommandHandlerFunc_t handlerPtr;                ///< asynchronous send handler
+    void*                  contextPtr;                          ///< asynchronous send context
     le_dls_Link_t          link;                                ///< link in AT commands list
     le_msg_SessionRef_t    sessionRef;                          ///< client session reference
 }
@@ -368,6 +387,13 @@ static le_ref_MapRef_t DevicesRefMap;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t UnsolRefMap;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread of the service, where the asynchronous send handlers are called
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t MainThreadRef;
+
 static void WaitingState(ClientStatePtr_t parserStatePtr,ClientEvent_t input);
 static void SendingState(ClientStatePtr_t  parserStatePtr,ClientEvent_t input);
 
@@ -380,6 +406,9 @@ static void UpdateTransitionManager(ClientStatePtr_t  parserStatePtr,
 
 static void SendLine(RxParserPtr_t charParserPtr);
 static void SendData(RxParserPtr_t charParserPtr);
+static void DeadlineTimerHandler(le_timer_Ref_t timerRef);
+static void CompleteCommand(AtCmd_t* cmdPtr, le_result_t result);
+static le_result_t Delete(le_atClient_CmdRef_t cmdRef);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -602,6 +631,9 @@ static void InitializeState
     rxParserPtr->curState = StartingState;
 
     interfacePtr->timerRef = le_timer_Create("CommandTimer");
+    interfacePtr->deadlineTimerRef = le_timer_Create("DeadlineTimer");
+    le_timer_SetHandler(interfacePtr->deadlineTimerRef, DeadlineTimerHandler);
+    le_timer_SetContextPtr(interfacePtr->deadlineTimerRef, interfacePtr);
     interfacePtr->rxParser.interfacePtr = interfacePtr;
 }
 
@@ -676,10 +708,11 @@ static void DestroyDeviceThread
         le_mem_Release(unsolPtr);
     }
 
+    // End the commands left in the queue
     while ((linkPtr=le_dls_Pop(&interfacePtr->atCommandList)) != NULL)
     {
         AtCmd_t* atCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
-        le_mem_Release(atCmdPtr);
+        CompleteCommand(atCmdPtr, LE_FAULT);
     }
 
     if (interfacePtr->timerRef)
@@ -687,6 +720,11 @@ static void DestroyDeviceThread
         le_timer_Delete(interfacePtr->timerRef);
     }
 
+    if (interfacePtr->deadlineTimerRef)
+    {
+        le_timer_Delete(interfacePtr->deadlineTimerRef);
+    }
+
     if (interfacePtr->waitingSemaphore)
     {
         le_sem_Delete(interfacePtr->waitingSemaphore);
@@ -786,6 +824,127 @@ static void StopTimer
     le_timer_Stop(cmdPtr->interfacePtr->timerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is called in the service thread to end a command: the response of
+ * le_atClient_Send() or le_atClient_SetCommandAndSend() is sent, or the handler of
+ * le_atClient_SendAsync() is called.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CommandDone
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    AtCmd_t* cmdPtr = param1Ptr;
+    le_atClient_ServerCmdRef_t serverCmdRef = cmdPtr->serverCmdRef;
+    le_atClient_CommandHandlerFunc_t handlerPtr = cmdPtr->handlerPtr;
+
+    cmdPtr->isSending = false;
+    cmdPtr->serverCmdRef = NULL;
+    cmdPtr->handlerPtr = NULL;
+
+    if (serverCmdRef && cmdPtr->isSetAndSend)
+    {
+        le_atClient_CmdRef_t cmdRef = cmdPtr->ref;
+
+        cmdPtr->isSetAndSend = false;
+        if ((cmdPtr->result != LE_OK) && (!cmdPtr->isSessionClosed))
+        {
+            LE_ERROR("Failed to send !");
+            Delete(cmdRef);
+        }
+        le_atClient_SetCommandAndSendRespond(serverCmdRef, cmdPtr->result, cmdRef);
+    }
+    else if (serverCmdRef)
+    {
+        // If the client session was closed meanwhile, the response is discarded
+        le_atClient_SendRespond(serverCmdRef, cmdPtr->result);
+    }
+    else if (handlerPtr)
+    {
+        // The handler is reset if the client session was closed meanwhile
+        handlerPtr(cmdPtr->ref, cmdPtr->result, cmdPtr->contextPtr);
+    }
+
+    // Release the reference taken by QueueCommand()
+    le_mem_Release(cmdPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to end a command removed from the device queue, in the device
+ * thread. The command must not be used anymore by the caller.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteCommand
+(
+    AtCmd_t*    cmdPtr,
+    le_result_t result
+)
+{
+    cmdPtr->result = result;
+
+    le_event_QueueFunctionToThread(MainThreadRef, CommandDone, cmdPtr, NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to end the commands of the line being executed. When the final
+ * response of the line is received, it is given to all the commands of the line.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteInFlightCommands
+(
+    DeviceContext_t* interfacePtr,
+    le_result_t      result
+)
+{
+    char finalRsp[LE_ATDEFS_RESPONSE_MAX_BYTES] = "";
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->atCommandList);
+
+    // Copy the final response now, the first command can be reused as soon as it is completed
+    if ((result == LE_OK) && (linkPtr != NULL))
+    {
+        AtCmd_t* firstCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+        le_dls_Link_t* rspLinkPtr = le_dls_PeekTail(&firstCmdPtr->responseList);
+
+        if (rspLinkPtr != NULL)
+        {
+            le_utf8_Copy(finalRsp, CONTAINER_OF(rspLinkPtr, RspString_t, link)->line,
+                         sizeof(finalRsp), NULL);
+        }
+    }
+
+    bool isFirst = true;
+
+    while ((interfacePtr->inFlightCount > 0) &&
+           ((linkPtr = le_dls_Pop(&interfacePtr->atCommandList)) != NULL))
+    {
+        AtCmd_t* cmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+        // The first command of the line has already got the final response
+        if ((result == LE_OK) && !isFirst)
+        {
+            RspString_t* newStringPtr = le_mem_ForceAlloc(RspStringPool);
+            memset(newStringPtr, 0, sizeof(RspString_t));
+            le_utf8_Copy(newStringPtr->line, finalRsp, sizeof(newStringPtr->line), NULL);
+            newStringPtr->link = LE_DLS_LINK_INIT;
+            le_dls_Queue(&cmdPtr->responseList, &newStringPtr->link);
+        }
+        isFirst = false;
+
+        interfacePtr->inFlightCount--;
+        CompleteCommand(cmdPtr, result);
+    }
+
+    interfacePtr->inFlightCount = 0;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Timer handler (called when the AT command timeout is reached)
@@ -798,12 +957,11 @@ static void TimerHandler
 )
 {
     AtCmd_t* atCmdPtr = le_timer_GetContextPtr(timerRef);
+    DeviceContext_t* interfacePtr = atCmdPtr->interfacePtr;
+    ClientStatePtr_t clientStatePtr = &interfacePtr->clientState;
 
     LE_ERROR("Timeout when sending %s, timeout = %d",  atCmdPtr->cmd, atCmdPtr->timeout);
-    atCmdPtr->result = LE_TIMEOUT;
-    le_dls_Pop(&atCmdPtr->interfacePtr->atCommandList);
-    le_sem_Post(atCmdPtr->endSem);
-    ClientStatePtr_t clientStatePtr = &atCmdPtr->interfacePtr->clientState;
+    CompleteInFlightCommands(interfacePtr, LE_TIMEOUT);
 
     UpdateTransitionManager(clientStatePtr,EVENT_SENDCMD,WaitingState);
 
@@ -819,7 +977,8 @@ static void TimerHandler
 //--------------------------------------------------------------------------------------------------
 static void StartTimer
 (
-    AtCmd_t* cmdPtr
+    AtCmd_t* cmdPtr,
+    uint32_t timeout
 )
 {
     le_timer_SetHandler(cmdPtr->interfacePtr->timerRef,
@@ -828,12 +987,284 @@ static void StartTimer
     le_timer_SetContextPtr(cmdPtr->interfacePtr->timerRef,
                            cmdPtr);
 
-    le_timer_SetMsInterval(cmdPtr->interfacePtr->timerRef,cmdPtr->timeout);
+    le_timer_SetMsInterval(cmdPtr->interfacePtr->timerRef,timeout);
 
     le_timer_Start(cmdPtr->interfacePtr->timerRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to get the first command of the device queue which is not being executed
+ *
+ * @return
+ *      - Link of the command
+ *      - NULL if no command is waiting
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_Link_t* PeekWaitingCommand
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->atCommandList);
+    uint32_t i;
+
+    for (i = 0; (i < interfacePtr->inFlightCount) && (linkPtr != NULL); i++)
+    {
+        linkPtr = le_dls_PeekNext(&interfacePtr->atCommandList, linkPtr);
+    }
+
+    return linkPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to add a command in the device queue, after the waiting commands
+ * of the same or higher priority.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void InsertCommand
+(
+    DeviceContext_t* interfacePtr,
+    AtCmd_t*         cmdPtr
+)
+{
+    le_dls_Link_t* linkPtr = PeekWaitingCommand(interfacePtr);
+
+    while (linkPtr != NULL)
+    {
+        AtCmd_t* queuedCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+        if (queuedCmdPtr->priority < cmdPtr->priority)
+        {
+            le_dls_AddBefore(&interfacePtr->atCommandList, linkPtr, &cmdPtr->link);
+            return;
+        }
+
+        linkPtr = le_dls_PeekNext(&interfacePtr->atCommandList, linkPtr);
+    }
+
+    le_dls_Queue(&interfacePtr->atCommandList, &cmdPtr->link);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to drop the waiting commands whose deadline is reached, and to
+ * start the deadline timer for the next one.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckDeadlines
+(
+    DeviceContext_t* interfacePtr
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_clk_Time_t nextExpiry = {0, 0};
+    bool hasNextExpiry = false;
+    le_dls_Link_t* linkPtr = PeekWaitingCommand(interfacePtr);
+
+    while (linkPtr != NULL)
+    {
+        AtCmd_t* cmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+        linkPtr = le_dls_PeekNext(&interfacePtr->atCommandList, linkPtr);
+
+        if (cmdPtr->deadline == 0)
+        {
+            continue;
+        }
+
+        if (!le_clk_GreaterThan(cmdPtr->expiryTime, now))
+        {
+            LE_WARN("Deadline of %s reached before sending, deadline = %d",
+                    cmdPtr->cmd, cmdPtr->deadline);
+            le_dls_Remove(&interfacePtr->atCommandList, &cmdPtr->link);
+            CompleteCommand(cmdPtr, LE_TIMEOUT);
+        }
+        else if (!hasNextExpiry || le_clk_GreaterThan(nextExpiry, cmdPtr->expiryTime))
+        {
+            nextExpiry = cmdPtr->expiryTime;
+            hasNextExpiry = true;
+        }
+    }
+
+    le_timer_Stop(interfacePtr->deadlineTimerRef);
+
+    if (hasNextExpiry)
+    {
+        le_timer_SetInterval(interfacePtr->deadlineTimerRef, le_clk_Sub(nextExpiry, now));
+        le_timer_Start(interfacePtr->deadlineTimerRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deadline timer handler (called when the deadline of a waiting command is reached)
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeadlineTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    CheckDeadlines(le_timer_GetContextPtr(timerRef));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to check if a command can be concatenated with others on a command line
+ *
+ * @return
+ *      - TRUE if the command can share a line
+ *      - FALSE otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsBatchable
+(
+    AtCmd_t* cmdPtr
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    if ((!cmdPtr->isBatchable) || (cmdPtr->textSize > 0) || (strlen(cmdPtr->cmd) <= 2) ||
+        (strncasecmp(cmdPtr->cmd, "AT", 2) != 0))
+    {
+        return false;
+    }
+
+    // A pattern matching every line would take the responses of the other commands of the line
+    linkPtr = le_dls_Peek(&cmdPtr->ExpectintermediateResponseList);
+    while (linkPtr != NULL)
+    {
+        if (CONTAINER_OF(linkPtr, RspString_t, link)->line[0] == '\0')
+        {
+            return false;
+        }
+        linkPtr = le_dls_PeekNext(&cmdPtr->ExpectintermediateResponseList, linkPtr);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to check if two lists of response strings are the same
+ *
+ * @return
+ *      - TRUE if the lists hold the same strings in the same order
+ *      - FALSE otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSameResponseList
+(
+    le_dls_List_t* list1Ptr,
+    le_dls_List_t* list2Ptr
+)
+{
+    le_dls_Link_t* link1Ptr = le_dls_Peek(list1Ptr);
+    le_dls_Link_t* link2Ptr = le_dls_Peek(list2Ptr);
+
+    while ((link1Ptr != NULL) && (link2Ptr != NULL))
+    {
+        if (strcmp(CONTAINER_OF(link1Ptr, RspString_t, link)->line,
+                   CONTAINER_OF(link2Ptr, RspString_t, link)->line) != 0)
+        {
+            return false;
+        }
+        link1Ptr = le_dls_PeekNext(list1Ptr, link1Ptr);
+        link2Ptr = le_dls_PeekNext(list2Ptr, link2Ptr);
+    }
+
+    return (link1Ptr == NULL) && (link2Ptr == NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to check if two lists of response strings can match the same line
+ *
+ * @return
+ *      - TRUE if a string of a list starts with a string of the other one
+ *      - FALSE otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsResponseListOverlap
+(
+    le_dls_List_t* list1Ptr,
+    le_dls_List_t* list2Ptr
+)
+{
+    le_dls_Link_t* link1Ptr = le_dls_Peek(list1Ptr);
+
+    while (link1Ptr != NULL)
+    {
+        char* line1Ptr = CONTAINER_OF(link1Ptr, RspString_t, link)->line;
+        le_dls_Link_t* link2Ptr = le_dls_Peek(list2Ptr);
+
+        while (link2Ptr != NULL)
+        {
+            char* line2Ptr = CONTAINER_OF(link2Ptr, RspString_t, link)->line;
+            size_t len1 = strlen(line1Ptr);
+            size_t len2 = strlen(line2Ptr);
+            size_t len = (len1 < len2) ? len1 : len2;
+
+            if (strncmp(line1Ptr, line2Ptr, len) == 0)
+            {
+                return true;
+            }
+            link2Ptr = le_dls_PeekNext(list2Ptr, link2Ptr);
+        }
+        link1Ptr = le_dls_PeekNext(list1Ptr, link1Ptr);
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function is used to check if a command can be added to the command line being built with
+ * the commands in flight. The intermediate responses of the line must go to one command only.
+ *
+ * @return
+ *      - TRUE if the command can be added to the line
+ *      - FALSE otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CanJoinLine
+(
+    DeviceContext_t* interfacePtr,
+    AtCmd_t*         cmdPtr,
+    size_t           lineLen
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&interfacePtr->atCommandList);
+    AtCmd_t* firstCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+    uint32_t i;
+
+    // The command is added with a ';' and without its "AT"
+    if ((!IsBatchable(cmdPtr)) ||
+        (lineLen + strlen(cmdPtr->cmd) - 1 > LE_ATDEFS_COMMAND_MAX_LEN) ||
+        (!IsSameResponseList(&firstCmdPtr->expectResponseList, &cmdPtr->expectResponseList)))
+    {
+        return false;
+    }
+
+    for (i = 0; (i < interfacePtr->inFlightCount) && (linkPtr != NULL); i++)
+    {
+        AtCmd_t* lineCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+        if (IsResponseListOverlap(&lineCmdPtr->ExpectintermediateResponseList,
+                                  &cmdPtr->ExpectintermediateResponseList))
+        {
+            return false;
+        }
+        linkPtr = le_dls_PeekNext(&interfacePtr->atCommandList, linkPtr);
+    }
 
+    return true;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -961,18 +1392,17 @@ static void SendingState
                              //~strlen(smRef->curContext.atLine));
             int32_t newCRLF = parserPtr->idx-2;
             size_t lineSize = newCRLF - parserPtr->idxLastCrLf;
+            char* linePtr = (char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]);
+            uint32_t i;
 
-            if (CheckResponse((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]), lineSize,
+            if (CheckResponse(linePtr, lineSize,
                               &(cmdPtr->expectResponseList), &(cmdPtr->responseList),
                               cmdPtr->cmd))
             {
                 LE_DEBUG("Final command found");
 
-                le_dls_Pop(&interfacePtr->atCommandList);
-
-                cmdPtr->result = LE_OK;
                 StopTimer(cmdPtr);
-                le_sem_Post(cmdPtr->endSem);
+                CompleteInFlightCommands(interfacePtr, LE_OK);
 
                 UpdateTransitionManager(clientStatePtr,input,WaitingState);
                 // Send the next command
@@ -980,9 +1410,22 @@ static void SendingState
                 return;
             }
 
-            CheckResponse((char*)&(parserPtr->buffer[parserPtr->idxLastCrLf]), lineSize,
-                          &(cmdPtr->ExpectintermediateResponseList), &(cmdPtr->responseList),
-                          cmdPtr->cmd);
+            // Give the intermediate response to the first command of the line expecting it. The
+            // echo of the line starts with the first command.
+            for (i = 0; (i < interfacePtr->inFlightCount) && (linkPtr != NULL); i++)
+            {
+                AtCmd_t* lineCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+
+                if (CheckResponse(linePtr, lineSize,
+                                  &(lineCmdPtr->ExpectintermediateResponseList),
+                                  &(lineCmdPtr->responseList),
+                                  cmdPtr->cmd))
+                {
+                    break;
+                }
+
+                linkPtr = le_dls_PeekNext(&interfacePtr->atCommandList, linkPtr);
+            }
             break;
         }
         default:
@@ -1014,6 +1457,9 @@ static void WaitingState
     {
         case EVENT_SENDCMD:
         {
+            // Drop the commands which missed their deadline
+            CheckDeadlines(interfacePtr);
+
             // Send at command
             le_dls_Link_t* linkPtr = le_dls_Peek(&(interfacePtr->atCommandList));
 
@@ -1024,25 +1470,63 @@ static void WaitingState
             }
 
             AtCmd_t* cmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
+            uint32_t timeout = cmdPtr->timeout;
+
+            // Room for the command line and '\r'
+            char atCommand[LE_ATDEFS_COMMAND_MAX_BYTES+1];
+            size_t len = snprintf(atCommand, sizeof(atCommand), "%s", cmdPtr->cmd);
 
-            if (cmdPtr->timeout > 0)
+            interfacePtr->inFlightCount = 1;
+
+            // Concatenate the following commands which can share the line, without their "AT"
+            if (IsBatchable(cmdPtr))
             {
-                StartTimer(cmdPtr);
-            }
+                linkPtr = le_dls_PeekNext(&(interfacePtr->atCommandList), linkPtr);
 
-            uint32_t len = strlen(cmdPtr->cmd)+2;
-            char atCommand[len];
-            memset(atCommand, 0, len);
-            snprintf(atCommand, len, "%s\r", cmdPtr->cmd);
+                while (linkPtr != NULL)
+                {
+                    AtCmd_t* nextCmdPtr = CONTAINER_OF(linkPtr, AtCmd_t, link);
 
-            le_dev_Write(&(interfacePtr->device),
-                           (uint8_t*) atCommand,
-                           len-1);
+                    if (!CanJoinLine(interfacePtr, nextCmdPtr, len))
+                    {
+                        break;
+                    }
 
-            UpdateTransitionManager(clientStatePtr,input,SendingState);
+                    len += snprintf(atCommand + len, sizeof(atCommand) - len, ";%s",
+                                    nextCmdPtr->cmd + 2);
 
-            break;
-        }
+                    // The line ends at the longest timeout, 0 meaning no timeout
+                    if ((timeout > 0) && ((nextCmdPtr->timeout == 0) ||
+                                          (nextCmdPtr->timeout > timeout)))
+                    {
+                        timeout = nextCmdPtr->timeout;
+                    }
+
+                    interfacePtr->inFlightCount++;
+                    linkPtr = le_dls_PeekNext(&(interfacePtr->atCommandList), linkPtr);
+                }
+            }
+
+            if (interfacePtr->inFlightCount > 1)
+            {
+                LE_DEBUG("%d commands sent on one line", interfacePtr->inFlightCount);
+            }
+
+            if (timeout > 0)
+            {
+                StartTimer(cmdPtr, timeout);
+            }
+
+            atCommand[len++] = '\r';
+
+            le_dev_Write(&(interfacePtr->device),
+                           (uint8_t*) atCommand,
+                           len);
+
+            UpdateTransitionManager(clientStatePtr,input,SendingState);
+
+            break;
+        }
         case EVENT_PROCESSLINE:
         {
             RxData_t* parserPtr = &interfacePtr->rxParser.rxData;
@@ -1203,7 +1687,7 @@ static void ReleaseRspStringList
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function is to send a new AT command
+ * This function is to queue a new AT command, in the device thread
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -1214,11 +1698,22 @@ static void SendCommand
 )
 {
     DeviceContext_t* interfacePtr = param1Ptr;
+    AtCmd_t* cmdPtr = param2Ptr;
 
     if (interfacePtr)
     {
         ClientState_t* clientState = &interfacePtr->clientState;
-        (clientState->curState)(clientState,EVENT_SENDCMD);
+
+        InsertCommand(interfacePtr, cmdPtr);
+
+        if (clientState->curState == WaitingState)
+        {
+            (clientState->curState)(clientState,EVENT_SENDCMD);
+        }
+        else if (cmdPtr->deadline > 0)
+        {
+            CheckDeadlines(interfacePtr);
+        }
     }
 }
 
@@ -1357,7 +1852,7 @@ static void RemoveUnsolicited
  * @return pointer to the new AT Command reference
  */
 //--------------------------------------------------------------------------------------------------
-le_atClient_CmdRef_t le_atClient_Create
+static le_atClient_CmdRef_t Create
 (
     void
 )
@@ -1371,6 +1866,7 @@ le_atClient_CmdRef_t le_atClient_Create
     cmdPtr->expectResponseList              = LE_DLS_LIST_INIT;
     cmdPtr->textSize                        = 0;
     cmdPtr->timeout                         = LE_ATDEFS_COMMAND_DEFAULT_TIMEOUT;
+    cmdPtr->priority                        = LE_ATCLIENT_PRIORITY_NORMAL;
     cmdPtr->interfacePtr                    = NULL;
     cmdPtr->ref                             = le_ref_CreateRef(CmdRefMap, cmdPtr);
     cmdPtr->intermediateIndex               = 0;
@@ -1381,6 +1877,20 @@ le_atClient_CmdRef_t le_atClient_Create
     return cmdPtr->ref;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_Create(), see Create().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_Create
+(
+    le_atClient_ServerCmdRef_t serverCmdRef
+        ///< [IN] Server command reference
+)
+{
+    le_atClient_CreateRespond(serverCmdRef, Create());
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to set the device where the AT command will be sent.
@@ -1393,7 +1903,7 @@ le_atClient_CmdRef_t le_atClient_Create
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetDevice
+static le_result_t SetDevice
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1423,18 +1933,39 @@ le_result_t le_atClient_SetDevice
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetDevice(), see SetDevice().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetDevice
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    le_atClient_DeviceRef_t devRef
+        ///< [IN] Device where the AT command has to be sent
+)
+{
+    le_atClient_SetDeviceRespond(serverCmdRef, SetDevice(cmdRef, devRef));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to delete an AT command reference.
  *
  * @return
+ *      - LE_BUSY when the command is being sent
  *      - LE_OK when function succeed
  *
  * @note If the AT Command reference is invalid, a fatal error occurs,
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_Delete
+static le_result_t Delete
 (
     le_atClient_CmdRef_t cmdRef
         ///< [IN] AT Command
@@ -1447,11 +1978,34 @@ le_result_t le_atClient_Delete
         return LE_BAD_PARAMETER;
     }
 
+    if (cmdPtr->isSending)
+    {
+        LE_ERROR("Command %s is being sent", cmdPtr->cmd);
+        return LE_BUSY;
+    }
+
     le_mem_Release(cmdPtr);
 
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_Delete(), see Delete().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_Delete
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef
+        ///< [IN] AT Command
+)
+{
+    le_atClient_DeleteRespond(serverCmdRef, Delete(cmdRef));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to set the AT command string to be sent.
@@ -1463,7 +2017,7 @@ le_result_t le_atClient_Delete
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetCommand
+static le_result_t SetCommand
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1483,6 +2037,26 @@ le_result_t le_atClient_SetCommand
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetCommand(), see SetCommand().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetCommand
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    const char* commandPtr
+        ///< [IN] Set Command
+)
+{
+    le_atClient_SetCommandRespond(serverCmdRef, SetCommand(cmdRef, commandPtr));
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1498,7 +2072,7 @@ le_result_t le_atClient_SetCommand
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetIntermediateResponse
+static le_result_t SetIntermediateResponse
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1554,6 +2128,26 @@ le_result_t le_atClient_SetIntermediateResponse
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetIntermediateResponse(), see SetIntermediateResponse().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetIntermediateResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    const char* intermediatePtr
+        ///< [IN] Set Intermediate
+)
+{
+    le_atClient_SetIntermediateResponseRespond(serverCmdRef, SetIntermediateResponse(cmdRef, intermediatePtr));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to set the final response(s) of the AT command execution.
@@ -1568,7 +2162,7 @@ le_result_t le_atClient_SetIntermediateResponse
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetFinalResponse
+static le_result_t SetFinalResponse
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1616,6 +2210,26 @@ le_result_t le_atClient_SetFinalResponse
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetFinalResponse(), see SetFinalResponse().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetFinalResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    const char* responsePtr
+        ///< [IN] Set Response
+)
+{
+    le_atClient_SetFinalResponseRespond(serverCmdRef, SetFinalResponse(cmdRef, responsePtr));
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1629,7 +2243,7 @@ le_result_t le_atClient_SetFinalResponse
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetText
+static le_result_t SetText
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1656,6 +2270,26 @@ le_result_t le_atClient_SetText
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetText(), see SetText().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetText
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    const char* textPtr
+        ///< [IN] The AT Data to send
+)
+{
+    le_atClient_SetTextRespond(serverCmdRef, SetText(cmdRef, textPtr));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to set the timeout of the AT command execution.
@@ -1667,7 +2301,7 @@ le_result_t le_atClient_SetText
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetTimeout
+static le_result_t SetTimeout
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1689,21 +2323,161 @@ le_result_t le_atClient_SetTimeout
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to send an AT Command and wait for response.
+ * Server function of le_atClient_SetTimeout(), see SetTimeout().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetTimeout
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    uint32_t timer
+        ///< [IN] Set Timer
+)
+{
+    le_atClient_SetTimeoutRespond(serverCmdRef, SetTimeout(cmdRef, timer));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to set the priority of the AT command in the queue of its device.
+ * The default priority is LE_ATCLIENT_PRIORITY_NORMAL.
  *
  * @return
- *      - LE_FAULT when function failed
- *      - LE_TIMEOUT when a timeout occur
+ *      - LE_BAD_PARAMETER when the priority is invalid
  *      - LE_OK when function succeed
  *
  * @note If the AT Command reference is invalid, a fatal error occurs,
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_Send
+static le_result_t SetPriority
 (
-    le_atClient_CmdRef_t cmdRef
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    le_atClient_Priority_t priority
+        ///< [IN] Priority
+)
+{
+    AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
+    if (cmdPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", cmdRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    switch (priority)
+    {
+        case LE_ATCLIENT_PRIORITY_LOW:
+        case LE_ATCLIENT_PRIORITY_NORMAL:
+        case LE_ATCLIENT_PRIORITY_HIGH:
+            break;
+
+        default:
+            LE_ERROR("Invalid priority %d", priority);
+            return LE_BAD_PARAMETER;
+    }
+
+    cmdPtr->priority = priority;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetPriority(), see SetPriority().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetPriority
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    le_atClient_Priority_t priority
+        ///< [IN] Priority
+)
+{
+    le_atClient_SetPriorityRespond(serverCmdRef, SetPriority(cmdRef, priority));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to set the maximum time the AT command can wait in the queue of its
+ * device before being sent. The command ends with LE_TIMEOUT if it is not sent in time.
+ * The default value, 0, means no deadline.
+ *
+ * @return
+ *      - LE_OK when function succeed
+ *
+ * @note If the AT Command reference is invalid, a fatal error occurs,
+ *       the function won't return.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetDeadline
+(
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    uint32_t deadline
+        ///< [IN] Deadline in milliseconds, 0 for none.
+)
+{
+    AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
+    if (cmdPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", cmdRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    cmdPtr->deadline = deadline;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetDeadline(), see SetDeadline().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetDeadline
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    uint32_t deadline
+        ///< [IN] Deadline in milliseconds, 0 for none.
+)
+{
+    le_atClient_SetDeadlineRespond(serverCmdRef, SetDeadline(cmdRef, deadline));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to allow the AT command to be concatenated with other commands on
+ * the same command line. Not allowed by default.
+ *
+ * @return
+ *      - LE_OK when function succeed
+ *
+ * @note If the AT Command reference is invalid, a fatal error occurs,
+ *       the function won't return.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetBatchable
+(
+    le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
+
+    bool batchable
+        ///< [IN] true to allow the command to share a line
 )
 {
     AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
@@ -1713,42 +2487,194 @@ le_result_t le_atClient_Send
         return LE_BAD_PARAMETER;
     }
 
+    cmdPtr->isBatchable = batchable;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_SetBatchable(), see SetBatchable().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SetBatchable
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    bool batchable
+        ///< [IN] true to allow the command to share a line
+)
+{
+    le_atClient_SetBatchableRespond(serverCmdRef, SetBatchable(cmdRef, batchable));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to check an AT command and prepare it to be queued on its device.
+ *
+ * @return
+ *      - LE_FAULT when function failed
+ *      - LE_OK when function succeed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PrepareCommand
+(
+    AtCmd_t* cmdPtr
+)
+{
     if (cmdPtr->interfacePtr == NULL)
     {
         LE_ERROR("no device set");
         return LE_FAULT;
     }
 
+    if (cmdPtr->isSending)
+    {
+        LE_ERROR("command %s is already being sent", cmdPtr->cmd);
+        return LE_FAULT;
+    }
+
     if (le_dls_NumLinks(&cmdPtr->expectResponseList) == 0)
     {
         LE_ERROR("no final responses set");
         return LE_FAULT;
     }
 
-    if (le_dls_NumLinks(&cmdPtr->ExpectintermediateResponseList) == 0)
+    // A batchable command only gets the intermediate responses it expects
+    if ((le_dls_NumLinks(&cmdPtr->ExpectintermediateResponseList) == 0) &&
+        (!cmdPtr->isBatchable))
     {
-        if (le_atClient_SetIntermediateResponse(cmdRef,"") != LE_OK)
+        if (SetIntermediateResponse(cmdPtr->ref,"") != LE_OK)
         {
             LE_ERROR("Can't set intermediate rsp");
             return LE_FAULT;
         }
     }
 
-    cmdPtr->endSem = le_sem_Create("ResultSignal",0);
-    le_dls_Queue(&cmdPtr->interfacePtr->atCommandList, &cmdPtr->link);
-
     ReleaseRspStringList(&cmdPtr->responseList);
 
+    if (cmdPtr->deadline > 0)
+    {
+        le_clk_Time_t deadline = { .sec = cmdPtr->deadline / 1000,
+                                   .usec = (cmdPtr->deadline % 1000) * 1000 };
+
+        cmdPtr->expiryTime = le_clk_Add(le_clk_GetRelativeTime(), deadline);
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to queue a prepared AT command on its device. CommandDone() is
+ * called in the service thread when the command ends.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueCommand
+(
+    AtCmd_t* cmdPtr
+)
+{
+    cmdPtr->isSending = true;
+
+    // Keep the command until it ends, even if the client session is closed
+    le_mem_AddRef(cmdPtr);
+
     le_event_QueueFunctionToThread(cmdPtr->interfacePtr->threadRef,
-                                                SendCommand,
-                                                (void*) cmdPtr->interfacePtr,
-                                                (void*) NULL);
+                                   SendCommand,
+                                   (void*) cmdPtr->interfacePtr,
+                                   (void*) cmdPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to send an AT Command and wait for response.
+ *
+ * The service thread doesn't wait: the response is sent to the client by CommandDone(), once the
+ * final response is detected or the timeout reached.
+ *
+ * @return
+ *      - LE_FAULT when function failed
+ *      - LE_TIMEOUT when a timeout occur
+ *      - LE_OK when function succeed
+ *
+ * @note If the AT Command reference is invalid, a fatal error occurs,
+ *       the function won't return.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_Send
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
 
-    le_sem_Wait(cmdPtr->endSem);
+    le_atClient_CmdRef_t cmdRef
+        ///< [IN] AT Command
+)
+{
+    AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
+    if (cmdPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", cmdRef);
+        le_atClient_SendRespond(serverCmdRef, LE_BAD_PARAMETER);
+        return;
+    }
 
-    le_sem_Delete(cmdPtr->endSem);
+    if (PrepareCommand(cmdPtr) != LE_OK)
+    {
+        le_atClient_SendRespond(serverCmdRef, LE_FAULT);
+        return;
+    }
 
-    return cmdPtr->result;
+    cmdPtr->serverCmdRef = serverCmdRef;
+    QueueCommand(cmdPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to send an AT Command without waiting for the response. The handler
+ * is called once the final response is detected, or the timeout reached.
+ *
+ * @note If the AT Command reference is invalid, a fatal error occurs,
+ *       the function won't return.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_SendAsync
+(
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    le_atClient_CommandHandlerFunc_t handlerPtr,
+        ///< [IN] Handler called at the end of the command
+
+    void* contextPtr
+        ///< [IN] Handler context
+)
+{
+    AtCmd_t* cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
+    if (cmdPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid reference (%p) provided!", cmdRef);
+        return;
+    }
+
+    if (handlerPtr == NULL)
+    {
+        LE_KILL_CLIENT("Handler function is NULL!");
+        return;
+    }
+
+    if (PrepareCommand(cmdPtr) != LE_OK)
+    {
+        handlerPtr(cmdRef, LE_FAULT, contextPtr);
+        return;
+    }
+
+    cmdPtr->handlerPtr = handlerPtr;
+    cmdPtr->contextPtr = contextPtr;
+    QueueCommand(cmdPtr);
 }
 
 
@@ -1764,7 +2690,7 @@ le_result_t le_atClient_Send
  *       the function won't return.
 */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_GetFirstIntermediateResponse
+static le_result_t GetFirstIntermediateResponse
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1801,6 +2727,30 @@ le_result_t le_atClient_GetFirstIntermediateResponse
     return LE_FAULT;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_GetFirstIntermediateResponse(), see GetFirstIntermediateResponse().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_GetFirstIntermediateResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    size_t intermediateRspSize
+        ///< [IN] Size of the client buffer
+)
+{
+    char rsp[LE_ATDEFS_RESPONSE_MAX_BYTES] = "";
+    size_t rspSize = (intermediateRspSize < sizeof(rsp)) ? intermediateRspSize : sizeof(rsp);
+    le_result_t result = GetFirstIntermediateResponse(cmdRef, rsp, rspSize);
+
+    le_atClient_GetFirstIntermediateResponseRespond(serverCmdRef, result, rsp);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1814,7 +2764,7 @@ le_result_t le_atClient_GetFirstIntermediateResponse
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_GetNextIntermediateResponse
+static le_result_t GetNextIntermediateResponse
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1850,6 +2800,30 @@ le_result_t le_atClient_GetNextIntermediateResponse
     return LE_NOT_FOUND;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_GetNextIntermediateResponse(), see GetNextIntermediateResponse().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_GetNextIntermediateResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    size_t intermediateRspSize
+        ///< [IN] Size of the client buffer
+)
+{
+    char rsp[LE_ATDEFS_RESPONSE_MAX_BYTES] = "";
+    size_t rspSize = (intermediateRspSize < sizeof(rsp)) ? intermediateRspSize : sizeof(rsp);
+    le_result_t result = GetNextIntermediateResponse(cmdRef, rsp, rspSize);
+
+    le_atClient_GetNextIntermediateResponseRespond(serverCmdRef, result, rsp);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function is used to get the final response
@@ -1862,7 +2836,7 @@ le_result_t le_atClient_GetNextIntermediateResponse
  *       the function won't return.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_GetFinalResponse
+static le_result_t GetFinalResponse
 (
     le_atClient_CmdRef_t cmdRef,
         ///< [IN] AT Command
@@ -1898,6 +2872,30 @@ le_result_t le_atClient_GetFinalResponse
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_GetFinalResponse(), see GetFinalResponse().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_GetFinalResponse
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_CmdRef_t cmdRef,
+        ///< [IN] AT Command
+
+    size_t finalRspSize
+        ///< [IN] Size of the client buffer
+)
+{
+    char rsp[LE_ATDEFS_RESPONSE_MAX_BYTES] = "";
+    size_t rspSize = (finalRspSize < sizeof(rsp)) ? finalRspSize : sizeof(rsp);
+    le_result_t result = GetFinalResponse(cmdRef, rsp, rspSize);
+
+    le_atClient_GetFinalResponseRespond(serverCmdRef, result, rsp);
+}
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1919,10 +2917,10 @@ le_result_t le_atClient_GetFinalResponse
  *
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_SetCommandAndSend
+void le_atClient_SetCommandAndSend
 (
-    le_atClient_CmdRef_t* cmdRefPtr,
-        ///< [OUT] Command reference
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
 
     le_atClient_DeviceRef_t devRef,
         ///< [IN] Device reference
@@ -1940,73 +2938,72 @@ le_result_t le_atClient_SetCommandAndSend
         ///< [IN] Timeout
 )
 {
-    if (cmdRefPtr  == NULL)
-    {
-        LE_KILL_CLIENT("cmdRefPtr is NULL.");
-        return LE_FAULT;
-    }
-
     le_result_t res = LE_FAULT;
+    le_atClient_CmdRef_t cmdRef = Create();
+    AtCmd_t* cmdPtr;
 
-    *cmdRefPtr = le_atClient_Create();
-    LE_DEBUG("New command ref (%p) created",*cmdRefPtr);
-    if(*cmdRefPtr == NULL)
+    LE_DEBUG("New command ref (%p) created", cmdRef);
+    if (cmdRef == NULL)
     {
-        return LE_FAULT;
+        le_atClient_SetCommandAndSendRespond(serverCmdRef, LE_FAULT, NULL);
+        return;
     }
 
-    res = le_atClient_SetCommand(*cmdRefPtr,commandPtr);
+    res = SetCommand(cmdRef, commandPtr);
     if (res != LE_OK)
     {
-        le_atClient_Delete(*cmdRefPtr);
         LE_ERROR("Failed to set the command !");
-        return res;
+        goto error;
     }
 
-    res = le_atClient_SetDevice(*cmdRefPtr,devRef);
+    res = SetDevice(cmdRef, devRef);
     if (res != LE_OK)
     {
-        le_atClient_Delete(*cmdRefPtr);
         LE_ERROR("Failed to set the command !");
-        return res;
+        goto error;
     }
 
-    res = le_atClient_SetIntermediateResponse(*cmdRefPtr,interRespPtr);
+    res = SetIntermediateResponse(cmdRef, interRespPtr);
     if (res != LE_OK)
     {
-        le_atClient_Delete(*cmdRefPtr);
         LE_ERROR("Failed to set intermediate response !");
-        return res;
+        goto error;
     }
 
-    res = le_atClient_SetFinalResponse(*cmdRefPtr,finalRespPtr);
+    res = SetFinalResponse(cmdRef, finalRespPtr);
     if (res != LE_OK)
     {
-        le_atClient_Delete(*cmdRefPtr);
         LE_ERROR("Failed to set final response !");
-        return res;
+        goto error;
     }
 
-    if(timeout > 0)
+    if (timeout > 0)
     {
-        res = le_atClient_SetTimeout(*cmdRefPtr, timeout);
+        res = SetTimeout(cmdRef, timeout);
         if (res != LE_OK)
         {
-            le_atClient_Delete(*cmdRefPtr);
             LE_ERROR("Failed to send !");
-            return res;
+            goto error;
         }
     }
 
-    res = le_atClient_Send(*cmdRefPtr);
+    cmdPtr = le_ref_Lookup(CmdRefMap, cmdRef);
+    res = PrepareCommand(cmdPtr);
     if (res != LE_OK)
     {
-        le_atClient_Delete(*cmdRefPtr);
         LE_ERROR("Failed to send !");
-        return res;
+        goto error;
     }
 
-    return res;
+    // The command is deleted by CommandDone() if it fails
+    cmdPtr->isSetAndSend = true;
+    cmdPtr->serverCmdRef = serverCmdRef;
+    QueueCommand(cmdPtr);
+    return;
+
+error:
+    Delete(cmdRef);
+    le_atClient_SetCommandAndSendRespond(serverCmdRef, res, cmdRef);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2121,6 +3118,20 @@ static void CloseSessionEventHandler
         {
             if (sessionRef == cmdPtr->sessionRef)
             {
+                // A command being sent is released when it ends. The one-shot handler of
+                // le_atClient_SendAsync() is not called then, but it holds data of the generated
+                // server code which is only freed by a call, so call it now: its message to the
+                // closed session is discarded.
+                if (cmdPtr->handlerPtr)
+                {
+                    le_atClient_CommandHandlerFunc_t handlerPtr = cmdPtr->handlerPtr;
+
+                    cmdPtr->handlerPtr = NULL;
+                    handlerPtr(cmdPtr->ref, LE_TERMINATED, cmdPtr->contextPtr);
+                }
+
+                // The command is released here, not by CommandDone()
+                cmdPtr->isSessionClosed = true;
                 le_mem_Release(cmdPtr);
             }
         }
@@ -2147,7 +3158,7 @@ static void CloseSessionEventHandler
  * @return reference on a device context
  */
 //--------------------------------------------------------------------------------------------------
-le_atClient_DeviceRef_t le_atClient_Start
+static le_atClient_DeviceRef_t Start
 (
     int32_t              fd          ///< The file descriptor
 )
@@ -2193,6 +3204,23 @@ le_atClient_DeviceRef_t le_atClient_Start
     return newInterfacePtr->ref;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_Start(), see Start().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_Start
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    int32_t fd
+        ///< [IN] The file descriptor
+)
+{
+    le_atClient_StartRespond(serverCmdRef, Start(fd));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to stop the ATClient session on the specified device.
@@ -2202,7 +3230,7 @@ le_atClient_DeviceRef_t le_atClient_Start
  *      - LE_OK when function succeed
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t le_atClient_Stop
+static le_result_t Stop
 (
     le_atClient_DeviceRef_t devRef
 )
@@ -2220,6 +3248,22 @@ le_result_t le_atClient_Stop
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server function of le_atClient_Stop(), see Stop().
+ */
+//--------------------------------------------------------------------------------------------------
+void le_atClient_Stop
+(
+    le_atClient_ServerCmdRef_t serverCmdRef,
+        ///< [IN] Server command reference
+
+    le_atClient_DeviceRef_t devRef
+)
+{
+    le_atClient_StopRespond(serverCmdRef, Stop(devRef));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The COMPONENT_INIT intialize the AT Client Component when Legato start
@@ -2228,6 +3272,8 @@ le_result_t le_atClient_Stop
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
 {
+    MainThreadRef = le_thread_GetCurrent();
+
     // Device pool allocation
     DevicesPool = le_mem_CreatePool("AtClientDevicesPool",sizeof(DeviceContext_t));
     le_mem_ExpandPool(DevicesPool,DEVICE_POOL_SIZE);
@@ -50,6 +50,15 @@
 //--------------------------------------------------------------------------------------------------
 #define RSP_POOL_SIZE       2
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of typical-length responses created up front.  Responses are only allocated to store
+ * unsolicited responses while a command is in progress, so this covers a burst of them without
+ * growing the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RSP_SMALL_POOL_SIZE 16
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Typical length of a response string
@@ -57,6 +66,21 @@
 //--------------------------------------------------------------------------------------------------
 #define RSP_STRING_TYPICAL_BYTES 24
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the output buffer of a device.  Must hold at least one response.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OUTPUT_BUFFER_BYTES (4 * (LE_ATDEFS_RESPONSE_MAX_BYTES + 4))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum time unsolicited responses and the echo wait in the output buffer of a device before
+ * being written, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OUTPUT_FLUSH_DEADLINE_MS 10
+
 //--------------------------------------------------------------------------------------------------
 /**
  * User-defined error strings pool size
@@ -691,6 +715,32 @@ typedef struct
 Text_t;
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Output buffer of a device.
+ *
+ * Responses are gathered here and written together when an intermediate or final response is
+ * sent, when the characters received from the device have been processed, when the buffer is full,
+ * or when the oldest response has waited OUTPUT_FLUSH_DEADLINE_MS, whichever comes first.
+ *
+ * The buffer is filled by the thread that opened the device.  Other threads write the pending
+ * output before their own data, under the lock, so that they don't overtake it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                    buf[OUTPUT_BUFFER_BYTES];             ///< pending output
+    size_t                  len;                                  ///< pending output length
+    bool                    isAtFlushNeeded;                      ///< pending output holds a final
+                                                                  ///< or unsolicited response
+    le_timer_Ref_t          flushTimer;                           ///< flush deadline timer
+    le_thread_Ref_t         threadRef;                            ///< thread owning the buffer
+    le_mutex_Ref_t          lock;                                 ///< protects buf, len and
+                                                                  ///< isAtFlushNeeded
+}
+OutputBuffer_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Device context structure.
@@ -714,6 +764,8 @@ typedef struct
                                                                   ///< over
     bool                    isFirstIntermediate;                  ///< is first intermediate sent
     RspState_t              rspState;                             ///< sending response state
+    OutputBuffer_t          output;                               ///< responses waiting to be
+                                                                  ///< written on the device
 #if !MK_CONFIG_DISABLE_AT_BRIDGE
     le_atServer_BridgeRef_t bridgeRef;                            ///< bridge reference
 #endif
@@ -1081,10 +1133,152 @@ static void AtCmdPoolDestructor
     le_ref_DeleteRef(SubscribedCmdRefMap, cmdPtr->cmdRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the pending output of a device, followed by some more data, in a single write.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_FAULT         The function failed to write all the data.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FlushOutput
+(
+    DeviceContext_t* devPtr,
+    const char* dataPtr,        ///< [IN] Data to write after the pending output (can be NULL)
+    size_t dataLen,             ///< [IN] Length of the data
+    bool isAtFlushNeeded        ///< [IN] The data holds a final or unsolicited response
+)
+{
+    OutputBuffer_t* outputPtr = &devPtr->output;
+    le_result_t result = LE_OK;
+    int32_t written;
+
+    // The flush timer can only be handled by the thread owning the buffer.  If it expires after
+    // another thread wrote the pending output, there is nothing left to write.
+    if (le_thread_GetCurrent() == outputPtr->threadRef)
+    {
+        le_timer_Stop(outputPtr->flushTimer);
+    }
+
+    le_mutex_Lock(outputPtr->lock);
+
+    size_t totalLen = outputPtr->len + dataLen;
+    if (0 == totalLen)
+    {
+        le_mutex_Unlock(outputPtr->lock);
+        return LE_OK;
+    }
+
+#if LE_CONFIG_LINUX
+    struct iovec iov[2] =
+    {
+        { .iov_base = outputPtr->buf, .iov_len = outputPtr->len },
+        { .iov_base = (void*) dataPtr, .iov_len = dataLen }
+    };
+
+    written = le_dev_WriteV(&devPtr->device, iov, NUM_ARRAY_MEMBERS(iov));
+#else
+    written = le_dev_Write(&devPtr->device, (uint8_t*) outputPtr->buf, outputPtr->len);
+    if ((written == outputPtr->len) && dataLen)
+    {
+        written += le_dev_Write(&devPtr->device, (uint8_t*) dataPtr, dataLen);
+    }
+#endif
+
+    outputPtr->len = 0;
+
+#ifdef LE_AT_FLUSH
+    if (outputPtr->isAtFlushNeeded || isAtFlushNeeded)
+    {
+        le_fd_Ioctl(devPtr->device.fd, LE_AT_FLUSH, NULL);
+    }
+#endif
+    outputPtr->isAtFlushNeeded = false;
+
+    le_mutex_Unlock(outputPtr->lock);
+
+    if (written < totalLen)
+    {
+        LE_ERROR("Failed to send data");
+        result = LE_FAULT;
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write data on a device, or add it to the output buffer of the device.
+ *
+ * @return
+ *      - LE_OK            The function succeeded.
+ *      - LE_FAULT         The function failed to write the data.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteOutput
+(
+    DeviceContext_t* devPtr,
+    const char* dataPtr,        ///< [IN] Data to write
+    size_t dataLen,             ///< [IN] Length of the data
+    bool flush,                 ///< [IN] Write the data (and the pending output) right away
+    bool isAtFlushNeeded        ///< [IN] The data holds a final or unsolicited response
+)
+{
+    OutputBuffer_t* outputPtr = &devPtr->output;
+
+    // The output buffer belongs to the thread that opened the device.  Other threads write the
+    // pending output and their data right away.
+    if (flush || (le_thread_GetCurrent() != outputPtr->threadRef))
+    {
+        return FlushOutput(devPtr, dataPtr, dataLen, isAtFlushNeeded);
+    }
+
+    le_mutex_Lock(outputPtr->lock);
+
+    if (dataLen > sizeof(outputPtr->buf) - outputPtr->len)
+    {
+        le_mutex_Unlock(outputPtr->lock);
+        return FlushOutput(devPtr, dataPtr, dataLen, isAtFlushNeeded);
+    }
+
+    memcpy(outputPtr->buf + outputPtr->len, dataPtr, dataLen);
+    outputPtr->len += dataLen;
+    outputPtr->isAtFlushNeeded = outputPtr->isAtFlushNeeded || isAtFlushNeeded;
+
+    le_mutex_Unlock(outputPtr->lock);
+
+    if (!le_timer_IsRunning(outputPtr->flushTimer))
+    {
+        le_timer_Start(outputPtr->flushTimer);
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when output has been pending in the output buffer of a device for too long.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    DeviceContext_t* devPtr = le_timer_GetContextPtr(timerRef);
+
+    FlushOutput(devPtr, NULL, 0, false);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send a response on the opened device.
  *
+ * Intermediate responses are written right away.  Other responses are added to the output buffer
+ * of the device, which is written by FlushOutput().
+ *
  * @return
  *      - LE_OK            The function succeeded.
  *      - LE_FAULT         The function failed to send response.
@@ -1096,7 +1290,6 @@ static le_result_t SendRspString
     const char* rspPtr
 )
 {
-    ssize_t strLenWritted;
     size_t stringLen;
 
     char string[LE_ATDEFS_RESPONSE_MAX_BYTES+4] = {0};
@@ -1113,24 +1306,11 @@ static le_result_t SendRspString
     }
 
     stringLen = strnlen(string, LE_ATDEFS_RESPONSE_MAX_BYTES);
-    strLenWritted = le_dev_Write(&devPtr->device, (uint8_t*) string, stringLen);
-
-#ifdef LE_AT_FLUSH
-    if (devPtr->rspState != AT_RSP_INTERMEDIATE)
-    {
-        le_fd_Ioctl(devPtr->device.fd, LE_AT_FLUSH, NULL);
-    }
-#endif
 
-    if(strLenWritted < stringLen)
-    {
-        LE_ERROR("Failed to send data");
-        return LE_FAULT;
-    }
-    else
-    {
-        return LE_OK;
-    }
+    // The final response is written by SendFinalRsp() with the unsolicited responses that waited
+    // for it, or once the received characters have been processed.
+    return WriteOutput(devPtr, string, stringLen, (devPtr->rspState == AT_RSP_INTERMEDIATE),
+                       (devPtr->rspState != AT_RSP_INTERMEDIATE));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1388,6 +1568,13 @@ end_processing:
         le_mem_Release(rspStringPtr);
     }
 
+    // Write the whole response to the command, and the unsolicited responses that were waiting
+    // for it, at once.
+    if (LE_OK != FlushOutput(devPtr, NULL, 0, false))
+    {
+        res = LE_FAULT;
+    }
+
     return res;
 }
 
@@ -1403,21 +1590,18 @@ end_processing:
 static le_result_t SendIntermediateRsp
 (
     DeviceContext_t* devPtr,
-    RspString_t* rspStringPtr
+    const char* rspPtr
 )
 {
-    le_result_t res;
-
-    if (rspStringPtr == NULL)
+    if (rspPtr == NULL)
     {
-        LE_ERROR("Bad rspStringPtr");
+        LE_ERROR("Bad rspPtr");
         return LE_FAULT;
     }
 
     if (devPtr == NULL)
     {
         LE_ERROR("Bad devPtr");
-        le_mem_Release(rspStringPtr);
         return LE_FAULT;
     }
 
@@ -1428,37 +1612,58 @@ static le_result_t SendIntermediateRsp
         (devPtr->cmdParser.currentCmdPtr && !((devPtr->cmdParser.currentCmdPtr)->processing)))
     {
         LE_ERROR("Command not processing anymore");
-        le_mem_Release(rspStringPtr);
         return LE_FAULT;
     }
 
-    res = SendRspString(devPtr, rspStringPtr->resp);
-    le_mem_Release(rspStringPtr);
-    return res;
+    return SendRspString(devPtr, rspPtr);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate and initialize a new unsolicited response structure
+ */
+//--------------------------------------------------------------------------------------------------
+static RspString_t* CreateResponse
+(
+    const char* rspStr
+)
+{
+    size_t rspLen = strlen(rspStr);
+
+    RspString_t* rspStringPtr = le_mem_ForceVarAlloc(RspStringPool,
+                                                     rspLen + sizeof(RspString_t) + 1);
+    memset(rspStringPtr, 0, sizeof(RspString_t));
+    le_utf8_Copy(rspStringPtr->resp, rspStr,
+                 le_mem_GetBlockSize(rspStringPtr) - sizeof(RspString_t), NULL);
+
+    return rspStringPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send an unsolicited response on the opened device.
  *
+ * The response is only copied to the pool if it has to wait for the end of the command in
+ * progress.
+ *
  */
 //--------------------------------------------------------------------------------------------------
 static void SendUnsolRsp
 (
     DeviceContext_t* devPtr,
-    RspString_t* rspStringPtr
+    const char* rspPtr
 )
 {
-    if (rspStringPtr == NULL)
+    if (rspPtr == NULL)
     {
-        LE_ERROR("Bad rspStringPtr");
+        LE_ERROR("Bad rspPtr");
         return;
     }
 
     if (devPtr == NULL)
     {
         LE_ERROR("Bad devPtr");
-        le_mem_Release(rspStringPtr);
         return;
     }
 
@@ -1466,11 +1671,12 @@ static void SendUnsolRsp
 
     if (!devPtr->processing && !devPtr->suspended)
     {
-        SendRspString(devPtr, rspStringPtr->resp);
-        le_mem_Release(rspStringPtr);
+        SendRspString(devPtr, rspPtr);
     }
     else
     {
+        RspString_t* rspStringPtr = CreateResponse(rspPtr);
+
         le_dls_Queue(&devPtr->unsolicitedList, &(rspStringPtr->link));
     }
 }
@@ -2683,13 +2889,14 @@ static void ReceiveCmd
     // Echo is activated
     if (devPtr->echo)
     {
-        le_dev_Write(&devPtr->device,
-                    (uint8_t *)(devPtr->currentCmd + devPtr->indexRead),
-                    size);
+        WriteOutput(devPtr, devPtr->currentCmd + devPtr->indexRead, size, false, false);
     }
 
     devPtr->indexRead += size;
     ParseBuffer(devPtr);
+
+    // Write the echo and the responses to what was received at once.
+    FlushOutput(devPtr, NULL, 0, false);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2945,28 +3152,6 @@ __attribute__((unused)) static void RxNewData
     }
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Allocate and initialize a new unsolicited response structure
- */
-//--------------------------------------------------------------------------------------------------
-static RspString_t* CreateResponse
-(
-    const char* rspStr
-)
-{
-    size_t rspLen = strlen(rspStr);
-
-    RspString_t* rspStringPtr = le_mem_ForceVarAlloc(RspStringPool,
-                                                     rspLen + sizeof(RspString_t) + 1);
-    memset(rspStringPtr, 0, sizeof(RspString_t));
-    le_utf8_Copy(rspStringPtr->resp, rspStr,
-                 le_mem_GetBlockSize(rspStringPtr) - sizeof(RspString_t), NULL);
-
-    return rspStringPtr;
-}
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Send unsolicited response.
@@ -2985,9 +3170,7 @@ static le_result_t SendUnsolicitedResponse
         return LE_FAULT;
     }
 
-    RspString_t* rspStringPtr = CreateResponse(unsolRsp);
-
-    SendUnsolRsp(devPtr, rspStringPtr);
+    SendUnsolRsp(devPtr, unsolRsp);
 
     return LE_OK;
 }
@@ -3024,6 +3207,10 @@ static le_result_t CloseServer
 
     le_dev_DeleteFdMonitoring(&devPtr->device);
 
+    FlushOutput(devPtr, NULL, 0, false);
+    le_timer_Delete(devPtr->output.flushTimer);
+    le_mutex_Delete(devPtr->output.lock);
+
 #if LE_CONFIG_LINUX
     if (le_fd_Close(devPtr->device.fd))
     {
@@ -3170,6 +3357,9 @@ le_result_t le_atServer_Suspend
         return LE_BAD_PARAMETER;
     }
 
+    // Responses sent before entering data mode (e.g. CONNECT) must not be mixed with the data.
+    FlushOutput(devPtr, NULL, 0, false);
+
     le_dev_DisableFdMonitoring(&devPtr->device, AT_EVENTS);
     devPtr->suspended = true;
 
@@ -3353,6 +3543,13 @@ le_atServer_DeviceRef_t le_atServer_Open
     devPtr->ref = le_ref_CreateRef(DevicesRefMap, devPtr);
     devPtr->suspended = false;
 
+    devPtr->output.flushTimer = le_timer_Create("AtServerFlush");
+    le_timer_SetMsInterval(devPtr->output.flushTimer, OUTPUT_FLUSH_DEADLINE_MS);
+    le_timer_SetHandler(devPtr->output.flushTimer, FlushTimerHandler);
+    le_timer_SetContextPtr(devPtr->output.flushTimer, devPtr);
+    devPtr->output.threadRef = le_thread_GetCurrent();
+    devPtr->output.lock = le_mutex_CreateNonRecursive("AtServerOutput");
+
     LE_INFO("created device fd=%x", fd);
 
     return devPtr->ref;
@@ -3914,9 +4111,7 @@ le_result_t le_atServer_SendIntermediateResponse
         return LE_FAULT;
     }
 
-    RspString_t* rspStringPtr = CreateResponse(intermediateRspPtr);
-
-    return SendIntermediateRsp(devPtr, rspStringPtr);
+    return SendIntermediateRsp(devPtr, intermediateRspPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -4485,7 +4680,7 @@ le_result_t le_atServer_GetTextAsync
     devPtr->text.cmdRef = cmdRef;
 
     // @TODO: Rework the write operation if this function is ever needed for RTOS
-    le_dev_Write(&devPtr->device, (uint8_t *)TEXT_PROMPT, TEXT_PROMPT_LEN);
+    WriteOutput(devPtr, TEXT_PROMPT, TEXT_PROMPT_LEN, true, false);
 
     return LE_OK;
 #else
@@ -4540,7 +4735,8 @@ COMPONENT_INIT
                                           sizeof(RspString_t) + LE_ATDEFS_RESPONSE_MAX_BYTES);
     RspStringPool = le_mem_CreateReducedPool(RspStringPool,
                                              "RspSmallStringPool",
-                                             0, sizeof(RspString_t) + RSP_STRING_TYPICAL_BYTES);
+                                             RSP_SMALL_POOL_SIZE,
+                                             sizeof(RspString_t) + RSP_STRING_TYPICAL_BYTES);
 
 #if LE_CONFIG_ATSERVER_USER_ERRORS
     // User-defined errors pool allocation
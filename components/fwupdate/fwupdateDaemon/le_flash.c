@@ -8,6 +8,7 @@
  */
 #include "legato.h"
 #include "interfaces.h"
+#include <poll.h>
 #include "pa_fwupdate.h"
 #include "pa_flash.h"
 
@@ -18,6 +19,20 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_PARTITION_REF             18
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to wait for the file descriptor to be readable or writable when streaming, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STREAM_TIMEOUT_MS             30000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bad blocks skipped while writing one block from a file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STREAM_MAX_BAD_BLOCK_RETRIES  8
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event ID on bad image notification.
@@ -102,6 +117,13 @@ static le_hashmap_Ref_t RequestHashMap = NULL;
 //--------------------------------------------------------------------------------------------------
 static uint32_t FlashRequestedCount = 0;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for the block buffer used to stream data between a file descriptor and the flash.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t StreamBufferPool = NULL;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The currently active systems mask: Modem, LK and Linux
@@ -633,6 +655,7 @@ static void PartitionInit
     {
         PartitionPool = le_mem_CreatePool("Flash Partition Pool", sizeof(Partition_t));
         PartitionRefMap = le_ref_CreateMap("Flash Partition Ref Map", MAX_PARTITION_REF);
+        StreamBufferPool = le_mem_CreatePool("Flash Stream Buffer Pool", LE_FLASH_MAX_WRITE_SIZE);
 
         // Register a handler to be notified when clients disconnect
         le_msg_AddServiceCloseHandler(le_flash_GetServiceRef(), CloseClientPartitions, NULL);
@@ -677,6 +700,317 @@ static void RequestInit
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of the data held by one block of a partition: the erase block size for MTD usage
+ * partition, an erase block size minus 2 pages for UBI partitions.
+ *
+ * @return
+ *      - The block data size
+ *      - 0 if a block does not fit into the stream buffer
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetBlockDataSize
+(
+    Partition_t* partPtr    ///< [IN] Partition descriptor
+)
+{
+    size_t size = partPtr->mtdInfo->eraseSize;
+
+    if (partPtr->isUbi)
+    {
+        size -= 2 * partPtr->mtdInfo->writeSize;
+    }
+    if (size > LE_FLASH_MAX_WRITE_SIZE)
+    {
+        LE_ERROR("Partition \"%s\" MTD%d: block size %zu too large for streaming",
+                 partPtr->partitionName, partPtr->mtdNum, size);
+        return 0;
+    }
+    return size;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait until a file descriptor is ready for reading or writing.
+ *
+ * @return
+ *      - LE_OK            The file descriptor is ready
+ *      - LE_TIMEOUT       It was not ready within the timeout
+ *      - LE_FAULT         On poll error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitFd
+(
+    int   fd,           ///< [IN] File descriptor
+    short events,       ///< [IN] POLLIN or POLLOUT
+    int   timeoutMs     ///< [IN] Time to wait, in milliseconds
+)
+{
+    struct pollfd pfd = { .fd = fd, .events = events };
+    int ret;
+
+    do
+    {
+        ret = poll(&pfd, 1, timeoutMs);
+    }
+    while ((-1 == ret) && (EINTR == errno));
+
+    if (-1 == ret)
+    {
+        LE_ERROR("poll failed on fd %d: %m", fd);
+        return LE_FAULT;
+    }
+    return (0 == ret ? LE_TIMEOUT : LE_OK);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Erase a block of an MTD partition. If the erase reports an I/O error, the block is marked bad
+ * (unless the PA layer already did) so that the logical block now refers to the next good block,
+ * and the erase is retried.
+ *
+ * @return
+ *      - LE_OK            On success
+ *      - LE_FAULT         On failure, or if too many bad blocks were found
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EraseBlockSkipBad
+(
+    Partition_t* partPtr,       ///< [IN] Partition descriptor
+    uint32_t     blockIndex,    ///< [IN] Logical block index to erase
+    uint32_t*    skippedPtr     ///< [IN/OUT] Number of bad blocks skipped
+)
+{
+    pa_flash_EccStats_t stats;
+    uint32_t badBlocks;
+    int retry;
+    le_result_t res;
+
+    for (retry = 0; retry < STREAM_MAX_BAD_BLOCK_RETRIES; retry++)
+    {
+        if (LE_OK != pa_flash_GetEccStats(partPtr->desc, &stats))
+        {
+            return LE_FAULT;
+        }
+        badBlocks = stats.badBlocks;
+
+        res = pa_flash_EraseBlock(partPtr->desc, blockIndex);
+        if (LE_IO_ERROR != res)
+        {
+            return (LE_OK == res ? LE_OK : LE_FAULT);
+        }
+
+        LE_WARN("Partition \"%s\" MTD%d: erase failed at blockIndex %u, skipping bad block",
+                partPtr->partitionName, partPtr->mtdNum, blockIndex);
+        if ((LE_OK != pa_flash_GetEccStats(partPtr->desc, &stats)) ||
+            ((stats.badBlocks == badBlocks) &&
+             (LE_OK != pa_flash_MarkBadBlock(partPtr->desc, blockIndex))))
+        {
+            return LE_FAULT;
+        }
+        (*skippedPtr)++;
+    }
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write one block of data to a partition. The blocks of an MTD partition are erased first unless
+ * they were erased while waiting for their data; on an I/O error the block is marked bad and the
+ * data are written to the next good block.
+ *
+ * @return
+ *      - LE_OK            On success
+ *      - LE_OUT_OF_RANGE  If there is no block left in the partition or the UBI volume
+ *      - LE_FAULT         On failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteStreamBlock
+(
+    Partition_t* partPtr,       ///< [IN] Partition descriptor
+    uint32_t     blockIndex,    ///< [IN] Logical block index to write
+    uint8_t*     dataPtr,       ///< [IN] Data to write
+    size_t       dataSize,      ///< [IN] Size of the data
+    uint32_t*    erasedEndPtr,  ///< [IN/OUT] Blocks below this index are already erased
+    uint32_t*    skippedPtr     ///< [IN/OUT] Number of bad blocks skipped
+)
+{
+    pa_flash_EccStats_t stats;
+    uint32_t badBlocks;
+    int retry;
+    le_result_t res;
+
+    if (partPtr->isUbi)
+    {
+        res = pa_flash_WriteUbiAtBlock(partPtr->desc, blockIndex, dataPtr, dataSize, true);
+        return ((LE_OK == res) || (LE_OUT_OF_RANGE == res) ? res : LE_FAULT);
+    }
+
+    for (retry = 0; retry < STREAM_MAX_BAD_BLOCK_RETRIES; retry++)
+    {
+        if (blockIndex >= partPtr->mtdInfo->nbLeb)
+        {
+            return LE_OUT_OF_RANGE;
+        }
+        if ((blockIndex >= *erasedEndPtr) &&
+            (LE_OK != EraseBlockSkipBad(partPtr, blockIndex, skippedPtr)))
+        {
+            return LE_FAULT;
+        }
+
+        if (LE_OK != pa_flash_GetEccStats(partPtr->desc, &stats))
+        {
+            return LE_FAULT;
+        }
+        badBlocks = stats.badBlocks;
+
+        res = pa_flash_WriteAtBlock(partPtr->desc, blockIndex, dataPtr, dataSize);
+        if (LE_IO_ERROR != res)
+        {
+            return (LE_OK == res ? LE_OK : LE_FAULT);
+        }
+
+        LE_WARN("Partition \"%s\" MTD%d: write failed at blockIndex %u, skipping bad block",
+                partPtr->partitionName, partPtr->mtdNum, blockIndex);
+        if ((LE_OK != pa_flash_GetEccStats(partPtr->desc, &stats)) ||
+            ((stats.badBlocks == badBlocks) &&
+             (LE_OK != pa_flash_MarkBadBlock(partPtr->desc, blockIndex))))
+        {
+            return LE_FAULT;
+        }
+        (*skippedPtr)++;
+
+        // The logical blocks from this one now refer to the next physical blocks, which were not
+        // erased yet.
+        *erasedEndPtr = blockIndex;
+    }
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a block buffer with data read from a file descriptor. Once the first data of the block are
+ * received, the block of an MTD partition is erased while waiting for the rest. Blocks that no
+ * data are received for are never erased, so the stream doesn't wipe anything beyond its end.
+ *
+ * @return
+ *      - LE_OK            On success. The buffer is not full if end of file was reached.
+ *      - LE_TIMEOUT       If no data were received for STREAM_TIMEOUT_MS
+ *      - LE_FAULT         On failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadStreamBlock
+(
+    Partition_t* partPtr,       ///< [IN] Partition descriptor
+    int          fd,            ///< [IN] File descriptor to read from
+    uint32_t     blockIndex,    ///< [IN] Logical block index the data will be written to
+    uint8_t*     dataPtr,       ///< [OUT] Buffer to fill
+    size_t*      dataSizePtr,   ///< [IN/OUT] Size of the buffer/size of the data read
+    uint32_t*    erasedEndPtr,  ///< [IN/OUT] Blocks below this index are already erased
+    uint32_t*    skippedPtr     ///< [IN/OUT] Number of bad blocks skipped
+)
+{
+    size_t size = 0;
+    ssize_t readSize;
+    le_result_t res;
+
+    while (size < *dataSizePtr)
+    {
+        res = WaitFd(fd, POLLIN, 0);
+        if (LE_TIMEOUT == res)
+        {
+            if ((!partPtr->isUbi) && (size > 0) &&
+                (*erasedEndPtr <= blockIndex) &&
+                (blockIndex < partPtr->mtdInfo->nbLeb))
+            {
+                if (LE_OK != EraseBlockSkipBad(partPtr, blockIndex, skippedPtr))
+                {
+                    return LE_FAULT;
+                }
+                *erasedEndPtr = blockIndex + 1;
+                continue;
+            }
+            res = WaitFd(fd, POLLIN, STREAM_TIMEOUT_MS);
+        }
+        if (LE_OK != res)
+        {
+            return res;
+        }
+
+        readSize = read(fd, dataPtr + size, *dataSizePtr - size);
+        if (0 == readSize)
+        {
+            break;
+        }
+        if (-1 == readSize)
+        {
+            if ((EINTR == errno) || (EAGAIN == errno) || (EWOULDBLOCK == errno))
+            {
+                continue;
+            }
+            LE_ERROR("Read from fd %d failed: %m", fd);
+            return LE_FAULT;
+        }
+        size += readSize;
+    }
+
+    *dataSizePtr = size;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole buffer to a file descriptor.
+ *
+ * @return
+ *      - LE_OK            On success
+ *      - LE_CLOSED        If the reader closed the file descriptor
+ *      - LE_TIMEOUT       If the reader did not accept data for STREAM_TIMEOUT_MS
+ *      - LE_FAULT         On failure
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteFdFull
+(
+    int            fd,          ///< [IN] File descriptor to write to
+    const uint8_t* dataPtr,     ///< [IN] Data to write
+    size_t         dataSize     ///< [IN] Size of the data
+)
+{
+    ssize_t writeSize;
+    le_result_t res;
+
+    while (dataSize > 0)
+    {
+        writeSize = write(fd, dataPtr, dataSize);
+        if (-1 == writeSize)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+            {
+                res = WaitFd(fd, POLLOUT, STREAM_TIMEOUT_MS);
+                if (LE_OK != res)
+                {
+                    return res;
+                }
+                continue;
+            }
+            if (EPIPE == errno)
+            {
+                return LE_CLOSED;
+            }
+            LE_ERROR("Write to fd %d failed: %m", fd);
+            return LE_FAULT;
+        }
+        dataPtr += writeSize;
+        dataSize -= writeSize;
+    }
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 // APIs
 //--------------------------------------------------------------------------------------------------
@@ -1242,6 +1576,228 @@ le_result_t le_flash_Write
     return res;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write data read from a file descriptor to a flash partition, until end of file.
+ * - the data are programmed from the logical block index given by blockIndex, one erase block
+ *   (or an erase block minus 2 pages for UBI partitions) at a time.
+ * - the blocks of an MTD partition are erased before being written, while waiting for the rest
+ *   of their data. Only the blocks that receive data are erased. If the erase or the write
+ *   reports an error, the block is marked "bad" and the data are written to the next block.
+ * - if the write addresses an UBI volume and more PEBs are required to write the new data, new PEBs
+ *   will be added into this volume.
+ *
+ * @note
+ *      The file descriptor is closed when the write is over.
+ *
+ * @return
+ *      - LE_OK            On success
+ *      - LE_BAD_PARAMETER If a parameter is invalid
+ *      - LE_OUT_OF_RANGE  If the data do not fit in the partition or the UBI volume
+ *      - LE_TIMEOUT       If no data were received for 30 seconds
+ *      - LE_FAULT         On other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_flash_WriteFromFd
+(
+    le_flash_PartitionRef_t partitionRef, ///< [IN] Partition reference to be used.
+    uint32_t                blockIndex,   ///< [IN] First logical block index to write.
+    int                     fd,           ///< [IN] File descriptor to read the data from.
+    uint32_t*               dataSizePtr   ///< [OUT] Number of bytes written.
+)
+{
+    Partition_t *partPtr = GetPartitionFromRef(partitionRef);
+    uint32_t erasedEnd = blockIndex;
+    uint32_t skipped = 0;
+    uint32_t total = 0;
+    size_t blockSize, size;
+    uint8_t* bufferPtr;
+    le_result_t res = LE_OK;
+
+    if (fd < 0)
+    {
+        LE_KILL_CLIENT("'fd' is negative");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((NULL == partPtr) || !(partPtr->isWrite) || (NULL == dataSizePtr) ||
+        ((partPtr->isUbi) && (-1 == partPtr->ubiVolume)))
+    {
+        close(fd);
+        return LE_BAD_PARAMETER;
+    }
+
+    blockSize = GetBlockDataSize(partPtr);
+    if (0 == blockSize)
+    {
+        close(fd);
+        return LE_FAULT;
+    }
+
+    bufferPtr = le_mem_ForceAlloc(StreamBufferPool);
+
+    for (;;)
+    {
+        size = blockSize;
+        res = ReadStreamBlock(partPtr, fd, blockIndex, bufferPtr, &size, &erasedEnd, &skipped);
+        if ((LE_OK != res) || (0 == size))
+        {
+            break;
+        }
+
+        res = WriteStreamBlock(partPtr, blockIndex, bufferPtr, size, &erasedEnd, &skipped);
+        if (LE_OK != res)
+        {
+            LE_ERROR("Partition \"%s\" MTD%d: Write failed at blockIndex %u, dataSize %"PRIuS
+                     ": %d", partPtr->partitionName, partPtr->mtdNum, blockIndex, size, res);
+            break;
+        }
+
+        total += size;
+        blockIndex++;
+
+        if (size < blockSize)
+        {
+            // End of file.
+            break;
+        }
+    }
+
+    le_mem_Release(bufferPtr);
+    close(fd);
+
+    LE_INFO("Partition \"%s\" MTD%d: %u bytes written up to blockIndex %u, %u bad blocks skipped",
+            partPtr->partitionName, partPtr->mtdNum, total, blockIndex, skipped);
+
+    *dataSizePtr = total;
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read data from a flash partition and write them to a file descriptor.
+ * - the data are read from the logical block index given by blockIndex, up to blockCount blocks
+ *   or to the last block of the partition or the UBI volume if blockCount is 0.
+ * - each block contributes an erase block size for MTD usage partition, or the size of the data
+ *   it holds for UBI partitions.
+ *
+ * @note
+ *      The file descriptor is closed when the read is over.
+ *
+ * @return
+ *      - LE_OK            On success
+ *      - LE_BAD_PARAMETER If a parameter is invalid
+ *      - LE_CLOSED        If the file descriptor has been closed by the reader
+ *      - LE_TIMEOUT       If the reader did not accept data for 30 seconds
+ *      - LE_FAULT         On other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_flash_ReadToFd
+(
+    le_flash_PartitionRef_t partitionRef, ///< [IN] Partition reference to be used.
+    uint32_t                blockIndex,   ///< [IN] First logical block index to read.
+    uint32_t                blockCount,   ///< [IN] Number of blocks to read, 0 for all.
+    int                     fd,           ///< [IN] File descriptor to write the data to.
+    uint32_t*               dataSizePtr   ///< [OUT] Number of bytes read.
+)
+{
+    Partition_t *partPtr = GetPartitionFromRef(partitionRef);
+    uint32_t lastBlock;
+    uint32_t total = 0;
+    size_t blockSize, size;
+    uint8_t* bufferPtr;
+    le_result_t res = LE_OK;
+
+    if (fd < 0)
+    {
+        LE_KILL_CLIENT("'fd' is negative");
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((NULL == partPtr) || !(partPtr->isRead) || (NULL == dataSizePtr) ||
+        ((partPtr->isUbi) && (-1 == partPtr->ubiVolume)))
+    {
+        close(fd);
+        return LE_BAD_PARAMETER;
+    }
+
+    blockSize = GetBlockDataSize(partPtr);
+    if (0 == blockSize)
+    {
+        close(fd);
+        return LE_FAULT;
+    }
+
+    if (partPtr->isUbi)
+    {
+        uint32_t freeBlock, sizeInBytes;
+
+        if (LE_OK != pa_flash_GetUbiInfo(partPtr->desc, &freeBlock, &lastBlock, &sizeInBytes))
+        {
+            close(fd);
+            return LE_FAULT;
+        }
+    }
+    else
+    {
+        lastBlock = partPtr->mtdInfo->nbLeb;
+    }
+    if ((0 != blockCount) && (blockIndex + blockCount < lastBlock))
+    {
+        lastBlock = blockIndex + blockCount;
+    }
+
+    // Block SIGPIPE so that a reader closing the fd makes write() fail with EPIPE instead of
+    // killing the service.
+    sigset_t pipeSet, oldSet;
+    sigemptyset(&pipeSet);
+    sigaddset(&pipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSet, &oldSet);
+
+    bufferPtr = le_mem_ForceAlloc(StreamBufferPool);
+
+    for (; blockIndex < lastBlock; blockIndex++)
+    {
+        size = blockSize;
+        if (partPtr->isUbi)
+        {
+            res = pa_flash_ReadUbiAtBlock(partPtr->desc, blockIndex, bufferPtr, &size);
+        }
+        else
+        {
+            res = pa_flash_ReadAtBlock(partPtr->desc, blockIndex, bufferPtr, size);
+        }
+        if (LE_OK != res)
+        {
+            LE_ERROR("Partition \"%s\" MTD%d: Read failed at blockIndex %u: %d",
+                     partPtr->partitionName, partPtr->mtdNum, blockIndex, res);
+            res = LE_FAULT;
+            break;
+        }
+
+        res = WriteFdFull(fd, bufferPtr, size);
+        if (LE_OK != res)
+        {
+            break;
+        }
+        total += size;
+    }
+
+    le_mem_Release(bufferPtr);
+    close(fd);
+
+    if (LE_CLOSED == res)
+    {
+        // Discard the pending SIGPIPE before restoring the signal mask.
+        struct timespec noWait = { 0, 0 };
+        sigtimedwait(&pipeSet, NULL, &noWait);
+    }
+    pthread_sigmask(SIG_SETMASK, &oldSet, NULL);
+
+    *dataSizePtr = total;
+    return res;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Retrieve information about the partition opened: the number of bad blocks found inside the
@@ -12,6 +12,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "le_gnss_local.h"
+#include "le_pos_local.h"
 #ifdef LE_CONFIG_ENABLE_GNSS_ACQUISITION_RATE_SETTING
 #include "posCfgEntries.h"
 #endif // LE_CONFIG_ENABLE_GNSS_ACQUISITION_RATE_SETTING
@@ -34,6 +35,9 @@
 #define GNSS_UERE                                 7
 #define GNSS_ESTIMATED_VERTICAL_ERROR_FACTOR      (GNSS_UERE * 1.5)
 
+// Meters covered by 1e-6 degree along a great circle (mean Earth radius of 6371 km).
+#define METERS_PER_MICRODEGREE                    0.111195
+
 #define POSITIONING_SAMPLE_MAX          1
 
 /// Expected number of sample handlers
@@ -364,6 +368,14 @@ static int32_t NumOfHandlers;
 //--------------------------------------------------------------------------------------------------
 static le_gnss_PositionHandlerRef_t GnssHandlerRef = NULL;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of users (movement handlers and geofences) of the PA handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t PositionReportUsers;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The acquisition rate in milliseconds.
@@ -510,18 +522,41 @@ static uint32_t CalculateAcquisitionRate
     return rate + 2;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calculate an upper bound of the distance in meters between two fix points, without any
+ * trigonometry. A path along the meridian then along the parallel is never shorter than the
+ * great circle, and a degree of longitude is never longer than a degree of latitude.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ComputeDistanceUpperBound
+(
+    int32_t latitude1,
+    int32_t longitude1,
+    int32_t latitude2,
+    int32_t longitude2
+)
+{
+    int64_t dLat = llabs((int64_t)latitude2 - (int64_t)latitude1);
+    int64_t dLon = llabs((int64_t)longitude2 - (int64_t)longitude1);
+    double bound = (double)(dLat + dLon) * METERS_PER_MICRODEGREE + 1;
+
+    return (bound >= (double)UINT32_MAX) ? UINT32_MAX : (uint32_t)bound;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Calculate the distance in meters between two fix points (use Haversine formula).
  *
  */
 //--------------------------------------------------------------------------------------------------
-static uint32_t ComputeDistance
+uint32_t pos_ComputeDistance
 (
-    uint32_t latitude1,
-    uint32_t longitude1,
-    uint32_t latitude2,
-    uint32_t longitude2
+    int32_t latitude1,
+    int32_t longitude1,
+    int32_t latitude2,
+    int32_t longitude2
 )
 {
     // Haversine formula:
@@ -541,7 +576,6 @@ static uint32_t ComputeDistance
     a = sin(dLat/2) * sin(dLat/2) + sin(dLon/2) * sin(dLon/2) * cos(lat1) * cos(lat2);
     c = 2 * atan2(sqrt(a), sqrt(1-a));
 
-    LE_DEBUG("Computed distance is %e meters (double)", (double)(R * c * 1000));
     return (uint32_t)(R * c * 1000);
 }
 
@@ -763,10 +797,21 @@ static le_result_t ComputeMove
         posSampleHandlerNodePtr->lastAlt = posParamPtr->altitude;
     }
 
-    uint32_t horizontalMove = ComputeDistance(posSampleHandlerNodePtr->lastLat,
-                                              posSampleHandlerNodePtr->lastLong,
-                                              posParamPtr->latitude,
-                                              posParamPtr->longitude);
+    // The Haversine distance is only needed when the handler cares about horizontal moves and
+    // the cheap upper bound does not already rule out a move beyond the magnitude.
+    uint32_t horizontalMove = 0;
+    if ((0 != posSampleHandlerNodePtr->horizontalMagnitude) &&
+        (ComputeDistanceUpperBound(posSampleHandlerNodePtr->lastLat,
+                                   posSampleHandlerNodePtr->lastLong,
+                                   posParamPtr->latitude,
+                                   posParamPtr->longitude)
+         > posSampleHandlerNodePtr->horizontalMagnitude))
+    {
+        horizontalMove = pos_ComputeDistance(posSampleHandlerNodePtr->lastLat,
+                                             posSampleHandlerNodePtr->lastLong,
+                                             posParamPtr->latitude,
+                                             posParamPtr->longitude);
+    }
 
     uint32_t verticalMove = abs(posParamPtr->altitude - posSampleHandlerNodePtr->lastAlt);
 
@@ -856,14 +901,6 @@ static void PosSampleHandlerfunc
         return;
     }
 
-    if (!NumOfHandlers)
-    {
-        LE_DEBUG("No positioning Sample handler, exit Handler Function");
-        // Release provided Position sample reference
-        le_gnss_ReleaseSampleRef(positionSampleRef);
-        return;
-    }
-
     LE_DEBUG("Handler Function called with sample %p", positionSampleRef);
 
     // Get Location
@@ -881,6 +918,20 @@ static void PosSampleHandlerfunc
         LE_DEBUG("Position unknown [%"PRIi32",%"PRIi32",%"PRIi32"]", latitude, longitude, hAccuracy);
     }
 
+    // Geofences
+    if (locationValid)
+    {
+        geofence_ProcessFix(latitude, longitude);
+    }
+
+    if (!NumOfHandlers)
+    {
+        LE_DEBUG("No positioning Sample handler, exit Handler Function");
+        // Release provided Position sample reference
+        le_gnss_ReleaseSampleRef(positionSampleRef);
+        return;
+    }
+
     // Get altitude
     result = le_gnss_GetAltitude(positionSampleRef, &altitude, &vAccuracy);
 
@@ -1217,6 +1268,59 @@ static void PosCloseSessionEventHandler
         // Get the next value in the reference mpa
         result = le_ref_NextNode(iterRef);
     }
+
+    // Delete the geofences of the closed session.
+    geofence_ReleaseSession(sessionRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscribe to the GNSS position reports. Reports are received as long as at least one user
+ * (movement handler or geofence) holds a subscription.
+ *
+ * @return LE_FAULT  The GNSS handler could not be registered.
+ * @return LE_OK     The function succeed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pos_AcquirePositionReports
+(
+    void
+)
+{
+    if (0 == PositionReportUsers)
+    {
+        if (NULL == (GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)))
+        {
+            LE_ERROR("Failed to add PA GNSS's handler!");
+            return LE_FAULT;
+        }
+    }
+
+    PositionReportUsers++;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a subscription taken with pos_AcquirePositionReports().
+ */
+//--------------------------------------------------------------------------------------------------
+void pos_ReleasePositionReports
+(
+    void
+)
+{
+    if (0 == PositionReportUsers)
+    {
+        return;
+    }
+
+    PositionReportUsers--;
+    if (0 == PositionReportUsers)
+    {
+        le_gnss_RemovePositionHandler(GnssHandlerRef);
+        GnssHandlerRef = NULL;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1262,6 +1366,10 @@ COMPONENT_INIT
 
     NumOfHandlers = 0;
     GnssHandlerRef = NULL;
+    PositionReportUsers = 0;
+
+    // Initialize the geofence engine
+    geofence_Init();
 
     // Create safe reference map for request references. The size of the map should be based on
     // the expected number of simultaneous data requests, so take a reasonable guess.
@@ -1446,14 +1554,10 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
     posSampleHandlerNodePtr->lastAlt = 0;
 
     // Start acquisition
-    if (0 == NumOfHandlers)
+    if (LE_OK != pos_AcquirePositionReports())
     {
-        if (NULL == (GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)))
-        {
-            LE_ERROR("Failed to add PA GNSS's handler!");
-            le_mem_Release(posSampleHandlerNodePtr);
-            return NULL;
-        }
+        le_mem_Release(posSampleHandlerNodePtr);
+        return NULL;
     }
 
     le_dls_Queue(&PosSampleHandlerList, &(posSampleHandlerNodePtr->link));
@@ -1492,6 +1596,7 @@ void le_pos_RemoveMovementHandler
                 // Remove the node.
                 le_mem_Release(posSampleHandlerNodePtr);
                 NumOfHandlers--;
+                pos_ReleasePositionReports();
                 linkPtr=NULL;
             }
             else
@@ -1501,12 +1606,6 @@ void le_pos_RemoveMovementHandler
             }
         } while (linkPtr != NULL);
     }
-
-    if (NumOfHandlers == 0)
-    {
-        le_gnss_RemovePositionHandler(GnssHandlerRef);
-        GnssHandlerRef = NULL;
-    }
 }
 
 //--------------------------------------------------------------------------------------------------
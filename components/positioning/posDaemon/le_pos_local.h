@@ -0,0 +1,112 @@
+/**
+ * @file le_pos_local.h
+ *
+ * Local Positioning Definitions
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_POS_LOCAL_INCLUDE_GUARD
+#define LEGATO_POS_LOCAL_INCLUDE_GUARD
+
+#include "legato.h"
+
+/// Maximum number of geofences registered at the same time.
+#ifndef LE_CONFIG_POSITIONING_GEOFENCE_MAX
+#define LE_CONFIG_POSITIONING_GEOFENCE_MAX 2048
+#endif // LE_CONFIG_POSITIONING_GEOFENCE_MAX
+
+/// Number of geofences for which memory is preallocated.
+#ifndef LE_CONFIG_POSITIONING_GEOFENCE_POOL_SIZE
+#define LE_CONFIG_POSITIONING_GEOFENCE_POOL_SIZE 16
+#endif // LE_CONFIG_POSITIONING_GEOFENCE_POOL_SIZE
+
+/// Side of the geofence index grid cells in 1e-6 degrees.
+#ifndef LE_CONFIG_POSITIONING_GEOFENCE_GRID_CELL
+#define LE_CONFIG_POSITIONING_GEOFENCE_GRID_CELL 10000
+#endif // LE_CONFIG_POSITIONING_GEOFENCE_GRID_CELL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calculate the distance in meters between two fix points (Haversine formula).
+ *
+ * @return The distance in meters.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pos_ComputeDistance
+(
+    int32_t latitude1,      ///< [IN] Latitude of the first point [resolution 1e-6].
+    int32_t longitude1,     ///< [IN] Longitude of the first point [resolution 1e-6].
+    int32_t latitude2,      ///< [IN] Latitude of the second point [resolution 1e-6].
+    int32_t longitude2      ///< [IN] Longitude of the second point [resolution 1e-6].
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subscribe to the GNSS position reports. Reports are received as long as at least one user
+ * (movement handler or geofence) holds a subscription.
+ *
+ * @return LE_FAULT  The GNSS handler could not be registered.
+ * @return LE_OK     The function succeed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pos_AcquirePositionReports
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a subscription taken with pos_AcquirePositionReports().
+ */
+//--------------------------------------------------------------------------------------------------
+void pos_ReleasePositionReports
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the geofence engine.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Evaluate the registered fences against a new fix and report the transitions.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_ProcessFix
+(
+    int32_t latitude,       ///< [IN] Latitude of the fix [resolution 1e-6].
+    int32_t longitude       ///< [IN] Longitude of the fix [resolution 1e-6].
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the fences and fence handlers owned by a closed client session.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_ReleaseSession
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Closed session.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the geofence engine counters.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_GetStats
+(
+    uint64_t* fixCountPtr,          ///< [OUT] Number of fixes processed.
+    uint64_t* candidateCountPtr,    ///< [OUT] Number of fences selected by the grid index.
+    uint64_t* exactTestCountPtr     ///< [OUT] Number of fences that passed the bounding box
+                                    ///<       prefilter and needed the exact test.
+);
+
+#endif // LEGATO_POS_LOCAL_INCLUDE_GUARD
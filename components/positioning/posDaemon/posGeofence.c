@@ -0,0 +1,1102 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file posGeofence.c
+ *
+ * This file contains the source code of the geofencing part of the Positioning API.
+ *
+ * Fences are indexed in a uniform latitude/longitude grid: each fence is linked to every cell its
+ * bounding box overlaps, so a fix only has to look at the fences of its own cell. Fences that
+ * cover too many cells to be indexed are kept in a separate list and are always checked, but
+ * only through their bounding box first. The trigonometry (Haversine distance for circles,
+ * ray casting for polygons) is only run for fences whose bounding box contains the fix.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_pos_local.h"
+
+#include <math.h>
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+/// Latitude and longitude limits, in 1e-6 degrees.
+#define LATITUDE_MAX            90000000
+#define LONGITUDE_MAX           180000000
+
+/// Meters covered by 1e-6 degree of latitude (mean Earth radius of 6371 km).
+#define METERS_PER_MICRODEGREE  0.111195
+
+/// Cosine of the latitude below which circular fences are considered as covering all longitudes.
+#define MIN_LATITUDE_COSINE     0.01
+
+/// Fences overlapping more grid cells than this are not indexed but kept in the large fence list.
+#define FENCE_MAX_CELLS         64
+
+/// Preallocated fences, grid cells and cell entries. The pools grow beyond these on demand.
+#define FENCE_POOL_SIZE         LE_CONFIG_POSITIONING_GEOFENCE_POOL_SIZE
+#define GRID_CELL_COUNT         (FENCE_POOL_SIZE * 2)
+#define CELL_ENTRY_COUNT        (FENCE_POOL_SIZE * 4)
+
+/// Expected number of fence handlers.
+#define HIGH_FENCE_HANDLER_COUNT    4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence shapes.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    FENCE_CIRCLE,       ///< Circular fence.
+    FENCE_POLYGON       ///< Polygonal fence.
+}
+FenceType_t;
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Geofence structure.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_FenceRef_t   ref;                                    ///< Fence safe reference.
+    FenceType_t         type;                                   ///< Fence shape.
+    int32_t             minLat;                                 ///< Bounding box south edge.
+    int32_t             maxLat;                                 ///< Bounding box north edge.
+    int32_t             minLon;                                 ///< Bounding box west edge.
+    int32_t             maxLon;                                 ///< Bounding box east edge.
+    int32_t             latitude;                               ///< Circle center latitude.
+    int32_t             longitude;                              ///< Circle center longitude.
+    uint32_t            radius;                                 ///< Circle radius in meters.
+    size_t              vertexCount;                            ///< Number of polygon vertices.
+    int32_t             vertexLat[LE_POS_MAX_FENCE_VERTICES];   ///< Polygon latitudes.
+    int32_t             vertexLon[LE_POS_MAX_FENCE_VERTICES];   ///< Polygon longitudes.
+    uint32_t            dwellTime;                              ///< Dwell time in seconds.
+    bool                isInside;                               ///< Last evaluated state.
+    bool                isDwellReported;                        ///< Dwell event already sent.
+    bool                isLarge;                                ///< In LargeFenceList.
+    bool                isDeleted;                              ///< Deletion is pending.
+    time_t              enterTime;                              ///< Relative time of entry.
+    uint32_t            evalStamp;                              ///< Last fix that evaluated it.
+    le_dls_List_t       cellEntryList;                          ///< Grid cell entries.
+    le_dls_Link_t       largeLink;                              ///< Link in LargeFenceList.
+    le_dls_Link_t       insideLink;                             ///< Link in InsideFenceList.
+    le_dls_Link_t       deleteLink;                             ///< Link in DeletedFenceList.
+    le_msg_SessionRef_t sessionRef;                             ///< Owner session.
+}
+Fence_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grid cell of the spatial index.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t            key;            ///< Row in the upper 32 bits, column in the lower 32 bits.
+    le_dls_List_t       entryList;      ///< Entries of the fences overlapping the cell.
+}
+GridCell_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Link between a fence and a grid cell.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    Fence_t*            fencePtr;       ///< Indexed fence.
+    GridCell_t*         cellPtr;        ///< Cell overlapped by the fence.
+    le_dls_Link_t       cellLink;       ///< Link in the cell's entry list.
+    le_dls_Link_t       fenceLink;      ///< Link in the fence's cell entry list.
+}
+CellEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence handler structure.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_pos_FenceHandlerFunc_t   handlerFuncPtr;     ///< The handler function address.
+    void*                       handlerContextPtr;  ///< The handler function context.
+    le_msg_SessionRef_t         sessionRef;         ///< Store message session reference.
+    bool                        isRemoved;          ///< Removal is pending.
+    le_dls_Link_t               link;               ///< Object node link.
+}
+FenceHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Static pool and pool reference for fences.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_MEM_DEFINE_STATIC_POOL(Fence, FENCE_POOL_SIZE, sizeof(Fence_t));
+static le_mem_PoolRef_t FencePoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Static pool and pool reference for grid cells.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_MEM_DEFINE_STATIC_POOL(GridCell, GRID_CELL_COUNT, sizeof(GridCell_t));
+static le_mem_PoolRef_t GridCellPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Static pool and pool reference for cell entries.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_MEM_DEFINE_STATIC_POOL(CellEntry, CELL_ENTRY_COUNT, sizeof(CellEntry_t));
+static le_mem_PoolRef_t CellEntryPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Static pool and pool reference for fence handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_MEM_DEFINE_STATIC_POOL(FenceHandler, HIGH_FENCE_HANDLER_COUNT, sizeof(FenceHandler_t));
+static le_mem_PoolRef_t FenceHandlerPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Safe Reference Map for fences.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_REF_DEFINE_STATIC_MAP(FenceMap, FENCE_POOL_SIZE);
+static le_ref_MapRef_t FenceMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grid index: cell key -> GridCell_t.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_HASHMAP_DEFINE_STATIC(GridCells, GRID_CELL_COUNT);
+static le_hashmap_Ref_t GridCellMap;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fences too large to be indexed in the grid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t LargeFenceList = LE_DLS_LIST_DECL_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fences the device is currently inside. They are evaluated on every fix to detect exits even
+ * when the new fix falls in another cell.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t InsideFenceList = LE_DLS_LIST_DECL_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fences deleted by a handler while a fix was being processed. The fence handlers removed
+ * meanwhile are only flagged, and released from FenceHandlerList afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t DeletedFenceList = LE_DLS_LIST_DECL_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fence handlers list.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t FenceHandlerList = LE_DLS_LIST_DECL_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of fences.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NumOfFences;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stamp of the fix being processed, used to evaluate each fence at most once per fix.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t EvalStamp;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * True while a fix is being processed.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsProcessingFix;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Engine counters.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t FixCount;
+static uint64_t CandidateCount;
+static uint64_t ExactTestCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the grid row of a latitude.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GridRow
+(
+    int32_t latitude
+)
+{
+    return (uint32_t)(((int64_t)latitude + LATITUDE_MAX) / LE_CONFIG_POSITIONING_GEOFENCE_GRID_CELL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the grid column of a longitude.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GridColumn
+(
+    int32_t longitude
+)
+{
+    return (uint32_t)(((int64_t)longitude + LONGITUDE_MAX) /
+                      LE_CONFIG_POSITIONING_GEOFENCE_GRID_CELL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a grid cell key.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GridKey
+(
+    uint32_t row,
+    uint32_t column
+)
+{
+    return (((uint64_t)row) << 32) | column;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a latitude/longitude pair is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsValidCoordinate
+(
+    int32_t latitude,
+    int32_t longitude
+)
+{
+    return ((latitude >= -LATITUDE_MAX) && (latitude <= LATITUDE_MAX) &&
+            (longitude >= -LONGITUDE_MAX) && (longitude <= LONGITUDE_MAX));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a fence from the grid index.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnindexFence
+(
+    Fence_t* fencePtr
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while (NULL != (linkPtr = le_dls_Pop(&fencePtr->cellEntryList)))
+    {
+        CellEntry_t* entryPtr = CONTAINER_OF(linkPtr, CellEntry_t, fenceLink);
+        GridCell_t* cellPtr = entryPtr->cellPtr;
+
+        le_dls_Remove(&cellPtr->entryList, &entryPtr->cellLink);
+        le_mem_Release(entryPtr);
+
+        if (le_dls_IsEmpty(&cellPtr->entryList))
+        {
+            le_hashmap_Remove(GridCellMap, &cellPtr->key);
+            le_mem_Release(cellPtr);
+        }
+    }
+
+    if (fencePtr->isLarge)
+    {
+        le_dls_Remove(&LargeFenceList, &fencePtr->largeLink);
+        fencePtr->isLarge = false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Link a fence to one grid cell.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddFenceToCell
+(
+    Fence_t* fencePtr,
+    uint64_t key
+)
+{
+    GridCell_t* cellPtr = le_hashmap_Get(GridCellMap, &key);
+
+    if (NULL == cellPtr)
+    {
+        cellPtr = le_mem_ForceAlloc(GridCellPoolRef);
+        cellPtr->key = key;
+        cellPtr->entryList = LE_DLS_LIST_INIT;
+        le_hashmap_Put(GridCellMap, &cellPtr->key, cellPtr);
+    }
+
+    CellEntry_t* entryPtr = le_mem_ForceAlloc(CellEntryPoolRef);
+    entryPtr->fencePtr = fencePtr;
+    entryPtr->cellPtr = cellPtr;
+    entryPtr->cellLink = LE_DLS_LINK_INIT;
+    entryPtr->fenceLink = LE_DLS_LINK_INIT;
+    le_dls_Queue(&cellPtr->entryList, &entryPtr->cellLink);
+    le_dls_Queue(&fencePtr->cellEntryList, &entryPtr->fenceLink);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a fence to the grid index, or to the large fence list if it overlaps too many cells.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexFence
+(
+    Fence_t* fencePtr
+)
+{
+    uint32_t firstRow = GridRow(fencePtr->minLat);
+    uint32_t lastRow = GridRow(fencePtr->maxLat);
+    uint32_t firstColumn = GridColumn(fencePtr->minLon);
+    uint32_t lastColumn = GridColumn(fencePtr->maxLon);
+    uint64_t cellCount = ((uint64_t)(lastRow - firstRow) + 1) * ((lastColumn - firstColumn) + 1);
+
+    if (cellCount <= FENCE_MAX_CELLS)
+    {
+        uint32_t row, column;
+
+        for (row = firstRow; row <= lastRow; row++)
+        {
+            for (column = firstColumn; column <= lastColumn; column++)
+            {
+                AddFenceToCell(fencePtr, GridKey(row, column));
+            }
+        }
+    }
+    else
+    {
+        LE_DEBUG("Fence %p overlaps %"PRIu64" cells, not indexed", fencePtr->ref, cellCount);
+        fencePtr->isLarge = true;
+        le_dls_Queue(&LargeFenceList, &fencePtr->largeLink);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a point is inside a polygon (ray casting, planar approximation).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInsidePolygon
+(
+    const Fence_t* fencePtr,
+    int32_t latitude,
+    int32_t longitude
+)
+{
+    bool isInside = false;
+    size_t i, j;
+
+    for (i = 0, j = fencePtr->vertexCount - 1; i < fencePtr->vertexCount; j = i++)
+    {
+        int64_t latI = fencePtr->vertexLat[i];
+        int64_t latJ = fencePtr->vertexLat[j];
+
+        if ((latI > latitude) != (latJ > latitude))
+        {
+            int64_t lonI = fencePtr->vertexLon[i];
+            int64_t lonJ = fencePtr->vertexLon[j];
+            double crossLon = (double)lonI +
+                              (double)(lonJ - lonI) * (double)(latitude - latI) /
+                              (double)(latJ - latI);
+
+            if ((double)longitude < crossLon)
+            {
+                isInside = !isInside;
+            }
+        }
+    }
+
+    return isInside;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a fix is inside a fence. The bounding box is checked first, the exact test is
+ * only run when the fix is inside the bounding box.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInsideFence
+(
+    const Fence_t* fencePtr,
+    int32_t latitude,
+    int32_t longitude
+)
+{
+    if ((latitude < fencePtr->minLat) || (latitude > fencePtr->maxLat) ||
+        (longitude < fencePtr->minLon) || (longitude > fencePtr->maxLon))
+    {
+        return false;
+    }
+
+    ExactTestCount++;
+
+    if (FENCE_CIRCLE == fencePtr->type)
+    {
+        return (pos_ComputeDistance(fencePtr->latitude, fencePtr->longitude,
+                                    latitude, longitude) <= fencePtr->radius);
+    }
+
+    return IsInsidePolygon(fencePtr, latitude, longitude);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a fence transition to the handlers of the fence owner.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportFenceEvent
+(
+    Fence_t* fencePtr,
+    le_pos_FenceEvent_t event,
+    int32_t latitude,
+    int32_t longitude
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&FenceHandlerList);
+
+    LE_DEBUG("Fence %p event %d at [%"PRIi32",%"PRIi32"]", fencePtr->ref, event,
+             latitude, longitude);
+
+    while (NULL != linkPtr)
+    {
+        FenceHandler_t* handlerPtr = CONTAINER_OF(linkPtr, FenceHandler_t, link);
+
+        // The handlers removed by a handler are only released once the fix is processed, so the
+        // next node stays valid.
+        linkPtr = le_dls_PeekNext(&FenceHandlerList, linkPtr);
+
+        if ((handlerPtr->sessionRef == fencePtr->sessionRef) && (!handlerPtr->isRemoved))
+        {
+            handlerPtr->handlerFuncPtr(fencePtr->ref, event, latitude, longitude,
+                                       handlerPtr->handlerContextPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Evaluate one fence against the current fix.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EvaluateFence
+(
+    Fence_t* fencePtr,
+    int32_t latitude,
+    int32_t longitude,
+    time_t now
+)
+{
+    if ((fencePtr->evalStamp == EvalStamp) || fencePtr->isDeleted)
+    {
+        return;
+    }
+    fencePtr->evalStamp = EvalStamp;
+    CandidateCount++;
+
+    bool isInside = IsInsideFence(fencePtr, latitude, longitude);
+
+    if (isInside && !fencePtr->isInside)
+    {
+        fencePtr->isInside = true;
+        fencePtr->isDwellReported = false;
+        fencePtr->enterTime = now;
+        le_dls_Queue(&InsideFenceList, &fencePtr->insideLink);
+        ReportFenceEvent(fencePtr, LE_POS_FENCE_ENTER, latitude, longitude);
+    }
+    else if (!isInside && fencePtr->isInside)
+    {
+        fencePtr->isInside = false;
+        le_dls_Remove(&InsideFenceList, &fencePtr->insideLink);
+        ReportFenceEvent(fencePtr, LE_POS_FENCE_EXIT, latitude, longitude);
+    }
+
+    if (fencePtr->isInside && (0 != fencePtr->dwellTime) && !fencePtr->isDwellReported &&
+        ((now - fencePtr->enterTime) >= (time_t)fencePtr->dwellTime) && !fencePtr->isDeleted)
+    {
+        fencePtr->isDwellReported = true;
+        ReportFenceEvent(fencePtr, LE_POS_FENCE_DWELL, latitude, longitude);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Free a fence.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DestroyFence
+(
+    Fence_t* fencePtr
+)
+{
+    UnindexFence(fencePtr);
+    if (fencePtr->isInside)
+    {
+        le_dls_Remove(&InsideFenceList, &fencePtr->insideLink);
+    }
+    le_ref_DeleteRef(FenceMap, fencePtr->ref);
+    le_mem_Release(fencePtr);
+
+    NumOfFences--;
+    pos_ReleasePositionReports();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a fence, or defer its deletion if a fix is being processed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeleteFence
+(
+    Fence_t* fencePtr
+)
+{
+    if (IsProcessingFix)
+    {
+        if (!fencePtr->isDeleted)
+        {
+            fencePtr->isDeleted = true;
+            le_dls_Queue(&DeletedFenceList, &fencePtr->deleteLink);
+        }
+    }
+    else
+    {
+        DestroyFence(fencePtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a fence handler, or defer its release if a fix is being processed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveFenceHandler
+(
+    FenceHandler_t* handlerPtr
+)
+{
+    if (IsProcessingFix)
+    {
+        handlerPtr->isRemoved = true;
+    }
+    else
+    {
+        le_dls_Remove(&FenceHandlerList, &handlerPtr->link);
+        le_mem_Release(handlerPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the fence of a reference, owned by the calling client.
+ *
+ * @return The fence or NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static Fence_t* GetClientFence
+(
+    le_pos_FenceRef_t fenceRef
+)
+{
+    Fence_t* fencePtr = le_ref_Lookup(FenceMap, fenceRef);
+
+    if ((NULL == fencePtr) || (fencePtr->isDeleted) ||
+        (fencePtr->sessionRef != le_pos_GetClientSessionRef()))
+    {
+        return NULL;
+    }
+
+    return fencePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a fence and register it.
+ *
+ * @return The new fence or NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static Fence_t* CreateFence
+(
+    FenceType_t type,
+    uint32_t dwellTime
+)
+{
+    if (NumOfFences >= LE_CONFIG_POSITIONING_GEOFENCE_MAX)
+    {
+        LE_ERROR("Maximum number of fences reached (%d)", LE_CONFIG_POSITIONING_GEOFENCE_MAX);
+        return NULL;
+    }
+
+    if (LE_OK != pos_AcquirePositionReports())
+    {
+        return NULL;
+    }
+
+    Fence_t* fencePtr = le_mem_ForceAlloc(FencePoolRef);
+    memset(fencePtr, 0, sizeof(Fence_t));
+    fencePtr->type = type;
+    fencePtr->dwellTime = dwellTime;
+    fencePtr->cellEntryList = LE_DLS_LIST_INIT;
+    fencePtr->largeLink = LE_DLS_LINK_INIT;
+    fencePtr->insideLink = LE_DLS_LINK_INIT;
+    fencePtr->deleteLink = LE_DLS_LINK_INIT;
+    fencePtr->evalStamp = EvalStamp;
+    fencePtr->sessionRef = le_pos_GetClientSessionRef();
+    fencePtr->ref = le_ref_CreateRef(FenceMap, fencePtr);
+    NumOfFences++;
+
+    return fencePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Internal functions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the geofence engine.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_Init
+(
+    void
+)
+{
+    FencePoolRef = le_mem_InitStaticPool(Fence, FENCE_POOL_SIZE, sizeof(Fence_t));
+    GridCellPoolRef = le_mem_InitStaticPool(GridCell, GRID_CELL_COUNT, sizeof(GridCell_t));
+    CellEntryPoolRef = le_mem_InitStaticPool(CellEntry, CELL_ENTRY_COUNT, sizeof(CellEntry_t));
+    FenceHandlerPoolRef = le_mem_InitStaticPool(FenceHandler, HIGH_FENCE_HANDLER_COUNT,
+                                                sizeof(FenceHandler_t));
+    FenceMap = le_ref_InitStaticMap(FenceMap, FENCE_POOL_SIZE);
+    GridCellMap = le_hashmap_InitStatic(GridCells, GRID_CELL_COUNT,
+                                        le_hashmap_HashUInt64, le_hashmap_EqualsUInt64);
+    NumOfFences = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Evaluate the registered fences against a new fix and report the transitions.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_ProcessFix
+(
+    int32_t latitude,       ///< [IN] Latitude of the fix [resolution 1e-6].
+    int32_t longitude       ///< [IN] Longitude of the fix [resolution 1e-6].
+)
+{
+    le_dls_Link_t* linkPtr;
+    uint64_t key;
+    GridCell_t* cellPtr;
+    time_t now;
+
+    if ((0 == NumOfFences) || !IsValidCoordinate(latitude, longitude))
+    {
+        return;
+    }
+
+    now = le_clk_GetRelativeTime().sec;
+    EvalStamp++;
+    FixCount++;
+    IsProcessingFix = true;
+
+    // Fences the device was inside: detect exits and dwell. The next node is fetched first as an
+    // exit removes the fence from the list.
+    linkPtr = le_dls_Peek(&InsideFenceList);
+    while (NULL != linkPtr)
+    {
+        Fence_t* fencePtr = CONTAINER_OF(linkPtr, Fence_t, insideLink);
+        linkPtr = le_dls_PeekNext(&InsideFenceList, linkPtr);
+        EvaluateFence(fencePtr, latitude, longitude, now);
+    }
+
+    // Fences indexed in the cell of the fix.
+    key = GridKey(GridRow(latitude), GridColumn(longitude));
+    cellPtr = le_hashmap_Get(GridCellMap, &key);
+    if (NULL != cellPtr)
+    {
+        linkPtr = le_dls_Peek(&cellPtr->entryList);
+        while (NULL != linkPtr)
+        {
+            CellEntry_t* entryPtr = CONTAINER_OF(linkPtr, CellEntry_t, cellLink);
+            linkPtr = le_dls_PeekNext(&cellPtr->entryList, linkPtr);
+            EvaluateFence(entryPtr->fencePtr, latitude, longitude, now);
+        }
+    }
+
+    // Fences too large to be indexed.
+    linkPtr = le_dls_Peek(&LargeFenceList);
+    while (NULL != linkPtr)
+    {
+        Fence_t* fencePtr = CONTAINER_OF(linkPtr, Fence_t, largeLink);
+        linkPtr = le_dls_PeekNext(&LargeFenceList, linkPtr);
+        EvaluateFence(fencePtr, latitude, longitude, now);
+    }
+
+    IsProcessingFix = false;
+
+    // Complete the deletions requested by the handlers.
+    while (NULL != (linkPtr = le_dls_Pop(&DeletedFenceList)))
+    {
+        DestroyFence(CONTAINER_OF(linkPtr, Fence_t, deleteLink));
+    }
+
+    linkPtr = le_dls_Peek(&FenceHandlerList);
+    while (NULL != linkPtr)
+    {
+        FenceHandler_t* handlerPtr = CONTAINER_OF(linkPtr, FenceHandler_t, link);
+        linkPtr = le_dls_PeekNext(&FenceHandlerList, linkPtr);
+
+        if (handlerPtr->isRemoved)
+        {
+            RemoveFenceHandler(handlerPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the fences and fence handlers owned by a closed client session.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_ReleaseSession
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Closed session.
+)
+{
+    le_ref_IterRef_t iterRef = le_ref_GetIterator(FenceMap);
+    le_result_t result = le_ref_NextNode(iterRef);
+
+    while (LE_OK == result)
+    {
+        Fence_t* fencePtr = le_ref_GetValue(iterRef);
+
+        // Get the next node before deleting the current one.
+        result = le_ref_NextNode(iterRef);
+
+        if (fencePtr->sessionRef == sessionRef)
+        {
+            LE_DEBUG("Delete fence %p, Session %p", fencePtr->ref, sessionRef);
+            DeleteFence(fencePtr);
+        }
+    }
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&FenceHandlerList);
+    while (NULL != linkPtr)
+    {
+        FenceHandler_t* handlerPtr = CONTAINER_OF(linkPtr, FenceHandler_t, link);
+        linkPtr = le_dls_PeekNext(&FenceHandlerList, linkPtr);
+
+        if (handlerPtr->sessionRef == sessionRef)
+        {
+            RemoveFenceHandler(handlerPtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the geofence engine counters.
+ */
+//--------------------------------------------------------------------------------------------------
+void geofence_GetStats
+(
+    uint64_t* fixCountPtr,          ///< [OUT] Number of fixes processed.
+    uint64_t* candidateCountPtr,    ///< [OUT] Number of fences selected by the grid index.
+    uint64_t* exactTestCountPtr     ///< [OUT] Number of fences that passed the bounding box
+                                    ///<       prefilter and needed the exact test.
+)
+{
+    *fixCountPtr = FixCount;
+    *candidateCountPtr = CandidateCount;
+    *exactTestCountPtr = ExactTestCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+// APIs.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a circular fence.
+ *
+ * @return
+ *  - Reference to the new fence.
+ *  - NULL if a parameter is invalid or the maximum number of fences is reached.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceRef_t le_pos_CreateCircularFence
+(
+    int32_t latitude,       ///< [IN] WGS84 Latitude of the center [resolution 1e-6].
+    int32_t longitude,      ///< [IN] WGS84 Longitude of the center [resolution 1e-6].
+    uint32_t radius,        ///< [IN] Radius in meters.
+    uint32_t dwellTime      ///< [IN] Dwell time in seconds (0 to disable).
+)
+{
+    if ((!IsValidCoordinate(latitude, longitude)) || (0 == radius))
+    {
+        LE_ERROR("Invalid circular fence [%"PRIi32",%"PRIi32"] radius %"PRIu32,
+                 latitude, longitude, radius);
+        return NULL;
+    }
+
+    Fence_t* fencePtr = CreateFence(FENCE_CIRCLE, dwellTime);
+    if (NULL == fencePtr)
+    {
+        return NULL;
+    }
+
+    fencePtr->latitude = latitude;
+    fencePtr->longitude = longitude;
+    fencePtr->radius = radius;
+
+    // Bounding box: the latitude span is constant, the longitude span grows with the latitude.
+    double latSpan = (double)radius / METERS_PER_MICRODEGREE;
+    double latitudeCos = cos((double)latitude / 1000000.0 * M_PI / 180.0);
+    int64_t minLat = (int64_t)latitude - (int64_t)latSpan - 1;
+    int64_t maxLat = (int64_t)latitude + (int64_t)latSpan + 1;
+
+    fencePtr->minLat = (int32_t)((minLat < -LATITUDE_MAX) ? -LATITUDE_MAX : minLat);
+    fencePtr->maxLat = (int32_t)((maxLat > LATITUDE_MAX) ? LATITUDE_MAX : maxLat);
+
+    if ((latitudeCos < MIN_LATITUDE_COSINE) ||
+        ((latSpan / latitudeCos) >= (double)LONGITUDE_MAX) ||
+        (fencePtr->minLat == -LATITUDE_MAX) || (fencePtr->maxLat == LATITUDE_MAX))
+    {
+        fencePtr->minLon = -LONGITUDE_MAX;
+        fencePtr->maxLon = LONGITUDE_MAX;
+    }
+    else
+    {
+        int64_t lonSpan = (int64_t)(latSpan / latitudeCos) + 1;
+        int64_t minLon = (int64_t)longitude - lonSpan;
+        int64_t maxLon = (int64_t)longitude + lonSpan;
+
+        // A circle crossing the 180th meridian is indexed over all the longitudes.
+        if ((minLon < -LONGITUDE_MAX) || (maxLon > LONGITUDE_MAX))
+        {
+            minLon = -LONGITUDE_MAX;
+            maxLon = LONGITUDE_MAX;
+        }
+        fencePtr->minLon = (int32_t)minLon;
+        fencePtr->maxLon = (int32_t)maxLon;
+    }
+
+    IndexFence(fencePtr);
+
+    LE_DEBUG("Circular fence %p created [%"PRIi32",%"PRIi32"] radius %"PRIu32,
+             fencePtr->ref, latitude, longitude, radius);
+
+    return fencePtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a polygonal fence.
+ *
+ * @return
+ *  - Reference to the new fence.
+ *  - NULL if a parameter is invalid or the maximum number of fences is reached.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceRef_t le_pos_CreatePolygonFence
+(
+    const int32_t* latitudesPtr,    ///< [IN] WGS84 Latitudes of the vertices [resolution 1e-6].
+    size_t latitudesSize,           ///< [IN]
+    const int32_t* longitudesPtr,   ///< [IN] WGS84 Longitudes of the vertices [resolution 1e-6].
+    size_t longitudesSize,          ///< [IN]
+    uint32_t dwellTime              ///< [IN] Dwell time in seconds (0 to disable).
+)
+{
+    size_t i;
+
+    if ((NULL == latitudesPtr) || (NULL == longitudesPtr) ||
+        (latitudesSize != longitudesSize) || (latitudesSize < 3) ||
+        (latitudesSize > LE_POS_MAX_FENCE_VERTICES))
+    {
+        LE_ERROR("Invalid polygon fence (%"PRIuS" latitudes, %"PRIuS" longitudes)",
+                 latitudesSize, longitudesSize);
+        return NULL;
+    }
+
+    int32_t minLat = LATITUDE_MAX;
+    int32_t maxLat = -LATITUDE_MAX;
+    int32_t minLon = LONGITUDE_MAX;
+    int32_t maxLon = -LONGITUDE_MAX;
+
+    for (i = 0; i < latitudesSize; i++)
+    {
+        if (!IsValidCoordinate(latitudesPtr[i], longitudesPtr[i]))
+        {
+            LE_ERROR("Invalid vertex %"PRIuS" [%"PRIi32",%"PRIi32"]",
+                     i, latitudesPtr[i], longitudesPtr[i]);
+            return NULL;
+        }
+        minLat = (latitudesPtr[i] < minLat) ? latitudesPtr[i] : minLat;
+        maxLat = (latitudesPtr[i] > maxLat) ? latitudesPtr[i] : maxLat;
+        minLon = (longitudesPtr[i] < minLon) ? longitudesPtr[i] : minLon;
+        maxLon = (longitudesPtr[i] > maxLon) ? longitudesPtr[i] : maxLon;
+    }
+
+    if (((int64_t)maxLon - minLon) > LONGITUDE_MAX)
+    {
+        LE_ERROR("Polygon fences must not cross the 180th meridian");
+        return NULL;
+    }
+
+    Fence_t* fencePtr = CreateFence(FENCE_POLYGON, dwellTime);
+    if (NULL == fencePtr)
+    {
+        return NULL;
+    }
+
+    fencePtr->vertexCount = latitudesSize;
+    memcpy(fencePtr->vertexLat, latitudesPtr, latitudesSize * sizeof(int32_t));
+    memcpy(fencePtr->vertexLon, longitudesPtr, longitudesSize * sizeof(int32_t));
+    fencePtr->minLat = minLat;
+    fencePtr->maxLat = maxLat;
+    fencePtr->minLon = minLon;
+    fencePtr->maxLon = maxLon;
+
+    IndexFence(fencePtr);
+
+    LE_DEBUG("Polygon fence %p created with %"PRIuS" vertices", fencePtr->ref, latitudesSize);
+
+    return fencePtr->ref;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a fence.
+ *
+ * @return LE_OK            Function succeeded.
+ * @return LE_BAD_PARAMETER Invalid reference provided, or fence of another client.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_pos_DeleteFence
+(
+    le_pos_FenceRef_t fenceRef      ///< [IN] Fence reference.
+)
+{
+    Fence_t* fencePtr = GetClientFence(fenceRef);
+    if (NULL == fencePtr)
+    {
+        LE_KILL_CLIENT("Invalid fence reference (%p) provided!", fenceRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    DeleteFence(fencePtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current state of a fence.
+ *
+ * @return LE_OK            Function succeeded.
+ * @return LE_BAD_PARAMETER Invalid reference provided, or fence of another client.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_pos_GetFenceState
+(
+    le_pos_FenceRef_t fenceRef,     ///< [IN] Fence reference.
+    bool* isInsidePtr               ///< [OUT] True if the last fix was inside the fence.
+)
+{
+    Fence_t* fencePtr = GetClientFence(fenceRef);
+    if ((NULL == fencePtr) || (NULL == isInsidePtr))
+    {
+        LE_KILL_CLIENT("Invalid fence reference (%p) provided!", fenceRef);
+        return LE_BAD_PARAMETER;
+    }
+
+    *isInsidePtr = fencePtr->isInside;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register a handler for geofence transitions.
+ *
+ * @return A handler reference, which is only needed for later removal of the handler.
+ */
+//--------------------------------------------------------------------------------------------------
+le_pos_FenceHandlerRef_t le_pos_AddFenceHandler
+(
+    le_pos_FenceHandlerFunc_t handlerPtr,   ///< [IN] The handler function.
+    void* contextPtr                        ///< [IN] The context pointer.
+)
+{
+    if (NULL == handlerPtr)
+    {
+        LE_KILL_CLIENT("handlerPtr pointer is NULL!");
+        return NULL;
+    }
+
+    FenceHandler_t* fenceHandlerPtr = le_mem_ForceAlloc(FenceHandlerPoolRef);
+    fenceHandlerPtr->handlerFuncPtr = handlerPtr;
+    fenceHandlerPtr->handlerContextPtr = contextPtr;
+    fenceHandlerPtr->sessionRef = le_pos_GetClientSessionRef();
+    fenceHandlerPtr->isRemoved = false;
+    fenceHandlerPtr->link = LE_DLS_LINK_INIT;
+    le_dls_Queue(&FenceHandlerList, &fenceHandlerPtr->link);
+
+    return (le_pos_FenceHandlerRef_t)fenceHandlerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to remove a handler for geofence transitions.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pos_RemoveFenceHandler
+(
+    le_pos_FenceHandlerRef_t handlerRef     ///< [IN] The handler reference.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&FenceHandlerList);
+
+    while (NULL != linkPtr)
+    {
+        FenceHandler_t* handlerPtr = CONTAINER_OF(linkPtr, FenceHandler_t, link);
+
+        if (((le_pos_FenceHandlerRef_t)handlerPtr == handlerRef) && (!handlerPtr->isRemoved))
+        {
+            RemoveFenceHandler(handlerPtr);
+            return;
+        }
+        linkPtr = le_dls_PeekNext(&FenceHandlerList, linkPtr);
+    }
+}
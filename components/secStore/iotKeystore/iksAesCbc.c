@@ -10,6 +10,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_iotKeystore.h"
+#include "iksStream.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -139,3 +140,63 @@ le_result_t le_iks_aesCbc_Decrypt
     return pa_iks_aesCbc_Decrypt(session, ciphertextChunkPtr, ciphertextChunkSize,
                                  plaintextChunkPtr, plaintextChunkSizePtr);
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encrypt all the plaintext read from a file descriptor, until the end of file, and write the
+ * ciphertext to another file descriptor.  le_iks_aesCbc_StartEncrypt() must have been previously
+ * called.  The plaintext size must be a multiple of the block size.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if the session reference is invalid
+ *                       or if the key type is invalid
+ *                       or if a file descriptor is invalid.
+ *      LE_OUT_OF_RANGE if the plaintext size is not a multiple of the block size.
+ *      LE_IO_ERROR if reading or writing a file descriptor failed.
+ *      LE_TIMEOUT if a file descriptor was not read or written for 10 seconds.
+ *      LE_UNSUPPORTED if underlying resource does not support this operation.
+ *      LE_FAULT if an encryption process has not started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_iks_aesCbc_EncryptStream
+(
+    uint64_t session,       ///< [IN] Session reference.
+    int plaintextFd,        ///< [IN] File descriptor to read the plaintext from.
+    int ciphertextFd        ///< [IN] File descriptor to write the ciphertext to.
+)
+{
+    return iksStream_Transform(session, plaintextFd, ciphertextFd, LE_IKS_AES_BLOCK_SIZE,
+                               pa_iks_aesCbc_Encrypt);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decrypt all the ciphertext read from a file descriptor, until the end of file, and write the
+ * plaintext to another file descriptor.  le_iks_aesCbc_StartDecrypt() must have been previously
+ * called.  The ciphertext size must be a multiple of the block size.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if the session reference is invalid
+ *                       or if the key type is invalid
+ *                       or if a file descriptor is invalid.
+ *      LE_OUT_OF_RANGE if the ciphertext size is not a multiple of the block size.
+ *      LE_IO_ERROR if reading or writing a file descriptor failed.
+ *      LE_TIMEOUT if a file descriptor was not read or written for 10 seconds.
+ *      LE_UNSUPPORTED if underlying resource does not support this operation.
+ *      LE_FAULT if a decryption process has not started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_iks_aesCbc_DecryptStream
+(
+    uint64_t session,       ///< [IN] Session reference.
+    int ciphertextFd,       ///< [IN] File descriptor to read the ciphertext from.
+    int plaintextFd         ///< [IN] File descriptor to write the plaintext to.
+)
+{
+    return iksStream_Transform(session, ciphertextFd, plaintextFd, LE_IKS_AES_BLOCK_SIZE,
+                               pa_iks_aesCbc_Decrypt);
+}
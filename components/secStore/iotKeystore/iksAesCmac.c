@@ -11,6 +11,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_iotKeystore.h"
+#include "iksStream.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -102,3 +103,32 @@ le_result_t le_iks_aesCmac_Verify
 {
     return pa_iks_aesCmac_Verify(session, tagBufPtr, tagBufSize);
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process all the message read from a file descriptor, until the end of file.
+ * le_iks_aesCmac_Done() or le_iks_aesCmac_Verify() must then be called to get or check the
+ * authentication tag.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if the session reference is invalid
+ *                       or if the key type is invalid
+ *                       or if the file descriptor is invalid.
+ *      LE_IO_ERROR if reading the file descriptor failed.
+ *      LE_TIMEOUT if the file descriptor was not read for 10 seconds.
+ *      LE_UNSUPPORTED if underlying resource does not support this operation.
+ *      LE_FAULT if no more messages can be processed, ie. le_iks_aesCmac_Done() or
+ *               le_iks_aesCmac_Verify() has already been called,
+ *               or if there was an internal error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_iks_aesCmac_ProcessStream
+(
+    uint64_t session,       ///< [IN] Session reference.
+    int msgFd               ///< [IN] File descriptor to read the message from.
+)
+{
+    return iksStream_Digest(session, msgFd, pa_iks_aesCmac_ProcessChunk);
+}
@@ -10,6 +10,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_iotKeystore.h"
+#include "iksStream.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -378,3 +379,86 @@ le_result_t le_iks_aesGcm_DoneDecrypt
 {
     return pa_iks_aesGcm_DoneDecrypt(session, tagPtr, tagSize);
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encrypt all the plaintext read from a file descriptor, until the end of file, write the
+ * ciphertext to another file descriptor and complete the encryption.  le_iks_aesGcm_StartEncrypt()
+ * must have been previously called to start an encryption process.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if the session reference is invalid
+ *                       or if the key type is invalid
+ *                       or if a file descriptor is invalid.
+ *      LE_IO_ERROR if reading or writing a file descriptor failed.
+ *      LE_TIMEOUT if a file descriptor was not read or written for 10 seconds.
+ *      LE_UNSUPPORTED if underlying resource does not support this operation.
+ *      LE_FAULT if an encryption process has not started or no data
+ *                            (AAD and plaintext) has been processed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_iks_aesGcm_EncryptStream
+(
+    uint64_t    session,        ///< [IN] Session reference.
+    int         plaintextFd,    ///< [IN] File descriptor to read the plaintext from.
+    int         ciphertextFd,   ///< [IN] File descriptor to write the ciphertext to.
+    uint8_t*    tagPtr,         ///< [OUT] Buffer to hold the authentication tag.
+    size_t*     tagSizePtr      ///< [INOUT] Authentication tag size.
+                                ///<         Expected to be LE_IKS_AESGCM_TAG_SIZE.
+)
+{
+    le_result_t result = iksStream_Transform(session, plaintextFd, ciphertextFd, 1,
+                                             pa_iks_aesGcm_Encrypt);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    return pa_iks_aesGcm_DoneEncrypt(session, tagPtr, tagSizePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decrypt all the ciphertext read from a file descriptor, until the end of file, write the
+ * plaintext to another file descriptor and verify the integrity.  le_iks_aesGcm_StartDecrypt() must
+ * have been previously called to start a decryption process.
+ *
+ * @warning
+ *      The plaintext is written before its integrity is verified.  The caller must not make use
+ *      of it unless this function returns LE_OK.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if the session reference is invalid
+ *                       or if the key type is invalid
+ *                       or if a file descriptor is invalid.
+ *      LE_IO_ERROR if reading or writing a file descriptor failed.
+ *      LE_TIMEOUT if a file descriptor was not read or written for 10 seconds.
+ *      LE_UNSUPPORTED if underlying resource does not support this operation.
+ *      LE_FAULT if a decryption process has not started
+ *               or no data (AAD and ciphertext) has been processed
+ *               or the integrity check failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_iks_aesGcm_DecryptStream
+(
+    uint64_t        session,        ///< [IN] Session reference.
+    int             ciphertextFd,   ///< [IN] File descriptor to read the ciphertext from.
+    int             plaintextFd,    ///< [IN] File descriptor to write the plaintext to.
+    const uint8_t*  tagPtr,         ///< [IN] Authentication tag.
+    size_t          tagSize         ///< [IN] Authentication tag size.
+                                    ///<         Expected to be LE_IKS_AESGCM_TAG_SIZE.
+)
+{
+    le_result_t result = iksStream_Transform(session, ciphertextFd, plaintextFd, 1,
+                                             pa_iks_aesGcm_Decrypt);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    return pa_iks_aesGcm_DoneDecrypt(session, tagPtr, tagSize);
+}
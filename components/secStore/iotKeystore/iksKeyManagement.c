@@ -11,6 +11,7 @@
 #include "interfaces.h"
 #include "pa_iotKeystore.h"
 #include "secStoreServer.h"
+#include "iksStream.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -789,4 +790,5 @@ le_result_t le_iks_DeleteSession
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
 {
+    iksStream_Init();
 }
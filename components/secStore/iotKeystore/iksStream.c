@@ -0,0 +1,619 @@
+/** @file iksStream.c
+ *
+ * Bulk processing of file descriptors by the IoT KeyStore's streaming routines.
+ *
+ * A stream goes through a ring of STREAM_NUM_BLOCKS blocks:
+ *
+ *  - the reader thread waits for a free block and fills it from the input file descriptor,
+ *  - the calling thread processes the filled block with the platform adaptor, one chunk of
+ *    LE_IKS_MAX_PACKET_SIZE bytes at a time,
+ *  - the writer thread writes the processed block to the output file descriptor and frees it.
+ *
+ * Only the calling thread uses the platform adaptor, which does not need to be thread-safe.  The
+ * end of the data is a block that is not full.
+ *
+ * The calling thread is the IPC thread of the service, shared by all the IoT KeyStore and secure
+ * storage clients.  So that a client that keeps a file descriptor open without reading or writing
+ * it cannot stall the service, the file descriptors are only read and written when poll() reports
+ * them ready, and reading or writing a block fails with LE_TIMEOUT after STREAM_BLOCK_TIMEOUT_MS.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "iksStream.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a block, a multiple of LE_IKS_MAX_PACKET_SIZE.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STREAM_BLOCK_SIZE       (16 * LE_IKS_MAX_PACKET_SIZE)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of blocks in the ring: one being read, one being processed and one being written.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STREAM_NUM_BLOCKS       3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time allowed to read or to write a block, in milliseconds.  The stream fails after that.
+ */
+//--------------------------------------------------------------------------------------------------
+#define STREAM_BLOCK_TIMEOUT_MS 10000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block of data.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t  inSize;                         ///< Number of bytes read.
+    size_t  outSize;                        ///< Number of bytes to write.
+    uint8_t in[STREAM_BLOCK_SIZE];          ///< Data read.
+    uint8_t out[STREAM_BLOCK_SIZE];         ///< Data to write.
+}
+Block_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stream being processed.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t        session;            ///< Session reference.
+    int             inFd;               ///< Input file descriptor.
+    int             outFd;              ///< Output file descriptor, -1 if none.
+    Block_t*        blocks;             ///< Ring of STREAM_NUM_BLOCKS blocks.
+    le_sem_Ref_t    freeSem;            ///< Posted when a block is free.
+    le_sem_Ref_t    readSem;            ///< Posted when a block has been read.
+    le_sem_Ref_t    processedSem;       ///< Posted when a block has been processed.
+    size_t          alignment;          ///< Data size must be a multiple of this.
+    iksStream_TransformFunc_t transformFunc;    ///< Routine transforming the chunks, or NULL.
+    iksStream_DigestFunc_t digestFunc;          ///< Routine processing the chunks, or NULL.
+    bool            isAborted;          ///< Processing failed, threads must stop.
+    le_result_t     readResult;         ///< Result of the reader thread.
+    le_result_t     writeResult;        ///< Result of the writer thread.
+}
+Stream_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of rings of blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t RingPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time by which a block must have been read or written.
+ *
+ * @return Relative time, STREAM_BLOCK_TIMEOUT_MS from now.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t GetBlockDeadline
+(
+    void
+)
+{
+    le_clk_Time_t timeout =
+    {
+        .sec = STREAM_BLOCK_TIMEOUT_MS / 1000,
+        .usec = (STREAM_BLOCK_TIMEOUT_MS % 1000) * 1000
+    };
+
+    return le_clk_Add(le_clk_GetRelativeTime(), timeout);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait until a file descriptor is ready, or a deadline.
+ *
+ * @return LE_OK if ready, LE_TIMEOUT if the deadline passed, LE_IO_ERROR on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WaitFd
+(
+    int fd,                 ///< [IN] File descriptor.
+    short events,           ///< [IN] POLLIN or POLLOUT.
+    le_clk_Time_t deadline  ///< [IN] Relative time to give up at.
+)
+{
+    struct pollfd pollFd = { .fd = fd, .events = events };
+
+    for (;;)
+    {
+        le_clk_Time_t now = le_clk_GetRelativeTime();
+        int timeoutMs = 0;
+
+        if (le_clk_GreaterThan(deadline, now))
+        {
+            le_clk_Time_t remaining = le_clk_Sub(deadline, now);
+            timeoutMs = remaining.sec * 1000 + (remaining.usec + 999) / 1000;
+        }
+
+        int count = poll(&pollFd, 1, timeoutMs);
+        if (count > 0)
+        {
+            return LE_OK;
+        }
+        if (count == 0)
+        {
+            LE_ERROR("No progress on fd %d for %d ms", fd, STREAM_BLOCK_TIMEOUT_MS);
+            return LE_TIMEOUT;
+        }
+        if (errno != EINTR)
+        {
+            LE_ERROR("poll error: %m");
+            return LE_IO_ERROR;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read until a buffer is full or the end of file, within STREAM_BLOCK_TIMEOUT_MS.
+ *
+ * @return LE_OK on success, LE_TIMEOUT if the data did not come in time, LE_IO_ERROR on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadFull
+(
+    int fd,             ///< [IN] File descriptor.
+    uint8_t* bufPtr,    ///< [OUT] Buffer.
+    size_t size,        ///< [IN] Buffer size.
+    size_t* countPtr    ///< [OUT] Number of bytes read.
+)
+{
+    le_clk_Time_t deadline = GetBlockDeadline();
+    size_t total = 0;
+
+    *countPtr = 0;
+
+    while (total < size)
+    {
+        // Once poll() reports data, read() returns what is available without blocking.
+        le_result_t result = WaitFd(fd, POLLIN, deadline);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        ssize_t count = read(fd, bufPtr + total, size - total);
+
+        if (count == 0)
+        {
+            break;
+        }
+        if (count < 0)
+        {
+            if ((errno == EINTR) || (errno == EAGAIN))
+            {
+                continue;
+            }
+            LE_ERROR("Read error: %m");
+            return LE_IO_ERROR;
+        }
+        total += count;
+    }
+
+    *countPtr = total;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole buffer, within STREAM_BLOCK_TIMEOUT_MS.
+ *
+ * @return LE_OK on success, LE_TIMEOUT if the data were not taken in time, LE_IO_ERROR on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteFull
+(
+    int fd,                 ///< [IN] File descriptor.
+    const uint8_t* bufPtr,  ///< [IN] Buffer.
+    size_t size             ///< [IN] Buffer size.
+)
+{
+    le_clk_Time_t deadline = GetBlockDeadline();
+    size_t total = 0;
+
+    while (total < size)
+    {
+        // Once poll() reports room, a write of at most PIPE_BUF bytes doesn't block.
+        le_result_t result = WaitFd(fd, POLLOUT, deadline);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        size_t chunkSize = size - total;
+        if (chunkSize > PIPE_BUF)
+        {
+            chunkSize = PIPE_BUF;
+        }
+
+        ssize_t count = write(fd, bufPtr + total, chunkSize);
+
+        if (count < 0)
+        {
+            if ((errno == EINTR) || (errno == EAGAIN))
+            {
+                continue;
+            }
+            LE_ERROR("Write error: %m");
+            return LE_IO_ERROR;
+        }
+        total += count;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reader thread: fill the free blocks from the input file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ReaderThread
+(
+    void* contextPtr    ///< [IN] Stream.
+)
+{
+    Stream_t* streamPtr = contextPtr;
+    int i;
+
+    for (i = 0; ; i = (i + 1) % STREAM_NUM_BLOCKS)
+    {
+        Block_t* blockPtr = &streamPtr->blocks[i];
+
+        le_sem_Wait(streamPtr->freeSem);
+        if (streamPtr->isAborted)
+        {
+            break;
+        }
+
+        size_t count;
+        streamPtr->readResult = ReadFull(streamPtr->inFd, blockPtr->in, STREAM_BLOCK_SIZE, &count);
+        blockPtr->inSize = count;
+
+        le_sem_Post(streamPtr->readSem);
+        if (count < STREAM_BLOCK_SIZE)
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writer thread: write the processed blocks to the output file descriptor.
+ *
+ * After a write error, the remaining blocks are dropped so that the stream can run to its end.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* WriterThread
+(
+    void* contextPtr    ///< [IN] Stream.
+)
+{
+    Stream_t* streamPtr = contextPtr;
+    int i;
+
+    // Make write() fail with EPIPE, instead of killing the service, if the reader goes away.
+    le_sig_Block(SIGPIPE);
+
+    for (i = 0; ; i = (i + 1) % STREAM_NUM_BLOCKS)
+    {
+        Block_t* blockPtr = &streamPtr->blocks[i];
+
+        le_sem_Wait(streamPtr->processedSem);
+        if (streamPtr->isAborted)
+        {
+            break;
+        }
+
+        if (streamPtr->writeResult == LE_OK)
+        {
+            streamPtr->writeResult = WriteFull(streamPtr->outFd, blockPtr->out,
+                                               blockPtr->outSize);
+        }
+
+        bool isLast = (blockPtr->inSize < STREAM_BLOCK_SIZE);
+        le_sem_Post(streamPtr->freeSem);
+        if (isLast)
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process a block with the platform adaptor, one chunk at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ProcessBlock
+(
+    const Stream_t* streamPtr,  ///< [IN] Stream.
+    Block_t* blockPtr           ///< [INOUT] Block.
+)
+{
+    size_t offset;
+
+    if (blockPtr->inSize % streamPtr->alignment != 0)
+    {
+        LE_ERROR("Data size is not a multiple of %" PRIuS, streamPtr->alignment);
+        return LE_OUT_OF_RANGE;
+    }
+
+    blockPtr->outSize = 0;
+
+    for (offset = 0; offset < blockPtr->inSize; offset += LE_IKS_MAX_PACKET_SIZE)
+    {
+        size_t inSize = blockPtr->inSize - offset;
+        size_t outSize = STREAM_BLOCK_SIZE - blockPtr->outSize;
+        le_result_t result;
+
+        if (inSize > LE_IKS_MAX_PACKET_SIZE)
+        {
+            inSize = LE_IKS_MAX_PACKET_SIZE;
+        }
+
+        if (streamPtr->transformFunc != NULL)
+        {
+            result = streamPtr->transformFunc(streamPtr->session, blockPtr->in + offset, inSize,
+                                              blockPtr->out + blockPtr->outSize, &outSize);
+            blockPtr->outSize += outSize;
+        }
+        else
+        {
+            result = streamPtr->digestFunc(streamPtr->session, blockPtr->in + offset, inSize);
+        }
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create and start a joinable thread of a stream.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_thread_Ref_t StartThread
+(
+    const char* namePtr,                ///< [IN] Thread name.
+    le_thread_MainFunc_t mainFunc,      ///< [IN] Thread main function.
+    Stream_t* streamPtr                 ///< [IN] Stream.
+)
+{
+    le_thread_Ref_t threadRef = le_thread_Create(namePtr, mainFunc, streamPtr);
+
+    le_thread_SetJoinable(threadRef);
+    le_thread_Start(threadRef);
+
+    return threadRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a stream, with a writer thread if it has an output file descriptor.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OUT_OF_RANGE if the data size is not a multiple of the alignment.
+ *      LE_IO_ERROR if reading or writing failed.
+ *      LE_TIMEOUT if a block was not read or written within STREAM_BLOCK_TIMEOUT_MS.
+ *      Otherwise the error returned by the platform adaptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RunStream
+(
+    Stream_t* streamPtr     ///< [IN] Stream.
+)
+{
+    le_thread_Ref_t readerRef;
+    le_thread_Ref_t writerRef = NULL;
+    le_result_t result;
+    int i;
+
+    streamPtr->blocks = le_mem_ForceAlloc(RingPool);
+    streamPtr->freeSem = le_sem_Create("IksStreamFree", STREAM_NUM_BLOCKS);
+    streamPtr->readSem = le_sem_Create("IksStreamRead", 0);
+    streamPtr->processedSem = le_sem_Create("IksStreamProcessed", 0);
+    streamPtr->isAborted = false;
+    streamPtr->readResult = LE_OK;
+    streamPtr->writeResult = LE_OK;
+
+    readerRef = StartThread("IksStreamReader", ReaderThread, streamPtr);
+    if (streamPtr->outFd >= 0)
+    {
+        writerRef = StartThread("IksStreamWriter", WriterThread, streamPtr);
+    }
+
+    for (i = 0; ; i = (i + 1) % STREAM_NUM_BLOCKS)
+    {
+        Block_t* blockPtr = &streamPtr->blocks[i];
+
+        le_sem_Wait(streamPtr->readSem);
+
+        // Stop reading as soon as the output cannot be written, too.
+        result = streamPtr->readResult;
+        if (result == LE_OK)
+        {
+            result = streamPtr->writeResult;
+        }
+        if (result == LE_OK)
+        {
+            result = ProcessBlock(streamPtr, blockPtr);
+        }
+        if (result != LE_OK)
+        {
+            // Unblock the threads waiting for a block.
+            streamPtr->isAborted = true;
+            le_sem_Post(streamPtr->freeSem);
+            le_sem_Post(streamPtr->processedSem);
+            break;
+        }
+
+        bool isLast = (blockPtr->inSize < STREAM_BLOCK_SIZE);
+        le_sem_Post((writerRef != NULL) ? streamPtr->processedSem : streamPtr->freeSem);
+        if (isLast)
+        {
+            break;
+        }
+    }
+
+    le_thread_Join(readerRef, NULL);
+    if (writerRef != NULL)
+    {
+        le_thread_Join(writerRef, NULL);
+        if (result == LE_OK)
+        {
+            result = streamPtr->writeResult;
+        }
+    }
+
+    le_sem_Delete(streamPtr->freeSem);
+    le_sem_Delete(streamPtr->readSem);
+    le_sem_Delete(streamPtr->processedSem);
+    le_mem_Release(streamPtr->blocks);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component.
+ */
+//--------------------------------------------------------------------------------------------------
+void iksStream_Init
+(
+    void
+)
+{
+    RingPool = le_mem_CreatePool("IksStreamRingPool", STREAM_NUM_BLOCKS * sizeof(Block_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Transform all the data of a file descriptor, until the end of file, and write the output to
+ * another one.  Both file descriptors are closed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if a file descriptor is invalid.
+ *      LE_OUT_OF_RANGE if the data size is not a multiple of the alignment.
+ *      LE_IO_ERROR if reading or writing failed.
+ *      LE_TIMEOUT if a block was not read or written within STREAM_BLOCK_TIMEOUT_MS.
+ *      Otherwise the error returned by transformFunc.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t iksStream_Transform
+(
+    uint64_t session,                       ///< [IN] Session reference.
+    int inFd,                               ///< [IN] Input file descriptor.
+    int outFd,                              ///< [IN] Output file descriptor.
+    size_t alignment,                       ///< [IN] Data size must be a multiple of this.
+    iksStream_TransformFunc_t transformFunc ///< [IN] Routine transforming the chunks.
+)
+{
+    Stream_t stream =
+    {
+        .session = session,
+        .inFd = inFd,
+        .outFd = outFd,
+        .alignment = alignment,
+        .transformFunc = transformFunc,
+        .digestFunc = NULL
+    };
+    le_result_t result = LE_BAD_PARAMETER;
+
+    if ((inFd >= 0) && (outFd >= 0))
+    {
+        result = RunStream(&stream);
+    }
+
+    if (inFd >= 0)
+    {
+        close(inFd);
+    }
+    if (outFd >= 0)
+    {
+        close(outFd);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process all the message of a file descriptor, until the end of file.  The file descriptor is
+ * closed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if the file descriptor is invalid.
+ *      LE_IO_ERROR if reading failed.
+ *      LE_TIMEOUT if a block was not read within STREAM_BLOCK_TIMEOUT_MS.
+ *      Otherwise the error returned by digestFunc.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t iksStream_Digest
+(
+    uint64_t session,                       ///< [IN] Session reference.
+    int inFd,                               ///< [IN] Input file descriptor.
+    iksStream_DigestFunc_t digestFunc       ///< [IN] Routine processing the chunks.
+)
+{
+    Stream_t stream =
+    {
+        .session = session,
+        .inFd = inFd,
+        .outFd = -1,
+        .alignment = 1,
+        .transformFunc = NULL,
+        .digestFunc = digestFunc
+    };
+    le_result_t result;
+
+    if (inFd < 0)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    result = RunStream(&stream);
+    close(inFd);
+
+    return result;
+}
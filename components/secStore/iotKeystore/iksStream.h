@@ -0,0 +1,105 @@
+/** @file iksStream.h
+ *
+ * Bulk processing of file descriptors by the IoT KeyStore's streaming routines.
+ *
+ * The data is read from an input file descriptor in large blocks by a reader thread, processed by
+ * the platform adaptor in the calling thread, and written to an output file descriptor by a writer
+ * thread, so that reading, processing and writing the successive blocks overlap.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_IKS_STREAM_INCLUDE_GUARD
+#define LEGATO_IKS_STREAM_INCLUDE_GUARD
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Platform adaptor routine transforming a chunk of data of at most LE_IKS_MAX_PACKET_SIZE bytes,
+ * e.g. pa_iks_aesGcm_Encrypt().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef le_result_t (*iksStream_TransformFunc_t)
+(
+    uint64_t session,       ///< [IN] Session reference.
+    const uint8_t* inPtr,   ///< [IN] Input chunk.
+    size_t inSize,          ///< [IN] Input chunk size.
+    uint8_t* outPtr,        ///< [OUT] Buffer to hold the output chunk.
+    size_t* outSizePtr      ///< [INOUT] Output chunk size.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Platform adaptor routine processing a chunk of message of at most LE_IKS_MAX_PACKET_SIZE bytes,
+ * e.g. pa_iks_hmac_ProcessChunk().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef le_result_t (*iksStream_DigestFunc_t)
+(
+    uint64_t session,       ///< [IN] Session reference.
+    const uint8_t* msgPtr,  ///< [IN] Message chunk.
+    size_t msgSize          ///< [IN] Message chunk size.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component.
+ */
+//--------------------------------------------------------------------------------------------------
+void iksStream_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Transform all the data of a file descriptor, until the end of file, and write the output to
+ * another one.  Both file descriptors are closed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if a file descriptor is invalid.
+ *      LE_OUT_OF_RANGE if the data size is not a multiple of the alignment.
+ *      LE_IO_ERROR if reading or writing failed.
+ *      LE_TIMEOUT if a block was not read or written in time.
+ *      Otherwise the error returned by transformFunc.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t iksStream_Transform
+(
+    uint64_t session,                       ///< [IN] Session reference.
+    int inFd,                               ///< [IN] Input file descriptor.
+    int outFd,                              ///< [IN] Output file descriptor.
+    size_t alignment,                       ///< [IN] Data size must be a multiple of this.
+    iksStream_TransformFunc_t transformFunc ///< [IN] Routine transforming the chunks.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process all the message of a file descriptor, until the end of file.  The file descriptor is
+ * closed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if the file descriptor is invalid.
+ *      LE_IO_ERROR if reading failed.
+ *      LE_TIMEOUT if a block was not read in time.
+ *      Otherwise the error returned by digestFunc.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t iksStream_Digest
+(
+    uint64_t session,                       ///< [IN] Session reference.
+    int inFd,                               ///< [IN] Input file descriptor.
+    iksStream_DigestFunc_t digestFunc       ///< [IN] Routine processing the chunks.
+);
+
+#endif // LEGATO_IKS_STREAM_INCLUDE_GUARD
@@ -13,6 +13,10 @@
 #include "pa_iotKeystore.h"
 
 
+#if !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
+// Implemented in software by pa_iotKeystore_openssl.c when
+// LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL is set, like the other blocks below.
+
 LE_SHARED le_result_t pa_iks_GetKey
 (
     const char*     keyId,          ///< [IN] Identifier string.
@@ -84,6 +88,8 @@ LE_SHARED le_result_t pa_iks_HasKeyValue
     return LE_UNSUPPORTED;
 }
 
+#endif // !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
+
 
 LE_SHARED le_result_t pa_iks_SetKeyUpdateKey
 (
@@ -95,6 +101,7 @@ LE_SHARED le_result_t pa_iks_SetKeyUpdateKey
 }
 
 
+#if !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
 LE_SHARED le_result_t pa_iks_GenKeyValue
 (
     uint64_t        keyRef,         ///< [IN] Key reference.
@@ -105,6 +112,8 @@ LE_SHARED le_result_t pa_iks_GenKeyValue
     return LE_UNSUPPORTED;
 }
 
+#endif // !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
+
 
 LE_SHARED le_result_t pa_iks_ProvisionKeyValue
 (
@@ -126,6 +135,7 @@ LE_SHARED le_result_t pa_iks_SaveKey
 }
 
 
+#if !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
 LE_SHARED le_result_t pa_iks_DeleteKey
 (
     uint64_t        keyRef,         ///< [IN] Key reference.
@@ -136,6 +146,8 @@ LE_SHARED le_result_t pa_iks_DeleteKey
     return LE_UNSUPPORTED;
 }
 
+#endif // !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
+
 
 LE_SHARED le_result_t pa_iks_GetPubKeyValue
 (
@@ -252,6 +264,7 @@ LE_SHARED le_result_t pa_iks_GetWrappingKey
 }
 
 
+#if !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
 LE_SHARED le_result_t pa_iks_CreateSession
 (
     uint64_t    keyRef,         ///< [IN] Key reference.
@@ -270,6 +283,8 @@ LE_SHARED le_result_t pa_iks_DeleteSession
     return LE_UNSUPPORTED;
 }
 
+#endif // !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
+
 
 //========================= AES Milenage routines =====================
 
@@ -356,6 +371,7 @@ LE_SHARED le_result_t pa_iks_aesMilenage_DeriveOpc
     return LE_UNSUPPORTED;
 }
 
+#if !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
 //========================= AES GCM routines =====================
 
 
@@ -613,6 +629,8 @@ LE_SHARED le_result_t pa_iks_hmac_Verify
     return LE_UNSUPPORTED;
 }
 
+#endif // !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
+
 
 //========================= RSA routines =====================
 
@@ -827,6 +845,7 @@ LE_SHARED le_result_t pa_iks_ecc_Ecies_DoneDecrypt
 }
 
 
+#if !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
 //--------------------------------------------------------------------------------------------------
 /**
  * Init this component
@@ -835,3 +854,4 @@ LE_SHARED le_result_t pa_iks_ecc_Ecies_DoneDecrypt
 COMPONENT_INIT
 {
 }
+#endif // !LE_CONFIG_IOT_KEYSTORE_PA_DEFAULT_OPENSSL
@@ -0,0 +1,1319 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file pa_iotKeystore_openssl.c
+ *
+ * Software implementation of the symmetric key routines of the @ref c_pa_iotKeystore interface,
+ * using OpenSSL.
+ *
+ * Keys are generated by OpenSSL's random number generator and only live in the memory of the
+ * process: they cannot be saved, provisioned or protected by an update key.  This is meant for
+ * development and for measuring the IoT KeyStore service itself, on platforms without a secure
+ * element.  The functions not implemented here are the ones of pa_iotKeystore_default.c.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+// Keep the HMAC_CTX and CMAC_CTX APIs available without deprecation warnings on OpenSSL 3.
+#define OPENSSL_API_COMPAT 0x10100000L
+
+#include "legato.h"
+#include "interfaces.h"
+#include "pa_iotKeystore.h"
+
+#include <openssl/cmac.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a key identifier, including the terminating null character.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KEY_ID_BYTES            LE_IKS_MAX_KEY_ID_BYTES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a key value.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KEY_VALUE_BYTES         128
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of keys and sessions, used to size the pools and reference maps.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KEY_POOL_SIZE           16
+#define SESSION_POOL_SIZE       16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sizes of the AES GCM nonce and tag, and of the AES CBC initialization vector.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GCM_NONCE_SIZE          LE_IKS_AESGCM_NONCE_SIZE
+#define GCM_TAG_SIZE            LE_IKS_AESGCM_TAG_SIZE
+#define CBC_IV_SIZE             LE_IKS_AES_BLOCK_SIZE
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t   link;                       ///< Link in the list of keys.
+    uint64_t        ref;                        ///< Reference given to the service.
+    char            id[KEY_ID_BYTES];           ///< Identifier.
+    int32_t         type;                       ///< Type (le_iks_KeyType_t).
+    uint32_t        size;                       ///< Size of the value, in bytes.
+    bool            hasValue;                   ///< true once a value has been generated.
+    uint8_t         value[KEY_VALUE_BYTES];     ///< Value.
+}
+Key_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a session.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SESSION_IDLE,       ///< No process started.
+    SESSION_ENCRYPT,    ///< Encryption process started.
+    SESSION_DECRYPT,    ///< Decryption process started.
+    SESSION_MAC,        ///< Message authentication code being computed.
+    SESSION_MAC_DONE    ///< Message authentication code computed, no more data accepted.
+}
+SessionState_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Session.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t            ref;            ///< Reference given to the service.
+    Key_t*              keyPtr;         ///< Key, referenced by the session.
+    SessionState_t      state;          ///< Process in progress.
+    bool                isTextStarted;  ///< AES GCM: text processed, no more AAD accepted.
+    bool                hasData;        ///< AES GCM: AAD, plaintext or ciphertext processed.
+    EVP_CIPHER_CTX*     cipherCtxPtr;   ///< AES GCM and CBC context.
+    HMAC_CTX*           hmacCtxPtr;     ///< HMAC context.
+    CMAC_CTX*           cmacCtxPtr;     ///< AES CMAC context.
+}
+Session_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools and reference maps of the keys and sessions, and list of the keys.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t KeyPool;
+static le_mem_PoolRef_t SessionPool;
+static le_ref_MapRef_t KeyRefMap;
+static le_ref_MapRef_t SessionRefMap;
+static le_dls_List_t KeyList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wipe the value of a key when it is freed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void KeyDestructor
+(
+    void* objPtr    ///< [IN] Key.
+)
+{
+    OPENSSL_cleanse(objPtr, sizeof(Key_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the key of a reference.
+ *
+ * @return The key, or NULL if the reference is invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static Key_t* GetKey
+(
+    uint64_t keyRef     ///< [IN] Key reference.
+)
+{
+    if ((keyRef == 0) || (keyRef > UINTPTR_MAX))
+    {
+        return NULL;
+    }
+
+    return le_ref_Lookup(KeyRefMap, (void*)(uintptr_t)keyRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the session of a reference, checking that its key is of one of the expected types.
+ *
+ * @return The session, or NULL if the reference is invalid or the key of the wrong type.
+ */
+//--------------------------------------------------------------------------------------------------
+static Session_t* GetSession
+(
+    uint64_t sessionRef,    ///< [IN] Session reference.
+    int32_t firstKeyType,   ///< [IN] First expected key type.
+    int32_t lastKeyType     ///< [IN] Last expected key type.
+)
+{
+    Session_t* sessionPtr;
+
+    if ((sessionRef == 0) || (sessionRef > UINTPTR_MAX))
+    {
+        return NULL;
+    }
+
+    sessionPtr = le_ref_Lookup(SessionRefMap, (void*)(uintptr_t)sessionRef);
+    if ((sessionPtr == NULL) ||
+        (sessionPtr->keyPtr->type < firstKeyType) || (sessionPtr->keyPtr->type > lastKeyType))
+    {
+        return NULL;
+    }
+
+    return sessionPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the OpenSSL AES cipher of a mode for a key.
+ */
+//--------------------------------------------------------------------------------------------------
+static const EVP_CIPHER* GetAesCipher
+(
+    const Key_t* keyPtr,    ///< [IN] Key.
+    bool isGcm              ///< [IN] true for GCM, false for CBC.
+)
+{
+    switch (keyPtr->size)
+    {
+        case 16:
+            return isGcm ? EVP_aes_128_gcm() : EVP_aes_128_cbc();
+        case 24:
+            return isGcm ? EVP_aes_192_gcm() : EVP_aes_192_cbc();
+        default:
+            return isGcm ? EVP_aes_256_gcm() : EVP_aes_256_cbc();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the OpenSSL digest of an HMAC key type.
+ */
+//--------------------------------------------------------------------------------------------------
+static const EVP_MD* GetHmacDigest
+(
+    int32_t keyType     ///< [IN] Key type.
+)
+{
+    switch (keyType)
+    {
+        case LE_IKS_KEY_TYPE_HMAC_SHA512:
+            return EVP_sha512();
+        case LE_IKS_KEY_TYPE_HMAC_SHA384:
+            return EVP_sha384();
+        default:
+            return EVP_sha256();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an AES GCM or CBC process on a session.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an internal error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartCipher
+(
+    Session_t* sessionPtr,  ///< [IN] Session.
+    bool isGcm,             ///< [IN] true for GCM, false for CBC.
+    bool isEncrypt,         ///< [IN] true to encrypt, false to decrypt.
+    const uint8_t* ivPtr    ///< [IN] Nonce or initialization vector.
+)
+{
+    EVP_CIPHER_CTX* ctxPtr = sessionPtr->cipherCtxPtr;
+
+    sessionPtr->state = SESSION_IDLE;
+
+    if ((EVP_CipherInit_ex(ctxPtr, GetAesCipher(sessionPtr->keyPtr, isGcm), NULL,
+                           sessionPtr->keyPtr->value, ivPtr, isEncrypt ? 1 : 0) != 1) ||
+        (EVP_CIPHER_CTX_set_padding(ctxPtr, 0) != 1))
+    {
+        return LE_FAULT;
+    }
+
+    sessionPtr->state = isEncrypt ? SESSION_ENCRYPT : SESSION_DECRYPT;
+    sessionPtr->isTextStarted = false;
+    sessionPtr->hasData = false;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encrypt or decrypt a chunk of data on a session.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_BAD_PARAMETER if a buffer is NULL.
+ *      LE_OUT_OF_RANGE if the chunk is too big, or not a multiple of the block size for CBC.
+ *      LE_FAULT if the expected process has not started or there was an internal error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t UpdateCipher
+(
+    Session_t* sessionPtr,      ///< [IN] Session.
+    SessionState_t state,       ///< [IN] Expected state of the session.
+    size_t alignment,           ///< [IN] Chunk sizes must be a multiple of this.
+    const uint8_t* inPtr,       ///< [IN] Input chunk.
+    size_t inSize,              ///< [IN] Input chunk size.
+    uint8_t* outPtr,            ///< [OUT] Buffer to hold the output chunk.
+    size_t* outSizePtr          ///< [INOUT] Output chunk size.
+)
+{
+    int outSize;
+
+    if ((inPtr == NULL) || (outPtr == NULL) || (outSizePtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if ((inSize > LE_IKS_MAX_PACKET_SIZE) || (inSize % alignment != 0) || (*outSizePtr < inSize))
+    {
+        return LE_OUT_OF_RANGE;
+    }
+    if (sessionPtr->state != state)
+    {
+        return LE_FAULT;
+    }
+
+    if (EVP_CipherUpdate(sessionPtr->cipherCtxPtr, outPtr, &outSize, inPtr, (int)inSize) != 1)
+    {
+        return LE_FAULT;
+    }
+
+    sessionPtr->isTextStarted = true;
+    sessionPtr->hasData = true;
+    *outSizePtr = outSize;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a chunk of message to the MAC computed on a session, starting it if needed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the MAC has already been computed or there was an internal error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t UpdateMac
+(
+    Session_t* sessionPtr,      ///< [IN] Session.
+    const uint8_t* msgPtr,      ///< [IN] Message chunk.
+    size_t msgSize              ///< [IN] Message chunk size.
+)
+{
+    const Key_t* keyPtr = sessionPtr->keyPtr;
+    int isOk;
+
+    if (sessionPtr->state == SESSION_MAC_DONE)
+    {
+        return LE_FAULT;
+    }
+
+    if (sessionPtr->state != SESSION_MAC)
+    {
+        if (keyPtr->type == LE_IKS_KEY_TYPE_AES_CMAC)
+        {
+            isOk = CMAC_Init(sessionPtr->cmacCtxPtr, keyPtr->value, keyPtr->size,
+                             GetAesCipher(keyPtr, false), NULL);
+        }
+        else
+        {
+            isOk = HMAC_Init_ex(sessionPtr->hmacCtxPtr, keyPtr->value, (int)keyPtr->size,
+                                GetHmacDigest(keyPtr->type), NULL);
+        }
+        if (isOk != 1)
+        {
+            return LE_FAULT;
+        }
+        sessionPtr->state = SESSION_MAC;
+    }
+
+    if (keyPtr->type == LE_IKS_KEY_TYPE_AES_CMAC)
+    {
+        isOk = CMAC_Update(sessionPtr->cmacCtxPtr, msgPtr, msgSize);
+    }
+    else
+    {
+        isOk = HMAC_Update(sessionPtr->hmacCtxPtr, msgPtr, msgSize);
+    }
+
+    return (isOk == 1) ? LE_OK : LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Complete the MAC computed on a session.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if no message has been processed, the MAC has already been computed or there was
+ *               an internal error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FinalMac
+(
+    Session_t* sessionPtr,      ///< [IN] Session.
+    uint8_t* macPtr,            ///< [OUT] Buffer to hold the MAC, EVP_MAX_MD_SIZE bytes.
+    size_t* macSizePtr          ///< [OUT] MAC size.
+)
+{
+    unsigned int hmacSize;
+    int isOk;
+
+    if (sessionPtr->state != SESSION_MAC)
+    {
+        return LE_FAULT;
+    }
+
+    if (sessionPtr->keyPtr->type == LE_IKS_KEY_TYPE_AES_CMAC)
+    {
+        isOk = CMAC_Final(sessionPtr->cmacCtxPtr, macPtr, macSizePtr);
+    }
+    else
+    {
+        isOk = HMAC_Final(sessionPtr->hmacCtxPtr, macPtr, &hmacSize);
+        *macSizePtr = hmacSize;
+    }
+    sessionPtr->state = SESSION_MAC_DONE;
+
+    return (isOk == 1) ? LE_OK : LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the MAC computed on a session, truncated to the size of the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t DoneMac
+(
+    Session_t* sessionPtr,  ///< [IN] Session.
+    uint8_t* tagBufPtr,     ///< [OUT] Buffer to hold the authentication tag.
+    size_t* tagBufSizePtr   ///< [INOUT] Authentication tag buffer size.
+)
+{
+    uint8_t mac[EVP_MAX_MD_SIZE];
+    size_t macSize;
+    le_result_t result;
+
+    if ((tagBufPtr == NULL) || (tagBufSizePtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    result = FinalMac(sessionPtr, mac, &macSize);
+    if (result == LE_OK)
+    {
+        if (*tagBufSizePtr > macSize)
+        {
+            *tagBufSizePtr = macSize;
+        }
+        memcpy(tagBufPtr, mac, *tagBufSizePtr);
+    }
+
+    OPENSSL_cleanse(mac, sizeof(mac));
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the MAC computed on a session against a tag, possibly truncated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t VerifyMac
+(
+    Session_t* sessionPtr,      ///< [IN] Session.
+    const uint8_t* tagBufPtr,   ///< [IN] Authentication tag to check against.
+    size_t tagBufSize           ///< [IN] Authentication tag size.
+)
+{
+    uint8_t mac[EVP_MAX_MD_SIZE];
+    size_t macSize;
+    le_result_t result;
+
+    if ((tagBufPtr == NULL) || (tagBufSize == 0))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    result = FinalMac(sessionPtr, mac, &macSize);
+    if ((result == LE_OK) &&
+        ((tagBufSize > macSize) || (CRYPTO_memcmp(mac, tagBufPtr, tagBufSize) != 0)))
+    {
+        result = LE_FAULT;
+    }
+
+    OPENSSL_cleanse(mac, sizeof(mac));
+    return result;
+}
+
+
+//========================= Key management routines =====================
+
+
+LE_SHARED le_result_t pa_iks_GetKey
+(
+    const char*     keyId,          ///< [IN] Identifier string.
+    uint64_t*       keyRefPtr       ///< [OUT] Key reference.
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    if ((keyId == NULL) || (keyRefPtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    for (linkPtr = le_dls_Peek(&KeyList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&KeyList, linkPtr))
+    {
+        Key_t* keyPtr = CONTAINER_OF(linkPtr, Key_t, link);
+
+        if (strcmp(keyPtr->id, keyId) == 0)
+        {
+            *keyRefPtr = keyPtr->ref;
+            return LE_OK;
+        }
+    }
+
+    return LE_NOT_FOUND;
+}
+
+
+LE_SHARED le_result_t pa_iks_CreateKey
+(
+    const char*         keyId,      ///< [IN] Identifier string.
+    uint32_t            keyUsage,   ///< [IN] Key usage.
+    uint64_t*           keyRefPtr   ///< [OUT] Key reference.
+)
+{
+    if (keyUsage != LE_IKS_KEY_USE_ENCRYPT)
+    {
+        return LE_UNSUPPORTED;
+    }
+
+    return pa_iks_CreateKeyByType(keyId, LE_IKS_KEY_TYPE_AES_GCM, 32, keyRefPtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_CreateKeyByType
+(
+    const char*         keyId,      ///< [IN] Identifier string.
+    int32_t             keyType,    ///< [IN] Key type.
+    uint32_t            keySize,    ///< [IN] Key size in bytes.
+    uint64_t*           keyRefPtr   ///< [OUT] Key reference.
+)
+{
+    uint64_t existingRef;
+    le_result_t result;
+
+    if ((keyId == NULL) || (keyRefPtr == NULL) || (keyId[0] == '\0'))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    result = pa_iks_IsKeySizeValid(keyType, keySize);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (pa_iks_GetKey(keyId, &existingRef) == LE_OK)
+    {
+        return LE_DUPLICATE;
+    }
+
+    Key_t* keyPtr = le_mem_ForceAlloc(KeyPool);
+    memset(keyPtr, 0, sizeof(*keyPtr));
+    if (le_utf8_Copy(keyPtr->id, keyId, sizeof(keyPtr->id), NULL) != LE_OK)
+    {
+        le_mem_Release(keyPtr);
+        return LE_BAD_PARAMETER;
+    }
+    keyPtr->type = keyType;
+    keyPtr->size = keySize;
+    keyPtr->link = LE_DLS_LINK_INIT;
+    keyPtr->ref = (uintptr_t)le_ref_CreateRef(KeyRefMap, keyPtr);
+    le_dls_Queue(&KeyList, &keyPtr->link);
+
+    *keyRefPtr = keyPtr->ref;
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_GetKeyType
+(
+    uint64_t            keyRef,     ///< [IN] Key reference.
+    int32_t*            keyTypePtr  ///< [OUT] Key type.
+)
+{
+    Key_t* keyPtr = GetKey(keyRef);
+
+    if ((keyPtr == NULL) || (keyTypePtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    *keyTypePtr = keyPtr->type;
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_GetKeySize
+(
+    uint64_t            keyRef,     ///< [IN] Key reference.
+    uint32_t*           keySizePtr  ///< [OUT] Key size.
+)
+{
+    Key_t* keyPtr = GetKey(keyRef);
+
+    if ((keyPtr == NULL) || (keySizePtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    *keySizePtr = keyPtr->size;
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_IsKeySizeValid
+(
+    int32_t             keyType,    ///< [IN] Key type.
+    uint32_t            keySize     ///< [IN] Key size in bytes.
+)
+{
+    switch (keyType)
+    {
+        case LE_IKS_KEY_TYPE_AES_GCM:
+        case LE_IKS_KEY_TYPE_AES_CBC:
+        case LE_IKS_KEY_TYPE_AES_CMAC:
+            return ((keySize == 16) || (keySize == 24) || (keySize == 32)) ? LE_OK :
+                                                                             LE_OUT_OF_RANGE;
+
+        case LE_IKS_KEY_TYPE_HMAC_SHA512:
+        case LE_IKS_KEY_TYPE_HMAC_SHA384:
+        case LE_IKS_KEY_TYPE_HMAC_SHA256:
+            // Longer keys would be hashed down by HMAC.
+            return ((keySize > 0) &&
+                    (keySize <= (uint32_t)EVP_MD_block_size(GetHmacDigest(keyType)))) ?
+                   LE_OK : LE_OUT_OF_RANGE;
+
+        default:
+            return LE_UNSUPPORTED;
+    }
+}
+
+
+LE_SHARED le_result_t pa_iks_HasKeyValue
+(
+    uint64_t            keyRef      ///< [IN] Key reference.
+)
+{
+    Key_t* keyPtr = GetKey(keyRef);
+
+    if (keyPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return keyPtr->hasValue ? LE_OK : LE_NOT_FOUND;
+}
+
+
+LE_SHARED le_result_t pa_iks_GenKeyValue
+(
+    uint64_t        keyRef,         ///< [IN] Key reference.
+    const uint8_t*  authCmdPtr,     ///< [IN] Authenticated command buffer.
+    size_t          authCmdSize     ///< [IN] Authenticated command buffer size.
+)
+{
+    Key_t* keyPtr = GetKey(keyRef);
+
+    if (keyPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    // Keys cannot have an update key here, so the authenticated command is ignored.
+    if (RAND_bytes(keyPtr->value, (int)keyPtr->size) != 1)
+    {
+        return LE_FAULT;
+    }
+    keyPtr->hasValue = true;
+
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_DeleteKey
+(
+    uint64_t        keyRef,         ///< [IN] Key reference.
+    const uint8_t*  authCmdPtr,     ///< [IN] Authenticated command buffer.
+    size_t          authCmdSize     ///< [IN] Authenticated command buffer size.
+)
+{
+    Key_t* keyPtr = GetKey(keyRef);
+
+    if (keyPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    // The sessions still using the key hold a reference on it.
+    le_ref_DeleteRef(KeyRefMap, (void*)(uintptr_t)keyRef);
+    le_dls_Remove(&KeyList, &keyPtr->link);
+    le_mem_Release(keyPtr);
+
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_CreateSession
+(
+    uint64_t    keyRef,         ///< [IN] Key reference.
+    uint64_t*   sessionRefPtr   ///< [OUT] Session reference.
+)
+{
+    Key_t* keyPtr = GetKey(keyRef);
+
+    if ((keyPtr == NULL) || (!keyPtr->hasValue) || (sessionRefPtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    Session_t* sessionPtr = le_mem_ForceAlloc(SessionPool);
+    memset(sessionPtr, 0, sizeof(*sessionPtr));
+    sessionPtr->cipherCtxPtr = EVP_CIPHER_CTX_new();
+    sessionPtr->hmacCtxPtr = HMAC_CTX_new();
+    sessionPtr->cmacCtxPtr = CMAC_CTX_new();
+    if ((sessionPtr->cipherCtxPtr == NULL) || (sessionPtr->hmacCtxPtr == NULL) ||
+        (sessionPtr->cmacCtxPtr == NULL))
+    {
+        EVP_CIPHER_CTX_free(sessionPtr->cipherCtxPtr);
+        HMAC_CTX_free(sessionPtr->hmacCtxPtr);
+        CMAC_CTX_free(sessionPtr->cmacCtxPtr);
+        le_mem_Release(sessionPtr);
+        return LE_NO_MEMORY;
+    }
+
+    le_mem_AddRef(keyPtr);
+    sessionPtr->keyPtr = keyPtr;
+    sessionPtr->state = SESSION_IDLE;
+    sessionPtr->ref = (uintptr_t)le_ref_CreateRef(SessionRefMap, sessionPtr);
+
+    *sessionRefPtr = sessionPtr->ref;
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_DeleteSession
+(
+    uint64_t            sessionRef  ///< [IN] Session reference.
+)
+{
+    Session_t* sessionPtr = GetSession(sessionRef, INT32_MIN, INT32_MAX);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    le_ref_DeleteRef(SessionRefMap, (void*)(uintptr_t)sessionRef);
+    EVP_CIPHER_CTX_free(sessionPtr->cipherCtxPtr);
+    HMAC_CTX_free(sessionPtr->hmacCtxPtr);
+    CMAC_CTX_free(sessionPtr->cmacCtxPtr);
+    le_mem_Release(sessionPtr->keyPtr);
+    le_mem_Release(sessionPtr);
+
+    return LE_OK;
+}
+
+
+//========================= AES GCM routines =====================
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_EncryptPacket
+(
+    uint64_t        keyRef,             ///< [IN] Key reference.
+    uint8_t*        noncePtr,           ///< [OUT] Buffer to hold the nonce.
+    size_t*         nonceSizePtr,       ///< [INOUT] Nonce size.
+    const uint8_t*  aadPtr,             ///< [IN] Additional authenticated data (AAD).
+    size_t          aadSize,            ///< [IN] AAD size.
+    const uint8_t*  plaintextPtr,       ///< [IN] Plaintext. NULL if not used.
+    size_t          plaintextSize,      ///< [IN] Plaintext size.
+    uint8_t*        ciphertextPtr,      ///< [OUT] Buffer to hold the ciphertext.
+    size_t*         ciphertextSizePtr,  ///< [INOUT] Ciphertext size.
+    uint8_t*        tagPtr,             ///< [OUT] Buffer to hold the authentication tag.
+    size_t*         tagSizePtr          ///< [INOUT] Authentication tag size.
+)
+{
+    uint64_t session;
+    size_t ciphertextSize = 0;
+    le_result_t result;
+
+    if ((aadSize == 0) && (plaintextSize == 0))
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    result = pa_iks_CreateSession(keyRef, &session);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    result = pa_iks_aesGcm_StartEncrypt(session, noncePtr, nonceSizePtr);
+    if ((result == LE_OK) && (aadSize > 0))
+    {
+        result = pa_iks_aesGcm_ProcessAad(session, aadPtr, aadSize);
+    }
+    if ((result == LE_OK) && (plaintextSize > 0))
+    {
+        result = pa_iks_aesGcm_Encrypt(session, plaintextPtr, plaintextSize,
+                                       ciphertextPtr, ciphertextSizePtr);
+        ciphertextSize = (result == LE_OK) ? *ciphertextSizePtr : 0;
+    }
+    if (result == LE_OK)
+    {
+        result = pa_iks_aesGcm_DoneEncrypt(session, tagPtr, tagSizePtr);
+    }
+    if ((result == LE_OK) && (ciphertextSizePtr != NULL))
+    {
+        *ciphertextSizePtr = ciphertextSize;
+    }
+
+    pa_iks_DeleteSession(session);
+    return result;
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_DecryptPacket
+(
+    uint64_t        keyRef,             ///< [IN] Key reference.
+    const uint8_t*  noncePtr,           ///< [IN] Nonce used to encrypt the packet.
+    size_t          nonceSize,          ///< [IN] Nonce size.
+    const uint8_t*  aadPtr,             ///< [IN] Additional authenticated data (AAD).
+    size_t          aadSize,            ///< [IN] AAD size.
+    const uint8_t*  ciphertextPtr,      ///< [IN] Ciphertext. NULL if not used.
+    size_t          ciphertextSize,     ///< [IN] Ciphertext size.
+    uint8_t*        plaintextPtr,       ///< [OUT] Buffer to hold the plaintext.
+    size_t*         plaintextSizePtr,   ///< [INOUT] Plaintext size.
+    const uint8_t*  tagPtr,             ///< [IN] Buffer to hold the authentication tag.
+    size_t          tagSize             ///< [IN] Authentication tag size.
+)
+{
+    uint64_t session;
+    size_t plaintextSize = 0;
+    le_result_t result;
+
+    if ((aadSize == 0) && (ciphertextSize == 0))
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    result = pa_iks_CreateSession(keyRef, &session);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    result = pa_iks_aesGcm_StartDecrypt(session, noncePtr, nonceSize);
+    if ((result == LE_OK) && (aadSize > 0))
+    {
+        result = pa_iks_aesGcm_ProcessAad(session, aadPtr, aadSize);
+    }
+    if ((result == LE_OK) && (ciphertextSize > 0))
+    {
+        result = pa_iks_aesGcm_Decrypt(session, ciphertextPtr, ciphertextSize,
+                                       plaintextPtr, plaintextSizePtr);
+        plaintextSize = (result == LE_OK) ? *plaintextSizePtr : 0;
+    }
+    if (result == LE_OK)
+    {
+        result = pa_iks_aesGcm_DoneDecrypt(session, tagPtr, tagSize);
+    }
+    if (result != LE_OK)
+    {
+        // Do not release unauthenticated plaintext.
+        if ((plaintextPtr != NULL) && (plaintextSize > 0))
+        {
+            OPENSSL_cleanse(plaintextPtr, plaintextSize);
+        }
+    }
+    else if (plaintextSizePtr != NULL)
+    {
+        *plaintextSizePtr = plaintextSize;
+    }
+
+    pa_iks_DeleteSession(session);
+    return result;
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_StartEncrypt
+(
+    uint64_t    session,        ///< [IN] Session reference.
+    uint8_t*    noncePtr,       ///< [OUT] Buffer to hold the nonce.  Assumed to be
+                                ///<       LE_IKS_AES_GCM_NONCE_SIZE bytes.
+    size_t*     nonceSizePtr    ///< [INOUT] Nonce size.
+                                ///<         Expected to be LE_IKS_AESGCM_NONCE_SIZE.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_GCM, LE_IKS_KEY_TYPE_AES_GCM);
+
+    if ((sessionPtr == NULL) || (noncePtr == NULL) || (nonceSizePtr == NULL) ||
+        (*nonceSizePtr < GCM_NONCE_SIZE))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (RAND_bytes(noncePtr, GCM_NONCE_SIZE) != 1)
+    {
+        return LE_FAULT;
+    }
+    *nonceSizePtr = GCM_NONCE_SIZE;
+
+    return StartCipher(sessionPtr, true, true, noncePtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_ProcessAad
+(
+    uint64_t        session,        ///< [IN] Session reference.
+    const uint8_t*  aadChunkPtr,    ///< [IN] AAD chunk.
+    size_t          aadChunkSize    ///< [IN] AAD chunk size.  Must be <= LE_IKS_MAX_PACKET_SIZE.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_GCM, LE_IKS_KEY_TYPE_AES_GCM);
+    int outSize;
+
+    if ((sessionPtr == NULL) || (aadChunkPtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if (aadChunkSize > LE_IKS_MAX_PACKET_SIZE)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+    if (((sessionPtr->state != SESSION_ENCRYPT) && (sessionPtr->state != SESSION_DECRYPT)) ||
+        sessionPtr->isTextStarted)
+    {
+        return LE_FAULT;
+    }
+
+    if (EVP_CipherUpdate(sessionPtr->cipherCtxPtr, NULL, &outSize,
+                         aadChunkPtr, (int)aadChunkSize) != 1)
+    {
+        return LE_FAULT;
+    }
+    sessionPtr->hasData = true;
+
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_Encrypt
+(
+    uint64_t        session,                ///< [IN] Session reference.
+    const uint8_t*  plaintextChunkPtr,      ///< [IN] Plaintext chunk.
+    size_t          plaintextChunkSize,     ///< [IN] Plaintext chunk size.
+    uint8_t*        ciphertextChunkPtr,     ///< [OUT] Buffer to hold the ciphertext chunk.
+    size_t*         ciphertextChunkSizePtr  ///< [INOUT] Ciphertext chunk size.
+                                            ///<         Must be >= plaintextChunkSize.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_GCM, LE_IKS_KEY_TYPE_AES_GCM);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return UpdateCipher(sessionPtr, SESSION_ENCRYPT, 1, plaintextChunkPtr, plaintextChunkSize,
+                        ciphertextChunkPtr, ciphertextChunkSizePtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_DoneEncrypt
+(
+    uint64_t    session,        ///< [IN] Session reference.
+    uint8_t*    tagPtr,         ///< [OUT] Buffer to hold the authentication tag.
+    size_t*     tagSizePtr      ///< [INOUT] Authentication tag size.
+                                ///<         Expected to be LE_IKS_AESGCM_TAG_SIZE.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_GCM, LE_IKS_KEY_TYPE_AES_GCM);
+    uint8_t final[LE_IKS_AES_BLOCK_SIZE];
+    int finalSize;
+
+    if ((sessionPtr == NULL) || (tagPtr == NULL) || (tagSizePtr == NULL) ||
+        (*tagSizePtr < GCM_TAG_SIZE))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if ((sessionPtr->state != SESSION_ENCRYPT) || (!sessionPtr->hasData))
+    {
+        return LE_FAULT;
+    }
+
+    sessionPtr->state = SESSION_IDLE;
+    if ((EVP_EncryptFinal_ex(sessionPtr->cipherCtxPtr, final, &finalSize) != 1) ||
+        (EVP_CIPHER_CTX_ctrl(sessionPtr->cipherCtxPtr, EVP_CTRL_GCM_GET_TAG,
+                             GCM_TAG_SIZE, tagPtr) != 1))
+    {
+        return LE_FAULT;
+    }
+    *tagSizePtr = GCM_TAG_SIZE;
+
+    return LE_OK;
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_StartDecrypt
+(
+    uint64_t        session,        ///< [IN] Session reference.
+    const uint8_t*  noncePtr,       ///< [IN] Nonce used to encrypt the packet.
+    size_t          nonceSize       ///< [IN] Nonce size.
+                                    ///<         Expected to be LE_IKS_AESGCM_NONCE_SIZE.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_GCM, LE_IKS_KEY_TYPE_AES_GCM);
+
+    if ((sessionPtr == NULL) || (noncePtr == NULL) || (nonceSize != GCM_NONCE_SIZE))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return StartCipher(sessionPtr, true, false, noncePtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_Decrypt
+(
+    uint64_t        session,                ///< [IN] Session reference.
+    const uint8_t*  ciphertextChunkPtr,     ///< [IN] Ciphertext chunk.
+    size_t          ciphertextChunkSize,    ///< [IN] Ciphertext chunk size.
+    uint8_t*        plaintextChunkPtr,      ///< [OUT] Buffer to hold the plaintext chunk.
+    size_t*         plaintextChunkSizePtr   ///< [INOUT] Plaintext chunk size.
+                                            ///<         Must be >= ciphertextSize.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_GCM, LE_IKS_KEY_TYPE_AES_GCM);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return UpdateCipher(sessionPtr, SESSION_DECRYPT, 1, ciphertextChunkPtr, ciphertextChunkSize,
+                        plaintextChunkPtr, plaintextChunkSizePtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesGcm_DoneDecrypt
+(
+    uint64_t        session,    ///< [IN] Session reference.
+    const uint8_t*  tagPtr,     ///< [IN] Buffer to hold the authentication tag.
+    size_t          tagSize     ///< [IN] Authentication tag size.
+                                ///<         Expected to be LE_IKS_AESGCM_TAG_SIZE.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_GCM, LE_IKS_KEY_TYPE_AES_GCM);
+    uint8_t final[LE_IKS_AES_BLOCK_SIZE];
+    int finalSize;
+
+    if ((sessionPtr == NULL) || (tagPtr == NULL) || (tagSize != GCM_TAG_SIZE))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if ((sessionPtr->state != SESSION_DECRYPT) || (!sessionPtr->hasData))
+    {
+        return LE_FAULT;
+    }
+
+    sessionPtr->state = SESSION_IDLE;
+    if ((EVP_CIPHER_CTX_ctrl(sessionPtr->cipherCtxPtr, EVP_CTRL_GCM_SET_TAG,
+                             GCM_TAG_SIZE, (void*)tagPtr) != 1) ||
+        (EVP_DecryptFinal_ex(sessionPtr->cipherCtxPtr, final, &finalSize) != 1))
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//========================= AES CBC routines =====================
+
+
+LE_SHARED le_result_t pa_iks_aesCbc_StartEncrypt
+(
+    uint64_t session,           ///< [IN] Session reference.
+    const uint8_t* ivPtr,       ///< [IN] Initialization vector.
+    size_t ivSize               ///< [IN] IV size. Assumed to be LE_IKS_AESCBC_IV_SIZE bytes.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_CBC, LE_IKS_KEY_TYPE_AES_CBC);
+
+    if ((sessionPtr == NULL) || (ivPtr == NULL) || (ivSize != CBC_IV_SIZE))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return StartCipher(sessionPtr, false, true, ivPtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesCbc_Encrypt
+(
+    uint64_t session,                   ///< [IN] Session reference.
+    const uint8_t* plaintextChunkPtr,   ///< [IN] Plaintext chunk.
+    size_t plaintextChunkSize,          ///< [IN] Plaintext chunk size.
+                                        ///<      Must be <= LE_IKS_MAX_PACKET_SIZE and
+                                        ///<      a multiple of LE_IKS_AES_BLOCK_SIZE.
+    uint8_t* ciphertextChunkPtr,        ///< [OUT] Buffer to hold the ciphertext chunk.
+    size_t* ciphertextChunkSizePtr      ///< [INOUT] Ciphertext chunk size.
+                                        ///<         Must be >= plaintextChunkSize.
+
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_CBC, LE_IKS_KEY_TYPE_AES_CBC);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return UpdateCipher(sessionPtr, SESSION_ENCRYPT, LE_IKS_AES_BLOCK_SIZE,
+                        plaintextChunkPtr, plaintextChunkSize,
+                        ciphertextChunkPtr, ciphertextChunkSizePtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesCbc_StartDecrypt
+(
+    uint64_t session,       ///< [IN] Session reference.
+    const uint8_t* ivPtr,   ///< [IN] Initialization vector.
+    size_t ivSize           ///< [IN] IV size. Assumed to be LE_IKS_AESCBC_IV_SIZE bytes.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_CBC, LE_IKS_KEY_TYPE_AES_CBC);
+
+    if ((sessionPtr == NULL) || (ivPtr == NULL) || (ivSize != CBC_IV_SIZE))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return StartCipher(sessionPtr, false, false, ivPtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesCbc_Decrypt
+(
+    uint64_t session,                   ///< [IN] Session reference.
+    const uint8_t* ciphertextChunkPtr,  ///< [IN] Ciphertext chunk.
+    size_t ciphertextChunkSize,         ///< [IN] Ciphertext chunk size.
+                                        ///<      Must be <= LE_IKS_MAX_PACKET_SIZE and
+                                        ///<      a multiple of LE_IKS_AES_BLOCK_SIZE.
+    uint8_t* plaintextChunkPtr,         ///< [OUT] Buffer to hold the plaintext chunk.
+    size_t* plaintextChunkSizePtr       ///< [INOUT] Plaintext buffer size.
+                                        ///<         Must be >= ciphertextChunkSize.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_CBC, LE_IKS_KEY_TYPE_AES_CBC);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return UpdateCipher(sessionPtr, SESSION_DECRYPT, LE_IKS_AES_BLOCK_SIZE,
+                        ciphertextChunkPtr, ciphertextChunkSize,
+                        plaintextChunkPtr, plaintextChunkSizePtr);
+}
+
+
+//========================= AES CMAC routines =====================
+
+
+LE_SHARED le_result_t pa_iks_aesCmac_ProcessChunk
+(
+    uint64_t session,           ///< [IN] Session reference.
+    const uint8_t* msgChunkPtr, ///< [IN] Message chunk.
+    size_t msgChunkSize         ///< [IN] Message chunk size. Must be <= LE_IKS_MAX_PACKET_SIZE.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_CMAC,
+                                       LE_IKS_KEY_TYPE_AES_CMAC);
+
+    if ((sessionPtr == NULL) || (msgChunkPtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if (msgChunkSize > LE_IKS_MAX_PACKET_SIZE)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    return UpdateMac(sessionPtr, msgChunkPtr, msgChunkSize);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesCmac_Done
+(
+    uint64_t session,       ///< [IN] Session reference.
+    uint8_t* tagBufPtr,     ///< [OUT] Buffer to hold the authentication tag.
+    size_t* tagBufSizePtr   ///< [INOUT] Authentication tag buffer size.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_CMAC,
+                                       LE_IKS_KEY_TYPE_AES_CMAC);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return DoneMac(sessionPtr, tagBufPtr, tagBufSizePtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_aesCmac_Verify
+(
+    uint64_t session,           ///< [IN] Session reference.
+    const uint8_t* tagBufPtr,   ///< [IN] Authentication tag to check against.
+    size_t tagBufSize           ///< [IN] Authentication tag size. Cannot be zero.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_AES_CMAC,
+                                       LE_IKS_KEY_TYPE_AES_CMAC);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return VerifyMac(sessionPtr, tagBufPtr, tagBufSize);
+}
+
+
+//========================= HMAC routines =====================
+
+
+LE_SHARED le_result_t pa_iks_hmac_ProcessChunk
+(
+    uint64_t session,           ///< [IN] Session reference.
+    const uint8_t* msgChunkPtr, ///< [IN] Message chunk.
+    size_t msgChunkSize         ///< [IN] Message chunk size. Must be <= LE_IKS_MAX_PACKET_SIZE.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_HMAC_SHA512,
+                                       LE_IKS_KEY_TYPE_HMAC_SHA256);
+
+    if ((sessionPtr == NULL) || (msgChunkPtr == NULL))
+    {
+        return LE_BAD_PARAMETER;
+    }
+    if (msgChunkSize > LE_IKS_MAX_PACKET_SIZE)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    return UpdateMac(sessionPtr, msgChunkPtr, msgChunkSize);
+}
+
+
+LE_SHARED le_result_t pa_iks_hmac_Done
+(
+    uint64_t session,       ///< [IN] Session reference.
+    uint8_t* tagBufPtr,     ///< [OUT] Buffer to hold the authentication tag.
+    size_t* tagBufSizePtr   ///< [INOUT] Authentication tag buffer size.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_HMAC_SHA512,
+                                       LE_IKS_KEY_TYPE_HMAC_SHA256);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return DoneMac(sessionPtr, tagBufPtr, tagBufSizePtr);
+}
+
+
+LE_SHARED le_result_t pa_iks_hmac_Verify
+(
+    uint64_t session,           ///< [IN] Session reference.
+    const uint8_t* tagBufPtr,   ///< [IN] Authentication tag to check against.
+    size_t tagBufSize           ///< [IN] Authentication tag size. Cannot be zero.
+)
+{
+    Session_t* sessionPtr = GetSession(session, LE_IKS_KEY_TYPE_HMAC_SHA512,
+                                       LE_IKS_KEY_TYPE_HMAC_SHA256);
+
+    if (sessionPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    return VerifyMac(sessionPtr, tagBufPtr, tagBufSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Component initializer.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    KeyPool = le_mem_CreatePool("IksSwKeyPool", sizeof(Key_t));
+    le_mem_ExpandPool(KeyPool, KEY_POOL_SIZE);
+    le_mem_SetDestructor(KeyPool, KeyDestructor);
+    KeyRefMap = le_ref_CreateMap("IksSwKeyRefMap", KEY_POOL_SIZE);
+
+    SessionPool = le_mem_CreatePool("IksSwSessionPool", sizeof(Session_t));
+    le_mem_ExpandPool(SessionPool, SESSION_POOL_SIZE);
+    SessionRefMap = le_ref_CreateMap("IksSwSessionRefMap", SESSION_POOL_SIZE);
+}
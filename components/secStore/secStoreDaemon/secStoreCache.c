@@ -0,0 +1,964 @@
+/** @file secStoreCache.c
+ *
+ * Write-back cache between the Secure Storage Daemon and the secure storage platform adaptor.
+ *
+ * Every pa_secStore_Write() encrypts the item and commits the secure storage, so a client updating
+ * the same small items many times pays for each update.  Items of at most
+ * LE_CONFIG_SECSTORE_CACHE_ITEM_SIZE bytes are instead kept in a pool of cache entries, looked up
+ * by path in a hash map, and marked dirty when written.  The dirty entries are committed together
+ * LE_CONFIG_SECSTORE_CACHE_COMMIT_DELAY ms after the first of them was written, unless a client
+ * has a batch write open, in which case they are committed when the batch ends.  A write to an
+ * item that is already dirty does not cost anything more.
+ *
+ * To keep a group of items consistent across a reset, the group is serialized in one journal item
+ * before the items are written, and the journal is deleted after.  A journal found on start is
+ * replayed as a whole.  Groups are limited to what fits in one item of LE_SECSTORE_MAX_ITEM_SIZE
+ * bytes, so a larger batch is committed as several groups, each of them consistent.
+ *
+ * Clean entries are kept as a read cache, and the least recently used one is recycled when the
+ * pool is exhausted.  If all the entries are dirty, they are committed first.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "secStoreServer.h"
+#include "secStoreCache.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of cache entries.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_ENTRIES           LE_CONFIG_SECSTORE_CACHE_ENTRIES
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a cached item.  Larger items are written through.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_ITEM_MAX_BYTES    LE_CONFIG_SECSTORE_CACHE_ITEM_SIZE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum delay, in ms, between the first write to a clean item and its commit.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMMIT_DELAY_MS         LE_CONFIG_SECSTORE_CACHE_COMMIT_DELAY
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of clients with a batch write open at the same time.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_BATCH_SESSIONS      8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the journal item.  App and user areas cannot start with a '.'.
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_PATH            "/.journal"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the journal item.
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_MAX_BYTES       LE_SECSTORE_MAX_ITEM_SIZE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * First word of the journal.
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_MAGIC           0x4c4e524aU
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Journal header: magic and number of items.
+ */
+//--------------------------------------------------------------------------------------------------
+#define JOURNAL_HEADER_BYTES    (2 * sizeof(uint32_t))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Journal record header: path length and item size, followed by the path and the data.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_HEADER_BYTES     (2 * sizeof(uint16_t))
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[SECSTORE_MAX_PATH_BYTES];     ///< Path of the item.  Key of the hash map.
+    le_dls_Link_t lruLink;                  ///< Link in LruList.
+    le_dls_Link_t dirtyLink;                ///< Link in DirtyList, if the entry is dirty.
+    bool isDirty;                           ///< true if the item is not committed yet.
+    size_t size;                            ///< Size of the item.
+    uint8_t data[CACHE_ITEM_MAX_BYTES];     ///< Data of the item.
+}
+Entry_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of cache entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t EntryPool = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache entries by path.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t EntryMap = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache entries, least recently used first.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t LruList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dirty cache entries, first written first.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t DirtyList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client sessions with a batch write open.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t BatchSessionMap = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer committing the dirty entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t CommitTimer = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the journal left by a previous run, if any, has been replayed.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRecovered = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if a journal may be left in secure storage by a commit that failed.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsJournalPending = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer to serialize and parse the journal.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t JournalBuf[JOURNAL_MAX_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a platform adaptor error may go away if the operation is retried later.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsTransientError
+(
+    le_result_t result              ///< [IN] Result of the platform adaptor.
+)
+{
+    return (result == LE_UNAVAILABLE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if an item path is a path or under it.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsUnder
+(
+    const char* itemPathPtr,        ///< [IN] Item path.
+    const char* pathPtr             ///< [IN] Path.
+)
+{
+    size_t len = strlen(pathPtr);
+
+    while ((len > 0) && (pathPtr[len - 1] == '/'))
+    {
+        len--;
+    }
+
+    return (strncmp(itemPathPtr, pathPtr, len) == 0) &&
+           ((itemPathPtr[len] == '\0') || (itemPathPtr[len] == '/'));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes an entry from the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DropEntry
+(
+    Entry_t* entryPtr               ///< [IN] Entry.
+)
+{
+    if (entryPtr->isDirty)
+    {
+        le_dls_Remove(&DirtyList, &entryPtr->dirtyLink);
+    }
+    le_dls_Remove(&LruList, &entryPtr->lruLink);
+    le_hashmap_Remove(EntryMap, entryPtr->path);
+    le_mem_Release(entryPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the items of a journal.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FORMAT_ERROR if the journal is corrupted.  Nothing is written in this case.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReplayJournal
+(
+    size_t journalSize              ///< [IN] Size of the journal in JournalBuf.
+)
+{
+    uint32_t magic;
+    uint32_t count;
+    uint32_t i;
+    size_t offset;
+
+    if (journalSize < JOURNAL_HEADER_BYTES)
+    {
+        return LE_FORMAT_ERROR;
+    }
+    memcpy(&magic, JournalBuf, sizeof(magic));
+    memcpy(&count, JournalBuf + sizeof(magic), sizeof(count));
+    if (magic != JOURNAL_MAGIC)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    // Check the whole journal before writing anything.
+    for (i = 0, offset = JOURNAL_HEADER_BYTES; i < count; i++)
+    {
+        uint16_t header[2];
+
+        if (offset + RECORD_HEADER_BYTES > journalSize)
+        {
+            return LE_FORMAT_ERROR;
+        }
+        memcpy(header, JournalBuf + offset, sizeof(header));
+        offset += RECORD_HEADER_BYTES + header[0] + header[1];
+        if ((header[0] == 0) || (header[0] >= SECSTORE_MAX_PATH_BYTES) || (offset > journalSize))
+        {
+            return LE_FORMAT_ERROR;
+        }
+    }
+    if (offset != journalSize)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    for (i = 0, offset = JOURNAL_HEADER_BYTES; i < count; i++)
+    {
+        char path[SECSTORE_MAX_PATH_BYTES];
+        uint16_t header[2];
+        le_result_t result;
+
+        memcpy(header, JournalBuf + offset, sizeof(header));
+        offset += RECORD_HEADER_BYTES;
+        memcpy(path, JournalBuf + offset, header[0]);
+        path[header[0]] = '\0';
+        offset += header[0];
+
+        result = pa_secStore_Write(path, JournalBuf + offset, header[1]);
+        if (IsTransientError(result))
+        {
+            return result;
+        }
+        LE_ERROR_IF(result != LE_OK, "Could not write '%s' from the journal: %s.",
+                    path, LE_RESULT_TXT(result));
+        offset += header[1];
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replays the journal left by a commit interrupted in a previous run, if not done yet.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Recover
+(
+    void
+)
+{
+    size_t journalSize = sizeof(JournalBuf);
+    le_result_t result;
+
+    if (IsRecovered)
+    {
+        return LE_OK;
+    }
+
+    result = pa_secStore_Read(JOURNAL_PATH, JournalBuf, &journalSize);
+    if (IsTransientError(result))
+    {
+        return result;
+    }
+
+    if (result == LE_OK)
+    {
+        result = ReplayJournal(journalSize);
+        if (IsTransientError(result))
+        {
+            return result;
+        }
+        if (result == LE_OK)
+        {
+            LE_INFO("Replayed the secure storage journal.");
+        }
+        else
+        {
+            LE_ERROR("Discarding the corrupted secure storage journal.");
+        }
+    }
+    else if (result != LE_NOT_FOUND)
+    {
+        LE_ERROR("Could not read the secure storage journal: %s.", LE_RESULT_TXT(result));
+    }
+
+    if (result != LE_NOT_FOUND)
+    {
+        pa_secStore_Delete(JOURNAL_PATH);
+    }
+    IsRecovered = true;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commits a group of dirty entries from the head of DirtyList.  The entries committed are marked
+ * clean, and the entries that could not be written because of a permanent error are dropped.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CommitGroup
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&DirtyList);
+    size_t journalSize = JOURNAL_HEADER_BYTES;
+    uint32_t count = 0;
+    uint32_t magic = JOURNAL_MAGIC;
+    uint32_t i;
+    le_result_t result;
+
+    // Serialize as many entries as fit in the journal.
+    while (linkPtr != NULL)
+    {
+        Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, dirtyLink);
+        uint16_t header[2] = { strlen(entryPtr->path), entryPtr->size };
+        size_t recordSize = RECORD_HEADER_BYTES + header[0] + header[1];
+
+        if (journalSize + recordSize > sizeof(JournalBuf))
+        {
+            break;
+        }
+        memcpy(JournalBuf + journalSize, header, sizeof(header));
+        memcpy(JournalBuf + journalSize + RECORD_HEADER_BYTES, entryPtr->path, header[0]);
+        memcpy(JournalBuf + journalSize + RECORD_HEADER_BYTES + header[0], entryPtr->data,
+               header[1]);
+        journalSize += recordSize;
+        count++;
+
+        linkPtr = le_dls_PeekNext(&DirtyList, linkPtr);
+    }
+    memcpy(JournalBuf, &magic, sizeof(magic));
+    memcpy(JournalBuf + sizeof(magic), &count, sizeof(count));
+
+    // A single item does not need a journal.
+    if (count > 1)
+    {
+        result = pa_secStore_Write(JOURNAL_PATH, JournalBuf, journalSize);
+        if (IsTransientError(result))
+        {
+            return result;
+        }
+        if (result == LE_OK)
+        {
+            IsJournalPending = true;
+        }
+        else
+        {
+            // Still commit the group, only without the journal.
+            LE_ERROR("Could not write the secure storage journal: %s.", LE_RESULT_TXT(result));
+            count = 1;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        Entry_t* entryPtr = CONTAINER_OF(le_dls_Peek(&DirtyList), Entry_t, dirtyLink);
+
+        result = pa_secStore_Write(entryPtr->path, entryPtr->data, entryPtr->size);
+        if (IsTransientError(result))
+        {
+            return result;
+        }
+        if (result == LE_OK)
+        {
+            le_dls_Remove(&DirtyList, &entryPtr->dirtyLink);
+            entryPtr->isDirty = false;
+        }
+        else
+        {
+            // Do not serve a value that will not survive a reset.
+            LE_ERROR("Could not write '%s': %s.", entryPtr->path, LE_RESULT_TXT(result));
+            DropEntry(entryPtr);
+        }
+    }
+
+    if (IsJournalPending)
+    {
+        pa_secStore_Delete(JOURNAL_PATH);
+        IsJournalPending = false;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the commit timer, unless it is already running or a batch write is open.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScheduleCommit
+(
+    void
+)
+{
+    if (!le_timer_IsRunning(CommitTimer) && le_hashmap_isEmpty(BatchSessionMap))
+    {
+        le_timer_Start(CommitTimer);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commits the dirty entries when the commit delay expires.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CommitTimerHandler
+(
+    le_timer_Ref_t timerRef         ///< [IN] Commit timer.
+)
+{
+    LE_UNUSED(timerRef);
+
+    if (le_hashmap_isEmpty(BatchSessionMap))
+    {
+        secStoreCache_Flush();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marks an entry as the most recently used.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TouchEntry
+(
+    Entry_t* entryPtr               ///< [IN] Entry.
+)
+{
+    le_dls_Remove(&LruList, &entryPtr->lruLink);
+    le_dls_Queue(&LruList, &entryPtr->lruLink);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets an entry for a path not in the cache, recycling the least recently used clean entry if the
+ * pool is exhausted.
+ *
+ * @return
+ *      Entry, or NULL if all the entries are dirty and cannot be committed now.
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* NewEntry
+(
+    const char* pathPtr             ///< [IN] Path of the item.
+)
+{
+    Entry_t* entryPtr = le_mem_TryAlloc(EntryPool);
+
+    if (entryPtr == NULL)
+    {
+        le_dls_Link_t* linkPtr;
+
+        if (le_dls_NumLinks(&DirtyList) == CACHE_ENTRIES)
+        {
+            secStoreCache_Flush();
+        }
+
+        for (linkPtr = le_dls_Peek(&LruList);
+             linkPtr != NULL;
+             linkPtr = le_dls_PeekNext(&LruList, linkPtr))
+        {
+            Entry_t* oldEntryPtr = CONTAINER_OF(linkPtr, Entry_t, lruLink);
+
+            if (!oldEntryPtr->isDirty)
+            {
+                DropEntry(oldEntryPtr);
+                break;
+            }
+        }
+
+        entryPtr = le_mem_TryAlloc(EntryPool);
+        if (entryPtr == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    LE_ASSERT(le_utf8_Copy(entryPtr->path, pathPtr, sizeof(entryPtr->path), NULL) == LE_OK);
+    entryPtr->lruLink = LE_DLS_LINK_INIT;
+    entryPtr->dirtyLink = LE_DLS_LINK_INIT;
+    entryPtr->isDirty = false;
+    entryPtr->size = 0;
+
+    le_hashmap_Put(EntryMap, entryPtr->path, entryPtr);
+    le_dls_Queue(&LruList, &entryPtr->lruLink);
+
+    return entryPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes an item.  Items small enough to be cached are committed later.
+ *
+ * @return
+ *      Same as pa_secStore_Write().  Errors of a deferred commit are only logged, and the item is
+ *      dropped from the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Write
+(
+    const char* pathPtr,            ///< [IN] Path to write to.
+    const uint8_t* bufPtr,          ///< [IN] Buffer containing the data to write.
+    size_t bufSize                  ///< [IN] Size of the buffer.
+)
+{
+    Entry_t* entryPtr;
+
+    if (Recover() != LE_OK)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    entryPtr = le_hashmap_Get(EntryMap, pathPtr);
+
+    if (bufSize > CACHE_ITEM_MAX_BYTES)
+    {
+        // Written through.  A cached value, even dirty, is superseded.
+        if (entryPtr != NULL)
+        {
+            DropEntry(entryPtr);
+        }
+        return pa_secStore_Write(pathPtr, bufPtr, bufSize);
+    }
+
+    if (entryPtr == NULL)
+    {
+        entryPtr = NewEntry(pathPtr);
+        if (entryPtr == NULL)
+        {
+            return pa_secStore_Write(pathPtr, bufPtr, bufSize);
+        }
+    }
+    else
+    {
+        TouchEntry(entryPtr);
+    }
+
+    memcpy(entryPtr->data, bufPtr, bufSize);
+    entryPtr->size = bufSize;
+    if (!entryPtr->isDirty)
+    {
+        entryPtr->isDirty = true;
+        le_dls_Queue(&DirtyList, &entryPtr->dirtyLink);
+    }
+
+    if ((COMMIT_DELAY_MS == 0) && le_hashmap_isEmpty(BatchSessionMap))
+    {
+        secStoreCache_Flush();
+    }
+    else
+    {
+        ScheduleCommit();
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads an item, from the cache if it is there.
+ *
+ * @return
+ *      Same as pa_secStore_Read().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Read
+(
+    const char* pathPtr,            ///< [IN] Path to read from.
+    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
+    size_t* bufSizePtr              ///< [IN/OUT] Size of buffer when this function is called.
+                                    ///          Number of bytes read when this function returns.
+)
+{
+    Entry_t* entryPtr;
+    le_result_t result;
+
+    if (Recover() != LE_OK)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    entryPtr = le_hashmap_Get(EntryMap, pathPtr);
+    if (entryPtr != NULL)
+    {
+        if (*bufSizePtr < entryPtr->size)
+        {
+            return LE_OVERFLOW;
+        }
+        memcpy(bufPtr, entryPtr->data, entryPtr->size);
+        *bufSizePtr = entryPtr->size;
+        TouchEntry(entryPtr);
+        return LE_OK;
+    }
+
+    result = pa_secStore_Read(pathPtr, bufPtr, bufSizePtr);
+
+    if ((result == LE_OK) && (*bufSizePtr <= CACHE_ITEM_MAX_BYTES))
+    {
+        entryPtr = NewEntry(pathPtr);
+        if (entryPtr != NULL)
+        {
+            memcpy(entryPtr->data, bufPtr, *bufSizePtr);
+            entryPtr->size = *bufSizePtr;
+        }
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a path and all the cached items under it.
+ *
+ * @return
+ *      Same as pa_secStore_Delete().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Delete
+(
+    const char* pathPtr             ///< [IN] Path to delete.
+)
+{
+    le_dls_Link_t* linkPtr;
+    bool isDirtyDropped = false;
+    le_result_t result;
+
+    // Do not leave a journal that would bring back the deleted items after a reset.
+    if (IsJournalPending)
+    {
+        secStoreCache_Flush();
+    }
+    else
+    {
+        Recover();
+    }
+
+    linkPtr = le_dls_Peek(&LruList);
+    while (linkPtr != NULL)
+    {
+        Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, lruLink);
+
+        linkPtr = le_dls_PeekNext(&LruList, linkPtr);
+        if (IsUnder(entryPtr->path, pathPtr))
+        {
+            isDirtyDropped = isDirtyDropped || entryPtr->isDirty;
+            DropEntry(entryPtr);
+        }
+    }
+
+    result = pa_secStore_Delete(pathPtr);
+
+    // The item only existed in the cache.
+    if ((result == LE_NOT_FOUND) && isDirtyDropped)
+    {
+        result = LE_OK;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of a path, including the items of the path that are not committed yet.
+ *
+ * @return
+ *      Same as pa_secStore_GetSize().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_GetSize
+(
+    const char* pathPtr,            ///< [IN] Path.
+    size_t* sizePtr                 ///< [OUT] Size in bytes of all items in the path.
+)
+{
+    le_dls_Link_t* linkPtr;
+    Entry_t* entryPtr;
+
+    if (Recover() != LE_OK)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    entryPtr = le_hashmap_Get(EntryMap, pathPtr);
+    if (entryPtr != NULL)
+    {
+        *sizePtr = entryPtr->size;
+        return LE_OK;
+    }
+
+    // Sizes of directories are only known by the platform adaptor.
+    for (linkPtr = le_dls_Peek(&DirtyList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&DirtyList, linkPtr))
+    {
+        if (IsUnder(CONTAINER_OF(linkPtr, Entry_t, dirtyLink)->path, pathPtr))
+        {
+            secStoreCache_Flush();
+            break;
+        }
+    }
+
+    return pa_secStore_GetSize(pathPtr, sizePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch write for a client session.  Until it ends, the commit delay does not apply.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreCache_StartBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Client session.
+)
+{
+    le_hashmap_Put(BatchSessionMap, sessionRef, sessionRef);
+    le_timer_Stop(CommitTimer);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends the batch write of a client session, if any, and commits the cached items.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.  The commit is retried later.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_EndBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Client session.
+)
+{
+    le_hashmap_Remove(BatchSessionMap, sessionRef);
+
+    return secStoreCache_Flush();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replays the journal left by an interrupted commit, if any, and commits the cached items.  Must be
+ * called before any operation reaching the platform adaptor without going through this cache.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.  The commit is retried later.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Flush
+(
+    void
+)
+{
+    le_result_t result = Recover();
+
+    le_timer_Stop(CommitTimer);
+
+    while ((result == LE_OK) && !le_dls_IsEmpty(&DirtyList))
+    {
+        result = CommitGroup();
+    }
+
+    if (result != LE_OK)
+    {
+        LE_WARN("Secure storage unavailable, %" PRIuS " items not committed.",
+                le_dls_NumLinks(&DirtyList));
+        le_timer_Start(CommitTimer);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drops all the cached items, including the ones not committed yet.  Must be called when secure
+ * storage is changed without going through this cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreCache_Invalidate
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    LE_WARN_IF(!le_dls_IsEmpty(&DirtyList),
+               "Dropping %" PRIuS " uncommitted secure storage items.",
+               le_dls_NumLinks(&DirtyList));
+
+    le_timer_Stop(CommitTimer);
+    while ((linkPtr = le_dls_Peek(&LruList)) != NULL)
+    {
+        DropEntry(CONTAINER_OF(linkPtr, Entry_t, lruLink));
+    }
+}
+
+
+#if LE_CONFIG_LINUX
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commits the cached items when the daemon is terminated, then exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TermSignalHandler
+(
+    int sigNum                      ///< [IN] Signal received.
+)
+{
+    LE_UNUSED(sigNum);
+
+    secStoreCache_Flush();
+    LE_INFO("Terminated");
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commits the cached items when a power failure is notified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PowerFailSignalHandler
+(
+    int sigNum                      ///< [IN] Signal received.
+)
+{
+    LE_UNUSED(sigNum);
+
+    LE_WARN("Power failure, committing secure storage.");
+    secStoreCache_Flush();
+}
+#endif /* end LE_CONFIG_LINUX */
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreCache_Init
+(
+    void
+)
+{
+    // Any cached item must fit in the journal.
+    LE_FATAL_IF(JOURNAL_HEADER_BYTES + RECORD_HEADER_BYTES + SECSTORE_MAX_PATH_BYTES +
+                CACHE_ITEM_MAX_BYTES > JOURNAL_MAX_BYTES,
+                "LE_CONFIG_SECSTORE_CACHE_ITEM_SIZE is too large.");
+
+    EntryPool = le_mem_CreatePool("SecStoreCachePool", sizeof(Entry_t));
+    le_mem_ExpandPool(EntryPool, CACHE_ENTRIES);
+    EntryMap = le_hashmap_Create("SecStoreCacheMap", CACHE_ENTRIES, le_hashmap_HashString,
+                                 le_hashmap_EqualsString);
+    BatchSessionMap = le_hashmap_Create("SecStoreBatchMap", MAX_BATCH_SESSIONS,
+                                        le_hashmap_HashVoidPointer, le_hashmap_EqualsVoidPointer);
+
+    CommitTimer = le_timer_Create("SecStoreCommit");
+    le_timer_SetMsInterval(CommitTimer, (COMMIT_DELAY_MS > 0) ? COMMIT_DELAY_MS : 1);
+    le_timer_SetHandler(CommitTimer, CommitTimerHandler);
+
+#if LE_CONFIG_LINUX
+    // Replace the default handler, which exits without committing.
+    le_sig_Block(SIGTERM);
+    le_sig_SetEventHandler(SIGTERM, TermSignalHandler);
+    le_sig_Block(SIGPWR);
+    le_sig_SetEventHandler(SIGPWR, PowerFailSignalHandler);
+#endif
+
+    // The journal of a commit interrupted by a reset must be replayed before any other operation.
+    Recover();
+}
@@ -0,0 +1,204 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file secStoreCache.h
+ *
+ * Write-back cache between the Secure Storage Daemon and the secure storage platform adaptor.
+ *
+ * Small items written by the clients are kept in memory and committed to the platform adaptor in
+ * groups: when the commit delay expires, when the last batch write ends, when the cache is full,
+ * or when the daemon is terminated.  Each group is first written to a journal item in secure
+ * storage, so that a group interrupted by a reset is replayed as a whole on the next start.
+ * Recently read items are served from the cache too.
+ *
+ * Without LE_CONFIG_SECSTORE_WRITE_BACK_CACHE, the routines of this header directly call the
+ * platform adaptor.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_SECSTORE_CACHE_INCLUDE_GUARD
+#define LEGATO_SECSTORE_CACHE_INCLUDE_GUARD
+
+#include "legato.h"
+#include "pa_secStore.h"
+
+#if LE_CONFIG_SECSTORE_WRITE_BACK_CACHE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreCache_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes an item.  Items small enough to be cached are committed later.
+ *
+ * @return
+ *      Same as pa_secStore_Write().  Errors of a deferred commit are only logged, and the item is
+ *      dropped from the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Write
+(
+    const char* pathPtr,            ///< [IN] Path to write to.
+    const uint8_t* bufPtr,          ///< [IN] Buffer containing the data to write.
+    size_t bufSize                  ///< [IN] Size of the buffer.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads an item, from the cache if it is there.
+ *
+ * @return
+ *      Same as pa_secStore_Read().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Read
+(
+    const char* pathPtr,            ///< [IN] Path to read from.
+    uint8_t* bufPtr,                ///< [OUT] Buffer to store the data in.
+    size_t* bufSizePtr              ///< [IN/OUT] Size of buffer when this function is called.
+                                    ///          Number of bytes read when this function returns.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes a path and all the cached items under it.
+ *
+ * @return
+ *      Same as pa_secStore_Delete().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Delete
+(
+    const char* pathPtr             ///< [IN] Path to delete.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the size of a path, including the items of the path that are not committed yet.
+ *
+ * @return
+ *      Same as pa_secStore_GetSize().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_GetSize
+(
+    const char* pathPtr,            ///< [IN] Path.
+    size_t* sizePtr                 ///< [OUT] Size in bytes of all items in the path.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts a batch write for a client session.  Until it ends, the commit delay does not apply.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreCache_StartBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Client session.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends the batch write of a client session, if any, and commits the cached items.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.  The commit is retried later.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_EndBatch
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Client session.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replays the journal left by an interrupted commit, if any, and commits the cached items.  Must be
+ * called before any operation reaching the platform adaptor without going through this cache.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.  The commit is retried later.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t secStoreCache_Flush
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drops all the cached items, including the ones not committed yet.  Must be called when secure
+ * storage is changed without going through this cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void secStoreCache_Invalidate
+(
+    void
+);
+
+#else /* !LE_CONFIG_SECSTORE_WRITE_BACK_CACHE */
+
+static inline void secStoreCache_Init(void) {}
+
+static inline le_result_t secStoreCache_Write
+(
+    const char* pathPtr,
+    const uint8_t* bufPtr,
+    size_t bufSize
+)
+{
+    return pa_secStore_Write(pathPtr, bufPtr, bufSize);
+}
+
+static inline le_result_t secStoreCache_Read
+(
+    const char* pathPtr,
+    uint8_t* bufPtr,
+    size_t* bufSizePtr
+)
+{
+    return pa_secStore_Read(pathPtr, bufPtr, bufSizePtr);
+}
+
+static inline le_result_t secStoreCache_Delete
+(
+    const char* pathPtr
+)
+{
+    return pa_secStore_Delete(pathPtr);
+}
+
+static inline le_result_t secStoreCache_GetSize
+(
+    const char* pathPtr,
+    size_t* sizePtr
+)
+{
+    return pa_secStore_GetSize(pathPtr, sizePtr);
+}
+
+static inline void secStoreCache_StartBatch(le_msg_SessionRef_t sessionRef) {}
+
+static inline le_result_t secStoreCache_EndBatch(le_msg_SessionRef_t sessionRef)
+{
+    return LE_OK;
+}
+
+static inline le_result_t secStoreCache_Flush(void)
+{
+    return LE_OK;
+}
+
+static inline void secStoreCache_Invalidate(void) {}
+
+#endif /* end !LE_CONFIG_SECSTORE_WRITE_BACK_CACHE */
+
+#endif // LEGATO_SECSTORE_CACHE_INCLUDE_GUARD
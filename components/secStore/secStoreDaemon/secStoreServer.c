@@ -23,6 +23,8 @@
 
 #include "limit.h"
 #include "pa_secStore.h"
+#include "secStoreServer.h"
+#include "secStoreCache.h"
 #include "watchdogChain.h"
 #include "user.h"
 
@@ -30,17 +32,6 @@
 #   include "appCfg.h"
 #endif
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Number of bytes in secure storage path buffer.
- */
-//--------------------------------------------------------------------------------------------------
-#ifdef SECSTOREADMIN_MAX_PATH_BYTES
-#   define SECSTORE_MAX_PATH_BYTES SECSTOREADMIN_MAX_PATH_BYTES
-#else
-#   define SECSTORE_MAX_PATH_BYTES 512
-#endif
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Number bytes in a md5 string.
@@ -516,6 +507,15 @@ static le_result_t InitSystems
     void
 )
 {
+    // The systems are moved and copied below the cache.
+    le_result_t result = secStoreCache_Flush();
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+    secStoreCache_Invalidate();
+
     // Get the current system index.
     int currIndex = le_update_GetCurrentSysIndex();
 
@@ -525,7 +525,7 @@ static le_result_t InitSystems
     LE_INFO("current system index=%d,  last good system index=%d", currIndex, LastGoodSystemIndex);
 
     // Get a list of all the systems in secure storage right now.
-    le_result_t result = pa_secStore_GetEntries(SYS_PATH, AddSystemToList, &SecStoreSystems);
+    result = pa_secStore_GetEntries(SYS_PATH, AddSystemToList, &SecStoreSystems);
 
     if (result != LE_OK)
     {
@@ -740,11 +740,11 @@ static le_result_t CheckClientLimit
     le_result_t result;
     size_t usedSpace = 0;
 
-    // Add map to decrease the pa_secStore_GetSize() calling times
+    // Add map to decrease the secStoreCache_GetSize() calling times
     MapContext_t* map = (MapContext_t *)le_hashmap_Get(clientLimitMap, clientPathPtr);
     if(NULL == map)
     {
-        result = pa_secStore_GetSize(clientPathPtr, &usedSpace);
+        result = secStoreCache_GetSize(clientPathPtr, &usedSpace);
 
         if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
         {
@@ -772,7 +772,7 @@ static le_result_t CheckClientLimit
             "Client %s's path for item %s is too long.", clientNamePtr, itemNamePtr);
 
     size_t origItemSize = 0;
-    result = pa_secStore_GetSize(itemPath, &origItemSize);
+    result = secStoreCache_GetSize(itemPath, &origItemSize);
 
     if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
     {
@@ -991,7 +991,7 @@ static le_result_t Write
     }
 
     // Write the item to the secure storage.
-    result = pa_secStore_Write(path, bufPtr, bufNumElements);
+    result = secStoreCache_Write(path, bufPtr, bufNumElements);
 
     if (result == LE_BAD_PARAMETER)
     {
@@ -1084,7 +1084,7 @@ static le_result_t Read
     }
 
     // Read the item from the secure storage.
-    result = pa_secStore_Read(path, bufPtr, bufNumElementsPtr);
+    result = secStoreCache_Read(path, bufPtr, bufNumElementsPtr);
 
     // If there is an error, make sure that the buffer is empty.
     if ( (LE_OK != result) && (bufNumElementsPtr > 0) )
@@ -1171,7 +1171,7 @@ le_result_t Delete
     }
 
     // Delete the item from the secure storage.
-    return pa_secStore_Delete(path);
+    return secStoreCache_Delete(path);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1247,7 +1247,7 @@ static le_result_t GetMinimumBufferSize
 
     // TODO: replace with more efficient call
     // (to avoid decryption of the data and/or iteration through descendent nodes)
-    result = pa_secStore_GetSize(path, &size);
+    result = secStoreCache_GetSize(path, &size);
 
     *sizePtr = (uint32_t) size;
 
@@ -1320,6 +1320,7 @@ le_result_t le_secStore_StartBatchWrite
     void
 )
 {
+    secStoreCache_StartBatch(le_secStore_GetClientSessionRef());
     return LE_OK;
 }
 
@@ -1343,6 +1344,7 @@ le_result_t secStoreGlobal_StartBatchWrite
     void
 )
 {
+    secStoreCache_StartBatch(secStoreGlobal_GetClientSessionRef());
     return LE_OK;
 }
 
@@ -1366,7 +1368,8 @@ le_result_t le_secStore_EndBatchWrite
     void
 )
 {
-    return LE_OK;
+    return (secStoreCache_EndBatch(le_secStore_GetClientSessionRef()) == LE_OK) ?
+           LE_OK : LE_FAULT;
 }
 
 #if !MK_CONFIG_SECSTORE_DISABLE_GLOBAL_ACCESS
@@ -1389,7 +1392,8 @@ le_result_t secStoreGlobal_EndBatchWrite
     void
 )
 {
-    return LE_OK;
+    return (secStoreCache_EndBatch(secStoreGlobal_GetClientSessionRef()) == LE_OK) ?
+           LE_OK : LE_FAULT;
 }
 
 #endif /* end !MK_CONFIG_SECSTORE_DISABLE_GLOBAL_ACCESS */
@@ -1610,6 +1614,7 @@ secStoreAdmin_IterRef_t secStoreAdmin_CreateIter
     iterPtr->entryList = LE_SLS_LIST_INIT;
     iterPtr->currEntryPtr = NULL;
 
+    secStoreCache_Flush();
     if (pa_secStore_GetEntries(path, StoreEntry, iterPtr) != LE_OK)
     {
         le_mem_Release(iterPtr);
@@ -1821,7 +1826,7 @@ le_result_t secStoreAdmin_Write
     }
 
     // Write the item to the secure storage.
-    return pa_secStore_Write(path, bufPtr, bufNumElements);
+    return secStoreCache_Write(path, bufPtr, bufNumElements);
 #else
     return LE_UNSUPPORTED;
 #endif
@@ -1873,7 +1878,7 @@ le_result_t secStoreAdmin_Read
     }
 
     // Read the item from the secure storage.
-    return pa_secStore_Read(path, bufPtr, bufNumElementsPtr);
+    return secStoreCache_Read(path, bufPtr, bufNumElementsPtr);
 #else
     return LE_UNSUPPORTED;
 #endif
@@ -1899,6 +1904,7 @@ le_result_t secStoreAdmin_CopyMetaTo
 )
 {
 #if LE_CONFIG_ENABLE_SECSTORE_ADMIN
+    secStoreCache_Flush();
     return pa_secStore_CopyMetaTo(path);
 #else
     return LE_UNSUPPORTED;
@@ -1937,7 +1943,7 @@ le_result_t secStoreAdmin_Delete
     }
 
     // Delete the item from the secure storage.
-    return pa_secStore_Delete(path);
+    return secStoreCache_Delete(path);
 #else
     return LE_UNSUPPORTED;
 #endif
@@ -1984,7 +1990,7 @@ le_result_t secStoreAdmin_GetSize
 
     // Delete the item from the secure storage.
     size_t size = 0;
-    le_result_t result = pa_secStore_GetSize(path, &size);
+    le_result_t result = secStoreCache_GetSize(path, &size);
 
     *sizePtr = size;
 
@@ -2026,6 +2032,7 @@ le_result_t secStoreAdmin_GetTotalSpace
     }
 
     size_t totalSize = 0, freeSize = 0;
+    secStoreCache_Flush();
     le_result_t result = pa_secStore_GetTotalSpace(&totalSize, &freeSize);
 
     *totalSizePtr = totalSize;
@@ -2049,6 +2056,9 @@ static void SecStoreUpdate
     void
 )
 {
+    // Cached items may not match what is in secure storage now.
+    secStoreCache_Invalidate();
+
     // First rebuild meta hash in PA level.
     pa_secStore_ReInitSecStorage();
 
@@ -2099,6 +2109,8 @@ static void AppInstallHandler
     LE_INFO("legato system is updated because APP '%s' installation is done !", installAppNamePtr);
     LE_INFO("rebuild legato secure storage ...");
 
+    secStoreCache_Flush();
+
     SecStoreUpdate();
 }
 
@@ -2117,11 +2129,33 @@ static void AppUninstallHandler
             uninstallAppNamePtr);
     LE_INFO("rebuild legato secure storage ...");
 
+    secStoreCache_Flush();
+
     SecStoreUpdate();
 }
 
 #endif /* end LE_CONFIG_LINUX */
 
+#if LE_CONFIG_SECSTORE_WRITE_BACK_CACHE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ends the batch write of a client that disconnects without ending it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseBatchHandler
+(
+    le_msg_SessionRef_t sessionRef,     ///< [IN] Client session.
+    void* contextPtr                    ///< [IN] Not used.
+)
+{
+    LE_UNUSED(contextPtr);
+
+    secStoreCache_EndBatch(sessionRef);
+}
+
+#endif /* end LE_CONFIG_SECSTORE_WRITE_BACK_CACHE */
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The secure storage daemon's initialization function.
@@ -2161,6 +2195,15 @@ COMPONENT_INIT
     le_instStat_AddAppUninstallEventHandler(AppUninstallHandler, NULL);
 #endif /* end LE_CONFIG_LINUX */
 
+#if LE_CONFIG_SECSTORE_WRITE_BACK_CACHE
+    secStoreCache_Init();
+
+    le_msg_AddServiceCloseHandler(le_secStore_GetServiceRef(), CloseBatchHandler, NULL);
+#if !MK_CONFIG_SECSTORE_DISABLE_GLOBAL_ACCESS
+    le_msg_AddServiceCloseHandler(secStoreGlobal_GetServiceRef(), CloseBatchHandler, NULL);
+#endif
+#endif /* end LE_CONFIG_SECSTORE_WRITE_BACK_CACHE */
+
     // Try to kick a couple of times before each timeout.
     le_clk_Time_t watchdogInterval = { .sec = MS_WDOG_INTERVAL };
     le_wdogChain_Init(1);
@@ -10,6 +10,17 @@
 #ifndef LEGATO_SECSTORESERVER_H_INCLUDE_GUARD
 #define LEGATO_SECSTORESERVER_H_INCLUDE_GUARD
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in secure storage path buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifdef SECSTOREADMIN_MAX_PATH_BYTES
+#   define SECSTORE_MAX_PATH_BYTES SECSTOREADMIN_MAX_PATH_BYTES
+#else
+#   define SECSTORE_MAX_PATH_BYTES 512
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The following are LE_SHARED functions
@@ -331,6 +331,118 @@ le_result_t le_spiLib_ReadHD
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes the number of bytes written and read by the transfers of a transaction.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_BAD_PARAMETER if there are no transfers, too many transfers, or an empty transfer
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spiLib_GetTransferSizes
+(
+    const le_spi_Transfer_t* transfers, ///< [in] transfers of the transaction
+    size_t numTransfers,                ///< [in] number of transfers
+    size_t* writeDataLength,            ///< [out] number of bytes of the write transfers
+    size_t* readDataLength              ///< [out] number of bytes of the read transfers
+)
+{
+    size_t writeLength = 0;
+    size_t readLength = 0;
+
+    if ((numTransfers == 0) || (numTransfers > LE_SPI_MAX_TRANSFERS))
+    {
+        LE_ERROR("Invalid number of transfers %"PRIuS, numTransfers);
+        return LE_BAD_PARAMETER;
+    }
+
+    for (size_t i = 0; i < numTransfers; i++)
+    {
+        // The sizes are checked against overflows, as they are used to size the data buffers
+        if ((transfers[i].length == 0) ||
+            (transfers[i].length > SIZE_MAX - writeLength) ||
+            (transfers[i].length > SIZE_MAX - readLength))
+        {
+            LE_ERROR("Invalid length %"PRIu32" for transfer %"PRIuS, transfers[i].length, i);
+            return LE_BAD_PARAMETER;
+        }
+        if (transfers[i].flags & LE_SPI_TRANSFER_WRITE)
+        {
+            writeLength += transfers[i].length;
+        }
+        if (transfers[i].flags & LE_SPI_TRANSFER_READ)
+        {
+            readLength += transfers[i].length;
+        }
+    }
+
+    *writeDataLength = writeLength;
+    *readDataLength = readLength;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs several SPI transfers as one SPI message, i.e. with one ioctl. The bytes of the write
+ * transfers are taken one after the other from writeData, and the bytes of the read transfers are
+ * stored one after the other in readData.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_FAULT
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spiLib_Transfer
+(
+    int fd,                             ///< [in] open file descriptor of SPI port
+    const le_spi_Transfer_t* transfers, ///< [in] transfers of the transaction
+    size_t numTransfers,                ///< [in] number of transfers
+    const uint8_t* writeData,           ///< [in] bytes of the write transfers
+    uint8_t* readData                   ///< [out] bytes of the read transfers
+)
+{
+    struct spi_ioc_transfer tr[LE_SPI_MAX_TRANSFERS];
+    int transferResult;
+
+    LE_ASSERT(numTransfers <= LE_SPI_MAX_TRANSFERS);
+    memset(tr, 0, numTransfers * sizeof(tr[0]));
+
+    for (size_t i = 0; i < numTransfers; i++)
+    {
+        tr[i].len = transfers[i].length;
+        if (transfers[i].flags & LE_SPI_TRANSFER_WRITE)
+        {
+            tr[i].tx_buf = (unsigned long)writeData;
+            writeData += transfers[i].length;
+        }
+        if (transfers[i].flags & LE_SPI_TRANSFER_READ)
+        {
+            tr[i].rx_buf = (unsigned long)readData;
+            readData += transfers[i].length;
+        }
+        tr[i].cs_change = (transfers[i].flags & LE_SPI_TRANSFER_CS_CHANGE) ? 1 : 0;
+        tr[i].delay_usecs = transfers[i].delayUsec;
+        tr[i].speed_hz = transfers[i].speedHz;
+        tr[i].bits_per_word = transfers[i].bitsPerWord;
+    }
+
+    LE_DEBUG("Transferring %"PRIuS" transfers in one message", numTransfers);
+
+    transferResult = ioctl(fd, SPI_IOC_MESSAGE(numTransfers), tr);
+    if (transferResult < 1)
+    {
+        LE_ERROR("Transfer failed with error %d : %d (%m)", transferResult, errno);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("Successful transmission with success %d", transferResult);
+    return LE_OK;
+}
+
+
 COMPONENT_INIT
 {
     LE_DEBUG("spiLibrary initializing");
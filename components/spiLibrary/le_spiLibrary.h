@@ -100,4 +100,45 @@ LE_SHARED le_result_t le_spiLib_ReadHD
     size_t* readDataLength    ///< [in/out] number of bytes in rx message
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Computes the number of bytes written and read by the transfers of a transaction.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_BAD_PARAMETER if there are no transfers, too many transfers, or an empty transfer
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_spiLib_GetTransferSizes
+(
+    const le_spi_Transfer_t* transfers, ///< [in] transfers of the transaction
+    size_t numTransfers,                ///< [in] number of transfers
+    size_t* writeDataLength,            ///< [out] number of bytes of the write transfers
+    size_t* readDataLength              ///< [out] number of bytes of the read transfers
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Performs several SPI transfers as one SPI message, i.e. with one ioctl. The bytes of the write
+ * transfers are taken one after the other from writeData, and the bytes of the read transfers are
+ * stored one after the other in readData.
+ *
+ * @return
+ *      - LE_OK
+ *      - LE_FAULT
+ *
+ * @note
+ *      The transfers must have been checked with le_spiLib_GetTransferSizes(), and the buffers
+ *      must be large enough.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_spiLib_Transfer
+(
+    int fd,                             ///< [in] open file descriptor of SPI port
+    const le_spi_Transfer_t* transfers, ///< [in] transfers of the transaction
+    size_t numTransfers,                ///< [in] number of transfers
+    const uint8_t* writeData,           ///< [in] bytes of the write transfers
+    uint8_t* readData                   ///< [out] bytes of the read transfers
+);
+
 #endif  // LE_SPI_LIBRARY_H
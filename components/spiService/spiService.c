@@ -12,9 +12,17 @@
 #include "interfaces.h"
 #include "le_spiLibrary.h"
 #include "watchdogChain.h"
+#include <sys/mman.h>
 
 #define MAX_EXPECTED_DEVICES (8)
 
+// Define the memfd sealing declarations missing from older C libraries.
+#ifndef F_GET_SEALS
+# define F_GET_SEALS    (1024 + 10)
+# define F_SEAL_SHRINK  0x0002
+# define F_SEAL_GROW    0x0004
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The timer interval to kick the watchdog chain.
@@ -363,6 +371,181 @@ le_result_t le_spi_ReadHD
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submit several transfers to the device as one SPI message.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the transfers do not match the size of the write data, or if the read
+ *        data buffer is too small
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spi_Transaction
+(
+    le_spi_DeviceHandleRef_t handle,     ///< [in] Handle for the SPI master
+    const le_spi_Transfer_t* transfers,  ///< [in] Transfers, in order
+    size_t numTransfers,                 ///< [in] Number of transfers
+    const uint8_t* writeData,            ///< [in] Bytes of the write transfers
+    size_t writeDataLength,              ///< [in] Number of bytes of the write transfers
+    uint8_t* readData,                   ///< [out] Bytes of the read transfers
+    size_t* readDataLength               ///< [in/out] Number of bytes of the read transfers
+)
+{
+    size_t writeLength, readLength;
+
+    if ((transfers == NULL) || (readData == NULL) || (readDataLength == NULL))
+    {
+        LE_KILL_CLIENT("transfers or readData is NULL.");
+        return LE_FAULT;
+    }
+
+    Device_t* device = le_ref_Lookup(DeviceHandleRefMap, handle);
+    if (device == NULL)
+    {
+        LE_KILL_CLIENT("Failed to lookup device from handle!");
+        return LE_FAULT;
+    }
+
+    if (!IsDeviceOwnedByCaller(device))
+    {
+        LE_KILL_CLIENT("Cannot assign handle to transfer as it is not owned by the caller");
+        return LE_FAULT;
+    }
+
+    if (le_spiLib_GetTransferSizes(transfers, numTransfers, &writeLength, &readLength) != LE_OK)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((writeLength != writeDataLength) || (readLength > *readDataLength))
+    {
+        LE_ERROR("Transfers write %"PRIuS" bytes (%"PRIuS" given) and read %"PRIuS
+                 " bytes (%"PRIuS" expected)",
+                 writeLength, writeDataLength, readLength, *readDataLength);
+        return LE_BAD_PARAMETER;
+    }
+
+    *readDataLength = readLength;
+
+    return le_spiLib_Transfer(
+        device->fd,
+        transfers,
+        numTransfers,
+        writeData,
+        readData) == LE_OK ? LE_OK : LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Submit several transfers to the device as one SPI message, with the data in a shared memory
+ * buffer: the bytes of the write transfers, followed by room for the bytes of the read transfers.
+ * The buffer is mapped, so that the data are not copied.  It must be a memfd sealed with
+ * F_SEAL_SHRINK and F_SEAL_GROW, so that the client cannot truncate it while it is mapped.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BAD_PARAMETER if the file descriptor is not a sealed memfd, cannot be mapped or is too
+ *        small
+ *      - LE_FAULT on failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_spi_SharedTransaction
+(
+    le_spi_DeviceHandleRef_t handle,     ///< [in] Handle for the SPI master
+    const le_spi_Transfer_t* transfers,  ///< [in] Transfers, in order
+    size_t numTransfers,                 ///< [in] Number of transfers
+    int bufferFd                         ///< [in] Shared memory buffer holding the data
+)
+{
+    size_t writeLength, readLength;
+    struct stat bufferStat;
+    le_result_t result;
+    uint8_t* bufferPtr;
+
+    if (bufferFd < 0)
+    {
+        LE_ERROR("Invalid buffer file descriptor");
+        return LE_BAD_PARAMETER;
+    }
+
+    // The file descriptor is closed on all paths, as it is owned by the service.
+    if (transfers == NULL)
+    {
+        LE_KILL_CLIENT("transfers is NULL.");
+        close(bufferFd);
+        return LE_FAULT;
+    }
+
+    Device_t* device = le_ref_Lookup(DeviceHandleRefMap, handle);
+    if (device == NULL)
+    {
+        LE_KILL_CLIENT("Failed to lookup device from handle!");
+        close(bufferFd);
+        return LE_FAULT;
+    }
+
+    if (!IsDeviceOwnedByCaller(device))
+    {
+        LE_KILL_CLIENT("Cannot assign handle to transfer as it is not owned by the caller");
+        close(bufferFd);
+        return LE_FAULT;
+    }
+
+    if (le_spiLib_GetTransferSizes(transfers, numTransfers, &writeLength, &readLength) != LE_OK)
+    {
+        close(bufferFd);
+        return LE_BAD_PARAMETER;
+    }
+
+    if (fstat(bufferFd, &bufferStat) != 0)
+    {
+        LE_ERROR("Cannot get the buffer size: %m");
+        close(bufferFd);
+        return LE_BAD_PARAMETER;
+    }
+
+    // The size of the buffer must not change while it is mapped: if the client could shrink it,
+    // accessing the mapping would raise SIGBUS in the service.
+    int seals = fcntl(bufferFd, F_GET_SEALS);
+    if ((seals == -1) || ((seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW)))
+    {
+        LE_ERROR("Buffer is not a memfd sealed against shrinking and growing");
+        close(bufferFd);
+        return LE_BAD_PARAMETER;
+    }
+
+    if ((bufferStat.st_size < 0) || ((size_t)bufferStat.st_size < writeLength + readLength))
+    {
+        LE_ERROR("Buffer of %lld bytes, %"PRIuS" bytes expected",
+                 (long long)bufferStat.st_size, writeLength + readLength);
+        close(bufferFd);
+        return LE_BAD_PARAMETER;
+    }
+
+    bufferPtr = mmap(NULL, writeLength + readLength, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     bufferFd, 0);
+    close(bufferFd);
+    if (bufferPtr == MAP_FAILED)
+    {
+        LE_ERROR("Cannot map the buffer: %m");
+        return LE_BAD_PARAMETER;
+    }
+
+    result = le_spiLib_Transfer(
+        device->fd,
+        transfers,
+        numTransfers,
+        bufferPtr,
+        bufferPtr + writeLength) == LE_OK ? LE_OK : LE_FAULT;
+
+    munmap(bufferPtr, writeLength + readLength);
+
+    return result;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if the given handle is owned by the current client.
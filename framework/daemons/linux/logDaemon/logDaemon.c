@@ -59,6 +59,18 @@
  * running process that belongs to an IPC session reference when the IPC system reports that
  * a session closed.  This is how the Log Control Daemon finds out that a client process died.
  *
+ * The log daemon also logs the standard out and standard error of app processes, which the
+ * Supervisor hands over as pipes.  Each pipe is drained in one pass when it becomes readable and the
+ * data is split into one log message per line.  The lines of each app go through its log rate
+ * limit (see logRateLimit.h); lines that exceed it are dropped and counted, and a summary of the
+ * dropped lines is logged when the app can log again.  The counters are listed by the log control
+ * tool's "stats" command.
+ *
+ * When the LOG_STORE build option is enabled, the log daemon also keeps a copy of the messages of
+ * all processes, and of the lines logged from the apps' standard out and standard error, in a
+ * persistent log store (see logStore.c).  The log control tool's "flush" command writes the
+ * buffered records to the store before the tool reads it.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -70,6 +82,8 @@
 #include "limit.h"
 #include "linux/logPlatform.h"
 #include "log.h"
+#include "logRateLimit.h"
+#include "logStore.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -303,11 +317,66 @@ static le_mem_PoolRef_t TracePoolRef;
                                 - LIMIT_MAX_COMPONENT_NAME_LEN )
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of log messages.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_MSG_SIZE            256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes read from a logged file descriptor in one pass of the event loop, so that
+ * a process writing continuously cannot starve the other file descriptors.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_FD_READ_BYTES_PER_PASS  16384
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * App file descriptor logging object.
+ *
+ * Holds the rate limit and the counters of the lines logged from the standard out and standard
+ * error of an app's processes.  These objects are kept for the life of the log daemon so that the
+ * counters survive app restarts.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char            appName[LIMIT_MAX_APP_NAME_BYTES];      ///< App name.
+    logRateLimit_Bucket_t rateLimit;        ///< Rate limit of the lines.
+    uint64_t        readCount;              ///< Number of reads from the app's fds.
+    uint64_t        byteCount;              ///< Number of bytes read from the app's fds.
+    uint64_t        lineCount;              ///< Number of lines logged.
+}
+FdLogApp_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for app file descriptor logging objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t FdLogAppPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash map of app file descriptor logging objects, keyed by app name.
+ *
+ * Value pointer points to a FdLogApp_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t FdLogAppMapRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * File descriptor logging object.
  *
- * Stores info about a file descriptor to be logged.
+ * Stores info about a file descriptor to be logged, and the partial line read from it.
  **/
 //--------------------------------------------------------------------------------------------------
 typedef struct
@@ -317,6 +386,9 @@ typedef struct
     int             pid;                                    ///< PID of the process.
     le_log_Level_t  level;                                  ///< Log level.
     le_fdMonitor_Ref_t monitorRef;                          ///< Monitor object.
+    FdLogApp_t*     appPtr;                                 ///< App the process belongs to.
+    size_t          lineLen;                                ///< Bytes in the line buffer.
+    char            line[MAX_MSG_SIZE];                     ///< Line not terminated yet.
 }
 FdLog_t;
 
@@ -329,14 +401,6 @@ FdLog_t;
 static le_mem_PoolRef_t FdLogPoolRef;
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Maximum length of log messages.
- */
-//--------------------------------------------------------------------------------------------------
-#define MAX_MSG_SIZE            256
-
-
 
 // ========================================
 //  FUNCTIONS
@@ -954,8 +1018,10 @@ static bool ParseCmdPacket
     }
     packetPtr++;
 
-    // The "list" command has no parameters.
-    if (commandCode == LOG_CMD_LIST_COMPONENTS)
+    // The "list", "stats" and "flush" commands have no parameters.
+    if ( (commandCode == LOG_CMD_LIST_COMPONENTS) ||
+         (commandCode == LOG_CMD_LIST_FD_STATS) ||
+         (commandCode == LOG_CMD_FLUSH_STORE) )
     {
         return true;
     }
@@ -2406,6 +2472,69 @@ static void GenerateList
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends the counters of the lines logged from the standard out and standard error of each app to
+ * the log control tool.
+ *
+ * @note    Sends one message for each app.  The messages are null-terminated, printable UTF-8
+ *          strings.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GenerateFdStatsList
+(
+    le_msg_SessionRef_t ipcSessionRef   ///< [IN] Log control tool's current IPC session.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_hashmap_It_Ref_t iteratorRef = le_hashmap_GetIterator(FdLogAppMapRef);
+    while (le_hashmap_NextNode(iteratorRef) == LE_OK)
+    {
+        const FdLogApp_t* appPtr = le_hashmap_GetValue(iteratorRef);
+
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(ipcSessionRef);
+
+        char* payloadPtr = le_msg_GetPayloadPtr(msgRef);
+
+        snprintf(payloadPtr,
+                 le_msg_GetMaxPayloadSize(msgRef),
+                 "%s: %" PRIu64 " lines, %" PRIu64 " bytes, %" PRIu64 " reads, "
+                 "%" PRIu64 " lines suppressed",
+                 appPtr->appName,
+                 appPtr->lineCount,
+                 appPtr->byteCount,
+                 appPtr->readCount,
+                 appPtr->rateLimit.droppedCount);
+
+        le_msg_Send(msgRef);
+    }
+}
+
+
+#if LE_CONFIG_LOG_STORE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends the counters of the messages an app sent to the log store socket to the log control tool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendStoreStatsToLogTool
+(
+    const char* appNamePtr,     ///< [IN] Name of the app, or "framework".
+    uint64_t recordCount,       ///< [IN] Number of messages stored.
+    uint64_t droppedCount,      ///< [IN] Number of messages dropped by the app's rate limit.
+    void* contextPtr            ///< [IN] Log control tool's current IPC session.
+)
+{
+    char message[LOG_STORE_MAX_MSG_BYTES];
+
+    snprintf(message, sizeof(message),
+             "%s: %" PRIu64 " messages stored, %" PRIu64 " dropped by the log store rate limit",
+             appNamePtr, recordCount, droppedCount);
+    SendToLogTool(contextPtr, message);
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Clears the settings for a given process name out of the data structures.
@@ -2499,6 +2628,8 @@ static void ClientMsgReceiveHandler
             case LOG_CMD_DISABLE_TRACE:
             case LOG_CMD_LIST_COMPONENTS:
             case LOG_CMD_FORGET_PROCESS:
+            case LOG_CMD_LIST_FD_STATS:
+            case LOG_CMD_FLUSH_STORE:
 
                 LE_ERROR("Client attempted to issue a log control command (%c)!", command);
 
@@ -2586,6 +2717,25 @@ static void ControlToolMsgReceiveHandler
 
                 break;
 
+            case LOG_CMD_LIST_FD_STATS:
+
+                GenerateFdStatsList(ipcSessionRef);
+#if LE_CONFIG_LOG_STORE
+                logStore_GetSenderStats(SendStoreStatsToLogTool, ipcSessionRef);
+#endif
+
+                break;
+
+            case LOG_CMD_FLUSH_STORE:
+
+#if LE_CONFIG_LOG_STORE
+                logStore_Flush();
+#else
+                SendToLogTool(ipcSessionRef, "*** The log store is not enabled.");
+#endif
+
+                break;
+
             default:
 
                 LE_ERROR("Unknown command byte '%c' received from log control tool.", command);
@@ -2600,6 +2750,180 @@ static void ControlToolMsgReceiveHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the app fd logging object for an app, creating it if it doesn't exist yet.
+ *
+ * @return  Pointer to the object.
+ */
+//--------------------------------------------------------------------------------------------------
+static FdLogApp_t* GetFdLogApp
+(
+    const char* appNamePtr      ///< [IN] Name of the app, which fits in LIMIT_MAX_APP_NAME_BYTES.
+)
+{
+    FdLogApp_t* appPtr = le_hashmap_Get(FdLogAppMapRef, appNamePtr);
+
+    if (appPtr == NULL)
+    {
+        appPtr = le_mem_ForceAlloc(FdLogAppPoolRef);
+        memset(appPtr, 0, sizeof(*appPtr));
+
+        LE_ASSERT(le_utf8_Copy(appPtr->appName, appNamePtr, sizeof(appPtr->appName), NULL)
+                  == LE_OK);
+
+        logRateLimit_Init(&appPtr->rateLimit, le_clk_GetRelativeTime());
+
+        le_hashmap_Put(FdLogAppMapRef, appPtr->appName, appPtr);
+    }
+
+    return appPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logs a message on behalf of the process an fd log object belongs to, and adds it to the log store
+ * under the process's app.  These messages don't go through the log store socket, which would
+ * attribute them to the log daemon.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogFdMsg
+(
+    FdLog_t* fdLogPtr,          ///< [IN] Fd log object.
+    le_log_Level_t level,       ///< [IN] Severity level.
+    const char* msgPtr          ///< [IN] Message.
+)
+{
+    log_LogGenericMsg(level, fdLogPtr->procName, fdLogPtr->pid, msgPtr);
+
+#if LE_CONFIG_LOG_STORE
+    char text[LOG_STORE_MAX_MSG_BYTES];
+
+    snprintf(text, sizeof(text), "%s | %s[%d] | %s",
+             log_GetSeverityStr(level), fdLogPtr->procName, fdLogPtr->pid, msgPtr);
+    logStore_Add(level, fdLogPtr->appName, text);
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logs a summary of the lines suppressed by an app's rate limit since the last summary, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogSuppressedLines
+(
+    FdLog_t* fdLogPtr           ///< [IN] Fd log object to log the summary for.
+)
+{
+    FdLogApp_t* appPtr = fdLogPtr->appPtr;
+
+    if (appPtr->rateLimit.pendingDropped > 0)
+    {
+        char msg[MAX_MSG_SIZE];
+
+        snprintf(msg, sizeof(msg), "%" PRIu32 " lines suppressed by the log rate limit of app '%s'",
+                 appPtr->rateLimit.pendingDropped, appPtr->appName);
+        LogFdMsg(fdLogPtr, LE_LOG_WARN, msg);
+
+        appPtr->rateLimit.pendingDropped = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logs the line in the line buffer of an fd log object, unless the app's rate limit is exceeded,
+ * and empties the line buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogFdLine
+(
+    FdLog_t* fdLogPtr           ///< [IN] Fd log object.
+)
+{
+    size_t len = fdLogPtr->lineLen;
+
+    fdLogPtr->lineLen = 0;
+
+    // Drop the carriage return of CR-LF line endings.
+    if ( (len > 0) && (fdLogPtr->line[len - 1] == '\r') )
+    {
+        len--;
+    }
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    FdLogApp_t* appPtr = fdLogPtr->appPtr;
+
+    if (!logRateLimit_Take(&appPtr->rateLimit, le_clk_GetRelativeTime()))
+    {
+        return;
+    }
+
+    LogSuppressedLines(fdLogPtr);
+
+    fdLogPtr->line[len] = '\0';
+
+    // TODO: Don't log the app name for now so that it matches all the other log formats.  Add
+    //       the app name to all log messages at the same time.
+    LogFdMsg(fdLogPtr, fdLogPtr->level, fdLogPtr->line);
+
+    appPtr->lineCount++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Splits data read from an fd into lines and logs each complete line.  The last line, if it is not
+ * terminated yet, is kept in the fd log object's line buffer.  Lines too long for a log message are
+ * split into several messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LogFdData
+(
+    FdLog_t* fdLogPtr,          ///< [IN] Fd log object.
+    const char* dataPtr,        ///< [IN] Data read from the fd.
+    size_t dataLen              ///< [IN] Number of bytes of data.
+)
+{
+    while (dataLen > 0)
+    {
+        size_t room = sizeof(fdLogPtr->line) - 1 - fdLogPtr->lineLen;
+        const char* endPtr = memchr(dataPtr, '\n', dataLen);
+        size_t len = (endPtr != NULL) ? (size_t)(endPtr - dataPtr) : dataLen;
+        bool isLineEnd = (endPtr != NULL);
+
+        if (len > room)
+        {
+            len = room;
+            isLineEnd = false;
+        }
+
+        memcpy(fdLogPtr->line + fdLogPtr->lineLen, dataPtr, len);
+        fdLogPtr->lineLen += len;
+
+        if (isLineEnd)
+        {
+            // Skip the '\n'.
+            len++;
+        }
+
+        if (isLineEnd || (fdLogPtr->lineLen == sizeof(fdLogPtr->line) - 1))
+        {
+            LogFdLine(fdLogPtr);
+        }
+
+        dataPtr += len;
+        dataLen -= len;
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Deletes the fd log object and monitor.  Closes the associated fd.
@@ -2611,6 +2935,11 @@ static void DeleteFdLog
     FdLog_t* fdLogPtr           ///< [IN] Fd log object to delete.
 )
 {
+    // Log what's left of the last line, and the lines suppressed so that they aren't forgotten
+    // until the app logs again.
+    LogFdLine(fdLogPtr);
+    LogSuppressedLines(fdLogPtr);
+
     // Delete the fd monitor.
     le_fdMonitor_Delete(fdLogPtr->monitorRef);
 
@@ -2624,7 +2953,10 @@ static void DeleteFdLog
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Logs message received from the fd.
+ * Logs messages received from the fd.
+ *
+ * All the data available on the fd is read, up to MAX_FD_READ_BYTES_PER_PASS bytes unless the
+ * writer has hung up, and logged one message per line.
  */
 //--------------------------------------------------------------------------------------------------
 static void LogFdMessages
@@ -2634,35 +2966,50 @@ static void LogFdMessages
 )
 {
     FdLog_t* fdLogPtr = le_fdMonitor_GetContextPtr();
+    bool isHangUp = ( (events & POLLRDHUP) || (events & POLLERR) || (events & POLLHUP) );
 
     if (events & POLLIN)
     {
-        // Read the data from the fd.
-        char msg[MAX_MSG_SIZE] = {'\0'};
-
-        int c;
+        FdLogApp_t* appPtr = fdLogPtr->appPtr;
+        char buf[4096];
+        size_t total = 0;
 
-        do
+        while ( isHangUp || (total < MAX_FD_READ_BYTES_PER_PASS) )
         {
-            c = read(fd, msg, sizeof(msg));
-        }
-        while ( (c == -1) && (errno == EINTR) );
+            ssize_t c = read(fd, buf, sizeof(buf));
 
-        if (c == -1)
-        {
-            LE_ERROR("Could not read fd log message for app/process '%s/%s[%d]'.  %m.",
-                     fdLogPtr->appName, fdLogPtr->procName, fdLogPtr->pid);
+            if (c > 0)
+            {
+                appPtr->readCount++;
+                appPtr->byteCount += c;
+                total += c;
 
-            DeleteFdLog(fd, fdLogPtr);
-        }
+                LogFdData(fdLogPtr, buf, c);
+            }
+            else if (c == 0)
+            {
+                break;
+            }
+            else if (errno == EINTR)
+            {
+                continue;
+            }
+            else if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) )
+            {
+                break;
+            }
+            else
+            {
+                LE_ERROR("Could not read fd log message for app/process '%s/%s[%d]'.  %m.",
+                         fdLogPtr->appName, fdLogPtr->procName, fdLogPtr->pid);
 
-        // Log the data.
-        // TODO: Don't log the app name for now so that it matches all the other log formats.  Add
-        //       the app name to all log messages at the same time.
-        log_LogGenericMsg(fdLogPtr->level, fdLogPtr->procName, fdLogPtr->pid, msg);
+                DeleteFdLog(fd, fdLogPtr);
+                return;
+            }
+        }
     }
 
-    if ( (events & POLLRDHUP) || (events & POLLERR) || (events & POLLHUP) )
+    if (isHangUp)
     {
         LE_DEBUG("Error on app/proc '%s/%s' log fd, events=%d.  Cannot log from this fd.",
                 fdLogPtr->appName, fdLogPtr->procName, events);
@@ -2690,18 +3037,24 @@ static void CreateFdLogMonitor
     // Create fd log object.
     FdLog_t* fdLogPtr = le_mem_ForceAlloc(FdLogPoolRef);
 
+    // The caller is the Supervisor, so don't kill its session over a name that's too long.
     if (le_utf8_Copy(fdLogPtr->appName, appNamePtr, LIMIT_MAX_APP_NAME_BYTES, NULL) != LE_OK)
     {
-        LE_KILL_CLIENT("App name '%s' too long.", appNamePtr);
+        LE_WARN("App name '%s' too long, truncated to '%s'.", appNamePtr, fdLogPtr->appName);
     }
 
     if (le_utf8_Copy(fdLogPtr->procName, procNamePtr, LIMIT_MAX_PROCESS_NAME_BYTES, NULL) != LE_OK)
     {
-        LE_KILL_CLIENT("Proc name '%s' too long.", procNamePtr);
+        LE_WARN("Proc name '%s' too long, truncated to '%s'.", procNamePtr, fdLogPtr->procName);
     }
 
     fdLogPtr->level = logLevel;
     fdLogPtr->pid = pid;
+    fdLogPtr->appPtr = GetFdLogApp(fdLogPtr->appName);
+    fdLogPtr->lineLen = 0;
+
+    // Read without blocking so that all the data available can be drained in one pass.
+    fd_SetNonBlocking(fd);
 
     // Create the fd monitor.
     fdLogPtr->monitorRef = le_fdMonitor_Create(monitorNamePtr, fd, LogFdMessages, 0);
@@ -2804,6 +3157,7 @@ COMPONENT_INIT
     LogSessionPoolRef = le_mem_CreatePool("LogSession", sizeof(LogSession_t));
     TracePoolRef = le_mem_CreatePool("Traces", sizeof(Trace_t));
     FdLogPoolRef = le_mem_CreatePool("FdLogs", sizeof(FdLog_t));
+    FdLogAppPoolRef = le_mem_CreatePool("FdLogApps", sizeof(FdLogApp_t));
 
     // Tune the pools' initial sizes to reduce warnings in the log at start-up.
     // TODO: Make this configurable.
@@ -2814,6 +3168,7 @@ COMPONENT_INIT
     le_mem_ExpandPool(LogSessionPoolRef, MAX_EXPECTED_COMPONENTS);
     le_mem_ExpandPool(TracePoolRef, MAX_EXPECTED_TRACES);
     le_mem_ExpandPool(FdLogPoolRef, MAX_EXPECTED_PROCESSES * 2); // Generally 2 fds per process (stderr, stdout).
+    le_mem_ExpandPool(FdLogAppPoolRef, MAX_EXPECTED_PROCESSES);
 
     // Create the hash maps.
     ProcessNameMapRef = le_hashmap_Create("ProcessName",
@@ -2828,6 +3183,10 @@ COMPONENT_INIT
                                           MAX_EXPECTED_PROCESSES,
                                           ProcessIdHash,
                                           ProcessIdEquals);
+    FdLogAppMapRef    = le_hashmap_Create("FdLogApp",
+                                          MAX_EXPECTED_PROCESSES,
+                                          le_hashmap_HashString,
+                                          le_hashmap_EqualsString);
 
     // Get a reference to the Log Control Protocol identification.
     le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(LOG_CONTROL_PROTOCOL_ID,
@@ -2844,6 +3203,10 @@ COMPONENT_INIT
     le_msg_SetServiceRecvHandler(serviceRef, ControlToolMsgReceiveHandler, NULL);
     le_msg_AdvertiseService(serviceRef);
 
+#if LE_CONFIG_LOG_STORE
+    logStore_Init();
+#endif
+
     // Close the fd that we inherited from the Supervisor.  This will let the Supervisor know that
     // we are initialized.  Then re-open it to /dev/null so that it cannot be reused later.
     FILE* filePtr;
@@ -103,6 +103,41 @@
 //--------------------------------------------------------------------------------------------------
 #define LOG_CMD_LIST_COMPONENTS         'c' // No ProcessName, ComponentName, or CommandData
 #define LOG_CMD_FORGET_PROCESS          'x' // No ComponentName or CommandData
+#define LOG_CMD_LIST_FD_STATS           's' // No ProcessName, ComponentName, or CommandData
+#define LOG_CMD_FLUSH_STORE             'f' // No ProcessName, ComponentName, or CommandData
+
+
+// =====================================
+//  LOG STORE
+// =====================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the log store's datagram socket.  When the LOG_STORE build option is enabled, every
+ * process sends a copy of each of its log messages to this socket, without blocking.  The Log
+ * Control Daemon gets the sender's credentials from the socket to find the app it belongs to.
+ *
+ * Each datagram holds one message: one byte with the severity level (or LOG_STORE_TRACE_LEVEL for
+ * traces), followed by the text of the message, not null-terminated.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_SOCKET_NAME           LE_CONFIG_RUNTIME_DIR "/logStore"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The maximum size in bytes of a log store datagram.  Longer messages are truncated.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_MAX_MSG_BYTES         512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Level byte of the log store datagrams that carry a trace.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_STORE_TRACE_LEVEL           0xFF
 
 
 // =========================================================================
@@ -0,0 +1,64 @@
+/** @file logRateLimit.c
+ *
+ * Per-app log rate limit of the Log Control Daemon (see logRateLimit.h).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+#include "logRateLimit.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes a token bucket with a full burst allowance.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRateLimit_Init
+(
+    logRateLimit_Bucket_t* bucketPtr,       ///< [OUT] Token bucket.
+    le_clk_Time_t now                       ///< [IN] Current relative time.
+)
+{
+    memset(bucketPtr, 0, sizeof(*bucketPtr));
+
+    bucketPtr->tokens = LE_CONFIG_LOG_RATE_LIMIT_BURST;
+    bucketPtr->lastRefillTime = now;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a token from a bucket to log one message, after adding the tokens earned since the last
+ * refill.  If there is no token left, the message is counted as dropped.
+ *
+ * @return  true if the message can be logged, false if it must be dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logRateLimit_Take
+(
+    logRateLimit_Bucket_t* bucketPtr,       ///< [IN] Token bucket.
+    le_clk_Time_t now                       ///< [IN] Current relative time.
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(now, bucketPtr->lastRefillTime);
+
+    bucketPtr->tokens += (elapsed.sec + elapsed.usec / 1000000.0)
+                       * LE_CONFIG_LOG_RATE_LIMIT_PER_SEC;
+    if (bucketPtr->tokens > LE_CONFIG_LOG_RATE_LIMIT_BURST)
+    {
+        bucketPtr->tokens = LE_CONFIG_LOG_RATE_LIMIT_BURST;
+    }
+    bucketPtr->lastRefillTime = now;
+
+    if (bucketPtr->tokens < 1)
+    {
+        bucketPtr->pendingDropped++;
+        bucketPtr->droppedCount++;
+        return false;
+    }
+
+    bucketPtr->tokens -= 1;
+    return true;
+}
@@ -0,0 +1,57 @@
+/** @file logRateLimit.h
+ *
+ * Per-app log rate limit of the Log Control Daemon.  Each app has a token bucket that allows a
+ * burst of LE_CONFIG_LOG_RATE_LIMIT_BURST messages, refilled at LE_CONFIG_LOG_RATE_LIMIT_PER_SEC
+ * messages per second.  Messages that exceed it are dropped and counted, so that one app logging
+ * continuously can't flood the logs of the other apps.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LOG_RATE_LIMIT_INCLUDE_GUARD
+#define LOG_RATE_LIMIT_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Token bucket of an app, and the counters of the messages it dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    double          tokens;                 ///< Number of messages that can be logged right now.
+    le_clk_Time_t   lastRefillTime;         ///< Time tokens were last added to the bucket.
+    uint32_t        pendingDropped;         ///< Messages dropped since the last summary.
+    uint64_t        droppedCount;           ///< Number of messages dropped by the rate limit.
+}
+logRateLimit_Bucket_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes a token bucket with a full burst allowance.
+ */
+//--------------------------------------------------------------------------------------------------
+void logRateLimit_Init
+(
+    logRateLimit_Bucket_t* bucketPtr,       ///< [OUT] Token bucket.
+    le_clk_Time_t now                       ///< [IN] Current relative time.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a token from a bucket to log one message, after adding the tokens earned since the last
+ * refill.  If there is no token left, the message is counted as dropped.
+ *
+ * @return  true if the message can be logged, false if it must be dropped.
+ */
+//--------------------------------------------------------------------------------------------------
+bool logRateLimit_Take
+(
+    logRateLimit_Bucket_t* bucketPtr,       ///< [IN] Token bucket.
+    le_clk_Time_t now                       ///< [IN] Current relative time.
+);
+
+
+#endif // LOG_RATE_LIMIT_INCLUDE_GUARD
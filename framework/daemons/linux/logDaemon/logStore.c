@@ -0,0 +1,1318 @@
+/** @file logStore.c
+ *
+ * Persistent log store of the Log Control Daemon.
+ *
+ * When the LOG_STORE build option is enabled, every process sends a copy of its log messages to the
+ * log store socket (see logDaemon.h), and the Log Control Daemon adds the lines logged from the
+ * standard out and standard error of the apps.  The records are buffered in RAM and written as
+ * compressed blocks to append-only segment files in the LOG_STORE_DIR directory:
+ *
+ * @verbatim
+   <seq>.seg:  | block header | deflated records | block header | deflated records | ...
+@endverbatim
+ *
+ * The block headers are the index of the store: each one holds the time range of its records,
+ * their highest severity level and a bit mask of the apps that logged them, so that queries skip
+ * the blocks that cannot match without reading or decompressing them.
+ *
+ * The messages received on the socket go through the rate limit of the sender's app (see
+ * logRateLimit.h).  The messages over the limit are dropped and counted, and a record of how many
+ * were dropped is added when the app can log again.
+ *
+ * A block is written when it is full, when the flush interval expires, or at most one second after
+ * a message of severity ERROR or higher, in which case it is also synced to flash.  This keeps the
+ * messages that precede a fault while writing a few large blocks rather than many small ones.
+ *
+ * Segments are never rewritten.  When a segment reaches LOG_STORE_SEGMENT_SIZE a new one is
+ * started, and the oldest segments are deleted as long as the store exceeds LOG_STORE_MAX_SIZE.
+ * A block torn by a power loss fails its checksum; it is cut off when the daemon starts and
+ * skipped by queries.
+ *
+ * The files are written in the byte order of the target, which is also the one reading them.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+#include "logDaemon.h"
+#include "logRateLimit.h"
+#include "logStore.h"
+
+#include "fileDescriptor.h"
+#include "limit.h"
+#include "log.h"
+#include "smack.h"
+#include "unixSocket.h"
+#include "user.h"
+
+#include <dirent.h>
+#include <zlib.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size in bytes of a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_BYTES               (LE_CONFIG_LOG_STORE_SEGMENT_SIZE * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum total size in bytes of the segment files.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_STORE_BYTES             (LE_CONFIG_LOG_STORE_MAX_SIZE * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size in bytes of the records of a block, before compression.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BLOCK_RAW_BYTES             (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size in bytes of the buffer holding the compressed records of a block.  Larger than what
+ * compress2() needs in the worst case for BLOCK_RAW_BYTES.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BLOCK_DATA_BYTES            (BLOCK_RAW_BYTES + (BLOCK_RAW_BYTES >> 8) + 64)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number at the start of each block header ("LSB1").
+ */
+//--------------------------------------------------------------------------------------------------
+#define BLOCK_MAGIC                 0x3142534C
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum time in milliseconds between a message of severity ERROR or higher and the write of its
+ * block.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ERROR_FLUSH_DELAY_MS        1000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of datagrams read from the log store socket in one pass of the event loop.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_MSGS_PER_PASS           64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Suffix of the segment file names.  The name is the segment's sequence number in hexadecimal,
+ * zero-padded so that the names sort in sequence order.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_SUFFIX              ".seg"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * App name of the records logged by processes that don't belong to an app.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FRAMEWORK_APP_NAME          "framework"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a block, followed in the segment file by dataSize bytes of compressed records.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;             ///< BLOCK_MAGIC.
+    uint32_t dataSize;          ///< Size of the compressed records.
+    uint32_t rawSize;           ///< Size of the records once decompressed.
+    uint32_t numRecords;        ///< Number of records.
+    uint64_t minTime;           ///< Time of the oldest record, in ms since the Epoch.
+    uint64_t maxTime;           ///< Time of the newest record, in ms since the Epoch.
+    uint64_t appMask;           ///< One bit set for the hash of each app name (see AppMaskBit()).
+    uint32_t dataCrc;           ///< CRC-32 of the compressed records.
+    uint8_t  maxLevel;          ///< Highest severity level of the records, traces count as DEBUG.
+    uint8_t  reserved[3];       ///< Zero.
+}
+BlockHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a record, followed by appLen bytes of app name and textLen bytes of text, both not
+ * null-terminated.  Records are copied in and out of the block buffer, which doesn't keep them
+ * aligned.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t timestamp;         ///< Time the record was received, in ms since the Epoch.
+    uint16_t textLen;           ///< Length of the text.
+    uint8_t  level;             ///< Severity level, LOG_STORE_TRACE_LEVEL for traces.
+    uint8_t  appLen;            ///< Length of the app name.
+    uint32_t reserved;          ///< Zero.
+}
+RecordHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segment file of the store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;         ///< Link in the segment list.
+    uint32_t seq;               ///< Sequence number, which is also the file name.
+    size_t size;                ///< Size of the file in bytes.
+}
+Segment_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the segment objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SegmentPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segments of the store, oldest first.  The last one is the one being written, if it is open.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t SegmentList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Total size in bytes of the segments.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t StoreSize;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segment being written, and its fd.  NULL and -1 when no segment is open.
+ */
+//--------------------------------------------------------------------------------------------------
+static Segment_t* CurrentSegmentPtr;
+static int SegmentFd = -1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the next segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextSeq;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sender of the messages received on the log store socket: an app, or the framework.  Holds the
+ * rate limit of its messages, so that one app can't flood the store and evict the history of the
+ * others.  These objects are kept for the life of the log daemon so that the counters survive app
+ * restarts.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char appName[LIMIT_MAX_APP_NAME_BYTES];     ///< App name, or FRAMEWORK_APP_NAME.
+    logRateLimit_Bucket_t rateLimit;            ///< Rate limit of the messages.
+    uint64_t recordCount;                       ///< Number of messages stored.
+}
+Sender_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for the sender objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SenderPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash map of the sender objects, keyed by app name.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t SenderMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of the block being filled, and its records.
+ */
+//--------------------------------------------------------------------------------------------------
+static BlockHeader_t Block;
+static uint8_t RawBuff[BLOCK_RAW_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer holding a block as it is written (header and compressed records), or the compressed
+ * records of a block as it is read.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t BlockBuff[sizeof(BlockHeader_t) + BLOCK_DATA_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer writing the buffered records after the flush interval, or soon after an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t FlushTimerRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time of the last block write, relative.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t LastFlushTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if the block being filled holds a message of severity ERROR or higher, in which case it is
+ * synced to flash when it is written.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsErrorPending;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once a write error has been logged, until a block is written again.  Keeps a failing flash
+ * from flooding the log (and the store itself) with errors.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsWriteFailed;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the bit of an app name in the app mask of the blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t AppMaskBit
+(
+    const char* appNamePtr      ///< [IN] App name.
+)
+{
+    return 1ULL << (le_hashmap_HashString(appNamePtr) % 64);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the severity level of a record used by the level filters, where traces count as DEBUG.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t FilterLevel
+(
+    uint8_t level               ///< [IN] Level of the record.
+)
+{
+    return (level == LOG_STORE_TRACE_LEVEL) ? LE_LOG_DEBUG : level;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the path of a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSegmentPath
+(
+    uint32_t seq,               ///< [IN] Sequence number of the segment.
+    char* pathPtr,              ///< [OUT] Buffer for the path.
+    size_t pathSize             ///< [IN] Size of the buffer.
+)
+{
+    LE_ASSERT(snprintf(pathPtr, pathSize, LE_CONFIG_LOG_STORE_DIR "/%08" PRIx32 SEGMENT_SUFFIX,
+                       seq) < pathSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Filter of scandir() keeping the segment files.
+ *
+ * @return  Non-zero if the entry is a segment file.
+ */
+//--------------------------------------------------------------------------------------------------
+static int IsSegmentEntry
+(
+    const struct dirent* entryPtr   ///< [IN] Directory entry.
+)
+{
+    const char* namePtr = entryPtr->d_name;
+    size_t len = strlen(namePtr);
+
+    return (len == 8 + sizeof(SEGMENT_SUFFIX) - 1) &&
+           (strspn(namePtr, "0123456789abcdef") == 8) &&
+           (strcmp(namePtr + 8, SEGMENT_SUFFIX) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads and checks the header of a block.
+ *
+ * @return  true if the header is valid and its block fits in the file.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadBlockHeader
+(
+    int fd,                     ///< [IN] Segment file.
+    off_t offset,               ///< [IN] Offset of the block in the file.
+    off_t fileSize,             ///< [IN] Size of the file.
+    BlockHeader_t* headerPtr    ///< [OUT] Header of the block.
+)
+{
+    if ( (offset + (off_t)sizeof(*headerPtr) > fileSize) ||
+         (pread(fd, headerPtr, sizeof(*headerPtr), offset) != sizeof(*headerPtr)) )
+    {
+        return false;
+    }
+
+    return (headerPtr->magic == BLOCK_MAGIC) &&
+           (headerPtr->dataSize <= BLOCK_DATA_BYTES) &&
+           (headerPtr->rawSize <= BLOCK_RAW_BYTES) &&
+           (offset + (off_t)sizeof(*headerPtr) + headerPtr->dataSize <= fileSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the compressed records of a block into the block buffer and checks them.
+ *
+ * @return  true if the records are intact.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadBlockData
+(
+    int fd,                         ///< [IN] Segment file.
+    off_t offset,                   ///< [IN] Offset of the block in the file.
+    const BlockHeader_t* headerPtr  ///< [IN] Header of the block.
+)
+{
+    return (pread(fd, BlockBuff, headerPtr->dataSize, offset + sizeof(*headerPtr)) ==
+                                                                (ssize_t)headerPtr->dataSize) &&
+           (crc32(0, BlockBuff, headerPtr->dataSize) == headerPtr->dataCrc);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a function for each record of a decompressed block that matches a query.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueryRecords
+(
+    const uint8_t* recordsPtr,  ///< [IN] Decompressed records.
+    size_t size,                ///< [IN] Size of the records.
+    uint64_t startTime,         ///< [IN] Start of the time range.
+    uint64_t endTime,           ///< [IN] End of the time range.
+    const char* appNamePtr,     ///< [IN] App name, or NULL for all the apps.
+    le_log_Level_t minLevel,    ///< [IN] Minimum severity level.
+    logStore_RecordFunc_t func, ///< [IN] Function called for each matching record.
+    void* contextPtr            ///< [IN] Context pointer passed to the function.
+)
+{
+    size_t pos = 0;
+
+    while (pos + sizeof(RecordHeader_t) <= size)
+    {
+        RecordHeader_t record;
+        memcpy(&record, recordsPtr + pos, sizeof(record));
+        pos += sizeof(record);
+
+        if ( (record.appLen > LIMIT_MAX_APP_NAME_LEN) ||
+             (record.textLen > LOG_STORE_MAX_MSG_BYTES) ||
+             (pos + record.appLen + record.textLen > size) )
+        {
+            // Can't happen in a block that passed its checksum, unless it was written by an
+            // incompatible version.
+            return;
+        }
+
+        char appName[LIMIT_MAX_APP_NAME_BYTES];
+        memcpy(appName, recordsPtr + pos, record.appLen);
+        appName[record.appLen] = '\0';
+        pos += record.appLen;
+
+        if ( (record.timestamp >= startTime) &&
+             (record.timestamp <= endTime) &&
+             (FilterLevel(record.level) >= minLevel) &&
+             ( (appNamePtr == NULL) || (strcmp(appName, appNamePtr) == 0) ) )
+        {
+            char text[LOG_STORE_MAX_MSG_BYTES + 1];
+            memcpy(text, recordsPtr + pos, record.textLen);
+            text[record.textLen] = '\0';
+
+            func(record.timestamp,
+                 (record.level == LOG_STORE_TRACE_LEVEL) ? (le_log_Level_t)-1 : record.level,
+                 appName,
+                 text,
+                 contextPtr);
+        }
+
+        pos += record.textLen;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the records of a segment that match a query.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QuerySegment
+(
+    const char* fileNamePtr,    ///< [IN] Name of the segment file.
+    uint64_t startTime,         ///< [IN] Start of the time range.
+    uint64_t endTime,           ///< [IN] End of the time range.
+    const char* appNamePtr,     ///< [IN] App name, or NULL for all the apps.
+    le_log_Level_t minLevel,    ///< [IN] Minimum severity level.
+    logStore_RecordFunc_t func, ///< [IN] Function called for each matching record.
+    void* contextPtr            ///< [IN] Context pointer passed to the function.
+)
+{
+    static uint8_t records[BLOCK_RAW_BYTES];
+
+    char path[LIMIT_MAX_PATH_BYTES];
+    LE_ASSERT(snprintf(path, sizeof(path), LE_CONFIG_LOG_STORE_DIR "/%s", fileNamePtr) <
+              sizeof(path));
+
+    // The segment may have been evicted since the directory was listed.
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        fd_Close(fd);
+        return;
+    }
+
+    uint64_t appBit = (appNamePtr == NULL) ? 0 : AppMaskBit(appNamePtr);
+    off_t offset = 0;
+    BlockHeader_t header;
+
+    // Stops at the end of the segment, or at a torn block at the end of the segment being written.
+    while (ReadBlockHeader(fd, offset, st.st_size, &header))
+    {
+        if ( (header.maxTime >= startTime) &&
+             (header.minTime <= endTime) &&
+             (header.maxLevel >= minLevel) &&
+             ( (appBit == 0) || ((header.appMask & appBit) != 0) ) &&
+             ReadBlockData(fd, offset, &header) )
+        {
+            uLongf rawSize = sizeof(records);
+
+            if ( (uncompress(records, &rawSize, BlockBuff, header.dataSize) == Z_OK) &&
+                 (rawSize == header.rawSize) )
+            {
+                QueryRecords(records, rawSize, startTime, endTime, appNamePtr, minLevel,
+                             func, contextPtr);
+            }
+        }
+
+        offset += sizeof(header) + header.dataSize;
+    }
+
+    fd_Close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes the segment being written.  The next block is written to a new segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseSegment
+(
+    void
+)
+{
+    if (SegmentFd >= 0)
+    {
+        fd_Close(SegmentFd);
+        SegmentFd = -1;
+    }
+
+    CurrentSegmentPtr = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a new segment and makes it the one being written.  Nothing is open if it fails.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenSegment
+(
+    void
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    GetSegmentPath(NextSeq, path, sizeof(path));
+
+    // Recreate the directory in case it was deleted under our feet.
+    if (le_dir_MakePath(LE_CONFIG_LOG_STORE_DIR, S_IRWXU) != LE_OK)
+    {
+        if (!IsWriteFailed)
+        {
+            LE_ERROR("Could not create log store directory '%s'.", LE_CONFIG_LOG_STORE_DIR);
+            IsWriteFailed = true;
+        }
+        return;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        if (!IsWriteFailed)
+        {
+            LE_ERROR("Could not create log store segment '%s'.  %m.", path);
+            IsWriteFailed = true;
+        }
+        return;
+    }
+
+    Segment_t* segPtr = le_mem_ForceAlloc(SegmentPoolRef);
+    segPtr->link = LE_DLS_LINK_INIT;
+    segPtr->seq = NextSeq++;
+    segPtr->size = 0;
+    le_dls_Queue(&SegmentList, &segPtr->link);
+
+    CurrentSegmentPtr = segPtr;
+    SegmentFd = fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Deletes the oldest segments as long as the store is larger than its maximum size.  The segment
+ * being written is never deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EvictSegments
+(
+    void
+)
+{
+    while (StoreSize > MAX_STORE_BYTES)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&SegmentList);
+        if (linkPtr == NULL)
+        {
+            break;
+        }
+
+        Segment_t* segPtr = CONTAINER_OF(linkPtr, Segment_t, link);
+        if (segPtr == CurrentSegmentPtr)
+        {
+            break;
+        }
+
+        char path[LIMIT_MAX_PATH_BYTES];
+        GetSegmentPath(segPtr->seq, path, sizeof(path));
+
+        if ( (unlink(path) != 0) && (errno != ENOENT) )
+        {
+            LE_WARN("Could not delete log store segment '%s'.  %m.", path);
+        }
+
+        StoreSize -= segPtr->size;
+        le_dls_Remove(&SegmentList, linkPtr);
+        le_mem_Release(segPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties the block being filled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetBlock
+(
+    void
+)
+{
+    memset(&Block, 0, sizeof(Block));
+    Block.minTime = UINT64_MAX;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compresses the block being filled and appends it to the segment being written, starting a new
+ * segment first if it doesn't fit, then deletes the segments that exceed the store size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteBlock
+(
+    void
+)
+{
+    bool isSync = IsErrorPending;
+
+    if (le_timer_IsRunning(FlushTimerRef))
+    {
+        le_timer_Stop(FlushTimerRef);
+    }
+    IsErrorPending = false;
+    LastFlushTime = le_clk_GetRelativeTime();
+
+    if (Block.numRecords == 0)
+    {
+        return;
+    }
+
+    uint8_t* dataPtr = BlockBuff + sizeof(BlockHeader_t);
+    uLongf dataSize = BLOCK_DATA_BYTES;
+
+    if (compress2(dataPtr, &dataSize, RawBuff, Block.rawSize, Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        LE_ERROR("Could not compress %" PRIu32 " log records.", Block.numRecords);
+        ResetBlock();
+        return;
+    }
+
+    Block.magic = BLOCK_MAGIC;
+    Block.dataSize = dataSize;
+    Block.dataCrc = crc32(0, dataPtr, dataSize);
+    memcpy(BlockBuff, &Block, sizeof(Block));
+
+    size_t blockSize = sizeof(Block) + dataSize;
+
+    if ( (CurrentSegmentPtr != NULL) && (CurrentSegmentPtr->size + blockSize > SEGMENT_BYTES) )
+    {
+        CloseSegment();
+    }
+    if (CurrentSegmentPtr == NULL)
+    {
+        OpenSegment();
+    }
+
+    if (CurrentSegmentPtr != NULL)
+    {
+        if (fd_WriteSize(SegmentFd, BlockBuff, blockSize) == (ssize_t)blockSize)
+        {
+            CurrentSegmentPtr->size += blockSize;
+            StoreSize += blockSize;
+            IsWriteFailed = false;
+
+            if (isSync)
+            {
+                fdatasync(SegmentFd);
+            }
+        }
+        else
+        {
+            if (!IsWriteFailed)
+            {
+                LE_ERROR("Could not write %" PRIuS " bytes to log store segment %08" PRIx32 ".",
+                         blockSize, CurrentSegmentPtr->seq);
+                IsWriteFailed = true;
+            }
+
+            // Cut off what was written of the block, and don't append to this segment anymore.
+            if (ftruncate(SegmentFd, CurrentSegmentPtr->size) != 0)
+            {
+                LE_WARN("Could not truncate log store segment %08" PRIx32 ".  %m.",
+                        CurrentSegmentPtr->seq);
+            }
+            CloseSegment();
+        }
+    }
+
+    ResetBlock();
+    EvictSegments();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the buffered records when the flush timer expires.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Flush timer.
+)
+{
+    WriteBlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedules the write of the block being filled after a message of severity ERROR or higher:
+ * immediately if no block has been written in the last ERROR_FLUSH_DELAY_MS, otherwise at the end
+ * of that delay so that a burst of errors is written as one block.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScheduleErrorFlush
+(
+    void
+)
+{
+    IsErrorPending = true;
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), LastFlushTime);
+    uint64_t elapsedMs = elapsed.sec * 1000ULL + elapsed.usec / 1000;
+
+    if (elapsedMs >= ERROR_FLUSH_DELAY_MS)
+    {
+        WriteBlock();
+        return;
+    }
+
+    uint32_t delayMs = ERROR_FLUSH_DELAY_MS - elapsedMs;
+
+    if (le_timer_GetMsTimeRemaining(FlushTimerRef) > delayMs)
+    {
+        le_timer_SetMsInterval(FlushTimerRef, delayMs);
+        le_timer_Restart(FlushTimerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cuts off the torn block that a power loss may have left at the end of a segment.
+ *
+ * @return  Size of the valid part of the segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t RepairSegment
+(
+    uint32_t seq,               ///< [IN] Sequence number of the segment.
+    size_t size                 ///< [IN] Size of the segment file.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    GetSegmentPath(seq, path, sizeof(path));
+
+    int fd = open(path, O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LE_WARN("Could not open log store segment '%s'.  %m.", path);
+        return size;
+    }
+
+    off_t offset = 0;
+    BlockHeader_t header;
+
+    while (ReadBlockHeader(fd, offset, size, &header) && ReadBlockData(fd, offset, &header))
+    {
+        offset += sizeof(header) + header.dataSize;
+    }
+
+    if (offset < size)
+    {
+        LE_WARN("Cutting off %" PRIuS " bytes of torn block at the end of log store segment '%s'.",
+                (size_t)(size - offset), path);
+
+        if (ftruncate(fd, offset) == 0)
+        {
+            size = offset;
+        }
+        else
+        {
+            LE_WARN("Could not truncate log store segment '%s'.  %m.", path);
+        }
+    }
+
+    fd_Close(fd);
+
+    return size;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lists the segments left by the previous run, repairs the last one and deletes the oldest ones if
+ * the store is larger than its maximum size (which may have been reduced).
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadSegments
+(
+    void
+)
+{
+    struct dirent** entries;
+    int numEntries = scandir(LE_CONFIG_LOG_STORE_DIR, &entries, IsSegmentEntry, alphasort);
+
+    if (numEntries < 0)
+    {
+        if (errno != ENOENT)
+        {
+            LE_ERROR("Could not list log store directory '%s'.  %m.", LE_CONFIG_LOG_STORE_DIR);
+        }
+        return;
+    }
+
+    int i;
+    for (i = 0; i < numEntries; i++)
+    {
+        char path[LIMIT_MAX_PATH_BYTES];
+        struct stat st;
+
+        LE_ASSERT(snprintf(path, sizeof(path), LE_CONFIG_LOG_STORE_DIR "/%s",
+                           entries[i]->d_name) < sizeof(path));
+
+        if (stat(path, &st) == 0)
+        {
+            Segment_t* segPtr = le_mem_ForceAlloc(SegmentPoolRef);
+            segPtr->link = LE_DLS_LINK_INIT;
+            segPtr->seq = strtoul(entries[i]->d_name, NULL, 16);
+            segPtr->size = st.st_size;
+            le_dls_Queue(&SegmentList, &segPtr->link);
+
+            NextSeq = segPtr->seq + 1;
+        }
+
+        free(entries[i]);
+    }
+    free(entries);
+
+    // Only the last segment was being written when the previous run ended.
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&SegmentList);
+    if (linkPtr != NULL)
+    {
+        Segment_t* segPtr = CONTAINER_OF(linkPtr, Segment_t, link);
+        segPtr->size = RepairSegment(segPtr->seq, segPtr->size);
+    }
+
+    for (linkPtr = le_dls_Peek(&SegmentList);
+         linkPtr != NULL;
+         linkPtr = le_dls_PeekNext(&SegmentList, linkPtr))
+    {
+        StoreSize += CONTAINER_OF(linkPtr, Segment_t, link)->size;
+    }
+
+    LE_INFO("Log store holds %" PRIuS " segments, %" PRIuS " bytes.",
+            le_dls_NumLinks(&SegmentList), StoreSize);
+
+    EvictSegments();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the name of the app a process belongs to, from the user it runs as.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetAppName
+(
+    const struct ucred* credPtr,    ///< [IN] Credentials of the process.
+    char* appNamePtr,               ///< [OUT] Buffer for the app name.
+    size_t appNameSize              ///< [IN] Size of the buffer.
+)
+{
+    // The user module caches the user names, so this doesn't read the password file every time.
+    if ( (credPtr->pid == 0) ||
+         (credPtr->uid == 0) ||
+         (user_GetAppName(credPtr->uid, appNamePtr, appNameSize) != LE_OK) )
+    {
+        LE_ASSERT(le_utf8_Copy(appNamePtr, FRAMEWORK_APP_NAME, appNameSize, NULL) == LE_OK);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the sender object of an app, creating it if it doesn't exist yet.
+ *
+ * @return  Pointer to the object.
+ */
+//--------------------------------------------------------------------------------------------------
+static Sender_t* GetSender
+(
+    const char* appNamePtr      ///< [IN] Name of the app, which fits in LIMIT_MAX_APP_NAME_BYTES.
+)
+{
+    Sender_t* senderPtr = le_hashmap_Get(SenderMapRef, appNamePtr);
+
+    if (senderPtr == NULL)
+    {
+        senderPtr = le_mem_ForceAlloc(SenderPoolRef);
+        memset(senderPtr, 0, sizeof(*senderPtr));
+
+        LE_ASSERT(le_utf8_Copy(senderPtr->appName, appNamePtr, sizeof(senderPtr->appName), NULL)
+                  == LE_OK);
+        logRateLimit_Init(&senderPtr->rateLimit, le_clk_GetRelativeTime());
+
+        le_hashmap_Put(SenderMapRef, senderPtr->appName, senderPtr);
+    }
+
+    return senderPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a record of the messages of an app dropped by its rate limit since the last such record,
+ * if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddDroppedRecord
+(
+    Sender_t* senderPtr         ///< [IN] Sender of the messages.
+)
+{
+    if (senderPtr->rateLimit.pendingDropped > 0)
+    {
+        char text[LOG_STORE_MAX_MSG_BYTES];
+
+        snprintf(text, sizeof(text),
+                 "%s | logDaemon[%d] | %" PRIu32 " messages dropped by the log store rate limit"
+                 " of app '%s'",
+                 log_GetSeverityStr(LE_LOG_WARN), getpid(), senderPtr->rateLimit.pendingDropped,
+                 senderPtr->appName);
+        logStore_Add(LE_LOG_WARN, senderPtr->appName, text);
+
+        senderPtr->rateLimit.pendingDropped = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the messages sent to the log store socket and adds them to the store, unless the rate
+ * limit of the sender's app is exceeded.
+ *
+ * @note    Must not log anything for each message, since its own messages come back through the
+ *          same socket.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SocketHandler
+(
+    int fd,                     ///< [IN] Log store socket.
+    short events                ///< [IN] Events.
+)
+{
+    int i;
+
+    for (i = 0; i < MAX_MSGS_PER_PASS; i++)
+    {
+        char msg[LOG_STORE_MAX_MSG_BYTES + 1];
+        size_t msgSize = LOG_STORE_MAX_MSG_BYTES;
+        struct ucred cred;
+
+        le_result_t result = unixSocket_ReceiveMsg(fd, msg, &msgSize, NULL, &cred);
+
+        // Truncated messages are stored as far as they go.
+        if ( ((result != LE_OK) && (result != LE_NO_MEMORY)) || (msgSize < 1) )
+        {
+            break;
+        }
+
+        msg[msgSize] = '\0';
+
+        uint8_t level = (uint8_t)msg[0];
+        char appName[LIMIT_MAX_APP_NAME_BYTES];
+
+        GetAppName(&cred, appName, sizeof(appName));
+
+        Sender_t* senderPtr = GetSender(appName);
+
+        if (!logRateLimit_Take(&senderPtr->rateLimit, le_clk_GetRelativeTime()))
+        {
+            continue;
+        }
+
+        AddDroppedRecord(senderPtr);
+
+        logStore_Add((level <= LE_LOG_EMERG) ? (le_log_Level_t)level : (le_log_Level_t)-1,
+                     appName,
+                     msg + 1);
+        senderPtr->recordCount++;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the buffered records and syncs them before the daemon is terminated, which happens when
+ * the framework is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SigTermHandler
+(
+    int sigNum                  ///< [IN] Signal number.
+)
+{
+    IsErrorPending = true;
+    WriteBlock();
+
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens the log store socket, which every process can send to.
+ *
+ * @return  The socket's fd.
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenSocket
+(
+    void
+)
+{
+    int fd = unixSocket_CreateDatagramNamed(LOG_STORE_SOCKET_NAME);
+
+    if (fd == LE_DUPLICATE)
+    {
+        if (unlink(LOG_STORE_SOCKET_NAME) != 0)
+        {
+            LE_FATAL("Couldn't unlink '%s' to make way for new socket. Errno = %d (%m).",
+                     LOG_STORE_SOCKET_NAME,
+                     errno);
+        }
+        fd = unixSocket_CreateDatagramNamed(LOG_STORE_SOCKET_NAME);
+    }
+
+    if (fd < 0)
+    {
+        LE_FATAL("Failed to open socket '%s'. Result = %d (%s).",
+                 LOG_STORE_SOCKET_NAME,
+                 fd,
+                 LE_RESULT_TXT(fd));
+    }
+
+    // All the processes, whatever their user, must be able to send to the socket.
+    if (chmod(LOG_STORE_SOCKET_NAME, S_IRUSR | S_IWUSR | S_IWGRP | S_IWOTH) != 0)
+    {
+        LE_FATAL("Could not set permissions of '%s'.  %m.", LOG_STORE_SOCKET_NAME);
+    }
+    smack_SetLabel(LOG_STORE_SOCKET_NAME, "*");
+
+    LE_FATAL_IF(unixSocket_EnableAuthentication(fd) != LE_OK,
+                "Could not enable credentials on '%s'.", LOG_STORE_SOCKET_NAME);
+
+    fd_SetNonBlocking(fd);
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the log store: recovers the segments left by the previous run, opens the log store
+ * socket and starts receiving the messages that the processes send to it.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Init
+(
+    void
+)
+{
+    // The block buffer must hold the worst case of compress2().
+    LE_ASSERT(compressBound(BLOCK_RAW_BYTES) <= BLOCK_DATA_BYTES);
+
+    user_Init();
+
+    SegmentPoolRef = le_mem_CreatePool("LogStoreSegment", sizeof(Segment_t));
+    le_mem_ExpandPool(SegmentPoolRef, MAX_STORE_BYTES / SEGMENT_BYTES + 1);
+
+    SenderPoolRef = le_mem_CreatePool("LogStoreSender", sizeof(Sender_t));
+    SenderMapRef = le_hashmap_Create("LogStoreSender",
+                                     31,
+                                     le_hashmap_HashString,
+                                     le_hashmap_EqualsString);
+
+    FlushTimerRef = le_timer_Create("LogStoreFlush");
+    le_timer_SetHandler(FlushTimerRef, FlushTimerHandler);
+
+    ResetBlock();
+    LastFlushTime = le_clk_GetRelativeTime();
+
+    LoadSegments();
+
+    // Write what is buffered before the framework stops.
+    le_sig_Block(SIGTERM);
+    le_sig_SetEventHandler(SIGTERM, SigTermHandler);
+
+    le_fdMonitor_Create("LogStore", OpenSocket(), SocketHandler, POLLIN);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a record to the log store.  Records are buffered and written as compressed blocks, when a
+ * block is full, when the flush interval expires, or soon after an error is logged.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Add
+(
+    le_log_Level_t level,       ///< [IN] Severity level, -1 for traces.
+    const char* appNamePtr,     ///< [IN] Name of the app that logged the record.
+    const char* textPtr         ///< [IN] Text of the record.
+)
+{
+    size_t appLen = strnlen(appNamePtr, LIMIT_MAX_APP_NAME_LEN);
+    size_t textLen = strnlen(textPtr, LOG_STORE_MAX_MSG_BYTES);
+
+    // Drop the line ending that the messages of the processes carry for syslog.
+    while ( (textLen > 0) && (textPtr[textLen - 1] == '\n') )
+    {
+        textLen--;
+    }
+
+    size_t recordSize = sizeof(RecordHeader_t) + appLen + textLen;
+
+    if (Block.rawSize + recordSize > BLOCK_RAW_BYTES)
+    {
+        WriteBlock();
+    }
+
+    le_clk_Time_t now = le_clk_GetAbsoluteTime();
+
+    RecordHeader_t record =
+    {
+        .timestamp = now.sec * 1000ULL + now.usec / 1000,
+        .textLen = textLen,
+        .level = (level <= LE_LOG_EMERG) ? level : LOG_STORE_TRACE_LEVEL,
+        .appLen = appLen
+    };
+
+    uint8_t* recordPtr = RawBuff + Block.rawSize;
+    memcpy(recordPtr, &record, sizeof(record));
+    memcpy(recordPtr + sizeof(record), appNamePtr, appLen);
+    memcpy(recordPtr + sizeof(record) + appLen, textPtr, textLen);
+
+    Block.rawSize += recordSize;
+    Block.numRecords++;
+    Block.appMask |= AppMaskBit(appNamePtr);
+
+    if (record.timestamp < Block.minTime)
+    {
+        Block.minTime = record.timestamp;
+    }
+    if (record.timestamp > Block.maxTime)
+    {
+        Block.maxTime = record.timestamp;
+    }
+    if (FilterLevel(record.level) > Block.maxLevel)
+    {
+        Block.maxLevel = FilterLevel(record.level);
+    }
+
+    if (Block.numRecords == 1)
+    {
+        le_timer_SetMsInterval(FlushTimerRef, LE_CONFIG_LOG_STORE_FLUSH_INTERVAL);
+        le_timer_Start(FlushTimerRef);
+    }
+
+    if ( (record.level >= LE_LOG_ERR) && (record.level != LOG_STORE_TRACE_LEVEL) )
+    {
+        ScheduleErrorFlush();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the buffered records to the current segment.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Flush
+(
+    void
+)
+{
+    WriteBlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a function with the counters of the messages received on the log store socket, for each
+ * app that sent some.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_GetSenderStats
+(
+    logStore_SenderStatsFunc_t func,    ///< [IN] Function called for each app.
+    void* contextPtr                    ///< [IN] Context pointer passed to the function.
+)
+{
+    le_hashmap_It_Ref_t iteratorRef = le_hashmap_GetIterator(SenderMapRef);
+
+    while (le_hashmap_NextNode(iteratorRef) == LE_OK)
+    {
+        const Sender_t* senderPtr = le_hashmap_GetValue(iteratorRef);
+
+        func(senderPtr->appName, senderPtr->recordCount, senderPtr->rateLimit.droppedCount,
+             contextPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the records of the log store that match a time range, an app and a minimum severity level,
+ * oldest first.  Uses the block index to skip the blocks that cannot match without decompressing
+ * them.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the log store directory doesn't exist.
+ *      LE_FAULT if the segments could not be listed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logStore_Query
+(
+    uint64_t startTime,         ///< [IN] Start of the time range, in ms since the Epoch.
+    uint64_t endTime,           ///< [IN] End of the time range (inclusive), in ms since the Epoch.
+    const char* appNamePtr,     ///< [IN] Name of the app, or NULL for all the apps.
+    le_log_Level_t minLevel,    ///< [IN] Minimum severity level.  Traces are matched as DEBUG.
+    logStore_RecordFunc_t func, ///< [IN] Function called for each matching record.
+    void* contextPtr            ///< [IN] Context pointer passed to the function.
+)
+{
+    struct dirent** entries;
+    int numEntries = scandir(LE_CONFIG_LOG_STORE_DIR, &entries, IsSegmentEntry, alphasort);
+
+    if (numEntries < 0)
+    {
+        return (errno == ENOENT) ? LE_NOT_FOUND : LE_FAULT;
+    }
+
+    int i;
+    for (i = 0; i < numEntries; i++)
+    {
+        QuerySegment(entries[i]->d_name, startTime, endTime, appNamePtr, minLevel,
+                     func, contextPtr);
+        free(entries[i]);
+    }
+    free(entries);
+
+    return LE_OK;
+}
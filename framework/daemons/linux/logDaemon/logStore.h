@@ -0,0 +1,120 @@
+/** @file logStore.h
+ *
+ * Persistent log store.  When the LOG_STORE build option is enabled, the Log Control Daemon keeps a
+ * copy of the log messages of all processes in compressed, append-only segment files, so that the
+ * logs that led to a fault can still be read after a crash or a reboot.
+ *
+ * The writing functions are used by the Log Control Daemon only.  The query function is also used
+ * by the log control tool, which reads the segment files directly.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LOG_STORE_INCLUDE_GUARD
+#define LOG_STORE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of the functions called for each record matching a query.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*logStore_RecordFunc_t)
+(
+    uint64_t timestamp,         ///< [IN] Time the record was received, in ms since the Epoch.
+    le_log_Level_t level,       ///< [IN] Severity level, -1 for traces.
+    const char* appNamePtr,     ///< [IN] Name of the app that logged the record, or "framework".
+    const char* textPtr,        ///< [IN] Text of the record.
+    void* contextPtr            ///< [IN] Context pointer given to logStore_Query().
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of the functions called with the counters of the messages received from each app on
+ * the log store socket.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*logStore_SenderStatsFunc_t)
+(
+    const char* appNamePtr,     ///< [IN] Name of the app, or "framework".
+    uint64_t recordCount,       ///< [IN] Number of messages stored.
+    uint64_t droppedCount,      ///< [IN] Number of messages dropped by the app's rate limit.
+    void* contextPtr            ///< [IN] Context pointer given to logStore_GetSenderStats().
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the log store: recovers the segments left by the previous run, opens the log store
+ * socket and starts receiving the messages that the processes send to it.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a record to the log store.  Records are buffered and written as compressed blocks, when a
+ * block is full, when the flush interval expires, or soon after an error is logged.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Add
+(
+    le_log_Level_t level,       ///< [IN] Severity level, -1 for traces.
+    const char* appNamePtr,     ///< [IN] Name of the app that logged the record.
+    const char* textPtr         ///< [IN] Text of the record.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the buffered records to the current segment.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_Flush
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls a function with the counters of the messages received on the log store socket, for each
+ * app that sent some.
+ */
+//--------------------------------------------------------------------------------------------------
+void logStore_GetSenderStats
+(
+    logStore_SenderStatsFunc_t func,    ///< [IN] Function called for each app.
+    void* contextPtr                    ///< [IN] Context pointer passed to the function.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the records of the log store that match a time range, an app and a minimum severity level,
+ * oldest first.  Uses the block index to skip the blocks that cannot match without decompressing
+ * them.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the log store directory doesn't exist.
+ *      LE_FAULT if the segments could not be listed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t logStore_Query
+(
+    uint64_t startTime,         ///< [IN] Start of the time range, in ms since the Epoch.
+    uint64_t endTime,           ///< [IN] End of the time range (inclusive), in ms since the Epoch.
+    const char* appNamePtr,     ///< [IN] Name of the app, or NULL for all the apps.
+    le_log_Level_t minLevel,    ///< [IN] Minimum severity level.  Traces are matched as DEBUG.
+    logStore_RecordFunc_t func, ///< [IN] Function called for each matching record.
+    void* contextPtr            ///< [IN] Context pointer passed to the function.
+);
+
+
+#endif // LOG_STORE_INCLUDE_GUARD
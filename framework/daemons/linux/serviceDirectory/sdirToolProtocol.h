@@ -45,6 +45,13 @@ typedef enum
     LE_SDTP_MSGID_BIND,             ///< Create one binding.  The payload is the binding details.
                                     ///  If the Service Directory runs into an error, it will
                                     ///  drop the connection to the sdir tool without responding.
+
+    LE_SDTP_MSGID_UNBIND_USER,      ///< Delete all bindings of one client user.  Only the client
+                                    ///  user ID in the payload is used.
+
+    LE_SDTP_MSGID_UNBIND_SERVER,    ///< Delete all bindings (of any client user) to the services
+                                    ///  of one server user.  Only the server user ID in the
+                                    ///  payload is used.
 }
 le_sdtp_MsgType_t;
 
@@ -1051,6 +1051,7 @@ static void CreateHardCodedBindings
     CreateBinding(uid, "le_appRemove", uid, "le_appRemove");
     CreateBinding(uid, "le_instStat", uid, "le_instStat");
     CreateBinding(uid, "le_appInfo", uid, "le_appInfo");
+    CreateBinding(uid, "le_appStats", uid, "le_appStats");
     CreateBinding(uid, "le_appProc", uid, "le_appProc");
     CreateBinding(uid, "le_ima", uid, "le_ima");
     CreateBinding(uid, "appSmack", uid, "appSmack");
@@ -2128,6 +2129,41 @@ static void SdirToolListBindings
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the statistics of the Service Directory's identity cache, which resolves the credentials
+ * of the clients and servers, to a given file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolListIdCacheStats
+(
+    int fd      ///< [in] The file descriptor to write the output to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    user_CacheStats_t stats;
+
+    user_GetCacheStats(&stats);
+
+    if (!stats.isEnabled)
+    {
+        dprintf(fd, "        disabled\n");
+        return;
+    }
+
+    uint64_t lookups = stats.hits + stats.misses;
+
+    dprintf(fd,
+            "        %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate), %" PRIu64 " flushes,"
+            " %" PRIuS " entries\n",
+            stats.hits,
+            stats.misses,
+            (lookups == 0) ? 0.0 : (100.0 * stats.hits / lookups),
+            stats.flushes,
+            stats.numEntries);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handles the "List" request from the 'sdir' tool. Dumps output in human readable format.
@@ -2157,6 +2193,10 @@ static void SdirToolList
 
         SdirToolListWaitingClients(fd);
 
+        dprintf(fd, "\nIDENTITY CACHE\n\n");
+
+        SdirToolListIdCacheStats(fd);
+
         dprintf(fd, "\n");
 
         fd_Close(fd);
@@ -2515,6 +2555,104 @@ static void SdirToolUnbindAll
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles an "Unbind User" request from the 'sdir' tool, deleting all the bindings of one client
+ * user.  Bindings of other users are left untouched, so their clients aren't disrupted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolUnbindUser
+(
+    uid_t uid   ///< [in] Unix user ID of the client user.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+
+    while (userLinkPtr != NULL)
+    {
+        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+
+        if (userPtr->uid == uid)
+        {
+            // Hold a reference so the User object doesn't go away while its bindings are deleted.
+            le_mem_AddRef(userPtr);
+
+            le_dls_Link_t* bindingLinkPtr;
+
+            while ((bindingLinkPtr = le_dls_Peek(&userPtr->bindingList)) != NULL)
+            {
+                // The destructor will remove it from the User's Binding List, etc.
+                le_mem_Release(CONTAINER_OF(bindingLinkPtr, Binding_t, link));
+            }
+
+            le_mem_Release(userPtr);
+
+            // The framework's own bindings belong to our user.  Never lose them.
+            if (uid == getuid())
+            {
+                CreateHardCodedBindings();
+            }
+
+            return;
+        }
+
+        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles an "Unbind Server" request from the 'sdir' tool, deleting the bindings of all client
+ * users to the services of one server user.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SdirToolUnbindServer
+(
+    uid_t uid   ///< [in] Unix user ID of the server user.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The framework's own bindings are served by our user.  Never delete them.
+    if (uid == getuid())
+    {
+        LE_KILL_CLIENT("Can't unbind the services of the framework's user (uid %u).", uid);
+        return;
+    }
+
+    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+
+    while (userLinkPtr != NULL)
+    {
+        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+
+        // Hold a reference so the User object doesn't go away while its bindings are deleted.
+        le_mem_AddRef(userPtr);
+
+        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
+
+        while (bindingLinkPtr != NULL)
+        {
+            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+
+            // Move on now, in case the binding gets deleted.
+            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+
+            if (bindingPtr->serverUserPtr->uid == uid)
+            {
+                // The destructor will remove it from the User's Binding List, etc.
+                le_mem_Release(bindingPtr);
+            }
+        }
+
+        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+
+        le_mem_Release(userPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handles a "Bind" request from the 'sdir' tool.
@@ -2593,6 +2731,16 @@ static void SdirToolRecv
             SdirToolBind(msgPtr);
             break;
 
+        case LE_SDTP_MSGID_UNBIND_USER:
+
+            SdirToolUnbindUser(msgPtr->client);
+            break;
+
+        case LE_SDTP_MSGID_UNBIND_SERVER:
+
+            SdirToolUnbindServer(msgPtr->server);
+            break;
+
         default:
             LE_KILL_CLIENT("Invalid message ID %d.", msgPtr->msgType);
             break;
@@ -27,6 +27,7 @@
 
 #include "legato.h"
 #include "log.h"
+#include "bootTrace.h"
 #include "start.h"
 #include "pa_start.h"
 
@@ -141,6 +142,7 @@ static const char AppsUnpackDir[] = "/legato/apps/unpack";
 static const char OldFwDir[] = "/mnt/flash/opt/legato";
 
 static const char LdconfigNotDoneMarkerFile[] = "/legato/systems/needs_ldconfig";
+static const char LdCacheSignatureFile[] = "/legato/systems/ld_cache_signature";
 static const char GoldenVersionFile[] = "/mnt/legato/system/version";
 static const char CurrentVersionFile[] = "/legato/systems/current/version";
 
@@ -160,6 +162,30 @@ static const char NoRebootFile[] = "/tmp/legato/.DEBUG_NO_REBOOT";
 //--------------------------------------------------------------------------------------------------
 #define MNT_LIB_DIR     "/mnt/legato/system/lib"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the current system's libraries, and dynamic linker's cache that indexes them.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CURRENT_LIB_DIR "/legato/systems/current/lib"
+#define LDSO_CACHE_FILE "/etc/ld.so.cache"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * FNV-1a 64-bit hash parameters, used to hash the contents of the system lib directory.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FNV_OFFSET_BASIS    0xcbf29ce484222325ULL
+#define FNV_PRIME           0x100000001b3ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the dynamic linker's cache signature (see GetLdSoCacheSignature()), including the
+ * null-terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LD_CACHE_SIGNATURE_BYTES    128
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The current start program being used.
@@ -786,9 +812,189 @@ static void Rename
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a buffer to an FNV-1a hash.
+ *
+ * @return The updated hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t HashBytes
+(
+    uint64_t hash,
+    const void* bufPtr,
+    size_t bufSize
+)
+{
+    const uint8_t* bytePtr = bufPtr;
+
+    while (bufSize-- > 0)
+    {
+        hash = (hash ^ *bytePtr++) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash the contents of the current system's lib directory: the name, type, size and modification
+ * time of every entry, and the target of symlinks.  The order of the entries doesn't matter.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the directory could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t HashLibDir
+(
+    uint64_t* hashPtr       ///< [OUT] Hash of the directory.
+)
+{
+    DIR* d = opendir(CURRENT_LIB_DIR);
+
+    if (d == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+    uint64_t dirHash = 0;
+
+    for (;;)
+    {
+        errno = 0;
+        struct dirent* entry = readdir(d);
+
+        if (entry == NULL)
+        {
+            if (errno != 0)
+            {
+                LE_ERROR("Failed to read directory entry from '%s': %m", CURRENT_LIB_DIR);
+                result = LE_FAULT;
+            }
+
+            break;
+        }
+
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        char path[PATH_MAX];
+        struct stat st;
+
+        if (   (snprintf(path, sizeof(path), "%s/%s", CURRENT_LIB_DIR, entry->d_name)
+                    >= sizeof(path))
+            || (lstat(path, &st) != 0))
+        {
+            result = LE_FAULT;
+            break;
+        }
+
+        uint64_t hash = FNV_OFFSET_BASIS;
+        hash = HashBytes(hash, entry->d_name, strlen(entry->d_name) + 1);
+        hash = HashBytes(hash, &st.st_mode, sizeof(st.st_mode));
+        hash = HashBytes(hash, &st.st_size, sizeof(st.st_size));
+        hash = HashBytes(hash, &st.st_mtime, sizeof(st.st_mtime));
+
+        if (S_ISLNK(st.st_mode))
+        {
+            char target[PATH_MAX];
+            ssize_t len = readlink(path, target, sizeof(target));
+
+            if (len < 0)
+            {
+                result = LE_FAULT;
+                break;
+            }
+
+            hash = HashBytes(hash, target, len);
+        }
+
+        // Summing the entries' hashes makes the result independent of the directory order.
+        dirHash += hash;
+    }
+
+    closedir(d);
+
+    *hashPtr = dirHash;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the signature of the dynamic linker's cache: the hash of the current system's lib directory,
+ * and the identity of the cache file.  If the signature matches the one saved when the cache was
+ * last generated, the cache is up to date for the current system.
+ *
+ * The cache file identity catches caches that were lost (e.g., kept on a tmpfs), or replaced by
+ * something else than the start program.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if the signature could not be computed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetLdSoCacheSignature
+(
+    char* bufPtr,           ///< [OUT] Signature.
+    size_t bufSize          ///< [IN] Size of the buffer (LD_CACHE_SIGNATURE_BYTES).
+)
+{
+    uint64_t libHash;
+    struct stat st;
+
+    if ((HashLibDir(&libHash) != LE_OK) || (stat(LDSO_CACHE_FILE, &st) != 0))
+    {
+        return LE_FAULT;
+    }
+
+    if (snprintf(bufPtr, bufSize, "%016" PRIx64 " %" PRIu64 " %" PRIu64 " %lld.%09ld\n",
+                 libHash,
+                 (uint64_t)st.st_ino,
+                 (uint64_t)st.st_size,
+                 (long long)st.st_mtim.tv_sec,
+                 st.st_mtim.tv_nsec) >= bufSize)
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the dynamic linker's cache is already up to date for the current system.
+ *
+ * @return true if the cache doesn't need to be regenerated.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsLdSoCacheUpToDate
+(
+    void
+)
+{
+    char savedSignature[LD_CACHE_SIGNATURE_BYTES];
+    char signature[LD_CACHE_SIGNATURE_BYTES];
+
+    return (   (ReadFromFile(LdCacheSignatureFile, savedSignature, sizeof(savedSignature)) > 0)
+            && (GetLdSoCacheSignature(signature, sizeof(signature)) == LE_OK)
+            && (strcmp(savedSignature, signature) == 0));
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * create the ld.so.cache for the new install (or reversion).
+ *
+ * Regenerating the cache is skipped if the current system's lib directory hasn't changed since
+ * the cache was last generated.
  */
 //--------------------------------------------------------------------------------------------------
 static void UpdateLdSoCache
@@ -798,6 +1004,20 @@ static void UpdateLdSoCache
 {
     int rc = 0;
     const char* text;
+
+    if (IsLdSoCacheUpToDate())
+    {
+        LE_INFO("Libraries unchanged, dynamic linker cache is up to date.");
+        bootTrace_Record(BOOT_TRACE_PHASE, 0, "ld cache (unchanged)");
+        unlink(LdconfigNotDoneMarkerFile);
+        return;
+    }
+
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "ld cache");
+
+    // The signature is only valid for the cache it was saved with.
+    unlink(LdCacheSignatureFile);
+
     // create marker file to say we are doing ldconfig
     text = "start_ldconfig";
     // If this fails, try to limp along anyway.
@@ -805,23 +1025,34 @@ static void UpdateLdSoCache
 
     if (FileExists("/usr/sbin/update-ld-cache"))
     {
-        rc = system("/usr/sbin/update-ld-cache /legato/systems/current/lib > /dev/null");
+        rc = system("/usr/sbin/update-ld-cache " CURRENT_LIB_DIR " > /dev/null");
     }
     else
     {
         // append /legato/systems/current/lib to /etc/ld.so.conf if it is not present. This path is
         // added at the end of the file to preserve the current paths set.
-        rc = system("/bin/grep -q '^/legato/systems/current/lib$' /etc/ld.so.conf 2>/dev/null || "
-                    "/bin/echo /legato/systems/current/lib >>/etc/ld.so.conf");
+        rc = system("/bin/grep -q '^" CURRENT_LIB_DIR "$' /etc/ld.so.conf 2>/dev/null || "
+                    "/bin/echo " CURRENT_LIB_DIR " >>/etc/ld.so.conf");
         if (!WIFEXITED(rc) || !WEXITSTATUS(rc))
         {
-            LE_ERROR("Add of path /legato/systems/current/lib to /etc/ld.so.conf fails: %d",
+            LE_ERROR("Add of path " CURRENT_LIB_DIR " to /etc/ld.so.conf fails: %d",
                      WEXITSTATUS(rc));
         }
 
         rc = system("/sbin/ldconfig > /dev/null");
     }
 
+    // Save the signature of the new cache so that it isn't regenerated for nothing next time.
+    if (WIFEXITED(rc) && (WEXITSTATUS(rc) == 0))
+    {
+        char signature[LD_CACHE_SIGNATURE_BYTES];
+
+        if (GetLdSoCacheSignature(signature, sizeof(signature)) == LE_OK)
+        {
+            (void)WriteToFile(LdCacheSignatureFile, signature, strlen(signature));
+        }
+    }
+
     // If this fails, the system probably won't work, but not much we can do but try.
     if (!WIFEXITED(rc) || !WEXITSTATUS(rc))
     {
@@ -1362,6 +1593,7 @@ static int TryToRun
 {
 
     // Start the Supervisor.
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "launch supervisor");
     pid_t supervisorPid = fork();
     if (supervisorPid == 0)
     {
@@ -2186,7 +2418,11 @@ int main
 
     daemon_Daemonize(5000); // 5 second timeout in case older supervisor is installed.
 
+    // Trace the start-up of the framework.
+    bootTrace_Begin();
+
     LE_INFO("Loading platform adaptor");
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "load platform adaptor");
     LoadPa();
 
     LE_INFO("Initializing platform adaptor");
@@ -2199,15 +2435,20 @@ int main
         {
             // Verify and install the current system.
             // R/O system are always ready. So, nothing to do for them.
+            bootTrace_Record(BOOT_TRACE_PHASE, 0, "select system");
             CheckAndInstallCurrentSystem();
         }
 
         // Fix ld.so.conf in case the system is still running an older version of start
         // script that makes legato use the wrong liblegato path.
+        bootTrace_Record(BOOT_TRACE_PHASE, 0, "fix ld.so.conf");
         FixLdSoConf();
 
         // Run the current system.
         Launch(isReadOnly);
+
+        // The Supervisor exited (e.g., the framework is being restarted), trace its next start-up.
+        bootTrace_Begin();
     }
 
     return 0;
@@ -61,6 +61,7 @@
 #include "file.h"
 #include "ima.h"
 #include "kernelModules.h"
+#include "appStats.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -233,7 +234,11 @@ static const FileLinkObj_t DefaultLinks[] =
 static const FileLinkObj_t DefaultTmpLinks[] =
 {
     {.src = LE_SVCDIR_SERVER_SOCKET_NAME, .dest = "/tmp/legato/"},
-    {.src = LE_SVCDIR_CLIENT_SOCKET_NAME, .dest = "/tmp/legato/"}
+    {.src = LE_SVCDIR_CLIENT_SOCKET_NAME, .dest = "/tmp/legato/"},
+#if LE_CONFIG_LOG_STORE
+    // Log store socket of the Log Control Daemon (LOG_STORE_SOCKET_NAME in logDaemon.h).
+    {.src = LE_CONFIG_RUNTIME_DIR "/logStore", .dest = "/tmp/legato/"}
+#endif
 };
 
 
@@ -3578,6 +3583,9 @@ void app_Delete
 
     CleanupResourceCfg(appRef);
 
+    // Take the last sample of the app's resources before its cgroups are removed.
+    appStats_StopApp(appRef->name);
+
     // Remove the resource limits.
     resLim_CleanupApp(appRef);
 
@@ -3636,6 +3644,7 @@ le_result_t app_Start
     }
 
     appRef->state = APP_STATE_RUNNING;
+    appStats_StartApp(appRef->name);
 
     // Set SMACK rules for this app.
     // Setup the runtime area in the file system.
@@ -3780,6 +3789,7 @@ void app_Stop
 
         CleanupAppSmackSettings(appRef);
 
+        appStats_StopApp(appRef->name);
         appRef->state = APP_STATE_STOPPED;
     }
 }
@@ -4904,5 +4914,6 @@ void app_StopComplete
     CleanupAppSmackSettings(appRef);
     LE_INFO("app '%s' has stopped.", appRef->name);
 
+    appStats_StopApp(appRef->name);
     appRef->state = APP_STATE_STOPPED;
 }
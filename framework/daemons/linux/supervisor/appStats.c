@@ -0,0 +1,562 @@
+//--------------------------------------------------------------------------------------------------
+/** @file appStats.c
+ *
+ * Periodic sampling of the resources used by the applications, and implementation of the
+ * le_appStats API.
+ *
+ * A single timer samples all the running applications in turn.  For each application, the cpu
+ * time and memory use are read from the application's cgroups, and the threads, file descriptors
+ * and sockets are counted from /proc for each process of the application.  The samples of each
+ * application are kept in a fixed-size ring, so the memory used does not grow over time.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "appStats.h"
+#include "interfaces.h"
+#include "limit.h"
+#include "cgroups.h"
+#include "fileDescriptor.h"
+#include <dirent.h>
+
+
+#if LE_CONFIG_SUPERV_APP_STATS_HISTORY > LE_APPSTATS_MAX_SAMPLES
+#error "LE_CONFIG_SUPERV_APP_STATS_HISTORY is larger than LE_APPSTATS_MAX_SAMPLES."
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples kept for each application.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HISTORY_DEPTH                   LE_CONFIG_SUPERV_APP_STATS_HISTORY
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of processes of an application that are read from /proc in a sample.  All the
+ * processes are counted though.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SAMPLED_PROCS               64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimated maximum number of applications.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EST_MAX_NUM_APPS                31
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prefix of the link of a file descriptor that is a socket.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SOCKET_LINK_PREFIX              "socket:"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource usage history of an application.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char name[LIMIT_MAX_APP_NAME_BYTES];        ///< Application name.  Key of the AppStatsMap.
+    bool isRunning;                             ///< true if the application is sampled.
+    uint64_t lastCpuTime;                       ///< Cpu time of the cgroup at the last sample (ns).
+    le_clk_Time_t lastTime;                     ///< Time of the last sample.
+    size_t first;                               ///< Index of the oldest sample.
+    size_t count;                               ///< Number of samples kept.
+    le_appStats_Sample_t samples[HISTORY_DEPTH];    ///< Ring of samples.
+}
+AppStats_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for application histories.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AppStatsPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Application histories, by application name.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t AppStatsMap;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling timer.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t SampleTimer;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Converts a time to nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t TimeToNs
+(
+    le_clk_Time_t time          ///< [IN] Time.
+)
+{
+    return (uint64_t)time.sec * 1000000000 + (uint64_t)time.usec * 1000;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the number of threads of a process from /proc/<pid>/stat.
+ *
+ * @return
+ *      The number of threads, 0 if the process is gone.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetNumThreads
+(
+    pid_t pid                   ///< [IN] Process ID.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    char buffer[512];
+
+    LE_ASSERT(snprintf(path, sizeof(path), "/proc/%d/stat", pid) < sizeof(path));
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd == -1)
+    {
+        return 0;
+    }
+
+    ssize_t numBytes;
+
+    do
+    {
+        numBytes = read(fd, buffer, sizeof(buffer) - 1);
+    }
+    while ((numBytes == -1) && (errno == EINTR));
+
+    fd_Close(fd);
+
+    if (numBytes <= 0)
+    {
+        return 0;
+    }
+
+    buffer[numBytes] = '\0';
+
+    // The process name is between parentheses and can contain spaces, so start after it.  The
+    // number of threads is the 18th field after the name.
+    char* fieldsPtr = strrchr(buffer, ')');
+    long numThreads;
+
+    if ( (fieldsPtr == NULL) ||
+         (sscanf(fieldsPtr + 1,
+                 " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %ld",
+                 &numThreads) != 1) ||
+         (numThreads < 0) )
+    {
+        LE_WARN("Could not read the number of threads of process %d.", pid);
+        return 0;
+    }
+
+    return numThreads;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts the open file descriptors and sockets of a process from /proc/<pid>/fd.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountFds
+(
+    pid_t pid,                  ///< [IN] Process ID.
+    uint32_t* numFdsPtr,        ///< [IN/OUT] Incremented by the number of file descriptors.
+    uint32_t* numSocketsPtr     ///< [IN/OUT] Incremented by the number of sockets.
+)
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+
+    LE_ASSERT(snprintf(path, sizeof(path), "/proc/%d/fd", pid) < sizeof(path));
+
+    DIR* dirPtr = opendir(path);
+
+    if (dirPtr == NULL)
+    {
+        return;
+    }
+
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        if (entryPtr->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        (*numFdsPtr)++;
+
+        char link[sizeof(SOCKET_LINK_PREFIX)];
+        ssize_t linkSize = readlinkat(dirfd(dirPtr), entryPtr->d_name, link, sizeof(link));
+
+        if ( (linkSize >= (ssize_t)sizeof(SOCKET_LINK_PREFIX) - 1) &&
+             (memcmp(link, SOCKET_LINK_PREFIX, sizeof(SOCKET_LINK_PREFIX) - 1) == 0) )
+        {
+            (*numSocketsPtr)++;
+        }
+    }
+
+    closedir(dirPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Samples the resources used by an application and adds the sample to its history.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleApp
+(
+    AppStats_t* appPtr          ///< [IN] Application to sample.
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_appStats_Sample_t* samplePtr;
+
+    if (appPtr->count < HISTORY_DEPTH)
+    {
+        samplePtr = &appPtr->samples[(appPtr->first + appPtr->count) % HISTORY_DEPTH];
+        appPtr->count++;
+    }
+    else
+    {
+        // Overwrite the oldest sample.
+        samplePtr = &appPtr->samples[appPtr->first];
+        appPtr->first = (appPtr->first + 1) % HISTORY_DEPTH;
+    }
+
+    memset(samplePtr, 0, sizeof(*samplePtr));
+    samplePtr->timestamp = TimeToNs(now) / 1000000;
+
+    // Cpu load since the last sample.
+    uint64_t cpuTime;
+
+    if (cgrp_cpu_GetUsage(appPtr->name, &cpuTime) == LE_OK)
+    {
+        uint64_t elapsed = TimeToNs(now) - TimeToNs(appPtr->lastTime);
+
+        if ((elapsed > 0) && (cpuTime >= appPtr->lastCpuTime))
+        {
+            samplePtr->cpuLoad = (cpuTime - appPtr->lastCpuTime) * 10000 / elapsed;
+        }
+
+        appPtr->lastCpuTime = cpuTime;
+    }
+
+    appPtr->lastTime = now;
+
+    // Memory.
+    ssize_t memUsed = cgrp_GetMemUsed(appPtr->name);
+
+    if (memUsed >= 0)
+    {
+        samplePtr->memUsed = memUsed;
+    }
+
+    memUsed = cgrp_GetMaxMemUsed(appPtr->name);
+
+    if (memUsed >= 0)
+    {
+        samplePtr->maxMemUsed = memUsed;
+    }
+
+    // Processes.  The freezer cgroup holds all the processes of the app, including the realtime
+    // ones that are not in its cpu cgroup.
+    pid_t pids[MAX_SAMPLED_PROCS];
+    ssize_t numProcs = cgrp_GetProcessesList(CGRP_SUBSYS_FREEZE,
+                                             appPtr->name,
+                                             pids,
+                                             MAX_SAMPLED_PROCS);
+
+    if (numProcs > 0)
+    {
+        samplePtr->numProcs = numProcs;
+
+        ssize_t i;
+        for (i = 0; (i < numProcs) && (i < MAX_SAMPLED_PROCS); i++)
+        {
+            samplePtr->numThreads += GetNumThreads(pids[i]);
+            CountFds(pids[i], &samplePtr->numFds, &samplePtr->numSockets);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Samples all the running applications.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Sampling timer.
+)
+{
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(AppStatsMap);
+
+    while (le_hashmap_NextNode(iter) == LE_OK)
+    {
+        AppStats_t* appPtr = le_hashmap_GetValue(iter);
+
+        if (appPtr->isRunning)
+        {
+            SampleApp(appPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drops the history of an uninstalled application.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppUninstallHandler
+(
+    const char* appNamePtr,     ///< [IN] Application uninstalled.
+    void* contextPtr            ///< [IN] Not used.
+)
+{
+    AppStats_t* appPtr = le_hashmap_Get(AppStatsMap, appNamePtr);
+
+    if ((appPtr != NULL) && !appPtr->isRunning)
+    {
+        le_hashmap_Remove(AppStatsMap, appNamePtr);
+        le_mem_Release(appPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the history of an application for a client.  Kills the client if the name is invalid.
+ *
+ * @return
+ *      The history, NULL if the application has not been sampled.
+ */
+//--------------------------------------------------------------------------------------------------
+static AppStats_t* GetClientApp
+(
+    const char* appNamePtr      ///< [IN] Application name.
+)
+{
+    if ( (appNamePtr == NULL) || (appNamePtr[0] == '\0') || (strchr(appNamePtr, '/') != NULL) )
+    {
+        LE_KILL_CLIENT("Invalid app name.");
+        return NULL;
+    }
+
+    AppStats_t* appPtr = le_hashmap_Get(AppStatsMap, appNamePtr);
+
+    if ((appPtr == NULL) || (appPtr->count == 0))
+    {
+        return NULL;
+    }
+
+    return appPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the application statistics sub-system and starts the sampling timer.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_Init
+(
+    void
+)
+{
+    AppStatsPool = le_mem_CreatePool("AppStats", sizeof(AppStats_t));
+    AppStatsMap = le_hashmap_Create("AppStats",
+                                    EST_MAX_NUM_APPS,
+                                    le_hashmap_HashString,
+                                    le_hashmap_EqualsString);
+
+    le_instStat_AddAppUninstallEventHandler(AppUninstallHandler, NULL);
+
+    if (LE_CONFIG_SUPERV_APP_STATS_INTERVAL > 0)
+    {
+        SampleTimer = le_timer_Create("AppStats");
+        LE_ASSERT(le_timer_SetMsInterval(SampleTimer, LE_CONFIG_SUPERV_APP_STATS_INTERVAL) == LE_OK);
+        LE_ASSERT(le_timer_SetRepeat(SampleTimer, 0) == LE_OK);
+        LE_ASSERT(le_timer_SetHandler(SampleTimer, SampleTimerHandler) == LE_OK);
+        LE_ASSERT(le_timer_Start(SampleTimer) == LE_OK);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts sampling an application.  Must be called when the application starts, once its cgroups
+ * are created.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_StartApp
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+)
+{
+    if (LE_CONFIG_SUPERV_APP_STATS_INTERVAL == 0)
+    {
+        return;
+    }
+
+    AppStats_t* appPtr = le_hashmap_Get(AppStatsMap, appNamePtr);
+
+    if (appPtr == NULL)
+    {
+        appPtr = le_mem_ForceAlloc(AppStatsPool);
+        memset(appPtr, 0, sizeof(*appPtr));
+        LE_ASSERT(le_utf8_Copy(appPtr->name, appNamePtr, sizeof(appPtr->name), NULL) == LE_OK);
+
+        le_hashmap_Put(AppStatsMap, appPtr->name, appPtr);
+    }
+
+    // The cgroups are kept when the app stops, so take the cpu time they already hold as the base.
+    uint64_t cpuTime;
+
+    appPtr->isRunning = true;
+    appPtr->lastCpuTime = (cgrp_cpu_GetUsage(appNamePtr, &cpuTime) == LE_OK) ? cpuTime : 0;
+    appPtr->lastTime = le_clk_GetRelativeTime();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a last sample of an application and stops sampling it.  Its history is kept until it is
+ * uninstalled.  Must be called when the application stops, before its cgroups are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_StopApp
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+)
+{
+    AppStats_t* appPtr = le_hashmap_Get(AppStatsMap, appNamePtr);
+
+    if ((appPtr != NULL) && appPtr->isRunning)
+    {
+        SampleApp(appPtr);
+        appPtr->isRunning = false;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the interval between two samples.
+ *
+ * @return
+ *      Sampling interval in milliseconds, 0 if sampling is disabled.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_appStats_GetInterval
+(
+    void
+)
+{
+    return LE_CONFIG_SUPERV_APP_STATS_INTERVAL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the last sample taken for the specified application.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the application has not been sampled.
+ *
+ * @note If the application name pointer is null or if its string is empty or of bad format it is a
+ *       fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_appStats_GetLatest
+(
+    const char* appName,
+        ///< [IN] Application name.
+    le_appStats_Sample_t* samplePtr
+        ///< [OUT] Last sample.
+)
+{
+    AppStats_t* appPtr = GetClientApp(appName);
+
+    if (appPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    *samplePtr = appPtr->samples[(appPtr->first + appPtr->count - 1) % HISTORY_DEPTH];
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the samples kept for the specified application, oldest first.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the application has not been sampled.
+ *
+ * @note If the application name pointer is null or if its string is empty or of bad format it is a
+ *       fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_appStats_GetHistory
+(
+    const char* appName,
+        ///< [IN] Application name.
+    le_appStats_Sample_t* samplesPtr,
+        ///< [OUT] Samples, oldest first.
+    size_t* samplesSizePtr
+        ///< [INOUT]
+)
+{
+    AppStats_t* appPtr = GetClientApp(appName);
+
+    if (appPtr == NULL)
+    {
+        *samplesSizePtr = 0;
+        return LE_NOT_FOUND;
+    }
+
+    // Return the newest samples if the buffer cannot hold all of them.
+    size_t skip = (appPtr->count > *samplesSizePtr) ? appPtr->count - *samplesSizePtr : 0;
+    size_t i;
+
+    for (i = skip; i < appPtr->count; i++)
+    {
+        samplesPtr[i - skip] = appPtr->samples[(appPtr->first + i) % HISTORY_DEPTH];
+    }
+
+    *samplesSizePtr = appPtr->count - skip;
+
+    return LE_OK;
+}
@@ -0,0 +1,48 @@
+//--------------------------------------------------------------------------------------------------
+/** @file appStats.h
+ *
+ * API for sampling the resources used by the applications.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_APP_STATS_INCLUDE_GUARD
+#define LEGATO_SRC_APP_STATS_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the application statistics sub-system and starts the sampling timer.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts sampling an application.  Must be called when the application starts, once its cgroups
+ * are created.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_StartApp
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a last sample of an application and stops sampling it.  Its history is kept until it is
+ * uninstalled.  Must be called when the application stops, before its cgroups are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+void appStats_StopApp
+(
+    const char* appNamePtr          ///< [IN] Name of the application.
+);
+
+
+#endif  // LEGATO_SRC_APP_STATS_INCLUDE_GUARD
@@ -73,6 +73,7 @@
 #include "cgroups.h"
 #include "file.h"
 #include "installer.h"
+#include "bootTrace.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -668,6 +669,7 @@ static le_result_t StartApp
     appContainerPtr->isActive = true;
 
     // Start the app.
+    bootTrace_Record(BOOT_TRACE_APP_START, 0, app_GetName(appContainerPtr->appRef));
 
     le_result_t result = app_Start(appContainerPtr->appRef);
 
@@ -8,6 +8,7 @@
  */
 #include "legato.h"
 #include "frameworkDaemons.h"
+#include "bootTrace.h"
 #include "limit.h"
 #include "fileDescriptor.h"
 #include "killProc.h"
@@ -271,6 +272,8 @@ static void StartDaemon
     // Store the pid of the running daemon process.
     daemonPtr->pid = pid;
 
+    bootTrace_Record(BOOT_TRACE_DAEMON_EXEC, pid, daemonNamePtr);
+
     // Close the write end of the pipe because the parent does not need it.
     fd_Close(syncPipeFd[1]);
 
@@ -290,6 +293,8 @@ static void StartDaemon
     // Close the read end of the pipe because it is no longer used.
     fd_Close(syncPipeFd[0]);
 
+    bootTrace_Record(BOOT_TRACE_DAEMON_READY, pid, daemonNamePtr);
+
     LE_INFO("Started system process '%s' with PID: %d.", daemonNamePtr, pid);
 }
 
@@ -338,6 +343,7 @@ void fwDaemons_Start
     }
 
     // Load the current IPC binding configuration into the Service Directory.
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "load bindings");
     LoadIpcBindingConfig();
 }
 
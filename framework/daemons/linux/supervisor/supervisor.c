@@ -218,6 +218,7 @@
 #include "sysPaths.h"
 #include "daemon.h"
 #include "apps.h"
+#include "appStats.h"
 #include "wait.h"
 #include "fileSystem.h"
 #include "sysStatus.h"
@@ -228,6 +229,7 @@
 #include "ima.h"
 #include "fs.h"
 #include "log.h"
+#include "bootTrace.h"
 #include "dir.h"
 
 
@@ -524,10 +526,12 @@ static void StartFramework
     alarm(30);
 
     // Start all framework daemons.
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "framework daemons");
     fwDaemons_Start();
 
     // Connect to the services we need from the framework daemons.
     LE_DEBUG("---- Connecting to services ----");
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "connect services");
     log_ConnectToControlDaemon();
     le_cfg_ConnectService();
     logFd_ConnectService();
@@ -537,6 +541,7 @@ static void StartFramework
     alarm(0);
 
     // Insert kernel modules
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "kernel modules");
     kernelModules_Insert();
 
     // Advertise services.
@@ -546,6 +551,7 @@ static void StartFramework
     wdog_AdvertiseService();
     supervisorWdog_AdvertiseService();
     le_appInfo_AdvertiseService();
+    le_appStats_AdvertiseService();
     le_appProc_AdvertiseService();
     le_ima_AdvertiseService();
     le_kernelModule_AdvertiseService();
@@ -559,7 +565,9 @@ static void StartFramework
                 "Failed to redirect stdin to /dev/null.  %m.");
 
     // Initialize the apps sub system.
+    bootTrace_Record(BOOT_TRACE_PHASE, 0, "apps");
     apps_Init();
+    appStats_Init();
     apps_VerifyAppWriteableDeviceFiles();
 
     State = STATE_NORMAL;
@@ -574,6 +582,8 @@ static void StartFramework
     {
         LE_INFO("Skipping app auto-start.");
     }
+
+    bootTrace_End();
 }
 
 
@@ -35,6 +35,7 @@
 #include "sysStatus.h"
 #include "system.h"
 #include "supCtrl.h"
+#include "sdirCtrl.h"
 #include "instStat.h"
 #include "installer.h"
 #include "smack.h"
@@ -920,6 +921,10 @@ le_result_t app_InstallIndividual
         smack_SetLabel(path, "framework");
     }
 
+    // Remember which user the app's bindings are kept under, in case the upgrade changes it.
+    uid_t prevUid;
+    bool hasPrevUid = (systemHasThisApp && (sdirCtrl_GetAppUid(appNamePtr, &prevUid) == LE_OK));
+
     // If this app is already in the current system but its app hash is different,
     if (systemHasThisApp)
     {
@@ -960,12 +965,8 @@ le_result_t app_InstallIndividual
     }
 
 
-    // Reload the bindings configuration
-    int retCode;
-    if ((retCode = system("/legato/systems/current/bin/sdir load")) != 0)
-    {
-        LE_WARN("Failed to load application bindings.  sdir load returned %d", retCode);
-    }
+    // Update the app's bindings in the Service Directory.
+    sdirCtrl_BindApp(appNamePtr, hasPrevUid ? &prevUid : NULL);
 
     ExecPostinstallHook(appMd5Ptr);
 
@@ -1041,16 +1042,22 @@ le_result_t app_RemoveIndividual
     // Make sure that the application isn't running when we attempt to uninstall it.
     supCtrl_StopApp(appNamePtr);
 
+    // Get the user the app's bindings are kept under before the app's user is deleted.
+    uid_t appUid;
+    le_result_t uidResult = sdirCtrl_GetAppUid(appNamePtr, &appUid);
+
     PerformAppDelete(appHash, appNamePtr, i);
 
     system_UnlinkApp("current", delAppName);
 
-    // Reload the bindings configuration
-    int retCode;
-    if ((retCode = system("/legato/systems/current/bin/sdir load")) != 0)
+    // Remove the app's bindings from the Service Directory.  If its user wasn't found, its
+    // bindings can't be told apart from the others, so all of them are reloaded.
+    if (uidResult != LE_OK)
     {
-        LE_WARN("Failed to load application bindings.  sdir load returned %d", retCode);
+        LE_WARN("User of app '%s' not found (%s).  Reloading all bindings.",
+                appNamePtr, LE_RESULT_TXT(uidResult));
     }
+    sdirCtrl_UnbindApp((uidResult == LE_OK) ? &appUid : NULL);
 
     sysStatus_MarkTried();
 
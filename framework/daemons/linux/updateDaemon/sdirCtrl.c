@@ -0,0 +1,525 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file sdirCtrl.c
+ *
+ * Keeps the Service Directory's bindings up to date when apps are installed and removed.
+ *
+ * Running "sdir load" makes the Service Directory delete every binding in the system and then
+ * re-create them one by one from the configuration tree, which takes longer and longer as apps are
+ * added.  Instead, this module talks the 'sdir' tool protocol to the Service Directory itself and
+ * only touches the bindings that involve the app being updated:
+ *  - the app's own bindings (its client-side interfaces), which are replaced; and
+ *  - other apps' and users' bindings to the app's services, which are created when the app's user
+ *    first appears and deleted when it goes away.
+ *
+ * Apps that are not sandboxed run as root and share root's bindings with the framework and with
+ * each other, so those still get a full "sdir load".
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_cfg_interface.h"
+#include "sdirToolProtocol.h"
+#include "limit.h"
+#include "user.h"
+#include "sdirCtrl.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reload all of the system's bindings using the 'sdir' tool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadAllBindings
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int retCode;
+    if ((retCode = system("/legato/systems/current/bin/sdir load")) != 0)
+    {
+        LE_WARN("Failed to load application bindings.  sdir load returned %d", retCode);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the user ID that an app's bindings are kept under.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the app (or its user) doesn't exist.
+ *      - LE_FAULT for any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetAppUid
+(
+    le_cfg_IteratorRef_t i,     ///< [IN] Read iterator on the "system" config tree.
+    const char* appNamePtr,     ///< [IN] The name of the app.
+    uid_t* uidPtr               ///< [OUT] The user ID.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char path[LIMIT_MAX_PATH_BYTES];
+    if (snprintf(path, sizeof(path), "/apps/%s/sandboxed", appNamePtr) >= sizeof(path))
+    {
+        LE_CRIT("Config node path too long (app name '%s').", appNamePtr);
+        return LE_FAULT;
+    }
+
+    // Apps that are not sandboxed run as root.
+    if (!le_cfg_GetBool(i, path, true))
+    {
+        *uidPtr = 0;
+        return LE_OK;
+    }
+
+    le_result_t result = user_GetAppUid(appNamePtr, uidPtr);
+    if ((result != LE_OK) && (result != LE_NOT_FOUND))
+    {
+        LE_CRIT("Failed to get the user ID of app '%s' (%s).", appNamePtr, LE_RESULT_TXT(result));
+        return LE_FAULT;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handles the Service Directory dropping the session, which it does if it doesn't like a request.
+ * The pending request then fails, and that is dealt with by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SessionCloseHandler
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Not used.
+    void* contextPtr                ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_WARN("Service Directory closed the session.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a session with the Service Directory's 'sdir' tool service.
+ *
+ * @return The session reference, or NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t OpenSession
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetProtocolRef(LE_SDTP_PROTOCOL_ID,
+                                                             sizeof(le_sdtp_Msg_t));
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(protocolRef, LE_SDTP_INTERFACE_NAME);
+
+    le_msg_SetSessionCloseHandler(sessionRef, SessionCloseHandler, NULL);
+
+    le_result_t result = le_msg_TryOpenSessionSync(sessionRef);
+    if (result != LE_OK)
+    {
+        LE_ERROR("Can't communicate with the Service Directory (%s).", LE_RESULT_TXT(result));
+        le_msg_DeleteSession(sessionRef);
+        return NULL;
+    }
+
+    return sessionRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request to the Service Directory and wait for it to be processed.
+ *
+ * @return LE_OK if successful, LE_COMM_ERROR if the Service Directory dropped the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendRequest
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session with the Service Directory.
+    const le_sdtp_Msg_t* reqPtr     ///< [IN] The request.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+    memcpy(le_msg_GetPayloadPtr(msgRef), reqPtr, sizeof(*reqPtr));
+
+    msgRef = le_msg_RequestSyncResponse(msgRef);
+    if (msgRef == NULL)
+    {
+        return LE_COMM_ERROR;
+    }
+
+    le_msg_ReleaseMsg(msgRef);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the binding that a config iterator is positioned on to the Service Directory.  Bindings
+ * to servers that aren't installed are skipped, like "sdir load" does.
+ *
+ * @return LE_OK unless the Service Directory dropped the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendBinding
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session with the Service Directory.
+    le_cfg_IteratorRef_t i,         ///< [IN] Iterator positioned on the binding's config node.
+    uid_t clientUid                 ///< [IN] User ID of the client.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sdtp_Msg_t req = { .msgType = LE_SDTP_MSGID_BIND, .client = clientUid };
+    char path[LIMIT_MAX_PATH_BYTES];
+
+    if (   (le_cfg_GetNodeName(i, "", req.clientInterfaceName,
+                               sizeof(req.clientInterfaceName)) != LE_OK)
+        || (le_cfg_GetString(i, "interface", req.serverInterfaceName,
+                             sizeof(req.serverInterfaceName), "") != LE_OK)
+        || (req.serverInterfaceName[0] == '\0'))
+    {
+        le_cfg_GetPath(i, "", path, sizeof(path));
+        LE_CRIT("Bad binding config (@ %s)", path);
+        return LE_OK;
+    }
+
+    // Get the server's user ID, from its app name or its user name.
+    char name[LIMIT_MAX_USER_NAME_BYTES] = "";
+    le_result_t result;
+
+    if (le_cfg_GetString(i, "app", name, sizeof(name), "") == LE_OK && name[0] != '\0')
+    {
+        result = GetAppUid(i, name, &req.server);
+    }
+    else if (le_cfg_GetString(i, "user", name, sizeof(name), "") == LE_OK && name[0] != '\0')
+    {
+        result = user_GetUid(name, &req.server);
+    }
+    else
+    {
+        le_cfg_GetPath(i, "", path, sizeof(path));
+        LE_CRIT("Server user name or app name missing (@ %s)", path);
+        return LE_OK;
+    }
+
+    if (result != LE_OK)
+    {
+        // This happens if the server app isn't installed yet.  The binding will be created when
+        // it is.
+        LE_DEBUG("Skipping binding of %s to '%s' (%s).",
+                 req.clientInterfaceName,
+                 name,
+                 LE_RESULT_TXT(result));
+        return LE_OK;
+    }
+
+    return SendRequest(sessionRef, &req);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the binding that a config iterator is positioned on is served by a given app.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsServedByApp
+(
+    le_cfg_IteratorRef_t i,         ///< [IN] Iterator positioned on the binding's config node.
+    const char* appNamePtr,         ///< [IN] Name of the app.
+    const char* appUserNamePtr      ///< [IN] Name of the app's user.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char name[LIMIT_MAX_USER_NAME_BYTES];
+
+    if (le_cfg_NodeExists(i, "app"))
+    {
+        return (   (le_cfg_GetString(i, "app", name, sizeof(name), "") == LE_OK)
+                && (strcmp(name, appNamePtr) == 0));
+    }
+
+    return (   (le_cfg_GetString(i, "user", name, sizeof(name), "") == LE_OK)
+            && (strcmp(name, appUserNamePtr) == 0));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the bindings of all apps or all users (other than the given app) to the services of the
+ * given app.
+ *
+ * @return LE_OK unless the Service Directory dropped the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendBindingsToApp
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session with the Service Directory.
+    le_cfg_IteratorRef_t i,         ///< [IN] Read iterator on the "system" config tree.
+    const char* collectionPtr,      ///< [IN] "/apps" or "/users".
+    const char* appNamePtr,         ///< [IN] Name of the app.
+    const char* appUserNamePtr      ///< [IN] Name of the app's user.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isApps = (strcmp(collectionPtr, "/apps") == 0);
+    le_result_t result = LE_OK;
+
+    le_cfg_GoToNode(i, collectionPtr);
+
+    le_result_t iterResult = le_cfg_GoToFirstChild(i);
+    while ((iterResult == LE_OK) && (result == LE_OK))
+    {
+        char name[LIMIT_MAX_USER_NAME_BYTES];
+
+        if (   (le_cfg_GetNodeName(i, "", name, sizeof(name)) == LE_OK)
+            && !(isApps && (strcmp(name, appNamePtr) == 0)))
+        {
+            bool haveUid = false;
+            uid_t clientUid;
+
+            le_cfg_GoToNode(i, "bindings");
+            le_result_t bindingResult = le_cfg_GoToFirstChild(i);
+            while ((bindingResult == LE_OK) && (result == LE_OK))
+            {
+                if (IsServedByApp(i, appNamePtr, appUserNamePtr))
+                {
+                    // Only look up the client's user ID if it has bindings to the app.
+                    if (!haveUid)
+                    {
+                        le_result_t uidResult = isApps ? GetAppUid(i, name, &clientUid)
+                                                       : user_GetUid(name, &clientUid);
+                        if (uidResult != LE_OK)
+                        {
+                            LE_WARN("Can't get the user ID of '%s' (%s).",
+                                    name,
+                                    LE_RESULT_TXT(uidResult));
+                            break;
+                        }
+                        haveUid = true;
+                    }
+
+                    result = SendBinding(sessionRef, i, clientUid);
+                }
+
+                bindingResult = le_cfg_GoToNextSibling(i);
+            }
+
+            // Go back up to the app's or user's node.
+            le_cfg_GoToNode(i, collectionPtr);
+            le_cfg_GoToNode(i, name);
+        }
+
+        iterResult = le_cfg_GoToNextSibling(i);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete all bindings of an app's user, and those of everybody else to the app user's services.
+ *
+ * @return LE_OK unless the Service Directory dropped the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendUnbindRequests
+(
+    le_msg_SessionRef_t sessionRef, ///< [IN] Session with the Service Directory.
+    uid_t uid                       ///< [IN] User ID of the app.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sdtp_Msg_t req = { .msgType = LE_SDTP_MSGID_UNBIND_USER, .client = uid };
+
+    le_result_t result = SendRequest(sessionRef, &req);
+    if (result == LE_OK)
+    {
+        req.msgType = LE_SDTP_MSGID_UNBIND_SERVER;
+        req.server = uid;
+
+        result = SendRequest(sessionRef, &req);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the user ID that an installed app's bindings are kept under in the Service Directory.
+ * This is the app's own user, or root if the app is not sandboxed.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the app (or its user) doesn't exist.
+ *      - LE_FAULT for any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t sdirCtrl_GetAppUid
+(
+    const char* appNamePtr,     ///< [IN] The name of the app.
+    uid_t* uidPtr               ///< [OUT] The user ID.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:/apps");
+
+    le_result_t result = LE_NOT_FOUND;
+    if (le_cfg_NodeExists(i, appNamePtr))
+    {
+        result = GetAppUid(i, appNamePtr, uidPtr);
+    }
+
+    le_cfg_CancelTxn(i);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the Service Directory after an app has been installed or upgraded.  The app's own
+ * bindings are replaced with those in its configuration, and, if the app's user is new, the
+ * bindings of other apps and users to the app's services are created.
+ *
+ * Falls back to reloading all of the system's bindings if the app is not sandboxed or if the
+ * incremental update fails.
+ */
+//--------------------------------------------------------------------------------------------------
+void sdirCtrl_BindApp
+(
+    const char* appNamePtr,     ///< [IN] The name of the app.
+    const uid_t* prevUidPtr     ///< [IN] User ID the app's bindings were kept under before the
+                                ///<      update, or NULL if the app was not installed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uid_t uid;
+    char appUserName[LIMIT_MAX_USER_NAME_BYTES];
+
+    if (   (sdirCtrl_GetAppUid(appNamePtr, &uid) != LE_OK)
+        || (uid == 0)
+        || ((prevUidPtr != NULL) && (*prevUidPtr == 0))
+        || (user_AppNameToUserName(appNamePtr, appUserName, sizeof(appUserName)) != LE_OK))
+    {
+        LoadAllBindings();
+        return;
+    }
+
+    le_msg_SessionRef_t sessionRef = OpenSession();
+    if (sessionRef == NULL)
+    {
+        LoadAllBindings();
+        return;
+    }
+
+    le_result_t result = LE_OK;
+
+    // If the app's user changed, nobody must stay bound to the old one.
+    bool isNewUser = ((prevUidPtr == NULL) || (*prevUidPtr != uid));
+    if ((prevUidPtr != NULL) && isNewUser)
+    {
+        result = SendUnbindRequests(sessionRef, *prevUidPtr);
+    }
+
+    // Replace the app's own bindings.  The app isn't running, so nobody is disrupted.
+    if (result == LE_OK)
+    {
+        le_sdtp_Msg_t req = { .msgType = LE_SDTP_MSGID_UNBIND_USER, .client = uid };
+        result = SendRequest(sessionRef, &req);
+    }
+
+    le_cfg_IteratorRef_t i = le_cfg_CreateReadTxn("system:/apps");
+
+    if (result == LE_OK)
+    {
+        le_cfg_GoToNode(i, appNamePtr);
+        le_cfg_GoToNode(i, "bindings");
+
+        le_result_t iterResult = le_cfg_GoToFirstChild(i);
+        while ((iterResult == LE_OK) && (result == LE_OK))
+        {
+            result = SendBinding(sessionRef, i, uid);
+
+            iterResult = le_cfg_GoToNextSibling(i);
+        }
+    }
+
+    // Bindings to the services of an app whose user didn't exist yet were skipped until now.
+    // Bindings to an existing user are already in place.
+    if ((result == LE_OK) && isNewUser)
+    {
+        result = SendBindingsToApp(sessionRef, i, "/users", appNamePtr, appUserName);
+        if (result == LE_OK)
+        {
+            result = SendBindingsToApp(sessionRef, i, "/apps", appNamePtr, appUserName);
+        }
+    }
+
+    le_cfg_CancelTxn(i);
+
+    le_msg_DeleteSession(sessionRef);
+
+    if (result != LE_OK)
+    {
+        LE_WARN("Failed to update the bindings of app '%s'.  Reloading all bindings.", appNamePtr);
+        LoadAllBindings();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all bindings of a removed app from the Service Directory: the app's own bindings and the
+ * bindings of other apps and users to the app's services.
+ *
+ * Falls back to reloading all of the system's bindings if the app's user is not known, if the app
+ * ran as root or if the incremental update fails.
+ */
+//--------------------------------------------------------------------------------------------------
+void sdirCtrl_UnbindApp
+(
+    const uid_t* uidPtr         ///< [IN] User ID the app's bindings were kept under, as returned
+                                ///<      by sdirCtrl_GetAppUid() before the app was removed, or
+                                ///<      NULL if it could not be found.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((uidPtr == NULL) || (*uidPtr == 0))
+    {
+        LoadAllBindings();
+        return;
+    }
+
+    le_msg_SessionRef_t sessionRef = OpenSession();
+    if (sessionRef == NULL)
+    {
+        LoadAllBindings();
+        return;
+    }
+
+    le_result_t result = SendUnbindRequests(sessionRef, *uidPtr);
+
+    le_msg_DeleteSession(sessionRef);
+
+    if (result != LE_OK)
+    {
+        LE_WARN("Failed to remove the bindings of uid %u.  Reloading all bindings.", *uidPtr);
+        LoadAllBindings();
+    }
+}
@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file sdirCtrl.h
+ *
+ * Updates the Service Directory's bindings when apps are installed and removed.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#ifndef __UPDATE_DAEMON_SDIR_CTRL_H_INCLUDE_GUARD
+#define __UPDATE_DAEMON_SDIR_CTRL_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the user ID that an installed app's bindings are kept under in the Service Directory.
+ * This is the app's own user, or root if the app is not sandboxed.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the app (or its user) doesn't exist.
+ *      - LE_FAULT for any other failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t sdirCtrl_GetAppUid
+(
+    const char* appNamePtr,     ///< [IN] The name of the app.
+    uid_t* uidPtr               ///< [OUT] The user ID.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the Service Directory after an app has been installed or upgraded.  The app's own
+ * bindings are replaced with those in its configuration, and, if the app's user is new, the
+ * bindings of other apps and users to the app's services are created.
+ *
+ * Falls back to reloading all of the system's bindings if the app is not sandboxed or if the
+ * incremental update fails.
+ */
+//--------------------------------------------------------------------------------------------------
+void sdirCtrl_BindApp
+(
+    const char* appNamePtr,     ///< [IN] The name of the app.
+    const uid_t* prevUidPtr     ///< [IN] User ID the app's bindings were kept under before the
+                                ///<      update, or NULL if the app was not installed.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all bindings of a removed app from the Service Directory: the app's own bindings and the
+ * bindings of other apps and users to the app's services.
+ *
+ * Falls back to reloading all of the system's bindings if the app's user is not known, if the app
+ * ran as root or if the incremental update fails.
+ */
+//--------------------------------------------------------------------------------------------------
+void sdirCtrl_UnbindApp
+(
+    const uid_t* uidPtr         ///< [IN] User ID the app's bindings were kept under, as returned
+                                ///<      by sdirCtrl_GetAppUid() before the app was removed, or
+                                ///<      NULL if it could not be found.
+);
+
+
+#endif // __UPDATE_DAEMON_SDIR_CTRL_H_INCLUDE_GUARD
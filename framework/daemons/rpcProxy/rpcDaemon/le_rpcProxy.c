@@ -770,8 +770,9 @@ static le_result_t RecvRpcMsg
             size_t remainingData = (msgStatePtr->expectedSize - msgStatePtr->recvSize);
             size_t receivedSize = remainingData;
 
-            result = le_comm_Receive(handle,
-                                     msgStatePtr->buffer + msgStatePtr->offSet, &receivedSize);
+            result = rpcProxy_RecvBytes(handle, msgStatePtr,
+                                        msgStatePtr->buffer + msgStatePtr->offSet, &receivedSize,
+                                        remainingData);
             if (result != LE_OK || receivedSize > remainingData)
             {
                 return LE_COMM_ERROR;
@@ -829,7 +830,12 @@ static le_result_t RecvRpcMsg
                 LE_ERROR("Error happened when processing a proxy message from %s", systemName);
                 return LE_COMM_ERROR;
             }
-            break;
+            if ((msgStatePtr->recvState != NETWORK_MSG_DONE) || (msgStatePtr->pendingSize == 0))
+            {
+                break;
+            }
+            // The start of the next message has already been received along with this one, and
+            // will not be reported again by the fd monitor: receive it now.
         }
         // Increment recv state to the next COMPLETE State
         AdvanceRecvMsgState(msgStatePtr);
@@ -267,6 +267,7 @@ void rpcProxyNetwork_StartNetworkConnectionRetryTimer
 
         // Reset Network Message Re-assembly State-Machine
         networkTimerPtr->record.messageState.recvState = NETWORK_MSG_IDLE;
+        networkTimerPtr->record.messageState.pendingSize = 0;
     }
 
     // Set Network Status record  in the timer event
@@ -572,6 +573,7 @@ le_result_t rpcProxyNetwork_CreateNetworkCommunicationChannel
 
     // Reset Network Message Re-assembly State-Machine
     networkRecordPtr->messageState.recvState = NETWORK_MSG_IDLE;
+    networkRecordPtr->messageState.pendingSize = 0;
 
     LE_ASSERT(networkRecordPtr->handle == NULL);
 
@@ -748,6 +750,7 @@ void rpcProxyNetwork_DeleteNetworkCommunicationChannel
 
     // Reset Network Message Re-assembly State-Machine
     networkRecordPtr->messageState.recvState = NETWORK_MSG_IDLE;
+    networkRecordPtr->messageState.pendingSize = 0;
 
     // Stop Network Keep-Alive service
     StopNetworkKeepAliveService(systemName, networkRecordPtr);
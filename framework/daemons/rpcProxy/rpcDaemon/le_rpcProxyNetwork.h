@@ -38,6 +38,32 @@ union allMessages{
 };
 #define RPC_PROXY_RECV_BUFFER_MAX  sizeof(union allMessages)
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes requested past the end of the item being received, when a message body
+ * is received in bulk.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RPC_PROXY_RECV_BULK_EXTRA_SIZE  LE_CONFIG_RPC_PROXY_RECV_BULK_EXTRA_SIZE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes received ahead, that are kept for the item by item receive or for the
+ * following messages: the bulk extra plus the largest item header (a semantic tag and the header
+ * of the tagged item) that may be handed back to the item by item receive.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RPC_PROXY_RECV_PENDING_MAX      (RPC_PROXY_RECV_BULK_EXTRA_SIZE + \
+                                         LE_PACK_SEMANTIC_TAG_MAX_SIZE + \
+                                         LE_PACK_POS_INTEGER_MAX_SIZE)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of collections that can be nested in a message body item received in bulk.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RPC_PROXY_RECV_NESTING_MAX      4
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -96,6 +122,7 @@ typedef enum MessageStreamState
     STREAM_CBOR_HEADER,         ///< Expecting CBOR header byte of an item
     STREAM_CBOR_ITEM_BODY,      ///< Expecting body of a cbor byte string or txt string item
     STREAM_INTEGER_ITEM,        ///< Expecting an integer CBOR item.
+    STREAM_PLANNED_BODY,        ///< Receiving an IPC message body in bulk, following a repack plan.
     STREAM_DONE                 ///< Streaming is done.
 } MessageStreamState_t;
 
@@ -110,6 +137,8 @@ typedef struct StreamState
     char workBuff[16];               ///< Temp buffer for state machine
     size_t expectedSize;             ///< Number of bytes that needed to be read
     size_t recvSize;                 ///< Number of bytes that have been read so far
+    bool readAhead;                  ///< Whether the last expected byte is the first byte of
+                                     ///< the next state, received along with this state's data
     le_msg_MessageRef_t msgRef;      ///< Messsage reference for the message being streamed
     size_t ipcMsgPayloadOffset;      ///< Offset in the ipc message buffer
     size_t msgBuffSizeLeft;          ///< Number of bytes left in msg buff size
@@ -120,6 +149,14 @@ typedef struct StreamState
     unsigned int collectionsLayer;   ///< Collections layer.
     bool isAsyncMsg;                 ///< Determines whether this is an async message.
     uint32_t asyncMsgId;             ///< Stores message id for async messages
+    struct RepackPlan* planPtr;      ///< Repack plan followed, or being recorded, to receive the
+                                     ///< message body in bulk (NULL if received item by item)
+    unsigned int planStep;           ///< Index of the plan step being received
+    size_t itemSizeLeft;             ///< Bytes left to receive in the string body being received
+                                     ///< in bulk
+    unsigned int nestingDepth;       ///< Number of collections open in the plan step
+    uint32_t nestedItemsLeft[RPC_PROXY_RECV_NESTING_MAX]; ///< Items left to receive in each open
+                                     ///< collection (UINT32_MAX if indefinite)
 #ifdef RPC_PROXY_LOCAL_SERVICE
     uint8_t slotIndex;               ///< Slot index for optimization of local service messages
     le_dls_List_t localBuffers;      ///< List of local buffers which have been created for
@@ -142,6 +179,10 @@ typedef struct NetworkMessageState
     uint8_t  type;         ///< Message Type (RPC_PROXY_CONNECT_SERVICE_REQUEST,
                            ///< RPC_PROXY_CONNECT_SERVICE_RESPONSE, etc.)
     StreamState_t streamState; ///< Holds the state information for streaming messages
+    uint8_t  pendingBuff[RPC_PROXY_RECV_PENDING_MAX]; ///< Bytes received past the end of the last
+                                                      ///< message received in bulk
+    size_t   pendingOffset; ///< Offset of the first pending byte in pendingBuff
+    size_t   pendingSize;   ///< Number of pending bytes
 }
 NetworkMessageState_t;
 
@@ -336,6 +377,28 @@ le_result_t rpcProxyNetwork_InitializeOnce
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive bytes of an rpc stream, starting with the bytes already received past the end of the
+ * previous message.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - Otherwise the error returned by le_comm_Receive().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t rpcProxy_RecvBytes
+(
+    void* handle,                       ///< [IN] Opaque handle to the le_comm communication channel
+    NetworkMessageState_t* msgStatePtr, ///< [IN] Pointer to the Message State-Machine data
+    void* bufferPtr,                    ///< [OUT] Buffer for the received bytes
+    size_t* lenPtr,                     ///< [IN/OUT] Room in the buffer, and number of bytes
+                                        ///<         received
+    size_t minSize                      ///< [IN] Number of bytes known to follow in the stream.
+                                        ///<      The le_comm channel is only read if fewer than
+                                        ///<      that many bytes are pending.
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive an rpc stream
@@ -97,6 +97,41 @@
  * byte strings, the destination buffer is set to the IPC message buffer or the payload buffer of
  * file stream message.
  *
+ *
+ * @subsection stream_read_ahead Reading ahead
+ *
+ * Every state costs at least one call to @c le_comm_Receive, so to keep the number of calls down
+ * the state machine receives the first byte of the next state along with the current state's data
+ * whenever that byte is known to exist: the IPC message ID is always followed by the body's array
+ * header, and inside an indefinite array any item other than a break is at least followed by the
+ * break closing the array. This way the CBOR header of most items comes for free with the end of
+ * the previous item, and string bodies are received in the same call as the following header,
+ * still directly into the IPC message buffer. The stream is never read past the end of the current
+ * message here: only the bulk receive below does so, and it keeps the extra bytes for the next one.
+ *
+ *
+ * @subsection stream_plan Repack plans
+ *
+ * Messages of a given IPC message ID usually carry the same items in the same order, so the item by
+ * item receive above does the same work again for every one of them. The first time a message ID is
+ * received, its top-level items are recorded into a repack plan (see @ref RepackPlan_t): CBOR type,
+ * semantic tag, and what has to be done to the item (copied as is, reference checked, context
+ * pointer remapped, string or out size checked against the buffer). The following messages of that
+ * ID are then received in bulk straight into the IPC message buffer, and repacked in place while
+ * being checked against the plan; strings are never copied twice, and only context pointers, whose
+ * encoding may change size, move the bytes that follow them.
+ *
+ * Each bulk read asks for the bytes known to be missing plus @c RPC_PROXY_RECV_BULK_EXTRA_SIZE
+ * more. Bytes received past the end of the message are kept in the @c pendingBuff of the network
+ * message state, and handed out first by @ref rpcProxy_RecvBytes, which every receive of the
+ * message header and stream goes through.
+ *
+ * An item that does not follow the plan, or that cannot be repacked in place (e.g. a file stream
+ * or, for local services, an optimized string), hands the rest of the body over to the item by
+ * item receive, starting with that item. If this happens while the plan is recorded, the message ID
+ * is marked as never received in bulk. Plans are never freed: at most
+ * @c RPC_PROXY_REPACK_PLAN_MAX_NUM message IDs get one, the others are received item by item.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -118,6 +153,8 @@
 #define RPC_PROXY_MSG_OUT_PARAMETER_MAX_NUM    (RPC_PROXY_LARGE_OUT_PARAMETER_MAX_NUM + \
                                                 RPC_PROXY_SMALL_OUT_PARAMETER_MAX_NUM)
 #define IPC_MSG_ID_SIZE                        sizeof(uint32_t)
+#define RPC_PROXY_REPACK_PLAN_MAX_NUM          LE_CONFIG_RPC_PROXY_REPACK_PLAN_MAX_NUM
+#define RPC_PROXY_REPACK_PLAN_MAX_STEPS        24
 // Initial number of bytes expected to parse an async (event) message:
 // 4 for id, 1 for indef array header, 1 for async handler tag, 2 for async handler tag value
 #define ASYNC_MSG_INITIAL_EXPECTED_SIZE        IPC_MSG_ID_SIZE + 1 + 1 + 2
@@ -660,6 +697,131 @@ static le_mem_PoolRef_t ResponseParameterArrayPoolRef = NULL;
 
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Action taken to repack a top-level item of an IPC message body received in bulk.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum RepackAction
+{
+    REPACK_UNSUPPORTED = 0,     ///< Item must be received item by item.
+    REPACK_COPY,                ///< Scalar item, copied as is.
+    REPACK_UINT32,              ///< 32-bit unsigned integer (e.g. "out" parameter size), copied.
+    REPACK_REFERENCE,           ///< Safe reference, copied.
+    REPACK_CONTEXT,             ///< Event handler context or reference, remapped.
+    REPACK_STRING,              ///< Text or byte string, copied as is.
+    REPACK_ARRAY,               ///< Array, its items being repacked in turn.
+    REPACK_BREAK                ///< End of an indefinite length array.
+}
+RepackAction_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Repack plan step: how to repack one top-level item of an IPC message body.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct RepackStep
+{
+    uint8_t itemType;               ///< CBOR type of the item (negative integers are recorded as
+                                    ///< positive ones)
+    uint8_t action;                 ///< Repack action (RepackAction_t)
+    le_pack_SemanticTag_t tag;      ///< Semantic tag preceding the item (0 if none)
+}
+RepackStep_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Repack plan status.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum RepackPlanStatus
+{
+    REPACK_PLAN_RECORDING = 0,      ///< Plan is being recorded from the first message received.
+    REPACK_PLAN_READY,              ///< Plan can be followed.
+    REPACK_PLAN_NONE                ///< Messages cannot be received in bulk.
+}
+RepackPlanStatus_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of a repack plan: a message ID of a service, in one direction.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct RepackPlanKey
+{
+    uint32_t serviceId;             ///< Service ID
+    uint32_t msgId;                 ///< IPC message ID
+    uint8_t type;                   ///< RPC message type (client request or server response)
+}
+RepackPlanKey_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Repack plan: layout of the IPC message bodies of a given message ID, learnt from the first
+ * message received, so that the following ones can be received in bulk.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct RepackPlan
+{
+    RepackPlanKey_t key;                                ///< Message ID the plan applies to
+    RepackPlanStatus_t status;                          ///< Plan status
+    unsigned int stepCount;                             ///< Number of steps (top-level items)
+    RepackStep_t steps[RPC_PROXY_REPACK_PLAN_MAX_STEPS]; ///< Steps
+}
+RepackPlan_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This pool is used to allocate repack plans.  Plans are kept for the lifetime of the process.
+ * Initialized in rpcProxy_InitializeOnceStreamingMemPools().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_MEM_DEFINE_STATIC_POOL(RepackPlanPool, RPC_PROXY_REPACK_PLAN_MAX_NUM, sizeof(RepackPlan_t));
+static le_mem_PoolRef_t RepackPlanPoolRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash Map to store repack plans (value), using the message ID (key).
+ * Initialized in rpcProxy_InitializeOnceStreamingMemPools().
+ */
+//--------------------------------------------------------------------------------------------------
+LE_HASHMAP_DEFINE_STATIC(RepackPlanHashMap, RPC_PROXY_REPACK_PLAN_MAX_NUM);
+static le_hashmap_Ref_t RepackPlanByMsgId = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash a repack plan key.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashRepackPlanKey
+(
+    const void* keyPtr      ///< [IN] Pointer to the repack plan key
+)
+{
+    const RepackPlanKey_t* planKeyPtr = keyPtr;
+
+    return (planKeyPtr->serviceId * 31 + planKeyPtr->msgId) * 2 + planKeyPtr->type;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two repack plan keys.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsRepackPlanKey
+(
+    const void* firstKeyPtr,    ///< [IN] Pointer to the first repack plan key
+    const void* secondKeyPtr    ///< [IN] Pointer to the second repack plan key
+)
+{
+    const RepackPlanKey_t* firstPlanKeyPtr = firstKeyPtr;
+    const RepackPlanKey_t* secondPlanKeyPtr = secondKeyPtr;
+
+    return ((firstPlanKeyPtr->serviceId == secondPlanKeyPtr->serviceId) &&
+            (firstPlanKeyPtr->msgId == secondPlanKeyPtr->msgId) &&
+            (firstPlanKeyPtr->type == secondPlanKeyPtr->type));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Helper functions for checking tags:
@@ -1205,7 +1367,7 @@ static void ReferenceCallback
         void* newContext;
         uint32_t contextPtrValue = (uint32_t) value;
 
-        rpcEventHandler_RepackOutgoingContext(sendContextPtr->lastTag, (void*) contextPtrValue,
+        rpcEventHandler_RepackOutgoingContext(sendContextPtr->lastTag, (void*)(uintptr_t) contextPtrValue,
                                               &newContext,
                                               sendContextPtr->messagePtr);
         //new write the new context:
@@ -1575,6 +1737,16 @@ void rpcProxy_InitializeOnceStreamingMemPools()
                                           le_hashmap_HashVoidPointer,
                                           le_hashmap_EqualsVoidPointer);
 #endif
+
+    RepackPlanPoolRef = le_mem_InitStaticPool(RepackPlanPool,
+                                              RPC_PROXY_REPACK_PLAN_MAX_NUM,
+                                              sizeof(RepackPlan_t));
+
+    // Create hash map for repack plans, using the message ID (key).
+    RepackPlanByMsgId = le_hashmap_InitStatic(RepackPlanHashMap,
+                                              RPC_PROXY_REPACK_PLAN_MAX_NUM,
+                                              HashRepackPlanKey,
+                                              EqualsRepackPlanKey);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1716,7 +1888,7 @@ static const dispatchFunc_fpt DispatchTable[LE_RPC_NUM_DISPATCH_IDXS][LE_CBOR_TY
                                              [LE_CBOR_TYPE_BYTE_STRING]  = HandleStringHeader,
                                              [LE_CBOR_TYPE_TEXT_STRING]  = HandleStringHeader,
                                              [LE_CBOR_TYPE_ITEM_ARRAY]   = HandleArrayHeader,
-                                             [LE_CBOR_TYPE_SEMANTIC_TAG] = HandleSemanticTag,
+                                             [LE_CBOR_TYPE_TAG]          = HandleSemanticTag,
                                              [LE_CBOR_TYPE_BOOLEAN]      = HandleWithDirectCopy,
                                              [LE_CBOR_TYPE_DOUBLE]       = HandleWithDirectCopy,
                                              [LE_CBOR_TYPE_INDEF_END]    = HandleIndefEnd,
@@ -1728,7 +1900,7 @@ static const dispatchFunc_fpt DispatchTable[LE_RPC_NUM_DISPATCH_IDXS][LE_CBOR_TY
                                              [LE_CBOR_TYPE_BYTE_STRING]  = HandleAsError,
                                              [LE_CBOR_TYPE_TEXT_STRING]  = HandleAsError,
                                              [LE_CBOR_TYPE_ITEM_ARRAY]   = HandleAsError,
-                                             [LE_CBOR_TYPE_SEMANTIC_TAG] = HandleAsError,
+                                             [LE_CBOR_TYPE_TAG]          = HandleAsError,
                                              [LE_CBOR_TYPE_BOOLEAN]      = HandleAsError,
                                              [LE_CBOR_TYPE_DOUBLE]       = HandleAsError,
                                              [LE_CBOR_TYPE_INDEF_END]    = HandleAsError,
@@ -1740,7 +1912,7 @@ static const dispatchFunc_fpt DispatchTable[LE_RPC_NUM_DISPATCH_IDXS][LE_CBOR_TY
                                              [LE_CBOR_TYPE_BYTE_STRING]  = HandleAsError,
                                              [LE_CBOR_TYPE_TEXT_STRING]  = HandleAsError,
                                              [LE_CBOR_TYPE_ITEM_ARRAY]   = HandleAsError,
-                                             [LE_CBOR_TYPE_SEMANTIC_TAG] = HandleAsError,
+                                             [LE_CBOR_TYPE_TAG]          = HandleAsError,
                                              [LE_CBOR_TYPE_BOOLEAN]      = HandleAsError,
                                              [LE_CBOR_TYPE_DOUBLE]       = HandleAsError,
                                              [LE_CBOR_TYPE_INDEF_END]    = HandleAsError,
@@ -1752,7 +1924,7 @@ static const dispatchFunc_fpt DispatchTable[LE_RPC_NUM_DISPATCH_IDXS][LE_CBOR_TY
                                              [LE_CBOR_TYPE_BYTE_STRING]  = HandleAsError,
                                              [LE_CBOR_TYPE_TEXT_STRING]  = HandleAsError,
                                              [LE_CBOR_TYPE_ITEM_ARRAY]   = HandleAsError,
-                                             [LE_CBOR_TYPE_SEMANTIC_TAG] = HandleAsError,
+                                             [LE_CBOR_TYPE_TAG]          = HandleAsError,
                                              [LE_CBOR_TYPE_BOOLEAN]      = HandleAsError,
                                              [LE_CBOR_TYPE_DOUBLE]       = HandleAsError,
                                              [LE_CBOR_TYPE_INDEF_END]    = HandleAsError,
@@ -1772,9 +1944,28 @@ static void GoToCborHeaderState
 {
     streamStatePtr->state = STREAM_CBOR_HEADER;
     streamStatePtr->expectedSize = 1;
+    streamStatePtr->readAhead = false;
     streamStatePtr->destBuff = (void*) streamStatePtr->workBuff;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check whether the item being received is necessarily followed by at least one more byte of the
+ *  stream, in which case that byte can be received along with the item.
+ *
+ *  Inside an indefinite length array, any item other than a break is followed by at least the
+ *  break closing the array, so reading one byte past the item never reads past the end of the
+ *  message.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool CanReadAhead
+(
+    StreamState_t* streamStatePtr  ///< [IN] Pointer to the Stream State-Machine data
+)
+{
+    return (streamStatePtr->collectionsLayer > 0);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Go to Integer Item state
@@ -1787,7 +1978,8 @@ static void GoToIntegerItemState
 )
 {
     streamStatePtr->state = STREAM_INTEGER_ITEM;
-    streamStatePtr->expectedSize = expectedBytes;
+    streamStatePtr->readAhead = CanReadAhead(streamStatePtr);
+    streamStatePtr->expectedSize = expectedBytes + (streamStatePtr->readAhead ? 1 : 0);
     streamStatePtr->destBuff = (void*)(streamStatePtr->workBuff + 1);
 }
 
@@ -1800,11 +1992,15 @@ static void GoToCborItemBodyState
 (
     StreamState_t* streamStatePtr, ///< [IN] Pointer to the Stream State-Machine data
     size_t expectedBytes,          ///< [IN] Bytes expected for this integer item.
-    void* destBuff                 ///< [IN] Pointer to destination buffer
+    void* destBuff,                ///< [IN] Pointer to destination buffer
+    size_t destBuffSize            ///< [IN] Room in the destination buffer.  The item is received
+                                   ///<      along with the next byte of the stream if there is
+                                   ///<      room for it.
 )
 {
     streamStatePtr->state = STREAM_CBOR_ITEM_BODY;
-    streamStatePtr->expectedSize = expectedBytes;
+    streamStatePtr->readAhead = (CanReadAhead(streamStatePtr) && (destBuffSize > expectedBytes));
+    streamStatePtr->expectedSize = expectedBytes + (streamStatePtr->readAhead ? 1 : 0);
     streamStatePtr->destBuff = destBuff;
 }
 
@@ -1822,6 +2018,7 @@ static void GoToConstantLengthMessageState
 {
     streamStatePtr->state = STREAM_CONSTANT_LENGTH_MSG;
     streamStatePtr->expectedSize = expectedBytes;
+    streamStatePtr->readAhead = false;
     streamStatePtr->destBuff = destBuff;
 }
 
@@ -1835,8 +2032,11 @@ static void GoToIpcMessageIdState
     StreamState_t* streamStatePtr  ///< [IN] Pointer to the Stream State-Machine data
 )
 {
+    // The message ID is always followed by the indefinite array holding the message body, so
+    // the array header is received along with the ID.
     streamStatePtr->destBuff = streamStatePtr->workBuff;
-    streamStatePtr->expectedSize = IPC_MSG_ID_SIZE;
+    streamStatePtr->expectedSize = IPC_MSG_ID_SIZE + 1;
+    streamStatePtr->readAhead = true;
     streamStatePtr->state = STREAM_MSG_ID;
 }
 
@@ -1850,8 +2050,11 @@ static void GoToAsyncEventInitState
     StreamState_t* streamStatePtr  ///< [IN] Pointer to the Stream State-Machine data
 )
 {
+    // The initial bytes are always followed by the reference, so its CBOR header is received
+    // along with them.
     streamStatePtr->destBuff = streamStatePtr->workBuff;
-    streamStatePtr->expectedSize = ASYNC_MSG_INITIAL_EXPECTED_SIZE;
+    streamStatePtr->expectedSize = ASYNC_MSG_INITIAL_EXPECTED_SIZE + 1;
+    streamStatePtr->readAhead = true;
     streamStatePtr->state = STREAM_ASYNC_EVENT_INIT;
 }
 
@@ -1867,6 +2070,7 @@ static void GoToDoneState
 {
     streamStatePtr->state = STREAM_DONE;
     streamStatePtr->expectedSize = 0;
+    streamStatePtr->readAhead = false;
     streamStatePtr->destBuff = NULL;
 }
 
@@ -2062,7 +2266,9 @@ static le_result_t RepackUnOptimizedData
     {
         if (length > 0)
         {
-            GoToCborItemBodyState(streamStatePtr, (size_t)length, (void*)responsePtr);
+            // The local buffer has no room to spare: do not receive the next byte into it.
+            GoToCborItemBodyState(streamStatePtr, (size_t)length, (void*)responsePtr,
+                                  (size_t)length);
         }
         else
         {
@@ -2180,6 +2386,11 @@ static le_result_t HandleIndefEnd
         {
             GoToDoneState(streamStatePtr);
         }
+        else
+        {
+            // The header may have been read ahead, which moved the destination buffer.
+            GoToCborHeaderState(streamStatePtr);
+        }
     }
     return ret;
 }
@@ -2308,8 +2519,16 @@ static le_result_t HandleStringHeader
             rpcProxy_FileStreamMessage_t* fileStreamMsgPtr =
                 (rpcProxy_FileStreamMessage_t*)proxyMessagePtr;
             fileStreamMsgPtr->payloadSize = (uint16_t) length;
-            GoToCborItemBodyState(streamStatePtr, (size_t) length,
-                                  (void*) fileStreamMsgPtr->payload);
+            if (length > 0)
+            {
+                GoToCborItemBodyState(streamStatePtr, (size_t) length,
+                                      (void*) fileStreamMsgPtr->payload,
+                                      RPC_PROXY_MAX_FILESTREAM_PAYLOAD_SIZE);
+            }
+            else
+            {
+                GoToCborHeaderState(streamStatePtr);
+            }
         }
         else
         {
@@ -2363,7 +2582,16 @@ static le_result_t HandleStringHeader
         }
 
         // if header was packed successfully need to move to next state to receive string body
-        GoToCborItemBodyState(streamStatePtr, length, *bufferPtr);
+        // directly into the ipc message buffer.
+        if (length > 0)
+        {
+            GoToCborItemBodyState(streamStatePtr, length, *bufferPtr,
+                                  streamStatePtr->msgBuffSizeLeft - (*bufferPtr - buffStart));
+        }
+        else
+        {
+            GoToCborHeaderState(streamStatePtr);
+        }
     }
 
     // done handling the value, update remaining size:
@@ -2608,7 +2836,7 @@ static le_result_t HandleReference
         // event handler tag to handle.
         LE_DEBUG("Handling an event reference value:%"PRIu32", Tag: %"PRIu16"", value,
                 streamStatePtr->lastTag);
-        ret = rpcEventHandler_RepackIncomingContext(streamStatePtr->lastTag, (void*)value, &newRef,
+        ret = rpcEventHandler_RepackIncomingContext(streamStatePtr->lastTag, (void*)(uintptr_t)value, &newRef,
                                                     proxyMessagePtr);
         if (ret != LE_OK)
         {
@@ -2726,6 +2954,632 @@ static le_result_t HandleWithDirectCopy
     return ret;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive bytes of an rpc stream, starting with the bytes already received past the end of the
+ * previous message.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - Otherwise the error returned by le_comm_Receive().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t rpcProxy_RecvBytes
+(
+    void* handle,                       ///< [IN] Opaque handle to the le_comm communication channel
+    NetworkMessageState_t* msgStatePtr, ///< [IN] Pointer to the Message State-Machine data
+    void* bufferPtr,                    ///< [OUT] Buffer for the received bytes
+    size_t* lenPtr,                     ///< [IN/OUT] Room in the buffer, and number of bytes
+                                        ///<         received
+    size_t minSize                      ///< [IN] Number of bytes known to follow in the stream.
+                                        ///<      The le_comm channel is only read if fewer than
+                                        ///<      that many bytes are pending.
+)
+{
+    size_t pendingSize = ((*lenPtr < msgStatePtr->pendingSize) ?
+                          *lenPtr : msgStatePtr->pendingSize);
+    if (pendingSize > 0)
+    {
+        memcpy(bufferPtr, msgStatePtr->pendingBuff + msgStatePtr->pendingOffset, pendingSize);
+        msgStatePtr->pendingOffset += pendingSize;
+        msgStatePtr->pendingSize -= pendingSize;
+        if (msgStatePtr->pendingSize == 0)
+        {
+            msgStatePtr->pendingOffset = 0;
+        }
+    }
+
+    if ((pendingSize >= minSize) || (pendingSize == *lenPtr))
+    {
+        *lenPtr = pendingSize;
+        return LE_OK;
+    }
+
+    size_t receivedSize = *lenPtr - pendingSize;
+    le_result_t result = le_comm_Receive(handle, (uint8_t*)bufferPtr + pendingSize, &receivedSize);
+    *lenPtr = pendingSize + ((result == LE_OK) ? receivedSize : 0);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Keep bytes received ahead of the stream, to be received again by the following states or
+ * messages.  They are placed before any byte still pending.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_OVERFLOW if there is no room left for them.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t KeepPendingBytes
+(
+    NetworkMessageState_t* msgStatePtr, ///< [IN] Pointer to the Message State-Machine data
+    const uint8_t* dataPtr,             ///< [IN] Bytes received ahead
+    size_t size                         ///< [IN] Number of bytes received ahead
+)
+{
+    if (size == 0)
+    {
+        return LE_OK;
+    }
+    if (size + msgStatePtr->pendingSize > sizeof(msgStatePtr->pendingBuff))
+    {
+        LE_ERROR("Too many bytes received ahead: %" PRIuS, size + msgStatePtr->pendingSize);
+        return LE_OVERFLOW;
+    }
+
+    memmove(msgStatePtr->pendingBuff + size,
+            msgStatePtr->pendingBuff + msgStatePtr->pendingOffset,
+            msgStatePtr->pendingSize);
+    memcpy(msgStatePtr->pendingBuff, dataPtr, size);
+    msgStatePtr->pendingOffset = 0;
+    msgStatePtr->pendingSize += size;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the action to take to repack an item received in bulk.
+ *
+ * Only items which are repacked as they are received, or which only need fixed size changes, can
+ * be received in bulk: strings that are optimized into local buffers, file stream metadata and
+ * unexpected items are left to the item by item receive.
+ */
+//--------------------------------------------------------------------------------------------------
+static RepackAction_t GetRepackAction
+(
+    StreamState_t* streamStatePtr, ///< [IN] Pointer to the Stream State-Machine data
+    le_cbor_Type_t itemType,       ///< [IN] CBOR type of the item
+    le_pack_SemanticTag_t tag      ///< [IN] Semantic tag preceding the item (0 if none)
+)
+{
+    switch (tag)
+    {
+        case 0:
+        case LE_PACK_OUT_STRING_RESPONSE:
+        case LE_PACK_OUT_BYTE_STR_RESPONSE:
+            break;
+        case LE_PACK_REFERENCE:
+            return ((itemType == LE_CBOR_TYPE_POS_INTEGER) ? REPACK_REFERENCE : REPACK_UNSUPPORTED);
+        case LE_PACK_OUT_STRING_SIZE:
+        case LE_PACK_OUT_BYTE_STR_SIZE:
+            return (((itemType == LE_CBOR_TYPE_POS_INTEGER) && !DoIOptimize(streamStatePtr)) ?
+                    REPACK_UINT32 : REPACK_UNSUPPORTED);
+        case LE_PACK_CONTEXT_PTR_REFERENCE:
+        case LE_PACK_ASYNC_HANDLER_REFERENCE:
+            return ((itemType == LE_CBOR_TYPE_POS_INTEGER) ? REPACK_CONTEXT : REPACK_UNSUPPORTED);
+        default:
+            return REPACK_UNSUPPORTED;
+    }
+
+    switch (itemType)
+    {
+        case LE_CBOR_TYPE_POS_INTEGER:
+        case LE_CBOR_TYPE_NEG_INTEGER:
+        case LE_CBOR_TYPE_BOOLEAN:
+        case LE_CBOR_TYPE_DOUBLE:
+            return REPACK_COPY;
+        case LE_CBOR_TYPE_BYTE_STRING:
+        case LE_CBOR_TYPE_TEXT_STRING:
+            return (DoIOptimize(streamStatePtr) ? REPACK_UNSUPPORTED : REPACK_STRING);
+        case LE_CBOR_TYPE_ITEM_ARRAY:
+            return REPACK_ARRAY;
+        case LE_CBOR_TYPE_INDEF_END:
+            return ((tag == 0) ? REPACK_BREAK : REPACK_UNSUPPORTED);
+        default:
+            return REPACK_UNSUPPORTED;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account for an item received in bulk being complete, along with the definite length arrays it
+ * completes.  Once a top-level item is complete, the next step of the repack plan is expected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompletePlannedItem
+(
+    StreamState_t* streamStatePtr  ///< [IN] Pointer to the Stream State-Machine data
+)
+{
+    while (streamStatePtr->nestingDepth > 0)
+    {
+        uint32_t* itemsLeftPtr = &streamStatePtr->nestedItemsLeft[streamStatePtr->nestingDepth - 1];
+        if (*itemsLeftPtr == UINT32_MAX)
+        {
+            // Indefinite length arrays are only complete once their break is received.
+            return;
+        }
+        (*itemsLeftPtr)--;
+        if (*itemsLeftPtr > 0)
+        {
+            return;
+        }
+        streamStatePtr->nestingDepth--;
+    }
+    streamStatePtr->planStep++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a collection in an item received in bulk.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_UNSUPPORTED if collections are nested too deep to be received in bulk.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t OpenPlannedCollection
+(
+    StreamState_t* streamStatePtr, ///< [IN] Pointer to the Stream State-Machine data
+    uint32_t itemCount             ///< [IN] Number of items (UINT32_MAX if indefinite)
+)
+{
+    if (streamStatePtr->nestingDepth == RPC_PROXY_RECV_NESTING_MAX)
+    {
+        return LE_UNSUPPORTED;
+    }
+    streamStatePtr->nestedItemsLeft[streamStatePtr->nestingDepth++] = itemCount;
+    if (itemCount == UINT32_MAX)
+    {
+        streamStatePtr->collectionsLayer++;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Repack, in place, an item of an IPC message body received in bulk.
+ *
+ * The item has been received straight into the IPC message buffer, where it is left as is unless
+ * it needs to be remapped.  A semantic tag and the item it applies to are repacked together, and
+ * string bodies are repacked as they are received.
+ *
+ * @return
+ *      - LE_OK if the item has been repacked.
+ *      - LE_IN_PROGRESS if more bytes are needed to repack the item.
+ *      - LE_UNSUPPORTED if the item must be received item by item.  Nothing has been repacked.
+ *      - Otherwise an error has happened.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RepackPlannedItem
+(
+    StreamState_t* streamStatePtr, ///< [IN] Pointer to the Stream State-Machine data
+    void* proxyMessagePtr,         ///< [IN] Pointer to the Proxy Message
+    uint8_t** itemPtrPtr,          ///< [IN/OUT] Start of the item, moved past the part repacked
+    uint8_t** endPtrPtr,           ///< [IN/OUT] End of the bytes received in the IPC message
+                                   ///<         buffer, moved if the item changes size
+    const uint8_t* limitPtr,       ///< [IN] End of the IPC message buffer
+    size_t* neededSizePtr          ///< [OUT] Number of bytes missing to repack the item
+)
+{
+    uint8_t* itemPtr = *itemPtrPtr;
+    size_t receivedSize = *endPtrPtr - itemPtr;
+
+    if (streamStatePtr->itemSizeLeft > 0)
+    {
+        // Body of a string: already in place.
+        size_t bodySize = ((receivedSize < streamStatePtr->itemSizeLeft) ?
+                           receivedSize : streamStatePtr->itemSizeLeft);
+        streamStatePtr->itemSizeLeft -= bodySize;
+        *itemPtrPtr += bodySize;
+        if (streamStatePtr->itemSizeLeft > 0)
+        {
+            *neededSizePtr = streamStatePtr->itemSizeLeft;
+            return LE_IN_PROGRESS;
+        }
+        CompletePlannedItem(streamStatePtr);
+        return LE_OK;
+    }
+
+    if (receivedSize < 1)
+    {
+        *neededSizePtr = 1;
+        return LE_IN_PROGRESS;
+    }
+
+    // Semantic tag, if any, and header of the item.
+    uint8_t* headerPtr = itemPtr;
+    le_pack_SemanticTag_t tag = 0;
+    ssize_t additionalBytes;
+    le_cbor_Type_t itemType = le_cbor_GetType(headerPtr, &additionalBytes);
+    if (itemType == LE_CBOR_TYPE_TAG)
+    {
+        if ((additionalBytes < 0) || (additionalBytes > (ssize_t)sizeof(le_pack_SemanticTag_t)))
+        {
+            return LE_UNSUPPORTED;
+        }
+        if (receivedSize < (size_t)additionalBytes + 2)
+        {
+            *neededSizePtr = additionalBytes + 2 - receivedSize;
+            return LE_IN_PROGRESS;
+        }
+        if (!le_pack_UnpackSemanticTag(&headerPtr, &tag))
+        {
+            return LE_UNSUPPORTED;
+        }
+        itemType = le_cbor_GetType(headerPtr, &additionalBytes);
+    }
+    size_t headerSize = 1 + ((additionalBytes > 0) ? additionalBytes : 0);
+    size_t unitSize = (headerPtr - itemPtr) + headerSize;
+    if (receivedSize < unitSize)
+    {
+        *neededSizePtr = unitSize - receivedSize;
+        return LE_IN_PROGRESS;
+    }
+
+    if ((streamStatePtr->nestingDepth == 0) && (itemType == LE_CBOR_TYPE_INDEF_END) && (tag == 0))
+    {
+        // End of the message body.
+        streamStatePtr->collectionsLayer = 0;
+        *itemPtrPtr += unitSize;
+        return LE_OK;
+    }
+
+    // Top-level items follow the repack plan, or are recorded into it.
+    RepackPlan_t* planPtr = streamStatePtr->planPtr;
+    bool isPlanStep = (streamStatePtr->nestingDepth == 0);
+    unsigned int step = streamStatePtr->planStep;
+    uint8_t stepType = ((itemType == LE_CBOR_TYPE_NEG_INTEGER) ?
+                        LE_CBOR_TYPE_POS_INTEGER : itemType);
+    RepackAction_t action;
+    if (isPlanStep && (planPtr->status == REPACK_PLAN_READY))
+    {
+        if ((step >= planPtr->stepCount) ||
+            (planPtr->steps[step].itemType != stepType) ||
+            (planPtr->steps[step].tag != tag))
+        {
+            LE_DEBUG("Message does not follow its repack plan at step %u", step);
+            return LE_UNSUPPORTED;
+        }
+        action = planPtr->steps[step].action;
+    }
+    else if (isPlanStep && (step >= RPC_PROXY_REPACK_PLAN_MAX_STEPS))
+    {
+        return LE_UNSUPPORTED;
+    }
+    else
+    {
+        action = GetRepackAction(streamStatePtr, itemType, tag);
+    }
+    if ((additionalBytes < 0) && (action != REPACK_ARRAY) && (action != REPACK_BREAK))
+    {
+        // Indefinite length strings are not expected.
+        return LE_UNSUPPORTED;
+    }
+
+    // Value of the item, for references and sizes.
+    uint32_t value = 0;
+    if ((action == REPACK_UINT32) || (action == REPACK_REFERENCE) || (action == REPACK_CONTEXT))
+    {
+        uint8_t* valuePtr = headerPtr;
+        if (!le_pack_UnpackUint32(&valuePtr, &value))
+        {
+            return LE_UNSUPPORTED;
+        }
+    }
+
+    switch (action)
+    {
+        case REPACK_COPY:
+        case REPACK_UINT32:
+            CompletePlannedItem(streamStatePtr);
+            break;
+
+        case REPACK_REFERENCE:
+            // Only safe references can be repacked.
+            if (((value & 0x01) == 0) && (value != 0))
+            {
+                return LE_UNSUPPORTED;
+            }
+            CompletePlannedItem(streamStatePtr);
+            break;
+
+        case REPACK_CONTEXT:
+        {
+            uint8_t repacked[LE_PACK_SEMANTIC_TAG_MAX_SIZE + LE_PACK_UINT32_MAX_SIZE];
+            uint8_t* repackedEndPtr = repacked;
+            void* newRef = NULL;
+
+            // Make sure the remapped reference fits before remapping it.
+            if ((size_t)(limitPtr - *endPtrPtr) < sizeof(repacked) - unitSize)
+            {
+                return LE_UNSUPPORTED;
+            }
+            LE_DEBUG("Handling an event reference value:%"PRIu32", Tag: %"PRIu16"", value, tag);
+            le_result_t ret = rpcEventHandler_RepackIncomingContext(tag, (void*)(uintptr_t)value,
+                                                                    &newRef, proxyMessagePtr);
+            if (ret != LE_OK)
+            {
+                return ret;
+            }
+            if (!le_pack_PackTaggedReference(&repackedEndPtr, newRef, tag))
+            {
+                return LE_FAULT;
+            }
+            size_t repackedSize = repackedEndPtr - repacked;
+            memmove(itemPtr + repackedSize, itemPtr + unitSize,
+                    *endPtrPtr - (itemPtr + unitSize));
+            memcpy(itemPtr, repacked, repackedSize);
+            *endPtrPtr = *endPtrPtr + repackedSize - unitSize;
+            unitSize = repackedSize;
+            CompletePlannedItem(streamStatePtr);
+            break;
+        }
+
+        case REPACK_STRING:
+        {
+            size_t length;
+            uint8_t* lengthPtr = headerPtr;
+            if (((itemType == LE_CBOR_TYPE_TEXT_STRING) &&
+                 !le_pack_UnpackStringHeader(&lengthPtr, &length)) ||
+                ((itemType == LE_CBOR_TYPE_BYTE_STRING) &&
+                 !le_pack_UnpackByteStringHeader(&lengthPtr, &length)))
+            {
+                return LE_UNSUPPORTED;
+            }
+            if (length > (size_t)(limitPtr - (itemPtr + unitSize)))
+            {
+                LE_ERROR("String of size %" PRIuS " does not fit in the IPC message", length);
+                return LE_NO_MEMORY;
+            }
+            streamStatePtr->itemSizeLeft = length;
+            if (length == 0)
+            {
+                CompletePlannedItem(streamStatePtr);
+            }
+            break;
+        }
+
+        case REPACK_ARRAY:
+        {
+            size_t itemCount = UINT32_MAX;
+            uint8_t* countPtr = headerPtr;
+            if ((additionalBytes >= 0) &&
+                !le_pack_UnpackArrayHeader(&countPtr, (void*)1, 0, &itemCount, UINT32_MAX - 1))
+            {
+                return LE_UNSUPPORTED;
+            }
+            if (itemCount == 0)
+            {
+                CompletePlannedItem(streamStatePtr);
+            }
+            else if (OpenPlannedCollection(streamStatePtr, itemCount) != LE_OK)
+            {
+                return LE_UNSUPPORTED;
+            }
+            break;
+        }
+
+        case REPACK_BREAK:
+            if (streamStatePtr->nestedItemsLeft[streamStatePtr->nestingDepth - 1] != UINT32_MAX)
+            {
+                return LE_UNSUPPORTED;
+            }
+            streamStatePtr->nestingDepth--;
+            streamStatePtr->collectionsLayer--;
+            CompletePlannedItem(streamStatePtr);
+            break;
+
+        default:
+            return LE_UNSUPPORTED;
+    }
+
+    if (isPlanStep && (planPtr->status == REPACK_PLAN_RECORDING))
+    {
+        planPtr->steps[step].itemType = stepType;
+        planPtr->steps[step].action = action;
+        planPtr->steps[step].tag = tag;
+    }
+    *itemPtrPtr += unitSize;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start receiving an IPC message body in bulk, if its message ID has a repack plan, or if one can
+ * be recorded for it.
+ *
+ * @return
+ *      - LE_OK if the body is to be received in bulk.
+ *      - LE_UNSUPPORTED if it is to be received item by item.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartPlannedBody
+(
+    StreamState_t* streamStatePtr, ///< [IN] Pointer to the Stream State-Machine data
+    void* proxyMessagePtr,         ///< [IN] Pointer to the Proxy Message
+    uint32_t id,                   ///< [IN] IPC message ID
+    uint8_t arrayHeader            ///< [IN] First byte of the body, read ahead with the ID
+)
+{
+    rpcProxy_CommonHeader_t* commonHeaderPtr = (rpcProxy_CommonHeader_t*) proxyMessagePtr;
+    ssize_t additionalBytes;
+
+    if ((le_cbor_GetType(&arrayHeader, &additionalBytes) != LE_CBOR_TYPE_ITEM_ARRAY) ||
+        (additionalBytes >= 0))
+    {
+        return LE_UNSUPPORTED;
+    }
+
+    RepackPlanKey_t key =
+    {
+        .serviceId = commonHeaderPtr->serviceId,
+        .msgId = id,
+        .type = commonHeaderPtr->type
+    };
+    RepackPlan_t* planPtr = le_hashmap_Get(RepackPlanByMsgId, &key);
+    if (planPtr == NULL)
+    {
+        planPtr = le_mem_TryAlloc(RepackPlanPoolRef);
+        if (planPtr == NULL)
+        {
+            // No more plans, the remaining message IDs are received item by item.
+            return LE_UNSUPPORTED;
+        }
+        memset(planPtr, 0, sizeof(RepackPlan_t));
+        planPtr->key = key;
+        planPtr->status = REPACK_PLAN_RECORDING;
+        le_hashmap_Put(RepackPlanByMsgId, &planPtr->key, planPtr);
+    }
+    if (planPtr->status == REPACK_PLAN_NONE)
+    {
+        return LE_UNSUPPORTED;
+    }
+    // A plan still being recorded here was abandoned along with its message (e.g. on a network
+    // error): it is recorded again from this message.
+
+    uint8_t* payloadPtr = le_msg_GetPayloadPtr(streamStatePtr->msgRef);
+    payloadPtr[IPC_MSG_ID_SIZE] = arrayHeader;
+    streamStatePtr->ipcMsgPayloadOffset = IPC_MSG_ID_SIZE + LE_PACK_INDEF_ARRAY_HEADER_MAX_SIZE;
+    streamStatePtr->collectionsLayer = 1;
+    streamStatePtr->planPtr = planPtr;
+    streamStatePtr->planStep = 0;
+    streamStatePtr->itemSizeLeft = 0;
+    streamStatePtr->nestingDepth = 0;
+    streamStatePtr->state = STREAM_PLANNED_BODY;
+    streamStatePtr->expectedSize = 0;
+    streamStatePtr->readAhead = false;
+    streamStatePtr->destBuff = NULL;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive an IPC message body in bulk.
+ *
+ * The body is received straight into the IPC message buffer, in as few reads as possible, and
+ * repacked in place following the repack plan of its message ID.  Each read asks for the bytes
+ * known to be missing plus up to @c RPC_PROXY_RECV_BULK_EXTRA_SIZE more; bytes received past the
+ * end of the message are kept for the next one.
+ *
+ * As soon as an item does not follow the plan, or cannot be repacked in place, the rest of the
+ * body is handed over to the item by item receive, starting with that item.
+ *
+ * @return:
+ *      - LE_OK when the body is received, or handed over to the item by item receive.
+ *      - LE_IN_PROGRESS when more bytes are to be received.
+ *      - Otherwise an error has happened.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RecvPlannedBody
+(
+    void* handle,                   ///< [IN] Opaque handle to the le_comm communication channel
+    StreamState_t* streamStatePtr,  ///< [IN] Pointer to the Stream State-Machine data
+    void* proxyMessagePtr           ///< [IN] Pointer to the Proxy Message
+)
+{
+    NetworkMessageState_t* msgStatePtr = CONTAINER_OF(streamStatePtr, NetworkMessageState_t,
+                                                      streamState);
+    RepackPlan_t* planPtr = streamStatePtr->planPtr;
+    uint8_t* payloadPtr = le_msg_GetPayloadPtr(streamStatePtr->msgRef);
+    const uint8_t* limitPtr = payloadPtr + le_msg_GetMaxPayloadSize(streamStatePtr->msgRef);
+    uint8_t* itemPtr = payloadPtr + streamStatePtr->ipcMsgPayloadOffset;
+    uint8_t* endPtr = itemPtr + streamStatePtr->recvSize;
+    bool isDrained = false;
+    le_result_t ret;
+
+    while (true)
+    {
+        size_t neededSize = 0;
+        ret = RepackPlannedItem(streamStatePtr, proxyMessagePtr, &itemPtr, &endPtr, limitPtr,
+                                &neededSize);
+        if (ret == LE_OK)
+        {
+            if (streamStatePtr->collectionsLayer == 0)
+            {
+                break;
+            }
+            continue;
+        }
+        else if ((ret != LE_IN_PROGRESS) || isDrained)
+        {
+            break;
+        }
+        else if (neededSize > (size_t)(limitPtr - endPtr))
+        {
+            // The item does not fit: let the item by item receive report it, unless it is a
+            // string already partly received.
+            ret = ((streamStatePtr->itemSizeLeft > 0) ? LE_NO_MEMORY : LE_UNSUPPORTED);
+            break;
+        }
+
+        size_t requestedSize = neededSize + RPC_PROXY_RECV_BULK_EXTRA_SIZE;
+        if (requestedSize > (size_t)(limitPtr - endPtr))
+        {
+            requestedSize = limitPtr - endPtr;
+        }
+        size_t receivedSize = requestedSize;
+        bool readsChannel = (msgStatePtr->pendingSize < neededSize);
+        ret = rpcProxy_RecvBytes(handle, msgStatePtr, endPtr, &receivedSize, neededSize);
+#if RPC_PROXY_HEX_DUMP
+        if (ret == LE_OK)
+        {
+            LE_INFO("Requested:%"PRIuS" bytes, Received:%"PRIuS"", requestedSize, receivedSize);
+            LE_LOG_DUMP(LE_LOG_INFO, endPtr, receivedSize);
+        }
+#endif
+        if (ret != LE_OK)
+        {
+            break;
+        }
+        endPtr += receivedSize;
+        // A short read means nothing more has been received for now.
+        isDrained = (readsChannel && (receivedSize < requestedSize));
+    }
+
+    streamStatePtr->ipcMsgPayloadOffset = itemPtr - payloadPtr;
+    streamStatePtr->recvSize = endPtr - itemPtr;
+    if (ret == LE_OK)
+    {
+        // Whole body received: keep what follows for the next message.
+        ret = KeepPendingBytes(msgStatePtr, itemPtr, endPtr - itemPtr);
+        if (planPtr->status == REPACK_PLAN_RECORDING)
+        {
+            planPtr->stepCount = streamStatePtr->planStep;
+            planPtr->status = REPACK_PLAN_READY;
+        }
+        GoToDoneState(streamStatePtr);
+    }
+    else if (ret == LE_UNSUPPORTED)
+    {
+        // Hand the rest of the body over to the item by item receive, which receives again the
+        // bytes received from the current item on.
+        LE_DEBUG("Receiving the rest of the message item by item from offset %" PRIuS,
+                 streamStatePtr->ipcMsgPayloadOffset);
+        ret = KeepPendingBytes(msgStatePtr, itemPtr, endPtr - itemPtr);
+        if (planPtr->status == REPACK_PLAN_RECORDING)
+        {
+            planPtr->status = REPACK_PLAN_NONE;
+        }
+        streamStatePtr->planPtr = NULL;
+        streamStatePtr->recvSize = 0;
+        streamStatePtr->msgBuffSizeLeft = limitPtr - itemPtr;
+        GoToCborHeaderState(streamStatePtr);
+    }
+    return ret;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Finish The stream
@@ -2850,14 +3704,28 @@ le_result_t rpcProxy_RecvStream
 )
 {
     le_result_t ret = LE_OK;
+    NetworkMessageState_t* msgStatePtr = CONTAINER_OF(streamStatePtr, NetworkMessageState_t,
+                                                      streamState);
     void* msgBufPtr = GetIpcMsgBufPtr(streamStatePtr);
     while(streamStatePtr->state != STREAM_DONE && ret == LE_OK)
     {
         LE_DEBUG("RecvStream State: %d", streamStatePtr->state);
 
+        if (streamStatePtr->state == STREAM_PLANNED_BODY)
+        {
+            ret = RecvPlannedBody(handle, streamStatePtr, proxyMessagePtr);
+            msgBufPtr = GetIpcMsgBufPtr(streamStatePtr);
+            continue;
+        }
+
         size_t remainingData = streamStatePtr->expectedSize - streamStatePtr->recvSize;
         size_t receivedSize = remainingData;
-        le_result_t result = le_comm_Receive(handle, streamStatePtr->destBuff, &receivedSize);
+        le_result_t result = LE_OK;
+        if (remainingData > 0)
+        {
+            result = rpcProxy_RecvBytes(handle, msgStatePtr, streamStatePtr->destBuff,
+                                        &receivedSize, remainingData);
+        }
 #if RPC_PROXY_HEX_DUMP
         if (result == LE_OK)
         {
@@ -2897,6 +3765,17 @@ le_result_t rpcProxy_RecvStream
         }
 
         uint8_t* workBuff = (uint8_t*)streamStatePtr->workBuff;
+
+        // If the first byte of the next state has been received along with this state's data, it
+        // is the last byte received.  Keep it aside as handling this state may overwrite it.
+        bool hasNextByte = (streamStatePtr->readAhead && receivedSize > 0);
+        size_t readAheadSize = (streamStatePtr->readAhead ? 1 : 0);
+        uint8_t nextByte = 0;
+        if (hasNextByte)
+        {
+            nextByte = ((uint8_t*)streamStatePtr->destBuff)[receivedSize - 1];
+        }
+
         if (streamStatePtr->state == STREAM_CONSTANT_LENGTH_MSG)
         {
             GoToDoneState(streamStatePtr);
@@ -2918,6 +3797,12 @@ le_result_t rpcProxy_RecvStream
                 streamStatePtr->msgBuffSizeLeft -= IPC_MSG_ID_SIZE;
                 GoToCborHeaderState(streamStatePtr);
                 PrintIpcMessageInfo(proxyMessagePtr, id);
+                if (hasNextByte &&
+                    (StartPlannedBody(streamStatePtr, proxyMessagePtr, id, nextByte) == LE_OK))
+                {
+                    // The array header read ahead opens the body received in bulk.
+                    hasNextByte = false;
+                }
             }
         }
         else if (streamStatePtr->state == STREAM_ASYNC_EVENT_INIT)
@@ -2928,9 +3813,11 @@ le_result_t rpcProxy_RecvStream
         {
             if (msgBufPtr == streamStatePtr->destBuff)
             {
-                // Were we just writing directly to ipc message buffer? if yes, move that forward.
-                msgBufPtr += streamStatePtr->expectedSize;
-                streamStatePtr->msgBuffSizeLeft -= streamStatePtr->expectedSize;
+                // Were we just writing directly to ipc message buffer? if yes, move that forward
+                // past the part of the body received by this call (partially received data has
+                // already been accounted for).
+                msgBufPtr += receivedSize - readAheadSize;
+                streamStatePtr->msgBuffSizeLeft -= streamStatePtr->expectedSize - readAheadSize;
             }
             GoToCborHeaderState(streamStatePtr);
         }
@@ -2956,6 +3843,26 @@ le_result_t rpcProxy_RecvStream
             }
         }
         streamStatePtr->recvSize = 0;
+
+        if (hasNextByte && ret == LE_OK)
+        {
+            if (streamStatePtr->state == STREAM_DONE || streamStatePtr->expectedSize == 0)
+            {
+                LE_ERROR("Received a byte past the end of the stream");
+                ret = LE_FORMAT_ERROR;
+            }
+            else
+            {
+                // The next state starts with one byte already received.
+                *(uint8_t*)streamStatePtr->destBuff = nextByte;
+                if (streamStatePtr->destBuff == msgBufPtr)
+                {
+                    msgBufPtr++;
+                }
+                streamStatePtr->destBuff++;
+                streamStatePtr->recvSize = 1;
+            }
+        }
 #if RPC_PROXY_HEX_DUMP
         //print current state of ipc message buffer:
         if (streamStatePtr->msgRef)
@@ -487,8 +487,20 @@
  * For example, the keyword "P/T/events" controls logging for a thread named "T" running inside
  * a process named "P".
  *
- * @todo Add a reference to the Process Inspector and its capabilities for inspecting Event Queues,
- * Event Loops, Handlers and Event Report statistics.
+ * @subsection c_event_profiling Profiling
+ *
+ * When the framework is built with event loop profiling support, a thread can call
+ * @c le_event_EnableProfiling() to have its Event Loop account the run-time of every handler it
+ * runs (event handlers, queued functions, fd monitor handlers and timer expiry handlers), the time
+ * Event Reports wait in its Event Queue and the depth of its Event Queue.  Handlers that run for
+ * longer than a given threshold are reported in the logs.  Setting the environment variable
+ * @c LE_EVENT_PROFILE to a threshold in milliseconds profiles all the threads of a process
+ * without code changes (@c LE_EVENT_PROFILE=0 profiles without slow handler warnings).
+ *
+ * The statistics can be viewed while the process runs using <c>inspect events PID</c>.
+ *
+ * @todo Add a reference to the Process Inspector and its capabilities for inspecting Event Queues
+ * and Handlers.
 
  * <HR>
  *
@@ -1039,6 +1051,23 @@ void le_event_RunLoop
 __attribute__ ((noreturn));
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables profiling of the calling thread's Event Loop (see @ref c_event_profiling).  Calling it
+ * again only changes the slow handler threshold.
+ *
+ * @return
+ *  - LE_OK if profiling is enabled.
+ *  - LE_NOT_IMPLEMENTED if the framework was built without event loop profiling support.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_event_EnableProfiling
+(
+    uint32_t slowThresholdMs    ///< [in] Handlers running for longer than this are reported in
+                                ///       the logs (0 = no reports).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches a file descriptor that will appear readable to poll(), select(), epoll_wait(), etc.
@@ -70,6 +70,10 @@
  * that currently exist inside a given process.  The state of each mutex can be
  * seen, including a list of any threads that might be waiting for that mutex.
  *
+ * On Linux, each mutex also counts how many times it was acquired and how many of those
+ * acquisitions had to wait for another thread to release it, along with the time spent waiting.
+ * Run <c>inspect mutexes --stats</c> to find the locks that threads are contending on.
+ *
  * <HR>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -917,6 +917,26 @@ LE_DECLARE_INLINE bool le_pack_PackTaggedOnOff
 
 #undef LE_PACK_PACK_SIMPLE_VALUE
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a reference can be passed through an API.
+ *
+ * All references passed through an API must be safe references (or NULL), so 0-bit will be set
+ * and reference will be <= UINT32_MAX.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_DECLARE_INLINE bool le_pack_IsSafeReference
+(
+    const void* ref
+)
+{
+    size_t refAsInt = (size_t)ref;
+
+    return ((refAsInt <= UINT32_MAX) &&
+            ((refAsInt & 0x01) ||
+             !refAsInt));
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pack a reference into a buffer, incrementing the buffer pointer.
@@ -930,12 +950,8 @@ LE_DECLARE_INLINE bool le_pack_PackReference
 {
     size_t refAsInt = (size_t)ref;
 
-    //  All references passed through an API must be safe references (or NULL), so
-    // 0-bit will be set and reference will be <= UINT32_MAX.  Size check
-    // is performed in pack function.
-    if ((refAsInt <= UINT32_MAX) &&
-        ((refAsInt & 0x01) ||
-         !refAsInt))
+    // Size check is performed in pack function.
+    if (le_pack_IsSafeReference(ref))
     {
 #ifdef LE_CONFIG_RPC
         return le_pack_PackTaggedUint32(bufferPtr, (uint32_t)refAsInt, LE_PACK_REFERENCE);
@@ -263,6 +263,8 @@ static bool DecodePositiveInteger
         {
             int length = (additional == _LE_CBOR_COMPLEX_THRESHOLD)?1:
                 2 << (additional-_LE_CBOR_COMPLEX_THRESHOLD-1);
+            // Only the low order bytes are received, clear the others
+            *valuePtr = 0;
             LE_CBOR_UNPACK_SIMPLE_BUFFER(((uint8_t*)valuePtr) + sizeof(uint64_t)-length, length);
             *valuePtr = be64toh(*valuePtr);
         }
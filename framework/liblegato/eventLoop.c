@@ -67,6 +67,7 @@
 #include "legato.h"
 
 #include "eventLoop.h"
+#include "eventProfile.h"
 #include "fdMonitor.h"
 #include "limit.h"
 #include "thread.h"
@@ -277,6 +278,9 @@ typedef struct
 {
     le_sls_Link_t           link;       ///< Used to link onto an Event Queue.
     EventReportType_t       type;       ///< Indicates what type of event report this is.
+#if LE_CONFIG_EVENT_PROFILING
+    uint64_t                queuedUs;   ///< Time the report was queued (0 if not profiled).
+#endif
 }
 Report_t;
 
@@ -559,12 +563,19 @@ void event_ProcessOneEventReport
     le_sls_Link_t* linkPtr;
     Report_t* reportObjPtr;
     Handler_t* handlerPtr;
+    size_t queueDepth;
 
     int oldState = event_Lock();
 
     // Pop an Event Report off the head of the Event Queue (inside a critical section).
     linkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue);
 
+    queueDepth = perThreadRecPtr->queueDepth;
+    if (linkPtr != NULL)
+    {
+        perThreadRecPtr->queueDepth--;
+    }
+
     event_Unlock(oldState);
 
     if (linkPtr == NULL)
@@ -575,6 +586,16 @@ void event_ProcessOneEventReport
     // Convert the link pointer into a pointer to the Report base class.
     reportObjPtr = CONTAINER_OF(linkPtr, Report_t, link);
 
+#if LE_CONFIG_EVENT_PROFILING
+    eventProf_ThreadRec_t* profileRecPtr = eventProf_GetThreadRec(perThreadRecPtr);
+    if (profileRecPtr != NULL)
+    {
+        eventProf_RecordDispatch(profileRecPtr, reportObjPtr->queuedUs, queueDepth);
+    }
+#else
+    LE_UNUSED(queueDepth);
+#endif
+
     // Hold on to the current event to release it in destructor in case thread is terminated
     // before event processing finishes.
     perThreadRecPtr->currentEvent = reportObjPtr;
@@ -587,8 +608,21 @@ void event_ProcessOneEventReport
         queuedFuncReportPtr = CONTAINER_OF(reportObjPtr, QueuedFunctionReport_t, baseClass);
 
         // Call the function.
-        queuedFuncReportPtr->function(queuedFuncReportPtr->param1Ptr,
-                                      queuedFuncReportPtr->param2Ptr);
+#if LE_CONFIG_EVENT_PROFILING
+        if (profileRecPtr != NULL)
+        {
+            eventProf_BeginHandler(profileRecPtr);
+            queuedFuncReportPtr->function(queuedFuncReportPtr->param1Ptr,
+                                          queuedFuncReportPtr->param2Ptr);
+            eventProf_EndHandler(profileRecPtr, EVENT_PROF_TYPE_QUEUED_FUNC,
+                                 (const void*)queuedFuncReportPtr->function, NULL, queueDepth);
+        }
+        else
+#endif
+        {
+            queuedFuncReportPtr->function(queuedFuncReportPtr->param1Ptr,
+                                          queuedFuncReportPtr->param2Ptr);
+        }
 
     }
     // If it's a publish-subscribe event report,
@@ -636,10 +670,34 @@ void event_ProcessOneEventReport
                 reportPtr = pubSubReportPtr->payload;
             }
 
+#if LE_CONFIG_EVENT_PROFILING
+            // The handler can be deleted as soon as the mutex is unlocked, so keep a copy of its
+            // name.  Handlers are profiled by their client function when they have one.
+            char handlerName[LIMIT_MAX_EVENT_HANDLER_NAME_BYTES] = "";
+            const void* handlerKey = (secondLayerFunc != NULL) ? secondLayerFunc :
+                                                                 (const void*)firstLayerFunc;
+            if (profileRecPtr != NULL)
+            {
+                le_utf8_Copy(handlerName, EVENT_NAME(handlerPtr->name), sizeof(handlerName), NULL);
+            }
+#endif
+
             event_Unlock(oldState);  // Unlock the mutex before calling the handler function.
                                // Don't access the Handler object anymore after this.
 
-            firstLayerFunc(reportPtr, secondLayerFunc);
+#if LE_CONFIG_EVENT_PROFILING
+            if (profileRecPtr != NULL)
+            {
+                eventProf_BeginHandler(profileRecPtr);
+                firstLayerFunc(reportPtr, secondLayerFunc);
+                eventProf_EndHandler(profileRecPtr, EVENT_PROF_TYPE_EVENT,
+                                     handlerKey, handlerName, queueDepth);
+            }
+            else
+#endif
+            {
+                firstLayerFunc(reportPtr, secondLayerFunc);
+            }
         }
     }
 
@@ -651,9 +709,123 @@ void event_ProcessOneEventReport
 }
 
 
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the Queued Function Reports pushed onto a thread's lock-free queue to the tail of its
+ * Event Queue, in the order they were pushed.
+ *
+ * @warning Assumes the mutex is locked.  Must only be called by the thread that owns the queue
+ *          (or by its destructor).
+ */
+//--------------------------------------------------------------------------------------------------
+static void TransferLockFreeQueue_NoLock
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* linkPtr;
+
+    // Take the whole stack at once.  Producers only ever push, so there is no ABA problem.
+    do
+    {
+        linkPtr = perThreadRecPtr->lockFreeQueuePtr;
+    }
+    while ((linkPtr != NULL) &&
+           !LE_SYNC_BOOL_COMPARE_AND_SWAP(&perThreadRecPtr->lockFreeQueuePtr, linkPtr, NULL));
+
+    // The stack is in LIFO order; reverse it before queueing.
+    le_sls_Link_t* fifoPtr = NULL;
+    while (linkPtr != NULL)
+    {
+        le_sls_Link_t* nextPtr = linkPtr->nextPtr;
+        linkPtr->nextPtr = fifoPtr;
+        fifoPtr = linkPtr;
+        linkPtr = nextPtr;
+    }
+
+    while (fifoPtr != NULL)
+    {
+        linkPtr = fifoPtr;
+        fifoPtr = fifoPtr->nextPtr;
+
+        *linkPtr = LE_SLS_LINK_INIT;
+        le_sls_Queue(&perThreadRecPtr->eventQueue, linkPtr);
+        perThreadRecPtr->queueDepth++;
+    }
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start processing a batch of Event Reports from the calling thread's Event Queue.
+ *
+ * Acknowledges the thread's wake-up signal and takes a snapshot of the Event Queue.  Anything
+ * reported after this will signal the thread again.
+ *
+ * @return The number of Event Reports in the batch (never more than
+ *         LE_CONFIG_EVENT_REPORT_BATCH_SIZE).
+ */
+//--------------------------------------------------------------------------------------------------
+size_t event_BeginReportBatch
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Acknowledge the wake-up before looking at the queue, so that nothing queued from now on
+    // can be missed.
+    fa_event_WaitForEvent(perThreadRecPtr);
+
+    int oldState = event_Lock();
+
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+    TransferLockFreeQueue_NoLock(perThreadRecPtr);
+#endif
+
+    size_t numReports = perThreadRecPtr->queueDepth;
+
+    event_Unlock(oldState);
+
+    if (numReports > LE_CONFIG_EVENT_REPORT_BATCH_SIZE)
+    {
+        numReports = LE_CONFIG_EVENT_REPORT_BATCH_SIZE;
+    }
+
+    return numReports;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish processing a batch of Event Reports started by event_BeginReportBatch().
+ *
+ * If Event Reports were left on the queue, signal the thread again so that its Event Loop comes
+ * back for them after it has checked the other file descriptors.
+ */
+//--------------------------------------------------------------------------------------------------
+void event_EndReportBatch
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int oldState = event_Lock();
+
+    if (perThreadRecPtr->queueDepth > 0)
+    {
+        fa_event_TriggerEvent_NoLock(perThreadRecPtr);
+    }
+
+    event_Unlock(oldState);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Process Event Reports from the calling thread's Event Queue until the queue is empty.
+ * Process a batch of Event Reports from the calling thread's Event Queue.
  */
 //--------------------------------------------------------------------------------------------------
 void event_ProcessEventReports
@@ -662,18 +834,18 @@ void event_ProcessEventReports
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Read the eventfd to fetch the number of Reports on the Event Queue and reset the count
-    // to zero.
-    uint64_t numReports = fa_event_WaitForEvent(perThreadRecPtr);
-
-    // Process only those event reports that are already on the queue.  Anything reported by the
-    // event handlers will have to wait until next time ProcessEventReports() is called.
-    // This approach ensures that event handlers that re-queue events to the event
-    // queue don't cause fd events to be starved.
+    size_t numReports = event_BeginReportBatch(perThreadRecPtr);
+
+    // Process only those event reports that are already on the queue, and no more than one batch
+    // of them.  Anything reported by the event handlers will have to wait until next time
+    // ProcessEventReports() is called.  This approach ensures that event handlers that re-queue
+    // events to the event queue, or a busy producer thread, don't cause fd events to be starved.
     for (; numReports > 0; numReports--)
     {
         event_ProcessOneEventReport(perThreadRecPtr);
     }
+
+    event_EndReportBatch(perThreadRecPtr);
 }
 
 
@@ -701,6 +873,34 @@ static void PubSubHandlerFunc
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue an Event Report onto a specific thread's Event Queue and wake up that thread.
+ *
+ * @warning Assumes the mutex is locked and the thread is protected from cancellation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueReport_NoLock
+(
+    event_PerThreadRec_t*   perThreadRecPtr, ///< [in] Pointer to the thread's event data record.
+    Report_t*               reportPtr        ///< [in] The report to queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+#if LE_CONFIG_EVENT_PROFILING
+    // Only timestamp the reports for the threads that are profiled.
+    reportPtr->queuedUs = (perThreadRecPtr->profileRecPtr != NULL) ? eventProf_GetTimeUs() : 0;
+#endif
+
+    le_sls_Queue(&perThreadRecPtr->eventQueue, &reportPtr->link);
+    perThreadRecPtr->queueDepth++;
+
+    // Notify the Event Loop that there is something on the queue.  Wake-ups are coalesced: this
+    // only signals the thread if it hasn't been signalled since it last looked at its queue.
+    fa_event_TriggerEvent_NoLock(perThreadRecPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Queue a function onto a specific thread's Event Queue (could belong to the calling thread or
@@ -729,11 +929,67 @@ static void QueueFunction_NoLock
     reportPtr->param2Ptr = param2Ptr;
 
     // Queue it to the Event Queue.
-    le_sls_Queue(&perThreadRecPtr->eventQueue, &reportPtr->baseClass.link);
+    QueueReport_NoLock(perThreadRecPtr, &reportPtr->baseClass);
+}
+
+
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a function onto a specific thread's lock-free queue (could belong to the calling thread
+ * or could belong to some other thread), without locking the mutex.
+ *
+ * The thread moves the functions to its Event Queue when it starts its next batch of Event
+ * Reports.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueFunctionLockFree
+(
+    event_PerThreadRec_t*   perThreadRecPtr, ///< [in] Pointer to the thread's event data record.
+    le_event_DeferredFunc_t func,       ///< [in] The function to be called later.
+    void*                   param1Ptr,  ///< [in] Value to be passed to the function when called.
+    void*                   param2Ptr   ///< [in] Value to be passed to the function when called.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int oldState;
+    int junk;
+
+    // Don't get cancelled while holding a report that isn't queued yet.
+    int err = pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldState);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", LE_ERRNO_TXT(err));
+
+    // Allocate a Queued Function Report object.
+    QueuedFunctionReport_t* reportPtr = le_mem_Alloc(ReportPoolRef);
+
+    // Initialize it.
+    reportPtr->baseClass.type = LE_EVENT_REPORT_QUEUED_FUNC;
+    reportPtr->function = func;
+    reportPtr->param1Ptr = param1Ptr;
+    reportPtr->param2Ptr = param2Ptr;
+#if LE_CONFIG_EVENT_PROFILING
+    reportPtr->baseClass.queuedUs = (perThreadRecPtr->profileRecPtr != NULL) ?
+                                    eventProf_GetTimeUs() : 0;
+#endif
+
+    // Push it onto the lock-free stack.
+    le_sls_Link_t* headPtr;
+    do
+    {
+        headPtr = perThreadRecPtr->lockFreeQueuePtr;
+        reportPtr->baseClass.link.nextPtr = headPtr;
+    }
+    while (!LE_SYNC_BOOL_COMPARE_AND_SWAP(&perThreadRecPtr->lockFreeQueuePtr,
+                                          headPtr,
+                                          &reportPtr->baseClass.link));
 
-    // Write to the eventfd to notify the Event Loop that there is something on the queue.
+    // Wake up the thread, unless it has already been signalled.
     fa_event_TriggerEvent_NoLock(perThreadRecPtr);
+
+    err = pthread_setcancelstate(oldState, &junk);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", LE_ERRNO_TXT(err));
 }
+#endif
 
 
 //--------------------------------------------------------------------------------------------------
@@ -798,6 +1054,11 @@ void event_Init
     // Perform OS-specific initialization
     fa_event_Init();
 
+#if LE_CONFIG_EVENT_PROFILING
+    // Initialize the profiling module; this checks if the whole process is to be profiled.
+    eventProf_Init();
+#endif
+
     // Initialize the FD Monitor module.
     fdMon_Init();
 }
@@ -841,6 +1102,14 @@ event_PerThreadRec_t* event_CreatePerThreadInfo
     // Initialize the current event member:
     recPtr->currentEvent = NULL;
 
+    recPtr->queueDepth = 0;
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+    recPtr->lockFreeQueuePtr = NULL;
+#endif
+#if LE_CONFIG_EVENT_PROFILING
+    recPtr->profileRecPtr = NULL;
+#endif
+
     // Take note of the fact that the Event Loop for this thread has been initialized, but
     // not started.
     recPtr->state = LE_EVENT_LOOP_INITIALIZED;
@@ -921,6 +1190,12 @@ void event_DestructThread
     // Delete all the FD Monitors for this thread.
     fdMon_DestructThread(perThreadRecPtr);
 
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+    oldState = event_Lock();
+    TransferLockFreeQueue_NoLock(perThreadRecPtr);
+    event_Unlock(oldState);
+#endif
+
     // Discard everything on the Event Queue.
     while (NULL != (singleLinkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue)))
     {
@@ -938,6 +1213,11 @@ void event_DestructThread
 
         le_mem_Release(reportPtr);
     }
+    perThreadRecPtr->queueDepth = 0;
+
+#if LE_CONFIG_EVENT_PROFILING
+    eventProf_DestructThread(perThreadRecPtr);
+#endif
 
     fa_event_DestructThread(perThreadRecPtr);
 }
@@ -1245,11 +1525,9 @@ void le_event_Report
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         memset(reportObjPtr->payload, 0, eventPtr->payloadSize);
         memcpy(reportObjPtr->payload, payloadPtr, payloadSize);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        fa_event_TriggerEvent_NoLock(perThreadRecPtr);
+        // Queue it; this will wake up the thread and tell it that it has something to do.
+        QueueReport_NoLock(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1306,11 +1584,9 @@ void le_event_ReportWithRefCounting
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         reportObjPtr->payload[0] = objectPtr;
         le_mem_AddRef(objectPtr);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        fa_event_TriggerEvent_NoLock(perThreadRecPtr);
+        // Queue it; this will wake up the thread and tell it that it has something to do.
+        QueueReport_NoLock(perThreadRecPtr, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1416,11 +1692,15 @@ void le_event_QueueFunction
 )
 //--------------------------------------------------------------------------------------------------
 {
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+    QueueFunctionLockFree(thread_GetEventRecPtr(), func, param1Ptr, param2Ptr);
+#else
     int oldState = event_Lock();
 
     QueueFunction_NoLock(thread_GetEventRecPtr(), func, param1Ptr, param2Ptr);
 
     event_Unlock(oldState);
+#endif
 }
 
 
@@ -1439,11 +1719,15 @@ void le_event_QueueFunctionToThread
 )
 //--------------------------------------------------------------------------------------------------
 {
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+    QueueFunctionLockFree(thread_GetOtherEventRecPtr(thread), func, param1Ptr, param2Ptr);
+#else
     int oldState = event_Lock();
 
     QueueFunction_NoLock(thread_GetOtherEventRecPtr(thread), func, param1Ptr, param2Ptr);
 
     event_Unlock(oldState);
+#endif
 }
 
 
@@ -1475,6 +1759,8 @@ le_result_t le_event_QueueFunctionToThreadUnique
 
     event_PerThreadRec_t* perThreadRecPtr = thread_GetOtherEventRecPtr(thread);
 
+    // NOTE: With LE_CONFIG_EVENT_LOCK_FREE_QUEUE, functions still on the thread's lock-free queue
+    //       are not seen here.
     LE_SLS_FOREACH(&perThreadRecPtr->eventQueue,
                    reportPtr, QueuedFunctionReport_t, baseClass.link)
     {
@@ -1516,3 +1802,28 @@ void le_event_RunLoop
 {
     fa_event_RunLoop();
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables profiling of the calling thread's Event Loop.
+ *
+ * @return
+ *  - LE_OK if profiling is enabled.
+ *  - LE_NOT_IMPLEMENTED if the framework was built without event loop profiling support.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_event_EnableProfiling
+(
+    uint32_t slowThresholdMs    ///< [in] Handlers running for longer than this are reported in
+                                ///       the logs (0 = no reports).
+)
+{
+#if LE_CONFIG_EVENT_PROFILING
+    eventProf_EnableThread(thread_GetEventRecPtr(), slowThresholdMs);
+    return LE_OK;
+#else
+    LE_UNUSED(slowThresholdMs);
+    return LE_NOT_IMPLEMENTED;
+#endif
+}
@@ -106,7 +106,35 @@ void event_ProcessOneEventReport
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Process Event Reports from the calling thread's Event Queue until the queue is empty.
+ * Start processing a batch of Event Reports from the calling thread's Event Queue.
+ *
+ * This is usually called from the framework adaptor implementation of le_event_ServiceLoop(),
+ * which then calls event_ProcessOneEventReport() for each report of the batch, followed by
+ * event_EndReportBatch().
+ *
+ * @return The number of Event Reports in the batch.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t event_BeginReportBatch
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish processing a batch of Event Reports started by event_BeginReportBatch().
+ */
+//--------------------------------------------------------------------------------------------------
+void event_EndReportBatch
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process a batch of Event Reports from the calling thread's Event Queue.
  *
  * This is usually called from the framework adaptor implementation of le_event_RunLoop() and
  * le_event_ServiceLoop()
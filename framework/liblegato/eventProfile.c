@@ -0,0 +1,479 @@
+//--------------------------------------------------------------------------------------------------
+/** @file eventProfile.c
+ *
+ * Event Loop profiling.
+ *
+ * When profiling is enabled for a thread (by setting the LE_EVENT_PROFILE environment variable
+ * for the whole process, or by calling le_event_EnableProfiling() from the thread), the Event
+ * Loop, the FD Monitor module and the Timer module report every handler they run to this module.
+ * For each handler function, the thread's profiling record keeps a run-time histogram, the
+ * longest run-time, the number of runs that exceeded the slow handler threshold and the deepest
+ * Event Queue seen when the handler was run.  The record also keeps the latency between the
+ * queueing of Event Reports and their dispatch.
+ *
+ * The records are kept on a process-wide list so the Inspect tool can read them
+ * ("inspect events <pid>") without stopping the process for longer than a memory read.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+#include "eventLoop.h"
+#include "eventProfile.h"
+
+#if LE_CONFIG_EVENT_PROFILING
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which the per-thread profiling records are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ThreadRecPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the profiling records of the process, exposed to the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t ThreadRecList = LE_DLS_LIST_DECL_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A counter that increments every time a change is made to ThreadRecList.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ThreadRecListChangeCount = 0;
+static size_t* ThreadRecListChangeCountRef = &ThreadRecListChangeCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if all the threads of the process are profiled (LE_EVENT_PROFILE is set).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsProcessProfiled = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slow handler threshold applied to the threads profiled because of LE_EVENT_PROFILE, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ProcessSlowThresholdMs = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex used to protect the record list from races.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;   // POSIX "Fast" mutex.
+
+/// Locks the mutex.
+#define LOCK    LE_ASSERT(pthread_mutex_lock(&Mutex) == 0);
+
+/// Unlocks the mutex.
+#define UNLOCK  LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the handler types, used in the slow handler warnings.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const TypeNames[EVENT_PROF_TYPE_COUNT] =
+{
+    "dispatch",
+    "queued function",
+    "event handler",
+    "fd monitor",
+    "timer"
+};
+
+
+// ==============================================
+//  PRIVATE FUNCTIONS
+// ==============================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a sample to a statistics entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddSample
+(
+    eventProf_Entry_t* entryPtr,    ///< [IN] Entry to update.
+    uint64_t           sampleUs,    ///< [IN] Sample, in microseconds.
+    size_t             queueDepth   ///< [IN] Event Queue depth.
+)
+{
+    uint32_t bucket = 0;
+    uint64_t value = sampleUs;
+
+    while ((value != 0) && (bucket < (EVENT_PROF_BUCKET_COUNT - 1)))
+    {
+        value >>= 1;
+        bucket++;
+    }
+
+    entryPtr->count++;
+    entryPtr->totalUs += sampleUs;
+    entryPtr->histogram[bucket]++;
+
+    if (sampleUs > entryPtr->maxUs)
+    {
+        entryPtr->maxUs = (sampleUs > UINT32_MAX) ? UINT32_MAX : (uint32_t)sampleUs;
+    }
+
+    if (queueDepth > entryPtr->maxQueueDepth)
+    {
+        entryPtr->maxQueueDepth = (uint32_t)queueDepth;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the statistics entry of a handler, allocating it on its first run.
+ *
+ * @return The entry, or NULL if the entry table is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static eventProf_Entry_t* FindEntry
+(
+    eventProf_ThreadRec_t* recPtr,  ///< [IN] Profiling record.
+    eventProf_Type_t       type,    ///< [IN] Type of handler.
+    const void*            key,     ///< [IN] Handler function address.
+    const char*            name     ///< [IN] Handler name, or NULL.
+)
+{
+    // Open addressing, the table is never shrunk while the thread is alive.
+    size_t index = ((((uintptr_t)key) >> 2) * 2654435761u) % LE_CONFIG_EVENT_PROFILE_MAX_HANDLERS;
+    size_t probe;
+
+    for (probe = 0; probe < LE_CONFIG_EVENT_PROFILE_MAX_HANDLERS; probe++)
+    {
+        eventProf_Entry_t* entryPtr = &recPtr->entries[index];
+
+        if ((entryPtr->key == key) && (entryPtr->type == type))
+        {
+            return entryPtr;
+        }
+
+        if (entryPtr->key == NULL)
+        {
+            memset(entryPtr, 0, sizeof(*entryPtr));
+            entryPtr->key = key;
+            entryPtr->type = type;
+
+            if (name != NULL)
+            {
+                le_utf8_Copy(entryPtr->name, name, sizeof(entryPtr->name), NULL);
+            }
+            else
+            {
+                snprintf(entryPtr->name, sizeof(entryPtr->name), "%p", key);
+            }
+
+            return entryPtr;
+        }
+
+        index = (index + 1) % LE_CONFIG_EVENT_PROFILE_MAX_HANDLERS;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a profiling record for the calling thread and add it to the record list.
+ *
+ * @return The record.
+ */
+//--------------------------------------------------------------------------------------------------
+static eventProf_ThreadRec_t* CreateThreadRec
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [IN] The calling thread's event record.
+    uint32_t              slowThresholdMs   ///< [IN] Slow handler threshold (0 = no warnings).
+)
+{
+    eventProf_ThreadRec_t* recPtr = le_mem_ForceAlloc(ThreadRecPool);
+
+    memset(recPtr, 0, sizeof(*recPtr));
+    recPtr->link = LE_DLS_LINK_INIT;
+    le_utf8_Copy(recPtr->threadName, le_thread_GetMyName(), sizeof(recPtr->threadName), NULL);
+    recPtr->slowThresholdUs = slowThresholdMs * 1000;
+    recPtr->dispatch.key = recPtr;
+    recPtr->dispatch.type = EVENT_PROF_TYPE_DISPATCH;
+    le_utf8_Copy(recPtr->dispatch.name, "<event queue>", sizeof(recPtr->dispatch.name), NULL);
+
+    LOCK
+    le_dls_Queue(&ThreadRecList, &recPtr->link);
+    ThreadRecListChangeCount++;
+    UNLOCK
+
+    perThreadRecPtr->profileRecPtr = recPtr;
+
+    return recPtr;
+}
+
+
+// ==============================================
+//  INTER-MODULE FUNCTIONS
+// ==============================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the profiling record list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* eventProf_GetThreadRecList
+(
+    void
+)
+{
+    return (&ThreadRecList);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the profiling record list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** eventProf_GetThreadRecListChgCntRef
+(
+    void
+)
+{
+    return (&ThreadRecListChangeCountRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Event Loop profiling module.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_Init
+(
+    void
+)
+{
+    ThreadRecPool = le_mem_CreatePool("EventProfile", sizeof(eventProf_ThreadRec_t));
+
+    const char* envPtr = getenv(EVENT_PROF_ENV_VAR_NAME);
+
+    if (envPtr != NULL)
+    {
+        int thresholdMs = 0;
+
+        if ((*envPtr != '\0') &&
+            ((le_utf8_ParseInt(&thresholdMs, envPtr) != LE_OK) || (thresholdMs < 0)))
+        {
+            LE_WARN("Invalid %s value '%s', slow handler warnings disabled.",
+                    EVENT_PROF_ENV_VAR_NAME, envPtr);
+            thresholdMs = 0;
+        }
+
+        IsProcessProfiled = true;
+        ProcessSlowThresholdMs = (uint32_t)thresholdMs;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time used to timestamp the samples.
+ *
+ * @return Relative time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t eventProf_GetTimeUs
+(
+    void
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    return ((uint64_t)now.sec * 1000000) + (uint64_t)now.usec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the calling thread's profiling record, creating it if profiling has been enabled for the
+ * whole process.
+ *
+ * @return The record, or NULL if the calling thread is not profiled.
+ */
+//--------------------------------------------------------------------------------------------------
+eventProf_ThreadRec_t* eventProf_GetThreadRec
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [IN] The calling thread's event record.
+)
+{
+    if ((perThreadRecPtr->profileRecPtr == NULL) && IsProcessProfiled)
+    {
+        return CreateThreadRec(perThreadRecPtr, ProcessSlowThresholdMs);
+    }
+
+    return perThreadRecPtr->profileRecPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable profiling for the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_EnableThread
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [IN] The calling thread's event record.
+    uint32_t              slowThresholdMs   ///< [IN] Slow handler threshold (0 = no warnings).
+)
+{
+    if (perThreadRecPtr->profileRecPtr == NULL)
+    {
+        CreateThreadRec(perThreadRecPtr, slowThresholdMs);
+    }
+    else
+    {
+        perThreadRecPtr->profileRecPtr->slowThresholdUs = slowThresholdMs * 1000;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the calling thread's profiling record, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_DestructThread
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [IN] The calling thread's event record.
+)
+{
+    eventProf_ThreadRec_t* recPtr = perThreadRecPtr->profileRecPtr;
+
+    if (recPtr != NULL)
+    {
+        LOCK
+        le_dls_Remove(&ThreadRecList, &recPtr->link);
+        ThreadRecListChangeCount++;
+        UNLOCK
+
+        perThreadRecPtr->profileRecPtr = NULL;
+        le_mem_Release(recPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the time an Event Report waited in the Event Queue before being dispatched.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_RecordDispatch
+(
+    eventProf_ThreadRec_t* recPtr,      ///< [IN] The calling thread's profiling record.
+    uint64_t               queuedUs,    ///< [IN] Time the report was queued.
+    size_t                 queueDepth   ///< [IN] Event Queue depth, including this report.
+)
+{
+    uint64_t nowUs = eventProf_GetTimeUs();
+
+    // Reports queued before profiling was enabled carry no timestamp.
+    if ((queuedUs != 0) && (nowUs >= queuedUs))
+    {
+        AddSample(&recPtr->dispatch, nowUs - queuedUs, queueDepth);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a handler sample.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_BeginHandler
+(
+    eventProf_ThreadRec_t* recPtr       ///< [IN] The calling thread's profiling record.
+)
+{
+    // Samples nested too deeply are not tracked, but the level is counted so that begin and end
+    // calls stay balanced.
+    if (recPtr->nestingLevel < EVENT_PROF_MAX_NESTING)
+    {
+        eventProf_Frame_t* framePtr = &recPtr->frames[recPtr->nestingLevel];
+
+        framePtr->startUs = eventProf_GetTimeUs();
+        framePtr->childUs = 0;
+    }
+
+    recPtr->nestingLevel++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the handler sample started by the last call to eventProf_BeginHandler() and account it to
+ * the handler.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_EndHandler
+(
+    eventProf_ThreadRec_t* recPtr,      ///< [IN] The calling thread's profiling record.
+    eventProf_Type_t       type,        ///< [IN] Type of handler.
+    const void*            key,         ///< [IN] Handler function address.
+    const char*            name,        ///< [IN] Handler name (NULL to use the address).
+    size_t                 queueDepth   ///< [IN] Event Queue depth when the handler was run.
+)
+{
+    LE_ASSERT(recPtr->nestingLevel > 0);
+
+    recPtr->nestingLevel--;
+
+    if (recPtr->nestingLevel >= EVENT_PROF_MAX_NESTING)
+    {
+        return;
+    }
+
+    eventProf_Frame_t* framePtr = &recPtr->frames[recPtr->nestingLevel];
+    uint64_t elapsedUs = eventProf_GetTimeUs() - framePtr->startUs;
+    uint64_t ownUs = (elapsedUs > framePtr->childUs) ? (elapsedUs - framePtr->childUs) : 0;
+
+    // The whole run-time of this handler is spent inside its parent.
+    if (recPtr->nestingLevel > 0)
+    {
+        recPtr->frames[recPtr->nestingLevel - 1].childUs += elapsedUs;
+    }
+
+    eventProf_Entry_t* entryPtr = FindEntry(recPtr, type, key, name);
+
+    if (entryPtr == NULL)
+    {
+        recPtr->droppedCount++;
+        return;
+    }
+
+    AddSample(entryPtr, ownUs, queueDepth);
+
+    if ((recPtr->slowThresholdUs != 0) && (ownUs >= recPtr->slowThresholdUs))
+    {
+        entryPtr->slowCount++;
+
+        LE_WARN("Slow %s '%s' in thread '%s': ran for %" PRIu64 " ms (threshold %" PRIu32 " ms).",
+                TypeNames[type],
+                entryPtr->name,
+                recPtr->threadName,
+                ownUs / 1000,
+                recPtr->slowThresholdUs / 1000);
+    }
+}
+
+#endif /* end LE_CONFIG_EVENT_PROFILING */
@@ -0,0 +1,244 @@
+/**
+ * @file eventProfile.h
+ *
+ * Event Loop profiling module's intra-framework header file.  This file exposes type definitions
+ * and function interfaces to other modules inside the framework implementation, and to the
+ * Inspect tool, which reads the profiling records of a running process.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_SRC_EVENT_PROFILE_H_INCLUDE_GUARD
+#define LEGATO_SRC_EVENT_PROFILE_H_INCLUDE_GUARD
+
+#include "limit.h"
+#include "thread.h"
+
+#if LE_CONFIG_EVENT_PROFILING
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of the environment variable that enables profiling for every thread of a process.  Its
+ * value is the slow handler warning threshold, in milliseconds (0 disables the warnings).
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_PROF_ENV_VAR_NAME             "LE_EVENT_PROFILE"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets in the run-time histograms.  Bucket 0 counts the samples under 1 us, and
+ * bucket n (n > 0) counts the samples in [2^(n-1), 2^n) us.  The last bucket also counts all the
+ * longer samples.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_PROF_BUCKET_COUNT             20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of nested handler samples tracked at the same time by a thread (e.g., a queued
+ * function dispatching an fd event that runs a timer expiry handler).
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_PROF_MAX_NESTING              8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of the code run by the Event Loop, as reported by the profiler.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    EVENT_PROF_TYPE_DISPATCH,       ///< Event Queue wake-up to dispatch latency.
+    EVENT_PROF_TYPE_QUEUED_FUNC,    ///< Queued function.
+    EVENT_PROF_TYPE_EVENT,          ///< Publish-subscribe event handler.
+    EVENT_PROF_TYPE_FD_MONITOR,     ///< File descriptor monitor handler.
+    EVENT_PROF_TYPE_TIMER,          ///< Timer expiry handler.
+    EVENT_PROF_TYPE_COUNT
+}
+eventProf_Type_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of one handler function.
+ *
+ * Run-times are the handler's own run-time: the time spent in handlers nested inside it (e.g., the
+ * timer expiry handlers run by the timer fd monitor) is accounted to the nested handlers only.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const void*         key;            ///< Handler function address (NULL if the slot is free).
+    eventProf_Type_t    type;           ///< Type of handler.
+    char                name[LIMIT_MAX_EVENT_HANDLER_NAME_BYTES];  ///< Name of the handler.
+    uint64_t            count;          ///< Number of runs.
+    uint64_t            totalUs;        ///< Sum of the run-times, in microseconds.
+    uint32_t            maxUs;          ///< Longest run-time, in microseconds.
+    uint32_t            slowCount;      ///< Number of runs over the slow handler threshold.
+    uint32_t            maxQueueDepth;  ///< Deepest Event Queue seen when the handler was run.
+    uint32_t            histogram[EVENT_PROF_BUCKET_COUNT];   ///< Run-time histogram.
+}
+eventProf_Entry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Nested handler sample in progress.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t startUs;                   ///< Time the handler was called.
+    uint64_t childUs;                   ///< Time spent in nested handlers so far.
+}
+eventProf_Frame_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-thread profiling record.
+ *
+ * Records are only written by their own thread; the Inspect tool reads them while the process
+ * is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct eventProf_ThreadRec
+{
+    le_dls_Link_t       link;           ///< Link in the process's record list.
+    char                threadName[MAX_THREAD_NAME_SIZE];   ///< Name of the profiled thread.
+    uint32_t            slowThresholdUs;///< Slow handler warning threshold (0 = no warnings).
+    uint32_t            droppedCount;   ///< Samples dropped because the entry table is full.
+    size_t              nestingLevel;   ///< Number of samples in progress.
+    eventProf_Frame_t   frames[EVENT_PROF_MAX_NESTING];             ///< Samples in progress.
+    eventProf_Entry_t   dispatch;       ///< Wake-up to dispatch latency of the Event Queue.
+    eventProf_Entry_t   entries[LE_CONFIG_EVENT_PROFILE_MAX_HANDLERS];  ///< Handler statistics.
+}
+eventProf_ThreadRec_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the profiling record list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* eventProf_GetThreadRecList
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the profiling record list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** eventProf_GetThreadRecListChgCntRef
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the Event Loop profiling module.
+ *
+ * This function must be called exactly once at process start-up, before any other profiling
+ * module functions are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time used to timestamp the samples.
+ *
+ * @return Relative time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t eventProf_GetTimeUs
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the calling thread's profiling record, creating it if profiling has been enabled for the
+ * whole process.
+ *
+ * @return The record, or NULL if the calling thread is not profiled.
+ */
+//--------------------------------------------------------------------------------------------------
+eventProf_ThreadRec_t* eventProf_GetThreadRec
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [IN] The calling thread's event record.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable profiling for the calling thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_EnableThread
+(
+    event_PerThreadRec_t* perThreadRecPtr,  ///< [IN] The calling thread's event record.
+    uint32_t              slowThresholdMs   ///< [IN] Slow handler threshold (0 = no warnings).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the calling thread's profiling record, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_DestructThread
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [IN] The calling thread's event record.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the time an Event Report waited in the Event Queue before being dispatched.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_RecordDispatch
+(
+    eventProf_ThreadRec_t* recPtr,      ///< [IN] The calling thread's profiling record.
+    uint64_t               queuedUs,    ///< [IN] Time the report was queued.
+    size_t                 queueDepth   ///< [IN] Event Queue depth, including this report.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a handler sample.  Must be followed by a call to eventProf_EndHandler() once the handler
+ * returns.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_BeginHandler
+(
+    eventProf_ThreadRec_t* recPtr       ///< [IN] The calling thread's profiling record.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the handler sample started by the last call to eventProf_BeginHandler() and account it to
+ * the handler.
+ */
+//--------------------------------------------------------------------------------------------------
+void eventProf_EndHandler
+(
+    eventProf_ThreadRec_t* recPtr,      ///< [IN] The calling thread's profiling record.
+    eventProf_Type_t       type,        ///< [IN] Type of handler.
+    const void*            key,         ///< [IN] Handler function address.
+    const char*            name,        ///< [IN] Handler name (NULL to use the address).
+    size_t                 queueDepth   ///< [IN] Event Queue depth when the handler was run.
+);
+
+#endif /* end LE_CONFIG_EVENT_PROFILING */
+
+#endif /* LEGATO_SRC_EVENT_PROFILE_H_INCLUDE_GUARD */
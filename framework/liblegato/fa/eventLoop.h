@@ -50,6 +50,14 @@ typedef struct
                                             ///< balance between queued events and monitored fds
                                             ///< in le_event_ServiceLoop().
     void*                currentEvent;      ///< Pointer to the current event report being processed
+    size_t               queueDepth;        ///< Number of Event Reports on the Event Queue.
+#if LE_CONFIG_EVENT_LOCK_FREE_QUEUE
+    le_sls_Link_t* volatile lockFreeQueuePtr;   ///< Queued Function Reports pushed without the
+                                                ///< mutex, newest first.
+#endif
+#if LE_CONFIG_EVENT_PROFILING
+    struct eventProf_ThreadRec* profileRecPtr;  ///< Profiling record, NULL if not profiled.
+#endif
 }
 event_PerThreadRec_t;
 
@@ -102,6 +110,11 @@ void fa_event_ThreadInit
 //--------------------------------------------------------------------------------------------------
 /**
  * Inform event loop an event has fired.  Wakes the event loop if it is asleep.
+ *
+ * Wake-ups may be coalesced: once signalled, the event loop need not be signalled again until it
+ * has called fa_event_WaitForEvent().
+ *
+ * @note With LE_CONFIG_EVENT_LOCK_FREE_QUEUE, this is also called without the event mutex held.
  */
 //--------------------------------------------------------------------------------------------------
 void fa_event_TriggerEvent_NoLock
@@ -111,10 +124,10 @@ void fa_event_TriggerEvent_NoLock
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Wait for an event to trigger.  This fetches the value of the Event FD (which is
- * the number of event reports on the Event Queue) and resets the Event FD value to zero.
+ * Acknowledge the thread's wake-up signal, so that the next call to
+ * fa_event_TriggerEvent_NoLock() signals it again.  This does not block.
  *
- * @return The number of Event Reports on the thread's Event Queue.
+ * @return The number of wake-up signals received since the last call (0 if none).
  */
 //--------------------------------------------------------------------------------------------------
 uint64_t fa_event_WaitForEvent
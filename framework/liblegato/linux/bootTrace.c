@@ -0,0 +1,300 @@
+//--------------------------------------------------------------------------------------------------
+/** @file bootTrace.c
+ *
+ * Boot tracer.  See bootTrace.h for an overview.
+ *
+ * Each process opens the trace file at most once, the first time it records an event, and keeps
+ * it open to record its other events.  The exception is the first service advertised by a
+ * process, which is the only event most framework daemons record: the trace file is then opened
+ * and closed around the record, unless the process already has it open.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "bootTrace.h"
+#include "fileDescriptor.h"
+#include "smack.h"
+#include "sysPaths.h"
+
+#if LE_CONFIG_BOOT_TRACE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the state of the module.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;   // POSIX "Fast" mutex.
+
+/// Locks the mutex.
+#define LOCK    LE_ASSERT(pthread_mutex_lock(&Mutex) == 0);
+
+/// Unlocks the mutex.
+#define UNLOCK  LE_ASSERT(pthread_mutex_unlock(&Mutex) == 0);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File descriptor of the trace file, or -1 if the process doesn't have it open.
+ */
+//--------------------------------------------------------------------------------------------------
+static int TraceFd = -1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the process has tried to open the trace file (whether it succeeded or not).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsOpenTried = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the first service advertised by the process has been recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsAdvertiseRecorded = false;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a clock time to microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ToUs
+(
+    le_clk_Time_t time
+)
+{
+    return ((uint64_t)time.sec * 1000000) + (uint64_t)time.usec;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the trace file in a single write().
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendEntry
+(
+    int fd,                     ///< [IN] Trace file.
+    uint64_t timeUs,            ///< [IN] Time of the event.
+    bootTrace_Event_t event,    ///< [IN] Event.
+    pid_t pid,                  ///< [IN] Process the event relates to (0 for the caller).
+    const char* namePtr         ///< [IN] Name (truncated if needed).
+)
+{
+    bootTrace_Entry_t entry;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.timeUs = timeUs;
+    entry.pid = (pid == 0 ? getpid() : pid);
+    entry.event = event;
+
+    // Truncation is fine, the name is only displayed.
+    (void)le_utf8_Copy(entry.name, (namePtr == NULL ? "" : namePtr), sizeof(entry.name), NULL);
+
+    ssize_t written;
+    do
+    {
+        written = write(fd, &entry, sizeof(entry));
+    }
+    while ((written == -1) && (errno == EINTR));
+
+    if (written != sizeof(entry))
+    {
+        LE_WARN("Failed to write boot trace record (%zd). %m", written);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the trace file being recorded for appending.
+ *
+ * @return The file descriptor, or -1 if no trace is being recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+static int OpenTrace
+(
+    void
+)
+{
+    int fd;
+
+    do
+    {
+        fd = open(BOOT_TRACE_RECORDING_PATH, O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+    while ((fd == -1) && (errno == EINTR));
+
+    return fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new boot trace, discarding any trace being recorded.  Called by the start program
+ * before it launches the Supervisor.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Begin
+(
+    void
+)
+{
+    LOCK
+
+    if (TraceFd != -1)
+    {
+        fd_Close(TraceFd);
+    }
+
+    IsOpenTried = true;
+
+    do
+    {
+        TraceFd = open(BOOT_TRACE_RECORDING_PATH,
+                       O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+                       S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    }
+    while ((TraceFd == -1) && (errno == EINTR));
+
+    if (TraceFd == -1)
+    {
+        // /legato may be read-only.  Start-up is not traced in that case.
+        LE_DEBUG("Boot trace disabled, could not create '%s'. %m", BOOT_TRACE_RECORDING_PATH);
+    }
+    else
+    {
+        // The framework daemons must be able to append to the trace.
+        (void)smack_SetLabel(BOOT_TRACE_RECORDING_PATH, "framework");
+
+        AppendEntry(TraceFd,
+                    ToUs(le_clk_GetAbsoluteTime()),
+                    BOOT_TRACE_HEADER,
+                    BOOT_TRACE_VERSION,
+                    BOOT_TRACE_MAGIC);
+    }
+
+    UNLOCK
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the boot trace, if one is being recorded.
+ *
+ * The trace file is opened by the first call made by a process.  If no trace is being recorded at
+ * that time, this and all later calls made by the process do nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Record
+(
+    bootTrace_Event_t event,    ///< [IN] Event.
+    pid_t pid,                  ///< [IN] Process the event relates to (0 for the caller).
+    const char* namePtr         ///< [IN] Phase, daemon, service or app name (truncated if needed).
+)
+{
+    uint64_t timeUs = ToUs(le_clk_GetRelativeTime());
+
+    LOCK
+
+    if (!IsOpenTried)
+    {
+        IsOpenTried = true;
+        TraceFd = OpenTrace();
+    }
+
+    if (TraceFd != -1)
+    {
+        AppendEntry(TraceFd, timeUs, event, pid, namePtr);
+    }
+
+    UNLOCK
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the first service advertised by the calling process.  Later calls do nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_RecordAdvertise
+(
+    const char* serviceNamePtr  ///< [IN] Name of the service.
+)
+{
+    uint64_t timeUs = ToUs(le_clk_GetRelativeTime());
+
+    LOCK
+
+    if (!IsAdvertiseRecorded)
+    {
+        IsAdvertiseRecorded = true;
+
+        if (TraceFd != -1)
+        {
+            AppendEntry(TraceFd, timeUs, BOOT_TRACE_ADVERTISE, 0, serviceNamePtr);
+        }
+        else if (!IsOpenTried)
+        {
+            // Don't keep the file open, this is the only event most processes record.
+            int fd = OpenTrace();
+
+            if (fd != -1)
+            {
+                AppendEntry(fd, timeUs, BOOT_TRACE_ADVERTISE, 0, serviceNamePtr);
+                fd_Close(fd);
+            }
+        }
+    }
+
+    UNLOCK
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the boot trace: record that start-up is done and move the trace to BOOT_TRACE_PATH.  Called
+ * by the Supervisor once the apps have been auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_End
+(
+    void
+)
+{
+    uint64_t timeUs = ToUs(le_clk_GetRelativeTime());
+
+    LOCK
+
+    if (!IsOpenTried)
+    {
+        IsOpenTried = true;
+        TraceFd = OpenTrace();
+    }
+
+    if (TraceFd != -1)
+    {
+        AppendEntry(TraceFd, timeUs, BOOT_TRACE_DONE, 0, "");
+        fd_Close(TraceFd);
+        TraceFd = -1;
+
+        // Processes started from now on won't find the trace, so won't record anything.
+        if (rename(BOOT_TRACE_RECORDING_PATH, BOOT_TRACE_PATH) == -1)
+        {
+            LE_WARN("Could not save boot trace to '%s'. %m", BOOT_TRACE_PATH);
+        }
+        else
+        {
+            LE_INFO("Boot trace saved to '%s'.", BOOT_TRACE_PATH);
+        }
+    }
+
+    UNLOCK
+}
+
+#endif /* end LE_CONFIG_BOOT_TRACE */
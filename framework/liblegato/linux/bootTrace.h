@@ -0,0 +1,151 @@
+//--------------------------------------------------------------------------------------------------
+/** @file bootTrace.h
+ *
+ * Boot tracer inter-module include file.
+ *
+ * While the framework starts up, the start program, the Supervisor and the framework daemons
+ * append fixed-size records to a trace file (BOOT_TRACE_RECORDING_PATH): the start program's
+ * phases, the launch and readiness of each framework daemon, the first service advertised by
+ * each process and the start of each app.  Once the apps have been auto-started, the Supervisor
+ * ends the trace and renames it to BOOT_TRACE_PATH, where the "boottrace" tool renders it as a
+ * timeline.
+ *
+ * The trace file starts with a header record, followed by the event records.  Records are
+ * appended with a single write() to a file opened with O_APPEND, so records written by different
+ * processes are never interleaved.
+ *
+ * This file exposes interfaces that are for use by other modules inside the framework
+ * implementation, but must not be used outside of the framework implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_SRC_BOOT_TRACE_INCLUDE_GUARD
+#define LEGATO_SRC_BOOT_TRACE_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic string stored in the name of the header record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BOOT_TRACE_MAGIC            "LEGATO_BOOT_TRACE"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Version of the trace file format, stored in the pid of the header record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BOOT_TRACE_VERSION          1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the name field of a record, including the null-terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BOOT_TRACE_NAME_BYTES       48
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Boot trace events.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    BOOT_TRACE_HEADER = 0,      ///< Header record (first record of the file).
+    BOOT_TRACE_PHASE,           ///< Start of a start-up phase.
+    BOOT_TRACE_DAEMON_EXEC,     ///< A framework daemon was forked (pid is the daemon's).
+    BOOT_TRACE_DAEMON_READY,    ///< A framework daemon signalled it is ready (pid is the daemon's).
+    BOOT_TRACE_ADVERTISE,       ///< First service advertised by a process.
+    BOOT_TRACE_APP_START,       ///< An app is being started.
+    BOOT_TRACE_DONE,            ///< Start-up is done.
+    BOOT_TRACE_EVENT_COUNT
+}
+bootTrace_Event_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Trace file record.
+ *
+ * In the header record, timeUs is the wall-clock time the trace was started at (in microseconds
+ * since the Epoch), pid is BOOT_TRACE_VERSION and name is BOOT_TRACE_MAGIC.  In the other records,
+ * timeUs is the CLOCK_MONOTONIC time of the event.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t    timeUs;                         ///< Time of the event, in microseconds.
+    int32_t     pid;                            ///< Process the event relates to.
+    uint16_t    event;                          ///< Event (bootTrace_Event_t).
+    uint16_t    reserved;                       ///< Reserved, set to 0.
+    char        name[BOOT_TRACE_NAME_BYTES];    ///< Phase, daemon, service or app name.
+}
+bootTrace_Entry_t;
+
+
+#if LE_CONFIG_BOOT_TRACE
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new boot trace, discarding any trace being recorded.  Called by the start program
+ * before it launches the Supervisor.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Begin
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the boot trace, if one is being recorded.
+ *
+ * The trace file is opened by the first call made by a process.  If no trace is being recorded at
+ * that time, this and all later calls made by the process do nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_Record
+(
+    bootTrace_Event_t event,    ///< [IN] Event.
+    pid_t pid,                  ///< [IN] Process the event relates to (0 for the caller).
+    const char* namePtr         ///< [IN] Phase, daemon, service or app name (truncated if needed).
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the first service advertised by the calling process.  Later calls do nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_RecordAdvertise
+(
+    const char* serviceNamePtr  ///< [IN] Name of the service.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the boot trace: record that start-up is done and move the trace to BOOT_TRACE_PATH.  Called
+ * by the Supervisor once the apps have been auto-started.
+ */
+//--------------------------------------------------------------------------------------------------
+void bootTrace_End
+(
+    void
+);
+
+#else /* if not LE_CONFIG_BOOT_TRACE */
+
+#define bootTrace_Begin()                           ((void)0)
+#define bootTrace_Record(event, pid, namePtr)       ((void)0)
+#define bootTrace_RecordAdvertise(serviceNamePtr)   ((void)0)
+#define bootTrace_End()                             ((void)0)
+
+#endif /* end LE_CONFIG_BOOT_TRACE */
+
+
+#endif  // LEGATO_SRC_BOOT_TRACE_INCLUDE_GUARD
@@ -55,6 +55,14 @@ static const char* SubSysName[CGRP_NUM_SUBSYSTEMS] = {"cpu,cpuacct", "memory", "
 #define CPU_SHARES_FILENAME         "cpu.shares"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cpu usage file.  Total cpu time consumed by the tasks of the cgroup, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CPU_USAGE_FILENAME          "cpuacct.usage"
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory limit file.
@@ -935,6 +943,49 @@ le_result_t cgrp_cpu_SetShare
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total cpu time consumed by the tasks of a cgroup since it was created.
+ *
+ * @note Realtime processes are not added to the cpu cgroup of their app so their cpu time is not
+ *       included.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_cpu_GetUsage
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* usagePtr              ///< [OUT] Cpu time in nanoseconds.
+)
+{
+    char buffer[32] = {0};
+
+    if (GetValue(CGRP_SUBSYS_CPU,
+                 cgroupNamePtr,
+                 CPU_USAGE_FILENAME,
+                 buffer,
+                 sizeof(buffer)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    char* endPtr;
+
+    errno = 0;
+    *usagePtr = strtoull(buffer, &endPtr, 10);
+    if ((errno != 0) || (endPtr == buffer))
+    {
+        LE_ERROR("Invalid cpu usage '%s' in cgroup '%s'.", buffer, cgroupNamePtr);
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the memory limit for a cgroup.
@@ -340,6 +340,25 @@ le_result_t cgrp_cpu_SetShare
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the total cpu time consumed by the tasks of a cgroup since it was created.
+ *
+ * @note Realtime processes are not added to the cpu cgroup of their app so their cpu time is not
+ *       included.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t cgrp_cpu_GetUsage
+(
+    const char* cgroupNamePtr,      ///< [IN] Name of the cgroup.
+    uint64_t* usagePtr              ///< [OUT] Cpu time in nanoseconds.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the memory limit for a cgroup.
@@ -19,20 +19,23 @@
  * Included in the set of file descriptors that are being monitored by epoll is an eventfd
  * (see 'man eventfd') monitored in "level-triggered" mode.
  *
- * Whenever an Event Report is added to the Event Queue for a thread, the number 1 is written to
- * that thread's eventfd.  When Event Reports are popped off a thread's Event Queue, that thread's
- * eventfd is read to decrement it.  As long as the eventfd's value is greater than 0, epoll_wait()
- * will return immediately, reporting that there is something to read from that fd.
+ * Wake-ups through the eventfd are coalesced.  When an Event Report is added to the Event Queue
+ * for a thread, the number 1 is written to that thread's eventfd only if nothing has been written
+ * to it since the thread last read it (tracked by the wakeupPending flag).  When the thread starts
+ * processing its Event Queue, it reads the eventfd to reset it to zero, clears the flag, and then
+ * takes a snapshot of the queue.  As long as the eventfd's value is greater than 0, epoll_wait()
+ * will return immediately, reporting that there is something to read from that fd.  So a producer
+ * posting many Event Reports to a busy thread costs one write() and one wake-up per batch rather
+ * than one per report.
  *
  * The Event Loop is an infinite loop that calls epoll_wait() and then responds to any fd events
- * that epoll_wait() reports.  If epoll_wait() reports an event on the eventfd, then an Event Report
- * is popped off the Event Queue and processed.  If epoll_wait() reports an event on any other fd,
+ * that epoll_wait() reports.  If epoll_wait() reports an event on any fd other than the eventfd,
  * FD Event Reports are created and pushed onto Event Queues according to what handlers are
- * registered for those events.  All pending Event Reports are processed until the Event Queue is
- * empty before returning to epoll_wait().  (NOTE: This choice was made to save system call
- * overhead in times of heavy load.  Unfortunately, it also means that if event handlers always add
- * new events to the queue, then epoll_wait() will never be called and therefore fd events will
- * never be detected.)
+ * registered for those events.  Then the Event Reports that were on the Event Queue are processed,
+ * up to LE_CONFIG_EVENT_REPORT_BATCH_SIZE of them, before returning to epoll_wait().  If reports
+ * are left over, the thread signals its own eventfd so that epoll_wait() returns immediately,
+ * after having checked the other fds.  (NOTE: This saves system call overhead in times of heavy
+ * load, while bounding the time during which fd events are not detected.)
  *
  * ----
  *
@@ -110,6 +113,30 @@ static short EPollToPoll
     return pollFlags;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process the next event of the batch started by le_event_ServiceLoop(), and finish the batch
+ * if it was the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessOneBatchedReport
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    perThreadRecPtr->liveEventCount--;
+
+    // This function assumes the mutex is NOT locked.
+    event_ProcessOneEventReport(perThreadRecPtr);
+
+    if (perThreadRecPtr->liveEventCount == 0)
+    {
+        // Make the fd readable again if events were left on the queue.
+        event_EndReportBatch(perThreadRecPtr);
+    }
+}
+
 // ==============================================
 //  FRAMEWORK ADAPTOR FUNCTIONS
 // ==============================================
@@ -154,8 +181,10 @@ event_PerThreadRec_t* fa_event_CreatePerThreadInfo
 
     // Open an eventfd for this thread.  This will be uses to signal to the epoll fd that there
     // are Event Reports on the Event Queue.
-    recPtr->eventQueueFd = eventfd(0, 0);
+    // It is non-blocking so that it can be read even if the wake-up came from another fd.
+    recPtr->eventQueueFd = eventfd(0, EFD_NONBLOCK);
     LE_FATAL_IF(recPtr->eventQueueFd < 0, "eventfd() failed with errno %d.", errno);
+    recPtr->wakeupPending = 0;
 
     // Add the eventfd to the list of file descriptors to wait for using epoll_wait().
     struct epoll_event ev;
@@ -217,9 +246,11 @@ void fa_event_DestructThread
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write to a thread's Event File Descriptor.  This increments it by one.
+ * Write to a thread's Event File Descriptor, unless it has already been written since the thread
+ * last read it.  This increments it by one.
  *
- * This must be done exactly once for each Event Report pushed onto the thread's Event Queue.
+ * This must be done after each Event Report is pushed onto the thread's Event Queue.  It is
+ * safe to call without holding the event mutex.
  */
 //--------------------------------------------------------------------------------------------------
 void fa_event_TriggerEvent_NoLock
@@ -235,6 +266,13 @@ void fa_event_TriggerEvent_NoLock
 
     ssize_t writeSize;
 
+    // Coalesce the wake-ups: if the thread has already been signalled, it will find this
+    // Event Report when it processes its queue.
+    if (!LE_SYNC_BOOL_COMPARE_AND_SWAP(&perThreadRecPtr->wakeupPending, 0, 1))
+    {
+        return;
+    }
+
     for (;;)
     {
         writeSize = write(perThreadRecPtr->eventQueueFd, &writeBuff, sizeof(writeBuff));
@@ -259,10 +297,10 @@ void fa_event_TriggerEvent_NoLock
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read a thread's Event File Descriptor.  This fetches the value of the Event FD (which is
- * the number of event reports on the Event Queue) and resets the Event FD value to zero.
+ * Read a thread's Event File Descriptor.  This fetches the value of the Event FD (the number
+ * of wake-up signals) and resets the Event FD value to zero.  This does not block.
  *
- * @return The number of Event Reports on the thread's Event Queue.
+ * @return The number of wake-up signals, or 0 if there were none.
  */
 //--------------------------------------------------------------------------------------------------
 uint64_t fa_event_WaitForEvent
@@ -280,13 +318,27 @@ uint64_t fa_event_WaitForEvent
     for (;;)
     {
         readSize = read(perThreadRecPtr->eventQueueFd, &readBuff, sizeof(readBuff));
+        if ((readSize == -1) && (errno == EAGAIN))
+        {
+            readBuff = 0;
+            readSize = sizeof(readBuff);
+        }
+
         if (readSize == sizeof(readBuff))
         {
+            // Only clear the flag after the eventfd has been reset, otherwise a signal written in
+            // between would be lost.  Reports queued from now on will signal the thread again.
+            LE_ATOMIC_AND_FETCH(&perThreadRecPtr->wakeupPending, 0, LE_ATOMIC_ORDER_ACQ_REL);
+
             return readBuff;
         }
         else
         {
-            if ((readSize == -1) && (errno != EINTR))
+            if ((readSize == -1) && (errno == EINTR))
+            {
+                continue;
+            }
+            else if (readSize == -1)
             {
                 LE_FATAL("read() failed with errno %d.", errno);
             }
@@ -442,13 +494,10 @@ le_result_t le_event_ServiceLoop
 
     LE_DEBUG("perThreadRecPtr->liveEventCount is" "%" PRIu64, perThreadRecPtr->liveEventCount);
 
-    // If there are still live events remaining in the queue, process a single event, then return
+    // If there are still live events remaining in the batch, process a single event, then return
     if (perThreadRecPtr->liveEventCount > 0)
     {
-        perThreadRecPtr->liveEventCount--;
-
-        // This function assumes the mutex is NOT locked.
-        event_ProcessOneEventReport(perThreadRecPtr);
+        ProcessOneBatchedReport(perThreadRecPtr);
 
         return LE_OK;
     }
@@ -514,16 +563,15 @@ le_result_t le_event_ServiceLoop
     }
 
     // Read the eventfd to reset it to zero so epoll stops telling us about it until more
-    // are added.
-    perThreadRecPtr->liveEventCount = fa_event_WaitForEvent(perThreadRecPtr);
+    // are added, and take the next batch of events from the queue.
+    perThreadRecPtr->liveEventCount = event_BeginReportBatch(perThreadRecPtr);
 
     LE_DEBUG("perThreadRecPtr->liveEventCount is" "%" PRIu64, perThreadRecPtr->liveEventCount);
 
     // If events were read, process the top event
     if (perThreadRecPtr->liveEventCount > 0)
     {
-        perThreadRecPtr->liveEventCount--;
-        event_ProcessOneEventReport(perThreadRecPtr);
+        ProcessOneBatchedReport(perThreadRecPtr);
 
         return LE_OK;
     }
@@ -24,6 +24,8 @@ typedef struct
     int                     epollFd;                ///< epoll(7) file descriptor.
     int                     eventQueueFd;           ///< eventfd(2) file descriptor for the Event
                                                     ///< Queue.
+    int                     wakeupPending;          ///< 1 if eventQueueFd has been written since
+                                                    ///< the thread last read it.
 }
 event_LinuxPerThreadRec_t;
 
@@ -43,6 +43,7 @@
 
 #include "legato.h"
 #include "eventLoop.h"
+#include "eventProfile.h"
 #include "thread.h"
 #include "fdMonitor.h"
 #include "limit.h"
@@ -323,7 +324,22 @@ void fa_fdMon_DispatchToHandler
     }
 
     // Call the handler function.
-    fdMonitorPtr->handlerFunc(fdMonitorPtr->fd, flags);
+#if LE_CONFIG_EVENT_PROFILING
+    eventProf_ThreadRec_t *profileRecPtr = fdMonitorPtr->threadRecPtr->profileRecPtr;
+    if (profileRecPtr != NULL)
+    {
+        eventProf_BeginHandler(profileRecPtr);
+        fdMonitorPtr->handlerFunc(fdMonitorPtr->fd, flags);
+        eventProf_EndHandler(profileRecPtr, EVENT_PROF_TYPE_FD_MONITOR,
+                             (const void *)fdMonitorPtr->handlerFunc,
+                             FDMON_NAME(fdMonitorPtr->name),
+                             fdMonitorPtr->threadRecPtr->queueDepth);
+    }
+    else
+#endif
+    {
+        fdMonitorPtr->handlerFunc(fdMonitorPtr->fd, flags);
+    }
 
     // If this fd is always ready (is not supported by epoll) and either POLLIN or POLLOUT
     // are enabled, then queue up another dispatcher for this FD Monitor.
@@ -15,6 +15,8 @@
 #include "logPlatform.h"
 #include "messagingSession.h"
 
+#include <sys/un.h>
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Maximum length of log messages.
@@ -23,6 +25,26 @@
 #define MAX_MSG_SIZE            256
 
 
+#if LE_CONFIG_LOG_STORE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Socket used to send a copy of the log messages to the Log Control Daemon's log store, -1 if it
+ * could not be created.  See LOG_STORE_SOCKET_NAME.
+ */
+//--------------------------------------------------------------------------------------------------
+static int LogStoreFd = -1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Address of the log store socket.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct sockaddr_un LogStoreAddr = { .sun_family = AF_UNIX,
+                                           .sun_path = LOG_STORE_SOCKET_NAME };
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log session.  Stores log configuration for each registered component.  The component names and
@@ -874,6 +896,67 @@ static void RegisterWithLogControlDaemon
 }
 
 
+#if LE_CONFIG_LOG_STORE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the socket used to send a copy of the log messages to the log store.  It is non-blocking
+ * so that logging never waits for the Log Control Daemon: messages that don't fit in the socket's
+ * queue are dropped from the store (they still go to syslog).
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenLogStoreSocket
+(
+    void
+)
+{
+    LogStoreFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a copy of a log message to the log store.  Errors are ignored; in particular the Log
+ * Control Daemon doesn't receive the messages logged before it starts.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendToLogStore
+(
+    le_log_Level_t level,       ///< [IN] Severity level, -1 for traces.
+    const char* formatPtr,      ///< [IN] Format of the message.
+    ...                         ///< [IN] Positional parameters.
+)
+{
+    char record[LOG_STORE_MAX_MSG_BYTES];
+    int savedErrno = errno;
+
+    if (LogStoreFd < 0)
+    {
+        return;
+    }
+
+    record[0] = (level <= LE_LOG_EMERG) ? level : LOG_STORE_TRACE_LEVEL;
+
+    va_list args;
+    va_start(args, formatPtr);
+    int len = vsnprintf(record + 1, sizeof(record) - 1, formatPtr, args);
+    va_end(args);
+
+    if (len >= 0)
+    {
+        if (len > sizeof(record) - 2)
+        {
+            len = sizeof(record) - 2;
+        }
+
+        sendto(LogStoreFd, record, len + 1, MSG_DONTWAIT | MSG_NOSIGNAL,
+               (struct sockaddr*)&LogStoreAddr, sizeof(LogStoreAddr));
+    }
+
+    errno = savedErrno;
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the logging system.
@@ -911,6 +994,10 @@ void fa_log_Init
 
     // Set the syslog format.
     openlog("Legato", 0, LOG_USER);
+
+#if LE_CONFIG_LOG_STORE
+    OpenLogStoreSocket();
+#endif
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -925,6 +1012,11 @@ void log_ReInit
 {
     closelog();
     openlog("Legato", 0, LOG_USER);
+
+#if LE_CONFIG_LOG_STORE
+    // The previous socket was closed along with the other fds.
+    OpenLogStoreSocket();
+#endif
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1196,6 +1288,21 @@ void fa_log_Send
     // it.  If there was a truncation then that'll just show up in the logs.
     vsnprintf(msg, sizeof(msg), formatPtr, args);
 
+#if LE_CONFIG_LOG_STORE
+    if (functionNamePtr == NULL)
+    {
+        SendToLogStore(level, "%s | %s[%d]/%s T=%s | %s %d | %s",
+                       levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
+                       baseFileNamePtr, lineNumber, msg);
+    }
+    else
+    {
+        SendToLogStore(level, "%s | %s[%d]/%s T=%s | %s %s() %d | %s",
+                       levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
+                       baseFileNamePtr, functionNamePtr, lineNumber, msg);
+    }
+#endif
+
     // If running on an embedded target, write the message out to the log.
 #ifdef LEGATO_EMBEDDED
 
@@ -17,6 +17,7 @@
 #include "messagingSession.h"
 #include "messagingLocal.h"
 #include "fileDescriptor.h"
+#include "bootTrace.h"
 
 
 // =======================================
@@ -1427,6 +1428,8 @@ void le_msg_AdvertiseService
 
     servicePtr->state = LE_MSG_INTERFACE_SERVICE_CONNECTING;
 
+    bootTrace_RecordAdvertise(servicePtr->interface.id.name);
+
     // Open a socket.
     int fd = unixSocket_CreateSeqPacketUnnamed();
     servicePtr->directorySocketFd = fd;
@@ -84,6 +84,16 @@
 #define BOOT_COUNT_PATH            "/legato/bootCount"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The location of the boot trace of the last framework start-up, and of the trace being recorded
+ * while the framework is starting up.  The latter is renamed to the former once start-up is done.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BOOT_TRACE_PATH            "/legato/bootTrace"
+#define BOOT_TRACE_RECORDING_PATH  "/legato/bootTrace.new"
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Constant to use as a symlink target (in place of MD5-based directory name), when the app is
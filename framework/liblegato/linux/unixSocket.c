@@ -166,34 +166,26 @@ static void ExtractAncillaryData
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Creates a named sequenced-packet Unix domain socket. This binds the socket to a file system path.
- * A "socket" type pseudo file will appear at that location in the file system.
+ * Binds a socket to a file system path.  Closes the socket if this fails.
  *
  * @return
- * - The file descriptor (a number > 0) of the socket, if successful.
+ * - The file descriptor of the socket, if successful.
  * - LE_NOT_PERMITTED if the calling process does not have permission to create a socket at
  *      that location in the file system.
  * - LE_DUPLICATE if something already exists at that location in the file system.
  * - LE_FAULT if failed for some other reason (check your logs).
  */
 //--------------------------------------------------------------------------------------------------
-int unixSocket_CreateSeqPacketNamed
+static int BindToPath
 (
+    int fd,             ///< [in] Socket to bind.
     const char* pathStr ///< [in] File system path to bind to the socket.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int fd;
     le_result_t result;
     struct sockaddr_un socketAddr;
 
-    // Create the socket.
-    fd = unixSocket_CreateSeqPacketUnnamed();
-    if (fd < 0)
-    {
-        return LE_FAULT;
-    }
-
     // Bind the socket to the file system path given.
     memset(&socketAddr, 0, sizeof(socketAddr));
     socketAddr.sun_family = AF_UNIX;
@@ -234,6 +226,68 @@ int unixSocket_CreateSeqPacketNamed
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a named sequenced-packet Unix domain socket. This binds the socket to a file system path.
+ * A "socket" type pseudo file will appear at that location in the file system.
+ *
+ * @return
+ * - The file descriptor (a number > 0) of the socket, if successful.
+ * - LE_NOT_PERMITTED if the calling process does not have permission to create a socket at
+ *      that location in the file system.
+ * - LE_DUPLICATE if something already exists at that location in the file system.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+int unixSocket_CreateSeqPacketNamed
+(
+    const char* pathStr ///< [in] File system path to bind to the socket.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Create the socket.
+    int fd = unixSocket_CreateSeqPacketUnnamed();
+    if (fd < 0)
+    {
+        return LE_FAULT;
+    }
+
+    return BindToPath(fd, pathStr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a named datagram Unix domain socket.  This binds the socket to a file system path.
+ * A "socket" type pseudo file will appear at that location in the file system.
+ *
+ * @return
+ * - The file descriptor (a number > 0) of the socket, if successful.
+ * - LE_NOT_PERMITTED if the calling process does not have permission to create a socket at
+ *      that location in the file system.
+ * - LE_DUPLICATE if something already exists at that location in the file system.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+int unixSocket_CreateDatagramNamed
+(
+    const char* pathStr ///< [in] File system path to bind to the socket.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Create the socket.
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd == -1)
+    {
+        LE_ERROR("socket(AF_UNIX, SOCK_DGRAM, 0) failed. Errno = %d (%m). See 'man 7 unix'.",
+                 errno);
+        return LE_FAULT;
+    }
+
+    return BindToPath(fd, pathStr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates an unnamed sequenced-packet Unix domain socket.
@@ -784,3 +838,38 @@ int unixSocket_GetErrorState
 
     return errCode;
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enables authentication of credentials on a socket.  This must be called for a socket before
+ * that socket can receive credentials.
+ *
+ * @return
+ * - LE_OK if successful.
+ * - LE_BAD_PARAMETER if the parameter is not a valid file descriptor.
+ * - LE_NOT_PERMITTED if the the file descriptor is not a socket file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_EnableAuthentication
+(
+    int fd              ///< [IN] fd of the socket that will be used to receive credentials.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const int one = 1;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_PASSCRED, &one, sizeof(one)) != 0)
+    {
+        LE_ERROR("Failed to enable SO_PASSCRED on fd %d. Errno = %d (%m).", fd, errno);
+
+        if (errno == EBADF)
+        {
+            return LE_BAD_PARAMETER;
+        }
+
+        return LE_NOT_PERMITTED;
+    }
+
+    return LE_OK;
+}
@@ -26,6 +26,7 @@
 #include <grp.h>
 #include <sys/file.h>
 #include <sys/sendfile.h>
+#include <sys/inotify.h>
 
 
 //--------------------------------------------------------------------------------------------------
@@ -146,6 +147,449 @@ static le_mem_PoolRef_t AppsTabPool = NULL;
 //--------------------------------------------------------------------------------------------------
 static bool IsEtcWritable = false;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identity cache.
+ *
+ * The C library and the apps translation table are read again from the file system on every
+ * lookup, which the framework daemons do to resolve the credentials of each new client session.
+ * Successful lookups are cached per process.  The cache is flushed whenever one of the files the
+ * results come from changes (or is replaced), which is detected by inotify watches that are
+ * polled, without blocking, before each lookup.  Changes made by this process are detected the
+ * same way.  If a file can't be watched, the cache is bypassed until it can be.
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of identity cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ID_CACHE_USER_NAME,     ///< User ID to user name.
+    ID_CACHE_USER_IDS,      ///< User name to user ID and primary group ID.
+    ID_CACHE_GROUP_NAME,    ///< Group ID to group name.
+    ID_CACHE_GROUP_ID       ///< Group name to group ID.
+}
+IdCacheType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identity cache entry.  The entry is its own hashmap key: the type and either the ID (for the
+ * ID to name entries) or the name (for the name to ID entries).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    IdCacheType_t type;                         ///< Type of entry.
+    uint32_t id;                                ///< User or group ID.
+    char name[LIMIT_MAX_USER_NAME_BYTES];       ///< User or group name.
+    gid_t gid;                                  ///< Primary group ID (ID_CACHE_USER_IDS only).
+}
+IdCacheEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Files the cached results come from, that are watched for changes.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    WATCHED_PASSWORD_FILE,
+    WATCHED_GROUP_FILE,
+    WATCHED_APPS_TRANSLATION_FILE,
+    WATCHED_FILE_COUNT
+}
+WatchedFile_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Events that invalidate the cache when they happen to a watched file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FILE_WATCH_MASK     (IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Events watched in the directory of a watched file that doesn't exist, to catch its creation.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DIR_WATCH_MASK      (IN_CREATE | IN_MOVED_TO | IN_ONLYDIR)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buckets of the identity cache hashmap.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ID_CACHE_HASHMAP_SIZE   31
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths of the watched files, indexed by WatchedFile_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const WatchedFilePaths[WATCHED_FILE_COUNT] =
+{
+    [WATCHED_PASSWORD_FILE]         = PASSWORD_FILE,
+    [WATCHED_GROUP_FILE]            = GROUP_FILE,
+    [WATCHED_APPS_TRANSLATION_FILE] = APPS_TRANSLATION_FILE,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the identity cache.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t IdCacheMutex = PTHREAD_MUTEX_INITIALIZER;   // POSIX "Fast" mutex.
+
+/// Locks the identity cache mutex.
+#define LOCK_ID_CACHE       LE_ASSERT(pthread_mutex_lock(&IdCacheMutex) == 0);
+
+/// Unlocks the identity cache mutex.
+#define UNLOCK_ID_CACHE     LE_ASSERT(pthread_mutex_unlock(&IdCacheMutex) == 0);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of identity cache entries, and hashmap of the entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t IdCachePool = NULL;
+static le_hashmap_Ref_t IdCacheMap = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * inotify instance watching the files the cached results come from, or -1 if the cache is not
+ * initialized.
+ */
+//--------------------------------------------------------------------------------------------------
+static int IdCacheInotifyFd = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Watch descriptors of the watched files, and of the directories of the watched files that don't
+ * exist (-1 if not watched).
+ */
+//--------------------------------------------------------------------------------------------------
+static int FileWatches[WATCHED_FILE_COUNT];
+static int DirWatches[WATCHED_FILE_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true if all the files that the cached results may come from are watched.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsIdCacheWatching = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Incremented every time a watched file changes.  A result read from the files is only added to the
+ * cache if no file changed since the lookup that missed.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t IdCacheGeneration = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identity cache statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static user_CacheStats_t IdCacheStats;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hashes an identity cache key.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashIdCacheKey
+(
+    const void* keyPtr
+)
+{
+    const IdCacheEntry_t* entryPtr = keyPtr;
+
+    if ((entryPtr->type == ID_CACHE_USER_NAME) || (entryPtr->type == ID_CACHE_GROUP_NAME))
+    {
+        return (entryPtr->id * 2) + (entryPtr->type == ID_CACHE_GROUP_NAME);
+    }
+
+    return le_hashmap_HashString(entryPtr->name) + entryPtr->type;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compares two identity cache keys.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsIdCacheKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const IdCacheEntry_t* firstPtr = firstKeyPtr;
+    const IdCacheEntry_t* secondPtr = secondKeyPtr;
+
+    if (firstPtr->type != secondPtr->type)
+    {
+        return false;
+    }
+
+    if ((firstPtr->type == ID_CACHE_USER_NAME) || (firstPtr->type == ID_CACHE_GROUP_NAME))
+    {
+        return (firstPtr->id == secondPtr->id);
+    }
+
+    return (strcmp(firstPtr->name, secondPtr->name) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes all the entries of the identity cache.
+ *
+ * @note Must be called with the identity cache mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushIdCache
+(
+    void
+)
+{
+    le_hashmap_It_Ref_t iterRef = le_hashmap_GetIterator(IdCacheMap);
+
+    while (le_hashmap_NextNode(iterRef) == LE_OK)
+    {
+        le_mem_Release((void*)le_hashmap_GetValue(iterRef));
+    }
+
+    le_hashmap_RemoveAll(IdCacheMap);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Watches a file the cached results may come from.  If the file doesn't exist, its directory is
+ * watched instead, so that the cache gets flushed when the file is created.
+ *
+ * @note Must be called with the identity cache mutex locked.
+ *
+ * @return
+ *      true if the file is watched.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WatchFile
+(
+    WatchedFile_t file
+)
+{
+    const char* pathPtr = WatchedFilePaths[file];
+
+    FileWatches[file] = inotify_add_watch(IdCacheInotifyFd, pathPtr, FILE_WATCH_MASK);
+
+    if (FileWatches[file] != -1)
+    {
+        if (DirWatches[file] != -1)
+        {
+            (void)inotify_rm_watch(IdCacheInotifyFd, DirWatches[file]);
+            DirWatches[file] = -1;
+        }
+        return true;
+    }
+
+    if ((errno == ENOENT) && (DirWatches[file] == -1))
+    {
+        char dirPath[LIMIT_MAX_PATH_BYTES];
+
+        LE_ASSERT_OK(le_utf8_Copy(dirPath, pathPtr, sizeof(dirPath), NULL));
+        *strrchr(dirPath, '/') = '\0';
+
+        DirWatches[file] = inotify_add_watch(IdCacheInotifyFd, dirPath, DIR_WATCH_MASK);
+    }
+
+    if (DirWatches[file] != -1)
+    {
+        // Nothing can be cached from a file that doesn't exist, and its creation will be seen.
+        return true;
+    }
+
+    LE_DEBUG("Cannot watch '%s', identity cache disabled. %m", pathPtr);
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether the identity cache can be used, flushing it first if any watched file changed
+ * since the last check.
+ *
+ * @note Must be called with the identity cache mutex locked.
+ *
+ * @return
+ *      true if the cache can be used.
+ *      false if the cache must be bypassed.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckIdCache
+(
+    void
+)
+{
+    if (IdCacheInotifyFd == -1)
+    {
+        return false;
+    }
+
+    // Any event means that a file changed, was replaced or was created.  The events themselves
+    // don't matter, only that there were some.
+    char buf[sizeof(struct inotify_event) + NAME_MAX + 1]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool hasChanged = false;
+
+    while (read(IdCacheInotifyFd, buf, sizeof(buf)) > 0)
+    {
+        hasChanged = true;
+    }
+
+    if (hasChanged || !IsIdCacheWatching)
+    {
+        IdCacheGeneration++;
+
+        if (le_hashmap_Size(IdCacheMap) > 0)
+        {
+            FlushIdCache();
+            IdCacheStats.flushes++;
+        }
+
+        // Replaced files must be watched again, and files that couldn't be watched retried.
+        IsIdCacheWatching = WatchFile(WATCHED_PASSWORD_FILE) && WatchFile(WATCHED_GROUP_FILE);
+
+        if (!IsEtcWritable)
+        {
+            IsIdCacheWatching = IsIdCacheWatching && WatchFile(WATCHED_APPS_TRANSLATION_FILE);
+        }
+    }
+
+    return IsIdCacheWatching;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the identity cache.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitIdCache
+(
+    void
+)
+{
+    LOCK_ID_CACHE
+
+    if (IdCachePool == NULL)
+    {
+        IdCachePool = le_mem_CreatePool("UserIdCache", sizeof(IdCacheEntry_t));
+        IdCacheMap = le_hashmap_Create("UserIdCache",
+                                       ID_CACHE_HASHMAP_SIZE,
+                                       HashIdCacheKey,
+                                       EqualsIdCacheKey);
+
+        int i;
+        for (i = 0; i < WATCHED_FILE_COUNT; i++)
+        {
+            FileWatches[i] = -1;
+            DirWatches[i] = -1;
+        }
+
+        IdCacheInotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (IdCacheInotifyFd == -1)
+        {
+            LE_WARN("Could not create inotify instance, identity cache disabled. %m");
+        }
+    }
+
+    UNLOCK_ID_CACHE
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up an entry in the identity cache.  The key is the type and either the ID or the name of
+ * the entry.  If found, the entry is copied into the key entry.
+ *
+ * @return
+ *      true if the entry was found.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetIdCacheEntry
+(
+    IdCacheEntry_t* entryPtr,   ///< [IN/OUT] Key of the entry, and the entry if found.
+    uint32_t* generationPtr     ///< [OUT] Cache generation, to pass to AddIdCacheEntry() if the
+                                ///<       entry is not found.
+)
+{
+    bool isFound = false;
+
+    LOCK_ID_CACHE
+
+    bool isUsable = CheckIdCache();
+
+    *generationPtr = IdCacheGeneration;
+
+    if (isUsable)
+    {
+        const IdCacheEntry_t* cachedPtr = le_hashmap_Get(IdCacheMap, entryPtr);
+
+        if (cachedPtr != NULL)
+        {
+            *entryPtr = *cachedPtr;
+            isFound = true;
+            IdCacheStats.hits++;
+        }
+        else
+        {
+            IdCacheStats.misses++;
+        }
+    }
+
+    UNLOCK_ID_CACHE
+
+    return isFound;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an entry read from the files to the identity cache, unless a file changed since the lookup
+ * that missed it (in which case the entry may already be stale).
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddIdCacheEntry
+(
+    const IdCacheEntry_t* entryPtr, ///< [IN] The entry.
+    uint32_t generation             ///< [IN] Cache generation returned by GetIdCacheEntry().
+)
+{
+    LOCK_ID_CACHE
+
+    if (   CheckIdCache()
+        && (generation == IdCacheGeneration)
+        && (le_hashmap_Get(IdCacheMap, entryPtr) == NULL))
+    {
+        IdCacheEntry_t* newEntryPtr = le_mem_ForceAlloc(IdCachePool);
+
+        *newEntryPtr = *entryPtr;
+        le_hashmap_Put(IdCacheMap, newEntryPtr, newEntryPtr);
+    }
+
+    UNLOCK_ID_CACHE
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Updates the user or group ID range value from a string.  If the string contains the value to
@@ -554,6 +998,8 @@ void user_Init
         AppsTab = (appTab_t *)le_mem_ForceAlloc(AppsTabPool);
         memset(AppsTab, 0, sizeof(appTab_t) * NbAppsInTranslationTable);
     }
+
+    InitIdCache();
 }
 
 
@@ -2026,8 +2472,7 @@ le_result_t user_DeleteGroup
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets the user ID and group ID of a user and stores them in the locations pointed to by uidPtr and
- * gidPtr.  If there was an error then the values at uidPtr and gidPtr are undefined.
+ * Gets the user ID and group ID of a user, from the identity cache if possible.
  *
  * @return
  *      LE_OK if the successful.
@@ -2035,15 +2480,24 @@ le_result_t user_DeleteGroup
  *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t user_GetIDs
+static le_result_t GetCachedIDs
 (
     const char* usernamePtr,    ///< [IN] Pointer to the name of the user to get.
-    uid_t* uidPtr,              ///< [OUT] Pinter to a location to store the uid for this user.
-                                ///        This can be NULL if the uid is not needed.
+    uid_t* uidPtr,              ///< [OUT] Pointer to a location to store the uid for this user.
     gid_t* gidPtr               ///< [OUT] Pointer to a location to store the gid for this user.
-                                ///        This can be NULL if the gid is not needed.
 )
 {
+    IdCacheEntry_t entry = { .type = ID_CACHE_USER_IDS };
+    uint32_t generation = 0;
+    bool isCacheable = (le_utf8_Copy(entry.name, usernamePtr, sizeof(entry.name), NULL) == LE_OK);
+
+    if (isCacheable && GetIdCacheEntry(&entry, &generation))
+    {
+        *uidPtr = entry.id;
+        *gidPtr = entry.gid;
+        return LE_OK;
+    }
+
     // Lock the passwd file for reading.
     int fd = le_flock_Open(PASSWORD_FILE, LE_FLOCK_READ);
     if (fd < 0)
@@ -2057,47 +2511,76 @@ le_result_t user_GetIDs
     // Release the lock on the passwd file.
     le_flock_Close(fd);
 
+    if (isCacheable && (r == LE_OK))
+    {
+        entry.id = *uidPtr;
+        entry.gid = *gidPtr;
+        AddIdCacheEntry(&entry, generation);
+    }
+
     return r;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets the user ID from a user name.
+ * Gets the user ID and group ID of a user and stores them in the locations pointed to by uidPtr and
+ * gidPtr.  If there was an error then the values at uidPtr and gidPtr are undefined.
  *
  * @return
- *      LE_OK if successful.
+ *      LE_OK if the successful.
  *      LE_NOT_FOUND if the user does not exist.
  *      LE_FAULT if there was an error.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t user_GetUid
+le_result_t user_GetIDs
 (
     const char* usernamePtr,    ///< [IN] Pointer to the name of the user to get.
-    uid_t* uidPtr               ///< [OUT] Pointer to store the uid.
+    uid_t* uidPtr,              ///< [OUT] Pinter to a location to store the uid for this user.
+                                ///        This can be NULL if the uid is not needed.
+    gid_t* gidPtr               ///< [OUT] Pointer to a location to store the gid for this user.
+                                ///        This can be NULL if the gid is not needed.
 )
 {
-    // Lock the passwd file for reading.
-    int fd = le_flock_Open(PASSWORD_FILE, LE_FLOCK_READ);
-    if (fd < 0)
-    {
-        LE_ERROR("Could not read file %s.  %m.", PASSWORD_FILE);
-        return LE_FAULT;
-    }
-
     uid_t uid;
+    gid_t gid;
 
-    le_result_t result = GetUid(usernamePtr, &uid);
+    le_result_t r = GetCachedIDs(usernamePtr, &uid, &gid);
 
-    // Release the lock on the passwd file.
-    le_flock_Close(fd);
-
-    if (result == LE_OK)
+    if (r == LE_OK)
     {
-        *uidPtr = uid;
+        if (uidPtr != NULL)
+        {
+            *uidPtr = uid;
+        }
+
+        if (gidPtr != NULL)
+        {
+            *gidPtr = gid;
+        }
     }
 
-    return result;
+    return r;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the user ID from a user name.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if the user does not exist.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_GetUid
+(
+    const char* usernamePtr,    ///< [IN] Pointer to the name of the user to get.
+    uid_t* uidPtr               ///< [OUT] Pointer to store the uid.
+)
+{
+    return user_GetIDs(usernamePtr, uidPtr, NULL);
 }
 
 
@@ -2117,6 +2600,16 @@ le_result_t user_GetGid
     gid_t* gidPtr                ///< [OUT] Pointer to store the gid.
 )
 {
+    IdCacheEntry_t entry = { .type = ID_CACHE_GROUP_ID };
+    uint32_t generation = 0;
+    bool isCacheable = (le_utf8_Copy(entry.name, groupNamePtr, sizeof(entry.name), NULL) == LE_OK);
+
+    if (isCacheable && GetIdCacheEntry(&entry, &generation))
+    {
+        *gidPtr = entry.gid;
+        return LE_OK;
+    }
+
     // Lock the group file for reading.
     int fd = le_flock_Open(GROUP_FILE, LE_FLOCK_READ);
     if (fd < 0)
@@ -2135,6 +2628,12 @@ le_result_t user_GetGid
     if (result == LE_OK)
     {
         *gidPtr = gid;
+
+        if (isCacheable)
+        {
+            entry.gid = gid;
+            AddIdCacheEntry(&entry, generation);
+        }
     }
 
     return result;
@@ -2143,39 +2642,109 @@ le_result_t user_GetGid
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets a user name from a user ID.
+ * Gets a user or group name from an ID, from the identity cache if possible.
  *
  * @return
  *      LE_OK if successful.
- *      LE_OVERFLOW if the provided buffer is too small and only part of the user name was copied.
- *      LE_NOT_FOUND if the user was not found.
- *      LE_FAULT if there was an error getting the user name.
+ *      LE_OVERFLOW if the provided buffer is too small and only part of the name was copied.
+ *      LE_NOT_FOUND if the user or group was not found.
+ *      LE_FAULT if there was an error getting the name.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t user_GetName
+static le_result_t GetCachedName
 (
-    uid_t uid,                  ///< [IN] The uid of the user to get the name for.
-    char* nameBufPtr,           ///< [OUT] The buffer to store the user name in.
-    size_t nameBufSize          ///< [IN] The size of the buffer that the user name will be stored in.
+    IdCacheType_t type,         ///< [IN] ID_CACHE_USER_NAME or ID_CACHE_GROUP_NAME.
+    uint32_t id,                ///< [IN] The uid or gid.
+    char* nameBufPtr,           ///< [OUT] The buffer to store the name in.
+    size_t nameBufSize          ///< [IN] The size of the buffer that the name will be stored in.
 )
 {
-    // Lock the passwd file for reading.
-    int fd = le_flock_Open(PASSWORD_FILE, LE_FLOCK_READ);
+    IdCacheEntry_t entry = { .type = type, .id = id };
+    uint32_t generation = 0;
+
+    if (GetIdCacheEntry(&entry, &generation))
+    {
+        return le_utf8_Copy(nameBufPtr, entry.name, nameBufSize, NULL);
+    }
+
+    const char* filePathPtr = (type == ID_CACHE_USER_NAME ? PASSWORD_FILE : GROUP_FILE);
+
+    // Lock the passwd or group file for reading.
+    int fd = le_flock_Open(filePathPtr, LE_FLOCK_READ);
     if (fd < 0)
     {
-        LE_ERROR("Could not read file %s.  %m.", PASSWORD_FILE);
+        LE_ERROR("Could not read file %s.  %m.", filePathPtr);
         return LE_FAULT;
     }
 
-    le_result_t r = GetName(uid, nameBufPtr, nameBufSize);
+    le_result_t r;
 
-    // Release the lock on the passwd file.
+    if (type == ID_CACHE_USER_NAME)
+    {
+        r = GetName(id, entry.name, sizeof(entry.name));
+    }
+    else
+    {
+        r = GetGroupName(id, entry.name, sizeof(entry.name));
+    }
+
+    // Release the lock on the file.
     le_flock_Close(fd);
 
+    if (r == LE_OK)
+    {
+        AddIdCacheEntry(&entry, generation);
+
+        return le_utf8_Copy(nameBufPtr, entry.name, nameBufSize, NULL);
+    }
+    else if (r == LE_OVERFLOW)
+    {
+        // Too long to be cached, get it into the caller's buffer directly.
+        fd = le_flock_Open(filePathPtr, LE_FLOCK_READ);
+        if (fd < 0)
+        {
+            LE_ERROR("Could not read file %s.  %m.", filePathPtr);
+            return LE_FAULT;
+        }
+
+        if (type == ID_CACHE_USER_NAME)
+        {
+            r = GetName(id, nameBufPtr, nameBufSize);
+        }
+        else
+        {
+            r = GetGroupName(id, nameBufPtr, nameBufSize);
+        }
+
+        le_flock_Close(fd);
+    }
+
     return r;
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a user name from a user ID.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the provided buffer is too small and only part of the user name was copied.
+ *      LE_NOT_FOUND if the user was not found.
+ *      LE_FAULT if there was an error getting the user name.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t user_GetName
+(
+    uid_t uid,                  ///< [IN] The uid of the user to get the name for.
+    char* nameBufPtr,           ///< [OUT] The buffer to store the user name in.
+    size_t nameBufSize          ///< [IN] The size of the buffer that the user name will be stored in.
+)
+{
+    return GetCachedName(ID_CACHE_USER_NAME, uid, nameBufPtr, nameBufSize);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a group name from a group ID.
@@ -2194,20 +2763,27 @@ le_result_t user_GetGroupName
     size_t nameBufSize          ///< [IN] The size of the buffer that the group name will be stored in.
 )
 {
-    // Lock the group file for reading.
-    int fd = le_flock_Open(GROUP_FILE, LE_FLOCK_READ);
-    if (fd < 0)
-    {
-        LE_ERROR("Could not read file %s.  %m.", GROUP_FILE);
-        return LE_FAULT;
-    }
+    return GetCachedName(ID_CACHE_GROUP_NAME, gid, nameBufPtr, nameBufSize);
+}
 
-    le_result_t r = GetGroupName(gid, nameBufPtr, nameBufSize);
 
-    // Release the lock on the group file.
-    le_flock_Close(fd);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the statistics of the process's identity cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void user_GetCacheStats
+(
+    user_CacheStats_t* statsPtr     ///< [OUT] Statistics.
+)
+{
+    LOCK_ID_CACHE
 
-    return r;
+    *statsPtr = IdCacheStats;
+    statsPtr->numEntries = (IdCacheMap == NULL ? 0 : le_hashmap_Size(IdCacheMap));
+    statsPtr->isEnabled = IsIdCacheWatching;
+
+    UNLOCK_ID_CACHE
 }
 
 
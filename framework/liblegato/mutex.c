@@ -27,6 +27,13 @@
  *    - Each Mutex object keeps track of its lock count.
  *  -# What type of mutex is a given mutex? (recursive?)
  *    - Stored in each Mutex object as a boolean flag.
+ *  -# How often is a given mutex contended, and for how long do threads wait for it?
+ *    - Each Mutex object counts its acquisitions, contended acquisitions, and the total and
+ *      maximum time spent waiting for it.
+ *
+ * To keep the cost of those diagnostics down, locking first tries to grab the pthreads mutex
+ * without blocking.  Only if that fails does the thread go on the mutex's waiting list and measure
+ * how long it waits.  The statistics are protected by the mutex itself, like the lock count.
  *
  * Copyright (C) Sierra Wireless Inc.
  */
@@ -173,6 +180,10 @@ le_mutex_Ref_t CreateMutex
     mutexPtr->lockedByThreadLink = LE_DLS_LINK_INIT;
     mutexPtr->waitingList = LE_DLS_LIST_INIT;
     pthread_mutex_init(&mutexPtr->waitingListMutex, NULL);  // Default attributes = Fast mutex.
+    mutexPtr->acquireCount = 0;
+    mutexPtr->contendedCount = 0;
+    mutexPtr->totalWaitUs = 0;
+    mutexPtr->maxWaitUs = 0;
 #endif
     mutexPtr->isRecursive = isRecursive;
     mutexPtr->lockCount = 0;
@@ -215,6 +226,7 @@ le_mutex_Ref_t CreateMutex
     // Add the mutex to the process's Mutex List.
     LOCK_MUTEX_LIST();
     le_dls_Queue(&MutexList, &mutexPtr->mutexListLink);
+    MutexListChangeCount++;
     UNLOCK_MUTEX_LIST();
 
     return mutexPtr;
@@ -263,6 +275,54 @@ static void RemoveFromWaitingList
 
     perThreadRecPtr->waitingOnMutex = NULL;
 }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block until a mutex that is held by another thread can be locked.
+ *
+ * While blocked, the thread is on the mutex's waiting list.  Once the lock is acquired, the time
+ * spent waiting is added to the mutex's contention statistics.
+ *
+ * @return The result of pthread_mutex_lock().
+ */
+//--------------------------------------------------------------------------------------------------
+static int WaitForLock
+(
+    Mutex_t*            mutexPtr,
+    mutex_ThreadRec_t*  perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    if (perThreadRecPtr)
+    {
+        AddToWaitingList(mutexPtr, perThreadRecPtr);
+    }
+
+    int result = pthread_mutex_lock(&mutexPtr->mutex);
+
+    if (perThreadRecPtr)
+    {
+        RemoveFromWaitingList(mutexPtr, perThreadRecPtr);
+    }
+
+    if (result == 0)
+    {
+        le_clk_Time_t waitTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+        uint64_t waitUs = (uint64_t)waitTime.sec * 1000000 + waitTime.usec;
+
+        mutexPtr->contendedCount++;
+        mutexPtr->totalWaitUs += waitUs;
+        if (waitUs > mutexPtr->maxWaitUs)
+        {
+            mutexPtr->maxWaitUs = (waitUs > UINT32_MAX) ? UINT32_MAX : (uint32_t)waitUs;
+        }
+    }
+
+    return result;
+}
 #endif
 
 //--------------------------------------------------------------------------------------------------
@@ -397,6 +457,22 @@ size_t** mutex_GetMutexListChgCntRef
 }
 
 
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the mutex list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* mutex_GetMutexList
+(
+    void
+)
+{
+    return (&MutexList);
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the Mutex module.
@@ -512,6 +588,7 @@ void le_mutex_Delete
     // Remove the Mutex object from the Mutex List.
     LOCK_MUTEX_LIST();
     le_dls_Remove(&MutexList, &mutexRef->mutexListLink);
+    MutexListChangeCount++;
     UNLOCK_MUTEX_LIST();
 
     // Destroy the pthreads mutex.
@@ -553,19 +630,15 @@ void le_mutex_Lock
     mutex_ThreadRec_t* perThreadRecPtr = thread_TryGetMutexRecPtr();
 
 #if LE_CONFIG_LINUX_TARGET_TOOLS
-    if (perThreadRecPtr)
+    // Only go through the waiting list if the mutex is held by someone (possibly this thread,
+    // in which case pthread_mutex_lock() reports the deadlock).
+    result = pthread_mutex_trylock(&mutexRef->mutex);
+    if (result == EBUSY)
     {
-        AddToWaitingList(mutexRef, perThreadRecPtr);
+        result = WaitForLock(mutexRef, perThreadRecPtr);
     }
-#endif
-
+#else
     result = pthread_mutex_lock(&mutexRef->mutex);
-
-#if LE_CONFIG_LINUX_TARGET_TOOLS
-    if (perThreadRecPtr)
-    {
-        RemoveFromWaitingList(mutexRef, perThreadRecPtr);
-    }
 #endif
 
     if (result == 0)
@@ -584,6 +657,10 @@ void le_mutex_Lock
 
         // Update the lock count.
         mutexRef->lockCount++;
+
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+        mutexRef->acquireCount++;
+#endif
     }
     else
     {
@@ -641,6 +718,10 @@ le_result_t le_mutex_TryLock
 
         // Update the lock count.
         mutexRef->lockCount++;
+
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+        mutexRef->acquireCount++;
+#endif
     }
     else if (result == EBUSY)
     {
@@ -25,6 +25,10 @@ typedef struct le_mutex
     le_dls_Link_t       lockedByThreadLink; ///< Used to link onto the thread's locked mutexes list.
     le_dls_List_t       waitingList;        ///< List of threads waiting for this mutex.
     pthread_mutex_t     waitingListMutex;   ///< Pthreads mutex used to protect the waiting list.
+    uint64_t            acquireCount;       ///< Number of times the lock was acquired.
+    uint64_t            contendedCount;     ///< Number of times a thread had to wait for the lock.
+    uint64_t            totalWaitUs;        ///< Total time spent waiting for the lock (us).
+    uint32_t            maxWaitUs;          ///< Longest time spent waiting for the lock (us).
 #endif
     bool                isRecursive;        ///< true if recursive, false otherwise.
     int                 lockCount;      ///< Number of lock calls not yet matched by unlock calls.
@@ -72,6 +76,19 @@ size_t** mutex_GetMutexListChgCntRef
 );
 
 
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the mutex list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* mutex_GetMutexList
+(
+    void
+);
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the Mutex module.
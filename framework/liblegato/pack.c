@@ -29,6 +29,7 @@ LE_DEFINE_INLINE bool le_pack_PackChar(uint8_t** bufferPtr, char value);
 LE_DEFINE_INLINE bool le_pack_PackDouble(uint8_t** bufferPtr, double value);
 LE_DEFINE_INLINE bool le_pack_PackResult(uint8_t** bufferPtr, le_result_t value);
 LE_DEFINE_INLINE bool le_pack_PackOnOff(uint8_t** bufferPtr, le_onoff_t value);
+LE_DEFINE_INLINE bool le_pack_IsSafeReference(const void* ref);
 LE_DEFINE_INLINE bool le_pack_PackReference(uint8_t** bufferPtr, const void* ref);
 LE_DEFINE_INLINE bool le_pack_PackStringHeader(uint8_t** bufferPtr, size_t stringLen);
 LE_DEFINE_INLINE bool le_pack_PackString(uint8_t** bufferPtr,
@@ -8,6 +8,7 @@
 
 #include "legato.h"
 #include "clock.h"
+#include "eventProfile.h"
 #include "thread.h"
 #include "timer.h"
 
@@ -421,7 +422,26 @@ static void ProcessExpiredTimer
     // call the optional expiry handler function
     if ( expiredTimer->handlerRef != NULL )
     {
-        expiredTimer->handlerRef(expiredTimer->safeRef);
+#if LE_CONFIG_EVENT_PROFILING
+        event_PerThreadRec_t* eventRecPtr = thread_GetEventRecPtr();
+        eventProf_ThreadRec_t* profileRecPtr = eventRecPtr->profileRecPtr;
+        if (profileRecPtr != NULL)
+        {
+            // The handler may delete the timer, so keep what is needed to account the sample.
+            le_timer_ExpiryHandler_t handlerFunc = expiredTimer->handlerRef;
+            char timerName[LIMIT_MAX_TIMER_NAME_BYTES];
+            le_utf8_Copy(timerName, TIMER_NAME(expiredTimer->name), sizeof(timerName), NULL);
+
+            eventProf_BeginHandler(profileRecPtr);
+            handlerFunc(expiredTimer->safeRef);
+            eventProf_EndHandler(profileRecPtr, EVENT_PROF_TYPE_TIMER, (const void*)handlerFunc,
+                                 timerName, eventRecPtr->queueDepth);
+        }
+        else
+#endif
+        {
+            expiredTimer->handlerRef(expiredTimer->safeRef);
+        }
     }
 }
 
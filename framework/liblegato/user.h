@@ -24,6 +24,26 @@ LE_FULL_API void user_Init
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the process's identity cache.
+ *
+ * The user and group lookup functions of this API (user_GetName(), user_GetIDs(), user_GetUid(),
+ * user_GetGid(), user_GetGroupName() and the app variants built on them) cache their results.  The
+ * cache is flushed whenever /etc/passwd, /etc/group or the apps translation table changes.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t hits;          ///< Number of lookups answered from the cache.
+    uint64_t misses;        ///< Number of lookups that read the user or group files.
+    uint64_t flushes;       ///< Number of times the cache was flushed because a file changed.
+    size_t   numEntries;    ///< Number of entries in the cache.
+    bool     isEnabled;     ///< false if the files can't be watched, which disables the cache.
+}
+user_CacheStats_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a user account with the specified name.  A group with the same name as the username will
@@ -281,4 +301,15 @@ LE_FULL_API le_result_t user_GetAppGid
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the statistics of the process's identity cache.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_FULL_API void user_GetCacheStats
+(
+    user_CacheStats_t* statsPtr     ///< [OUT] Statistics.
+);
+
+
 #endif  // LEGATO_SRC_USER_INCLUDE_GUARD
@@ -0,0 +1,350 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event Loop throughput benchmark.
+ *
+ * Several producer threads post events to the main thread's Event Queue as fast as they can,
+ * first as queued functions, then as publish-subscribe event reports.  The main thread checks
+ * that every event is received exactly once and in order for each producer, and logs the
+ * throughput.  Then the round-trip latency of a queued function between two idle threads is
+ * measured.
+ *
+ * Producers post their events in bursts and wait for the consumer to reach the end of each burst
+ * before posting the next, which bounds the number of outstanding reports.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+/// Number of producer threads.
+#define PRODUCER_COUNT          4
+
+/// Number of events posted by each producer in each phase.
+#ifdef LE_CONFIG_REDUCE_FOOTPRINT
+#   define EVENTS_PER_PRODUCER  5000
+#else
+#   define EVENTS_PER_PRODUCER  100000
+#endif
+
+/// Number of events a producer posts before waiting for the consumer to catch up.
+#define BURST_SIZE              256
+
+/// Number of queued function round-trips in the latency phase.
+#ifdef LE_CONFIG_REDUCE_FOOTPRINT
+#   define ROUND_TRIP_COUNT     1000
+#else
+#   define ROUND_TRIP_COUNT     20000
+#endif
+
+/// Total number of events received by the consumer in each phase.
+#define TOTAL_EVENTS            (PRODUCER_COUNT * EVENTS_PER_PRODUCER)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark phases.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PHASE_QUEUED_FUNC,      ///< Producers use le_event_QueueFunctionToThread().
+    PHASE_EVENT_REPORT,     ///< Producers use le_event_Report().
+    PHASE_ROUND_TRIP        ///< Ping-pong between the main thread and an echo thread.
+}
+Phase_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event report payload.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t producerIndex;     ///< Index of the producer that posted the event.
+    uint32_t seq;               ///< Sequence number of the event for this producer.
+}
+Payload_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Producer state.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t        index;      ///< Index of the producer.
+    le_sem_Ref_t    burstSem;   ///< Posted by the consumer at the end of each burst.
+    uint32_t        nextSeq;    ///< Next sequence number expected by the consumer.
+}
+Producer_t;
+
+static Producer_t Producers[PRODUCER_COUNT];
+
+static le_thread_Ref_t ConsumerThread;
+static le_thread_Ref_t EchoThread;
+static le_event_Id_t PayloadEventId;
+
+static Phase_t CurrentPhase;
+static uint32_t ReceivedCount;
+static uint32_t OutOfOrderCount;
+static uint32_t RoundTripCount;
+static le_clk_Time_t StartTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since StartTime, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedUs
+(
+    void
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+
+    return ((uint64_t)elapsed.sec * 1000000) + elapsed.usec;
+}
+
+
+static void StartPhase(Phase_t phase);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account for one event received by the consumer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ConsumeEvent
+(
+    uint32_t producerIndex,
+    uint32_t seq
+)
+{
+    Producer_t* producerPtr = &Producers[producerIndex];
+
+    if (seq != producerPtr->nextSeq)
+    {
+        OutOfOrderCount++;
+    }
+    producerPtr->nextSeq = seq + 1;
+
+    // Let the producer post its next burst.
+    if ((seq + 1) % BURST_SIZE == 0)
+    {
+        le_sem_Post(producerPtr->burstSem);
+    }
+
+    if (++ReceivedCount < TOTAL_EVENTS)
+    {
+        return;
+    }
+
+    uint64_t elapsedUs = GetElapsedUs();
+
+    LE_TEST_OK(OutOfOrderCount == 0, "%s: all events received in order",
+               (CurrentPhase == PHASE_QUEUED_FUNC) ? "queued functions" : "event reports");
+    LE_TEST_INFO("%s: %u events from %d threads in %" PRIu64 " us (%" PRIu64 " events/s)",
+                 (CurrentPhase == PHASE_QUEUED_FUNC) ? "queued functions" : "event reports",
+                 TOTAL_EVENTS, PRODUCER_COUNT, elapsedUs,
+                 (elapsedUs > 0) ? ((uint64_t)TOTAL_EVENTS * 1000000 / elapsedUs) : 0);
+
+    StartPhase(CurrentPhase + 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queued function run by the consumer for each event of the queued function phase.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueuedFunc
+(
+    void* param1Ptr,    ///< Producer index.
+    void* param2Ptr     ///< Sequence number.
+)
+{
+    ConsumeEvent((uint32_t)(uintptr_t)param1Ptr, (uint32_t)(uintptr_t)param2Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler run by the consumer for each event of the event report phase.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PayloadHandler
+(
+    void* reportPtr
+)
+{
+    Payload_t* payloadPtr = reportPtr;
+
+    ConsumeEvent(payloadPtr->producerIndex, payloadPtr->seq);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Producer thread main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ProducerMain
+(
+    void* contextPtr    ///< Producer state.
+)
+{
+    Producer_t* producerPtr = contextPtr;
+    Payload_t payload = { .producerIndex = producerPtr->index };
+
+    for (payload.seq = 0; payload.seq < EVENTS_PER_PRODUCER; payload.seq++)
+    {
+        if (CurrentPhase == PHASE_QUEUED_FUNC)
+        {
+            le_event_QueueFunctionToThread(ConsumerThread,
+                                           QueuedFunc,
+                                           (void*)(uintptr_t)payload.producerIndex,
+                                           (void*)(uintptr_t)payload.seq);
+        }
+        else
+        {
+            le_event_Report(PayloadEventId, &payload, sizeof(payload));
+        }
+
+        if ((payload.seq + 1) % BURST_SIZE == 0)
+        {
+            le_sem_Wait(producerPtr->burstSem);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ping queued to the echo thread; queues a pong back to the main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Pong(void* param1Ptr, void* param2Ptr);
+
+static void Ping
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_event_QueueFunctionToThread(ConsumerThread, Pong, param1Ptr, param2Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pong queued back to the main thread; starts the next round-trip.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Pong
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    LE_UNUSED(param1Ptr);
+    LE_UNUSED(param2Ptr);
+
+    if (++RoundTripCount < ROUND_TRIP_COUNT)
+    {
+        le_event_QueueFunctionToThread(EchoThread, Ping, NULL, NULL);
+        return;
+    }
+
+    uint64_t elapsedUs = GetElapsedUs();
+
+    LE_TEST_OK(true, "round-trips complete");
+    LE_TEST_INFO("round-trip: %u queued function round-trips in %" PRIu64 " us"
+                 " (%" PRIu64 " ns per round-trip)",
+                 ROUND_TRIP_COUNT, elapsedUs, elapsedUs * 1000 / ROUND_TRIP_COUNT);
+
+    LE_TEST_EXIT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Echo thread main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* EchoMain
+(
+    void* contextPtr
+)
+{
+    LE_UNUSED(contextPtr);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a benchmark phase.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartPhase
+(
+    Phase_t phase
+)
+{
+    int i;
+
+    CurrentPhase = phase;
+    ReceivedCount = 0;
+    OutOfOrderCount = 0;
+    StartTime = le_clk_GetRelativeTime();
+
+    if (phase == PHASE_ROUND_TRIP)
+    {
+        RoundTripCount = 0;
+        le_event_QueueFunctionToThread(EchoThread, Ping, NULL, NULL);
+        return;
+    }
+
+    for (i = 0; i < PRODUCER_COUNT; i++)
+    {
+        char name[16];
+
+        Producers[i].nextSeq = 0;
+
+        snprintf(name, sizeof(name), "producer%d", i);
+        le_thread_Start(le_thread_Create(name, ProducerMain, &Producers[i]));
+    }
+}
+
+
+COMPONENT_INIT
+{
+    int i;
+
+    LE_TEST_PLAN(3);
+
+    LE_TEST_INFO("======== BEGIN EVENT LOOP THROUGHPUT TEST ========");
+
+    ConsumerThread = le_thread_GetCurrent();
+
+    PayloadEventId = le_event_CreateId("Payload", sizeof(Payload_t));
+    le_event_AddHandler("Payload", PayloadEventId, PayloadHandler);
+
+    for (i = 0; i < PRODUCER_COUNT; i++)
+    {
+        char name[16];
+
+        snprintf(name, sizeof(name), "burst%d", i);
+        Producers[i].index = i;
+        Producers[i].burstSem = le_sem_Create(name, 0);
+    }
+
+    EchoThread = le_thread_Create("echo", EchoMain, NULL);
+    le_thread_Start(EchoThread);
+
+    StartPhase(PHASE_QUEUED_FUNC);
+}
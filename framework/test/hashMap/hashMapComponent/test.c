@@ -597,6 +597,13 @@ void TestLongIntHashMap(le_hashmap_Ref_t map)
     LE_TEST(NULL != rval);
     LE_TEST((*((uint64_t*) rval) == ival2) && (le_hashmap_Size(map) == 1));
 
+    // Keys differing only in their upper 32 bits are distinct
+    uint64_t ikey2 = ikey1 + (1ULL << 32);
+    rval = insertRetrieve(map, &ikey2, &ival1);
+    LE_TEST(NULL != rval);
+    LE_TEST((*((uint64_t*) rval) == ival1) && (le_hashmap_Size(map) == 2));
+    LE_TEST(*((uint64_t*) le_hashmap_Get(map, &ikey1)) == ival2);
+
     le_hashmap_RemoveAll(map);
     LE_TEST(le_hashmap_isEmpty(map));
 
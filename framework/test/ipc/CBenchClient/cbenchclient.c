@@ -0,0 +1,151 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * IPC benchmark client.
+ *
+ * Calls each ipcBench function in a tight loop and logs the average round-trip time and the CPU
+ * time the client spends per call, which is where the generated packing code runs.  Build the
+ * interface once normally and once with ifgen's --no-fixed-prefix to compare copying the
+ * fixed-size start of messages in one go against packing parameters one by one.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+#include <time.h>
+
+/// Number of calls made to each function.
+#ifdef LE_CONFIG_REDUCE_FOOTPRINT
+#   define CALL_COUNT   2000
+#else
+#   define CALL_COUNT   50000
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function making one call and returning true if the result is the expected one.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef bool (*CallFunc_t)(uint32_t i);
+
+static bool CallGetSignalQuality
+(
+    uint32_t i
+)
+{
+    uint32_t quality = 0;
+
+    LE_UNUSED(i);
+    return (ipcBench_GetSignalQuality(&quality) == LE_OK) && (quality == 4);
+}
+
+static bool CallSetPreferences
+(
+    uint32_t i
+)
+{
+    return ipcBench_SetPreferences(IPCBENCH_RAT_BIT_LTE | IPCBENCH_RAT_BIT_UMTS,
+                                   0x0000000100080045ull,
+                                   true,
+                                   i + 1) == LE_OK;
+}
+
+static bool CallGetLocation
+(
+    uint32_t i
+)
+{
+    int32_t latitude, longitude, hAccuracy;
+    int32_t value = (int32_t)((i << 1) | 1);
+
+    return (ipcBench_GetLocation((ipcBench_SampleRef_t)(size_t)value,
+                                 &latitude, &longitude, &hAccuracy) == LE_OK) &&
+           (latitude == value + 1) && (longitude == value + 2) && (hAccuracy == value + 3);
+}
+
+static bool CallRegister
+(
+    uint32_t i
+)
+{
+    LE_UNUSED(i);
+    return ipcBench_Register(IPCBENCH_RAT_LTE, 208, 1, "Orange F") == LE_OK;
+}
+
+static bool CallSendText
+(
+    uint32_t i
+)
+{
+    LE_UNUSED(i);
+    return ipcBench_SendText("+33612345678", "Temperature alarm on sensor 4") == LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the CPU time used by the calling thread, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetThreadCpuNs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    LE_ASSERT(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Call a function CALL_COUNT times and log the cost per call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Run
+(
+    const char* name,
+    CallFunc_t func
+)
+{
+    uint32_t i;
+    uint32_t failCount = 0;
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    uint64_t startCpuNs = GetThreadCpuNs();
+
+    for (i = 0; i < CALL_COUNT; ++i)
+    {
+        if (!func(i))
+        {
+            ++failCount;
+        }
+    }
+
+    uint64_t cpuNs = GetThreadCpuNs() - startCpuNs;
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    uint64_t elapsedNs = (uint64_t)elapsed.sec * 1000000000ull + (uint64_t)elapsed.usec * 1000;
+
+    LE_TEST_OK(failCount == 0, "%s: %u calls, %u failed", name, CALL_COUNT, failCount);
+    LE_TEST_INFO("%s: %" PRIu64 " ns per round-trip, %" PRIu64 " ns client CPU per call",
+                 name, elapsedNs / CALL_COUNT, cpuNs / CALL_COUNT);
+}
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(5);
+
+    LE_TEST_INFO("======== BEGIN IPC BENCHMARK ========");
+
+    ipcBench_ConnectService();
+
+    Run("GetSignalQuality", CallGetSignalQuality);
+    Run("SetPreferences", CallSetPreferences);
+    Run("GetLocation", CallGetLocation);
+    Run("Register", CallRegister);
+    Run("SendText", CallSendText);
+
+    LE_TEST_INFO("======== END IPC BENCHMARK ========");
+    LE_TEST_EXIT;
+}
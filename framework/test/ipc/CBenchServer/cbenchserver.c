@@ -0,0 +1,94 @@
+/**
+ * Server side of the IPC benchmark.  Every function does as little work as possible so that the
+ * client measures the cost of the messaging itself.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+le_result_t ipcBench_GetSignalQuality
+(
+    uint32_t* qualityPtr
+)
+{
+    *qualityPtr = 4;
+    return LE_OK;
+}
+
+le_result_t ipcBench_SetPreferences
+(
+    ipcBench_RatMask_t ratMask,
+    uint64_t bandMask,
+    bool enable,
+    uint32_t timeout
+)
+{
+    if ((ratMask & IPCBENCH_RAT_BIT_LTE) && (bandMask != 0) && enable && (timeout > 0))
+    {
+        return LE_OK;
+    }
+
+    return LE_BAD_PARAMETER;
+}
+
+le_result_t ipcBench_GetLocation
+(
+    ipcBench_SampleRef_t sampleRef,
+    int32_t* latitudePtr,
+    int32_t* longitudePtr,
+    int32_t* hAccuracyPtr
+)
+{
+    int32_t value = (int32_t)(size_t)sampleRef;
+
+    if (latitudePtr)
+    {
+        *latitudePtr = value + 1;
+    }
+    if (longitudePtr)
+    {
+        *longitudePtr = value + 2;
+    }
+    if (hAccuracyPtr)
+    {
+        *hAccuracyPtr = value + 3;
+    }
+
+    return LE_OK;
+}
+
+le_result_t ipcBench_Register
+(
+    ipcBench_Rat_t rat,
+    uint32_t mcc,
+    uint32_t mnc,
+    const char* LE_NONNULL name
+)
+{
+    if ((rat == IPCBENCH_RAT_LTE) && (mcc == 208) && (mnc == 1) && (name[0] != '\0'))
+    {
+        return LE_OK;
+    }
+
+    return LE_BAD_PARAMETER;
+}
+
+le_result_t ipcBench_SendText
+(
+    const char* LE_NONNULL destination,
+    const char* LE_NONNULL text
+)
+{
+    if ((destination[0] != '\0') && (text[0] != '\0'))
+    {
+        return LE_OK;
+    }
+
+    return LE_BAD_PARAMETER;
+}
+
+COMPONENT_INIT
+{
+}
@@ -0,0 +1,100 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log rate limit test.
+ *
+ * Drives the per-app token bucket of the Log Control Daemon with a simulated clock, and checks
+ * the burst allowance, the refill rate, the cap on the refill and the counting of the dropped
+ * messages against the configured limits.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "logRateLimit.h"
+
+/// Burst allowance and refill rate under test.
+#define BURST           LE_CONFIG_LOG_RATE_LIMIT_BURST
+#define PER_SEC         LE_CONFIG_LOG_RATE_LIMIT_PER_SEC
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tries to log a number of messages at the same time.
+ *
+ * @return Number of messages allowed by the rate limit.
+ */
+//--------------------------------------------------------------------------------------------------
+static int TakeMany
+(
+    logRateLimit_Bucket_t* bucketPtr,
+    le_clk_Time_t now,
+    int count
+)
+{
+    int taken = 0;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (logRateLimit_Take(bucketPtr, now))
+        {
+            taken++;
+        }
+    }
+
+    return taken;
+}
+
+
+COMPONENT_INIT
+{
+    logRateLimit_Bucket_t bucket;
+    le_clk_Time_t now = { .sec = 100, .usec = 0 };
+    const le_clk_Time_t halfSecond = { .sec = 0, .usec = 500000 };
+    const le_clk_Time_t hour = { .sec = 3600, .usec = 0 };
+    uint64_t droppedCount;
+    int taken;
+
+    LE_TEST_PLAN(8);
+
+    LE_TEST_INFO("======== BEGIN LOG RATE LIMIT TEST ========");
+    LE_TEST_INFO("burst %d messages, refill %d messages per second", BURST, PER_SEC);
+
+    logRateLimit_Init(&bucket, now);
+
+    taken = TakeMany(&bucket, now, BURST);
+    LE_TEST_OK(taken == BURST, "burst of %d messages allowed (%d)", BURST, taken);
+
+    LE_TEST_OK(!logRateLimit_Take(&bucket, now), "message over the burst dropped");
+    LE_TEST_OK((bucket.droppedCount == 1) && (bucket.pendingDropped == 1),
+               "dropped message counted (%" PRIu64 ", %" PRIu32 ")",
+               bucket.droppedCount, bucket.pendingDropped);
+
+    // Half a second earns half a second's worth of messages, and no more.
+    now = le_clk_Add(now, halfSecond);
+    droppedCount = bucket.droppedCount;
+    taken = TakeMany(&bucket, now, PER_SEC);
+    LE_TEST_OK(taken == PER_SEC / 2, "%d messages allowed after 0.5 s (%d)", PER_SEC / 2, taken);
+    LE_TEST_OK(bucket.droppedCount == droppedCount + PER_SEC - taken,
+               "messages over the refill counted (%" PRIu64 ")", bucket.droppedCount);
+
+    // A long quiet period refills the bucket up to the burst allowance only.
+    now = le_clk_Add(now, hour);
+    droppedCount = bucket.droppedCount;
+    taken = TakeMany(&bucket, now, BURST + 10);
+    LE_TEST_OK(taken == BURST, "refill capped at the burst allowance (%d)", taken);
+    LE_TEST_OK(bucket.droppedCount == droppedCount + 10,
+               "messages over the burst counted (%" PRIu64 ")", bucket.droppedCount);
+
+    // The pending count is what the next summary reports; the total keeps growing.
+    bucket.pendingDropped = 0;
+    droppedCount = bucket.droppedCount;
+    LE_TEST_OK(   !logRateLimit_Take(&bucket, now)
+               && (bucket.pendingDropped == 1)
+               && (bucket.droppedCount == droppedCount + 1),
+               "pending count restarts after a summary");
+
+    LE_TEST_INFO("======== END LOG RATE LIMIT TEST ========");
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,185 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Identity cache test and benchmark.
+ *
+ * Creates the users of NUM_APPS apps, then resolves the credentials of each app the way the
+ * framework daemons do when a client opens a session (user name for the Service Directory, app
+ * name for the Config Tree).  The first pass reads the user files, the following ones are answered
+ * by the cache.  Then checks that a user deleted by another process is no longer resolved, and
+ * deletes the users.
+ *
+ * Must be run as root.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "limit.h"
+#include "user.h"
+
+/// Number of apps whose users are created.
+#define NUM_APPS            200
+
+/// Number of passes over all the apps once the cache is warm.
+#define NUM_WARM_PASSES     20
+
+/// Prefix of the names of the apps.
+#define APP_NAME_PREFIX     "userCacheTest"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * User IDs of the apps.
+ */
+//--------------------------------------------------------------------------------------------------
+static uid_t AppUids[NUM_APPS];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the name of an app.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetAppName
+(
+    int index,
+    char* bufPtr,
+    size_t bufSize
+)
+{
+    LE_ASSERT(snprintf(bufPtr, bufSize, APP_NAME_PREFIX "%03d", index) < bufSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resolves the credentials of every app, as done on session open, and checks the results.
+ *
+ * @return Time taken, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ResolveAll
+(
+    int* errorCountPtr      ///< [IN/OUT] Incremented for each wrong result.
+)
+{
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+    int i;
+
+    for (i = 0; i < NUM_APPS; i++)
+    {
+        char expectedName[LIMIT_MAX_APP_NAME_BYTES];
+        char userName[LIMIT_MAX_USER_NAME_BYTES];
+        char appName[LIMIT_MAX_APP_NAME_BYTES];
+
+        GetAppName(i, expectedName, sizeof(expectedName));
+
+        if (   (user_GetName(AppUids[i], userName, sizeof(userName)) != LE_OK)
+            || (user_GetAppName(AppUids[i], appName, sizeof(appName)) != LE_OK)
+            || (strcmp(appName, expectedName) != 0))
+        {
+            (*errorCountPtr)++;
+        }
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return ((uint64_t)elapsed.sec * 1000000) + elapsed.usec;
+}
+
+
+COMPONENT_INIT
+{
+    char appName[LIMIT_MAX_APP_NAME_BYTES];
+    char userName[LIMIT_MAX_USER_NAME_BYTES];
+    user_CacheStats_t stats;
+    int errorCount = 0;
+    int i;
+
+    LE_TEST_PLAN(6);
+
+    LE_TEST_INFO("======== BEGIN USER IDENTITY CACHE TEST ========");
+
+    user_Init();
+
+    for (i = 0; i < NUM_APPS; i++)
+    {
+        gid_t gid;
+
+        GetAppName(i, appName, sizeof(appName));
+        LE_ASSERT_OK(user_AppNameToUserName(appName, userName, sizeof(userName)));
+
+        le_result_t result = user_Create(userName, &AppUids[i], &gid);
+        if ((result != LE_OK) && (result != LE_DUPLICATE))
+        {
+            errorCount++;
+        }
+    }
+    LE_TEST_OK(errorCount == 0, "created the users of %d apps", NUM_APPS);
+
+    // The users were just created, so this pass reads the files.
+    errorCount = 0;
+    uint64_t coldUs = ResolveAll(&errorCount);
+
+    uint64_t warmUs = 0;
+    for (i = 0; i < NUM_WARM_PASSES; i++)
+    {
+        warmUs += ResolveAll(&errorCount);
+    }
+    warmUs /= NUM_WARM_PASSES;
+
+    LE_TEST_OK(errorCount == 0, "resolved the credentials of %d apps %d times",
+               NUM_APPS, NUM_WARM_PASSES + 1);
+
+    user_GetCacheStats(&stats);
+    uint64_t lookups = stats.hits + stats.misses;
+    LE_TEST_OK(stats.isEnabled && (stats.hits >= 2 * NUM_APPS * NUM_WARM_PASSES),
+               "cache hits: %" PRIu64 ", misses: %" PRIu64 " (%.1f%% hit rate), flushes: %" PRIu64
+               ", entries: %" PRIuS,
+               stats.hits, stats.misses, (lookups == 0) ? 0.0 : (100.0 * stats.hits / lookups),
+               stats.flushes, stats.numEntries);
+
+    LE_TEST_INFO("session open credentials: cold %.2f us, cached %.2f us (%" PRIu64 "x)",
+                 (double)coldUs / NUM_APPS,
+                 (double)warmUs / NUM_APPS,
+                 (warmUs == 0 ? 0 : coldUs / warmUs));
+
+    // Delete the first app's user from another process: the cache must notice.
+    GetAppName(0, appName, sizeof(appName));
+    LE_ASSERT_OK(user_AppNameToUserName(appName, userName, sizeof(userName)));
+
+    pid_t pid = fork();
+    LE_FATAL_IF(pid < 0, "fork() failed. %m");
+    if (pid == 0)
+    {
+        _exit(user_Delete(userName) == LE_OK ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    int status;
+    LE_ASSERT(waitpid(pid, &status, 0) == pid);
+    LE_TEST_OK(WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS),
+               "deleted '%s' from another process", userName);
+
+    char nameBuf[LIMIT_MAX_USER_NAME_BYTES];
+    uid_t uid;
+    LE_TEST_OK(   (user_GetName(AppUids[0], nameBuf, sizeof(nameBuf)) == LE_NOT_FOUND)
+               && (user_GetUid(userName, &uid) == LE_NOT_FOUND),
+               "deleted user no longer resolved");
+
+    errorCount = 0;
+    for (i = 1; i < NUM_APPS; i++)
+    {
+        GetAppName(i, appName, sizeof(appName));
+        LE_ASSERT_OK(user_AppNameToUserName(appName, userName, sizeof(userName)));
+
+        if (user_Delete(userName) != LE_OK)
+        {
+            errorCount++;
+        }
+    }
+    LE_TEST_OK(errorCount == 0, "deleted the users");
+
+    LE_TEST_INFO("======== END USER IDENTITY CACHE TEST ========");
+
+    LE_TEST_EXIT;
+}
@@ -483,4 +483,119 @@ void RemoveFile
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the whole contents of a file.
+ *
+ * @return true if the file was read, false if it doesn't exist or couldn't be read.
+ **/
+//--------------------------------------------------------------------------------------------------
+bool ReadFile
+(
+    const std::string& path,
+    std::string& contents   ///< [OUT] Contents of the file.
+)
+{
+    std::ifstream inputStream(path, std::ifstream::binary);
+
+    if (!inputStream.is_open())
+    {
+        return false;
+    }
+
+    std::ostringstream buffer;
+    buffer << inputStream.rdbuf();
+
+    if (inputStream.bad())
+    {
+        return false;
+    }
+
+    contents = buffer.str();
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Constructor.  Opens the new version of the generated file for writing.
+ **/
+//--------------------------------------------------------------------------------------------------
+GeneratedFile_t::GeneratedFile_t
+(
+    const std::string& path ///< Path to the generated file.
+)
+:   std::ofstream(path + ".new", std::ofstream::trunc),
+    path(path),
+    newPath(path + ".new")
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor.  Deletes the new version if it wasn't committed.
+ **/
+//--------------------------------------------------------------------------------------------------
+GeneratedFile_t::~GeneratedFile_t
+(
+)
+{
+    if (is_open())
+    {
+        close();
+        unlink(newPath.c_str());
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the stream and replace the generated file with the new version, unless they have the same
+ * contents.
+ *
+ * @return true if the file was replaced, false if it was left as it was.
+ **/
+//--------------------------------------------------------------------------------------------------
+bool GeneratedFile_t::Commit
+(
+)
+{
+    close();
+
+    if (fail())
+    {
+        unlink(newPath.c_str());
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to write file '%s'."), newPath)
+        );
+    }
+
+    struct stat oldStat;
+    struct stat newStat;
+
+    // Only compare the contents if the sizes are the same.
+    if (   (stat(path.c_str(), &oldStat) == 0)
+        && (stat(newPath.c_str(), &newStat) == 0)
+        && (oldStat.st_size == newStat.st_size)
+        && S_ISREG(oldStat.st_mode))
+    {
+        std::string oldContents;
+        std::string newContents;
+
+        if (   ReadFile(path, oldContents)
+            && ReadFile(newPath, newContents)
+            && (oldContents == newContents))
+        {
+            RemoveFile(newPath);
+            return false;
+        }
+    }
+
+    RenameFile(newPath, path);
+
+    return true;
+}
+
 } // namespace file
@@ -198,6 +198,47 @@ void RemoveFile
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the whole contents of a file.
+ *
+ * @return true if the file was read, false if it doesn't exist or couldn't be read.
+ **/
+//--------------------------------------------------------------------------------------------------
+bool ReadFile
+(
+    const std::string& path,
+    std::string& contents   ///< [OUT] Contents of the file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Output stream for a generated file.  The contents are written to a new version of the file, which
+ * replaces the file when Commit() is called, unless they are the same.  The file is left alone in
+ * that case, so it keeps its timestamp and ninja doesn't rebuild everything that depends on it.
+ * The new version is deleted if the stream is destroyed without being committed.
+ **/
+//--------------------------------------------------------------------------------------------------
+class GeneratedFile_t : public std::ofstream
+{
+    public:
+
+        GeneratedFile_t(const std::string& path);
+        ~GeneratedFile_t();
+
+        /// Close the stream and replace the file with the new version if they differ.
+        /// @return true if the file was replaced.
+        /// @throw mk::Exception_t if something goes wrong.
+        bool Commit();
+
+    private:
+
+        std::string path;       ///< Path to the generated file.
+        std::string newPath;    ///< Path to the new version of the file.
+};
+
+
 } // namespace file
 
 #endif // LEGATO_DEFTOOLS_FILE_H_INCLUDE_GUARD
@@ -527,6 +527,70 @@ static void ModelKernelModules
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the .adef and .mdef files of the apps and kernel modules listed in the .sdef file, and
+ * everything they refer to, on several threads at once.  The files are found the same way as
+ * ModelApp() and ModelKernelModule() find them.  Binary apps are left alone.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrefetchDefFiles
+(
+    const std::list<const parseTree::CompoundItem_t*>& appsSections,
+    const std::list<const parseTree::CompoundItem_t*>& kernelModulesSections,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::list<std::string> defFilePaths;
+
+    // Lambda function that adds a file to the list, if it can be found.
+    auto addFile = [&defFilePaths](const std::string& filePath,
+                                   const std::list<std::string>& searchDirs)
+        {
+            auto foundPath = file::FindFile(filePath, searchDirs);
+            if (!foundPath.empty())
+            {
+                defFilePaths.push_back(foundPath);
+            }
+        };
+
+    for (auto sectionPtr : appsSections)
+    {
+        auto appsSectionPtr = dynamic_cast<const parseTree::CompoundItemList_t*>(sectionPtr);
+
+        for (auto itemPtr : appsSectionPtr->Contents())
+        {
+            const auto appSpec = path::Unquote(DoSubstitution(itemPtr->firstTokenPtr));
+
+            if (path::HasSuffix(appSpec, ".adef"))
+            {
+                addFile(appSpec, buildParams.appDirs);
+            }
+            else if (!path::HasSuffix(appSpec, ".app"))
+            {
+                addFile(appSpec + ".adef", buildParams.appDirs);
+            }
+        }
+    }
+
+    for (auto sectionPtr : kernelModulesSections)
+    {
+        auto moduleSectionPtr = dynamic_cast<const parseTree::CompoundItemList_t*>(sectionPtr);
+
+        for (auto itemPtr : moduleSectionPtr->Contents())
+        {
+            const auto moduleSpec = path::Unquote(DoSubstitution(itemPtr->firstTokenPtr));
+
+            addFile(path::HasSuffix(moduleSpec, ".mdef") ? moduleSpec : moduleSpec + ".mdef",
+                    buildParams.moduleDirs);
+        }
+    }
+
+    parser::prefetch::Run(defFilePaths, buildParams);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Exract the server side details from a bindings section in the parse tree.
@@ -1511,6 +1575,10 @@ model::System_t* GetSystem
     // these will modify the build parameters.
     buildParams.FinishConfig();
 
+    // Parse the definition files of the apps and kernel modules ahead of time, concurrently.
+    // This must be done after all search directories have been parsed.
+    PrefetchDefFiles(appsSections, kernelModulesSections, buildParams);
+
     // Process all the "apps:" sections.  This must be done after all interface search directories
     // have been parsed.
     ModelApps(systemPtr, appsSections, buildParams);
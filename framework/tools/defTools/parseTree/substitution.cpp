@@ -134,6 +134,7 @@ static void EvalVar
     std::string& processed,             ///< The string we will dump the var value into.
     const std::string& original,        ///< The original string we pulled the name from.
     const std::string& varName,         ///< The name of the variable we extracted.
+    const std::string* curDirPtr,       ///< Value of CURDIR, or NULL to read it from the env.
     std::set<std::string>* usedVarsPtr  ///< Record the found name in this set, if not null.
 )
 //--------------------------------------------------------------------------------------------------
@@ -149,7 +150,14 @@ static void EvalVar
         usedVarsPtr->insert(varName);
     }
 
-    processed.append(envVars::Get(varName));
+    if ((curDirPtr != NULL) && (varName == "CURDIR"))
+    {
+        processed.append(*curDirPtr);
+    }
+    else
+    {
+        processed.append(envVars::Get(varName));
+    }
 }
 
 
@@ -169,6 +177,7 @@ static size_t HandleBracketVar
     const std::string& original,        ///< The string to extract a var name from.
     std::string& processed,             ///< The string we will dump the var value into.
     size_t begin,                       ///< Start name extraction from here.
+    const std::string* curDirPtr,       ///< Value of CURDIR, or NULL to read it from the env.
     std::set<std::string>* usedVarsPtr  ///< Record the found name in this set, if not null.
 )
 //--------------------------------------------------------------------------------------------------
@@ -182,7 +191,7 @@ static size_t HandleBracketVar
 
     auto varName = ExtractVarName(original, begin, end - begin);
 
-    EvalVar(processed, original, varName, usedVarsPtr);
+    EvalVar(processed, original, varName, curDirPtr, usedVarsPtr);
 
     return end + 1;
 }
@@ -204,6 +213,7 @@ static size_t HandleVar
     const std::string& original,        ///< The string to extract a var name from.
     std::string& processed,             ///< The string we will dump the var value into.
     size_t begin,                       ///< Start name extraction from here.
+    const std::string* curDirPtr,       ///< Value of CURDIR, or NULL to read it from the env.
     std::set<std::string>* usedVarsPtr  ///< Record the found name in this set, if not null.
 )
 //--------------------------------------------------------------------------------------------------
@@ -211,7 +221,7 @@ static size_t HandleVar
     size_t end = FindFirstNotNameChar(original, begin);
     auto varName = original.substr(begin, end - begin);
 
-    EvalVar(processed, original, varName, usedVarsPtr);
+    EvalVar(processed, original, varName, curDirPtr, usedVarsPtr);
 
     return end;
 }
@@ -225,9 +235,10 @@ static size_t HandleVar
  * @return The converted string.
  **/
 //--------------------------------------------------------------------------------------------------
-static std::string DoSubstitution
+static std::string SubstituteVars
 (
     const std::string& original,        ///< Original string to subsitute variables in.
+    const std::string* curDirPtr,       ///< Value of CURDIR, or NULL to read it from the env.
     std::set<std::string>* usedVarsPtr  ///< If not null, record any variables found in original.
 )
 //--------------------------------------------------------------------------------------------------
@@ -255,11 +266,11 @@ static std::string DoSubstitution
         }
         else if (next == '{')
         {
-            begin = HandleBracketVar(original, processed, found + 2, usedVarsPtr);
+            begin = HandleBracketVar(original, processed, found + 2, curDirPtr, usedVarsPtr);
         }
         else if (IsValidFirstChar(next))
         {
-            begin = HandleVar(original, processed, found + 1, usedVarsPtr);
+            begin = HandleVar(original, processed, found + 1, curDirPtr, usedVarsPtr);
         }
         else
         {
@@ -294,28 +305,21 @@ std::string DoSubstitution
 )
 //--------------------------------------------------------------------------------------------------
 {
-    std::string oldDir;
-
     // Check to see if we were given a context to work with...
     if (contentPtr != NULL)
     {
         // Currently we only populate CURDIR.  However in the future we may add other variables based on
         // where the fragment where the text came from.
-        oldDir = envVars::Get("CURDIR");
-        envVars::Set("CURDIR",
-                     path::MakeAbsolute(path::GetContainingDir(contentPtr->filePtr->path)));
-    }
+        // CURDIR is not set in the process environment, because definition files may be parsed
+        // by several threads at once (see parser/prefetch.h).
+        const std::string curDir = path::MakeAbsolute(
+                                                path::GetContainingDir(contentPtr->filePtr->path));
 
-    // Actually subsitute any variables in the string now.
-    auto result = DoSubstitution(originalString, usedVarsPtr);
-
-    // Restore the old value of CURDIR if we had changed it before.
-    if (contentPtr != NULL)
-    {
-        envVars::Set("CURDIR", oldDir);
+        return SubstituteVars(originalString, &curDir, usedVarsPtr);
     }
 
-    return result;
+    // Actually subsitute any variables in the string now.
+    return SubstituteVars(originalString, NULL, usedVarsPtr);
 }
 
 
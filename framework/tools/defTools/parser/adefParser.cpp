@@ -739,9 +739,25 @@ parseTree::AdefFile_t* Parse
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Use the copy parsed ahead of time by the prefetcher, if there is one.
+    auto prefetchedPtr = prefetch::Take(filePath, parseTree::DefFile_t::ADEF, beVerbose);
+    if (prefetchedPtr != NULL)
+    {
+        return static_cast<parseTree::AdefFile_t*>(prefetchedPtr);
+    }
+
+    // Or the copy saved by an earlier run, if nothing it depends on has changed.
+    auto cachedPtr = parseCache::Load(filePath, parseTree::DefFile_t::ADEF, beVerbose);
+    if (cachedPtr != NULL)
+    {
+        return static_cast<parseTree::AdefFile_t*>(cachedPtr);
+    }
+
     parseTree::AdefFile_t* filePtr = new parseTree::AdefFile_t(filePath);
 
+    parseCache::Recorder_t recorder;
     ParseFile(filePtr, beVerbose, internal::ParseSection);
+    recorder.Store(filePtr);
 
     return filePtr;
 }
@@ -24,7 +24,7 @@ namespace api
 //--------------------------------------------------------------------------------------------------
 std::string ParseUseTypesStatement
 (
-    std::ifstream& inputStream
+    std::istream& inputStream
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -81,6 +81,28 @@ void GetDependencies
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Use the dependencies found ahead of time by the prefetcher, if there are any.
+    std::list<std::string> prefetchedDependencies;
+    if (prefetch::TakeApiDependencies(filePath, prefetchedDependencies))
+    {
+        for (auto& dependency : prefetchedDependencies)
+        {
+            handlerFunc(std::move(dependency));
+        }
+        return;
+    }
+
+    // Or the ones saved by an earlier run, if the file hasn't changed since.
+    std::list<std::string> dependencies;
+    if (parseCache::LoadApiDependencies(filePath, dependencies))
+    {
+        for (auto& dependency : dependencies)
+        {
+            handlerFunc(std::move(dependency));
+        }
+        return;
+    }
+
     // Make sure the file exists.
     if (!file::FileExists(filePath))
     {
@@ -89,16 +111,19 @@ void GetDependencies
         );
     }
 
-    std::ifstream inputStream(filePath);
-
-    // Make sure we were able to open the file.
-    if (!inputStream.is_open())
+    // Read the whole file, so that the parse cache records the contents that were actually
+    // scanned.
+    std::string contents;
+    parseCache::FileStamp_t stamp;
+    if (!parseCache::ReadSourceFile(filePath, contents, stamp))
     {
         throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for reading."), filePath)
+            mk::format(LE_I18N("Failed to read from file '%s'."), filePath)
         );
     }
 
+    std::istringstream inputStream(contents);
+
     // Keep looking for USETYPES statements, skipping comments.
     for (int c = inputStream.get(); c != EOF; c = inputStream.get())
     {
@@ -108,6 +133,7 @@ void GetDependencies
             std::string dependency = ParseUseTypesStatement(inputStream);
             if (!dependency.empty())
             {
+                dependencies.push_back(dependency);
                 handlerFunc(std::move(dependency));
             }
         }
@@ -145,12 +171,7 @@ void GetDependencies
         }
     }
 
-    if (inputStream.bad())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to read from file '%s'."), filePath)
-        );
-    }
+    parseCache::StoreApiDependencies(filePath, stamp, dependencies);
 }
 
 
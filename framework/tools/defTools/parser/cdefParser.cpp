@@ -376,9 +376,25 @@ parseTree::CdefFile_t* Parse
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Use the copy parsed ahead of time by the prefetcher, if there is one.
+    auto prefetchedPtr = prefetch::Take(filePath, parseTree::DefFile_t::CDEF, beVerbose);
+    if (prefetchedPtr != NULL)
+    {
+        return static_cast<parseTree::CdefFile_t*>(prefetchedPtr);
+    }
+
+    // Or the copy saved by an earlier run, if nothing it depends on has changed.
+    auto cachedPtr = parseCache::Load(filePath, parseTree::DefFile_t::CDEF, beVerbose);
+    if (cachedPtr != NULL)
+    {
+        return static_cast<parseTree::CdefFile_t*>(cachedPtr);
+    }
+
     parseTree::CdefFile_t* filePtr = new parseTree::CdefFile_t(filePath);
 
+    parseCache::Recorder_t recorder;
     ParseFile(filePtr, beVerbose, internal::ParseSection);
+    recorder.Store(filePtr);
 
     return filePtr;
 }
@@ -27,7 +27,6 @@ Lexer_t::LexerContext_t::LexerContext_t
 )
 //--------------------------------------------------------------------------------------------------
 :   filePtr(filePtr),
-    inputStream(filePtr->path),
     line(1),
     column(0),
     ifNestDepth(0)
@@ -40,22 +39,22 @@ Lexer_t::LexerContext_t::LexerContext_t
             mk::format(LE_I18N("File not found: '%s'."), filePtr->path)
         );
     }
-    if (!inputStream.is_open())
+
+    // Read the whole file, so that the parse cache records the contents that were actually lexed.
+    std::string contents;
+    parseCache::FileStamp_t stamp;
+    if (!parseCache::ReadSourceFile(filePtr->path, contents, stamp))
     {
         throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for reading."), filePtr->path)
+            mk::format(LE_I18N("Failed to read from file '%s'."), filePtr->path)
         );
     }
+    parseCache::NoteFileRead(filePtr->path, stamp);
+
+    inputStream.str(contents);
 
     // Read in the first characters.
     Buffer(2);
-
-    if (inputStream.bad())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to read from file '%s'."), filePtr->path)
-        );
-    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -874,9 +873,12 @@ void Lexer_t::ProcessIncludeDirective
     // First search for include file in the including file's directory, then in the LEGATO_ROOT
     // directory
     auto includePath = file::FindFile(filePath, { curDir });
+    parseCache::NoteSearch(false, filePath, curDir, includePath);
     if (includePath == "")
     {
-        includePath = file::FindFile(filePath, { envVars::Get("LEGATO_ROOT") });
+        auto legatoRoot = envVars::Get("LEGATO_ROOT");
+        includePath = file::FindFile(filePath, { legatoRoot });
+        parseCache::NoteSearch(false, filePath, legatoRoot, includePath);
     }
 
     if (includePath == "")
@@ -1198,7 +1200,9 @@ bool Lexer_t::PullAndEvalBoolExpression
                 std::string fileName = path::Unquote(DoSubstitution(fileNamePtr, &substitutedVars));
                 auto curDir = path::GetContainingDir(context.top().filePtr->path);
 
-                result = (file::FindFile(fileName, { curDir }) != "");
+                auto foundPath = file::FindFile(fileName, { curDir });
+                parseCache::NoteSearch(false, fileName, curDir, foundPath);
+                result = (foundPath != "");
 
                 MarkVarsUsed(substitutedVars, fileNamePtr);
             }
@@ -1211,7 +1215,9 @@ bool Lexer_t::PullAndEvalBoolExpression
                 std::string fileName = path::Unquote(DoSubstitution(fileNamePtr, &substitutedVars));
                 auto curDir = path::GetContainingDir(context.top().filePtr->path);
 
-                result = (file::FindDirectory(fileName, { curDir }) != "");
+                auto foundPath = file::FindDirectory(fileName, { curDir });
+                parseCache::NoteSearch(true, fileName, curDir, foundPath);
+                result = (foundPath != "");
 
                 MarkVarsUsed(substitutedVars, fileNamePtr);
             }
@@ -1252,6 +1258,9 @@ void Lexer_t::MarkVarsUsed
 )
 //--------------------------------------------------------------------------------------------------
 {
+    prefetch::NoteVarsUsed(localUsedVars);
+    parseCache::NoteVarsUsed(localUsedVars);
+
     for (auto const &substitutedVar: localUsedVars)
     {
         // No need to check if variable is already in usedVars list as insert will simply
@@ -2638,6 +2647,12 @@ void Lexer_t::ContinueAfterError
     bool stopAtNewline
 )
 {
+    // Prefetch worker threads don't report errors, the file will be parsed again by the modeller.
+    if (prefetch::IsWorkerThread())
+    {
+        throw e;
+    }
+
     std::cerr << "[ERROR] " << e.what() << std::endl;
 
     if (tokensSinceError < 2)
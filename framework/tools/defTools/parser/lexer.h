@@ -77,7 +77,7 @@ class Lexer_t
         {
             parseTree::DefFileFragment_t* filePtr;  ///< Pointer to the File object for the file being parsed.
 
-            std::ifstream inputStream;      ///< File input stream from which tokens will be matched.
+            std::istringstream inputStream; ///< Contents of the file, from which tokens will be matched.
             std::deque<int> nextChars;      ///< File buffer for characters read from the input
                                             ///< stream but not yet consumed.
             size_t line;                    ///< File line number.
@@ -213,9 +213,25 @@ parseTree::MdefFile_t* Parse
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Use the copy parsed ahead of time by the prefetcher, if there is one.
+    auto prefetchedPtr = prefetch::Take(filePath, parseTree::DefFile_t::MDEF, beVerbose);
+    if (prefetchedPtr != NULL)
+    {
+        return static_cast<parseTree::MdefFile_t*>(prefetchedPtr);
+    }
+
+    // Or the copy saved by an earlier run, if nothing it depends on has changed.
+    auto cachedPtr = parseCache::Load(filePath, parseTree::DefFile_t::MDEF, beVerbose);
+    if (cachedPtr != NULL)
+    {
+        return static_cast<parseTree::MdefFile_t*>(cachedPtr);
+    }
+
     parseTree::MdefFile_t* filePtr = new parseTree::MdefFile_t(filePath);
 
+    parseCache::Recorder_t recorder;
     ParseFile(filePtr, beVerbose, internal::ParseSection);
+    recorder.Store(filePtr);
 
     return filePtr;
 }
@@ -0,0 +1,1123 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file parseCache.cpp  On-disk cache of parsed definition files.
+ *
+ * Each cached file is saved in its own cache entry, named after the MD5 hash of its path.  An
+ * entry is a sequence of numbers and length-prefixed strings:
+ *
+ *  - the cache format version,
+ *  - the path and type of the file,
+ *  - the environment variables and file searches its preprocessor depended on,
+ *  - the files it is made of (the file itself, then the files it includes), each with the size,
+ *    modification time and MD5 hash of the contents the lexer read, and its list of tokens,
+ *  - the included files, as (index of the #include path token, index of the file) pairs,
+ *  - the tree of sections, each item being its content type, the indexes of its first and last
+ *    tokens and its contents.
+ *
+ * Tokens are numbered across all the files, in file order then in the order they were lexed.
+ *
+ * A file whose size and modification time are the same as when it was cached is assumed to be
+ * the same; otherwise it is hashed to check whether its contents have changed.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "defTools.h"
+
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+
+
+namespace parser
+{
+
+namespace parseCache
+{
+
+
+/// Version of the format of the cache entries.  Change it whenever the format or the parse tree
+/// structures change.
+static const size_t FormatVersion = 1;
+
+/// Directory holding the cache entries, or "" if the cache is disabled.
+static std::string CacheDir;
+
+/// Number of definition files looked up in the cache, and number of them found there.
+static std::atomic<size_t> DefFileLookupCount(0);
+static std::atomic<size_t> DefFileHitCount(0);
+
+/// Number of .api files looked up in the cache, and number of them found there.
+static std::atomic<size_t> ApiFileLookupCount(0);
+static std::atomic<size_t> ApiFileHitCount(0);
+
+/// Recorder for the file the calling thread is parsing, or NULL.
+static thread_local Recorder_t* RecorderPtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a number to a cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Put
+(
+    std::string& entry,
+    size_t number
+)
+//--------------------------------------------------------------------------------------------------
+{
+    entry += std::to_string(number);
+    entry += ' ';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a string to a cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Put
+(
+    std::string& entry,
+    const std::string& string
+)
+//--------------------------------------------------------------------------------------------------
+{
+    entry += std::to_string(string.size());
+    entry += ':';
+    entry += string;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the numbers and strings back from a cache entry.  Throws mk::Exception_t if the entry is
+ * truncated or corrupted.
+ */
+//--------------------------------------------------------------------------------------------------
+struct Reader_t
+{
+    const std::string& entry;
+    size_t pos;
+
+    Reader_t(const std::string& entry): entry(entry), pos(0) {}
+
+    size_t GetNumber(char terminator = ' ')
+    {
+        size_t number = 0;
+        size_t start = pos;
+
+        while ((pos < entry.size()) && isdigit(entry[pos]))
+        {
+            number = (number * 10) + (entry[pos] - '0');
+            pos++;
+        }
+
+        if ((pos == start) || (pos >= entry.size()) || (entry[pos] != terminator))
+        {
+            throw mk::Exception_t(LE_I18N("Corrupted parse cache entry."));
+        }
+        pos++;
+
+        return number;
+    }
+
+    std::string GetString()
+    {
+        size_t length = GetNumber(':');
+
+        if (length > (entry.size() - pos))
+        {
+            throw mk::Exception_t(LE_I18N("Corrupted parse cache entry."));
+        }
+
+        std::string string = entry.substr(pos, length);
+        pos += length;
+
+        return string;
+    }
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path to the cache entry for a file.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string GetEntryPath
+(
+    const std::string& filePath,    ///< Absolute path to the cached file.
+    const std::string& suffix       ///< Kind of cache entry.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return path::Combine(CacheDir, md5(filePath) + suffix);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a cache entry.  The entry is written to a temporary file that is then renamed, so other
+ * threads and processes never see a partial entry.  Errors are ignored: the file will just be
+ * parsed again next time.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteEntry
+(
+    const std::string& entryPath,
+    const std::string& entry
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto tempPath = entryPath + ".tmp"
+                  + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream outputStream(tempPath, std::ofstream::trunc | std::ofstream::binary);
+        if (!outputStream.is_open())
+        {
+            return;
+        }
+
+        outputStream << entry;
+        outputStream.close();
+
+        if (outputStream.fail())
+        {
+            unlink(tempPath.c_str());
+            return;
+        }
+    }
+
+    if (rename(tempPath.c_str(), entryPath.c_str()) != 0)
+    {
+        unlink(tempPath.c_str());
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a file's path and stamp to a cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutFileStamp
+(
+    std::string& entry,
+    const std::string& filePath,
+    const FileStamp_t& stamp
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Put(entry, filePath);
+    Put(entry, stamp.size);
+    Put(entry, stamp.mtimeSec);
+    Put(entry, stamp.mtimeNsec);
+    Put(entry, stamp.contentsMd5);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read back the stamp written by PutFileStamp() and check the file still matches it.
+ *
+ * @return true if the file is unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckFileStamp
+(
+    Reader_t& reader,
+    std::string& filePath   ///< [OUT] Path to the file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    filePath = reader.GetString();
+    size_t size = reader.GetNumber();
+    size_t mtimeSec = reader.GetNumber();
+    size_t mtimeNsec = reader.GetNumber();
+    std::string contentsMd5 = reader.GetString();
+
+    struct stat fileStat;
+
+    if ((stat(filePath.c_str(), &fileStat) != 0) || ((size_t)fileStat.st_size != size))
+    {
+        return false;
+    }
+
+    if (   ((size_t)fileStat.st_mtim.tv_sec == mtimeSec)
+        && ((size_t)fileStat.st_mtim.tv_nsec == mtimeNsec))
+    {
+        return true;
+    }
+
+    // Touched, but possibly not changed.
+    std::string contents;
+
+    return file::ReadFile(filePath, contents) && (md5(contents) == contentsMd5);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the whole contents of a file to be parsed, and get its stamp.  The file is stat'ed before it
+ * is read, so a modification made while it is being read changes its modification time after the
+ * one in the stamp.  A modification time less than two seconds old is not recorded, because the
+ * file system may not have the resolution to show another modification made in the same tick; the
+ * contents will be hashed to check the file instead.
+ *
+ * @return true if the file was read, false if it doesn't exist or couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+bool ReadSourceFile
+(
+    const std::string& filePath,    ///< Path to the file.
+    std::string& contents,          ///< [OUT] Contents of the file.
+    FileStamp_t& stamp              ///< [OUT] Stamp of the contents.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat fileStat;
+
+    if ((stat(filePath.c_str(), &fileStat) != 0) || !file::ReadFile(filePath, contents))
+    {
+        return false;
+    }
+
+    stamp.size = contents.size();
+
+    if (fileStat.st_mtim.tv_sec + 2 <= time(NULL))
+    {
+        stamp.mtimeSec = fileStat.st_mtim.tv_sec;
+        stamp.mtimeNsec = fileStat.st_mtim.tv_nsec;
+    }
+    else
+    {
+        stamp.mtimeSec = 0;
+        stamp.mtimeNsec = 0;
+    }
+
+    stamp.contentsMd5 = CacheDir.empty() ? "" : md5(contents);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get all the fragments a definition file is made of: the file itself, then the files it
+ * includes, depth first.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetFragments
+(
+    const parseTree::DefFileFragment_t* fragmentPtr,
+    std::vector<const parseTree::DefFileFragment_t*>& fragments
+)
+//--------------------------------------------------------------------------------------------------
+{
+    fragments.push_back(fragmentPtr);
+
+    for (auto& include : fragmentPtr->includedFiles)
+    {
+        GetFragments(include.second, fragments);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a token reference to a cache entry.  Throws mk::Exception_t if the token isn't in the
+ * token list of any of the file's fragments.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutTokenRef
+(
+    std::string& entry,
+    const std::map<const parseTree::Token_t*, size_t>& tokenIndexes,
+    const parseTree::Token_t* tokenPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto i = tokenIndexes.find(tokenPtr);
+
+    if (i == tokenIndexes.end())
+    {
+        throw mk::Exception_t(LE_I18N("Token not found in parse tree."));
+    }
+
+    Put(entry, i->second);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a section or other compound item, and everything in it, to a cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutItem
+(
+    std::string& entry,
+    const std::map<const parseTree::Token_t*, size_t>& tokenIndexes,
+    const parseTree::CompoundItem_t* itemPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Put(entry, itemPtr->type);
+    PutTokenRef(entry, tokenIndexes, itemPtr->firstTokenPtr);
+    PutTokenRef(entry, tokenIndexes, itemPtr->lastTokenPtr);
+
+    auto tokenListPtr = dynamic_cast<const parseTree::TokenList_t*>(itemPtr);
+
+    if (tokenListPtr != NULL)
+    {
+        Put(entry, tokenListPtr->Contents().size());
+
+        for (auto tokenPtr : tokenListPtr->Contents())
+        {
+            PutTokenRef(entry, tokenIndexes, tokenPtr);
+        }
+    }
+    else
+    {
+        auto itemListPtr = dynamic_cast<const parseTree::CompoundItemList_t*>(itemPtr);
+
+        if (itemListPtr == NULL)
+        {
+            throw mk::Exception_t(LE_I18N("Unknown kind of parse tree item."));
+        }
+
+        Put(entry, itemListPtr->Contents().size());
+
+        for (auto subItemPtr : itemListPtr->Contents())
+        {
+            PutItem(entry, tokenIndexes, subItemPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a token reference back from a cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static parseTree::Token_t* GetTokenRef
+(
+    Reader_t& reader,
+    const std::vector<parseTree::Token_t*>& tokens
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t index = reader.GetNumber();
+
+    if (index >= tokens.size())
+    {
+        throw mk::Exception_t(LE_I18N("Corrupted parse cache entry."));
+    }
+
+    return tokens[index];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rebuild a section or other compound item, and everything in it, from a cache entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static parseTree::CompoundItem_t* GetItem
+(
+    Reader_t& reader,
+    const std::vector<parseTree::Token_t*>& tokens
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto type = static_cast<parseTree::Content_t::Type_t>(reader.GetNumber());
+    auto firstTokenPtr = GetTokenRef(reader, tokens);
+    auto lastTokenPtr = GetTokenRef(reader, tokens);
+    size_t contentCount = reader.GetNumber();
+
+    parseTree::CompoundItem_t* itemPtr;
+
+    switch (type)
+    {
+        case parseTree::Content_t::COMPLEX_SECTION:
+        case parseTree::Content_t::APP:
+        case parseTree::Content_t::MODULE:
+        {
+            parseTree::CompoundItemList_t* itemListPtr;
+
+            if (type == parseTree::Content_t::COMPLEX_SECTION)
+            {
+                itemListPtr = new parseTree::ComplexSection_t(firstTokenPtr);
+            }
+            else if (type == parseTree::Content_t::APP)
+            {
+                itemListPtr = new parseTree::App_t(firstTokenPtr);
+            }
+            else
+            {
+                itemListPtr = new parseTree::Module_t(firstTokenPtr);
+            }
+
+            for (size_t i = 0; i < contentCount; i++)
+            {
+                itemListPtr->AddContent(GetItem(reader, tokens));
+            }
+
+            itemPtr = itemListPtr;
+            break;
+        }
+
+        default:
+        {
+            // Throws if the type is not a token list type.
+            auto tokenListPtr = parseTree::CreateTokenList(type, firstTokenPtr);
+
+            // Bindings and commands already contain their first token.
+            size_t i = tokenListPtr->Contents().size();
+
+            if (i > contentCount)
+            {
+                throw mk::Exception_t(LE_I18N("Corrupted parse cache entry."));
+            }
+
+            for (size_t j = 0; j < i; j++)
+            {
+                (void)GetTokenRef(reader, tokens);
+            }
+
+            for (; i < contentCount; i++)
+            {
+                tokenListPtr->AddContent(GetTokenRef(reader, tokens));
+            }
+
+            itemPtr = tokenListPtr;
+            break;
+        }
+    }
+
+    itemPtr->lastTokenPtr = lastTokenPtr;
+
+    return itemPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty definition file object of a given type.
+ */
+//--------------------------------------------------------------------------------------------------
+static parseTree::DefFile_t* CreateDefFile
+(
+    parseTree::DefFile_t::Type_t type,
+    const std::string& filePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (type)
+    {
+        case parseTree::DefFile_t::CDEF:
+            return new parseTree::CdefFile_t(filePath);
+        case parseTree::DefFile_t::ADEF:
+            return new parseTree::AdefFile_t(filePath);
+        case parseTree::DefFile_t::MDEF:
+            return new parseTree::MdefFile_t(filePath);
+        case parseTree::DefFile_t::SDEF:
+            return new parseTree::SdefFile_t(filePath);
+    }
+
+    throw mk::Exception_t(LE_I18N("Corrupted parse cache entry."));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that everything the preprocessor depended on is still the same.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckPreprocessorInputs
+(
+    Reader_t& reader
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::set<std::string> varNames;
+
+    for (size_t count = reader.GetNumber(); count > 0; count--)
+    {
+        auto name = reader.GetString();
+        auto value = reader.GetString();
+
+        if (envVars::Get(name) != value)
+        {
+            return false;
+        }
+
+        varNames.insert(name);
+    }
+
+    for (size_t count = reader.GetNumber(); count > 0; count--)
+    {
+        bool isDir = (reader.GetNumber() != 0);
+        auto name = reader.GetString();
+        auto dir = reader.GetString();
+        auto result = reader.GetString();
+
+        if (result != (isDir ? file::FindDirectory(name, { dir }) : file::FindFile(name, { dir })))
+        {
+            return false;
+        }
+    }
+
+    // The prefetcher must check them again before handing the parse tree over.
+    prefetch::NoteVarsUsed(varNames);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Rebuild a definition file's parse tree from a cache entry.
+ *
+ * @return Pointer to the parse tree, or NULL if the entry is out of date.
+ */
+//--------------------------------------------------------------------------------------------------
+static parseTree::DefFile_t* ReadDefFile
+(
+    const std::string& entry,
+    const std::string& filePath,
+    parseTree::DefFile_t::Type_t type
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Reader_t reader(entry);
+
+    if (   (reader.GetNumber() != FormatVersion)
+        || (reader.GetString() != filePath)
+        || (reader.GetNumber() != type)
+        || !CheckPreprocessorInputs(reader))
+    {
+        return NULL;
+    }
+
+    size_t fragmentCount = reader.GetNumber();
+
+    if (fragmentCount == 0)
+    {
+        return NULL;
+    }
+
+    std::unique_ptr<parseTree::DefFile_t> defFilePtr;
+    std::vector<parseTree::DefFileFragment_t*> fragments;
+    std::vector<parseTree::Token_t*> tokens;
+
+    try
+    {
+        for (size_t i = 0; i < fragmentCount; i++)
+        {
+            std::string fragmentPath;
+
+            if (!CheckFileStamp(reader, fragmentPath))
+            {
+                throw mk::Exception_t(LE_I18N("Out of date."));
+            }
+
+            parseTree::DefFileFragment_t* fragmentPtr;
+
+            if (i == 0)
+            {
+                defFilePtr.reset(CreateDefFile(type, filePath));
+                fragmentPtr = defFilePtr.get();
+            }
+            else
+            {
+                fragmentPtr = new parseTree::DefFileFragment_t(fragmentPath);
+            }
+            fragments.push_back(fragmentPtr);
+
+            for (size_t count = reader.GetNumber(); count > 0; count--)
+            {
+                auto tokenType = static_cast<parseTree::Token_t::Type_t>(reader.GetNumber());
+                size_t line = reader.GetNumber();
+                size_t column = reader.GetNumber();
+                int curPos = std::stoi(reader.GetString());
+
+                auto tokenPtr = new parseTree::Token_t(tokenType, fragmentPtr, line, column, curPos);
+                tokenPtr->text = reader.GetString();
+                tokens.push_back(tokenPtr);
+            }
+        }
+
+        for (size_t count = reader.GetNumber(); count > 0; count--)
+        {
+            auto tokenPtr = GetTokenRef(reader, tokens);
+            size_t fragmentIndex = reader.GetNumber();
+
+            if ((fragmentIndex == 0) || (fragmentIndex >= fragments.size()))
+            {
+                throw mk::Exception_t(LE_I18N("Corrupted parse cache entry."));
+            }
+
+            tokenPtr->filePtr->includedFiles.insert(
+                std::make_pair(tokenPtr, fragments[fragmentIndex])
+            );
+        }
+
+        for (size_t count = reader.GetNumber(); count > 0; count--)
+        {
+            defFilePtr->sections.push_back(GetItem(reader, tokens));
+        }
+    }
+    catch (std::exception& e)
+    {
+        // The fragments and tokens created so far are leaked, like all parse trees are.
+        return NULL;
+    }
+
+    if (reader.pos != entry.size())
+    {
+        return NULL;
+    }
+
+    return defFilePtr.release();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start using the cache kept in the build's working directory.
+ */
+//--------------------------------------------------------------------------------------------------
+void Enable
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto cacheDir = path::Combine(buildParams.workingDir, "parseCache");
+
+    try
+    {
+        file::MakeDir(cacheDir);
+    }
+    catch (mk::Exception_t& e)
+    {
+        // Work without the cache.
+        return;
+    }
+
+    CacheDir = path::MakeAbsolute(cacheDir);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the parse tree of a definition file from the cache, if it is there and still valid.
+ *
+ * @return Pointer to the parse tree, or NULL if the file must be parsed by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::DefFile_t* Load
+(
+    const std::string& filePath,        ///< Path to the definition file.
+    parseTree::DefFile_t::Type_t type,  ///< Type of the definition file.
+    bool beVerbose                      ///< true if progress messages should be printed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CacheDir.empty())
+    {
+        return NULL;
+    }
+
+    DefFileLookupCount++;
+
+    auto absPath = path::MakeAbsolute(filePath);
+    std::string entry;
+
+    if (!file::ReadFile(GetEntryPath(absPath, ".def"), entry))
+    {
+        return NULL;
+    }
+
+    parseTree::DefFile_t* defFilePtr;
+
+    try
+    {
+        defFilePtr = ReadDefFile(entry, absPath, type);
+    }
+    catch (std::exception& e)
+    {
+        return NULL;
+    }
+
+    if (defFilePtr != NULL)
+    {
+        DefFileHitCount++;
+
+        if (beVerbose)
+        {
+            std::cout << mk::format(LE_I18N("Parsing file: '%s'."), defFilePtr->path)
+                      << std::endl;
+        }
+    }
+
+    return defFilePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start recording for the file the calling thread is about to parse.
+ */
+//--------------------------------------------------------------------------------------------------
+Recorder_t::Recorder_t
+(
+)
+//--------------------------------------------------------------------------------------------------
+:   hasWarnings(false),
+    prevRecorderPtr(RecorderPtr)
+{
+    RecorderPtr = this;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop recording.
+ */
+//--------------------------------------------------------------------------------------------------
+Recorder_t::~Recorder_t
+(
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RecorderPtr = prevRecorderPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the parse tree of the file to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void Recorder_t::Store
+(
+    const parseTree::DefFile_t* defFilePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CacheDir.empty() || hasWarnings)
+    {
+        return;
+    }
+
+    std::string entry;
+
+    Put(entry, FormatVersion);
+    Put(entry, defFilePtr->path);
+    Put(entry, defFilePtr->type);
+
+    Put(entry, usedVars.size());
+    for (auto& var : usedVars)
+    {
+        Put(entry, var.first);
+        Put(entry, var.second);
+    }
+
+    Put(entry, searches.size());
+    for (auto& search : searches)
+    {
+        Put(entry, search.isDir ? 1 : 0);
+        Put(entry, search.name);
+        Put(entry, search.dir);
+        Put(entry, search.result);
+    }
+
+    std::vector<const parseTree::DefFileFragment_t*> fragments;
+    std::map<const parseTree::DefFileFragment_t*, size_t> fragmentIndexes;
+    std::map<const parseTree::Token_t*, size_t> tokenIndexes;
+
+    GetFragments(defFilePtr, fragments);
+
+    Put(entry, fragments.size());
+    for (auto fragmentPtr : fragments)
+    {
+        size_t fragmentIndex = fragmentIndexes.size();
+        fragmentIndexes[fragmentPtr] = fragmentIndex;
+
+        // Only the contents the lexer actually read can be vouched for.
+        auto stampIter = fileStamps.find(fragmentPtr->path);
+        if (stampIter == fileStamps.end())
+        {
+            return;
+        }
+        PutFileStamp(entry, fragmentPtr->path, stampIter->second);
+
+        // Only the last token is known, the list is linked backwards from it.
+        std::vector<const parseTree::Token_t*> fragmentTokens;
+        for (auto tokenPtr = fragmentPtr->lastTokenPtr;
+             tokenPtr != NULL;
+             tokenPtr = tokenPtr->prevPtr)
+        {
+            fragmentTokens.push_back(tokenPtr);
+        }
+
+        Put(entry, fragmentTokens.size());
+        for (auto i = fragmentTokens.rbegin(); i != fragmentTokens.rend(); ++i)
+        {
+            auto tokenPtr = *i;
+
+            size_t tokenIndex = tokenIndexes.size();
+            tokenIndexes[tokenPtr] = tokenIndex;
+
+            Put(entry, tokenPtr->type);
+            Put(entry, tokenPtr->line);
+            Put(entry, tokenPtr->column);
+            Put(entry, std::to_string(tokenPtr->curPos));
+            Put(entry, tokenPtr->text);
+        }
+    }
+
+    try
+    {
+        size_t includeCount = 0;
+        std::string includes;
+
+        for (auto fragmentPtr : fragments)
+        {
+            for (auto& include : fragmentPtr->includedFiles)
+            {
+                PutTokenRef(includes, tokenIndexes, include.first);
+                Put(includes, fragmentIndexes.at(include.second));
+                includeCount++;
+            }
+        }
+
+        Put(entry, includeCount);
+        entry += includes;
+
+        Put(entry, defFilePtr->sections.size());
+        for (auto sectionPtr : defFilePtr->sections)
+        {
+            PutItem(entry, tokenIndexes, sectionPtr);
+        }
+    }
+    catch (mk::Exception_t& e)
+    {
+        // Something that can't be cached, just parse the file every time.
+        return;
+    }
+
+    WriteEntry(GetEntryPath(defFilePtr->path, ".def"), entry);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the preprocessor substituted some environment variables in the file being parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteVarsUsed
+(
+    const std::set<std::string>& varNames
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (RecorderPtr != NULL)
+    {
+        for (auto& varName : varNames)
+        {
+            RecorderPtr->usedVars[varName] = envVars::Get(varName);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the lexer read a file that is part of the file being parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteFileRead
+(
+    const std::string& filePath,    ///< Path to the file.
+    const FileStamp_t& stamp        ///< Stamp of the contents that were read.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (RecorderPtr != NULL)
+    {
+        RecorderPtr->fileStamps[filePath] = stamp;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the preprocessor looked for a file or directory.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteSearch
+(
+    bool isDir,                 ///< true if looking for a directory.
+    const std::string& name,    ///< File or directory looked for.
+    const std::string& dir,     ///< Directory searched.
+    const std::string& result   ///< Path to what was found, or "" if nothing was.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (RecorderPtr != NULL)
+    {
+        RecorderPtr->searches.push_back({ isDir, name, dir, result });
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that a warning was printed about the file being parsed, so it must not be cached.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteWarning
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (RecorderPtr != NULL)
+    {
+        RecorderPtr->hasWarnings = true;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the list of dependencies of a .api file from the cache, if it is there and the file hasn't
+ * changed.
+ *
+ * @return true if the dependencies were found, false if the file must be scanned by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+bool LoadApiDependencies
+(
+    const std::string& filePath,            ///< Path to the .api file.
+    std::list<std::string>& dependencies    ///< [OUT] Dependencies, in the order they appear.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CacheDir.empty())
+    {
+        return false;
+    }
+
+    ApiFileLookupCount++;
+
+    auto absPath = path::MakeAbsolute(filePath);
+    std::string entry;
+
+    if (!file::ReadFile(GetEntryPath(absPath, ".api"), entry))
+    {
+        return false;
+    }
+
+    try
+    {
+        Reader_t reader(entry);
+        std::string stampPath;
+
+        if (   (reader.GetNumber() != FormatVersion)
+            || !CheckFileStamp(reader, stampPath)
+            || (stampPath != absPath))
+        {
+            return false;
+        }
+
+        std::list<std::string> cachedDependencies;
+
+        for (size_t count = reader.GetNumber(); count > 0; count--)
+        {
+            cachedDependencies.push_back(reader.GetString());
+        }
+
+        dependencies.swap(cachedDependencies);
+    }
+    catch (mk::Exception_t& e)
+    {
+        return false;
+    }
+
+    ApiFileHitCount++;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the list of dependencies of a .api file to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void StoreApiDependencies
+(
+    const std::string& filePath,                ///< Path to the .api file.
+    const FileStamp_t& stamp,                   ///< Stamp of the contents that were scanned.
+    const std::list<std::string>& dependencies  ///< Dependencies, in the order they appear.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CacheDir.empty())
+    {
+        return;
+    }
+
+    auto absPath = path::MakeAbsolute(filePath);
+    std::string entry;
+
+    Put(entry, FormatVersion);
+    PutFileStamp(entry, absPath, stamp);
+
+    Put(entry, dependencies.size());
+    for (auto& dependency : dependencies)
+    {
+        Put(entry, dependency);
+    }
+
+    WriteEntry(GetEntryPath(absPath, ".api"), entry);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print how many files were loaded from the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void PrintStats
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CacheDir.empty())
+    {
+        return;
+    }
+
+    std::cout << mk::format(LE_I18N("Parse cache: loaded %zu of %zu definition files and"
+                                    " %zu of %zu .api files."),
+                            DefFileHitCount.load(), DefFileLookupCount.load(),
+                            ApiFileHitCount.load(), ApiFileLookupCount.load())
+              << std::endl;
+}
+
+
+
+} // namespace parseCache
+
+} // namespace parser
@@ -0,0 +1,221 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file parseCache.h  On-disk cache of parsed definition files.
+ *
+ * When ninja's regeneration rule re-runs mkapp or mksys because one file changed, most of the
+ * .adef, .cdef, .mdef and .api files are the same as last time.  The parse trees of the
+ * definition files and the dependencies of the .api files are saved in the build's working
+ * directory, and loaded from there instead of being parsed again, as long as:
+ *  - the file, and every file it includes, has the same contents,
+ *  - every environment variable its preprocessor directives substituted has the same value, and
+ *  - every file search done by its preprocessor directives (#include, file_exists() and
+ *    dir_exists()) finds the same thing.
+ *
+ * Files whose parsing printed warnings are not cached, so the warnings are printed every time.
+ * .sdef files are not cached either, because parsing them sets environment variables.
+ *
+ * The cache can be used by several threads at once (see prefetch.h).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_DEFTOOLS_PARSE_CACHE_H_INCLUDE_GUARD
+#define LEGATO_DEFTOOLS_PARSE_CACHE_H_INCLUDE_GUARD
+
+
+namespace parseCache
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start using the cache kept in the build's working directory.  Until this is called, nothing is
+ * loaded from or saved to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void Enable
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size, modification time and MD5 hash of the contents of a file, as it was read to be parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+struct FileStamp_t
+{
+    size_t size;                ///< Size of the contents.
+    size_t mtimeSec;            ///< Modification time, or 0 if too recent to be relied upon.
+    size_t mtimeNsec;
+    std::string contentsMd5;    ///< MD5 hash of the contents ("" if the cache is disabled).
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the whole contents of a file to be parsed, and get its stamp.  The stamp is taken from the
+ * contents that were read, so a cache entry never claims to match a version of the file that was
+ * modified after it was parsed.
+ *
+ * @return true if the file was read, false if it doesn't exist or couldn't be read.
+ */
+//--------------------------------------------------------------------------------------------------
+bool ReadSourceFile
+(
+    const std::string& filePath,    ///< Path to the file.
+    std::string& contents,          ///< [OUT] Contents of the file.
+    FileStamp_t& stamp              ///< [OUT] Stamp of the contents.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the parse tree of a definition file from the cache, if it is there and still valid.  The
+ * caller takes ownership of the parse tree.
+ *
+ * @return Pointer to the parse tree, or NULL if the file must be parsed by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::DefFile_t* Load
+(
+    const std::string& filePath,        ///< Path to the definition file.
+    parseTree::DefFile_t::Type_t type,  ///< Type of the definition file.
+    bool beVerbose                      ///< true if progress messages should be printed.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records what the preprocessor depends on while the calling thread parses a definition file, so
+ * the parse tree can be saved to the cache once it is complete.
+ */
+//--------------------------------------------------------------------------------------------------
+class Recorder_t
+{
+    public:
+
+        Recorder_t();
+        ~Recorder_t();
+
+        /// Save the parse tree of the file to the cache (if it is enabled and nothing stops it).
+        void Store(const parseTree::DefFile_t* defFilePtr);
+
+        /// Environment variables the preprocessor substituted, with their values.
+        std::map<std::string, std::string> usedVars;
+
+        /// File searches the preprocessor did.
+        struct Search_t
+        {
+            bool isDir;             ///< true if it was a search for a directory.
+            std::string name;       ///< What was looked for.
+            std::string dir;        ///< Where it was looked for.
+            std::string result;     ///< What was found ("" if nothing).
+        };
+        std::list<Search_t> searches;
+
+        /// Stamps of the files the lexer read, by path.
+        std::map<std::string, FileStamp_t> fileStamps;
+
+        /// true if a warning was printed.
+        bool hasWarnings;
+
+    private:
+
+        Recorder_t* prevRecorderPtr;    ///< Recorder that was active on this thread before.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the preprocessor substituted some environment variables in the file being parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteVarsUsed
+(
+    const std::set<std::string>& varNames
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the lexer read a file that is part of the file being parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteFileRead
+(
+    const std::string& filePath,    ///< Path to the file.
+    const FileStamp_t& stamp        ///< Stamp of the contents that were read.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the preprocessor looked for a file or directory.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteSearch
+(
+    bool isDir,                 ///< true if looking for a directory.
+    const std::string& name,    ///< File or directory looked for.
+    const std::string& dir,     ///< Directory searched.
+    const std::string& result   ///< Path to what was found, or "" if nothing was.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that a warning was printed about the file being parsed, so it must not be cached.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteWarning
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the list of dependencies of a .api file from the cache, if it is there and the file hasn't
+ * changed.
+ *
+ * @return true if the dependencies were found, false if the file must be scanned by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+bool LoadApiDependencies
+(
+    const std::string& filePath,            ///< Path to the .api file.
+    std::list<std::string>& dependencies    ///< [OUT] Dependencies, in the order they appear.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the list of dependencies of a .api file to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void StoreApiDependencies
+(
+    const std::string& filePath,                ///< Path to the .api file.
+    const FileStamp_t& stamp,                   ///< Stamp of the contents that were scanned.
+    const std::list<std::string>& dependencies  ///< Dependencies, in the order they appear.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print how many files were loaded from the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+void PrintStats
+(
+    void
+);
+
+
+
+} // namespace parseCache
+
+#endif // LEGATO_DEFTOOLS_PARSE_CACHE_H_INCLUDE_GUARD
@@ -158,6 +158,12 @@ parseTree::TokenList_t* ParseSimpleOrTokenListSection
     {
         // 'preBuilt:' must use '{}'. Support without '{}' will be deprecated in a future release.
         // Add support now for backward comptability.
+        // Prefetch worker threads must not print, give up and let the modeller parse the file.
+        if (prefetch::IsWorkerThread())
+        {
+            throw mk::Exception_t(LE_I18N("Warning while pre-parsing."));
+        }
+        parseCache::NoteWarning();
         sectionNameTokenPtr->PrintWarning(
             mk::format(LE_I18N("Use '{}' with '%s' section. Support without '{}' is deprecated."),
                                sectionNameTokenPtr->text)
@@ -15,6 +15,11 @@
  * - @ref sdefParser.h
  * - @ref apiParser.h
  *
+ * The definition files a system or app needs can also be parsed ahead of time, on several threads
+ * at once, by the prefetcher declared in @ref prefetch.h.  The results are saved in the build's
+ * working directory by the cache declared in @ref parseCache.h, so the files that haven't changed
+ * don't have to be parsed again the next time.
+ *
  * Also, there's a set of parsing functions declared in @ref parser.h that are shared by multiple
  * parsers.
  *
@@ -50,6 +55,8 @@ namespace parser
 #include "mdefParser.h"
 #include "sdefParser.h"
 #include "apiParser.h"
+#include "prefetch.h"
+#include "parseCache.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,596 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file prefetch.cpp  Concurrent pre-parsing of definition files.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "defTools.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+
+namespace parser
+{
+
+namespace prefetch
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A file waiting to be pre-parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+struct Job_t
+{
+    std::string path;                   ///< Path to the file.
+    bool isApi;                         ///< true if it is a .api file.
+    parseTree::DefFile_t::Type_t type;  ///< Type of definition file (if not a .api file).
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A pre-parsed definition file.
+ */
+//--------------------------------------------------------------------------------------------------
+struct ParsedFile_t
+{
+    parseTree::DefFile_t* defFilePtr;               ///< The parse tree.
+    std::map<std::string, std::string> usedVars;    ///< Environment variables the preprocessor
+                                                    ///  substituted, with their values.
+};
+
+
+/// Mutex protecting everything below that is shared by the threads.
+static std::mutex Mutex;
+
+/// Signalled when a job is queued or finished.
+static std::condition_variable JobCondition;
+
+/// Files waiting to be pre-parsed.
+static std::deque<Job_t> JobQueue;
+
+/// Number of jobs being processed by the worker threads.
+static size_t ActiveJobCount = 0;
+
+/// Paths of all the files that have been queued, so each file is only pre-parsed once.
+static std::set<std::string> QueuedPaths;
+
+/// Pre-parsed definition files, by path.
+static std::map<std::string, ParsedFile_t> ParsedFiles;
+
+/// Pre-scanned .api file dependencies, by path.
+static std::map<std::string, std::list<std::string>> ApiDependencies;
+
+/// true on the worker threads.
+static thread_local bool IsWorker = false;
+
+/// Environment variables substituted by the preprocessor while the calling worker thread parses
+/// a file, or NULL.
+static thread_local std::map<std::string, std::string>* UsedVarsPtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a file to be pre-parsed, unless it has already been queued.  Mutex must be locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueLocked
+(
+    const std::string& filePath,
+    bool isApi,
+    parseTree::DefFile_t::Type_t type
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (QueuedPaths.insert(filePath).second)
+    {
+        JobQueue.push_back({ filePath, isApi, type });
+        JobCondition.notify_one();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a file to be pre-parsed, unless it has already been queued.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Queue
+(
+    const std::string& filePath,
+    bool isApi,
+    parseTree::DefFile_t::Type_t type = parseTree::DefFile_t::CDEF
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    QueueLocked(filePath, isApi, type);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue the file referred to by a FILE_PATH token, if it looks like a component, a .api file or a
+ * .mdef file.  The file is found the same way the modeller will look for it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueReferencedFile
+(
+    const parseTree::Token_t* tokenPtr,
+    const std::string& defFileDir,      ///< Directory of the definition file the token is in.
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::string filePath;
+
+    try
+    {
+        filePath = path::Unquote(DoSubstitution(tokenPtr));
+    }
+    catch (mk::Exception_t& e)
+    {
+        return;
+    }
+
+    if (filePath.empty())
+    {
+        return;
+    }
+
+    if (path::HasSuffix(filePath, ".api"))
+    {
+        auto apiFilePath = file::FindFile(filePath, buildParams.interfaceDirs);
+
+        if (!apiFilePath.empty())
+        {
+            Queue(apiFilePath, true);
+        }
+    }
+    else if (path::HasSuffix(filePath, ".mdef"))
+    {
+        auto mdefFilePath = file::FindFile(filePath, buildParams.moduleDirs);
+
+        if (!mdefFilePath.empty())
+        {
+            Queue(mdefFilePath, false, parseTree::DefFile_t::MDEF);
+        }
+    }
+    else
+    {
+        auto componentDir = file::FindComponent(filePath, { defFileDir });
+
+        if (componentDir.empty())
+        {
+            componentDir = file::FindComponent(filePath, buildParams.componentDirs);
+        }
+
+        if (!componentDir.empty())
+        {
+            Queue(path::Combine(path::MakeAbsolute(componentDir), "Component.cdef"),
+                  false,
+                  parseTree::DefFile_t::CDEF);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue all the files referred to by the FILE_PATH tokens of a definition file fragment and the
+ * fragments it includes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueReferencedFiles
+(
+    const parseTree::DefFileFragment_t* fragmentPtr,
+    const std::string& defFileDir,      ///< Directory of the top-level definition file.
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Note: the lexer only keeps track of the last token of a fragment.
+    for (auto tokenPtr = fragmentPtr->lastTokenPtr; tokenPtr != NULL; tokenPtr = tokenPtr->prevPtr)
+    {
+        if (tokenPtr->type == parseTree::Token_t::FILE_PATH)
+        {
+            QueueReferencedFile(tokenPtr, defFileDir, buildParams);
+        }
+    }
+
+    for (auto& include : fragmentPtr->includedFiles)
+    {
+        QueueReferencedFiles(include.second, defFileDir, buildParams);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a definition file and queue the files it refers to.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ParseDefFile
+(
+    const Job_t& job,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ParsedFile_t parsedFile;
+
+    UsedVarsPtr = &parsedFile.usedVars;
+
+    try
+    {
+        switch (job.type)
+        {
+            case parseTree::DefFile_t::ADEF:
+                parsedFile.defFilePtr = adef::Parse(job.path, false);
+                break;
+
+            case parseTree::DefFile_t::CDEF:
+                parsedFile.defFilePtr = cdef::Parse(job.path, false);
+                break;
+
+            case parseTree::DefFile_t::MDEF:
+                parsedFile.defFilePtr = mdef::Parse(job.path, false);
+                break;
+
+            default:
+                throw mk::Exception_t(LE_I18N("Internal error: Unexpected definition file type."));
+        }
+    }
+    catch (mk::Exception_t& e)
+    {
+        // Leave it to the modeller to report the error.
+        UsedVarsPtr = NULL;
+        return;
+    }
+
+    UsedVarsPtr = NULL;
+
+    QueueReferencedFiles(parsedFile.defFilePtr,
+                         path::MakeAbsolute(path::GetContainingDir(job.path)),
+                         buildParams);
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    ParsedFiles[job.path] = parsedFile;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan a .api file for its dependencies and queue them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ScanApiFile
+(
+    const Job_t& job,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::list<std::string> dependencies;
+
+    try
+    {
+        api::GetDependencies(job.path,
+                             [&dependencies](std::string&& dependency)
+                             {
+                                 dependencies.push_back(dependency);
+                             });
+    }
+    catch (mk::Exception_t& e)
+    {
+        return;
+    }
+
+    // Look for the dependencies where GetApiFilePtr() will.
+    auto dir = path::GetContainingDir(job.path);
+
+    for (auto dependency : dependencies)
+    {
+        if (!path::HasSuffix(dependency, ".api"))
+        {
+            dependency += ".api";
+        }
+
+        auto includedFilePath = file::FindFile(dependency, { dir });
+
+        if (includedFilePath.empty())
+        {
+            includedFilePath = file::FindFile(dependency, buildParams.interfaceDirs);
+        }
+
+        if (!includedFilePath.empty())
+        {
+            Queue(includedFilePath, true);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    ApiDependencies[job.path] = dependencies;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread main function.  Processes jobs until there are none left and none being processed
+ * (which could queue more).
+ */
+//--------------------------------------------------------------------------------------------------
+static void Worker
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    IsWorker = true;
+
+    std::unique_lock<std::mutex> lock(Mutex);
+
+    for (;;)
+    {
+        while (JobQueue.empty() && (ActiveJobCount > 0))
+        {
+            JobCondition.wait(lock);
+        }
+
+        if (JobQueue.empty())
+        {
+            break;
+        }
+
+        Job_t job = JobQueue.front();
+        JobQueue.pop_front();
+        ActiveJobCount++;
+
+        lock.unlock();
+
+        try
+        {
+            if (job.isApi)
+            {
+                ScanApiFile(job, buildParams);
+            }
+            else
+            {
+                ParseDefFile(job, buildParams);
+            }
+        }
+        catch (std::exception& e)
+        {
+            // Anything that went wrong will be reported by the modeller.
+        }
+
+        lock.lock();
+
+        ActiveJobCount--;
+
+        // Wake up the other workers, either to process the jobs queued by this one, or to exit.
+        JobCondition.notify_all();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pre-parse a set of .adef and .mdef files, and everything they refer to, on
+ * buildParams.jobCount threads (the number of CPUs if 0).  Returns once all the files are parsed.
+ *
+ * Does nothing if only one job is allowed.
+ */
+//--------------------------------------------------------------------------------------------------
+void Run
+(
+    const std::list<std::string>& defFilePaths,  ///< Paths to the .adef and .mdef files.
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t threadCount = (buildParams.jobCount > 0 ? buildParams.jobCount
+                                                   : std::thread::hardware_concurrency());
+    if (threadCount <= 1)
+    {
+        return;
+    }
+
+    for (auto& filePath : defFilePaths)
+    {
+        if (path::HasSuffix(filePath, ".mdef"))
+        {
+            Queue(filePath, false, parseTree::DefFile_t::MDEF);
+        }
+        else if (path::HasSuffix(filePath, ".cdef"))
+        {
+            Queue(filePath, false, parseTree::DefFile_t::CDEF);
+        }
+        else
+        {
+            Queue(filePath, false, parseTree::DefFile_t::ADEF);
+        }
+    }
+
+    std::vector<std::thread> threads;
+
+    try
+    {
+        while (threads.size() < threadCount)
+        {
+            threads.emplace_back(Worker, std::cref(buildParams));
+        }
+    }
+    catch (std::system_error& e)
+    {
+        // Make do with the threads that could be started.
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // If no thread could be started, the files will just be parsed when needed.
+    JobQueue.clear();
+
+    if (buildParams.beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Pre-parsed %zu definition files and %zu .api files"
+                                        " using %zu threads."),
+                                ParsedFiles.size(), ApiDependencies.size(), threads.size())
+                  << std::endl;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the pre-parsed copy of a definition file, if there is one and it is still valid.  The
+ * caller takes ownership of the parse tree.
+ *
+ * @return Pointer to the parse tree, or NULL if the file must be parsed by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::DefFile_t* Take
+(
+    const std::string& filePath,        ///< Path to the definition file.
+    parseTree::DefFile_t::Type_t type,  ///< Type of the definition file.
+    bool beVerbose                      ///< true if progress messages should be printed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (IsWorker)
+    {
+        return NULL;
+    }
+
+    ParsedFile_t parsedFile;
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+
+        auto i = ParsedFiles.find(filePath);
+
+        if (i == ParsedFiles.end())
+        {
+            return NULL;
+        }
+
+        parsedFile = i->second;
+        ParsedFiles.erase(i);
+    }
+
+    if (parsedFile.defFilePtr->type != type)
+    {
+        return NULL;
+    }
+
+    // The preprocessor must see the same values now as it did then.
+    for (auto& var : parsedFile.usedVars)
+    {
+        if (envVars::Get(var.first) != var.second)
+        {
+            return NULL;
+        }
+    }
+
+    if (beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Parsing file: '%s'."), filePath) << std::endl;
+    }
+
+    return parsedFile.defFilePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the pre-scanned list of dependencies of a .api file, if there is one.
+ *
+ * @return true if the dependencies were found, false if the file must be scanned by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+bool TakeApiDependencies
+(
+    const std::string& filePath,            ///< Path to the .api file.
+    std::list<std::string>& dependencies    ///< [OUT] Dependencies, in the order they appear.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (IsWorker)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    auto i = ApiDependencies.find(filePath);
+
+    if (i == ApiDependencies.end())
+    {
+        return false;
+    }
+
+    dependencies.swap(i->second);
+    ApiDependencies.erase(i);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the calling thread is a prefetch worker thread.  Worker threads must not print
+ * anything: errors and warnings abort the pre-parsing of the file instead.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsWorkerThread
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return IsWorker;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the preprocessor of the calling worker thread substituted some environment variables.
+ * Does nothing if not called by a worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteVarsUsed
+(
+    const std::set<std::string>& varNames
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (UsedVarsPtr != NULL)
+    {
+        for (auto& varName : varNames)
+        {
+            // The environment doesn't change while the worker threads run.
+            (*UsedVarsPtr)[varName] = envVars::Get(varName);
+        }
+    }
+}
+
+
+
+} // namespace prefetch
+
+} // namespace parser
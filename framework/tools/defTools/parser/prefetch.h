@@ -0,0 +1,104 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file prefetch.h  Concurrent pre-parsing of definition files.
+ *
+ * Before the modeller walks a system or an app, Run() lexes and parses the .adef, .cdef and .mdef
+ * files it is going to need, and scans the .api files for their USETYPES dependencies, on a pool
+ * of worker threads.  Each file that is parsed is searched for references to more files
+ * (components, .api files and kernel modules), which are queued in turn.
+ *
+ * The modeller itself still runs on the calling thread, in the same order as before.  The parsers
+ * just pick up the pre-parsed files with Take() and TakeApiDependencies() instead of reading the
+ * files again, so the conceptual model and everything printed are the same as for a sequential
+ * build.  A file is parsed again on the calling thread if:
+ *  - it could not be pre-parsed (errors and warnings are only reported by the calling thread),
+ *  - an environment variable used by its preprocessor directives has changed since, or
+ *  - it was not pre-parsed at all (e.g., it is only found by a search the prefetcher doesn't do).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_DEFTOOLS_PREFETCH_H_INCLUDE_GUARD
+#define LEGATO_DEFTOOLS_PREFETCH_H_INCLUDE_GUARD
+
+
+namespace prefetch
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pre-parse a set of .adef and .mdef files, and everything they refer to, on
+ * buildParams.jobCount threads (the number of CPUs if 0).  Returns once all the files are parsed.
+ *
+ * Does nothing if only one job is allowed.
+ */
+//--------------------------------------------------------------------------------------------------
+void Run
+(
+    const std::list<std::string>& defFilePaths,  ///< Paths to the .adef and .mdef files.
+    const mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the pre-parsed copy of a definition file, if there is one and it is still valid.  The
+ * caller takes ownership of the parse tree.
+ *
+ * @return Pointer to the parse tree, or NULL if the file must be parsed by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::DefFile_t* Take
+(
+    const std::string& filePath,        ///< Path to the definition file.
+    parseTree::DefFile_t::Type_t type,  ///< Type of the definition file.
+    bool beVerbose                      ///< true if progress messages should be printed.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take the pre-scanned list of dependencies of a .api file, if there is one.
+ *
+ * @return true if the dependencies were found, false if the file must be scanned by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+bool TakeApiDependencies
+(
+    const std::string& filePath,            ///< Path to the .api file.
+    std::list<std::string>& dependencies    ///< [OUT] Dependencies, in the order they appear.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the calling thread is a prefetch worker thread.  Worker threads must not print
+ * anything: errors and warnings abort the pre-parsing of the file instead.
+ *
+ * @return true if it is.
+ */
+//--------------------------------------------------------------------------------------------------
+bool IsWorkerThread
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Note that the preprocessor of the calling worker thread substituted some environment variables.
+ * Does nothing if not called by a worker thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void NoteVarsUsed
+(
+    const std::set<std::string>& varNames
+);
+
+
+
+} // namespace prefetch
+
+#endif // LEGATO_DEFTOOLS_PREFETCH_H_INCLUDE_GUARD
@@ -22,6 +22,12 @@ def AddLangArgumentGroup(parser):
                         action='store_true',
                         default=False,
                         help='allow in-place function calls')
+    parser.add_argument('--no-fixed-prefix',
+                        dest="fixedPrefix",
+                        action='store_false',
+                        default=True,
+                        help='pack parameters one by one, instead of copying the fixed-size'
+                             ' prefix of messages in one go')
 
 # Custom filters needed for C templates
 Filters = { 'DecorateName':        codeGenHelpers.DecorateName,
@@ -40,7 +46,9 @@ Filters = { 'DecorateName':        codeGenHelpers.DecorateName,
             'CAPIParameters':        codeGenHelpers.IterCAPIParameters,
             'MaxCOutputBuffers':     codeGenHelpers.GetMaxCOutputBuffers,
             'LocalMessageSize':      codeGenHelpers.GetLocalMessageSize,
-            'SizePointerTag':        codeGenHelpers.GetSizePointerTag}
+            'SizePointerTag':        codeGenHelpers.GetSizePointerTag,
+            'FixedWireType':         codeGenHelpers.GetFixedWireType,
+            'FixedPrefixLength':     codeGenHelpers.GetFixedPrefixLength}
 
 
 Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter,
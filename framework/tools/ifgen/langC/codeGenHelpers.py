@@ -343,6 +343,72 @@ def GetUnpackFunction(context, apiType):
     else:
         return _PackFunctionMapping[apiType] % ("Unpack", )
 
+_FixedWireTypeMapping = {
+    interfaceIR.UINT8_TYPE:  "uint8_t",
+    interfaceIR.UINT16_TYPE: "uint16_t",
+    interfaceIR.UINT32_TYPE: "uint32_t",
+    interfaceIR.UINT64_TYPE: "uint64_t",
+    interfaceIR.INT8_TYPE:   "int8_t",
+    interfaceIR.INT16_TYPE:  "int16_t",
+    interfaceIR.INT32_TYPE:  "int32_t",
+    interfaceIR.INT64_TYPE:  "int64_t",
+    interfaceIR.BOOL_TYPE:   "uint8_t",
+    interfaceIR.CHAR_TYPE:   "char",
+    interfaceIR.DOUBLE_TYPE: "double",
+    interfaceIR.RESULT_TYPE: "le_result_t",
+    interfaceIR.ONOFF_TYPE:  "le_onoff_t",
+}
+
+def GetFixedWireType(apiType):
+    """
+    Get the C type holding a value of an API type as packed on the wire when RPC is not used, or
+    None if values of this type do not have a fixed size on the wire.
+    """
+    if isinstance(apiType, interfaceIR.ReferenceType):
+        # References are packed as 32-bit safe references
+        return "uint32_t"
+    elif isinstance(apiType, interfaceIR.BitmaskType) or \
+         isinstance(apiType, interfaceIR.EnumType):
+        if apiType.size == interfaceIR.UINT32_TYPE.size:
+            return "uint32_t"
+        elif apiType.size == interfaceIR.UINT64_TYPE.size:
+            return "uint64_t"
+        return None
+    else:
+        return _FixedWireTypeMapping.get(apiType)
+
+@contextfilter
+def GetFixedPrefixLength(context, parameterList, withRequiredOutputs=False):
+    """
+    Get the number of leading parameters of a function or handler which are packed at a fixed
+    offset in the message, i.e. until the first parameter with a variable size on the wire.
+
+    Output parameters which do not pack their buffer size are not in the message at all, so they
+    are skipped.  Returns 0 if the prefix is not worth packing in one go (less than two values,
+    counting the required outputs bitmask), if disabled on the command line, or with RPC as all
+    values are then CBOR encoded.
+    """
+    if not context['args'].fixedPrefix or os.environ.get('LE_CONFIG_RPC') == "y":
+        return 0
+    length = 0
+    valueCount = 1 if withRequiredOutputs else 0
+    for parameter in parameterList:
+        if parameter.direction == interfaceIR.DIR_OUT and \
+           not isinstance(parameter, interfaceIR.StringParameter) and \
+           not isinstance(parameter, interfaceIR.ArrayParameter):
+            length += 1
+        elif parameter.direction == interfaceIR.DIR_IN and \
+             not isinstance(parameter, interfaceIR.StringParameter) and \
+             not isinstance(parameter, interfaceIR.ArrayParameter) and \
+             GetFixedWireType(parameter.apiType) is not None:
+            length += 1
+            valueCount += 1
+        else:
+            break
+    if valueCount < 2:
+        return 0
+    return length
+
 def EscapeString(string):
     return string.encode('string_escape').replace('"', '\\"')
 
@@ -316,7 +316,14 @@ static void _Handle_ifgen_{{apiBaseName}}_{{function.name}}
         _UNLOCK
 
         // Unpack the remaining parameters.
-        {%- call pack.UnpackInputs(handler.apiType.parameters,useBaseName=True) %}
+        {%- set prefixLength = handler.apiType.parameters|FixedPrefixLength %}
+        {%- call pack.UnpackFixedPrefix(handler.apiType.parameters,prefixLength,
+                                        useBaseName=True,
+                                        headerSize="LE_PACK_INDEF_ARRAY_HEADER_MAX_SIZE + "
+                                                   "LE_PACK_UINT32_MAX_SIZE") %}
+            goto {{error_unpack_label}};
+        {%- endcall %}
+        {%- call pack.UnpackInputs(handler.apiType.parameters[prefixLength:],useBaseName=True) %}
             goto {{error_unpack_label}};
         {%- endcall %}
 
@@ -430,14 +437,24 @@ LE_SHARED {{function.returnType|FormatType(useBaseName=True)}} ifgen_{{apiBaseNa
     le_pack_PackIndefArrayHeader(&_msgBufPtr);
     // Pack a list of outputs requested by the client.
     {%- if any(function.parameters, "OutParameter") %}
+    {%- set requiredOutputs = "_requiredOutputs" %}
     uint32_t _requiredOutputs = 0;
     {%- for output in function.parameters if output is OutParameter %}
     _requiredOutputs |= ((!!({{output|FormatParameterName}})) << {{loop.index0}});
     {%- endfor %}
-    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, _requiredOutputs));
+    {%- else %}
+    {%- set requiredOutputs = None %}
+    {%- endif %}
+    {%- set prefixLength = 0 if function is RemoveHandlerFunction else
+                           function.parameters|FixedPrefixLength(requiredOutputs) %}
+    {%- if prefixLength == 0 %}
+    {{- pack.PackFixedPrefix(function.parameters,prefixLength,requiredOutputs) }}
     {%- endif %}
 
     // Pack the input parameters
+    {%- if prefixLength > 0 %}
+    {{- pack.PackFixedPrefix(function.parameters,prefixLength,requiredOutputs) }}
+    {%- endif %}
     {%- if function is RemoveHandlerFunction %}
     {#- Remove handlers only have one parameter which is special so handle it separately from
      # the general case. #}
@@ -461,7 +478,7 @@ LE_SHARED {{function.returnType|FormatType(useBaseName=True)}} ifgen_{{apiBaseNa
                                      {{function.parameters[0]|FormatParameterName}} ));
 #endif
     {%- else %}
-    {{- pack.PackInputs(function.parameters,initiatorWaits=True) }}
+    {{- pack.PackInputs(function.parameters[prefixLength:],initiatorWaits=True) }}
     {%- endif %}
     le_pack_PackEndOfIndefArray(&_msgBufPtr);
 
@@ -602,7 +602,11 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
     LE_ASSERT(le_pack_PackReference( &_msgBufPtr, serverDataPtr->contextPtr ));
 #endif
     // Pack the input parameters
-    {{ pack.PackInputs(handler.apiType.parameters) }}
+    {%- set prefixLength = handler.apiType.parameters|FixedPrefixLength %}
+    {{- pack.PackFixedPrefix(handler.apiType.parameters,prefixLength,
+                             headerSize="LE_PACK_INDEF_ARRAY_HEADER_MAX_SIZE + "
+                                        "LE_PACK_UINT32_MAX_SIZE") }}
+    {{ pack.PackInputs(handler.apiType.parameters[prefixLength:]) }}
 
     le_pack_PackEndOfIndefArray(&_msgBufPtr);
 
@@ -743,11 +747,14 @@ static void Handle_{{apiName}}_{{function.name}}
     // Unpack which outputs are needed.
     _serverCmdPtr->requiredOutputs = 0;
     {%- if any(function.parameters, "OutParameter") %}
-    if (!le_pack_UnpackUint32(&_msgBufPtr, &_serverCmdPtr->requiredOutputs))
-    {
-        goto {{error_unpack_label}};
-    }
+    {%- set requiredOutputs = "_serverCmdPtr->requiredOutputs" %}
+    {%- else %}
+    {%- set requiredOutputs = None %}
     {%- endif %}
+    {%- set prefixLength = function.parameters|FixedPrefixLength(requiredOutputs) %}
+    {%- call pack.UnpackFixedPrefix(function.parameters,prefixLength,requiredOutputs) %}
+        goto {{error_unpack_label}};
+    {%- endcall %}
 
     {% for parameter in function.parameters if parameter is OutParameter %}
     _skip_{{parameter|FormatParameterName}} =
@@ -755,7 +762,7 @@ static void Handle_{{apiName}}_{{function.name}}
     {% endfor %}
 
     // Unpack the input parameters from the message
-    {%- call pack.UnpackInputs(function.parameters,initiatorWaits=True) %}
+    {%- call pack.UnpackInputs(function.parameters[prefixLength:],initiatorWaits=True) %}
         goto {{error_unpack_label}};
     {%- endcall %}
 
@@ -864,11 +871,15 @@ static void Handle_{{apiName}}_{{function.name}}
 
     // Unpack which outputs are needed
     {%- if any(function.parameters, "OutParameter") %}
-    if (!le_pack_UnpackUint32(&_msgBufPtr, &_requiredOutputs))
-    {
-        goto {{error_unpack_label}};
-    }
+    {%- set requiredOutputs = "_requiredOutputs" %}
+    {%- else %}
+    {%- set requiredOutputs = None %}
     {%- endif %}
+    {%- set prefixLength = 0 if function is RemoveHandlerFunction else
+                           function.parameters|FixedPrefixLength(requiredOutputs) %}
+    {%- call pack.UnpackFixedPrefix(function.parameters,prefixLength,requiredOutputs) %}
+        goto {{error_unpack_label}};
+    {%- endcall %}
 
     {%- for parameter in function.parameters if parameter is OutParameter %}
     _skip_{{parameter|FormatParameterName}} = !(_requiredOutputs & (1u << {{loop.index0}}));
@@ -908,7 +919,7 @@ static void Handle_{{apiName}}_{{function.name}}
     handlerRef = ({{function.parameters[0].apiType|FormatType}})serverDataPtr->handlerRef;
     le_mem_Release(serverDataPtr);
     {%- else %}
-    {%- call pack.UnpackInputs(function.parameters,initiatorWaits=True) %}
+    {%- call pack.UnpackInputs(function.parameters[prefixLength:],initiatorWaits=True) %}
         goto {{error_unpack_label}};
     {%- endcall %}
     {%- endif %}
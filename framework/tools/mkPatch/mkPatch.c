@@ -13,6 +13,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -21,6 +22,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <time.h>
 
 
 // Can't include legato.h because this doesn't run on target
@@ -29,13 +31,13 @@
 #include <le_crc.h>
 
 #include "flash-ubi.h"
+#include "bsdiff.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Defines some executables requested by the tool
  */
 //--------------------------------------------------------------------------------------------------
-#define BSDIFF "bsdiff"
 #define HDRCNV "hdrcnv"
 
 //--------------------------------------------------------------------------------------------------
@@ -110,6 +112,40 @@ typedef struct
 }
 DeltaPatchHeader_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Patch of a segment of the destination image
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* patchPtr;       ///< Patch built by bsDiff(), NULL if not built yet
+    size_t   patchSize;      ///< Size of the patch
+    le_result_t result;      ///< Result of bsDiff()
+}
+SegmentPatch_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Context shared by the threads diffing the segments of a destination image against the whole
+ * original image
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const uint8_t*  origPtr;        ///< Original image
+    size_t          origSize;       ///< Size of the original image
+    const off_t*    suffixPtr;      ///< Suffix array of the original image, shared by all threads
+    const uint8_t*  destPtr;        ///< Destination image
+    size_t          destSize;       ///< Size of the destination image
+    size_t          segmentSize;    ///< Size of a segment
+    uint32_t        numSegments;    ///< Number of segments
+    uint32_t        nextSegment;    ///< Next segment to diff, protected by mutex
+    pthread_mutex_t mutex;          ///< Mutex protecting nextSegment
+    SegmentPatch_t* segmentPtr;     ///< Patches of the segments, in order
+}
+DiffContext_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure to get correspondance between a partition name and image type for the CWE headers
@@ -230,10 +266,10 @@ static uint8_t Chunk[SEGMENT_SIZE];
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Buffer for the segment patch
+ * Number of threads diffing the segments. 0 to use all the online processors.
  */
 //--------------------------------------------------------------------------------------------------
-static uint8_t PatchedChunk[2 * SEGMENT_SIZE];
+static int NumJobs = 0;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -809,6 +845,186 @@ static void ExecSystem
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a whole file into a buffer allocated with malloc(3). In case of error, call exit(3).
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* LoadFile
+(
+    const char* namePtr,    ///< [IN] Name of the file
+    size_t* sizePtr         ///< [OUT] Size of the file
+)
+{
+    struct stat st;
+    uint8_t* bufPtr;
+    size_t offset = 0;
+    ssize_t len;
+    int fd;
+
+    fd = open( namePtr, O_RDONLY );
+    if( 0 > fd )
+    {
+        fprintf(stderr, "Unable to open file %s: %m\n", namePtr);
+        exit(1);
+    }
+    if( -1 == fstat( fd, &st ) )
+    {
+        fprintf(stderr, "fstat() of %s fails: %m\n", namePtr);
+        exit(1);
+    }
+    // Allocate one more byte so that malloc(0) is never called for an empty file
+    bufPtr = malloc( st.st_size + 1 );
+    if( NULL == bufPtr )
+    {
+        fprintf(stderr, "Unable to allocate %zu bytes for %s\n", (size_t)st.st_size, namePtr);
+        exit(1);
+    }
+    while( offset < st.st_size )
+    {
+        len = read( fd, bufPtr + offset, st.st_size - offset );
+        if( 0 >= len )
+        {
+            if( (0 > len) && (EINTR == errno) )
+            {
+                continue;
+            }
+            fprintf(stderr, "read() of %s fails: %m\n", namePtr );
+            exit(4);
+        }
+        offset += len;
+    }
+    close( fd );
+
+    *sizePtr = st.st_size;
+    return bufPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Return the number of seconds elapsed since a start time, and set the start time to now
+ */
+//--------------------------------------------------------------------------------------------------
+static double LapTime
+(
+    struct timespec* startPtr   ///< [IN/OUT] Start time
+)
+{
+    struct timespec now;
+    double elapsed;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    elapsed = (now.tv_sec - startPtr->tv_sec) + (now.tv_nsec - startPtr->tv_nsec) / 1e9;
+    *startPtr = now;
+    return elapsed;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread diffing the segments of the destination image until there is none left
+ */
+//--------------------------------------------------------------------------------------------------
+static void* DiffSegmentThread
+(
+    void* contextPtr
+)
+{
+    DiffContext_t* ctxPtr = contextPtr;
+    SegmentPatch_t* segPtr;
+    uint32_t segment;
+    size_t offset, len;
+
+    for( ;; )
+    {
+        pthread_mutex_lock( &ctxPtr->mutex );
+        segment = ctxPtr->nextSegment++;
+        pthread_mutex_unlock( &ctxPtr->mutex );
+        if( segment >= ctxPtr->numSegments )
+        {
+            break;
+        }
+
+        offset = (size_t)segment * ctxPtr->segmentSize;
+        len = ctxPtr->destSize - offset;
+        if( len > ctxPtr->segmentSize )
+        {
+            len = ctxPtr->segmentSize;
+        }
+        segPtr = &ctxPtr->segmentPtr[segment];
+        segPtr->result = bsDiff( ctxPtr->origPtr, ctxPtr->origSize, ctxPtr->suffixPtr,
+                                 ctxPtr->destPtr + offset, len,
+                                 &segPtr->patchPtr, &segPtr->patchSize );
+        if( IsVerbose )
+        {
+            printf("Segment %u: offset 0x%zx size %zu patch %zu bytes\n",
+                   segment, offset, len, segPtr->patchSize);
+        }
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Diff all the segments of the destination image against the whole original image, on NumJobs
+ * threads. In case of error, call exit(3).
+ *
+ * @return The number of threads used
+ */
+//--------------------------------------------------------------------------------------------------
+static int DiffSegments
+(
+    DiffContext_t* ctxPtr   ///< [IN/OUT] Images to diff and patches of the segments
+)
+{
+    pthread_t threads[256];
+    int nbThreads = NumJobs;
+    int i;
+
+    if( 0 >= nbThreads )
+    {
+        nbThreads = sysconf( _SC_NPROCESSORS_ONLN );
+    }
+    if( nbThreads > (int)NUM_ARRAY_MEMBERS(threads) )
+    {
+        nbThreads = NUM_ARRAY_MEMBERS(threads);
+    }
+    if( nbThreads > (int)ctxPtr->numSegments )
+    {
+        nbThreads = ctxPtr->numSegments;
+    }
+    if( 0 >= nbThreads )
+    {
+        nbThreads = 1;
+    }
+
+    ctxPtr->nextSegment = 0;
+    pthread_mutex_init( &ctxPtr->mutex, NULL );
+    for( i = 0; i < nbThreads; i++ )
+    {
+        if( 0 != pthread_create( &threads[i], NULL, DiffSegmentThread, ctxPtr ) )
+        {
+            fprintf(stderr, "Unable to create diff thread: %m\n");
+            exit(3);
+        }
+    }
+    for( i = 0; i < nbThreads; i++ )
+    {
+        pthread_join( threads[i], NULL );
+    }
+    pthread_mutex_destroy( &ctxPtr->mutex );
+
+    for( i = 0; i < ctxPtr->numSegments; i++ )
+    {
+        if( LE_OK != ctxPtr->segmentPtr[i].result )
+        {
+            fprintf(stderr, "Diff of segment %d fails: %d\n",
+                    i, ctxPtr->segmentPtr[i].result);
+            exit(3);
+        }
+    }
+    return nbThreads;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print usage and exit...
@@ -820,7 +1036,7 @@ static void Usage
 )
 {
     fprintf(stderr,
-            "usage: %s -T TARGET [-o patchname] [-S 4K|2K] [-E 256K|128K] [-N] [-v]\n"
+            "usage: %s -T TARGET [-o patchname] [-S 4K|2K] [-E 256K|128K] [-N] [-j N] [-v]\n"
             "        {-p PART {[-U VOLID] file-orig file-dest}}\n",
             ProgName );
     fprintf(stderr, "\n");
@@ -835,6 +1051,8 @@ static void Usage
                     "        Specify another PEB size (optional - specified only one time).\n");
     fprintf(stderr, "   -N, --no-spkg-header\n"
                     "        Do not generate the CWE SPKG header.\n");
+    fprintf(stderr, "   -j, --jobs <N>\n"
+                    "        Diff the segments on N threads. Else use all the processors.\n");
     fprintf(stderr, "   -v, --verbose\n"
                     "        Be verbose.\n");
     fprintf(stderr, "   -p, --partition <PART>\n"
@@ -903,7 +1121,7 @@ int main
 {
     char tmpName[PATH_MAX];
     int fdr, fdw, fdp;
-    int len, patchNum = 0;
+    uint32_t patchNum = 0;
     int iargc = argc;
     char** argvPtr = &argv[1];
     struct stat st;
@@ -911,6 +1129,7 @@ int main
     unsigned int ubiVolId = (uint32_t)-1;
     size_t chunkLen;
     char* partPtr = NULL;
+    char* partNamePtr = NULL;
     char* pckgPtr = NULL;
     char* productPtr = NULL;
     char* targetPtr = NULL;
@@ -926,10 +1145,16 @@ int main
     char* toolchainEnvPtr = NULL;
     char* envPtr = NULL;
     int ret;
+    uint8_t *origImgPtr, *destImgPtr;
+    size_t origImgSize, destImgSize, patchSize;
+    off_t* suffixPtr;
+    DiffContext_t diffCtx;
+    int nbThreads;
+    struct timespec lapTime, volumeTime, toolTime;
+    double loadTime, sortTime, diffTime;
 
     ProgName = argv[0];
-
-    CheckForTool( BSDIFF, NULL );
+    clock_gettime( CLOCK_MONOTONIC, &toolTime );
 
     getcwd(CurrentWorkDir, sizeof(CurrentWorkDir));
     atexit( ExitHandler );
@@ -1063,6 +1288,23 @@ int main
             iargc--;
         }
 
+        else if( (iargc >= 5) &&
+                 ((0 == strcmp(*argvPtr, "--jobs")) || (0 == strcmp(*argvPtr, "-j"))) )
+        {
+            char *endPtr;
+
+            ++argvPtr;
+            errno = 0;
+            NumJobs = strtol( *argvPtr, &endPtr, 10 );
+            if( (errno) || (*endPtr) || (0 >= NumJobs) )
+            {
+                fprintf(stderr, "Incorrect number of jobs '%s'\n", *argvPtr );
+                exit(1);
+            }
+            ++argvPtr;
+            iargc -= 2;
+        }
+
         else if( (iargc >= 4) &&
                  ((0 == strcmp(*argvPtr, "--verbose")) || (0 == strcmp(*argvPtr, "-v"))) )
         {
@@ -1107,6 +1349,7 @@ int main
             {
                 if( 0 == strcmp( *argvPtr, partToSpkgPtr[ip].partName ) )
                 {
+                    partNamePtr = partToSpkgPtr[ip].partName;
                     partPtr = partToSpkgPtr[ip].imageType;
                     pckgPtr = partToSpkgPtr[ip].spkgImageType;
                     isUbiImage = partToSpkgPtr[ip].isUbiImage;
@@ -1289,22 +1532,13 @@ int main
                 exit(EXIT_FAILURE);
             }
 
-            fdr = open( OrigName, O_RDONLY );
-            if( 0 > fdr )
-            {
-                fprintf(stderr, "Unable to open origin file %s: %m\n", OrigName);
-                exit(1);
-            }
-            fstat( fdr, &st );
-            PatchMetaHeader.origSize = htobe32(st.st_size);
+            clock_gettime( CLOCK_MONOTONIC, &lapTime );
+            volumeTime = lapTime;
 
-            crc32Orig = LE_CRC_START_CRC32;
+            origImgPtr = LoadFile( OrigName, &origImgSize );
+            PatchMetaHeader.origSize = htobe32(origImgSize);
 
-            while( 0 < (len = read( fdr, Chunk, chunkLen )) )
-            {
-                crc32Orig = le_crc_Crc32( Chunk, len, crc32Orig );
-            }
-            close( fdr );
+            crc32Orig = le_crc_Crc32( origImgPtr, origImgSize, LE_CRC_START_CRC32 );
             PatchMetaHeader.origCrc32 = htobe32(crc32Orig);
 
             if( notUbiOpt && isUbiImage )
@@ -1326,18 +1560,39 @@ int main
                 exit(EXIT_FAILURE);
             }
 
-            fdr = open( DestName, O_RDONLY );
-            if( 0 > fdr )
-            {
-                fprintf(stderr, "Unable to open destination file %s: %m\n", DestPtr);
-                exit(1);
-            }
-            fstat( fdr, &st );
-            PatchMetaHeader.destSize = htobe32(st.st_size);
+            destImgPtr = LoadFile( DestName, &destImgSize );
+            PatchMetaHeader.destSize = htobe32(destImgSize);
 
             PatchMetaHeader.ubiVolId = htobe32(ubiVolId);
 
-            crc32Dest = LE_CRC_START_CRC32;
+            crc32Dest = le_crc_Crc32( destImgPtr, destImgSize, LE_CRC_START_CRC32 );
+            loadTime = LapTime( &lapTime );
+
+            // The suffix array of the original image is built once and shared by all the segments
+            suffixPtr = bsDiffSuffixArray( origImgPtr, origImgSize );
+            if( NULL == suffixPtr )
+            {
+                fprintf(stderr, "Unable to build the suffix array of %s\n", OrigName);
+                exit(3);
+            }
+            sortTime = LapTime( &lapTime );
+
+            memset( &diffCtx, 0, sizeof(diffCtx) );
+            diffCtx.origPtr = origImgPtr;
+            diffCtx.origSize = origImgSize;
+            diffCtx.suffixPtr = suffixPtr;
+            diffCtx.destPtr = destImgPtr;
+            diffCtx.destSize = destImgSize;
+            diffCtx.segmentSize = chunkLen;
+            diffCtx.numSegments = (destImgSize + chunkLen - 1) / chunkLen;
+            diffCtx.segmentPtr = calloc( diffCtx.numSegments + 1, sizeof(SegmentPatch_t) );
+            if( NULL == diffCtx.segmentPtr )
+            {
+                fprintf(stderr, "Unable to allocate %u segments\n", diffCtx.numSegments);
+                exit(3);
+            }
+            nbThreads = DiffSegments( &diffCtx );
+            diffTime = LapTime( &lapTime );
 
             snprintf( tmpName, sizeof(tmpName),
                       "patch.%u.bin",
@@ -1350,72 +1605,28 @@ int main
             }
             write( fdp, &PatchMetaHeader, sizeof(PatchMetaHeader) );
 
-            while( 0 < (len = read( fdr, Chunk, chunkLen)) )
+            // Segment patches are written in order, whatever the order they were built
+            patchSize = 0;
+            for( patchNum = 0; patchNum < diffCtx.numSegments; )
             {
-                crc32Dest = le_crc_Crc32( Chunk, len, crc32Dest );
-                snprintf( tmpName, sizeof(tmpName), "patchdest.%u.bin.%d", pid, patchNum );
-                fdw = open( tmpName, O_WRONLY | O_TRUNC | O_CREAT, S_IWUSR | S_IRUSR );
-                if( 0 <= fdw )
-                {
-                    write( fdw, Chunk, len );
-                    close( fdw );
-                }
-                else {
-                    fprintf( stderr, "Open of patch file %s fails: %m\n", tmpName );
-                    exit(3);
-                }
+                SegmentPatch_t* segPtr = &diffCtx.segmentPtr[patchNum];
 
-                ret = snprintf(CmdBuf, sizeof(CmdBuf),
-                               BSDIFF " %s %s patched.%u.bin.%d",
-                               OrigName, tmpName, pid, patchNum);
-                if (ret >= sizeof(CmdBuf))
-                {
-                    fprintf(stderr, "command truncated in file %s at line # %d", __FILE__, __LINE__);
-                    exit(EXIT_FAILURE);
-                }
-
-                if( IsVerbose )
-                {
-                    printf( "%s\n", CmdBuf );
-                }
-                ExecSystem( CmdBuf );
-
-                ret = snprintf( tmpName, sizeof(tmpName), "patched.%u.bin.%d", pid, patchNum );
-                if (ret >= sizeof(tmpName))
-                {
-                    fprintf(stderr, "string truncated in file %s at line # %d", __FILE__, __LINE__);
-                    exit(EXIT_FAILURE);
-                }
-
-                fdw = open( tmpName, O_RDONLY );
-                if( 0 > fdw )
-                {
-                    fprintf(stderr, "Unable to open destination file %s: %m\n", tmpName);
-                    exit(1);
-                }
-                fstat( fdw, &st );
                 PatchHeader.offset = htobe32(patchNum * chunkLen);
                 patchNum++;
                 PatchHeader.number = htobe32(patchNum);
-                PatchHeader.size = htobe32(st.st_size);
+                PatchHeader.size = htobe32(segPtr->patchSize);
                 printf("Patch Header: offset 0x%x number %d size %u (0x%x)\n",
                        be32toh(PatchHeader.offset), be32toh(PatchHeader.number),
                        be32toh(PatchHeader.size), be32toh(PatchHeader.size));
-                len = read( fdw, PatchedChunk, st.st_size );
-                if( 0 > len )
-                {
-                    fprintf(stderr, "read() fails: %m\n" );
-                    exit(4);
-                }
-                close(fdw);
                 write( fdp, &PatchHeader, sizeof(PatchHeader) );
-                write( fdp, PatchedChunk, st.st_size );
-            }
-            if( len < 0 )
-            {
-                fprintf(stderr, "read() fails: %m\n" );
-                exit(4);
+                write( fdp, segPtr->patchPtr, segPtr->patchSize );
+                patchSize += segPtr->patchSize;
+                free( segPtr->patchPtr );
             }
+            free( diffCtx.segmentPtr );
+            free( suffixPtr );
+            free( destImgPtr );
+            free( origImgPtr );
 
             PatchMetaHeader.destCrc32 = htobe32(crc32Dest);
             PatchMetaHeader.numPatches = htobe32(patchNum);
@@ -1431,9 +1642,18 @@ int main
                     be32toh(PatchMetaHeader.ubiVolId),
                     be32toh(PatchMetaHeader.origSize), be32toh(PatchMetaHeader.origCrc32),
                     be32toh(PatchMetaHeader.destSize), be32toh(PatchMetaHeader.destCrc32));
-            close( fdr );
             close( fdp );
 
+            printf( "Timing %s", partNamePtr );
+            if( (uint32_t)-1 != ubiVolId )
+            {
+                printf( " volume %u", ubiVolId );
+            }
+            printf( ": %zu -> %zu bytes, patch %zu bytes in %u segments\n"
+                    "  load %.3fs, suffix sort %.3fs, diff %.3fs on %d threads, total %.3fs\n",
+                    origImgSize, destImgSize, patchSize, patchNum,
+                    loadTime, sortTime, diffTime, nbThreads, LapTime( &volumeTime ) );
+
             snprintf( CmdBuf, sizeof(CmdBuf),
                       HDRCNV " patch.%u.bin -OH patch.%u.hdr -IT %s -PT %s -V \"1.0\" -B 00000001",
                       pid, pid, partPtr, productPtr );
@@ -1524,6 +1744,7 @@ int main
         snprintf( CmdBuf, sizeof(CmdBuf), "mv patch-%s.cwe %s", targetPtr, outPtr );
         ExecSystem( CmdBuf );
     }
+    printf( "Timing total: %.3fs\n", LapTime( &toolTime ) );
 
     exit( 0 );
 }
@@ -63,24 +63,25 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         // Generate a rule for creating an info.properties file.
         "rule MakeAppInfoProperties\n"
         "  description = Creating info.properties\n"
-        // Delete the old info.properties file, if there is one.
-        "  command = rm -f $out && $\n"
-        // Compute the MD5 checksum of the staging area.
-        // Don't follow symlinks (-P), and include the directory structure and the contents of
-        // symlinks as part of the MD5 hash.
-        "            md5=$$( ( cd $workingDir/staging && $\n"
-        "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-        "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-        "                      find -P -type l -print0 |LC_ALL=C sort -z"
-                             " |xargs -0 -r -n 1 readlink $\n"
-        "                    ) | md5sum) && $\n"
-        "            md5=$${md5%% *} && $\n"
-        // Generate the app's info.properties file.
+        // The file is only replaced if the app's hash changed, so the app doesn't get packed again
+        // when its contents are the same as last time.
+        "  restat = 1\n"
+        // Compute the MD5 checksum of the staging area, leaving out the old info.properties file.
+        // Symlinks aren't followed, and the directory structure and the contents of symlinks are
+        // part of the MD5 hash.  The hashes of the files are cached, so only the files that changed
+        // since the last build are read.
+        "  command = md5=`staging-md5 --cache $workingDir/staging.md5cache"
+                    " --exclude ./info.properties $workingDir/staging` && $\n"
+        // Generate the app's info.properties file into a temporary file outside the staging area,
+        // so that a failed or interrupted build can't leave it behind to be hashed and packed.
+        "            tmp=`mktemp $workingDir/info.properties.XXXXXX` && $\n"
+        "            trap 'rm -f $$tmp' EXIT && trap 'exit 1' HUP INT TERM && $\n"
         "            ( echo \"app.name=$name\" && $\n"
         "              echo \"app.md5=$$md5\" && $\n"
         "              echo \"app.version=$version\" && $\n"
         "              echo \"legato.version=`cat $$LEGATO_ROOT/version`\" $\n"
-        "            ) > $out\n"
+        "            ) > $$tmp && $\n"
+        "            if ! cmp -s $$tmp $out; then chmod 644 $$tmp && mv -f $$tmp $out; fi\n"
         "\n"
 
         // Create an update pack file for an app.
@@ -93,7 +94,7 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         // option as it is not available in other tar (e.g bsdtar)
         "            mtime=`stat -c %Y $adefPath` && $\n"
         "            find $workingDir/staging -exec touch --no-dereference "
-                    "--date=@$$mtime {} \\; && $\n"
+                    "--date=@$$mtime {} + && $\n"
         "            (cd $workingDir/staging && find . -print0 | LC_ALL=C sort -z"
                      " |tar --no-recursion --null -T - -cjf - ) > $workingDir/$name.$target && $\n"
         // Get the size of the tarball.
@@ -119,7 +120,7 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         // Change all file time stamp to generate reproducible build. Can't use gnu tar --mtime
         // option as it is not available in other tar (e.g bsdtar)
         "            mtime=`stat -c %Y $adefPath` && $\n"
-        "            find $workingDir -exec touch  --no-dereference --date=@$$mtime {} \\; && $\n"
+        "            find $workingDir -exec touch  --no-dereference --date=@$$mtime {} + && $\n"
         "            (cd $workingDir/ && find . -print0 |LC_ALL=C sort -z"
         "  |tar --no-recursion --null -T - -cjf - ) > $out\n"
         "\n";
@@ -140,13 +141,7 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
             // Recompute the MD5 checksum of the staging area.
             // Don't follow symlinks (-P), and include the directory structure and the contents
             // of symlinks as part of the MD5 hash.
-            "            md5signed=$$( ( cd $workingDir/staging.signed && $\n"
-            "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-            "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-            "                      find -P -type l -print0 |LC_ALL=C sort -z"
-                                 " |xargs -0 -r -n 1 readlink $\n"
-            "                    ) | md5sum) && $\n"
-            "            md5signed=$${md5signed%% *} && $\n"
+            "            md5signed=`staging-md5 $workingDir/staging.signed` && $\n"
             // Get the app's MD5 hash from its info.properties file and replace with signed one.
             "            md5=`grep '^app.md5=' $workingDir/staging.signed/info.properties"
                         " | sed 's/^app.md5=//'` && $\n"
@@ -156,7 +151,7 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
             // option as it is not available in other tar (e.g bsdtar)
             "            mtime=`stat -c %Y $adefPath` && $\n"
             "            find $workingDir/staging.signed -exec touch --no-dereference "
-                        "--date=@$$mtime {} \\; && $\n"
+                        "--date=@$$mtime {} + && $\n"
             "            "<< baseGeneratorPtr->GetPathEnvVarDecl() << " && $\n"
             "            fakeroot ima-sign.sh --sign -y legato -d $workingDir/staging.signed "
                         "-t $workingDir/$name.$target.signed -p " << buildParams.privKey <<" && $\n"
@@ -188,7 +183,7 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
             // option as it is not available in other tar (e.g bsdtar)
             "            mtime=`stat -c %Y $adefPath` && $\n"
             "            find $workingDir/staging.signed.bin -exec touch --no-dereference "
-                        "--date=@$$mtime {} \\; && $\n"
+                        "--date=@$$mtime {} + && $\n"
             // Require signing image. Sign the staging area and create tarball
             "            "<< baseGeneratorPtr->GetPathEnvVarDecl() << " && $\n"
             "            fakeroot ima-sign.sh --sign -y legato -d $workingDir/staging.signed.bin/ "
@@ -44,18 +44,22 @@ void LinuxSystemBuildScriptGenerator_t::GenerateSystemBuildRules
     "  command = $\n"
 
     // Copy the framework bin and lib directories into the system's staging area.
+    // Timestamps are preserved so the cached MD5 hashes of the files that didn't change can be
+    // reused when the staging area is hashed below.
     "            mkdir -p $stagingDir/bin && $\n"
     "            mkdir -p $stagingDir/lib && $\n"
     "            find $$LEGATO_ROOT/build/$target/framework/bin/* -type d -prune -o"
-                                  " -print | xargs cp -P -t $stagingDir/bin && $\n"
+                                  " -print | xargs cp -P --preserve=timestamps"
+                                  " -t $stagingDir/bin && $\n"
     "            find $$LEGATO_ROOT/build/$target/framework/lib/* -type d -prune -o"
-                       " \\( -type f -o -type l \\) -print | xargs cp -P -t $stagingDir/lib && $\n"
+                       " \\( -type f -o -type l \\) -print | xargs cp -P --preserve=timestamps"
+                       " -t $stagingDir/lib && $\n"
 
     // Create modules directory and copy kernel modules into it
     "            mkdir -p $stagingDir/modules && $\n"
     "            if [ -d $builddir/modules ] ; then $\n"
     "                find $builddir/modules/*/*.ko -print"
-                          "| xargs cp -P -t $stagingDir/modules ; $\n"
+                          "| xargs cp -P --preserve=timestamps -t $stagingDir/modules ; $\n"
     "            fi && $\n"
 
     // Create an apps directory for the symlinks to the apps.
@@ -130,15 +134,11 @@ void LinuxSystemBuildScriptGenerator_t::GenerateSystemBuildRules
     // Delete the old info.properties file, if there is one.
     "            rm -f $out && $\n"
 
-    // Compute the MD5 checksum of the staging area.
-    // Don't follow symlinks (-P), and include the directory structure and the contents of symlinks
-    // as part of the MD5 hash.
-    "            md5=$$( ( cd $stagingDir && $\n"
-    "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-    "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-    "                      find -P -type l -print0 |LC_ALL=C sort -z |xargs -0 -r -n 1 readlink $\n"
-    "                    ) |tee /proc/self/fd/2 | md5sum) && $\n"
-    "            md5=$${md5%% *} && $\n"
+    // Compute the MD5 checksum of the staging area, printing what was hashed to stderr.
+    // Symlinks aren't followed, and the directory structure and the contents of symlinks are part
+    // of the MD5 hash.  The hashes of the files are cached, so only the files that changed since
+    // the last build are read.
+    "            md5=`staging-md5 --list --cache $builddir/staging.md5cache $stagingDir` && $\n"
 
     // Get the Legato framework version and append the MD5 sum to it to get the system version.
     "           frameworkVersion=$$( cat $$LEGATO_ROOT/version ) && $\n"
@@ -162,7 +162,7 @@ void LinuxSystemBuildScriptGenerator_t::GenerateSystemBuildRules
     // Change all file time stamp to generate reproducible build. Can't use gnu tar --mtime option
     // as it is not available in other tar (e.g bsdtar)
     "            mtime=`stat -c %Y " << systemPtr->defFilePtr->path <<"` && $\n"
-    "            find $stagingDir -exec touch  --no-dereference --date=@$$mtime {} \\; && $\n"
+    "            find $stagingDir -exec touch  --no-dereference --date=@$$mtime {} + && $\n"
     // Pack the system's staging area into a compressed tarball.
     "           (cd $stagingDir && find . -print0 | LC_ALL=C sort -z"
                                  " |tar --no-recursion --null -T -"
@@ -237,13 +237,7 @@ void LinuxSystemBuildScriptGenerator_t::GenerateSystemBuildRules
         // Recompute the MD5 checksum of the staging area.
         // Don't follow symlinks (-P), and include the directory structure and the contents
         // of symlinks as part of the MD5 hash.
-        "            md5signed=$$( ( cd $stagingDir.signed && $\n"
-        "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-        "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-        "                      find -P -type l -print0 |LC_ALL=C sort -z "
-                               "|xargs -0 -r -n 1 readlink $\n"
-        "                    ) | md5sum) && $\n"
-        "            md5signed=$${md5signed%% *} && $\n"
+        "            md5signed=`staging-md5 $stagingDir.signed` && $\n"
         // Get the systems's MD5 hash from its info.properties file and replace with signed one
         "            md5=`grep '^system.md5=' $stagingDir.signed/info.properties | "
                                                           "sed 's/^system.md5=//'` && $\n"
@@ -252,7 +246,7 @@ void LinuxSystemBuildScriptGenerator_t::GenerateSystemBuildRules
         // option as it is not available in other tar (e.g bsdtar)
         "            mtime=`stat -c %Y " << systemPtr->defFilePtr->path <<"` && $\n"
         "            find $stagingDir.signed -exec touch  --no-dereference "
-                    "--date=@$$mtime {} \\; && $\n"
+                    "--date=@$$mtime {} + && $\n"
         // No need to recompute the md5 hash again as it is used for app/system version and
         // enable signing shouldn't change the app/system version.
         // Require signing image. Sign the staging area and create tarball
@@ -42,7 +42,7 @@ void GenerateCLangExeMain
 
     // Open the file as an output stream.
     file::MakeDir(path::GetContainingDir(sourceFile));
-    std::ofstream outputFile(sourceFile);
+    file::GeneratedFile_t outputFile(sourceFile);
     if (outputFile.is_open() == false)
     {
         throw mk::Exception_t(
@@ -213,7 +213,7 @@ void GenerateCLangExeMain
                   "    LE_FATAL(\"== SHOULDN'T GET HERE! ==\");\n"
                   "}\n";
 
-    outputFile.close();
+    outputFile.Commit();
 }
 
 
@@ -43,7 +43,7 @@ void GenerateJavaComponentMainFile
 
     // Open the .java file for writing.
     file::MakeDir(outputDir);
-    std::ofstream outputFile(filePath, std::ofstream::trunc);
+    file::GeneratedFile_t outputFile(filePath);
     if (!outputFile.is_open())
     {
         throw mk::Exception_t(
@@ -159,6 +159,8 @@ void GenerateJavaComponentMainFile
                   "        return component;\n"
                   "    }\n"
                   "}\n";
+
+    outputFile.Commit();
 }
 
 
@@ -394,11 +394,17 @@ void MakeApp
         args::Save(BuildParams);
 
         // Save the environment variables.
-        // Note: we must do this before we parse the definition file, because parsing the file
-        // will result in the CURDIR environment variable being set.
+        // Note: we must do this before we model the application, because modelling it
+        // will result in the BUILDDIR environment variable being set.
         envVars::Save(BuildParams);
     }
 
+    // Reuse the parse results of the definition files that haven't changed since the last run.
+    parser::parseCache::Enable(BuildParams);
+
+    // Parse the .adef file and the files it refers to ahead of time, on several threads.
+    parser::prefetch::Run({ AdefFilePath }, BuildParams);
+
     // Construct a model of the application.
     model::App_t* appPtr = modeller::GetApp(AdefFilePath, BuildParams);
 
@@ -428,6 +434,7 @@ void MakeApp
     // If verbose mode is on, print a summary of the application model.
     if (BuildParams.beVerbose)
     {
+        parser::parseCache::PrintStats();
         modeller::PrintSummary(appPtr);
     }
 
@@ -309,8 +309,8 @@ void MakeComponent
             args::Save(BuildParams);
 
             // Save the environment variables.
-            // Note: we must do this before we parse the definition file, because parsing the file
-            // will result in the CURDIR environment variable being set.
+            // Note: we must do this before we model the components, because modelling them
+            // will result in the BUILDDIR environment variable being set.
             envVars::Save(BuildParams);
         }
     }
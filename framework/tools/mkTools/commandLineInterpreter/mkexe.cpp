@@ -513,8 +513,8 @@ void MakeExecutable
             args::Save(BuildParams);
 
             // Save the environment variables.
-            // Note: we must do this before we parse the definition file, because parsing the file
-            // will result in the CURDIR environment variable being set.
+            // Note: we must do this before we model the components, because modelling them
+            // will result in the BUILDDIR environment variable being set.
             envVars::Save(BuildParams);
         }
     }
@@ -378,18 +378,22 @@ void MakeSystem
         args::Save(BuildParams);
 
         // Save the environment variables.
-        // Note: we must do this before we parse the definition file, because parsing the file
-        // will result in the CURDIR environment variable being set.
+        // Note: we must do this before we parse the definition file, because modelling the
+        // system will result in the BUILDDIR environment variable being set.
         // Also, the .sdef file can contain environment variable settings.
         envVars::Save(BuildParams);
     }
 
+    // Reuse the parse results of the definition files that haven't changed since the last run.
+    parser::parseCache::Enable(BuildParams);
+
     // Construct a model of the system.
     model::System_t* systemPtr = modeller::GetSystem(SdefFilePath, BuildParams);
 
     // If verbose mode is on, print a summary of the system model.
     if (BuildParams.beVerbose)
     {
+        parser::parseCache::PrintStats();
 //        modeller::PrintSummary(systemPtr);
     }
 
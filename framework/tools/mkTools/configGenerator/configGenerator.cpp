@@ -938,7 +938,7 @@ void Generate
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
+    file::GeneratedFile_t cfgStream(filePath);
 
     if (cfgStream.is_open() == false)
     {
@@ -968,6 +968,8 @@ void Generate
     GenerateAppTagsConfig(cfgStream, appPtr);
 
     cfgStream << "}" << std::endl;
+
+    cfgStream.Commit();
 }
 
 
@@ -1372,7 +1374,7 @@ static void GenerateModulesConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
+    file::GeneratedFile_t cfgStream(filePath);
 
     if (cfgStream.is_open() == false)
     {
@@ -1470,6 +1472,8 @@ static void GenerateModulesConfig
 
     cfgStream << "}\n";
 
+    cfgStream.Commit();
+
     // Check for cyclic dependencies in kernel modules
     hasCyclicDependency(checkCycleMap, visitedMap, recurStackMap);
 }
@@ -1497,7 +1501,7 @@ static void GenerateUsersConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
+    file::GeneratedFile_t cfgStream(filePath);
 
     if (cfgStream.is_open() == false)
     {
@@ -1529,6 +1533,8 @@ static void GenerateUsersConfig
     }
 
     cfgStream << "}\n";
+
+    cfgStream.Commit();
 }
 
 
@@ -1590,7 +1596,7 @@ static void GenerateAppsConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
+    file::GeneratedFile_t cfgStream(filePath);
 
     if (cfgStream.is_open() == false)
     {
@@ -1611,6 +1617,8 @@ static void GenerateAppsConfig
     }
 
     cfgStream << "}\n";
+
+    cfgStream.Commit();
 }
 
 
@@ -1748,7 +1756,7 @@ static void GenerateFrameworkConfig
     }
 
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
+    file::GeneratedFile_t cfgStream(filePath);
 
     if (cfgStream.is_open() == false)
     {
@@ -1780,6 +1788,8 @@ static void GenerateFrameworkConfig
     }
 
     cfgStream << "}" << std::endl;
+
+    cfgStream.Commit();
 }
 
 
@@ -2,7 +2,7 @@
 /** @file inspect.c
  *
  * Legato inspection tool used to inspect Legato structures such as memory pools, timers, threads,
- * mutexes, etc. in running processes.
+ * mutexes, event loop statistics, etc. in running processes.
  *
  * Must be run as root.
  *
@@ -23,6 +23,7 @@
 #include "limit.h"
 #include "fileDescriptor.h"
 #include "timer.h"
+#include "eventProfile.h"
 
 #include "inspect_target.h"
 
@@ -82,10 +83,14 @@ typedef struct ThreadObjIter*       ThreadObjIter_Ref_t;
 typedef struct TimerIter*           TimerIter_Ref_t;
 #if LE_CONFIG_LINUX_TARGET_TOOLS
 typedef struct MutexIter*           MutexIter_Ref_t;
+typedef struct MutexStatIter*       MutexStatIter_Ref_t;
 typedef struct SemaphoreIter*       SemaphoreIter_Ref_t;
 #endif
 typedef struct ThreadMemberObjIter* ThreadMemberObjIter_Ref_t;
 typedef struct RefMapIter*          RefMapIter_Ref_t;
+#if LE_CONFIG_EVENT_PROFILING
+typedef struct EventProfIter*       EventProfIter_Ref_t;
+#endif
 #if LE_CONFIG_LINUX
 typedef struct ServiceObjIter*      ServiceObjIter_Ref_t;
 typedef struct ClientObjIter*       ClientObjIter_Ref_t;
@@ -106,9 +111,13 @@ typedef enum
     INSPECT_INSP_TYPE_TIMER,
 #if LE_CONFIG_LINUX_TARGET_TOOLS
     INSPECT_INSP_TYPE_MUTEX,
+    INSPECT_INSP_TYPE_MUTEX_STATS,
     INSPECT_INSP_TYPE_SEMAPHORE,
 #endif
     INSPECT_INSP_TYPE_SAFE_REF,
+#if LE_CONFIG_EVENT_PROFILING
+    INSPECT_INSP_TYPE_EVENT_PROF,
+#endif
 #if LE_CONFIG_LINUX
     INSPECT_INSP_TYPE_IPC_SERVERS,
     INSPECT_INSP_TYPE_IPC_CLIENTS,
@@ -211,6 +220,13 @@ typedef struct MutexIter
 }
 MutexIter_t;
 
+typedef struct MutexStatIter
+{
+    RemoteDlsListAccess_t mutexList;     ///< Mutex list of the remote process.
+    Mutex_t currMutex;                   ///< Current mutex from the list.
+}
+MutexStatIter_t;
+
 typedef struct SemaphoreIter
 {
     RemoteDlsListAccess_t threadObjList;
@@ -237,6 +253,17 @@ typedef struct RefMapIter
 }
 RefMapIter_t;
 
+#if LE_CONFIG_EVENT_PROFILING
+typedef struct EventProfIter
+{
+    RemoteDlsListAccess_t threadRecList;  ///< Profiling record list in the remote process.
+    eventProf_ThreadRec_t currThreadRec;  ///< Current profiling record from the list.
+    bool isThreadRecRead;                 ///< true once currThreadRec holds a record.
+    int entryIndex;                       ///< Current entry of the record (-1 = dispatch entry).
+}
+EventProfIter_t;
+#endif
+
 #if LE_CONFIG_LINUX
 typedef struct ServiceObjIter
 {
@@ -305,10 +332,14 @@ typedef union {
     TimerIter_t timerIter;
 #if LE_CONFIG_LINUX_TARGET_TOOLS
     MutexIter_t mutexIter;
+    MutexStatIter_t mutexStatIter;
     SemaphoreIter_t semIter;
 #endif
     ThreadMemberObjIter_t threadMemberIter;
     RefMapIter_t safeRefIter;
+#if LE_CONFIG_EVENT_PROFILING
+    EventProfIter_t eventProfIter;
+#endif
 #if LE_CONFIG_LINUX
     ServiceObjIter_t serviceIter;
     ClientObjIter_t clientIter;
@@ -410,6 +441,16 @@ static bool IsFollowing = false;
 static bool IsVerbose = false;
 
 
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+//--------------------------------------------------------------------------------------------------
+/**
+ * true = print statistics instead of the current state (only valid for mutexes).
+ **/
+//--------------------------------------------------------------------------------------------------
+static bool IsStats = false;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Type of Timer under inspection: TIMER_NON_WAKEUP / TIMER_WAKEUP
@@ -749,6 +790,103 @@ static RefMapIter_Ref_t CreateRefMapIter
     return iteratorPtr;
 }
 
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an iterator that can be used to iterate over all the mutexes of a specific process,
+ * whether they are currently locked or not. See the comment block for CreateMemPoolIter for
+ * additional detail.
+ *
+ * @return
+ *      An iterator to the list of mutexes of the specified process.
+ */
+//--------------------------------------------------------------------------------------------------
+static MutexStatIter_Ref_t CreateMutexStatIter
+(
+    void
+)
+{
+    // Get the address offset of the mutex list for the process to inspect.
+    uintptr_t listAddrOffset = target_GetRemoteAddress(PidToInspect, mutex_GetMutexList());
+
+    // Get the address offset of the mutex list change counter for the process to inspect.
+    uintptr_t listChgCntAddrOffset = target_GetRemoteAddress(PidToInspect,
+                                                             mutex_GetMutexListChgCntRef());
+
+    // Create the iterator.
+    MutexStatIter_t* iteratorPtr = le_mem_ForceAlloc(IteratorPool);
+    memset(iteratorPtr, 0, sizeof(MutexStatIter_t));
+    InitRemoteDlsListAccessObj(&iteratorPtr->mutexList);
+
+    // Get the List for the process-under-inspection.
+    if (target_ReadAddress(PidToInspect, listAddrOffset, &(iteratorPtr->mutexList.List),
+                          sizeof(iteratorPtr->mutexList.List)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("mutex list"));
+    }
+
+    // Get the ListChgCntRef for the process-under-inspection.
+    if (target_ReadAddress(PidToInspect, listChgCntAddrOffset,
+                          &(iteratorPtr->mutexList.ListChgCntRef),
+                          sizeof(iteratorPtr->mutexList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("mutex list change counter ref"));
+    }
+
+    return iteratorPtr;
+}
+#endif
+
+#if LE_CONFIG_EVENT_PROFILING
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an iterator that can be used to iterate over the event loop profiling entries of a
+ * specific process. See the comment block for CreateMemPoolIter for additional detail.
+ *
+ * @return
+ *      An iterator to the event loop profiling entries of the specified process.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventProfIter_Ref_t CreateEventProfIter
+(
+    void
+)
+{
+    // Get the address offset of the profiling record list for the process to inspect.
+    uintptr_t listAddrOffset = target_GetRemoteAddress(PidToInspect,
+                                                       eventProf_GetThreadRecList());
+
+    // Get the address offset of the profiling record list change counter for the process to
+    // inspect.
+    uintptr_t listChgCntAddrOffset = target_GetRemoteAddress(PidToInspect,
+                                                   eventProf_GetThreadRecListChgCntRef());
+
+    // Create the iterator.
+    EventProfIter_t* iteratorPtr = le_mem_ForceAlloc(IteratorPool);
+    memset(iteratorPtr, 0, sizeof(EventProfIter_t));
+    InitRemoteDlsListAccessObj(&iteratorPtr->threadRecList);
+    iteratorPtr->isThreadRecRead = false;
+    iteratorPtr->entryIndex = -1;
+
+    // Get the List for the process-under-inspection.
+    if (target_ReadAddress(PidToInspect, listAddrOffset, &(iteratorPtr->threadRecList.List),
+                          sizeof(iteratorPtr->threadRecList.List)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("event profile list"));
+    }
+
+    // Get the ListChgCntRef for the process-under-inspection.
+    if (target_ReadAddress(PidToInspect, listChgCntAddrOffset,
+                          &(iteratorPtr->threadRecList.ListChgCntRef),
+                          sizeof(iteratorPtr->threadRecList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("event profile list change counter ref"));
+    }
+
+    return iteratorPtr;
+}
+#endif
+
 #if LE_CONFIG_LINUX
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1027,6 +1165,50 @@ static size_t GetRefMapListChgCnt
     return refMapListChgCnt;
 }
 
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the process-wide mutex list change counter from the specified iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetMutexStatListChgCnt
+(
+    MutexStatIter_Ref_t iterator ///< [IN] The iterator to get the list change counter from.
+)
+{
+    size_t mutexListChgCnt;
+    if (target_ReadAddress(PidToInspect, (uintptr_t)(iterator->mutexList.ListChgCntRef),
+                          &mutexListChgCnt, sizeof(mutexListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("mutex list change counter"));
+    }
+
+    return mutexListChgCnt;
+}
+#endif
+
+#if LE_CONFIG_EVENT_PROFILING
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the event loop profiling record list change counter from the specified iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetEventProfListChgCnt
+(
+    EventProfIter_Ref_t iterator ///< [IN] The iterator to get the list change counter from.
+)
+{
+    size_t eventProfListChgCnt;
+    if (target_ReadAddress(PidToInspect, (uintptr_t)(iterator->threadRecList.ListChgCntRef),
+                          &eventProfListChgCnt, sizeof(eventProfListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("event profile list change counter"));
+    }
+
+    return eventProfListChgCnt;
+}
+#endif
+
 #if LE_CONFIG_LINUX
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1577,6 +1759,41 @@ static Mutex_t* GetNextMutex
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next mutex from the process-wide mutex list. For other detail see GetNextMemPool.
+ *
+ * @return
+ *      A mutex from the iterator's list of mutexes.
+ */
+//--------------------------------------------------------------------------------------------------
+static Mutex_t* GetNextMutexStat
+(
+    MutexStatIter_Ref_t mutexStatIterRef ///< [IN] The iterator to get the next mutex from.
+)
+{
+    le_dls_Link_t* linkPtr = GetNextDlsLink(&(mutexStatIterRef->mutexList),
+                                            &(mutexStatIterRef->currMutex.mutexListLink));
+
+    if (linkPtr == NULL)
+    {
+        return NULL;
+    }
+
+    // Get the address of mutex.
+    Mutex_t* remMutexPtr = CONTAINER_OF(linkPtr, Mutex_t, mutexListLink);
+
+    // Read the mutex into our own memory.
+    if (target_ReadAddress(PidToInspect, (uintptr_t)remMutexPtr, &(mutexStatIterRef->currMutex),
+                          sizeof(mutexStatIterRef->currMutex)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("mutex object"));
+    }
+
+    return &(mutexStatIterRef->currMutex);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the next semaphore. Since there's no "semaphore list" and therefore each thread object owns
@@ -1675,6 +1892,61 @@ static void* GetNextRefMap
 }
 
 
+#if LE_CONFIG_EVENT_PROFILING
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next event loop profiling entry from the specified iterator.  Each profiled thread
+ * first yields its Event Queue dispatch entry, then the entries of the handlers it has run.
+ * For other detail see GetNextMemPool.
+ *
+ * @return
+ *      The iterator, positioned on the next entry, or NULL if there are no more entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventProfIter_Ref_t GetNextEventProfEntry
+(
+    EventProfIter_Ref_t eventProfIterRef ///< [IN] The iterator to get the next entry from.
+)
+{
+    // Move to the next used entry of the current record.
+    if (eventProfIterRef->isThreadRecRead)
+    {
+        while (++(eventProfIterRef->entryIndex) < LE_CONFIG_EVENT_PROFILE_MAX_HANDLERS)
+        {
+            if (eventProfIterRef->currThreadRec.entries[eventProfIterRef->entryIndex].key != NULL)
+            {
+                return eventProfIterRef;
+            }
+        }
+    }
+
+    // Move on to the next record.
+    le_dls_Link_t* linkPtr = GetNextDlsLink(&(eventProfIterRef->threadRecList),
+                                            &(eventProfIterRef->currThreadRec.link));
+
+    if (linkPtr == NULL)
+    {
+        return NULL;
+    }
+
+    // Get the address of the record.
+    eventProf_ThreadRec_t* recPtr = CONTAINER_OF(linkPtr, eventProf_ThreadRec_t, link);
+
+    // Read the record into our own memory.
+    if (target_ReadAddress(PidToInspect, (uintptr_t)recPtr, &(eventProfIterRef->currThreadRec),
+                          sizeof(eventProfIterRef->currThreadRec)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("event profile record"));
+    }
+
+    eventProfIterRef->isThreadRecRead = true;
+    eventProfIterRef->entryIndex = -1;
+
+    return eventProfIterRef;
+}
+#endif
+
+
 #if LE_CONFIG_LINUX
 //--------------------------------------------------------------------------------------------------
 /**
@@ -1892,7 +2164,7 @@ static void PrintHelp
         "              Legato process.\n"
         "\n"
         "SYNOPSIS:\n"
-        "    inspect <pools|saferefs|threads|timers|mutexes|semaphores> [OPTIONS]"
+        "    inspect <pools|saferefs|threads|timers|mutexes|semaphores|events> [OPTIONS]"
 #if LE_CONFIG_LINUX
                                                                                  " PID"
 #endif
@@ -1910,9 +2182,21 @@ static void PrintHelp
 #if LE_CONFIG_LINUX_TARGET_TOOLS
         "    inspect mutexes            Prints the info of mutexes in all threads for the"
                                         " specified process.\n"
+        "    inspect mutexes --stats    Prints the lock acquisition and contention statistics of"
+                                        " all mutexes\n"
+        "                               of the specified process, whether they are currently\n"
+        "                               locked or not.\n"
         "    inspect semaphores         Prints the info of semaphores in all threads for the"
                                         " specified process.\n"
 #endif
+#if LE_CONFIG_EVENT_PROFILING
+        "    inspect events             Prints the event loop statistics of the profiled threads"
+                                        " of the specified process:\n"
+        "                               handler run-times, Event Queue dispatch latency and\n"
+        "                               depth.  Profiling is enabled by starting the process\n"
+        "                               with LE_EVENT_PROFILE=<slow handler threshold in ms>\n"
+        "                               or by calling le_event_EnableProfiling().\n"
+#endif
 #if LE_CONFIG_LINUX
         "    inspect ipc                Prints the info of ipc in all threads for the"
                                         " specified process.\n"
@@ -2051,6 +2335,17 @@ static ColumnInfo_t MutexTableInfo[] =
 };
 static size_t MutexTableInfoSize = NUM_ARRAY_MEMBERS(MutexTableInfo);
 
+static ColumnInfo_t MutexStatTableInfo[] =
+{
+    {"NAME",          "%*s", NULL, "%*s",        MAX_NAME_BYTES,   true,  0, true},
+    {"ACQUIRED",      "%*s", NULL, "%*"PRIu64"", sizeof(uint32_t), false, 0, true},
+    {"CONTENDED",     "%*s", NULL, "%*"PRIu64"", sizeof(uint32_t), false, 0, true},
+    {"AVG WAIT US",   "%*s", NULL, "%*"PRIu64"", sizeof(uint32_t), false, 0, true},
+    {"MAX WAIT US",   "%*s", NULL, "%*u",        sizeof(uint32_t), false, 0, true},
+    {"TOTAL WAIT US", "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, false}
+};
+static size_t MutexStatTableInfoSize = NUM_ARRAY_MEMBERS(MutexStatTableInfo);
+
 static ColumnInfo_t SemaphoreTableInfo[] =
 {
     {"NAME",         "%*s", NULL, "%*s", LIMIT_MAX_SEMAPHORE_NAME_BYTES, true,  0, true},
@@ -2067,6 +2362,24 @@ static ColumnInfo_t RefMapTableInfo[] =
 };
 static size_t RefMapTableInfoSize = NUM_ARRAY_MEMBERS(RefMapTableInfo);
 
+#if LE_CONFIG_EVENT_PROFILING
+static ColumnInfo_t EventProfTableInfo[] =
+{
+    {"THREAD",    "%*s",  NULL, "%*s",         MAX_THREAD_NAME_SIZE,               true,  0, true},
+    {"TYPE",      "%*s",  NULL, "%*s",         0,                                  true,  0, true},
+    {"HANDLER",   "%-*s", NULL, "%-*s",        LIMIT_MAX_EVENT_HANDLER_NAME_BYTES, true,  0, true},
+    {"COUNT",     "%*s",  NULL, "%*"PRIu64"",  sizeof(uint32_t),                   false, 0, true},
+    {"AVG US",    "%*s",  NULL, "%*"PRIu64"",  sizeof(uint32_t),                   false, 0, true},
+    {"P99 US",    "%*s",  NULL, "%*u",         sizeof(uint32_t),                   false, 0, true},
+    {"MAX US",    "%*s",  NULL, "%*u",         sizeof(uint32_t),                   false, 0, true},
+    {"SLOW",      "%*s",  NULL, "%*u",         sizeof(uint16_t),                   false, 0, true},
+    {"MAX DEPTH", "%*s",  NULL, "%*u",         sizeof(uint16_t),                   false, 0, true},
+    {"TOTAL US",  "%*s",  NULL, "%*"PRIu64"",  sizeof(uint64_t),                   false, 0, false},
+    {"HISTOGRAM", "%-*s", NULL, "%-*s",        0,                                  true,  0, false}
+};
+static size_t EventProfTableInfoSize = NUM_ARRAY_MEMBERS(EventProfTableInfo);
+#endif
+
 #if LE_CONFIG_LINUX
 static ColumnInfo_t ServiceObjTableInfo[] =
 {
@@ -2109,6 +2422,37 @@ typedef struct
 }
 DefnStrMapping_t;
 
+#if LE_CONFIG_EVENT_PROFILING
+// event loop profiling: handler type
+static DefnStrMapping_t EventProfTypeTbl[] =
+{
+    {
+        EVENT_PROF_TYPE_DISPATCH,
+        "dispatch"
+    },
+    {
+        EVENT_PROF_TYPE_QUEUED_FUNC,
+        "queued func"
+    },
+    {
+        EVENT_PROF_TYPE_EVENT,
+        "event"
+    },
+    {
+        EVENT_PROF_TYPE_FD_MONITOR,
+        "fd monitor"
+    },
+    {
+        EVENT_PROF_TYPE_TIMER,
+        "timer"
+    }
+};
+static int EventProfTypeTblSize = NUM_ARRAY_MEMBERS(EventProfTypeTbl);
+
+// Size of the text of a histogram: one count per bucket, up to 10 digits and a separator each.
+#define EVENT_PROF_HISTOGRAM_STR_BYTES  (EVENT_PROF_BUCKET_COUNT * 11)
+#endif
+
 #if LE_CONFIG_LINUX
 // pthread attribute: detach state
 static DefnStrMapping_t ThreadObjDetachStateTbl[] =
@@ -2335,6 +2679,16 @@ static void InitDisplayTable
                                                                        superPoolStrLen;
         InitDisplayTableMaxDataSize("SUB-POOL", table, tableSize, subPoolColumnStrLen);
     }
+#if LE_CONFIG_EVENT_PROFILING
+    else if (table == EventProfTableInfo)
+    {
+        InitDisplayTableMaxDataSize("TYPE", table, tableSize,
+                                    FindMaxStrSizeFromTable(EventProfTypeTbl,
+                                                            EventProfTypeTblSize));
+        InitDisplayTableMaxDataSize("HISTOGRAM", table, tableSize,
+                                    EVENT_PROF_HISTOGRAM_STR_BYTES - 1);
+    }
+#endif
 #if LE_CONFIG_LINUX
     else if (table == ServiceObjTableInfo)
     {
@@ -2420,6 +2774,10 @@ static void InitDisplay
             InitDisplayTable(MutexTableInfo, MutexTableInfoSize);
             break;
 
+        case INSPECT_INSP_TYPE_MUTEX_STATS:
+            InitDisplayTable(MutexStatTableInfo, MutexStatTableInfoSize);
+            break;
+
         case INSPECT_INSP_TYPE_SEMAPHORE:
             InitDisplayTable(SemaphoreTableInfo, SemaphoreTableInfoSize);
             break;
@@ -2429,6 +2787,12 @@ static void InitDisplay
             InitDisplayTable(RefMapTableInfo, RefMapTableInfoSize);
             break;
 
+#if LE_CONFIG_EVENT_PROFILING
+        case INSPECT_INSP_TYPE_EVENT_PROF:
+            InitDisplayTable(EventProfTableInfo, EventProfTableInfoSize);
+            break;
+#endif
+
 #if LE_CONFIG_LINUX
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             InitDisplayTable(ServiceObjTableInfo, ServiceObjTableInfoSize);
@@ -2622,6 +2986,12 @@ static int PrintInspectHeader
             tableSize = MutexTableInfoSize;
             break;
 
+        case INSPECT_INSP_TYPE_MUTEX_STATS:
+            strncpy(inspectTypeString, "Mutex Contention Statistics", inspectTypeStringSize);
+            table = MutexStatTableInfo;
+            tableSize = MutexStatTableInfoSize;
+            break;
+
         case INSPECT_INSP_TYPE_SEMAPHORE:
             strncpy(inspectTypeString, "Semaphores", inspectTypeStringSize);
             table = SemaphoreTableInfo;
@@ -2635,6 +3005,14 @@ static int PrintInspectHeader
             tableSize = RefMapTableInfoSize;
             break;
 
+#if LE_CONFIG_EVENT_PROFILING
+        case INSPECT_INSP_TYPE_EVENT_PROF:
+            strncpy(inspectTypeString, "Event Loop Statistics", inspectTypeStringSize);
+            table = EventProfTableInfo;
+            tableSize = EventProfTableInfoSize;
+            break;
+#endif
+
 #if LE_CONFIG_LINUX
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             strncpy(inspectTypeString, "IPC Server Interface", inspectTypeStringSize);
@@ -3747,6 +4125,81 @@ static int PrintMutexInfo
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print mutex contention statistics to stdout.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrintMutexStatInfo
+(
+    Mutex_t* mutexRef   ///< [IN] ref to mutex to be printed.
+)
+{
+    int lineCount = 0;
+
+    uint64_t avgWaitUs = 0;
+    if (mutexRef->contendedCount > 0)
+    {
+        avgWaitUs = mutexRef->totalWaitUs / mutexRef->contendedCount;
+    }
+
+    // Output mutex statistics
+    int index = 0;
+
+    if (!IsOutputJson)
+    {
+        FillStrColField   (MUTEX_NAME(mutexRef->name), MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index);
+        FillUint64ColField(mutexRef->acquireCount,     MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index);
+        FillUint64ColField(mutexRef->contendedCount,   MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index);
+        FillUint64ColField(avgWaitUs,                  MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index);
+        FillUint32ColField(mutexRef->maxWaitUs,        MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index);
+        FillUint64ColField(mutexRef->totalWaitUs,      MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index);
+
+        PrintInfo(MutexStatTableInfo, MutexStatTableInfoSize);
+        lineCount++;
+    }
+    else
+    {
+        // If it's not the first time, print a comma.
+        if (!IsPrintedNodeFirst)
+        {
+            printf(",");
+        }
+        else
+        {
+            IsPrintedNodeFirst = false;
+        }
+
+        bool printed = false;
+
+        printf("[");
+
+        ExportStrToJson   (MUTEX_NAME(mutexRef->name), MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index, &printed);
+        ExportUint64ToJson(mutexRef->acquireCount,     MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index, &printed);
+        ExportUint64ToJson(mutexRef->contendedCount,   MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index, &printed);
+        ExportUint64ToJson(avgWaitUs,                  MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index, &printed);
+        ExportUint32ToJson(mutexRef->maxWaitUs,        MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index, &printed);
+        ExportUint64ToJson(mutexRef->totalWaitUs,      MutexStatTableInfo,
+                           MutexStatTableInfoSize, &index, &printed);
+
+        printf("]");
+    }
+
+    return lineCount;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print semaphore information to stdout.
@@ -3922,6 +4375,200 @@ static int PrintRefMapInfo
 }
 
 
+#if LE_CONFIG_EVENT_PROFILING
+//--------------------------------------------------------------------------------------------------
+/**
+ * Estimate the 99th percentile of a run-time histogram.
+ *
+ * @return The upper bound of the bucket holding the 99th percentile, capped at the maximum
+ *         run-time, in microseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetEventProfP99
+(
+    const eventProf_Entry_t* entryPtr   ///< [IN] Entry to get the percentile of.
+)
+{
+    uint64_t sampleCount = 0;
+    int i;
+
+    for (i = 0; i < EVENT_PROF_BUCKET_COUNT; i++)
+    {
+        sampleCount += entryPtr->histogram[i];
+    }
+
+    // Number of samples at or below the 99th percentile, rounded up.
+    uint64_t target = (sampleCount * 99 + 99) / 100;
+    uint64_t seen = 0;
+
+    for (i = 0; i < EVENT_PROF_BUCKET_COUNT; i++)
+    {
+        seen += entryPtr->histogram[i];
+        if ((seen >= target) && (seen > 0))
+        {
+            uint32_t bucketTopUs = ((uint32_t)1 << i);
+            return (bucketTopUs < entryPtr->maxUs) ? bucketTopUs : entryPtr->maxUs;
+        }
+    }
+
+    return entryPtr->maxUs;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print event loop profiling entry information to stdout.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrintEventProfInfo
+(
+    EventProfIter_Ref_t eventProfIterRef    ///< [IN] iterator positioned on the entry to print.
+)
+{
+    int lineCount = 0;
+
+    int index = 0;
+
+    eventProf_ThreadRec_t* recPtr = &(eventProfIterRef->currThreadRec);
+    eventProf_Entry_t* entryPtr = &(recPtr->dispatch);
+
+    if (eventProfIterRef->entryIndex >= 0)
+    {
+        entryPtr = &(recPtr->entries[eventProfIterRef->entryIndex]);
+    }
+
+    char* typeStr = DefnToStr(entryPtr->type, EventProfTypeTbl, EventProfTypeTblSize);
+    uint64_t avgUs = (entryPtr->count > 0) ? (entryPtr->totalUs / entryPtr->count) : 0;
+    uint32_t p99Us = GetEventProfP99(entryPtr);
+
+    // Make sure the strings read from the remote process are terminated.
+    recPtr->threadName[sizeof(recPtr->threadName) - 1] = '\0';
+    entryPtr->name[sizeof(entryPtr->name) - 1] = '\0';
+
+    // The histogram is printed as a comma-separated list of bucket counts.
+    char histogramStr[EVENT_PROF_HISTOGRAM_STR_BYTES + 2] = "";
+    size_t histogramLen = 0;
+    int i;
+
+    if (IsOutputJson)
+    {
+        histogramLen += snprintf(histogramStr, sizeof(histogramStr), "[");
+    }
+    for (i = 0; i < EVENT_PROF_BUCKET_COUNT; i++)
+    {
+        histogramLen += snprintf(histogramStr + histogramLen, sizeof(histogramStr) - histogramLen,
+                                 "%s%" PRIu32, (i > 0) ? "," : "", entryPtr->histogram[i]);
+    }
+    if (IsOutputJson)
+    {
+        snprintf(histogramStr + histogramLen, sizeof(histogramStr) - histogramLen, "]");
+    }
+
+    if (!IsOutputJson)
+    {
+        FillStrColField(recPtr->threadName,
+                        EventProfTableInfo,
+                        EventProfTableInfoSize, &index);
+        FillStrColField(typeStr,
+                        EventProfTableInfo,
+                        EventProfTableInfoSize, &index);
+        FillStrColField(entryPtr->name,
+                        EventProfTableInfo,
+                        EventProfTableInfoSize, &index);
+        FillUint64ColField(entryPtr->count,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index);
+        FillUint64ColField(avgUs,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index);
+        FillUint32ColField(p99Us,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index);
+        FillUint32ColField(entryPtr->maxUs,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index);
+        FillUint32ColField(entryPtr->slowCount,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index);
+        FillUint32ColField(entryPtr->maxQueueDepth,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index);
+        FillUint64ColField(entryPtr->totalUs,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index);
+        FillStrColField(histogramStr,
+                        EventProfTableInfo,
+                        EventProfTableInfoSize, &index);
+
+        PrintInfo(EventProfTableInfo, EventProfTableInfoSize);
+        lineCount++;
+    }
+    else
+    {
+        if (!IsPrintedNodeFirst)
+        {
+            printf(",");
+        }
+        else
+        {
+            IsPrintedNodeFirst = false;
+        }
+
+        bool printed = false;
+        printf("[");
+
+        ExportStrToJson(recPtr->threadName,
+                        EventProfTableInfo,
+                        EventProfTableInfoSize, &index,
+                        &printed);
+        ExportStrToJson(typeStr,
+                        EventProfTableInfo,
+                        EventProfTableInfoSize, &index,
+                        &printed);
+        ExportStrToJson(entryPtr->name,
+                        EventProfTableInfo,
+                        EventProfTableInfoSize, &index,
+                        &printed);
+        ExportUint64ToJson(entryPtr->count,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index,
+                           &printed);
+        ExportUint64ToJson(avgUs,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index,
+                           &printed);
+        ExportUint32ToJson(p99Us,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index,
+                           &printed);
+        ExportUint32ToJson(entryPtr->maxUs,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index,
+                           &printed);
+        ExportUint32ToJson(entryPtr->slowCount,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index,
+                           &printed);
+        ExportUint32ToJson(entryPtr->maxQueueDepth,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index,
+                           &printed);
+        ExportUint64ToJson(entryPtr->totalUs,
+                           EventProfTableInfo,
+                           EventProfTableInfoSize, &index,
+                           &printed);
+        ExportArrayToJson(histogramStr,
+                          EventProfTableInfo,
+                          EventProfTableInfoSize, &index,
+                          &printed);
+        printf("]");
+    }
+
+    return lineCount;
+}
+#endif
+
+
 #if LE_CONFIG_LINUX
 //--------------------------------------------------------------------------------------------------
 /**
@@ -4303,6 +4950,13 @@ static void InspectFunc
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintMutexInfo;
             break;
 
+        case INSPECT_INSP_TYPE_MUTEX_STATS:
+            createIterFunc    = (CreateIterFunc_t)    CreateMutexStatIter;
+            getListChgCntFunc = (GetListChgCntFunc_t) GetMutexStatListChgCnt;
+            getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextMutexStat;
+            printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintMutexStatInfo;
+            break;
+
         case INSPECT_INSP_TYPE_SEMAPHORE:
             createIterFunc    = (CreateIterFunc_t)    CreateSemaphoreIter;
             getListChgCntFunc = (GetListChgCntFunc_t) GetThreadMemberObjListChgCnt;
@@ -4318,6 +4972,15 @@ static void InspectFunc
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintRefMapInfo;
             break;
 
+#if LE_CONFIG_EVENT_PROFILING
+        case INSPECT_INSP_TYPE_EVENT_PROF:
+            createIterFunc    = (CreateIterFunc_t)    CreateEventProfIter;
+            getListChgCntFunc = (GetListChgCntFunc_t) GetEventProfListChgCnt;
+            getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextEventProfEntry;
+            printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintEventProfInfo;
+            break;
+#endif
+
 #if LE_CONFIG_LINUX
         case INSPECT_INSP_TYPE_IPC_SERVERS:
             createIterFunc    = (CreateIterFunc_t)    CreateServiceObjIter;
@@ -4563,6 +5226,12 @@ static void CommandArgHandler
     {
         InspectType = INSPECT_INSP_TYPE_SAFE_REF;
     }
+#if LE_CONFIG_EVENT_PROFILING
+    else if (strcmp(command, "events") == 0)
+    {
+        InspectType = INSPECT_INSP_TYPE_EVENT_PROF;
+    }
+#endif
 #if LE_CONFIG_LINUX
     else if (strcmp(command, "ipc") == 0)
     {
@@ -4646,6 +5315,9 @@ COMPONENT_INIT
     IsOutputJson = false;
     IsFollowing = false;
     IsVerbose = false;
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+    IsStats = false;
+#endif
     TimerTypeIndex = TIMER_NON_WAKEUP;
 
     // The command-line has a command string followed by a PID.
@@ -4660,6 +5332,11 @@ COMPONENT_INIT
     // -v option prints in verbose mode.
     le_arg_SetFlagVar(&IsVerbose, "v", NULL);
 
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+    // --stats option prints the mutex contention statistics.
+    le_arg_SetFlagVar(&IsStats, NULL, "stats");
+#endif
+
     // --interval=N option specifies the update period (implies -f).
     le_arg_SetIntCallback(FollowOptionCallback, NULL, "interval");
 
@@ -4668,6 +5345,19 @@ COMPONENT_INIT
 
     le_arg_Scan();
 
+#if LE_CONFIG_LINUX_TARGET_TOOLS
+    if (IsStats)
+    {
+        if (InspectType != INSPECT_INSP_TYPE_MUTEX)
+        {
+            fprintf(stderr, "The --stats option is only supported by 'inspect mutexes'.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        InspectType = INSPECT_INSP_TYPE_MUTEX_STATS;
+    }
+#endif
+
     // Create a memory pool for iterators.
     if (!IteratorPool)
     {
@@ -210,6 +210,7 @@ static void PrintHelp
         "    app status [<appName>]\n"
         "    app version <appName>\n"
         "    app info [<appName>]\n"
+        "    app stats [<appName>]\n"
         "    app runProc <appName> <procName> [options]\n"
         "    app runProc <appName> [<procName>] --exe=<exePath> [options]\n"
         "\n"
@@ -260,6 +261,12 @@ static void PrintHelp
         "       If no name is given, prints the information of all installed applications.\n"
         "       If a name is given, prints the information of the specified application.\n"
         "\n"
+        "    app stats [<appName>]\n"
+        "       If no name is given, prints the last resource usage sample of all installed\n"
+        "       applications.\n"
+        "       If a name is given, prints the resource usage history of the specified application,\n"
+        "       oldest sample first.\n"
+        "\n"
         "    app runProc <appName> <procName> [options]\n"
         "       Runs a configured process inside an app using the process settings from the\n"
         "       configuration database.  If an exePath is provided as an option then the specified\n"
@@ -1247,6 +1254,117 @@ static void ListApps
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the header of a table of resource usage samples.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintSampleHeader
+(
+    const char* firstColumnPtr  ///< [IN] Title of the first column.
+)
+{
+    printf("%-24s %8s %10s %10s %5s %7s %5s %7s\n",
+           firstColumnPtr, "CPU%", "MEM(KB)", "MAXMEM(KB)", "PROCS", "THREADS", "FDS", "SOCKETS");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints a resource usage sample as a row of a table.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintSample
+(
+    const char* firstColumnPtr,             ///< [IN] Value of the first column.
+    const le_appStats_Sample_t* samplePtr   ///< [IN] Sample to print.
+)
+{
+    printf("%-24s %5u.%02u %10" PRIu64 " %10" PRIu64 " %5u %7u %5u %7u\n",
+           firstColumnPtr,
+           samplePtr->cpuLoad / 100, samplePtr->cpuLoad % 100,
+           samplePtr->memUsed / 1024, samplePtr->maxMemUsed / 1024,
+           samplePtr->numProcs, samplePtr->numThreads,
+           samplePtr->numFds, samplePtr->numSockets);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the last resource usage sample of an application.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintAppLatestSample
+(
+    const char* appNamePtr      ///< [IN] Application name.
+)
+{
+    le_appStats_Sample_t sample;
+
+    if (le_appStats_GetLatest(appNamePtr, &sample) == LE_OK)
+    {
+        PrintSample(appNamePtr, &sample);
+    }
+    else
+    {
+        printf("%-24s %8s\n", appNamePtr, "-");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implements the "stats" command.
+ *
+ * @note This function does not return.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PrintStats
+(
+    void
+)
+{
+    le_appStats_ConnectService();
+
+    if (le_appStats_GetInterval() == 0)
+    {
+        fprintf(stderr, "App resource usage sampling is disabled.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (AppNamePtr == NULL)
+    {
+        PrintSampleHeader("APP");
+        ListInstalledApps(PrintAppLatestSample);
+    }
+    else
+    {
+        le_appStats_Sample_t samples[LE_APPSTATS_MAX_SAMPLES];
+        size_t numSamples = NUM_ARRAY_MEMBERS(samples);
+
+        if (le_appStats_GetHistory(AppNamePtr, samples, &numSamples) != LE_OK)
+        {
+            printf("No resource usage sampled for app '%s'.\n", AppNamePtr);
+            exit(EXIT_FAILURE);
+        }
+
+        PrintSampleHeader("TIME(s)");
+
+        size_t i;
+        for (i = 0; i < numSamples; i++)
+        {
+            char time[32];
+
+            snprintf(time, sizeof(time), "%" PRIu64 ".%03u",
+                     samples[i].timestamp / 1000, (unsigned int)(samples[i].timestamp % 1000));
+            PrintSample(time, &samples[i]);
+        }
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prints the application version.
@@ -1938,6 +2056,14 @@ static void CommandArgHandler
         le_arg_AddPositionalCallback(AppNameArgHandler);
         le_arg_AllowLessPositionalArgsThanCallbacks();
     }
+    else if (strcmp(command, "stats") == 0)
+    {
+        CommandFunc = PrintStats;
+
+        // Accept an optional app name argument.
+        le_arg_AddPositionalCallback(AppNameArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
     else
     {
         fprintf(stderr, "Unknown command '%s'.  Try --help.\n", command);
@@ -0,0 +1,536 @@
+/** @file boottrace.c
+ *
+ * Boot trace tool.  Displays the trace of the framework's last start-up (or of the start-up in
+ * progress) recorded by the start program, the Supervisor and the framework daemons, as a
+ * timeline followed by a summary of the framework daemons' start-up times.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "bootTrace.h"
+#include "sysPaths.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of framework daemons listed in the summary.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_DAEMONS     32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start-up times of a framework daemon.  Times are 0 if the event was not recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pid_t       pid;                                ///< Process ID of the daemon.
+    char        name[BOOT_TRACE_NAME_BYTES];        ///< Name of the daemon.
+    uint64_t    execUs;                             ///< Time the daemon was forked.
+    uint64_t    advertiseUs;                        ///< Time the daemon advertised a service.
+    uint64_t    readyUs;                            ///< Time the daemon signalled it was ready.
+}
+Daemon_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Framework daemons found in the trace.
+ */
+//--------------------------------------------------------------------------------------------------
+static Daemon_t Daemons[MAX_DAEMONS];
+static size_t NumDaemons = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records of the trace, sorted by time once they have all been read.  The processes append their
+ * records independently, so they are not always in time order in the file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bootTrace_Entry_t   entry;                      ///< Record.
+    size_t              index;                      ///< Position of the record in the file.
+}
+Record_t;
+
+static Record_t* Records = NULL;
+static size_t NumRecords = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path of the trace file given on the command line, or NULL to use the default one.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* TracePathPtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Display names of the events, indexed by bootTrace_Event_t.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* const EventNames[BOOT_TRACE_EVENT_COUNT] =
+{
+    [BOOT_TRACE_HEADER]       = "header",
+    [BOOT_TRACE_PHASE]        = "phase",
+    [BOOT_TRACE_DAEMON_EXEC]  = "exec",
+    [BOOT_TRACE_DAEMON_READY] = "ready",
+    [BOOT_TRACE_ADVERTISE]    = "advertise",
+    [BOOT_TRACE_APP_START]    = "app start",
+    [BOOT_TRACE_DONE]         = "done",
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints help to stdout and exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintHelp
+(
+    void
+)
+{
+    puts(
+        "NAME:\n"
+        "    boottrace - Displays the trace of the framework's start-up.\n"
+        "\n"
+        "SYNOPSIS:\n"
+        "    boottrace [OPTIONS]\n"
+        "\n"
+        "DESCRIPTION:\n"
+        "    Displays the start-up trace recorded by the start program, the Supervisor and the\n"
+        "    framework daemons as a timeline, followed by the time each framework daemon took to\n"
+        "    advertise its first service and to become ready.  The trace of the start-up in\n"
+        "    progress is displayed if there is one, otherwise the trace of the last start-up is.\n"
+        "\n"
+        "    Times are in milliseconds, relative to the first event of the trace.  DELTA is the\n"
+        "    time to the next event, i.e., the duration of phases.\n"
+        "\n"
+        "OPTIONS:\n"
+        "    -f, --file=PATH\n"
+        "        Read the trace from PATH.\n"
+        "\n"
+        "    -h, --help\n"
+        "        Print this help text and exit.\n"
+        );
+
+    exit(EXIT_SUCCESS);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the next record from the trace file.
+ *
+ * @return
+ *      LE_OK if a record was read.
+ *      LE_OUT_OF_RANGE at the end of the file.
+ *      LE_FAULT if the file could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadEntry
+(
+    int fd,
+    bootTrace_Entry_t* entryPtr
+)
+{
+    size_t numBytes = 0;
+
+    while (numBytes < sizeof(*entryPtr))
+    {
+        ssize_t result = read(fd, (char*)entryPtr + numBytes, sizeof(*entryPtr) - numBytes);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return LE_FAULT;
+        }
+        if (result == 0)
+        {
+            // A partial record is being written by a process still starting up.
+            return LE_OUT_OF_RANGE;
+        }
+
+        numBytes += result;
+    }
+
+    entryPtr->name[sizeof(entryPtr->name) - 1] = '\0';
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read all the records that follow the header of the trace file.
+ *
+ * @return
+ *      LE_OK if the records were read.
+ *      LE_FAULT if the file could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRecords
+(
+    int fd
+)
+{
+    size_t maxRecords = 0;
+    le_result_t result;
+
+    do
+    {
+        if (NumRecords == maxRecords)
+        {
+            maxRecords = (maxRecords == 0) ? 64 : (maxRecords * 2);
+            Records = realloc(Records, maxRecords * sizeof(Record_t));
+            LE_ASSERT(Records != NULL);
+        }
+
+        result = ReadEntry(fd, &Records[NumRecords].entry);
+        if (result == LE_OK)
+        {
+            Records[NumRecords].index = NumRecords;
+            NumRecords++;
+        }
+    }
+    while (result == LE_OK);
+
+    return (result == LE_OUT_OF_RANGE) ? LE_OK : result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two records by time, then by position in the file so that the sort is stable.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareRecords
+(
+    const void* aPtr,
+    const void* bPtr
+)
+{
+    const Record_t* recordAPtr = aPtr;
+    const Record_t* recordBPtr = bPtr;
+
+    if (recordAPtr->entry.timeUs != recordBPtr->entry.timeUs)
+    {
+        return (recordAPtr->entry.timeUs < recordBPtr->entry.timeUs) ? -1 : 1;
+    }
+
+    return (recordAPtr->index < recordBPtr->index) ? -1 : 1;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a duration in milliseconds, or "?" if the end is before the start, which happens when the
+ * clock was adjusted during the start-up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintDuration
+(
+    int width,
+    uint64_t startUs,
+    uint64_t endUs
+)
+{
+    if (endUs < startUs)
+    {
+        printf(" %*s", width, "?");
+    }
+    else
+    {
+        printf(" %*.3f", width, (double)(endUs - startUs) / 1000.0);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a framework daemon by process ID.
+ *
+ * @return The daemon, or NULL if the process is not a framework daemon.
+ */
+//--------------------------------------------------------------------------------------------------
+static Daemon_t* FindDaemon
+(
+    pid_t pid
+)
+{
+    size_t i;
+
+    for (i = 0; i < NumDaemons; i++)
+    {
+        if (Daemons[i].pid == pid)
+        {
+            return &Daemons[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Account a record to the framework daemon it relates to, if any.  The exec records must be
+ * accounted first, as the other records of a daemon can be recorded before its exec record.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AccountDaemonEvent
+(
+    const bootTrace_Entry_t* entryPtr
+)
+{
+    Daemon_t* daemonPtr = FindDaemon(entryPtr->pid);
+
+    if ((daemonPtr == NULL) && (entryPtr->event == BOOT_TRACE_DAEMON_EXEC))
+    {
+        if (NumDaemons >= MAX_DAEMONS)
+        {
+            return;
+        }
+
+        daemonPtr = &Daemons[NumDaemons++];
+        memset(daemonPtr, 0, sizeof(*daemonPtr));
+        daemonPtr->pid = entryPtr->pid;
+        LE_ASSERT_OK(le_utf8_Copy(daemonPtr->name, entryPtr->name, sizeof(daemonPtr->name), NULL));
+    }
+
+    if (daemonPtr == NULL)
+    {
+        return;
+    }
+
+    switch (entryPtr->event)
+    {
+        case BOOT_TRACE_DAEMON_EXEC:
+            daemonPtr->execUs = entryPtr->timeUs;
+            break;
+
+        case BOOT_TRACE_ADVERTISE:
+            daemonPtr->advertiseUs = entryPtr->timeUs;
+            break;
+
+        case BOOT_TRACE_DAEMON_READY:
+            daemonPtr->readyUs = entryPtr->timeUs;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the start-up time of an event relative to the daemon's launch, or "-" if not recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintDaemonTime
+(
+    const Daemon_t* daemonPtr,
+    uint64_t timeUs
+)
+{
+    if ((timeUs == 0) || (daemonPtr->execUs == 0))
+    {
+        printf(" %14s", "-");
+    }
+    else
+    {
+        PrintDuration(14, daemonPtr->execUs, timeUs);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a line of the timeline.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintEntry
+(
+    const bootTrace_Entry_t* entryPtr,
+    uint64_t firstUs,                       ///< [IN] Time of the first event.
+    const bootTrace_Entry_t* nextEntryPtr   ///< [IN] Next record, or NULL if this is the last one.
+)
+{
+    const Daemon_t* daemonPtr = FindDaemon(entryPtr->pid);
+    const char* eventNamePtr = "?";
+
+    if (entryPtr->event < BOOT_TRACE_EVENT_COUNT)
+    {
+        eventNamePtr = EventNames[entryPtr->event];
+    }
+
+    printf("%10.3f", (double)(entryPtr->timeUs - firstUs) / 1000.0);
+
+    if (nextEntryPtr == NULL)
+    {
+        printf(" %10s", "");
+    }
+    else
+    {
+        PrintDuration(10, entryPtr->timeUs, nextEntryPtr->timeUs);
+    }
+
+    printf(" %7d  %-16s  %-10s  %s\n",
+           (int)entryPtr->pid,
+           (daemonPtr == NULL ? "" : daemonPtr->name),
+           eventNamePtr,
+           entryPtr->name);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the trace.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintTrace
+(
+    int fd,
+    bool isInProgress
+)
+{
+    bootTrace_Entry_t header;
+
+    if (   (ReadEntry(fd, &header) != LE_OK)
+        || (header.event != BOOT_TRACE_HEADER)
+        || (strcmp(header.name, BOOT_TRACE_MAGIC) != 0))
+    {
+        fprintf(stderr, "Not a boot trace.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (header.pid != BOOT_TRACE_VERSION)
+    {
+        fprintf(stderr, "Unsupported boot trace version %d.\n", (int)header.pid);
+        exit(EXIT_FAILURE);
+    }
+
+    time_t startTime = (time_t)(header.timeUs / 1000000);
+    char timeStr[64];
+
+    if (strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&startTime)) == 0)
+    {
+        timeStr[0] = '\0';
+    }
+
+    printf("Framework start-up of %s%s\n\n", timeStr, (isInProgress ? " (in progress)" : ""));
+    printf("%10s %10s %7s  %-16s  %-10s  %s\n",
+           "TIME(ms)", "DELTA(ms)", "PID", "DAEMON", "EVENT", "NAME");
+
+    if (ReadRecords(fd) != LE_OK)
+    {
+        fprintf(stderr, "Failed to read boot trace: %m.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (NumRecords > 0)
+    {
+        qsort(Records, NumRecords, sizeof(Record_t), CompareRecords);
+    }
+
+    uint64_t firstUs = (NumRecords > 0) ? Records[0].entry.timeUs : 0;
+    uint64_t doneUs = 0;
+    size_t i;
+
+    for (i = 0; i < NumRecords; i++)
+    {
+        if (Records[i].entry.event == BOOT_TRACE_DAEMON_EXEC)
+        {
+            AccountDaemonEvent(&Records[i].entry);
+        }
+    }
+
+    for (i = 0; i < NumRecords; i++)
+    {
+        const bootTrace_Entry_t* entryPtr = &Records[i].entry;
+
+        if (entryPtr->event != BOOT_TRACE_DAEMON_EXEC)
+        {
+            AccountDaemonEvent(entryPtr);
+        }
+
+        if (entryPtr->event == BOOT_TRACE_DONE)
+        {
+            doneUs = entryPtr->timeUs;
+        }
+
+        PrintEntry(entryPtr, firstUs, (i + 1 < NumRecords) ? &Records[i + 1].entry : NULL);
+    }
+
+    if (NumDaemons > 0)
+    {
+        printf("\n%-16s %7s %14s %14s\n", "DAEMON", "PID", "ADVERTISE(ms)", "READY(ms)");
+
+        for (i = 0; i < NumDaemons; i++)
+        {
+            printf("%-16s %7d", Daemons[i].name, (int)Daemons[i].pid);
+            PrintDaemonTime(&Daemons[i], Daemons[i].advertiseUs);
+            PrintDaemonTime(&Daemons[i], Daemons[i].readyUs);
+            printf("\n");
+        }
+    }
+
+    if (doneUs != 0)
+    {
+        printf("\nStart-up took %.3f ms.\n", (double)(doneUs - firstUs) / 1000.0);
+    }
+}
+
+
+COMPONENT_INIT
+{
+    le_arg_SetFlagCallback(PrintHelp, "h", "help");
+    le_arg_SetStringVar(&TracePathPtr, "f", "file");
+    le_arg_Scan();
+
+    bool isInProgress = false;
+    int fd;
+
+    if (TracePathPtr != NULL)
+    {
+        fd = open(TracePathPtr, O_RDONLY);
+    }
+    else
+    {
+        TracePathPtr = BOOT_TRACE_RECORDING_PATH;
+        fd = open(TracePathPtr, O_RDONLY);
+
+        if (fd != -1)
+        {
+            isInProgress = true;
+        }
+        else if (errno == ENOENT)
+        {
+            TracePathPtr = BOOT_TRACE_PATH;
+            fd = open(TracePathPtr, O_RDONLY);
+        }
+    }
+
+    if (fd == -1)
+    {
+        fprintf(stderr, "Cannot open boot trace '%s': %m.\n", TracePathPtr);
+        exit(EXIT_FAILURE);
+    }
+
+    PrintTrace(fd, isInProgress);
+
+    close(fd);
+
+    exit(EXIT_SUCCESS);
+}
@@ -26,6 +26,16 @@ $ log trace keyword processName/componentName
  * To disable a trace:
  * @verbatim
 $ log stoptrace keyword processName/componentName
+@endverbatim
+ *
+ * To list the counters of the lines logged from apps' standard out and standard error:
+ * @verbatim
+$ log stats
+@endverbatim
+ *
+ * To print the errors logged by an app in the last 10 minutes, from the persistent log store:
+ * @verbatim
+$ log show appName --since=-600 --level=ERROR
 @endverbatim
  *
  *
@@ -52,6 +62,7 @@ $ log stoptrace keyword processName/componentName
 #include "legato.h"
 #include "log.h"
 #include "logDaemon.h"
+#include "logStore.h"
 #include "limit.h"
 #include <ctype.h>
 
@@ -99,6 +110,29 @@ static const char* SessionIdPtr = DEFAULT_SESSION_ID;
 static bool ErrorOccurred = false;
 
 
+#if LE_CONFIG_LOG_STORE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Options of the "show" command, as given on the command line.  NULL if not given.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const char* ShowAppNamePtr = NULL;
+static const char* ShowSincePtr = NULL;
+static const char* ShowUntilPtr = NULL;
+static const char* ShowLevelPtr = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time range (in ms since the Epoch) and minimum severity level of the "show" command.
+ **/
+//--------------------------------------------------------------------------------------------------
+static uint64_t ShowStartTime = 0;
+static uint64_t ShowEndTime = UINT64_MAX;
+static le_log_Level_t ShowMinLevel = LE_LOG_DEBUG;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Prints help to stdout.
@@ -119,6 +153,10 @@ static void PrintHelpAndExit
         "    log trace KEYWORD_STR [DESTINATION]\n"
         "    log stoptrace KEYWORD_STR [DESTINATION]\n"
         "    log forget PROCESS_NAME\n"
+        "    log stats\n"
+#if LE_CONFIG_LOG_STORE
+        "    log show [APP_NAME] [--since=TIME] [--until=TIME] [--level=FILTER_STR]\n"
+#endif
         "\n"
         "DESCRIPTION:\n"
         "    log list            Lists all processes/components registered with the\n"
@@ -146,6 +184,23 @@ static void PrintHelpAndExit
         "                        Future processes with that name will have default\n"
         "                        settings.\n"
         "\n"
+        "    log stats           Lists, for each app, the number of lines logged from\n"
+        "                        the standard out and standard error of its processes,\n"
+        "                        the number of bytes and reads these lines came from,\n"
+        "                        and the number of lines suppressed because the app\n"
+        "                        exceeded its log rate limit.\n"
+        "\n"
+#if LE_CONFIG_LOG_STORE
+        "    log show            Prints the messages kept in the persistent log store,\n"
+        "                        oldest first, optionally only those of one app,\n"
+        "                        in a time range, or at least as severe as a\n"
+        "                        FILTER_STR.  A TIME is either a local date and time\n"
+        "                        (\"YYYY-MM-DD HH:MM:SS\") or a number of seconds\n"
+        "                        before now preceded by a '-' (e.g., -600 for the\n"
+        "                        last 10 minutes).  Works even if the log daemon is\n"
+        "                        not running.\n"
+        "\n"
+#endif
         "The [DESTINATION] is optional and specifies the process and component to\n"
         "send the command to.  The [DESTINATION] must be in this format:\n"
         "\n"
@@ -172,6 +227,66 @@ static void PrintHelpAndExit
 }
 
 
+#if LE_CONFIG_LOG_STORE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints a record of the log store.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void PrintStoredRecord
+(
+    uint64_t timestamp,         ///< [IN] Time of the record, in ms since the Epoch.
+    le_log_Level_t level,       ///< [IN] Severity level (already part of the text).
+    const char* appNamePtr,     ///< [IN] App that logged the record.
+    const char* textPtr,        ///< [IN] Text of the record.
+    void* contextPtr            ///< [IN] Not used.
+)
+{
+    time_t sec = timestamp / 1000;
+    struct tm tm;
+    char timeStr[32] = "";
+
+    if (localtime_r(&sec, &tm) != NULL)
+    {
+        strftime(timeStr, sizeof(timeStr), "%b %e %H:%M:%S", &tm);
+    }
+
+    printf("%s.%03u %s | %s\n", timeStr, (unsigned int)(timestamp % 1000), appNamePtr, textPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prints the messages of the log store that match the options of the "show" command, and exits.
+ **/
+//--------------------------------------------------------------------------------------------------
+__attribute__ ((__noreturn__))
+static void ShowStoredLogs
+(
+    void
+)
+{
+    le_result_t result = logStore_Query(ShowStartTime,
+                                        ShowEndTime,
+                                        ShowAppNamePtr,
+                                        ShowMinLevel,
+                                        PrintStoredRecord,
+                                        NULL);
+    if (result == LE_NOT_FOUND)
+    {
+        printf("The log store is empty.\n");
+    }
+    else if (result != LE_OK)
+    {
+        printf("***ERROR: Can't read the log store.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handles a message received from the Log Control Daemon.
@@ -210,10 +325,16 @@ static void SessionCloseHandler
     {
         exit(EXIT_FAILURE);
     }
-    else
+
+#if LE_CONFIG_LOG_STORE
+    // The log daemon has written the records it buffered, the store can be read now.
+    if (Command == LOG_CMD_FLUSH_STORE)
     {
-        exit(EXIT_SUCCESS);
+        ShowStoredLogs();
     }
+#endif
+
+    exit(EXIT_SUCCESS);
 }
 
 
@@ -239,6 +360,14 @@ static le_msg_SessionRef_t ConnectToLogControlDaemon
     le_result_t result = le_msg_TryOpenSessionSync(sessionRef);
     if (result != LE_OK)
     {
+#if LE_CONFIG_LOG_STORE
+        // The log store can be read without the daemon, only the records it buffered are missing.
+        if (Command == LOG_CMD_FLUSH_STORE)
+        {
+            ShowStoredLogs();
+        }
+#endif
+
         printf("***ERROR: Can't communicate with the Log Control Daemon.\n");
 
         switch (result)
@@ -479,6 +608,111 @@ static void ProcessIdArgHandler
 }
 
 
+#if LE_CONFIG_LOG_STORE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called by le_arg_Scan() when the optional app name argument of a "show"
+ * command is found on the command line.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ShowAppNameArgHandler
+(
+    const char* appName
+)
+{
+    ShowAppNamePtr = appName;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parses a time option of the "show" command: either a local date and time, or a number of seconds
+ * before now preceded by a '-'.
+ *
+ * @return  The time in ms since the Epoch.  Exits if the time is not valid.
+ **/
+//--------------------------------------------------------------------------------------------------
+static uint64_t ParseTime
+(
+    const char* timeStr
+)
+{
+    if (timeStr[0] == '-')
+    {
+        char* endPtr;
+
+        errno = 0;
+        long secs = strtol(timeStr + 1, &endPtr, 10);
+        if ( (errno != 0) || (endPtr == timeStr + 1) || (*endPtr != '\0') || (secs < 0) )
+        {
+            ExitWithErrorMsg("Invalid time.");
+        }
+
+        le_clk_Time_t now = le_clk_GetAbsoluteTime();
+
+        return (now.sec > secs) ? (now.sec - secs) * 1000ULL : 0;
+    }
+
+    struct tm tm;
+    const char* endPtr;
+
+    memset(&tm, 0, sizeof(tm));
+    endPtr = strptime(timeStr, "%Y-%m-%d %H:%M:%S", &tm);
+    if ( (endPtr == NULL) || (*endPtr != '\0') )
+    {
+        memset(&tm, 0, sizeof(tm));
+        endPtr = strptime(timeStr, "%Y-%m-%dT%H:%M:%S", &tm);
+    }
+    if ( (endPtr == NULL) || (*endPtr != '\0') )
+    {
+        ExitWithErrorMsg("Invalid time.");
+    }
+
+    // Let mktime() figure out whether daylight saving time applies.
+    tm.tm_isdst = -1;
+    time_t t = mktime(&tm);
+    if (t == (time_t)-1)
+    {
+        ExitWithErrorMsg("Invalid time.");
+    }
+
+    return t * 1000ULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks and converts the options of the "show" command.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ParseShowOptions
+(
+    void
+)
+{
+    if (ShowSincePtr != NULL)
+    {
+        ShowStartTime = ParseTime(ShowSincePtr);
+    }
+
+    if (ShowUntilPtr != NULL)
+    {
+        // The end of the range is inclusive, up to the last ms of the second given.
+        ShowEndTime = ParseTime(ShowUntilPtr) + 999;
+    }
+
+    if (ShowLevelPtr != NULL)
+    {
+        ShowMinLevel = ParseSeverityLevel(ShowLevelPtr);
+        if (ShowMinLevel == (le_log_Level_t)(-1))
+        {
+            ExitWithErrorMsg("Invalid log level.");
+        }
+    }
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function that gets called by le_arg_Scan() when it sees the first positional argument while
@@ -529,6 +763,23 @@ static void CommandArgHandler
         // This command has only a process name (or pid) as a parameter.
         le_arg_AddPositionalCallback(ProcessIdArgHandler);
     }
+    else if (strcmp(command, "stats") == 0)
+    {
+        Command = LOG_CMD_LIST_FD_STATS;
+
+        // This command has no parameters and no destination.
+    }
+#if LE_CONFIG_LOG_STORE
+    else if (strcmp(command, "show") == 0)
+    {
+        // Have the log daemon write what it buffered before reading the store.
+        Command = LOG_CMD_FLUSH_STORE;
+
+        // This command has an optional app name and options.
+        le_arg_AddPositionalCallback(ShowAppNameArgHandler);
+        le_arg_AllowLessPositionalArgsThanCallbacks();
+    }
+#endif
     else
     {
         char errorMsg[100];
@@ -551,8 +802,22 @@ COMPONENT_INIT
     // Print help and exit if the "-h" or "--help" options are given.
     le_arg_SetFlagCallback(PrintHelpAndExit, "h", "help");
 
+#if LE_CONFIG_LOG_STORE
+    // Options of the "show" command.
+    le_arg_SetStringVar(&ShowSincePtr, NULL, "since");
+    le_arg_SetStringVar(&ShowUntilPtr, NULL, "until");
+    le_arg_SetStringVar(&ShowLevelPtr, NULL, "level");
+#endif
+
     le_arg_Scan();
 
+#if LE_CONFIG_LOG_STORE
+    if (Command == LOG_CMD_FLUSH_STORE)
+    {
+        ParseShowOptions();
+    }
+#endif
+
     // Connect to the Log Control Daemon and allocate a message buffer to hold the command.
     le_msg_SessionRef_t sessionRef = ConnectToLogControlDaemon();
     le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
@@ -574,8 +839,10 @@ COMPONENT_INIT
             break;
 
         case LOG_CMD_LIST_COMPONENTS:
+        case LOG_CMD_LIST_FD_STATS:
+        case LOG_CMD_FLUSH_STORE:
 
-            // This one has no arguments.
+            // These have no arguments.
 
             break;
 